@@ -12,6 +12,8 @@
         GL_ARB_enhanced_layouts,
         GL_ARB_shader_image_load_store,
         GL_ARB_shading_language_420pack,
+        GL_ARB_tessellation_shader,
+        GL_ARB_timer_query,
         GL_ARB_texture_filter_anisotropic,
         GL_EXT_shader_image_load_store,
         GL_EXT_texture_filter_anisotropic
@@ -21,9 +23,9 @@
     Reproducible: False
 
     Commandline:
-        --profile="core" --api="gl=3.2" --generator="c" --spec="gl" --local-files --extensions="GL_ARB_arrays_of_arrays,GL_ARB_compute_shader,GL_ARB_enhanced_layouts,GL_ARB_shader_image_load_store,GL_ARB_shading_language_420pack,GL_ARB_texture_filter_anisotropic,GL_EXT_shader_image_load_store,GL_EXT_texture_filter_anisotropic"
+        --profile="core" --api="gl=3.2" --generator="c" --spec="gl" --local-files --extensions="GL_ARB_arrays_of_arrays,GL_ARB_compute_shader,GL_ARB_enhanced_layouts,GL_ARB_shader_image_load_store,GL_ARB_shading_language_420pack,GL_ARB_tessellation_shader,GL_ARB_timer_query,GL_ARB_texture_filter_anisotropic,GL_EXT_shader_image_load_store,GL_EXT_texture_filter_anisotropic"
     Online:
-        https://glad.dav1d.de/#profile=core&language=c&specification=gl&loader=on&api=gl%3D3.2&extensions=GL_ARB_arrays_of_arrays&extensions=GL_ARB_compute_shader&extensions=GL_ARB_enhanced_layouts&extensions=GL_ARB_shader_image_load_store&extensions=GL_ARB_shading_language_420pack&extensions=GL_ARB_texture_filter_anisotropic&extensions=GL_EXT_shader_image_load_store&extensions=GL_EXT_texture_filter_anisotropic
+        https://glad.dav1d.de/#profile=core&language=c&specification=gl&loader=on&api=gl%3D3.2&extensions=GL_ARB_arrays_of_arrays&extensions=GL_ARB_compute_shader&extensions=GL_ARB_enhanced_layouts&extensions=GL_ARB_shader_image_load_store&extensions=GL_ARB_shading_language_420pack&extensions=GL_ARB_tessellation_shader&extensions=GL_ARB_timer_query&extensions=GL_ARB_texture_filter_anisotropic&extensions=GL_EXT_shader_image_load_store&extensions=GL_EXT_texture_filter_anisotropic
 */
 
 #include <stdio.h>
@@ -591,6 +593,8 @@ int GLAD_GL_ARB_compute_shader = 0;
 int GLAD_GL_ARB_enhanced_layouts = 0;
 int GLAD_GL_ARB_shader_image_load_store = 0;
 int GLAD_GL_ARB_shading_language_420pack = 0;
+int GLAD_GL_ARB_tessellation_shader = 0;
+int GLAD_GL_ARB_timer_query = 0;
 int GLAD_GL_ARB_texture_filter_anisotropic = 0;
 int GLAD_GL_EXT_shader_image_load_store = 0;
 int GLAD_GL_EXT_texture_filter_anisotropic = 0;
@@ -598,6 +602,11 @@ PFNGLDISPATCHCOMPUTEPROC glad_glDispatchCompute = NULL;
 PFNGLDISPATCHCOMPUTEINDIRECTPROC glad_glDispatchComputeIndirect = NULL;
 PFNGLBINDIMAGETEXTUREARBPROC glad_glBindImageTextureARB = NULL;
 PFNGLMEMORYBARRIERARBPROC glad_glMemoryBarrierARB = NULL;
+PFNGLPATCHPARAMETERIPROC glad_glPatchParameteri = NULL;
+PFNGLPATCHPARAMETERFVPROC glad_glPatchParameterfv = NULL;
+PFNGLQUERYCOUNTERPROC glad_glQueryCounter = NULL;
+PFNGLGETQUERYOBJECTI64VPROC glad_glGetQueryObjecti64v = NULL;
+PFNGLGETQUERYOBJECTUI64VPROC glad_glGetQueryObjectui64v = NULL;
 PFNGLBINDIMAGETEXTUREEXTPROC glad_glBindImageTextureEXT = NULL;
 PFNGLMEMORYBARRIEREXTPROC glad_glMemoryBarrierEXT = NULL;
 /// TODO to add
@@ -966,6 +975,17 @@ static void load_GL_ARB_shader_image_load_store(GLADloadproc load) {
 	glad_glBindImageTextureARB = (PFNGLBINDIMAGETEXTUREARBPROC)load("glBindImageTexture"); //ARB
 	glad_glMemoryBarrierARB = (PFNGLMEMORYBARRIERARBPROC)load("glMemoryBarrier"); //ARB
 }
+static void load_GL_ARB_tessellation_shader(GLADloadproc load) {
+	if(!GLAD_GL_ARB_tessellation_shader) return;
+	glad_glPatchParameteri = (PFNGLPATCHPARAMETERIPROC)load("glPatchParameteri");
+	glad_glPatchParameterfv = (PFNGLPATCHPARAMETERFVPROC)load("glPatchParameterfv");
+}
+static void load_GL_ARB_timer_query(GLADloadproc load) {
+	if(!GLAD_GL_ARB_timer_query) return;
+	glad_glQueryCounter = (PFNGLQUERYCOUNTERPROC)load("glQueryCounter");
+	glad_glGetQueryObjecti64v = (PFNGLGETQUERYOBJECTI64VPROC)load("glGetQueryObjecti64v");
+	glad_glGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VPROC)load("glGetQueryObjectui64v");
+}
 static void load_GL_EXT_shader_image_load_store(GLADloadproc load) {
 	if(!GLAD_GL_EXT_shader_image_load_store) return;
 	glad_glBindImageTextureEXT = (PFNGLBINDIMAGETEXTUREEXTPROC)load("glBindImageTextureEXT");
@@ -978,6 +998,8 @@ static int find_extensionsGL(void) {
 	GLAD_GL_ARB_enhanced_layouts = has_ext("GL_ARB_enhanced_layouts");
 	GLAD_GL_ARB_shader_image_load_store = has_ext("GL_ARB_shader_image_load_store");
 	GLAD_GL_ARB_shading_language_420pack = has_ext("GL_ARB_shading_language_420pack");
+	GLAD_GL_ARB_tessellation_shader = has_ext("GL_ARB_tessellation_shader");
+	GLAD_GL_ARB_timer_query = has_ext("GL_ARB_timer_query");
 	GLAD_GL_ARB_texture_filter_anisotropic = has_ext("GL_ARB_texture_filter_anisotropic");
 	GLAD_GL_EXT_shader_image_load_store = has_ext("GL_EXT_shader_image_load_store");
 	GLAD_GL_EXT_texture_filter_anisotropic = has_ext("GL_EXT_texture_filter_anisotropic");
@@ -1059,6 +1081,8 @@ int gladLoadGLLoader(GLADloadproc load) {
 	if (!find_extensionsGL()) return 0;
 	load_GL_ARB_compute_shader(load);
 	load_GL_ARB_shader_image_load_store(load);
+	load_GL_ARB_tessellation_shader(load);
+	load_GL_ARB_timer_query(load);
 	load_GL_EXT_shader_image_load_store(load);
 
 	////////////////////////
@@ -12,6 +12,8 @@
         GL_ARB_enhanced_layouts,
         GL_ARB_shader_image_load_store,
         GL_ARB_shading_language_420pack,
+        GL_ARB_tessellation_shader,
+        GL_ARB_timer_query,
         GL_ARB_texture_filter_anisotropic,
         GL_EXT_shader_image_load_store,
         GL_EXT_texture_filter_anisotropic
@@ -21,9 +23,9 @@
     Reproducible: False
 
     Commandline:
-        --profile="core" --api="gl=3.2" --generator="c" --spec="gl" --local-files --extensions="GL_ARB_arrays_of_arrays,GL_ARB_compute_shader,GL_ARB_enhanced_layouts,GL_ARB_shader_image_load_store,GL_ARB_shading_language_420pack,GL_ARB_texture_filter_anisotropic,GL_EXT_shader_image_load_store,GL_EXT_texture_filter_anisotropic"
+        --profile="core" --api="gl=3.2" --generator="c" --spec="gl" --local-files --extensions="GL_ARB_arrays_of_arrays,GL_ARB_compute_shader,GL_ARB_enhanced_layouts,GL_ARB_shader_image_load_store,GL_ARB_shading_language_420pack,GL_ARB_tessellation_shader,GL_ARB_timer_query,GL_ARB_texture_filter_anisotropic,GL_EXT_shader_image_load_store,GL_EXT_texture_filter_anisotropic"
     Online:
-        https://glad.dav1d.de/#profile=core&language=c&specification=gl&loader=on&api=gl%3D3.2&extensions=GL_ARB_arrays_of_arrays&extensions=GL_ARB_compute_shader&extensions=GL_ARB_enhanced_layouts&extensions=GL_ARB_shader_image_load_store&extensions=GL_ARB_shading_language_420pack&extensions=GL_ARB_texture_filter_anisotropic&extensions=GL_EXT_shader_image_load_store&extensions=GL_EXT_texture_filter_anisotropic
+        https://glad.dav1d.de/#profile=core&language=c&specification=gl&loader=on&api=gl%3D3.2&extensions=GL_ARB_arrays_of_arrays&extensions=GL_ARB_compute_shader&extensions=GL_ARB_enhanced_layouts&extensions=GL_ARB_shader_image_load_store&extensions=GL_ARB_shading_language_420pack&extensions=GL_ARB_tessellation_shader&extensions=GL_ARB_timer_query&extensions=GL_ARB_texture_filter_anisotropic&extensions=GL_EXT_shader_image_load_store&extensions=GL_EXT_texture_filter_anisotropic
 */
 
 
@@ -1958,6 +1960,40 @@ GLAPI PFNGLSAMPLEMASKIPROC glad_glSampleMaski;
 #define GL_DISPATCH_INDIRECT_BUFFER 0x90EE
 #define GL_DISPATCH_INDIRECT_BUFFER_BINDING 0x90EF
 #define GL_COMPUTE_SHADER_BIT 0x00000020
+#define GL_PATCHES 0x000E
+#define GL_PATCH_VERTICES 0x8E72
+#define GL_PATCH_DEFAULT_INNER_LEVEL 0x8E73
+#define GL_PATCH_DEFAULT_OUTER_LEVEL 0x8E74
+#define GL_TESS_CONTROL_OUTPUT_VERTICES 0x8E75
+#define GL_TESS_GEN_MODE 0x8E76
+#define GL_TESS_GEN_SPACING 0x8E77
+#define GL_TESS_GEN_VERTEX_ORDER 0x8E78
+#define GL_TESS_GEN_POINT_MODE 0x8E79
+#define GL_ISOLINES 0x8E7A
+#define GL_FRACTIONAL_ODD 0x8E7B
+#define GL_FRACTIONAL_EVEN 0x8E7C
+#define GL_MAX_PATCH_VERTICES 0x8E7D
+#define GL_MAX_TESS_GEN_LEVEL 0x8E7E
+#define GL_MAX_TESS_CONTROL_UNIFORM_COMPONENTS 0x8E7F
+#define GL_MAX_TESS_EVALUATION_UNIFORM_COMPONENTS 0x8E80
+#define GL_MAX_TESS_CONTROL_TEXTURE_IMAGE_UNITS 0x8E81
+#define GL_MAX_TESS_EVALUATION_TEXTURE_IMAGE_UNITS 0x8E82
+#define GL_MAX_TESS_CONTROL_OUTPUT_COMPONENTS 0x8E83
+#define GL_MAX_TESS_PATCH_COMPONENTS 0x8E84
+#define GL_MAX_TESS_CONTROL_TOTAL_OUTPUT_COMPONENTS 0x8E85
+#define GL_MAX_TESS_EVALUATION_OUTPUT_COMPONENTS 0x8E86
+#define GL_MAX_TESS_CONTROL_UNIFORM_BLOCKS 0x8E89
+#define GL_MAX_TESS_EVALUATION_UNIFORM_BLOCKS 0x8E8A
+#define GL_MAX_TESS_CONTROL_INPUT_COMPONENTS 0x886C
+#define GL_MAX_TESS_EVALUATION_INPUT_COMPONENTS 0x886D
+#define GL_MAX_COMBINED_TESS_CONTROL_UNIFORM_COMPONENTS 0x8E1E
+#define GL_MAX_COMBINED_TESS_EVALUATION_UNIFORM_COMPONENTS 0x8E1F
+#define GL_UNIFORM_BLOCK_REFERENCED_BY_TESS_CONTROL_SHADER 0x84F0
+#define GL_UNIFORM_BLOCK_REFERENCED_BY_TESS_EVALUATION_SHADER 0x84F1
+#define GL_TESS_EVALUATION_SHADER 0x8E87
+#define GL_TESS_CONTROL_SHADER 0x8E88
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_TIMESTAMP 0x8E28
 #define GL_LOCATION_COMPONENT 0x934A
 #define GL_TRANSFORM_FEEDBACK_BUFFER_INDEX 0x934B
 #define GL_TRANSFORM_FEEDBACK_BUFFER_STRIDE 0x934C
@@ -2116,6 +2152,29 @@ GLAPI PFNGLMEMORYBARRIERARBPROC glad_glMemoryBarrierARB;
 #define GL_ARB_shading_language_420pack 1
 GLAPI int GLAD_GL_ARB_shading_language_420pack;
 #endif
+#ifndef GL_ARB_tessellation_shader
+#define GL_ARB_tessellation_shader 1
+GLAPI int GLAD_GL_ARB_tessellation_shader;
+typedef void (APIENTRYP PFNGLPATCHPARAMETERIPROC)(GLenum pname, GLint value);
+GLAPI PFNGLPATCHPARAMETERIPROC glad_glPatchParameteri;
+#define glPatchParameteri glad_glPatchParameteri
+typedef void (APIENTRYP PFNGLPATCHPARAMETERFVPROC)(GLenum pname, const GLfloat *values);
+GLAPI PFNGLPATCHPARAMETERFVPROC glad_glPatchParameterfv;
+#define glPatchParameterfv glad_glPatchParameterfv
+#endif
+#ifndef GL_ARB_timer_query
+#define GL_ARB_timer_query 1
+GLAPI int GLAD_GL_ARB_timer_query;
+typedef void (APIENTRYP PFNGLQUERYCOUNTERPROC)(GLuint id, GLenum target);
+GLAPI PFNGLQUERYCOUNTERPROC glad_glQueryCounter;
+#define glQueryCounter glad_glQueryCounter
+typedef void (APIENTRYP PFNGLGETQUERYOBJECTI64VPROC)(GLuint id, GLenum pname, GLint64 *params);
+GLAPI PFNGLGETQUERYOBJECTI64VPROC glad_glGetQueryObjecti64v;
+#define glGetQueryObjecti64v glad_glGetQueryObjecti64v
+typedef void (APIENTRYP PFNGLGETQUERYOBJECTUI64VPROC)(GLuint id, GLenum pname, GLuint64 *params);
+GLAPI PFNGLGETQUERYOBJECTUI64VPROC glad_glGetQueryObjectui64v;
+#define glGetQueryObjectui64v glad_glGetQueryObjectui64v
+#endif
 #ifndef GL_ARB_texture_filter_anisotropic
 #define GL_ARB_texture_filter_anisotropic 1
 GLAPI int GLAD_GL_ARB_texture_filter_anisotropic;
@@ -0,0 +1,45 @@
+/* Author: BAIRAC MIHAI */
+
+// the low resolution clouds, premultiplied colors (check CloudsUpsampler.h)
+uniform sampler2D u_LowResMap;
+uniform sampler2D u_LowResDepthMap;
+
+// x, y, width, height of the full resolution viewport
+uniform vec4 u_Viewport;
+
+out vec4 fragColor;
+
+
+void main (void)
+{
+	ivec2 lowResSize = textureSize(u_LowResMap, 0);
+	vec2 scale = vec2(lowResSize) / u_Viewport.zw;
+
+	// the fragment position relative to the centers of the 4 nearest low resolution texels
+	vec2 lowResPos = (gl_FragCoord.xy - u_Viewport.xy) * scale - 0.5f;
+	ivec2 basePos = ivec2(floor(lowResPos));
+	vec2 f = lowResPos - vec2(basePos);
+
+	// the depth of the plane changes by about fwidth() / scale between 2 low resolution texels,
+	// the texels outside of the plane keep the cleared depth (1.0)
+	float depthTolerance = fwidth(gl_FragCoord.z) / min(scale.x, scale.y) + 1e-6f;
+
+	vec4 colorSum = vec4(0.0f);
+	float weightSum = 0.0f;
+
+	for (int i = 0; i < 4; ++ i)
+	{
+		ivec2 offset = ivec2(i & 1, i >> 1);
+		ivec2 texelPos = clamp(basePos + offset, ivec2(0), lowResSize - 1);
+
+		vec2 bilinear = mix(1.0f - f, f, vec2(offset));
+		float depthDiff = abs(texelFetch(u_LowResDepthMap, texelPos, 0).r - gl_FragCoord.z) / depthTolerance;
+
+		float weight = bilinear.x * bilinear.y / (1.0f + depthDiff * depthDiff);
+
+		colorSum += weight * texelFetch(u_LowResMap, texelPos, 0);
+		weightSum += weight;
+	}
+
+	fragColor = colorSum / max(weightSum, 1e-4f);
+}
\ No newline at end of file
@@ -1,21 +1,50 @@
 /* Author: BAIRAC MIHAI */
 
 uniform mat4 u_WorldToClipMatrix;
-uniform mat4 u_ObjectToWorldMatrix;
+// one matrix per layer, only the first one is used if not layered
+uniform mat4 u_ObjectToWorldMatrix[2];
+
+// both reflection and refraction are rendered in one pass, one instance per layer (check MotorBoat.vert.glsl)
+uniform bool u_IsLayered;
 
 in vec3 a_position;
 
 out vec3 v_uv;
 out float v_fogCoord;
 
+out float gl_ClipDistance[4]; //clip plane for local reflection and refraction + the layer bounds
+
+// the layers are placed side by side: 0 - left half (reflection), 1 - right half (refraction)
+vec4 computeLayerClipPos (vec4 clipPos, int layer)
+{
+	clipPos.x = 0.5f * (clipPos.x + (2.0f * float(layer) - 1.0f) * clipPos.w);
+
+	return clipPos;
+}
+
 void main (void)
 {	
 	v_uv = a_position;
 
-	vec4 world_pos = u_ObjectToWorldMatrix * vec4(a_position, 1.0f);
+	int layer = (u_IsLayered ? gl_InstanceID : 0);
+
+	vec4 world_pos = u_ObjectToWorldMatrix[layer] * vec4(a_position, 1.0f);
 
 	// we use the w value instead of z as explained in here: https://learnopengl.com/#!Advanced-OpenGL/Cubemaps
 	vec4 clip_pos = u_WorldToClipMatrix * world_pos;
 
 	gl_Position = clip_pos.xyww;
+
+	// the sky is never clipped by the water planes
+	gl_ClipDistance[0] = 1.0f;
+	gl_ClipDistance[1] = 1.0f;
+
+	if (u_IsLayered)
+	{
+		// the layer bounds, so nothing spills into the other half
+		gl_ClipDistance[2] = gl_Position.w + gl_Position.x;
+		gl_ClipDistance[3] = gl_Position.w - gl_Position.x;
+
+		gl_Position = computeLayerClipPos(gl_Position, layer);
+	}
 }
@@ -0,0 +1,94 @@
+/* Author: BAIRAC MIHAI */
+
+// Radix-4 pass: 2 consecutive radix-2 butterfly stages merged into a single pass
+// u_Radix4ButterflyMap stores per pass 2 rows: the 4 source indices and the 2 complex weights
+uniform sampler2D u_Radix4ButterflyMap;
+uniform sampler2DArray u_PingPongMap; // 2 complex inputs (= 4 values) per layer
+
+uniform float u_FFTSize;
+uniform float u_IndicesStep;
+uniform float u_WeightsStep;
+uniform bool u_IsLastStep;
+
+/// Interpolated inputs across mesh
+in vec2 v_uv;
+///
+
+out vec4 fragColor0; // DY
+out vec4 fragColor1; // DX, DZ
+out vec4 fragColor2; // SX, SZ
+
+vec2 complex_mult_complex (vec2 c1, vec2 c2)
+{
+	// (x, yi) * (u, vi) = (xu - yv), (xv + yu)i
+
+	return vec2(c1.x * c2.x - c1.y * c2.y, c1.x * c2.y + c1.y * c2.x);
+}
+
+vec4 computeIFFT (vec4 indices, vec4 weights, float layer)
+{
+	vec2 sourceA = texture(u_PingPongMap, vec3(v_uv.x, indices.x, layer)).xy;
+	vec2 sourceB = texture(u_PingPongMap, vec3(v_uv.x, indices.y, layer)).xy;
+	vec2 sourceC = texture(u_PingPongMap, vec3(v_uv.x, indices.z, layer)).xy;
+	vec2 sourceD = texture(u_PingPongMap, vec3(v_uv.x, indices.w, layer)).xy;
+
+	// first stage
+	vec2 complexAB = sourceA + complex_mult_complex(weights.xy, sourceB);
+	vec2 complexCD = sourceC + complex_mult_complex(weights.xy, sourceD);
+
+	// second stage
+	vec2 complex = complexAB + complex_mult_complex(weights.zw, complexCD);
+
+	return vec4(complex, 0.0f, 0.0f);
+}
+
+vec4 compute2IFFT (vec4 indices, vec4 weights, float layer)
+{
+	vec4 sourceA = texture(u_PingPongMap, vec3(v_uv.x, indices.x, layer));
+	vec4 sourceB = texture(u_PingPongMap, vec3(v_uv.x, indices.y, layer));
+	vec4 sourceC = texture(u_PingPongMap, vec3(v_uv.x, indices.z, layer));
+	vec4 sourceD = texture(u_PingPongMap, vec3(v_uv.x, indices.w, layer));
+
+	// first stage
+	vec4 complex2AB, complex2CD;
+	complex2AB.xy = sourceA.xy + complex_mult_complex(weights.xy, sourceB.xy);
+	complex2AB.zw = sourceA.zw + complex_mult_complex(weights.xy, sourceB.zw);
+	complex2CD.xy = sourceC.xy + complex_mult_complex(weights.xy, sourceD.xy);
+	complex2CD.zw = sourceC.zw + complex_mult_complex(weights.xy, sourceD.zw);
+
+	// second stage
+	vec4 complex2;
+	complex2.xy = complex2AB.xy + complex_mult_complex(weights.zw, complex2CD.xy);
+	complex2.zw = complex2AB.zw + complex_mult_complex(weights.zw, complex2CD.zw);
+
+	return complex2;
+}
+
+void main (void)
+{
+	vec4 indices = texture(u_Radix4ButterflyMap, vec2(v_uv.y, u_IndicesStep));
+	vec4 weights = texture(u_Radix4ButterflyMap, vec2(v_uv.y, u_WeightsStep));
+
+	vec4 dy = computeIFFT(indices, weights, 0);
+	vec4 dxdz = compute2IFFT(indices, weights, 1);
+	vec4 sxsz = compute2IFFT(indices, weights, 2);
+
+	if (u_IsLastStep)
+	{
+		// the texture is of size u_FFTSize x u_FFTSize
+		vec2 index = v_uv * u_FFTSize;
+		int sign_correction = (mod((index.x + index.y), 2.0f) == 1.0f) ? -1 : 1;
+
+		vec3 displacement = vec3( - dxdz.x, dy.x, - dxdz.z) * sign_correction;
+		vec2 slopes = vec2( - sxsz.x, - sxsz.z) * sign_correction;
+
+		fragColor0 = vec4(displacement, 0.0f);
+		fragColor1 = vec4(slopes, 0.0f, 0.0f);
+	}
+	else
+	{
+		fragColor0 = dy;
+		fragColor1 = dxdz;
+		fragColor2 = sxsz;
+	}
+}
\ No newline at end of file
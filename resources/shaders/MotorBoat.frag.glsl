@@ -1,7 +1,7 @@
 /* Author: BAIRAC MIHAI */
 
 uniform float u_HDRExposure;
-uniform bool u_ApplyHDR;
+uniform bool u_ApplyHDR[2]; // one value per layer (check MotorBoat.vert.glsl)
 
 uniform sampler2D u_BoatDiffMap;
 uniform sampler2D u_BoatNormalMap;
@@ -11,6 +11,7 @@ uniform vec3 u_SunDirection;
 /// Interpolated inputs across mesh
 in vec3 v_normal; ///
 in vec2 v_uv;
+flat in int v_layer;
 ///
 
 out vec4 fragColor;
@@ -65,7 +66,7 @@ void main (void)
     vec3 finalColor = (ambient + diffuse) * boatColor;
 
 #ifdef HDR
-if (u_ApplyHDR)
+if (u_ApplyHDR[v_layer])
 {
 	finalColor = hdr(finalColor);
 }
@@ -6,26 +6,40 @@ modern way for clip planes: http://github.prideout.net/clip-planes
 */
 
 uniform mat4 u_WorldToClipMatrix;
-uniform mat4 u_ObjectToWorldMatrix;
+// one matrix per layer, only the first one is used if not layered
+uniform mat4 u_ObjectToWorldMatrix[2];
 
 uniform vec4 u_ReflClipPlane;
 uniform vec4 u_RefrClipPlane;
 
+// both reflection and refraction are rendered in one pass, one instance per layer (check Application::RenderReflectedRefractedScene())
+uniform bool u_IsLayered;
+
 in vec3 a_position;
 in vec3 a_normal; ///
 in vec2 a_uv;
 
 out vec3 v_normal; ///
 out vec2 v_uv;
+flat out int v_layer;
+
+out float gl_ClipDistance[4]; //clip plane for local reflection and refraction + the layer bounds
+
+// the layers are placed side by side: 0 - left half (reflection), 1 - right half (refraction)
+vec4 computeLayerClipPos (vec4 clipPos, int layer)
+{
+	clipPos.x = 0.5f * (clipPos.x + (2.0f * float(layer) - 1.0f) * clipPos.w);
 
-out float gl_ClipDistance[2]; //clip plane for local reflection and refraction
+	return clipPos;
+}
 
 void main (void)
 {
 	v_normal = a_normal; ///
 	v_uv = a_uv;
+	v_layer = (u_IsLayered ? gl_InstanceID : 0);
 
-	vec4 world_pos = u_ObjectToWorldMatrix * vec4(a_position, 1.0f);
+	vec4 world_pos = u_ObjectToWorldMatrix[v_layer] * vec4(a_position, 1.0f);
 
 	gl_Position = u_WorldToClipMatrix * world_pos;
 
@@ -34,4 +48,16 @@ void main (void)
 
 	// clip plane for under water refraction
 	gl_ClipDistance[1] = dot(world_pos, u_RefrClipPlane);
+
+	if (u_IsLayered)
+	{
+		// every layer is clipped only by its own plane
+		gl_ClipDistance[1 - v_layer] = 1.0f;
+
+		// the layer bounds, so nothing spills into the other half
+		gl_ClipDistance[2] = gl_Position.w + gl_Position.x;
+		gl_ClipDistance[3] = gl_Position.w - gl_Position.x;
+
+		gl_Position = computeLayerClipPos(gl_Position, v_layer);
+	}
 }
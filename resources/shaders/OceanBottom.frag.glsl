@@ -20,16 +20,37 @@ struct SandData
 };
 uniform SandData u_SandData;
 
-uniform vec3 u_SunDirection;
+// Uniform blocks (check UniformBufferManager)
+layout(std140) uniform SunBlock
+{
+	vec3 u_SunDirection;
+};
 
 uniform float u_TileScale;
 
 #ifdef UNDERWATER_CAUSTICS
+#ifdef BAKED_CAUSTICS
+// looping atlas of caustics factors, one layer per frame of the ocean animation (check CausticsBaker)
+struct CausticsData
+{
+	sampler2DArray Map;
+	float Scale;
+	vec3 Color;
+	float Intensity;
+	// the ocean patch size the atlas was baked for
+	float PatchSize;
+	// the current frame, the fractional part blends 2 layers
+	float Frame;
+	// the landing shift of the current sun direction, relative to the baked one
+	vec2 SunOffset;
+};
+#else
 struct CausticsData
 {	
 	sampler2D Map;
 	float Scale;
 };
+#endif // BAKED_CAUSTICS
 uniform CausticsData u_CausticsData;
 #endif // UNDERWATER_CAUSTICS
 
@@ -65,7 +86,7 @@ vec3 bilinearFilteringCaustics (vec2 uv)
 {
 	vec3 causticsComponent = vec3(0.0f);
 
-#ifdef UNDERWATER_CAUSTICS
+#if defined(UNDERWATER_CAUSTICS) && !defined(BAKED_CAUSTICS)
 	int texSize = textureSize(u_CausticsData.Map, 0).x;
 	float offset = 1.0f / texSize;
 
@@ -107,7 +128,7 @@ vec3 bicubicTriangularFilteringCaustics (vec2 uv)
 {
 vec3 causticsComponent = vec3(0.0f);
 
-#ifdef UNDERWATER_CAUSTICS
+#if defined(UNDERWATER_CAUSTICS) && !defined(BAKED_CAUSTICS)
 	int texSize = textureSize(u_CausticsData.Map, 0).x;
 	float offset = 1.0f / texSize;
 
@@ -136,11 +157,28 @@ vec3 causticsComponent = vec3(0.0f);
 	return causticsComponent;
 }
 
+#ifdef BAKED_CAUSTICS
+vec3 computeBakedCaustics (void)
+{
+	vec2 uv = (v_causUV - u_CausticsData.SunOffset) * u_CausticsData.Scale / u_CausticsData.PatchSize;
+
+	int frameCount = textureSize(u_CausticsData.Map, 0).z;
+	float frame0 = floor(u_CausticsData.Frame);
+	float frame1 = mod(frame0 + 1.0f, float(frameCount));
+
+	float causticsFactor = mix(texture(u_CausticsData.Map, vec3(uv, frame0)).r, texture(u_CausticsData.Map, vec3(uv, frame1)).r, u_CausticsData.Frame - frame0);
+
+	return u_CausticsData.Color * causticsFactor * u_CausticsData.Intensity;
+}
+#endif // BAKED_CAUSTICS
+
 vec3 computeUnderWaterCausticsEffect (void)
 {
 	vec3 underWaterCausticsComponent = vec3(0.0f);
 
-#ifdef UNDERWATER_CAUSTICS
+#ifdef BAKED_CAUSTICS
+	underWaterCausticsComponent = computeBakedCaustics();
+#elif defined(UNDERWATER_CAUSTICS)
 //	underWaterCausticsComponent = texture(u_CausticsData.Map, v_causUV * u_CausticsData.Scale * u_TileScale).rgb;
 //	underWaterCausticsComponent = bicubicTriangularFilteringCaustics(v_causUV * u_CausticsData.Scale * u_TileScale);
 
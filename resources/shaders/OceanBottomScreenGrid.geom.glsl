@@ -7,13 +7,15 @@ layout (triangle_strip, max_vertices = 3) out;
 uniform mat4 u_ProjectingMatrix;
 uniform float u_PlaneDistance;
 
-// Matrices
-uniform mat4 u_WorldToCameraMatrix;
-uniform mat4 u_WorldToClipMatrix;
-uniform mat4 u_ClipToCameraMatrix;
-uniform mat4 u_CameraToWorldMatrix;
-
-uniform vec3 u_CameraPosition;
+// Uniform blocks (check UniformBufferManager)
+layout(std140) uniform CameraBlock
+{
+	mat4 u_WorldToCameraMatrix;
+	mat4 u_WorldToClipMatrix;
+	mat4 u_ClipToCameraMatrix;
+	mat4 u_CameraToWorldMatrix;
+	vec3 u_CameraPosition;
+};
 
 struct PerlinData
 {
@@ -96,8 +98,13 @@ void main (void)
 
 			v_baseUV = worldPos.xz / u_PatchSize;
 
+#ifdef BAKED_CAUSTICS
+			// the baked caustics atlas is laid out in world space (check CausticsBaker)
+			v_causUV = worldPos.xz;
+#else
 			// NOTE! Not yet sure, but for it to work properly I had to inverse the the uv on OY axis !
 			v_causUV = vec2(v_uv[i].x, 1.0f - v_uv[i].y); //works pretty well with some artifacts
+#endif // BAKED_CAUSTICS
 
 			float height = texture(u_PerlinData.DisplacementMap, v_baseUV * u_PerlinData.Scale).w * u_PerlinData.Amplitude;
 			worldPos.y += height;
@@ -3,9 +3,15 @@
 // Projector data
 uniform mat4 u_ProjectingMatrix;
 uniform float u_PlaneDistance;
-// Matrices
-uniform mat4 u_WorldToCameraMatrix;
-uniform mat4 u_WorldToClipMatrix;
+// Uniform blocks (check UniformBufferManager)
+layout(std140) uniform CameraBlock
+{
+	mat4 u_WorldToCameraMatrix;
+	mat4 u_WorldToClipMatrix;
+	mat4 u_ClipToCameraMatrix;
+	mat4 u_CameraToWorldMatrix;
+	vec3 u_CameraPosition;
+};
 
 struct PerlinData
 {
@@ -17,7 +23,42 @@ uniform PerlinData u_PerlinData;
 
 uniform float u_PatchSize;
 
+#ifdef PROCEDURAL_GRID
+// there is no vertex buffer, the uv is computed from gl_VertexID (check Ocean::SetupGrid())
+struct ProceduralGridData
+{
+	int Width; // vertices per row
+	int Height; // rows
+};
+uniform ProceduralGridData u_ProceduralGridData;
+
+vec2 a_uv;
+
+// same zig-zag triangle strip as the world space grid indices
+vec2 computeProceduralGridUV (void)
+{
+	int rowVertexCount = 2 * u_ProceduralGridData.Width;
+	int row = gl_VertexID / rowVertexCount;
+	int column = (gl_VertexID - row * rowVertexCount) / 2;
+
+	bool isEvenRow = (row % 2 == 0);
+	bool isEvenVertex = (gl_VertexID % 2 == 0);
+
+	if (!isEvenRow)
+	{
+		column = u_ProceduralGridData.Width - 1 - column;
+	}
+
+	if (isEvenRow == isEvenVertex)
+	{
+		++ row;
+	}
+
+	return vec2(column, row) / vec2(u_ProceduralGridData.Width - 1, u_ProceduralGridData.Height - 1);
+}
+#else
 in vec2 a_uv;
+#endif // PROCEDURAL_GRID
 
 out vec2 v_baseUV;
 out vec2 v_causUV;
@@ -95,6 +136,10 @@ void main (void)
 {
 	vec3 worldPos;
 
+#ifdef PROCEDURAL_GRID
+	a_uv = computeProceduralGridUV();
+#endif // PROCEDURAL_GRID
+
 #ifdef USE_GRID_CORNERS_BOTTOM
 	// by computing the grid vertex positions on CPU based on the 4 edges of the grid we avoid interpolation and float precision errors
 	vec4 result = mix(mix(u_ProjectingMatrix[0], u_ProjectingMatrix[1], a_uv.x), mix(u_ProjectingMatrix[2], u_ProjectingMatrix[3], a_uv.x), a_uv.y);
@@ -115,7 +160,12 @@ void main (void)
 
 	v_baseUV = worldPos.xz / u_PatchSize;
 
+#ifdef BAKED_CAUSTICS
+	// the baked caustics atlas is laid out in world space (check CausticsBaker)
+	v_causUV = worldPos.xz;
+#else
 	v_causUV = a_uv; //works pretty well with some artifacts
+#endif // BAKED_CAUSTICS
 
 	float height = texture(u_PerlinData.DisplacementMap, v_baseUV * u_PerlinData.Scale).w * u_PerlinData.Amplitude;
 	worldPos.y += height;
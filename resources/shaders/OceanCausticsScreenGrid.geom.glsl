@@ -15,20 +15,27 @@ layout (triangle_strip, max_vertices = 3) out;
 uniform mat4 u_BottomProjectingMatrix;
 uniform float u_BottomPlaneDistance;
 uniform float u_PlaneDistanceOffset;
-// Matrices
-uniform mat4 u_WorldToClipMatrix;
-uniform mat4 u_ClipToCameraMatrix;
-uniform mat4 u_CameraToWorldMatrix;
 
-uniform vec3 u_CameraPosition;
+// Uniform blocks (check UniformBufferManager)
+layout(std140) uniform CameraBlock
+{
+	mat4 u_WorldToCameraMatrix;
+	mat4 u_WorldToClipMatrix;
+	mat4 u_ClipToCameraMatrix;
+	mat4 u_CameraToWorldMatrix;
+	vec3 u_CameraPosition;
+};
+
+layout(std140) uniform SunBlock
+{
+	vec3 u_SunDirection;
+};
 
 uniform sampler2DArray u_FFTWaveDataMap;
 
 uniform float u_PatchSize;
 uniform float u_ChoppyScale;
 
-uniform vec3 u_SunDirection;
-
 out vec3 v_oldPos;
 out vec3 v_newPos;
 
@@ -12,16 +12,62 @@ uniform mat4 u_BottomProjectingMatrix;
 uniform float u_BottomPlaneDistance;
 uniform float u_PlaneDistanceOffset;
 
-uniform mat4 u_WorldToClipMatrix;
+// Uniform blocks (check UniformBufferManager)
+layout(std140) uniform CameraBlock
+{
+	mat4 u_WorldToCameraMatrix;
+	mat4 u_WorldToClipMatrix;
+	mat4 u_ClipToCameraMatrix;
+	mat4 u_CameraToWorldMatrix;
+	vec3 u_CameraPosition;
+};
+
+layout(std140) uniform SunBlock
+{
+	vec3 u_SunDirection;
+};
 
 uniform sampler2DArray u_FFTWaveDataMap;
 
 uniform float u_PatchSize;
 uniform float u_ChoppyScale;
 
-uniform vec3 u_SunDirection;
+#ifdef PROCEDURAL_GRID
+// there is no vertex buffer, the uv is computed from gl_VertexID (check Ocean::SetupGrid())
+struct ProceduralGridData
+{
+	int Width; // vertices per row
+	int Height; // rows
+};
+uniform ProceduralGridData u_ProceduralGridData;
+
+vec2 a_uv;
+
+// same zig-zag triangle strip as the world space grid indices
+vec2 computeProceduralGridUV (void)
+{
+	int rowVertexCount = 2 * u_ProceduralGridData.Width;
+	int row = gl_VertexID / rowVertexCount;
+	int column = (gl_VertexID - row * rowVertexCount) / 2;
+
+	bool isEvenRow = (row % 2 == 0);
+	bool isEvenVertex = (gl_VertexID % 2 == 0);
+
+	if (!isEvenRow)
+	{
+		column = u_ProceduralGridData.Width - 1 - column;
+	}
+
+	if (isEvenRow == isEvenVertex)
+	{
+		++ row;
+	}
 
+	return vec2(column, row) / vec2(u_ProceduralGridData.Width - 1, u_ProceduralGridData.Height - 1);
+}
+#else
 in vec2 a_uv;
+#endif // PROCEDURAL_GRID
 
 out vec3 v_oldPos;
 out vec3 v_newPos;
@@ -103,6 +149,10 @@ void main (void)
 {
 	vec3 worldPos, rayOrigin, rayDirection;
 
+#ifdef PROCEDURAL_GRID
+	a_uv = computeProceduralGridUV();
+#endif // PROCEDURAL_GRID
+
 #ifdef USE_GRID_CORNERS_BOTTOM
 	vec4 result = mix(mix(u_BottomProjectingMatrix[0], u_BottomProjectingMatrix[1], a_uv.x), mix(u_BottomProjectingMatrix[2], u_BottomProjectingMatrix[3], a_uv.x), a_uv.y);
 
@@ -0,0 +1,61 @@
+/* Author: BAIRAC MIHAI
+
+ One pass of the multi-pass god rays (check Ocean::RenderOceanBottomGodRays)
+
+ Every pass blurs the previous one towards the light with SamplesPerPass taps,
+ the step of a pass is SamplesPerPass times the step of the previous pass, so the taps of the passes don't overlap and
+ PassCount passes sum SamplesPerPass ^ PassCount evenly spaced taps, like the single pass version (OceanGodRays.frag.glsl).
+
+ The taps are averaged, the exposure and the weight are applied by the upsample pass.
+
+ License: check the package
+
+*/
+
+struct GodRaysData
+{
+	// the occluder map for the first pass, the previous pass for the others
+	sampler2D SourceMap;
+	int NumberOfSamples;
+	int SamplesPerPass;
+	float Decay;
+	float Density;
+	vec2 LightDirectionOnScreen;
+	// the tap step of this pass, as a fraction of the ray length
+	float StepFraction;
+	bool IsFirstPass;
+};
+uniform GodRaysData u_GodRaysData;
+
+in vec2 v_uv;
+
+out vec4 fragColor;
+
+
+void main (void)
+{
+	vec2 deltaTextCoord = (v_uv - u_GodRaysData.LightDirectionOnScreen) * u_GodRaysData.Density * u_GodRaysData.StepFraction;
+
+	// the decay of the single pass version is applied per sample, a tap of this pass is StepFraction * NumberOfSamples samples away
+	float decayStep = pow(u_GodRaysData.Decay, u_GodRaysData.StepFraction * float(u_GodRaysData.NumberOfSamples));
+	float illuminationDecay = 1.0f;
+
+	vec3 finalColor = vec3(0.0f);
+
+	vec2 uv = v_uv;
+	for (int i = 0; i < u_GodRaysData.SamplesPerPass; i++)
+	{
+		finalColor += texture(u_GodRaysData.SourceMap, uv).rgb * illuminationDecay;
+
+		uv -= deltaTextCoord;
+		illuminationDecay *= decayStep;
+	}
+
+	finalColor /= float(u_GodRaysData.SamplesPerPass);
+
+	// alpha - the occluder luminance, the upsample pass compares it with the full resolution occluder map
+	vec4 center = texture(u_GodRaysData.SourceMap, v_uv);
+	float guide = (u_GodRaysData.IsFirstPass ? dot(center.rgb, vec3(1.0f / 3.0f)) : center.a);
+
+	fragColor = vec4(finalColor, guide);
+}
\ No newline at end of file
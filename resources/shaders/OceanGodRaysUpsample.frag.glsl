@@ -0,0 +1,68 @@
+/* Author: BAIRAC MIHAI
+
+ Upsamples the multi-pass god rays (check OceanGodRaysPass.frag.glsl) and adds them to the scene
+
+ Every fragment blends the 4 nearest low resolution texels, weighted by the bilinear weights and by how close
+ the occluder luminance of the texel is to the full resolution occluder map, so the rays keep the sharp occluder edges near the light.
+
+ License: check the package
+
+*/
+
+struct GodRaysData
+{
+	// full resolution
+	sampler2D OccluderMap;
+	// the last pass
+	sampler2D RaysMap;
+	int NumberOfSamples;
+	float Exposure;
+	float Weight;
+};
+uniform GodRaysData u_GodRaysData;
+
+in vec2 v_uv;
+
+out vec4 fragColor;
+
+// the occluder is much brighter than the background
+const float kGuideTolerance = 0.1f;
+
+
+void main (void)
+{
+	ivec2 lowResSize = textureSize(u_GodRaysData.RaysMap, 0);
+
+	float guide = dot(texture(u_GodRaysData.OccluderMap, v_uv).rgb, vec3(1.0f / 3.0f));
+
+	// the fragment position relative to the centers of the 4 nearest low resolution texels
+	vec2 lowResPos = v_uv * vec2(lowResSize) - 0.5f;
+	ivec2 basePos = ivec2(floor(lowResPos));
+	vec2 f = lowResPos - vec2(basePos);
+
+	vec3 colorSum = vec3(0.0f);
+	float weightSum = 0.0f;
+
+	for (int i = 0; i < 4; ++ i)
+	{
+		ivec2 offset = ivec2(i & 1, i >> 1);
+		ivec2 texelPos = clamp(basePos + offset, ivec2(0), lowResSize - 1);
+
+		vec4 texel = texelFetch(u_GodRaysData.RaysMap, texelPos, 0);
+
+		vec2 bilinear = mix(1.0f - f, f, vec2(offset));
+		float guideDiff = (texel.a - guide) / kGuideTolerance;
+
+		float weight = bilinear.x * bilinear.y / (1.0f + guideDiff * guideDiff);
+
+		colorSum += weight * texel.rgb;
+		weightSum += weight;
+	}
+
+	// the passes average the taps, the single pass version sums NumberOfSamples of them
+	vec3 finalColor = colorSum / max(weightSum, 1e-4f) * float(u_GodRaysData.NumberOfSamples) * u_GodRaysData.Weight * u_GodRaysData.Exposure;
+
+	// No need to HDR this because we blend this effect with the hdr corrected color that is already in framebuffer!
+
+	fragColor = vec4(finalColor, 1.0f);
+}
\ No newline at end of file
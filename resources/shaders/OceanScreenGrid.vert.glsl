@@ -1,12 +1,55 @@
 /* Author: BAIRAC MIHAI */
 
+#ifdef PROCEDURAL_GRID
+// there is no vertex buffer, the vertex is computed from gl_VertexID (check Ocean::SetupScreenSpaceGrid())
+struct ProceduralGridData
+{
+	int Width; // vertices per row
+	int Height; // rows
+	vec2 Origin; // clip space position of the first vertex
+	vec2 Step; // clip space distance between two vertices
+};
+uniform ProceduralGridData u_ProceduralGridData;
+
+vec3 a_position;
+vec2 a_uv;
+
+// same zig-zag triangle strip as the screen space grid indices
+void computeProceduralGridVertex (void)
+{
+	int rowVertexCount = 2 * u_ProceduralGridData.Width;
+	int row = gl_VertexID / rowVertexCount;
+	int column = (gl_VertexID - row * rowVertexCount) / 2;
+
+	bool isEvenRow = (row % 2 == 0);
+	bool isEvenVertex = (gl_VertexID % 2 == 0);
+
+	if (!isEvenRow)
+	{
+		column = u_ProceduralGridData.Width - 1 - column;
+	}
+
+	if (isEvenRow != isEvenVertex)
+	{
+		++ row;
+	}
+
+	a_position = vec3(u_ProceduralGridData.Origin + vec2(column, row) * u_ProceduralGridData.Step, 0.0f);
+	a_uv = vec2(column, row) / vec2(u_ProceduralGridData.Width, u_ProceduralGridData.Height);
+}
+#else
 in vec3 a_position;
 in vec2 a_uv;
+#endif // PROCEDURAL_GRID
 
 out vec2 v_uv;
 
 void main (void)
 {	
+#ifdef PROCEDURAL_GRID
+	computeProceduralGridVertex();
+#endif // PROCEDURAL_GRID
+
 	gl_PointSize = 5; //Wireframe
 
 	v_uv = a_uv;
@@ -0,0 +1,280 @@
+/* Author: BAIRAC MIHAI
+
+The perlin noise sampling algorithm is based on the nVidia Direct3D SDK11 OceanCS sample code
+Code: https://developer.nvidia.com/dx11-samples
+License: download the package and check the License.pdf file
+
+*/
+
+// Uniform blocks (check UniformBufferManager)
+layout(std140) uniform CameraBlock
+{
+	mat4 u_WorldToCameraMatrix;
+	mat4 u_WorldToClipMatrix;
+	mat4 u_ClipToCameraMatrix;
+	mat4 u_CameraToWorldMatrix;
+	vec3 u_CameraPosition;
+};
+
+layout(std140) uniform OceanPatchBlock
+{
+	vec2 u_PerlinNoiseMovement;
+	float u_WindSpeed;
+	bool u_IsUnderWater;
+};
+
+layout(std140) uniform BoatEffectsBlock
+{
+	vec3 u_BoatPosition;
+	float u_BoatKelvinWakeAmplitude;
+	vec3 u_BoatWakePosition;
+	float u_BoatKelvinWakeFoamAmount;
+};
+
+// FFT Ocean Patch data
+struct FFTOceanPatchData 
+{
+	sampler2DArray FFTWaveDataMap;
+	sampler2D NormalGradientFoldingMap;
+
+	float PatchSize;
+	float WaveAmplitude;
+	float WindSpeedMixLimit;
+	float ChoppyScale;
+	float TileScale;
+	bool UseFFTSlopes;
+	// the other cascades (only for CFT_CPU_FFTW type), cascade c starts at layer c * (UseFFTSlopes ? 2 : 1)
+	int CascadeCount;
+	vec4 CascadeUVScales;
+};
+uniform FFTOceanPatchData u_FFTOceanPatchData;
+
+// the FFT displacement was already sampled on the CPU
+uniform bool u_UseCPUDisplacement;
+
+// Perlin Noise Data
+struct PerlinNoiseData
+{	
+	sampler2D DisplacementMap;
+	vec3 Octaves;
+	vec3 Amplitudes;
+	vec3 Gradients;
+};
+uniform PerlinNoiseData u_PerlinNoiseData;
+
+struct WaveBlending 
+{
+	float Begin;
+	float End;
+};
+uniform WaveBlending u_WaveBlending;
+
+// used by both BOAT_FOAM and BOAT_KELVIN_WAKE
+struct BoatKelvinWakeData 
+{
+	sampler2D DispNormMap;
+	sampler2D FoamMap;
+	float Scale;
+};
+uniform BoatKelvinWakeData u_BoatKelvinWakeData;
+//
+
+// generated on the CPU, check CPUProjectedGrid
+in vec3 a_position; // world space position on the ocean plane
+in vec3 a_displacement; // FFT displacement
+
+out vec2 v_scaledUV;
+out vec3 v_worldDispPos;
+out vec3 v_worldPos;
+out float v_blendFactor;
+out float v_fogCoord;
+out vec4 v_clipPos; //for local reflections + refractions
+
+// used by both BOAT_FOAM and BOAT_KELVIN_WAKE
+out vec2 v_boatEffectBaseUV;
+//
+
+
+float calculateWaveDisplacementAttenuation (float d, float dmin, float dmax)
+{
+	//source:
+	// http://stackoverflow.com/questions/33508269/projected-grid-water-horizon-detail
+	// http://computergraphics.stackexchange.com/questions/1681/projected-grid-water-horizon-detail
+
+    // Quadratic curve that is 1 at dmin and 0 at dmax
+    // Constant 1 for less than dmin, constant 0 for more than dmax
+
+    float att = d > dmax ? 0.0f: clamp(0.0f, 1.0f, (1.0f / ((dmin - dmax) * (dmin - dmax))) * ((d - dmax) * (d - dmax)));
+
+	att = clamp(att, 0.0f, 1.0f);
+
+	return att;
+}
+
+vec3 computePerlinDisplacement (vec2 scaledUV)
+{
+	vec3 perlinDisp = vec3(0.0f);
+
+	vec3 perlinAmplitudes = u_WindSpeed * u_PerlinNoiseData.Amplitudes;
+
+	if (v_blendFactor < 1.0f)
+	{
+		vec2 perlinUV_1 = scaledUV * u_PerlinNoiseData.Octaves.x + u_PerlinNoiseMovement;
+		vec2 perlinUV_2 = scaledUV * u_PerlinNoiseData.Octaves.y + u_PerlinNoiseMovement;
+		vec2 perlinUV_3 = scaledUV * u_PerlinNoiseData.Octaves.z + u_PerlinNoiseMovement;
+
+		perlinDisp.y += texture(u_PerlinNoiseData.DisplacementMap, perlinUV_1).w * perlinAmplitudes.x;
+		perlinDisp.y += texture(u_PerlinNoiseData.DisplacementMap, perlinUV_2).w * perlinAmplitudes.y;
+		perlinDisp.y += texture(u_PerlinNoiseData.DisplacementMap, perlinUV_3).w * perlinAmplitudes.z;
+	}
+
+	return perlinDisp;
+}
+
+vec3 computeFFTDisplacement (vec2 scaledUV)
+{
+	vec3 fftDisp = vec3(0.0f);
+
+	if (v_blendFactor > 0.0f)
+	{
+		if (u_UseCPUDisplacement)
+		{
+			fftDisp = a_displacement;
+		}
+		else
+		{
+			// the grid has no neighbours to compute the gradients from, so the base level is sampled
+			fftDisp = textureLod(u_FFTOceanPatchData.FFTWaveDataMap, vec3(scaledUV, 0), 0.0f).xyz;
+		}
+
+		// the CPU displacement has only the first cascade
+		int cascadeLayerCount = (u_FFTOceanPatchData.UseFFTSlopes ? 2 : 1);
+		for (int c = 1; c < u_FFTOceanPatchData.CascadeCount; ++ c)
+		{
+			fftDisp += textureLod(u_FFTOceanPatchData.FFTWaveDataMap, vec3(scaledUV * u_FFTOceanPatchData.CascadeUVScales[c], c * cascadeLayerCount), 0.0f).xyz;
+		}
+		fftDisp.xz *= u_FFTOceanPatchData.ChoppyScale; ////
+	}
+
+	return fftDisp;
+}
+
+float computeBoatKelvinWakeDisplacement(void)
+{
+	float bowWakeDisp = 0.0f;
+
+#ifdef BOAT_KELVIN_WAKE // inspired from SunDog Triton Demo ocean shaders
+	//////// BOW WAKE - in front of the boat ////////
+	// center them to boat position
+	vec2 bowWakeDispUV = v_boatEffectBaseUV;
+
+	ivec2 texSize = textureSize(u_BoatKelvinWakeData.DispNormMap, 0);
+	bowWakeDispUV += vec2(texSize.x, texSize.y * 0.4f);
+	bowWakeDispUV /= (texSize * u_BoatKelvinWakeData.Scale);
+
+	// alpha channel holds the displacement!
+	vec4 data = texture(u_BoatKelvinWakeData.DispNormMap, bowWakeDispUV);
+
+	float wakeDisp = data.w;
+	wakeDisp = (wakeDisp < 0.02f ? 0.0f : wakeDisp); // to eliminate artifacts
+
+	bowWakeDisp = wakeDisp * u_BoatKelvinWakeAmplitude;
+#endif // BOAT_KELVIN_WAKE
+
+	return bowWakeDisp;
+}
+
+void computeBoatBaseEffectUV(vec3 worldPos)
+{
+// used by both BOAT_FOAM and BOAT_KELVIN_WAKE
+	// compute the position
+	vec3 Pos = worldPos - u_BoatPosition;
+	
+	vec3 P = u_BoatWakePosition - u_BoatPosition;
+
+	// compute the frame to rotate on
+	vec3 Forward = normalize(P);
+    vec3 Up = vec3(0.0f, 1.0f, 0.0f);
+    vec3 Right = normalize(cross(Up, Forward));
+
+	// compute the UVs
+	v_boatEffectBaseUV.x = dot(Pos.xz, Right.xz);
+	v_boatEffectBaseUV.y = dot(Pos.xz, Forward.xz);
+//
+}
+
+void main (void)
+{
+	// the grid is already projected on the ocean plane
+	vec3 worldPos = a_position;
+	
+	/////////////////////////////////////////////////////////////////
+
+	// patch size is different from grid size !!!
+	vec2 uv = worldPos.xz / u_FFTOceanPatchData.PatchSize;
+
+	// NOTE! uncommenting this code we can see patches
+	//uv = max(floor(uv), 1.0f) + fract(uv);
+
+	// when making texture lookups in fragment shader it has access to per-attribute gradients (partial derivates)
+	// for the primitive currently being shaded, and it uses this information to determine which LOD to fetch neighboring texels from during filtering.
+	// the vertex sahder and geometry shader stages don't have access to such info, so in those stages the LOD can't be determinated correctly automatically/implicitly.
+	// To allow this the textureLod() and textureGrad() where introduces. The LOD is sampled from mipmaps. If there is no mipmaps then the base lod (the original texture) will be used.
+	// Because hardware is limited it is good to use these functions, even if one new hardware the use of them may not be necesarry, you never know on what hardware the program may be runned on :)
+	// dFdx() and dFdy() (partial derivatives) are available only in fragment shader for reasons explained above.
+	// https://www.opengl.org/registry/specs/EXT/geometry_shader4.txt
+	// http://stackoverflow.com/questions/28983192/why-no-access-to-texture-lod-in-fragment-shader
+	// https://rendermeapangolin.wordpress.com/2015/05/27/opengl-texture-lod/
+	// https://rendermeapangolin.wordpress.com/2015/05/26/screen-space-grid/
+
+	vec2 scaledUV = uv * u_FFTOceanPatchData.TileScale;
+
+	//////////////////
+	float dist = length(u_CameraPosition.xz - worldPos.xz);
+
+	// better and smoother blending !!!
+	// make blend factor the same with falloff factor
+	//v_blendFactor = calculateWaveDisplacementAttenuation(dist, u_WaveBlending.Begin, u_WaveBlending.End);
+	v_blendFactor = clamp((u_WaveBlending.End - dist) / (u_WaveBlending.End - u_WaveBlending.Begin), 0.0f, 1.0f);
+
+	// FOR DEBUGGING
+	//v_blendFactor = 1.0f - v_blendFactor; //inverse displacement
+	//v_blendFactor = 0.0f; //only perlin noise
+	//v_blendFactor = 1.0f; //only fft
+
+	vec3 disp = vec3(0.0f);
+	vec3 perlinDisp = vec3(0.0f);
+	vec3 fftDisp = vec3(0.0f);
+
+	//////// PERLIN NOISE displacement //////////
+	perlinDisp = computePerlinDisplacement(scaledUV);
+
+	///////// FFT displacement ////////////
+	fftDisp = computeFFTDisplacement(scaledUV);
+
+	//disp = perlinDisp;
+	//disp = fftDisp;
+	disp = mix(perlinDisp, fftDisp, v_blendFactor);
+
+// used by both BOAT_FOAM and BOAT_KELVIN_WAKE
+	computeBoatBaseEffectUV(worldPos);
+//
+
+#ifdef BOAT_KELVIN_WAKE
+	disp.y += computeBoatKelvinWakeDisplacement();
+#endif // BOAT_KELVIN_WAKE
+
+	v_scaledUV = scaledUV;
+	v_worldPos = worldPos;
+	v_worldDispPos = v_worldPos + disp;
+
+	if (u_CameraPosition.y <= 0.0f)
+	{
+		vec4 v = u_WorldToCameraMatrix * vec4(v_worldPos, 1.0f);
+		v_fogCoord = abs(v.z / v.w);
+	}
+
+	////////////////////////////
+
+	gl_Position = v_clipPos = u_WorldToClipMatrix * vec4(v_worldDispPos, 1.0f);
+}
\ No newline at end of file
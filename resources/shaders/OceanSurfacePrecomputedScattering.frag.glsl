@@ -18,12 +18,43 @@ License: check the code
 */
 
 uniform float u_HDRExposure;
-uniform float u_CrrTime;
+
+// Uniform blocks (check UniformBufferManager)
+layout(std140) uniform CameraBlock
+{
+	mat4 u_WorldToCameraMatrix;
+	mat4 u_WorldToClipMatrix;
+	mat4 u_ClipToCameraMatrix;
+	mat4 u_CameraToWorldMatrix;
+	vec3 u_CameraPosition;
+};
+
+layout(std140) uniform SunBlock
+{
+	vec3 u_SunDirection;
+};
+
+layout(std140) uniform OceanPatchBlock
+{
+	vec2 u_PerlinNoiseMovement;
+	float u_WindSpeed;
+	bool u_IsUnderWater;
+};
+
+layout(std140) uniform BoatEffectsBlock
+{
+	vec3 u_BoatPosition;
+	float u_BoatKelvinWakeAmplitude;
+	vec3 u_BoatWakePosition;
+	float u_BoatKelvinWakeFoamAmount;
+};
 
 uniform sampler2D u_ReflectionMap;
 uniform sampler2D u_RefractionMap;
 uniform float u_ReflectionDistortFactor;
 uniform float u_RefractionDistortFactor;
+// the camera the maps were rendered with, they can be a few frames old
+uniform mat4 u_ReflRefrWorldToClipMatrix;
 
 uniform vec3 u_WaterColor;
 uniform vec3 u_WaterRefrColor;
@@ -31,10 +62,6 @@ uniform vec3 u_UnderWaterColor;
 
 uniform float u_MaxFadeAltitude;
 
-uniform vec3 u_CameraPosition;
-
-uniform bool u_IsUnderWater;
-
 // Precomputed Sky data used to compute the sun radiance reflection on water
 struct PrecomputedScatteringData
 {
@@ -54,11 +81,13 @@ struct FFTOceanPatchData
 
 	float PatchSize;
 	float WaveAmplitude;
-	float WindSpeed;
 	float WindSpeedMixLimit;
 	float ChoppyScale;
 	float TileScale;
 	bool UseFFTSlopes;
+	// the other cascades (only for CFT_CPU_FFTW type), cascade c starts at layer c * (UseFFTSlopes ? 2 : 1)
+	int CascadeCount;
+	vec4 CascadeUVScales;
 };
 uniform FFTOceanPatchData u_FFTOceanPatchData;
 
@@ -66,7 +95,6 @@ uniform FFTOceanPatchData u_FFTOceanPatchData;
 struct PerlinNoiseData
 {	
 	sampler2D DisplacementMap;
-	vec2 Movement;
 	vec3 Octaves;
 	vec3 Amplitudes;
 	vec3 Gradients;
@@ -103,13 +131,6 @@ struct UnderWaterFog
 uniform UnderWaterFog u_UnderWaterFog;
 #endif // UNDERWATER_FOG_SURFACE
 
-// Sun data
-struct SunData
-{
-	vec3 Direction;
-};
-uniform SunData u_SunData;
-
 
 #ifdef BOAT_FOAM
 struct BoatFoamData 
@@ -125,10 +146,6 @@ struct BoatKelvinWakeData
 {
 	sampler2D DispNormMap;
 	sampler2D FoamMap;
-	vec3 BoatPosition;
-	vec3 WakePosition;
-	float Amplitude;
-	float FoamAmount;
 	float Scale;
 };
 uniform BoatKelvinWakeData u_BoatKelvinWakeData;
@@ -336,11 +353,11 @@ vec2 computePerlinSlopes (void)
 {
 	vec2 perlinSlopes = vec2(0.0f);
 
-	vec3 perlinGradients = u_FFTOceanPatchData.WindSpeed * u_PerlinNoiseData.Gradients;
+	vec3 perlinGradients = u_WindSpeed * u_PerlinNoiseData.Gradients;
 
-	vec2 perlinUV_1 = v_blendFactor < 1.0f ? v_scaledUV * u_PerlinNoiseData.Octaves.x + u_PerlinNoiseData.Movement : vec2(0.0f);
-	vec2 perlinUV_2 = v_blendFactor < 1.0f ? v_scaledUV * u_PerlinNoiseData.Octaves.y + u_PerlinNoiseData.Movement : vec2(0.0f);
-	vec2 perlinUV_3 = v_blendFactor < 1.0f ? v_scaledUV * u_PerlinNoiseData.Octaves.z + u_PerlinNoiseData.Movement : vec2(0.0f);
+	vec2 perlinUV_1 = v_blendFactor < 1.0f ? v_scaledUV * u_PerlinNoiseData.Octaves.x + u_PerlinNoiseMovement : vec2(0.0f);
+	vec2 perlinUV_2 = v_blendFactor < 1.0f ? v_scaledUV * u_PerlinNoiseData.Octaves.y + u_PerlinNoiseMovement : vec2(0.0f);
+	vec2 perlinUV_3 = v_blendFactor < 1.0f ? v_scaledUV * u_PerlinNoiseData.Octaves.z + u_PerlinNoiseMovement : vec2(0.0f);
 
 	perlinSlopes += texture(u_PerlinNoiseData.DisplacementMap, perlinUV_1).xy * perlinGradients.x;
 	perlinSlopes += texture(u_PerlinNoiseData.DisplacementMap, perlinUV_2).xy * perlinGradients.y;
@@ -358,6 +375,11 @@ vec2 computeFFTSlopes (void)
 	if (u_FFTOceanPatchData.UseFFTSlopes)
 	{
 		fftSlopes = texture(u_FFTOceanPatchData.FFTWaveDataMap, vec3(fftUV, 1)).xy;
+
+		for (int c = 1; c < u_FFTOceanPatchData.CascadeCount; ++ c)
+		{
+			fftSlopes += texture(u_FFTOceanPatchData.FFTWaveDataMap, vec3(fftUV * u_FFTOceanPatchData.CascadeUVScales[c], 2 * c + 1)).xy;
+		}
 	}
 	else
 	{
@@ -391,7 +413,7 @@ vec2 computeBoatKelvinWakeSlopes (void)
 	wakeNorm = normalize(wakeNorm * 2.0f - 1.0f);
 
 
-	wakeNorm.xz *= min(1.0f, u_BoatKelvinWakeData.Amplitude);
+	wakeNorm.xz *= min(1.0f, u_BoatKelvinWakeAmplitude);
     wakeNorm = normalize(wakeNorm);
 
 	wakeSlopes = vec2(wakeNorm.x / wakeNorm.y, wakeNorm.z / wakeNorm.y);
@@ -520,7 +542,7 @@ vec3 computeBoatKelvinWakeEffectFoam (vec2 wakeSlope)
 	vec4 bowWakeColor = texture(u_BoatKelvinWakeData.FoamMap, bowWakeFoamUV * u_BoatKelvinWakeData.Scale);
 	float bowAlpha = (bowWakeColor.a < 0.02f ? 0.0f : bowWakeColor.a * 2.0f); // to eliminate artifact lines from 'clamp to edge' wrap type
 
-	float bowWakeFactor = u_BoatKelvinWakeData.FoamAmount * length(wakeSlope) * bowAlpha;
+	float bowWakeFactor = u_BoatKelvinWakeFoamAmount * length(wakeSlope) * bowAlpha;
 
 	bowWakeComponent = bowWakeFactor * bowWakeColor.rgb;
 	bowWakeComponent = min(bowWakeComponent, 1.0f);
@@ -558,12 +580,22 @@ float computeLightQuantityFactor (float lightDirY)
 
 
 
+#ifdef LAYERED_REFL_REFR
+// the reflection and the refraction maps are the halves of one double width map (check Application::RenderReflectedRefractedScene())
+// layer: 0 - reflection (left half), 1 - refraction (right half)
+vec2 computeLayerCoord (vec2 coord, float layer)
+{
+	// the distorted coordinates must not reach the other half
+	return vec2((clamp(coord.x, 0.0f, 1.0f) + layer) * 0.5f, coord.y);
+}
+#endif // LAYERED_REFL_REFR
+
 void main (void)
 {
 	vec3 viewDir = normalize(u_CameraPosition - v_worldDispPos); // from pixel to camera
 
 	// sun is considered a directional light source
-	vec3 lightDir = normalize(u_SunData.Direction); // from the sun ???
+	vec3 lightDir = normalize(u_SunDirection); // from the sun ???
 
 	vec3 normalDir = vec3(0.0f);
 	vec2 slopes = vec2(0.0f);
@@ -595,16 +627,24 @@ void main (void)
 	const float r = (1.2f - 1.0f)/(1.2f + 1.0f);		
 	float fresnelFactor = max(0.0f, min(1.0f, r + (1.0f - r) * pow(1.0f - dot(normalDir, viewDir), 5.0f)));
 
-	// coordinates for local reflection and refraction
+	// screen coordinates
 	vec2 coord = (v_clipPos.xy / v_clipPos.w) * 0.5f + 0.5f;
 
+	// coordinates for local reflection and refraction (reprojected)
+	vec4 reflRefrClipPos = u_ReflRefrWorldToClipMatrix * vec4(v_worldDispPos, 1.0f);
+	vec2 reflRefrCoord = (reflRefrClipPos.xy / reflRefrClipPos.w) * 0.5f + 0.5f;
+
 	vec3 finalColor = vec3(0.0f);
 
 	if (u_IsUnderWater)
 	{
 		//// refraction
 		vec2 refrOffset = normalDir.xz * u_RefractionDistortFactor;
-		vec3 refraction = texture(u_RefractionMap, coord + refrOffset).rgb;
+		vec2 refrCoord = reflRefrCoord + refrOffset;
+#ifdef LAYERED_REFL_REFR
+		refrCoord = computeLayerCoord(refrCoord, 1.0f);
+#endif // LAYERED_REFL_REFR
+		vec3 refraction = texture(u_RefractionMap, refrCoord).rgb;
 
 		finalColor = mix(refraction, u_UnderWaterColor, 0.7f);
 
@@ -622,11 +662,15 @@ void main (void)
 	{	
 		//// reflection
 		vec2 reflOffset = normalDir.xz * u_ReflectionDistortFactor; 
-		vec3 reflection = texture(u_ReflectionMap, coord + reflOffset).rgb;
+		vec2 reflCoord = reflRefrCoord + reflOffset;
+#ifdef LAYERED_REFL_REFR
+		reflCoord = computeLayerCoord(reflCoord, 0.0f);
+#endif // LAYERED_REFL_REFR
+		vec3 reflection = texture(u_ReflectionMap, reflCoord).rgb;
 
 
 		// much better visually! - reduced the reflection color by mixing it with another flat color
-		float mixFactor = clamp(u_FFTOceanPatchData.WindSpeed / u_FFTOceanPatchData.WindSpeedMixLimit, 0.0f, 1.0f) * fresnelFactor;
+		float mixFactor = clamp(u_WindSpeed / u_WindSpeedMixLimit, 0.0f, 1.0f) * fresnelFactor;
 		finalColor = mix(u_WaterRefrColor, mix(reflection, u_WaterColor, mixFactor), fresnelFactor);
 
 		float fadeAltitude = (u_MaxFadeAltitude - u_CameraPosition.y) / u_MaxFadeAltitude;
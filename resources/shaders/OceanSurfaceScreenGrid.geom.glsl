@@ -13,15 +13,30 @@ layout (triangle_strip, max_vertices = 3) out;
 uniform mat4 u_ProjectingMatrix;
 uniform float u_PlaneDistance;
 
-// Matrices
-uniform mat4 u_WorldToCameraMatrix;
-uniform mat4 u_WorldToClipMatrix;
-uniform mat4 u_ClipToCameraMatrix;
-uniform mat4 u_CameraToWorldMatrix;
+// Uniform blocks (check UniformBufferManager)
+layout(std140) uniform CameraBlock
+{
+	mat4 u_WorldToCameraMatrix;
+	mat4 u_WorldToClipMatrix;
+	mat4 u_ClipToCameraMatrix;
+	mat4 u_CameraToWorldMatrix;
+	vec3 u_CameraPosition;
+};
 
-uniform vec3 u_CameraPosition;
+layout(std140) uniform OceanPatchBlock
+{
+	vec2 u_PerlinNoiseMovement;
+	float u_WindSpeed;
+	bool u_IsUnderWater;
+};
 
-uniform float u_CrrTime;
+layout(std140) uniform BoatEffectsBlock
+{
+	vec3 u_BoatPosition;
+	float u_BoatKelvinWakeAmplitude;
+	vec3 u_BoatWakePosition;
+	float u_BoatKelvinWakeFoamAmount;
+};
 
 // FFT Ocean Patch data
 struct FFTOceanPatchData 
@@ -31,11 +46,13 @@ struct FFTOceanPatchData
 
 	float PatchSize;
 	float WaveAmplitude;
-	float WindSpeed;
 	float WindSpeedMixLimit;
 	float ChoppyScale;
 	float TileScale;
 	bool UseFFTSlopes;
+	// the other cascades (only for CFT_CPU_FFTW type), cascade c starts at layer c * (UseFFTSlopes ? 2 : 1)
+	int CascadeCount;
+	vec4 CascadeUVScales;
 };
 uniform FFTOceanPatchData u_FFTOceanPatchData;
 
@@ -43,7 +60,6 @@ uniform FFTOceanPatchData u_FFTOceanPatchData;
 struct PerlinNoiseData
 {	
 	sampler2D DisplacementMap;
-	vec2 Movement;
 	vec3 Octaves;
 	vec3 Amplitudes;
 	vec3 Gradients;
@@ -62,10 +78,6 @@ struct BoatKelvinWakeData
 {
 	sampler2D DispNormMap;
 	sampler2D FoamMap;
-	vec3 BoatPosition;
-	vec3 WakePosition;
-	float Amplitude;
-	float FoamAmount;
 	float Scale;
 };
 uniform BoatKelvinWakeData u_BoatKelvinWakeData;
@@ -154,13 +166,13 @@ vec3 computePerlinDisplacement (vec2 scaledUV)
 {
 	vec3 perlinDisp = vec3(0.0f);
 
-	vec3 perlinAmplitudes = u_FFTOceanPatchData.WindSpeed * u_PerlinNoiseData.Amplitudes;
+	vec3 perlinAmplitudes = u_WindSpeed * u_PerlinNoiseData.Amplitudes;
 
 	if (v_blendFactor < 1.0f)
 	{
-		vec2 perlinUV_1 = scaledUV * u_PerlinNoiseData.Octaves.x + u_PerlinNoiseData.Movement;
-		vec2 perlinUV_2 = scaledUV * u_PerlinNoiseData.Octaves.y + u_PerlinNoiseData.Movement;
-		vec2 perlinUV_3 = scaledUV * u_PerlinNoiseData.Octaves.z + u_PerlinNoiseData.Movement;
+		vec2 perlinUV_1 = scaledUV * u_PerlinNoiseData.Octaves.x + u_PerlinNoiseMovement;
+		vec2 perlinUV_2 = scaledUV * u_PerlinNoiseData.Octaves.y + u_PerlinNoiseMovement;
+		vec2 perlinUV_3 = scaledUV * u_PerlinNoiseData.Octaves.z + u_PerlinNoiseMovement;
 
 		perlinDisp.y += texture(u_PerlinNoiseData.DisplacementMap, perlinUV_1).w * perlinAmplitudes.x;
 		perlinDisp.y += texture(u_PerlinNoiseData.DisplacementMap, perlinUV_2).w * perlinAmplitudes.y;
@@ -176,8 +188,15 @@ vec3 computeFFTDisplacement (vec2 scaledUV)
 
 	if (v_blendFactor > 0.0f)
 	{
+		int cascadeLayerCount = (u_FFTOceanPatchData.UseFFTSlopes ? 2 : 1);
+
 #ifdef USE_GRID_CORNERS_SURFACE
 		fftDisp = texture(u_FFTOceanPatchData.FFTWaveDataMap, vec3(scaledUV, 0)).xyz;
+
+		for (int c = 1; c < u_FFTOceanPatchData.CascadeCount; ++ c)
+		{
+			fftDisp += texture(u_FFTOceanPatchData.FFTWaveDataMap, vec3(scaledUV * u_FFTOceanPatchData.CascadeUVScales[c], c * cascadeLayerCount)).xyz;
+		}
 #else
 
 		/// working ok with this setup
@@ -197,6 +216,13 @@ vec3 computeFFTDisplacement (vec2 scaledUV)
 
 		fftDisp = textureGrad(u_FFTOceanPatchData.FFTWaveDataMap, vec3(scaledUV, 0), scaledDUDX, scaledDUDY).xyz;
 		//fftDisp = texture(u_FFTOceanPatchData.FFTWaveDataMap, vec3(scaledUV, 0)).xyz;
+
+		// the gradients scale with the uv
+		for (int c = 1; c < u_FFTOceanPatchData.CascadeCount; ++ c)
+		{
+			float uvScale = u_FFTOceanPatchData.CascadeUVScales[c];
+			fftDisp += textureGrad(u_FFTOceanPatchData.FFTWaveDataMap, vec3(scaledUV * uvScale, c * cascadeLayerCount), scaledDUDX * uvScale, scaledDUDY * uvScale).xyz;
+		}
 #endif // USE_GRID_CORNERS_SURFACE
 		fftDisp.xz *= u_FFTOceanPatchData.ChoppyScale; ////
 	}
@@ -223,7 +249,7 @@ float computeBoatKelvinWakeDisplacement (void)
 	float wakeDisp = data.w;
 	wakeDisp = (wakeDisp < 0.02f ? 0.0f : wakeDisp); // to eliminate artifacts
 
-	bowWakeDisp = wakeDisp * u_BoatKelvinWakeData.Amplitude;
+	bowWakeDisp = wakeDisp * u_BoatKelvinWakeAmplitude;
 #endif // BOAT_KELVIN_WAKE
 
 	return bowWakeDisp;
@@ -233,9 +259,9 @@ void computeBoatBaseEffectUV(vec3 worldPos)
 {
 // used by both BOAT_FOAM and BOAT_KELVIN_WAKE
 	// compute the position
-	vec3 Pos = worldPos - u_BoatKelvinWakeData.BoatPosition;
+	vec3 Pos = worldPos - u_BoatPosition;
 	
-	vec3 P = u_BoatKelvinWakeData.WakePosition - u_BoatKelvinWakeData.BoatPosition;
+	vec3 P = u_BoatWakePosition - u_BoatPosition;
 
 	// compute the frame to rotate on
 	vec3 Forward = normalize(P);
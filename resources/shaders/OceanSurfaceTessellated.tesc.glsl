@@ -0,0 +1,94 @@
+/* Author: BAIRAC MIHAI
+
+ The tessellation levels are computed from the screen space length of the patch edges,
+ the shared edges of the neighbour patches get the same levels, so there are no cracks
+
+*/
+
+layout(vertices = 4) out;
+
+// Uniform blocks (check UniformBufferManager)
+layout(std140) uniform CameraBlock
+{
+	mat4 u_WorldToCameraMatrix;
+	mat4 u_WorldToClipMatrix;
+	mat4 u_ClipToCameraMatrix;
+	mat4 u_CameraToWorldMatrix;
+	vec3 u_CameraPosition;
+};
+
+// check Ocean::UpdateTessellatedGrid()
+struct TessellatedData
+{
+	vec2 Origin; // the grid origin, snapped to the patch size
+	float PatchSize;
+	vec4 FrustumPlanes[6]; // world space, pointing inwards
+	vec4 Bounds; // x - lowest wave height, y - highest wave height, z - horizontal wave displacement
+	float TessFactor; // ProjectionMatrix[1][1] * ViewportHeight / (2 * TargetEdgeLength)
+	float MaxTessLevel;
+};
+uniform TessellatedData u_TessellatedData;
+
+in vec3 v_patchPos[];
+
+out vec3 tc_patchPos[];
+
+
+// how many TargetEdgeLength pixels the edge covers on the screen
+float computeEdgeTessLevel (vec3 p0, vec3 p1)
+{
+	vec3 edgeCentre = 0.5f * (p0 + p1);
+
+	float dist = max(length(u_CameraPosition - edgeCentre), 0.001f);
+
+	return clamp(length(p1 - p0) * u_TessellatedData.TessFactor / dist, 1.0f, u_TessellatedData.MaxTessLevel);
+}
+
+bool isPatchVisible (void)
+{
+	// the waves displace the vertices in all directions
+	vec3 boxMin = vec3(min(min(v_patchPos[0].x, v_patchPos[1].x), min(v_patchPos[2].x, v_patchPos[3].x)) - u_TessellatedData.Bounds.z, u_TessellatedData.Bounds.x,
+					   min(min(v_patchPos[0].z, v_patchPos[1].z), min(v_patchPos[2].z, v_patchPos[3].z)) - u_TessellatedData.Bounds.z);
+	vec3 boxMax = vec3(max(max(v_patchPos[0].x, v_patchPos[1].x), max(v_patchPos[2].x, v_patchPos[3].x)) + u_TessellatedData.Bounds.z, u_TessellatedData.Bounds.y,
+					   max(max(v_patchPos[0].z, v_patchPos[1].z), max(v_patchPos[2].z, v_patchPos[3].z)) + u_TessellatedData.Bounds.z);
+
+	// check HelperFunctions::IsBoxInsideFrustum()
+	for (int i = 0; i < 6; ++ i)
+	{
+		vec4 plane = u_TessellatedData.FrustumPlanes[i];
+		vec3 positiveVertex = mix(boxMin, boxMax, step(0.0f, plane.xyz));
+
+		if (dot(plane.xyz, positiveVertex) + plane.w < 0.0f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void main (void)
+{
+	tc_patchPos[gl_InvocationID] = v_patchPos[gl_InvocationID];
+
+	if (gl_InvocationID == 0)
+	{
+		if (isPatchVisible())
+		{
+			// the patch vertices are (0, 0), (1, 0), (1, 1), (0, 1) in the uv space
+			gl_TessLevelOuter[0] = computeEdgeTessLevel(v_patchPos[3], v_patchPos[0]); // u = 0
+			gl_TessLevelOuter[1] = computeEdgeTessLevel(v_patchPos[0], v_patchPos[1]); // v = 0
+			gl_TessLevelOuter[2] = computeEdgeTessLevel(v_patchPos[1], v_patchPos[2]); // u = 1
+			gl_TessLevelOuter[3] = computeEdgeTessLevel(v_patchPos[2], v_patchPos[3]); // v = 1
+
+			gl_TessLevelInner[0] = max(gl_TessLevelOuter[1], gl_TessLevelOuter[3]);
+			gl_TessLevelInner[1] = max(gl_TessLevelOuter[0], gl_TessLevelOuter[2]);
+		}
+		else
+		{
+			// a zero outer level discards the patch
+			gl_TessLevelOuter[0] = gl_TessLevelOuter[1] = gl_TessLevelOuter[2] = gl_TessLevelOuter[3] = 0.0f;
+			gl_TessLevelInner[0] = gl_TessLevelInner[1] = 0.0f;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+/* Author: BAIRAC MIHAI */
+
+uniform float u_PlaneDistance;
+
+// check Ocean::UpdateTessellatedGrid()
+struct TessellatedData
+{
+	vec2 Origin; // the grid origin, snapped to the patch size
+	float PatchSize;
+	vec4 FrustumPlanes[6]; // world space, pointing inwards
+	vec4 Bounds; // x - lowest wave height, y - highest wave height, z - horizontal wave displacement
+	float TessFactor; // ProjectionMatrix[1][1] * ViewportHeight / (2 * TargetEdgeLength)
+	float MaxTessLevel;
+};
+uniform TessellatedData u_TessellatedData;
+
+// shared by all the patches
+in vec3 a_position; // patch grid vertex coordinates, xz in [0, PatchCount]
+
+out vec3 v_patchPos;
+
+
+void main (void)
+{
+	// the plane distance is measured along the plane normal (0, 1, 0)
+	// the displacement is done after the tessellation, check OceanSurfaceTessellated.tese.glsl
+	v_patchPos = vec3(u_TessellatedData.Origin.x + a_position.x * u_TessellatedData.PatchSize, - u_PlaneDistance, u_TessellatedData.Origin.y + a_position.z * u_TessellatedData.PatchSize);
+}
\ No newline at end of file
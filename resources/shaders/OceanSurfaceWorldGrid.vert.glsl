@@ -10,13 +10,30 @@ License: download the package and check the License.pdf file
 uniform mat4 u_ProjectingMatrix;
 uniform float u_PlaneDistance;
 
-// Matrices
-uniform mat4 u_WorldToCameraMatrix;
-uniform mat4 u_WorldToClipMatrix;
+// Uniform blocks (check UniformBufferManager)
+layout(std140) uniform CameraBlock
+{
+	mat4 u_WorldToCameraMatrix;
+	mat4 u_WorldToClipMatrix;
+	mat4 u_ClipToCameraMatrix;
+	mat4 u_CameraToWorldMatrix;
+	vec3 u_CameraPosition;
+};
 
-uniform vec3 u_CameraPosition;
+layout(std140) uniform OceanPatchBlock
+{
+	vec2 u_PerlinNoiseMovement;
+	float u_WindSpeed;
+	bool u_IsUnderWater;
+};
 
-uniform float u_CrrTime;
+layout(std140) uniform BoatEffectsBlock
+{
+	vec3 u_BoatPosition;
+	float u_BoatKelvinWakeAmplitude;
+	vec3 u_BoatWakePosition;
+	float u_BoatKelvinWakeFoamAmount;
+};
 
 // FFT Ocean Patch data
 struct FFTOceanPatchData 
@@ -26,11 +43,13 @@ struct FFTOceanPatchData
 
 	float PatchSize;
 	float WaveAmplitude;
-	float WindSpeed;
 	float WindSpeedMixLimit;
 	float ChoppyScale;
 	float TileScale;
 	bool UseFFTSlopes;
+	// the other cascades (only for CFT_CPU_FFTW type), cascade c starts at layer c * (UseFFTSlopes ? 2 : 1)
+	int CascadeCount;
+	vec4 CascadeUVScales;
 };
 uniform FFTOceanPatchData u_FFTOceanPatchData;
 
@@ -38,7 +57,6 @@ uniform FFTOceanPatchData u_FFTOceanPatchData;
 struct PerlinNoiseData
 {	
 	sampler2D DisplacementMap;
-	vec2 Movement;
 	vec3 Octaves;
 	vec3 Amplitudes;
 	vec3 Gradients;
@@ -57,16 +75,47 @@ struct BoatKelvinWakeData
 {
 	sampler2D DispNormMap;
 	sampler2D FoamMap;
-	vec3 BoatPosition;
-	vec3 WakePosition;
-	float Amplitude;
-	float FoamAmount;
 	float Scale;
 };
 uniform BoatKelvinWakeData u_BoatKelvinWakeData;
 //
 
+#ifdef PROCEDURAL_GRID
+// there is no vertex buffer, the uv is computed from gl_VertexID (check Ocean::SetupGrid())
+struct ProceduralGridData
+{
+	int Width; // vertices per row
+	int Height; // rows
+};
+uniform ProceduralGridData u_ProceduralGridData;
+
+vec2 a_uv;
+
+// same zig-zag triangle strip as the world space grid indices
+vec2 computeProceduralGridUV (void)
+{
+	int rowVertexCount = 2 * u_ProceduralGridData.Width;
+	int row = gl_VertexID / rowVertexCount;
+	int column = (gl_VertexID - row * rowVertexCount) / 2;
+
+	bool isEvenRow = (row % 2 == 0);
+	bool isEvenVertex = (gl_VertexID % 2 == 0);
+
+	if (!isEvenRow)
+	{
+		column = u_ProceduralGridData.Width - 1 - column;
+	}
+
+	if (isEvenRow == isEvenVertex)
+	{
+		++ row;
+	}
+
+	return vec2(column, row) / vec2(u_ProceduralGridData.Width - 1, u_ProceduralGridData.Height - 1);
+}
+#else
 in vec2 a_uv;
+#endif // PROCEDURAL_GRID
 
 out vec2 v_scaledUV;
 out vec3 v_worldDispPos;
@@ -167,13 +216,13 @@ vec3 computePerlinDisplacement (vec2 scaledUV)
 {
 	vec3 perlinDisp = vec3(0.0f);
 
-	vec3 perlinAmplitudes = u_FFTOceanPatchData.WindSpeed * u_PerlinNoiseData.Amplitudes;
+	vec3 perlinAmplitudes = u_WindSpeed * u_PerlinNoiseData.Amplitudes;
 
 	if (v_blendFactor < 1.0f)
 	{
-		vec2 perlinUV_1 = scaledUV * u_PerlinNoiseData.Octaves.x + u_PerlinNoiseData.Movement;
-		vec2 perlinUV_2 = scaledUV * u_PerlinNoiseData.Octaves.y + u_PerlinNoiseData.Movement;
-		vec2 perlinUV_3 = scaledUV * u_PerlinNoiseData.Octaves.z + u_PerlinNoiseData.Movement;
+		vec2 perlinUV_1 = scaledUV * u_PerlinNoiseData.Octaves.x + u_PerlinNoiseMovement;
+		vec2 perlinUV_2 = scaledUV * u_PerlinNoiseData.Octaves.y + u_PerlinNoiseMovement;
+		vec2 perlinUV_3 = scaledUV * u_PerlinNoiseData.Octaves.z + u_PerlinNoiseMovement;
 
 		perlinDisp.y += texture(u_PerlinNoiseData.DisplacementMap, perlinUV_1).w * perlinAmplitudes.x;
 		perlinDisp.y += texture(u_PerlinNoiseData.DisplacementMap, perlinUV_2).w * perlinAmplitudes.y;
@@ -189,8 +238,15 @@ vec3 computeFFTDisplacement (vec3 worldPos, vec2 scaledUV)
 
 	if (v_blendFactor > 0.0f)
 	{
+		int cascadeLayerCount = (u_FFTOceanPatchData.UseFFTSlopes ? 2 : 1);
+
 #ifdef USE_GRID_CORNERS_SURFACE
 		fftDisp = texture(u_FFTOceanPatchData.FFTWaveDataMap, vec3(scaledUV, 0)).xyz;
+
+		for (int c = 1; c < u_FFTOceanPatchData.CascadeCount; ++ c)
+		{
+			fftDisp += texture(u_FFTOceanPatchData.FFTWaveDataMap, vec3(scaledUV * u_FFTOceanPatchData.CascadeUVScales[c], c * cascadeLayerCount)).xyz;
+		}
 #else
 
 		/// working ok with this setup
@@ -210,6 +266,13 @@ vec3 computeFFTDisplacement (vec3 worldPos, vec2 scaledUV)
 
 		fftDisp = textureGrad(u_FFTOceanPatchData.FFTWaveDataMap, vec3(scaledUV, 0), scaledDUDX, scaledDUDY).xyz;
 		//fftDisp = texture(u_FFTOceanPatchData.FFTWaveDataMap, vec3(scaledUV, 0)).xyz;
+
+		// the gradients scale with the uv
+		for (int c = 1; c < u_FFTOceanPatchData.CascadeCount; ++ c)
+		{
+			float uvScale = u_FFTOceanPatchData.CascadeUVScales[c];
+			fftDisp += textureGrad(u_FFTOceanPatchData.FFTWaveDataMap, vec3(scaledUV * uvScale, c * cascadeLayerCount), scaledDUDX * uvScale, scaledDUDY * uvScale).xyz;
+		}
 #endif // USE_GRID_CORNERS_SURFACE
 		fftDisp.xz *= u_FFTOceanPatchData.ChoppyScale; ////
 	}
@@ -236,7 +299,7 @@ float computeBoatKelvinWakeDisplacement(void)
 	float wakeDisp = data.w;
 	wakeDisp = (wakeDisp < 0.02f ? 0.0f : wakeDisp); // to eliminate artifacts
 
-	bowWakeDisp = wakeDisp * u_BoatKelvinWakeData.Amplitude;
+	bowWakeDisp = wakeDisp * u_BoatKelvinWakeAmplitude;
 #endif // BOAT_KELVIN_WAKE
 
 	return bowWakeDisp;
@@ -246,9 +309,9 @@ void computeBoatBaseEffectUV(vec3 worldPos)
 {
 // used by both BOAT_FOAM and BOAT_KELVIN_WAKE
 	// compute the position
-	vec3 Pos = worldPos - u_BoatKelvinWakeData.BoatPosition;
+	vec3 Pos = worldPos - u_BoatPosition;
 	
-	vec3 P = u_BoatKelvinWakeData.WakePosition - u_BoatKelvinWakeData.BoatPosition;
+	vec3 P = u_BoatWakePosition - u_BoatPosition;
 
 	// compute the frame to rotate on
 	vec3 Forward = normalize(P);
@@ -265,6 +328,10 @@ void main (void)
 {
 	vec3 worldPos = vec3(0.0f);
 
+#ifdef PROCEDURAL_GRID
+	a_uv = computeProceduralGridUV();
+#endif // PROCEDURAL_GRID
+
 #ifdef USE_GRID_CORNERS_SURFACE
 	// by computing the grid vertex positions on CPU based on the 4 edges of the grid we avoid interpolation and float precision errors
 	vec4 result = mix(mix(u_ProjectingMatrix[0], u_ProjectingMatrix[1], a_uv.x), mix(u_ProjectingMatrix[2], u_ProjectingMatrix[3], a_uv.x), a_uv.y);
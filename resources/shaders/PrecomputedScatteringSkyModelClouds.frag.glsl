@@ -28,10 +28,12 @@ uniform vec3 u_SunDirection;
 
 struct CloudsData 
 {
-	sampler2D NoiseMap;
-	int Octaves;
-	float Lacunarity;
-	float Gain;
+	// the octaves summed up on the CPU (check CloudsNoiseGenerator.h)
+	// layer 0 - a full group of octaves, layer 1 - the last group
+	sampler2DArray NoiseMap;
+	int GroupCount;
+	mat2 GroupMatrix;
+	float GroupGain;
 	float Norm;
 	float Clamp1;
 	float Clamp2;
@@ -303,18 +305,18 @@ void sunRadianceAndSkyIrradiance (vec3 worldP, vec3 worldS, out vec3 sunL, out v
 
 vec4 cloudColor (vec3 worldP, vec3 worldCamera, vec3 worldSunDir)
 {
-    float a = 23.0f / 180.0f * u_PrecomputedScatteringData.PI;
-    mat2 m = mat2(cos(a), sin(a), -sin(a), cos(a));
-
+    // the octave rotation (23 degrees) and lacunarity are baked into the groups
+    // group i + 1 is group i sampled with the coordinates transformed by the group matrix, so one fetch per group
     vec2 st = worldP.xy / 1000000.0f;
     float g = 1.0f;
     float r = 0.0f;
-    for (float i = 0.0f; i < u_CloudsData.Octaves; i += 1.0f)
+    for (int i = 0; i < u_CloudsData.GroupCount - 1; ++ i)
 	{
-		r -= g * (2.0f * texture(u_CloudsData.NoiseMap, st).r - 1.0f);
-        st = (m * st) * u_CloudsData.Lacunarity;
-        g *= u_CloudsData.Gain;
+		r -= g * texture(u_CloudsData.NoiseMap, vec3(st, 0.0f)).r;
+        st = u_CloudsData.GroupMatrix * st;
+        g *= u_CloudsData.GroupGain;
     }
+	r -= g * texture(u_CloudsData.NoiseMap, vec3(st, 1.0f)).r;
 
     float v = clamp((r * u_CloudsData.Norm - u_CloudsData.Clamp1) / (u_CloudsData.Clamp2 - u_CloudsData.Clamp1), 0.0f, 1.0f);
     float t = clamp((r * u_CloudsData.Norm * 3.0f - u_CloudsData.Clamp1) / (u_CloudsData.Clamp2 - u_CloudsData.Clamp1), 0.0f, 1.0f);
@@ -11,7 +11,7 @@ License: GameDev.net Open License
 
 uniform float u_HDRExposure;
 uniform bool u_ApplyHDR;
-uniform bool u_IsReflMode;
+uniform bool u_IsReflMode[2]; // one value per layer (check ScatteringSkyModel.vert.glsl)
 uniform bool u_IsUnderWater;
 
 #ifdef UNDERWATER_FOG
@@ -24,11 +24,26 @@ uniform vec3 u_SunDirection;
 uniform float u_g;
 uniform float u_yOffset;
 
+#ifdef SKY_VIEW_LUT
+uniform sampler2D u_SkyViewLUT;
+// the Mie color is proportional to the Rayleigh color: KmESun / (InvWavelength * KrESun)
+uniform vec3 u_MieOverRayleigh;
+// the elevation of the lowest sky dome point which is above the sea (radians, negative)
+uniform float u_MinElevation;
+// the centers of the first and of the last rows, so the lowest and the highest rows are not blended together (GL_REPEAT)
+uniform vec2 u_SkyViewLUTRowRange;
+#endif // SKY_VIEW_LUT
+
 /// Interpolated inputs across mesh
 in float v_fragY;
+#ifdef SKY_VIEW_LUT
+in vec3 v_SkyViewDirection;
+#else
 in vec3 v_RayleighColor;
 in vec3 v_MieColor;
+#endif // SKY_VIEW_LUT
 in vec3 v_Direction;
+flat in int v_layer;
 ///
 
 out vec4 fragColor;
@@ -62,15 +77,42 @@ float computeMiePhase (float cos_angle)
 	return miePhase;
 }
 
+#ifdef SKY_VIEW_LUT
+// the same parameterization as the one of ScatteringSkyModelSkyViewLUT.frag.glsl
+vec2 computeSkyViewLUTUV (vec3 direction)
+{
+	const float kPI = 3.14159265f;
+
+	direction = normalize(direction);
+
+	float azimuth = atan(direction.z, direction.x);
+	float elevation = asin(clamp(direction.y, -1.0f, 1.0f));
+
+	float v = (elevation < 0.0f ? - sqrt(min(elevation / u_MinElevation, 1.0f)) : sqrt(elevation / (0.5f * kPI)));
+
+	// the azimuth wraps around (GL_REPEAT), the elevation must not
+	return vec2(azimuth / (2.0f * kPI) + 0.5f, clamp(0.5f * v + 0.5f, u_SkyViewLUTRowRange.x, u_SkyViewLUTRowRange.y));
+}
+#endif // SKY_VIEW_LUT
+
 vec3 computeSkySunColor (void)
 {
+#ifdef SKY_VIEW_LUT
+	// one fetch per fragment, whatever the sample count is
+	vec3 rayleighColor = texture(u_SkyViewLUT, computeSkyViewLUTUV(v_SkyViewDirection)).rgb;
+	vec3 mieColor = rayleighColor * u_MieOverRayleigh;
+#else
+	vec3 rayleighColor = v_RayleighColor;
+	vec3 mieColor = v_MieColor;
+#endif // SKY_VIEW_LUT
+
 	float cos_angle = dot(u_SunDirection, v_Direction) / length(v_Direction);
 	float cos_angle2 = cos_angle * cos_angle;
 
 	float rayleighPhase = computeRayleighPhase(cos_angle2);
 	float miePhase = computeMiePhase(cos_angle);
 
-	vec3 skySunColor = u_IsReflMode ? 0.5f * v_RayleighColor : rayleighPhase * v_RayleighColor + miePhase * v_MieColor;
+	vec3 skySunColor = u_IsReflMode[v_layer] ? 0.5f * rayleighColor : rayleighPhase * rayleighColor + miePhase * mieColor;
 
 	return skySunColor;
 }
@@ -9,7 +9,11 @@ License: GameDev.net Open License
 */
 
 uniform mat4 u_WorldToClipMatrix;
-uniform mat4 u_ObjectToWorldMatrix;
+// one matrix per layer, only the first one is used if not layered
+uniform mat4 u_ObjectToWorldMatrix[2];
+
+// both reflection and refraction are rendered in one pass, one instance per layer (check MotorBoat.vert.glsl)
+uniform bool u_IsLayered;
 
 uniform vec3 u_CameraPosition;
 uniform vec3 u_SunDirection;
@@ -33,16 +37,47 @@ uniform ScatteringData u_ScatteringData;
 in vec3 a_position;
 
 out float v_fragY;
+#ifdef SKY_VIEW_LUT
+out vec3 v_SkyViewDirection;
+#else
 out vec3 v_RayleighColor;
 out vec3 v_MieColor;
+#endif // SKY_VIEW_LUT
 out vec3 v_Direction;
+flat out int v_layer;
+
+out float gl_ClipDistance[4]; //clip plane for local reflection and refraction + the layer bounds
 
+#ifndef SKY_VIEW_LUT
 float applyScale (float cos)
 {
 	float x = 1.0f - cos;
 	return u_ScatteringData.ScaleDepth * exp(-0.00287f + x * (0.459f + x * (3.83f + x * (-6.80f + x * 5.25f))));
 }
+#endif // SKY_VIEW_LUT
+
+// the layers are placed side by side: 0 - left half (reflection), 1 - right half (refraction)
+vec4 computeLayerClipPos (vec4 clipPos, int layer)
+{
+	clipPos.x = 0.5f * (clipPos.x + (2.0f * float(layer) - 1.0f) * clipPos.w);
+
+	return clipPos;
+}
 
+#ifdef SKY_VIEW_LUT
+// the scattering is looked up per fragment (check ScatteringSkyModelSkyViewLUT.frag.glsl)
+void computeAtmosphereScattering (void)
+{
+	vec3 pos = a_position;
+
+	pos /= u_ScatteringData.EarthRadius;
+	pos.y += u_ScatteringData.InnerRadius;
+
+	// the sky dome is centered in the camera, so the vertex position is also the view direction
+	v_SkyViewDirection = a_position;
+	v_Direction = u_CameraPosition - pos;
+}
+#else
 void computeAtmosphereScattering (void)
 {
 	vec3 pos = a_position;
@@ -94,16 +129,32 @@ void computeAtmosphereScattering (void)
 	v_RayleighColor = accColor * (u_ScatteringData.InvWavelength * u_ScatteringData.KrESun);
 	v_MieColor = accColor * u_ScatteringData.KmESun;
 }
+#endif // SKY_VIEW_LUT
 
 void main (void)
 {
 	computeAtmosphereScattering();
 
-	vec4 world_pos = u_ObjectToWorldMatrix * vec4(a_position, 1.0f);
+	v_layer = (u_IsLayered ? gl_InstanceID : 0);
+
+	vec4 world_pos = u_ObjectToWorldMatrix[v_layer] * vec4(a_position, 1.0f);
 
 	v_fragY = a_position.y;
 
 	// we use the w value instead of z as explained in here: https://learnopengl.com/#!Advanced-OpenGL/Cubemaps
 	vec4 clip_pos = u_WorldToClipMatrix * world_pos;
 	gl_Position = clip_pos.xyww;
+
+	// the sky is never clipped by the water planes
+	gl_ClipDistance[0] = 1.0f;
+	gl_ClipDistance[1] = 1.0f;
+
+	if (u_IsLayered)
+	{
+		// the layer bounds, so nothing spills into the other half
+		gl_ClipDistance[2] = gl_Position.w + gl_Position.x;
+		gl_ClipDistance[3] = gl_Position.w - gl_Position.x;
+
+		gl_Position = computeLayerClipPos(gl_Position, v_layer);
+	}
 }
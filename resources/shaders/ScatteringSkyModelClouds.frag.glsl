@@ -1,10 +1,6 @@
 /* Author: BAIRAC MIHAI
 
-Clouds generated using simplex noise algorithm
-Simplex noise code taken from: 
-https://github.com/ashima/webgl-noise/blob/master/src/noise2D.glsl
-License: MIT License
-
+Clouds generated using fractal noise (fBm), the octaves are summed up on the CPU (check CloudsNoiseGenerator.h)
 
 Fractal code to sum up octaves taken from:
 https://github.com/Auburns/FastNoise/blob/master/FastNoise.cpp
@@ -19,10 +15,17 @@ uniform float u_SunDirY;
 
 struct CloudsData
 {
-	int Octaves;
-	float Lacunarity;
-	float Gain;
+	// layer 0 - a full group of octaves, layer 1 - the last group
+	sampler2DArray NoiseMap;
+	int GroupCount;
+	mat2 GroupMatrix;
+	float GroupGain;
+	// 1 / the sum of the octave weights
+	float Amplitude;
 	float ScaleFactor;
+	// 1 / the noise cells per texture tile (check CloudsNoiseGenerator::GetNoiseCellCount()),
+	// the simplex noise used before had 1 cell per unit, so ScaleFactor keeps its meaning
+	float NoiseTileScale;
 };
 uniform CloudsData u_CloudsData;
 
@@ -35,130 +38,23 @@ out vec4 fragColor;
 
 ////////////////////////////////////////////
 
-vec3 mod289 (vec3 x)
-{
-  return x - floor(x * (1.0 / 289.0)) * 289.0;
-}
-
-vec2 mod289 (vec2 x)
-{
-  return x - floor(x * (1.0 / 289.0)) * 289.0;
-}
-
-vec3 permute (vec3 x)
-{
-  return mod289(((x*34.0)+1.0)*x);
-}
-
-float snoise (vec2 v)
-{
-  const vec4 C = vec4(0.211324865405187,  // (3.0-sqrt(3.0))/6.0
-                      0.366025403784439,  // 0.5*(sqrt(3.0)-1.0)
-                     -0.577350269189626,  // -1.0 + 2.0 * C.x
-                      0.024390243902439); // 1.0 / 41.0
-// First corner
-  vec2 i  = floor(v + dot(v, C.yy) );
-  vec2 x0 = v -   i + dot(i, C.xx);
-
-// Other corners
-  vec2 i1;
-  //i1.x = step( x0.y, x0.x ); // x0.x > x0.y ? 1.0 : 0.0
-  //i1.y = 1.0 - i1.x;
-  i1 = (x0.x > x0.y) ? vec2(1.0, 0.0) : vec2(0.0, 1.0);
-  // x0 = x0 - 0.0 + 0.0 * C.xx ;
-  // x1 = x0 - i1 + 1.0 * C.xx ;
-  // x2 = x0 - 1.0 + 2.0 * C.xx ;
-  vec4 x12 = x0.xyxy + C.xxzz;
-  x12.xy -= i1;
-
-// Permutations
-  i = mod289(i); // Avoid truncation effects in permutation
-  vec3 p = permute( permute( i.y + vec3(0.0, i1.y, 1.0 ))
-		+ i.x + vec3(0.0, i1.x, 1.0 ));
-
-  vec3 m = max(0.5 - vec3(dot(x0,x0), dot(x12.xy,x12.xy), dot(x12.zw,x12.zw)), 0.0);
-  m = m*m ;
-  m = m*m ;
-
-// Gradients: 41 points uniformly over a line, mapped onto a diamond.
-// The ring size 17*17 = 289 is close to a multiple of 41 (41*7 = 287)
-
-  vec3 x = 2.0 * fract(p * C.www) - 1.0;
-  vec3 h = abs(x) - 0.5;
-  vec3 ox = floor(x + 0.5);
-  vec3 a0 = x - ox;
-
-// Normalise gradients implicitly by scaling m
-// Approximation of: m *= inversesqrt( a0*a0 + h*h );
-  m *= 1.79284291400159 - 0.85373472095314 * ( a0*a0 + h*h );
-
-// Compute final noise value at P
-  vec3 g;
-  g.x  = a0.x  * x0.x  + h.x  * x0.y;
-  g.yz = a0.yz * x12.xz + h.yz * x12.yw;
-  return 130.0 * dot(m, g);
-}
-
-//////////////////////////
-
+// group i + 1 is group i sampled with the coordinates transformed by the group matrix, so one fetch per group
 float fractalFBM (vec2 uv)
 {
-	float sum = snoise(uv);
-	float amp = 1.0f;
-	float ampFractal = 1.0f;
-
-	for (int i = 0; i < u_CloudsData.Octaves; ++ i)
-	{
-		uv *= u_CloudsData.Lacunarity;
-		ampFractal += amp;
-		amp *= u_CloudsData.Gain;
-
-		sum  += snoise(uv) * amp;
-	}
-
-	sum /= ampFractal;
-
-	return sum;
-}
-
-float fractalBillow (vec2 uv)
-{
-	float sum = abs(snoise(uv)) * 2.0f - 1.0f;
-	float amp = 1.0f;
-	float ampFractal = 1.0f;
-
-	for (int i = 0; i < u_CloudsData.Octaves; ++ i)
-	{
-		uv *= u_CloudsData.Lacunarity;
-		ampFractal += amp;
-		amp *= u_CloudsData.Gain;
-
-		sum  += (abs(snoise(uv)) * 2.0f - 1.0f) * amp;
-	}
-
-	sum /= ampFractal;
-
-	return sum;
-}
-
-float fractalRigidMulti (vec2 uv)
-{
-	float sum = 1.0f - abs(snoise(uv));
+	float sum = 0.0f;
 	float amp = 1.0f;
-	float ampFractal = 1.0f;
 
-	for (int i = 0; i < u_CloudsData.Octaves; ++ i)
+	for (int i = 0; i < u_CloudsData.GroupCount - 1; ++ i)
 	{
-		uv *= u_CloudsData.Lacunarity;
-		ampFractal += amp;
-		amp *= u_CloudsData.Gain;
+		sum += texture(u_CloudsData.NoiseMap, vec3(uv, 0.0f)).r * amp;
 
-		sum  += (1.0f - abs(snoise(uv))) * amp;
+		uv = u_CloudsData.GroupMatrix * uv;
+		amp *= u_CloudsData.GroupGain;
 	}
 
-	sum /= ampFractal;
+	sum += texture(u_CloudsData.NoiseMap, vec3(uv, 1.0f)).r * amp;
 
-	return sum;
+	return sum * u_CloudsData.Amplitude;
 }
 ////////////////////////////////////////////
 
@@ -196,9 +92,7 @@ void main (void)
 	// the clouds surface color must get darker and darker as sun goes away!!!
 	float lightQuantity = computeLightQuantityFactor(u_SunDirY);
 
-	float value = fractalFBM(v_uv * u_CloudsData.ScaleFactor);
-	//float value = fractalBillow(v_uv);
-	//float value = fractalRigidMulti(v_uv);
+	float value = fractalFBM(v_uv * u_CloudsData.ScaleFactor * u_CloudsData.NoiseTileScale);
 
 	finalColor = vec3((value + 0.3f) * lightQuantity);
 
@@ -214,5 +108,6 @@ void main (void)
 
 	finalColor *= lightQuantity;
 
-	fragColor = vec4(finalColor, value * 3.0f);
+	// the alpha is clamped by the fixed point targets only (the reduced resolution clouds target is a float one)
+	fragColor = vec4(finalColor, clamp(value * 3.0f, 0.0f, 1.0f));
 }	
@@ -0,0 +1,133 @@
+/* Author: BAIRAC MIHAI
+
+Sky view lookup table of the Scattering sky model
+Atmospheric scattring code based and adapted from
+code: https://www.gamedev.net/forums/topic/461747-atmospheric-scattering-sean-oneill---gpu-gems2/
+paper: https://developer.nvidia.com/gpugems/GPUGems2/gpugems2_chapter16.html
+The lookup table idea and parameterization: https://sebh.github.io/publications/egsr2020.pdf
+
+License: GameDev.net Open License
+
+*/
+
+uniform sampler2D u_TransmittanceLUT;
+// x - the height of the first row, y - the height of the last row (check ScatteringSkyModelTransmittanceLUT.frag.glsl)
+uniform vec2 u_TransmittanceHeightRange;
+
+uniform vec3 u_CameraPosition;
+uniform vec3 u_SunDirection;
+
+// the elevation of the lowest sky dome point which is above the sea (radians, negative)
+uniform float u_MinElevation;
+uniform float u_yOffset;
+
+struct ScatteringData 
+{
+	float EarthRadius;
+	int SampleCount;
+	vec3 InvWavelength;
+	float InnerRadius;
+	float KrESun;
+	float KmESun;
+	float Kr4PI;
+	float Km4PI;
+	float Scale;
+	float ScaleDepth;
+	float ScaleOverScaleDepth;
+};
+uniform ScatteringData u_ScatteringData;
+
+/// Interpolated inputs across mesh
+in vec2 v_uv;
+///
+
+out vec4 fragColor;
+
+const float kPI = 3.14159265f;
+
+
+float applyScale (float cos)
+{
+	float x = 1.0f - cos;
+	return u_ScatteringData.ScaleDepth * exp(-0.00287f + x * (0.459f + x * (3.83f + x * (-6.80f + x * 5.25f))));
+}
+
+// u - the azimuth, v - the elevation, half of the rows below the horizon and half above it
+// the rows are denser near the horizon, where the sky color changes the most (the inverse of the lookup in ScatteringSkyModel.frag.glsl)
+vec3 computeViewDirection (vec2 uv)
+{
+	float azimuth = (uv.x - 0.5f) * 2.0f * kPI;
+
+	float v = 2.0f * uv.y - 1.0f;
+	float elevation = (v < 0.0f ? u_MinElevation : 0.5f * kPI) * v * v;
+
+	return vec3(cos(elevation) * cos(azimuth), sin(elevation), cos(elevation) * sin(azimuth));
+}
+
+vec3 lookupTransmittance (float height, float cosAngle)
+{
+	vec2 uv = vec2(0.5f * cosAngle + 0.5f, (height - u_TransmittanceHeightRange.x) / (u_TransmittanceHeightRange.y - u_TransmittanceHeightRange.x));
+
+	return texture(u_TransmittanceLUT, uv).rgb;
+}
+
+// the same scattering as the one of ScatteringSkyModel.vert.glsl, but for the sky dome point seen in the given direction
+vec3 computeRayleighColor (vec3 direction)
+{
+	// The intersection of the direction with the sky dome (the sphere of the Earth radius, lowered by the altitude offset)
+	// in the atmosphere units, so the sky dome radius is 1
+	float offset = u_yOffset / u_ScatteringData.EarthRadius;
+	float b = - direction.y * offset;
+	float domeDistance = - b + sqrt(b * b - (offset * offset - 1.0f));
+
+	vec3 pos = direction * domeDistance;
+	pos.y += u_ScatteringData.InnerRadius;
+
+	// Get the ray from the camera to the dome point, and its length (which is the far point of the ray passing through the atmosphere)
+	vec3 ray = pos - u_CameraPosition;
+	float far = length(ray);
+	ray /= far;
+
+	// Calculate the ray's starting position, then calculate its scattering offset
+	vec3 start = u_CameraPosition;
+	float height = length(start);
+	float depth = exp(u_ScatteringData.ScaleOverScaleDepth * (u_ScatteringData.InnerRadius - u_CameraPosition.y));
+	float startAngle = dot(ray, start) / height;
+	float startOffset = depth * applyScale(startAngle);
+
+	// Initialize the scattering loop variables
+	float fSampleCount = u_ScatteringData.SampleCount;
+	float sampleLength = far / fSampleCount;
+	float scaledLength = sampleLength * u_ScatteringData.Scale;
+	vec3 sampleRay = ray * sampleLength;
+	vec3 samplePoint = start + sampleRay * 0.5f;
+
+	vec3 extinction = u_ScatteringData.InvWavelength * u_ScatteringData.Kr4PI + u_ScatteringData.Km4PI;
+
+	// Now loop through the sample rays
+	vec3 accColor = vec3(0.0f); //accumulated color
+
+	for(int i = 0; i < u_ScatteringData.SampleCount; i ++)
+	{
+		float height = length(samplePoint);
+		float depth = exp(u_ScatteringData.ScaleOverScaleDepth * (u_ScatteringData.InnerRadius - height));
+		float lightAngle = dot(u_SunDirection, samplePoint) / height;
+		float cameraAngle = dot(ray, samplePoint) / height;
+
+		// the light attenuation (the sun to the sample point) comes from the transmittance LUT,
+		// the view attenuation (the sample point to the camera) is the difference of the optical depths along the ray
+		vec3 attenuate = exp(- (startOffset - depth * applyScale(cameraAngle)) * extinction) * lookupTransmittance(height, lightAngle);
+		accColor += attenuate * (depth * scaledLength);
+
+		// Next sample point
+		samplePoint += sampleRay;
+	}
+
+	// the Mie color is proportional to the Rayleigh color, so it is not stored (check ScatteringSkyModel.frag.glsl)
+	return accColor * (u_ScatteringData.InvWavelength * u_ScatteringData.KrESun);
+}
+
+void main (void)
+{
+	fragColor = vec4(computeRayleighColor(computeViewDirection(v_uv)), 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+/* Author: BAIRAC MIHAI
+
+Transmittance lookup table of the Scattering sky model
+The optical depth is the one of the scattering code, which is based and adapted from
+code: https://www.gamedev.net/forums/topic/461747-atmospheric-scattering-sean-oneill---gpu-gems2/
+paper: https://developer.nvidia.com/gpugems/GPUGems2/gpugems2_chapter16.html
+The lookup table idea: https://sebh.github.io/publications/egsr2020.pdf
+
+License: GameDev.net Open License
+
+*/
+
+struct ScatteringData 
+{
+	vec3 InvWavelength;
+	float InnerRadius;
+	float Kr4PI;
+	float Km4PI;
+	float ScaleDepth;
+	float ScaleOverScaleDepth;
+};
+uniform ScatteringData u_ScatteringData;
+
+// x - the height of the first row, y - the height of the last row
+uniform vec2 u_HeightRange;
+
+/// Interpolated inputs across mesh
+in vec2 v_uv;
+///
+
+out vec4 fragColor;
+
+float applyScale (float cos)
+{
+	float x = 1.0f - cos;
+	return u_ScatteringData.ScaleDepth * exp(-0.00287f + x * (0.459f + x * (3.83f + x * (-6.80f + x * 5.25f))));
+}
+
+// u - the cosine of the angle between the up vector and the direction, v - the height
+void main (void)
+{
+	float cosAngle = 2.0f * v_uv.x - 1.0f;
+	float height = mix(u_HeightRange.x, u_HeightRange.y, v_uv.y);
+
+	float depth = exp(u_ScatteringData.ScaleOverScaleDepth * (u_ScatteringData.InnerRadius - height));
+
+	// the attenuation along the direction up to the outer atmosphere
+	vec3 transmittance = exp(- depth * applyScale(cosAngle) * (u_ScatteringData.InvWavelength * u_ScatteringData.Kr4PI + u_ScatteringData.Km4PI));
+
+	fragColor = vec4(transmittance, 1.0f);
+}
\ No newline at end of file
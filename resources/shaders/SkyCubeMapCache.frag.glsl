@@ -0,0 +1,40 @@
+/* Author: BAIRAC MIHAI */
+
+uniform float u_HDRExposure;
+uniform bool u_ApplyHDR;
+
+// the linear sky colors, rendered by the sky model (check SkyCubeMapCache.h)
+uniform samplerCube u_CubeMap;
+
+/// Interpolated inputs across mesh
+in vec3 v_uv;
+///
+
+out vec4 fragColor;
+
+#ifdef HDR
+// Exposure tone mapping + gamma correction
+vec3 hdr (vec3 L) 
+{
+    L = L * u_HDRExposure;
+    L.r = L.r < 1.413f ? pow(L.r * 0.38317f, 1.0f / 2.2f) : 1.0f - exp(-L.r);
+    L.g = L.g < 1.413f ? pow(L.g * 0.38317f, 1.0f / 2.2f) : 1.0f - exp(-L.g);
+    L.b = L.b < 1.413f ? pow(L.b * 0.38317f, 1.0f / 2.2f) : 1.0f - exp(-L.b);
+    return L;
+}
+#endif // HDR
+
+
+void main (void)
+{
+	vec3 finalColor = texture(u_CubeMap, v_uv).rgb;
+
+#ifdef HDR
+if (u_ApplyHDR)
+{
+	finalColor = hdr(finalColor);
+}
+#endif // HDR
+
+	fragColor = vec4(finalColor, 1.0f);
+}
\ No newline at end of file
@@ -20,4 +20,14 @@
 #define USE_FFTW
 #endif
 
+// SSE intrinsics are used by some CPU side computations (e.g. CPU FFT mipmaps, displacement codec)
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define USE_SSE
+#endif
+
+// SSE2 adds the float <-> integer conversions
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2
+#endif
+
 #endif /* APP_CONFIG_H */
\ No newline at end of file
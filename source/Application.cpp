@@ -16,10 +16,13 @@ TEXTURE UNIT ALLOCATION
 #include "CustomTypes.h"
 #include "HelperFunctions.h"
 #include "GLConfig.h"
+#include "GLStateCache.h"
 #include "GlobalConfig.h"
 #define GLM_MESSAGES //info about GLM
 // glm::vec3 comes from the header
 #include "glm/common.hpp" //clamp()
+#include "glm/geometric.hpp" //dot()
+#include "glm/trigonometric.hpp" //cos(), radians()
 #include "glm/gtc/type_ptr.hpp" //value_ptr()
 #include "glm/gtc/matrix_transform.hpp" //scale()
 #include "glm/gtc/constants.hpp" //epsilon
@@ -30,8 +33,19 @@ TEXTURE UNIT ALLOCATION
 #include "Sky.h"
 #include "Ocean.h"
 #include "MotorBoat.h"
+#include "QualityGovernor.h"
 
 
+namespace
+{
+	// reflection and refraction (check Application::RenderReflectedRefractedScene())
+	const unsigned short kReflRefrLayerCount = 2;
+
+	// the scale part of the reflected and refracted objects model matrices
+	const glm::vec3 kReflectionScale(1.0f, -1.0f, 1.0f);
+	const glm::vec3 kRefractionScale(1.0f, 0.75f, 1.0f);
+}
+
 Application::Application()
 {
 	LOG("Application successfully created!");
@@ -39,11 +53,13 @@ Application::Application()
 
 Application::Application(const GlobalConfig& i_Config, int i_WindowWidth, int i_WindowHeight)
 	: m_WindowWidth(0), m_WindowHeight(0), m_pFBM(nullptr),
+	  m_ReflRefrResolutionScale(1.0f), m_ReflRefrUpdateInterval(1), m_ReflRefrMinForwardDot(1.0f), m_ReflRefrFrameCount(0),
+	  m_IsReflRefrUpdateForced(true), m_IsReflRefrUnderWater(false), m_IsReflRefrLayered(false), m_ReflRefrCameraForward(0.0f), m_ReflRefrWorldToClipMatrix(1.0f),
 #ifdef USE_GUI
 	  m_pGUIBar(nullptr),
 #endif //USE_GUI
       m_pCamera(nullptr), m_pObservingCamera(nullptr), m_pCurrentViewingCamera(nullptr), m_pCurrentControllingCamera(nullptr),
-	  m_pPostProcessingManager(nullptr), m_pSky(nullptr), m_pOcean(nullptr), m_pMotorBoat(nullptr),
+	  m_pPostProcessingManager(nullptr), m_pSky(nullptr), m_pOcean(nullptr), m_pMotorBoat(nullptr), m_pQualityGovernor(nullptr),
 	  m_TimeScale(0.0f), m_CrrTime(0.0f), m_DeltaTime(0.0f),
 	  m_IsGUIVisible(false), m_IsCameraViewChanged(false), m_IsCameraControlChanged(false),
 	  m_IsRenderWireframe(false), m_IsRenderPoints(false), m_IsCursorReleased(false),
@@ -248,6 +264,101 @@ void TW_CALL Application::GetOceanChoppyScale(void* i_pValue, void* i_pClientDat
 	*static_cast<float *>(i_pValue) = static_cast<const Ocean *>(i_pClientData)->GetChoppyScale();
 }
 
+void TW_CALL Application::GetOceanQuadtreeSelectionTime(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<float *>(i_pValue) = static_cast<const Ocean *>(i_pClientData)->GetQuadtreeSelectionTime();
+}
+
+void TW_CALL Application::GetOceanQuadtreeVisibleTiles(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<unsigned int *>(i_pValue) = static_cast<const Ocean *>(i_pClientData)->GetQuadtreeVisibleTileCount();
+}
+
+void TW_CALL Application::GetOceanQuadtreeCulledTiles(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<unsigned int *>(i_pValue) = static_cast<const Ocean *>(i_pClientData)->GetQuadtreeCulledTileCount();
+}
+
+void TW_CALL Application::GetGLIssuedCallCount(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<unsigned int *>(i_pValue) = GLStateCache::GetIssuedCallCount();
+}
+
+void TW_CALL Application::GetGLElidedCallCount(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<unsigned int *>(i_pValue) = GLStateCache::GetElidedCallCount();
+}
+
+void TW_CALL Application::SetQualityGovernorEnabled(const void* i_pValue, void* i_pClientData)
+{
+	static_cast<QualityGovernor *>(i_pClientData)->SetIsEnabled(*static_cast<const bool *>(i_pValue));
+}
+
+void TW_CALL Application::GetQualityGovernorEnabled(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<bool *>(i_pValue) = static_cast<const QualityGovernor *>(i_pClientData)->GetIsEnabled();
+}
+
+void TW_CALL Application::SetQualityGovernorLevel(const void* i_pValue, void* i_pClientData)
+{
+	static_cast<QualityGovernor *>(i_pClientData)->SetLevel(*static_cast<const unsigned short *>(i_pValue));
+}
+
+void TW_CALL Application::GetQualityGovernorLevel(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<unsigned short *>(i_pValue) = static_cast<const QualityGovernor *>(i_pClientData)->GetLevel();
+}
+
+void TW_CALL Application::SetQualityGovernorTargetFrameTime(const void* i_pValue, void* i_pClientData)
+{
+	static_cast<QualityGovernor *>(i_pClientData)->SetTargetFrameTime(*static_cast<const float *>(i_pValue));
+}
+
+void TW_CALL Application::GetQualityGovernorTargetFrameTime(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<float *>(i_pValue) = static_cast<const QualityGovernor *>(i_pClientData)->GetTargetFrameTime();
+}
+
+void TW_CALL Application::GetQualityGovernorCPUTime(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<float *>(i_pValue) = static_cast<const QualityGovernor *>(i_pClientData)->GetCPUTime();
+}
+
+void TW_CALL Application::GetQualityGovernorGPUTime(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<float *>(i_pValue) = static_cast<const QualityGovernor *>(i_pClientData)->GetGPUTime();
+}
+
+void TW_CALL Application::GetQualityGovernorLastDecision(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<int *>(i_pValue) = static_cast<int>(static_cast<const QualityGovernor *>(i_pClientData)->GetLastDecision());
+}
+
+void TW_CALL Application::GetQualityGovernorDecisionCount(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<unsigned int *>(i_pValue) = static_cast<const QualityGovernor *>(i_pClientData)->GetDecisionCount();
+}
+
+void TW_CALL Application::GetOceanFFTSize(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<unsigned short *>(i_pValue) = static_cast<const Ocean *>(i_pClientData)->GetFFTSize();
+}
+
+void TW_CALL Application::GetOceanScreenSpaceGridResolution(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<float *>(i_pValue) = static_cast<const Ocean *>(i_pClientData)->GetScreenSpaceGridResolution();
+}
+
+void TW_CALL Application::GetOceanCausticsMapSize(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<unsigned short *>(i_pValue) = static_cast<const Ocean *>(i_pClientData)->GetCausticsMapSize();
+}
+
+void TW_CALL Application::GetOceanGodRaysNumberOfSamples(void* i_pValue, void* i_pClientData)
+{
+	*static_cast<unsigned short *>(i_pValue) = static_cast<const Ocean *>(i_pClientData)->GetGodRaysNumberOfSamples();
+}
+
 
 void TW_CALL Application::SetFOV(const void* i_pValue, void* i_pClientData)
 {
@@ -365,7 +476,7 @@ void Application::InitScene(const GlobalConfig& i_Config)
 		assert(ret != 0);
 		ret = TwAddVarCB(m_pGUIBar, "Octaves", TW_TYPE_UINT16, SetCloudsOctaves, GetCloudsOctaves, m_pSky, "min=1; max=15.0; step=1 group=Clouds");
 		assert(ret != 0);
-		ret = TwAddVarCB(m_pGUIBar, "Lacunarity", TW_TYPE_FLOAT, SetCloudsLacunarity, GetCloudsLacunarity, m_pSky, "min=0.1; max=3.0; step=0.1 group=Clouds");
+		ret = TwAddVarCB(m_pGUIBar, "Lacunarity", TW_TYPE_FLOAT, SetCloudsLacunarity, GetCloudsLacunarity, m_pSky, "min=1.5; max=3.0; step=0.1 group=Clouds");
 		assert(ret != 0);
 		ret = TwAddVarCB(m_pGUIBar, "Gain", TW_TYPE_FLOAT, SetCloudsGain, GetCloudsGain, m_pSky, "min=0.1; max=1.0; step=0.1 group=Clouds");
 		assert(ret != 0);
@@ -411,6 +522,23 @@ void Application::InitScene(const GlobalConfig& i_Config)
 	ret = TwAddVarCB(m_pGUIBar, "ChoppyScale", TW_TYPE_FLOAT, SetOceanChoppyScale, GetOceanChoppyScale, m_pOcean, "min=0.1; max=3.0; step=0.1 group=Waves");
 	assert(ret != 0);
 
+	if (m_pOcean->GetGridType() == CustomTypes::Ocean::GridType::GT_QUADTREE)
+	{
+		// read only stats
+		ret = TwAddVarCB(m_pGUIBar, "QuadtreeSelectionTime", TW_TYPE_FLOAT, nullptr, GetOceanQuadtreeSelectionTime, m_pOcean, "label='Quadtree Selection (ms)' group=Stats");
+		assert(ret != 0);
+		ret = TwAddVarCB(m_pGUIBar, "QuadtreeVisibleTiles", TW_TYPE_UINT32, nullptr, GetOceanQuadtreeVisibleTiles, m_pOcean, "label='Quadtree Visible Tiles' group=Stats");
+		assert(ret != 0);
+		ret = TwAddVarCB(m_pGUIBar, "QuadtreeCulledTiles", TW_TYPE_UINT32, nullptr, GetOceanQuadtreeCulledTiles, m_pOcean, "label='Quadtree Culled Tiles' group=Stats");
+		assert(ret != 0);
+	}
+
+	// program, texture, framebuffer and vertex array binds of the current frame (check GLStateCache)
+	ret = TwAddVarCB(m_pGUIBar, "GLIssuedCalls", TW_TYPE_UINT32, nullptr, GetGLIssuedCallCount, nullptr, "label='GL Binds Issued' group=Stats");
+	assert(ret != 0);
+	ret = TwAddVarCB(m_pGUIBar, "GLElidedCalls", TW_TYPE_UINT32, nullptr, GetGLElidedCallCount, nullptr, "label='GL Binds Elided' group=Stats");
+	assert(ret != 0);
+
 	// add params to GUI
 	ret = TwAddVarCB(m_pGUIBar, "FOV", TW_TYPE_FLOAT, SetFOV, GetFOV, m_pCurrentControllingCamera, "min=5.0; max=129.0; step=1.0 group=Rendering");
 	assert(ret != 0);
@@ -420,6 +548,57 @@ void Application::InitScene(const GlobalConfig& i_Config)
 	m_pMotorBoat = new MotorBoat(i_Config);
 	assert(m_pMotorBoat != nullptr);
 	LOG("Motor Boat is: %d bytes in size", sizeof(*m_pSky));
+
+	//////// QUALITY GOVERNOR ////////
+	// always created, so the level can be changed from the GUI even if the automatic changes are disabled
+	m_pQualityGovernor = new QualityGovernor(i_Config);
+	assert(m_pQualityGovernor != nullptr);
+
+#ifdef USE_GUI
+	ret = TwAddVarCB(m_pGUIBar, "QualityGovernorEnabled", TW_TYPE_BOOL8, SetQualityGovernorEnabled, GetQualityGovernorEnabled, m_pQualityGovernor, "label='Enabled' group=Quality");
+	assert(ret != 0);
+
+	std::string levelDef = "label='Level' min=0 max=" + std::to_string(m_pQualityGovernor->GetLevelCount() - 1) + " step=1 group=Quality";
+	ret = TwAddVarCB(m_pGUIBar, "QualityLevel", TW_TYPE_UINT16, SetQualityGovernorLevel, GetQualityGovernorLevel, m_pQualityGovernor, levelDef.c_str());
+	assert(ret != 0);
+
+	ret = TwAddVarCB(m_pGUIBar, "QualityTargetFrameTime", TW_TYPE_FLOAT, SetQualityGovernorTargetFrameTime, GetQualityGovernorTargetFrameTime, m_pQualityGovernor, "label='Target Frame Time (ms)' min=1.0 max=100.0 step=0.1 group=Quality");
+	assert(ret != 0);
+
+	// read only stats
+	ret = TwAddVarCB(m_pGUIBar, "QualityCPUTime", TW_TYPE_FLOAT, nullptr, GetQualityGovernorCPUTime, m_pQualityGovernor, "label='CPU Time (ms)' group=Quality");
+	assert(ret != 0);
+	ret = TwAddVarCB(m_pGUIBar, "QualityGPUTime", TW_TYPE_FLOAT, nullptr, GetQualityGovernorGPUTime, m_pQualityGovernor, "label='GPU Time (ms)' group=Quality");
+	assert(ret != 0);
+
+	TwEnumVal decisionTypes[] = { { static_cast<int>(QualityGovernor::DECISION_TYPE::DT_NONE), "None" },
+								  { static_cast<int>(QualityGovernor::DECISION_TYPE::DT_STEP_DOWN), "Step Down" },
+								  { static_cast<int>(QualityGovernor::DECISION_TYPE::DT_STEP_UP), "Step Up" },
+								  { static_cast<int>(QualityGovernor::DECISION_TYPE::DT_MANUAL), "Manual" } };
+	TwType decisionType = TwDefineEnum("QualityDecisionType", decisionTypes, 4);
+	ret = TwAddVarCB(m_pGUIBar, "QualityLastDecision", decisionType, nullptr, GetQualityGovernorLastDecision, m_pQualityGovernor, "label='Last Decision' group=Quality");
+	assert(ret != 0);
+	ret = TwAddVarCB(m_pGUIBar, "QualityDecisionCount", TW_TYPE_UINT32, nullptr, GetQualityGovernorDecisionCount, m_pQualityGovernor, "label='Decisions' group=Quality");
+	assert(ret != 0);
+
+	ret = TwAddVarCB(m_pGUIBar, "QualityFFTSize", TW_TYPE_UINT16, nullptr, GetOceanFFTSize, m_pOcean, "label='FFT Size' group=Quality");
+	assert(ret != 0);
+	if (m_pOcean->GetGridType() == CustomTypes::Ocean::GridType::GT_SCREEN_SPACE)
+	{
+		ret = TwAddVarCB(m_pGUIBar, "QualityGridResolution", TW_TYPE_FLOAT, nullptr, GetOceanScreenSpaceGridResolution, m_pOcean, "label='Grid Resolution' group=Quality");
+		assert(ret != 0);
+	}
+	if (i_Config.Scene.Ocean.Bottom.Caustics.Enabled)
+	{
+		ret = TwAddVarCB(m_pGUIBar, "QualityCausticsMapSize", TW_TYPE_UINT16, nullptr, GetOceanCausticsMapSize, m_pOcean, "label='Caustics Map Size' group=Quality");
+		assert(ret != 0);
+	}
+	if (i_Config.Scene.Ocean.UnderWater.GodRays.Enabled)
+	{
+		ret = TwAddVarCB(m_pGUIBar, "QualityGodRaysSamples", TW_TYPE_UINT16, nullptr, GetOceanGodRaysNumberOfSamples, m_pOcean, "label='God Rays Samples' group=Quality");
+		assert(ret != 0);
+	}
+#endif //USE_GUI
 }
 
 void Application::Update(float i_CrrTime, float i_DeltaTime, const GlobalConfig& i_Config)
@@ -427,20 +606,64 @@ void Application::Update(float i_CrrTime, float i_DeltaTime, const GlobalConfig&
 	m_CrrTime = i_CrrTime;
 	m_DeltaTime = i_DeltaTime;
 
+	GLStateCache::ResetCounters();
+
+	if (m_pQualityGovernor)
+	{
+		m_pQualityGovernor->BeginFrame();
+	}
+
 	// NOTE! Reflected stuff is only above water
-	if (i_Config.VisualEffects.ShowReflections && m_pCurrentViewingCamera && m_pCurrentViewingCamera->GetAltitude() > 0.0f)
+	bool isReflected = (i_Config.VisualEffects.ShowReflections && m_pCurrentViewingCamera && m_pCurrentViewingCamera->GetAltitude() > 0.0f);
+	// NOTE! Refracted stuff is only under water
+	bool isRefracted = (i_Config.VisualEffects.ShowRefractions && m_pCurrentViewingCamera && m_pCurrentViewingCamera->GetAltitude() < 0.0f);
+
+	if ((isReflected || isRefracted) && IsReflRefrUpdateNeeded(isRefracted))
 	{
-		UpdateReflectedScene(i_CrrTime, i_DeltaTime);
+		if (m_IsReflRefrLayered)
+		{
+			UpdateReflectedRefractedScene(i_CrrTime, i_DeltaTime);
+
+			RenderReflectedRefractedScene();
+		}
+		else if (isReflected)
+		{
+			UpdateReflectedScene(i_CrrTime, i_DeltaTime);
+
+			RenderReflectedScene();
+		}
+		else
+		{
+			UpdateRefractedScene(i_CrrTime, i_DeltaTime);
+
+			RenderRefractedScene();
+		}
 
-		RenderReflectedScene();
+		m_ReflRefrCameraForward = m_pCurrentViewingCamera->GetForward();
+		m_ReflRefrWorldToClipMatrix = m_pCurrentViewingCamera->GetProjectionViewMatrix();
+		m_IsReflRefrUnderWater = isRefracted;
+		m_IsReflRefrUpdateForced = false;
+		m_ReflRefrFrameCount = 0;
+	}
+	else if (!isReflected && !isRefracted)
+	{
+		// the maps are not updated, they are sampled as before
+		if (m_pCurrentViewingCamera)
+		{
+			m_ReflRefrWorldToClipMatrix = m_pCurrentViewingCamera->GetProjectionViewMatrix();
+		}
+		m_IsReflRefrUpdateForced = true;
 	}
 
-	// NOTE! Refracted stuff is only under water
-	if (i_Config.VisualEffects.ShowRefractions && m_pCurrentViewingCamera && m_pCurrentViewingCamera->GetAltitude() < 0.0f)
+	// the maps are reprojected until the next update
+	if (m_ReflRefrFrameCount < m_ReflRefrUpdateInterval)
 	{
-		UpdateRefractedScene(i_CrrTime, i_DeltaTime);
+		++ m_ReflRefrFrameCount;
+	}
 
-		RenderRefractedScene();
+	if (m_pOcean)
+	{
+		m_pOcean->SetReflRefrWorldToClipMatrix(m_ReflRefrWorldToClipMatrix);
 	}
 
 	UpdateScene(i_CrrTime, i_DeltaTime, i_Config);
@@ -461,7 +684,7 @@ void Application::UpdateReflectedScene(float i_CrrTime, float i_DeltaTime)
 {
 	// Local Reflection
 	// Transforms order: S * R * T (from left to right)
-	glm::mat4 ScaleMatrix = glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, -1.0f, 1.0f));
+	glm::mat4 ScaleMatrix = glm::scale(glm::mat4(1.0f), kReflectionScale);
 
 	//// update the objects in scene
 
@@ -479,7 +702,7 @@ void Application::UpdateReflectedScene(float i_CrrTime, float i_DeltaTime)
 void Application::UpdateRefractedScene(float i_CrrTime, float i_DeltaTime)
 {
 	// Local Refraction
-	glm::mat4 ScaleMatrix = glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 0.75f, 1.0f));
+	glm::mat4 ScaleMatrix = glm::scale(glm::mat4(1.0f), kRefractionScale);
 
 	//// update the objects in scene
 
@@ -494,6 +717,26 @@ void Application::UpdateRefractedScene(float i_CrrTime, float i_DeltaTime)
 	}
 }
 
+void Application::UpdateReflectedRefractedScene(float i_CrrTime, float i_DeltaTime)
+{
+	// Local Reflection and Refraction
+	glm::mat4 ReflScaleMatrix = glm::scale(glm::mat4(1.0f), kReflectionScale);
+	glm::mat4 RefrScaleMatrix = glm::scale(glm::mat4(1.0f), kRefractionScale);
+
+	//// update the objects in scene, once for both layers
+
+	if (m_pMotorBoat && m_pSky && m_pCurrentViewingCamera)
+	{
+		m_pMotorBoat->UpdateReflectedRefracted(ReflScaleMatrix, RefrScaleMatrix, *m_pCurrentViewingCamera, m_pSky->GetSunDirection(), m_IsRenderWireframe, i_CrrTime);
+	}
+
+	// the sky models which can't render both layers at once are updated per layer (check RenderReflectedRefractedScene())
+	if (m_pSky && m_pCurrentViewingCamera && m_pSky->IsLayeredReflRefrSupported())
+	{
+		m_pSky->UpdateReflectedRefracted(ReflScaleMatrix, RefrScaleMatrix, *m_pCurrentViewingCamera, m_IsRenderWireframe, i_CrrTime);
+	}
+}
+
 /*
 More info about boat buoyancy:
 
@@ -581,6 +824,29 @@ void Application::Render(const GlobalConfig& i_Config)
 #ifdef USE_GUI
 	RenderGUI();
 #endif //USE_GUI
+
+	// the new settings are used starting with the next frame
+	if (m_pQualityGovernor && m_pQualityGovernor->EndFrame(m_DeltaTime))
+	{
+		ApplyQualitySettings(i_Config);
+	}
+}
+
+void Application::ApplyQualitySettings(const GlobalConfig& i_Config)
+{
+	if (m_pOcean)
+	{
+		const QualityGovernor::QualitySettings& settings = m_pQualityGovernor->GetSettings();
+
+		m_pOcean->SetFFTSize(settings.FFTSize);
+		m_pOcean->SetScreenSpaceGridResolution(settings.ScreenSpaceGridResolution);
+		m_pOcean->SetCausticsMapSize(settings.CausticsMapSize);
+
+		if (i_Config.Scene.Ocean.UnderWater.GodRays.Enabled)
+		{
+			m_pOcean->SetGodRaysNumberOfSamples(settings.GodRaysNumberOfSamples);
+		}
+	}
 }
 
 void Application::RenderPPE(const GlobalConfig& i_Config)
@@ -591,6 +857,33 @@ void Application::RenderPPE(const GlobalConfig& i_Config)
 	}
 }
 
+bool Application::IsReflRefrUpdateNeeded(bool i_IsUnderWater) const
+{
+	if (m_IsReflRefrUpdateForced || m_ReflRefrFrameCount >= m_ReflRefrUpdateInterval)
+	{
+		return true;
+	}
+
+	// the layered pass renders both maps, so going through the ocean surface needs no update
+	if (!m_IsReflRefrLayered && i_IsUnderWater != m_IsReflRefrUnderWater)
+	{
+		return true;
+	}
+
+	// the reprojection can't fill the regions which were outside of the old view
+	return (m_pCurrentViewingCamera && glm::dot(m_pCurrentViewingCamera->GetForward(), m_ReflRefrCameraForward) < m_ReflRefrMinForwardDot);
+}
+
+int Application::GetReflRefrMapWidth(void) const
+{
+	return glm::max(static_cast<int>(m_WindowWidth * m_ReflRefrResolutionScale), 1);
+}
+
+int Application::GetReflRefrMapHeight(void) const
+{
+	return glm::max(static_cast<int>(m_WindowHeight * m_ReflRefrResolutionScale), 1);
+}
+
 void Application::RenderReflectedScene(void)
 {
 	// Local Reflection
@@ -600,6 +893,8 @@ void Application::RenderReflectedScene(void)
 		m_pFBM->SetupDrawBuffers(1, 0);
 	}
 
+	glViewport(0, 0, GetReflRefrMapWidth(), GetReflRefrMapHeight());
+
 	// clear the buffers for the current frame
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -626,6 +921,8 @@ void Application::RenderReflectedScene(void)
 	{
 		m_pFBM->UnBind();
 	}
+
+	glViewport(0, 0, m_WindowWidth, m_WindowHeight);
 }
 
 void Application::RenderRefractedScene(void)
@@ -637,6 +934,8 @@ void Application::RenderRefractedScene(void)
 		m_pFBM->SetupDrawBuffers(1, 1);
 	}
 
+	glViewport(0, 0, GetReflRefrMapWidth(), GetReflRefrMapHeight());
+
 	// clear the buffers for the current frame
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -663,6 +962,78 @@ void Application::RenderRefractedScene(void)
 	{
 		m_pFBM->UnBind();
 	}
+
+	glViewport(0, 0, m_WindowWidth, m_WindowHeight);
+}
+
+void Application::RenderReflectedRefractedScene(void)
+{
+	// Local Reflection and Refraction
+	// both maps are rendered in one pass, side by side: reflection in the left half, refraction in the right half
+	// the objects are drawn instanced, one instance per half (check MotorBoat.vert.glsl)
+	if (m_pFBM)
+	{
+		m_pFBM->Bind();
+		m_pFBM->SetupDrawBuffers(1, 0);
+	}
+
+	int mapWidth = GetReflRefrMapWidth(), mapHeight = GetReflRefrMapHeight();
+
+	glViewport(0, 0, kReflRefrLayerCount * mapWidth, mapHeight);
+
+	// clear the buffers for the current frame
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	// the reflection and refraction clip planes and the halves bounds
+	glEnable(GL_CLIP_DISTANCE0);
+	glEnable(GL_CLIP_DISTANCE1);
+	glEnable(GL_CLIP_DISTANCE2);
+	glEnable(GL_CLIP_DISTANCE3);
+
+	// the reflection instances are mirrored, so their winding is reverted
+	glDisable(GL_CULL_FACE);
+
+	// render the reflected and refracted objects in scene
+
+	if (m_pMotorBoat)
+	{
+		m_pMotorBoat->RenderReflectedRefracted();
+	}
+
+	// the sky has to be drawn last !!!
+	// as explined in here: https://learnopengl.com/#!Advanced-OpenGL/Cubemaps
+	if (m_pSky && m_pSky->IsLayeredReflRefrSupported())
+	{
+		m_pSky->RenderReflectedRefracted();
+	}
+
+	glDisable(GL_CLIP_DISTANCE0);
+	glDisable(GL_CLIP_DISTANCE1);
+	glDisable(GL_CLIP_DISTANCE2);
+	glDisable(GL_CLIP_DISTANCE3);
+
+	if (m_pSky && !m_pSky->IsLayeredReflRefrSupported() && m_pCurrentViewingCamera)
+	{
+		// the sky model is drawn once per half, the viewport keeps it inside
+		glViewport(0, 0, mapWidth, mapHeight);
+
+		m_pSky->UpdateReflected(glm::scale(glm::mat4(1.0f), kReflectionScale), *m_pCurrentViewingCamera, m_pCurrentViewingCamera->GetAltitude() < 0.0f, m_IsRenderWireframe, m_CrrTime);
+		m_pSky->RenderReflected();
+
+		glViewport(mapWidth, 0, mapWidth, mapHeight);
+
+		m_pSky->UpdateRefracted(glm::scale(glm::mat4(1.0f), kRefractionScale), *m_pCurrentViewingCamera, m_pCamera->GetAltitude() < 0.0f, m_IsRenderWireframe, m_CrrTime);
+		m_pSky->RenderRefracted();
+	}
+
+	glEnable(GL_CULL_FACE);
+
+	if (m_pFBM)
+	{
+		m_pFBM->UnBind();
+	}
+
+	glViewport(0, 0, m_WindowWidth, m_WindowHeight);
 }
 
 void Application::RenderScene(const GlobalConfig& i_Config)
@@ -721,8 +1092,17 @@ void Application::RenderScene(const GlobalConfig& i_Config)
 
 	if (m_pFBM)
 	{
-		m_pFBM->BindColorAttachmentByIndex(0, true); // reflection map
-		m_pFBM->BindColorAttachmentByIndex(1, true); // refraction map
+		if (m_IsReflRefrLayered)
+		{
+			// both maps are the halves of the same texture (check RenderReflectedRefractedScene())
+			m_pFBM->BindColorAttachmentByIndex(0, true); // reflection map
+			m_pFBM->BindColorAttachmentByIndex(0, false, i_Config.TexUnit.Global.RefractionMap); // refraction map
+		}
+		else
+		{
+			m_pFBM->BindColorAttachmentByIndex(0, true); // reflection map
+			m_pFBM->BindColorAttachmentByIndex(1, true); // refraction map
+		}
 	}
 
 	if (m_pOcean && m_pCurrentViewingCamera)
@@ -767,6 +1147,9 @@ void Application::RenderGUI()
 		//Draw AntTweakBar bars
 		int ret = TwDraw(); // returneaza 'Invalid Value' ca eroare OpenGL, dar e ok!
 		//assert(ret != 0);
+
+		// AntTweakBar binds its own program, textures and vertex array
+		GLStateCache::Invalidate();
 	}
 #endif //USE_GUI
 }
@@ -788,6 +1171,8 @@ void Application::TerminateScene(void)
 
 	SAFE_DELETE(m_pMotorBoat);
 
+	SAFE_DELETE(m_pQualityGovernor);
+
 #ifdef USE_GUI
 	// Terminate AntTweakBar
 	int ret = TwTerminate();
@@ -803,9 +1188,24 @@ void Application::SetupDefaultFrameBuffer(const GlobalConfig& i_Config)
 
 void Application::SetupAuxiliaryFrameBuffer(const GlobalConfig& i_Config)
 {
+	m_ReflRefrResolutionScale = glm::clamp(i_Config.VisualEffects.ReflectionRefraction.ResolutionScale, 0.1f, 1.0f);
+	m_ReflRefrUpdateInterval = glm::max(i_Config.VisualEffects.ReflectionRefraction.UpdateInterval, static_cast<unsigned short>(1));
+	m_ReflRefrMinForwardDot = glm::cos(glm::radians(i_Config.VisualEffects.ReflectionRefraction.MaxReprojectionAngle));
+	m_IsReflRefrUpdateForced = true;
+	m_IsReflRefrLayered = i_Config.VisualEffects.ReflectionRefraction.UseLayeredRendering;
+
+	// the maps are distorted by the waves anyway, so they can be smaller than the window
 	m_pFBM = new FrameBufferManager("Main Auxiliary FrameBuffer", i_Config);
 	assert(m_pFBM != nullptr);
-	m_pFBM->CreateSimple(2, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE, m_WindowWidth, m_WindowHeight, GL_CLAMP_TO_EDGE, GL_LINEAR, i_Config.TexUnit.Global.ReflectionMap, 5, false, FrameBufferManager::DEPTH_BUFFER_TYPE::DBT_RENDER_BUFFER_DEPTH_STENCIL);
+	if (m_IsReflRefrLayered)
+	{
+		// both maps side by side in one color attachment (check RenderReflectedRefractedScene())
+		m_pFBM->CreateSimple(1, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE, kReflRefrLayerCount * GetReflRefrMapWidth(), GetReflRefrMapHeight(), GL_CLAMP_TO_EDGE, GL_LINEAR, i_Config.TexUnit.Global.ReflectionMap, 5, false, FrameBufferManager::DEPTH_BUFFER_TYPE::DBT_RENDER_BUFFER_DEPTH_STENCIL);
+	}
+	else
+	{
+		m_pFBM->CreateSimple(2, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE, GetReflRefrMapWidth(), GetReflRefrMapHeight(), GL_CLAMP_TO_EDGE, GL_LINEAR, i_Config.TexUnit.Global.ReflectionMap, 5, false, FrameBufferManager::DEPTH_BUFFER_TYPE::DBT_RENDER_BUFFER_DEPTH_STENCIL);
+	}
 }
 
 void Application::SetupGL(const GlobalConfig& i_Config)
@@ -857,6 +1257,9 @@ void Application::SwitchViewBetweenCameras()
 		m_pCurrentViewingCamera = m_pObservingCamera;
 		m_IsCameraViewChanged = true;
 	}
+
+	// the maps were rendered for the other camera
+	m_IsReflRefrUpdateForced = true;
 }
 
 void Application::SwitchControlBetweenCameras()
@@ -895,9 +1298,19 @@ void Application::OnWindowResize(int i_Width, int i_Height)
 
 	if (m_pFBM)
 	{
-		m_pFBM->UpdateColorAttachmentSize(0, m_WindowWidth, m_WindowHeight); //reflection
-		m_pFBM->UpdateColorAttachmentSize(1, m_WindowWidth, m_WindowHeight); //refraction
-		m_pFBM->UpdateDepthBufferSize(m_WindowWidth, m_WindowHeight);
+		if (m_IsReflRefrLayered)
+		{
+			m_pFBM->UpdateColorAttachmentSize(0, kReflRefrLayerCount * GetReflRefrMapWidth(), GetReflRefrMapHeight()); //reflection + refraction
+			m_pFBM->UpdateDepthBufferSize(kReflRefrLayerCount * GetReflRefrMapWidth(), GetReflRefrMapHeight());
+		}
+		else
+		{
+			m_pFBM->UpdateColorAttachmentSize(0, GetReflRefrMapWidth(), GetReflRefrMapHeight()); //reflection
+			m_pFBM->UpdateColorAttachmentSize(1, GetReflRefrMapWidth(), GetReflRefrMapHeight()); //refraction
+			m_pFBM->UpdateDepthBufferSize(GetReflRefrMapWidth(), GetReflRefrMapHeight());
+		}
+
+		m_IsReflRefrUpdateForced = true;
 	}
 
 	if (m_pOcean)
@@ -9,6 +9,7 @@
 #include "SDL/SDL_events.h"
 #define GLM_SWIZZLE //offers the possibility to use: .xx(), xy(), xyz(), ...
 #include "glm/vec3.hpp"
+#include "glm/mat4x4.hpp"
 
 
 class GlobalConfig;
@@ -18,6 +19,7 @@ class PostProcessingManager;
 class Sky;
 class Ocean;
 class MotorBoat;
+class QualityGovernor;
 
 /*
 	Main application
@@ -137,6 +139,25 @@ private:
 	static void TW_CALL GetOceanVerySmallWavesFactor(void* i_pValue, void* i_pClientData);
 	static void TW_CALL SetOceanChoppyScale(const void* i_pValue, void* i_pClientData);
 	static void TW_CALL GetOceanChoppyScale(void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetOceanQuadtreeSelectionTime(void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetOceanQuadtreeVisibleTiles(void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetOceanQuadtreeCulledTiles(void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetGLIssuedCallCount(void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetGLElidedCallCount(void* i_pValue, void* i_pClientData);
+	static void TW_CALL SetQualityGovernorEnabled(const void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetQualityGovernorEnabled(void* i_pValue, void* i_pClientData);
+	static void TW_CALL SetQualityGovernorLevel(const void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetQualityGovernorLevel(void* i_pValue, void* i_pClientData);
+	static void TW_CALL SetQualityGovernorTargetFrameTime(const void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetQualityGovernorTargetFrameTime(void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetQualityGovernorCPUTime(void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetQualityGovernorGPUTime(void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetQualityGovernorLastDecision(void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetQualityGovernorDecisionCount(void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetOceanFFTSize(void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetOceanScreenSpaceGridResolution(void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetOceanCausticsMapSize(void* i_pValue, void* i_pClientData);
+	static void TW_CALL GetOceanGodRaysNumberOfSamples(void* i_pValue, void* i_pClientData);
 	static void TW_CALL SetFOV(const void* i_pValue, void* i_pClientData);
 	static void TW_CALL GetFOV(void* i_pValue, void* i_pClientData);
 #endif //USE_GUI
@@ -152,13 +173,25 @@ private:
 	void UpdatePPE(float i_CrrTime, float i_DeltaTime, const GlobalConfig& i_Config);
 	void UpdateReflectedScene(float i_CrrTime, float i_DeltaTime);
 	void UpdateRefractedScene(float i_CrrTime, float i_DeltaTime);
+	void UpdateReflectedRefractedScene(float i_CrrTime, float i_DeltaTime);
 	void UpdateScene(float i_CrrTime, float i_DeltaTime, const GlobalConfig& i_Config);
 
 	void ComputeBuoyancy(float i_DeltaTime, bool i_IsBuyoancyEnabled);
 
+	// applies the quality governor settings to the scene
+	void ApplyQualitySettings(const GlobalConfig& i_Config);
+
 	void RenderPPE(const GlobalConfig& i_Config);
 	void RenderReflectedScene(void);
 	void RenderRefractedScene(void);
+	// both maps in one pass (check m_IsReflRefrLayered)
+	void RenderReflectedRefractedScene(void);
+
+	// the local reflection and refraction maps are rendered every m_ReflRefrUpdateInterval frames,
+	// sooner if the camera changed too much since the last update
+	bool IsReflRefrUpdateNeeded(bool i_IsUnderWater) const;
+	int GetReflRefrMapWidth(void) const;
+	int GetReflRefrMapHeight(void) const;
 	void RenderScene(const GlobalConfig& i_Config);
 	void RenderGUI();
 
@@ -167,6 +200,20 @@ private:
 
 	//////// Auxilliary FBO for reflected and refracted objects!
 	FrameBufferManager* m_pFBM;
+
+	float m_ReflRefrResolutionScale;
+	unsigned short m_ReflRefrUpdateInterval;
+	// cosine of the max reprojection angle
+	float m_ReflRefrMinForwardDot;
+	// frames since the last maps update
+	unsigned short m_ReflRefrFrameCount;
+	bool m_IsReflRefrUpdateForced;
+	bool m_IsReflRefrUnderWater;
+	// both maps are rendered in one pass, side by side in one double width map
+	bool m_IsReflRefrLayered;
+	// the viewing camera state when the maps were rendered, used to reproject them
+	glm::vec3 m_ReflRefrCameraForward;
+	glm::mat4 m_ReflRefrWorldToClipMatrix;
 	////////
 #ifdef USE_GUI
 	// pointer to TwBar is required by the AntTweakBar library specs
@@ -179,6 +226,8 @@ private:
 	Ocean* m_pOcean;
 	MotorBoat* m_pMotorBoat;
 
+	QualityGovernor* m_pQualityGovernor;
+
 	float m_TimeScale, m_CrrTime, m_DeltaTime;
 	bool m_IsGUIVisible;
 
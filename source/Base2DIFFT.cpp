@@ -7,13 +7,13 @@
 
 
 Base2DIFFT::Base2DIFFT( void )
-	: m_NumButterflies(0), m_FFTSize(0), m_FFTLayerCount(0), m_UseFFTSlopes(false)
+	: m_NumButterflies(0), m_FFTSize(0), m_FFTLayerCount(0), m_UseFFTSlopes(false), m_IsPrepared(false)
 {
 	LOG("Base2DIFFT successfully created!");
 }
 
 Base2DIFFT::Base2DIFFT(const GlobalConfig& i_Config )
-  : m_NumButterflies(0), m_FFTSize(0), m_FFTLayerCount(0), m_UseFFTSlopes(false)
+  : m_NumButterflies(0), m_FFTSize(0), m_FFTLayerCount(0), m_UseFFTSlopes(false), m_IsPrepared(false)
 {
 	Initialize(i_Config);
 }
@@ -30,7 +30,7 @@ void Base2DIFFT::Destroy ( void )
 	LOG("Base2DIFFT successfully destroyed!");
 }
 
-void Base2DIFFT::Initialize(const GlobalConfig& i_Config)
+void Base2DIFFT::Prepare(const GlobalConfig& i_Config)
 {
 	m_FFTSize = i_Config.Scene.Ocean.Surface.OceanPatch.FFTSize;
 	m_UseFFTSlopes = i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.UseFFTSlopes;
@@ -38,6 +38,16 @@ void Base2DIFFT::Initialize(const GlobalConfig& i_Config)
 	// the FFT algorithm need log(n) base 2 steps
 	m_NumButterflies = static_cast<unsigned short>(glm::log2(static_cast<float>(m_FFTSize)));
 
+	m_IsPrepared = true;
+}
+
+void Base2DIFFT::Initialize(const GlobalConfig& i_Config)
+{
+	if (!m_IsPrepared)
+	{
+		Prepare(i_Config);
+	}
+
 	LOG("Base2DIFFT successfully created!");
 }
 
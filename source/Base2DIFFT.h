@@ -18,6 +18,9 @@ public:
 	Base2DIFFT(const GlobalConfig& i_Config);
 	virtual ~Base2DIFFT(void);
 
+	// CPU only part of Initialize(), no GL calls, so it can run on a worker thread
+	// Initialize() calls it, if it wasn't called before
+	virtual void Prepare(const GlobalConfig& i_Config);
 	virtual void Initialize(const GlobalConfig& i_Config);
 
 	virtual void Perform2DIFFT(void);
@@ -45,6 +48,8 @@ protected:
 
 	bool m_UseFFTSlopes;
 
+	bool m_IsPrepared;
+
 private:
 	//// Methods ////
 	void Destroy ( void );
@@ -9,6 +9,21 @@
 #include "GlobalConfig.h"
 
 
+const char* const BaseSkyModel::m_kUniformHandleNames[] =
+{
+	"u_ApplyHDR",
+	"u_WorldToClipMatrix",
+	"u_ObjectToWorldMatrix",
+	"u_ClipToCameraMatrix",
+	"u_CameraToWorldMatrix",
+	"u_CameraPosition",
+	"u_SunDirection",
+	"u_SunDirY",
+	"u_IsReflMode",
+	"u_IsUnderWater",
+	"u_IsLayered"
+};
+
 BaseSkyModel::BaseSkyModel ( void )
 	: m_IndexCount(0), m_IsWireframeMode(false)
 {
@@ -69,6 +84,21 @@ void BaseSkyModel::RenderRefracted ( void )
 	//stub
 }
 
+bool BaseSkyModel::IsLayeredReflRefrSupported ( void ) const
+{
+	return false;
+}
+
+void BaseSkyModel::UpdateReflectedRefracted ( const glm::mat4& i_ReflScaleMatrix, const glm::mat4& i_RefrScaleMatrix, const Camera& i_Camera, bool i_IsWireframeMode, float i_CrrTime )
+{
+	//stub
+}
+
+void BaseSkyModel::RenderReflectedRefracted ( void )
+{
+	//stub
+}
+
 void BaseSkyModel::UpdateSunPosition ( float i_CrrTime )
 {
 	if (m_SunData.IsDynamic)
@@ -35,6 +35,12 @@ public:
 	virtual void RenderReflected(void);
 	virtual void RenderRefracted(void);
 
+	// both layers of the layered reflection/refraction pass (check Application::RenderReflectedRefractedScene())
+	// the models which don't support it are rendered once per layer
+	virtual bool IsLayeredReflRefrSupported(void) const;
+	virtual void UpdateReflectedRefracted(const glm::mat4& i_ReflScaleMatrix, const glm::mat4& i_RefrScaleMatrix, const Camera& i_Camera, bool i_IsWireframeMode, float i_CrrTime);
+	virtual void RenderReflectedRefracted(void);
+
 	virtual void UpdateSunPosition(float i_CrrTime);
 
 	virtual void SetSunDirection(float i_Phi, float i_Theta);
@@ -65,6 +71,28 @@ protected:
 	// name, location
 	std::map<std::string, int> m_Uniforms;
 
+	// the uniforms set every frame, shared by the sky and clouds programs (check UniformHandleTable)
+	enum class UNIFORM_HANDLE
+	{
+		UH_APPLY_HDR = 0,
+		UH_WORLD_TO_CLIP_MATRIX,
+		UH_OBJECT_TO_WORLD_MATRIX,
+		UH_CLIP_TO_CAMERA_MATRIX,
+		UH_CAMERA_TO_WORLD_MATRIX,
+		UH_CAMERA_POSITION,
+		UH_SUN_DIRECTION,
+		UH_SUN_DIR_Y,
+		UH_IS_REFL_MODE,
+		UH_IS_UNDER_WATER,
+		UH_IS_LAYERED,
+		UH_COUNT
+	};
+
+	static const char* const m_kUniformHandleNames[static_cast<unsigned short>(UNIFORM_HANDLE::UH_COUNT)];
+
+	typedef ShaderManager::UniformHandleTable<UNIFORM_HANDLE, static_cast<unsigned short>(UNIFORM_HANDLE::UH_COUNT)> UniformHandles;
+	UniformHandles m_Handles;
+
 	struct SunData
 	{
 		glm::vec3 Direction;
@@ -3,7 +3,15 @@
 #include "CPUFFTW2DIFFT.h"
 #include "CommonHeaders.h"
 #include "GlobalConfig.h"
+#include "DisplacementCodec.h"
+#include "OceanFieldPublisher.h"
+#include "glm/common.hpp" //clamp()
+#include "glm/trigonometric.hpp" //sin(), cos()
+#include "glm/gtc/constants.hpp" //two_pi()
 #include <cassert>
+#ifdef USE_SSE
+#include <xmmintrin.h> // _mm_add_ps(), _mm_mul_ps()
+#endif // USE_SSE
 
 
 CPUFFTW2DIFFT::CPUFFTW2DIFFT ( void )
@@ -11,7 +19,7 @@ CPUFFTW2DIFFT::CPUFFTW2DIFFT ( void )
 #ifdef USE_FFTW
 	m_pDY(nullptr), m_pDX(nullptr), m_pDZ(nullptr), m_pSX(nullptr), m_pSZ(nullptr),
 #endif //USE_FFTW
-	  m_FFTDataTexId(0)
+	  m_FFTDataTexId(0), m_UseCPUMipMaps(false), m_UseSpectralMipMaps(false), m_MipMapCount(0), m_CascadeCount(1)
 {
 	LOG("CPUFFTW2DIFFT successfully created!");
 }
@@ -21,7 +29,7 @@ CPUFFTW2DIFFT::CPUFFTW2DIFFT ( const GlobalConfig& i_Config )
 #ifdef USE_FFTW
 	m_pDY(nullptr), m_pDX(nullptr), m_pDZ(nullptr), m_pSX(nullptr), m_pSZ(nullptr),
 #endif //USE_FTTW
-	  m_FFTDataTexId(0)
+	  m_FFTDataTexId(0), m_UseCPUMipMaps(false), m_UseSpectralMipMaps(false), m_MipMapCount(0), m_CascadeCount(1)
 {
 	Initialize(i_Config);
 }
@@ -32,27 +40,32 @@ CPUFFTW2DIFFT::~CPUFFTW2DIFFT ( void )
 	Destroy();
 }
 
-void CPUFFTW2DIFFT::Initialize ( const GlobalConfig& i_Config )
+void CPUFFTW2DIFFT::Prepare ( const GlobalConfig& i_Config )
 {
-	Base2DIFFT::Initialize(i_Config);
+	Base2DIFFT::Prepare(i_Config);
 
 #ifdef USE_FFTW
-	// NOTE! for FFT slopes we need 2 layers, otherwise only 1 is needed!
-	m_FFTLayerCount = (m_UseFFTSlopes ? 2 : 1);
+	m_CascadeCount = glm::clamp<unsigned short>(i_Config.Scene.Ocean.Surface.OceanPatch.Cascades.Count, 1, m_kMaxCascadeCount);
+
+	// NOTE! for FFT slopes we need 2 layers per cascade, otherwise only 1 is needed!
+	m_FFTLayerCount = (m_UseFFTSlopes ? 2 : 1) * m_CascadeCount;
+
+	unsigned int cascadeDataSize = m_FFTSize * m_FFTSize;
+	unsigned int dataSize = cascadeDataSize * m_CascadeCount;
 
 	// Allocate memory for data structures used to compute 2D IFFT
-	m_pDY = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * m_FFTSize * m_FFTSize);
+	m_pDY = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * dataSize);
 	assert(m_pDY != nullptr);
-	m_pDX = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * m_FFTSize * m_FFTSize);
+	m_pDX = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * dataSize);
 	assert(m_pDX != nullptr);
-	m_pDZ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * m_FFTSize * m_FFTSize);
+	m_pDZ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * dataSize);
 	assert(m_pDZ != nullptr);
 
 	if (m_UseFFTSlopes)
 	{
-		m_pSX = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * m_FFTSize * m_FFTSize);
+		m_pSX = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * dataSize);
 		assert(m_pSX != nullptr);
-		m_pSZ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * m_FFTSize * m_FFTSize);
+		m_pSZ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * dataSize);
 		assert(m_pSZ != nullptr);
 	}
 
@@ -71,30 +84,111 @@ void CPUFFTW2DIFFT::Initialize ( const GlobalConfig& i_Config )
 
 	// NOTE! The best flags are: FFTW_MEASURE, FFTW_PATIENT, FFTW_EXHAUSTIVE (increased time, but more optimal)
 	// the fastest flag is FFTW_MEASURE, the most optim is FFTW_PATIENT (for this PC)
-	m_PDY = fftw_plan_dft_2d(m_FFTSize, m_FFTSize, m_pDY, m_pDY, FFTW_BACKWARD, FFTW_MEASURE);
-	m_PDX = fftw_plan_dft_2d(m_FFTSize, m_FFTSize, m_pDX, m_pDX, FFTW_BACKWARD, FFTW_MEASURE);
-	m_PDZ = fftw_plan_dft_2d(m_FFTSize, m_FFTSize, m_pDZ, m_pDZ, FFTW_BACKWARD, FFTW_MEASURE);
+	// NOTE! the FFTW planner isn't thread safe, only one thread at a time should create or destroy plans (check FFTOceanPatchBuilder)
+	// the cascades are transformed together, one FFTSize x FFTSize transform every FFTSize * FFTSize complex numbers
+	int fftSize[] = { m_FFTSize, m_FFTSize };
+
+	m_PDY = fftw_plan_many_dft(2, fftSize, m_CascadeCount, m_pDY, nullptr, 1, cascadeDataSize, m_pDY, nullptr, 1, cascadeDataSize, FFTW_BACKWARD, FFTW_MEASURE);
+	m_PDX = fftw_plan_many_dft(2, fftSize, m_CascadeCount, m_pDX, nullptr, 1, cascadeDataSize, m_pDX, nullptr, 1, cascadeDataSize, FFTW_BACKWARD, FFTW_MEASURE);
+	m_PDZ = fftw_plan_many_dft(2, fftSize, m_CascadeCount, m_pDZ, nullptr, 1, cascadeDataSize, m_pDZ, nullptr, 1, cascadeDataSize, FFTW_BACKWARD, FFTW_MEASURE);
 
 	if (m_UseFFTSlopes)
 	{
-		m_PSX = fftw_plan_dft_2d(m_FFTSize, m_FFTSize, m_pSX, m_pSX, FFTW_BACKWARD, FFTW_MEASURE);
-		m_PSZ = fftw_plan_dft_2d(m_FFTSize, m_FFTSize, m_pSZ, m_pSZ, FFTW_BACKWARD, FFTW_MEASURE);
+		m_PSX = fftw_plan_many_dft(2, fftSize, m_CascadeCount, m_pSX, nullptr, 1, cascadeDataSize, m_pSX, nullptr, 1, cascadeDataSize, FFTW_BACKWARD, FFTW_MEASURE);
+		m_PSZ = fftw_plan_many_dft(2, fftSize, m_CascadeCount, m_pSZ, nullptr, 1, cascadeDataSize, m_pSZ, nullptr, 1, cascadeDataSize, FFTW_BACKWARD, FFTW_MEASURE);
 	}
 
-	////////////
-	m_TM.Initialize("CPUFFTW2DIFFT", i_Config);
-	// NOTE! no need for more than 3 levels of mipmaps
-	m_FFTDataTexId = m_TM.Create2DArrayTexture(m_FFTLayerCount, GL_RGBA16F, GL_RGBA, GL_FLOAT, m_FFTSize, m_FFTSize, GL_REPEAT, GL_LINEAR, nullptr, i_Config.TexUnit.Ocean.CPU2DIFFT.FFTMap, m_kMipmapCount);
+	m_FFTProcessedData.resize(cascadeDataSize * m_FFTLayerCount);
 
-	if (m_UseFFTSlopes)
+	m_UseSpectralMipMaps = i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.SpectralMipMaps.Enabled;
+	// the spectral levels replace the box filtered ones
+	m_UseCPUMipMaps = (i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.UseCPUMipMaps && !m_UseSpectralMipMaps);
+	m_MipMapCount = m_kMipmapCount;
+
+	if (m_UseSpectralMipMaps)
 	{
-		m_FFTProcessedData.resize(m_FFTSize * m_FFTSize * 2);
+		// the smallest level is 8 x 8
+		unsigned short maxMipMapCount = (m_NumButterflies > 3 ? m_NumButterflies - 2 : 1);
+		m_MipMapCount = glm::clamp<unsigned short>(i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.SpectralMipMaps.LevelCount, 1, maxMipMapCount);
+
+		PrepareSpectralMipMapLevels();
 	}
-	else
+
+	if (m_UseCPUMipMaps || m_UseSpectralMipMaps)
 	{
-		m_FFTProcessedData.resize(m_FFTSize * m_FFTSize);
+		m_FFTProcessedMipMapData.resize(m_MipMapCount - 1);
+
+		for (unsigned short i = 0; i < m_FFTProcessedMipMapData.size(); ++i)
+		{
+			unsigned short levelSize = m_FFTSize >> (i + 1);
+			m_FFTProcessedMipMapData[i].resize(levelSize * levelSize * m_FFTLayerCount);
+		}
+
+		m_FFTProcessedMipMapLevels.resize(m_MipMapCount);
+		m_FFTProcessedMipMapLevels[0] = &m_FFTProcessedData[0];
+
+		for (unsigned short i = 1; i < m_MipMapCount; ++i)
+		{
+			m_FFTProcessedMipMapLevels[i] = &m_FFTProcessedMipMapData[i - 1][0];
+		}
 	}
 #endif //USE_FFTW
+}
+
+void CPUFFTW2DIFFT::PrepareSpectralMipMapLevels ( void )
+{
+#ifdef USE_FFTW
+	unsigned short componentCount = (m_UseFFTSlopes ? m_kSpectralComponentCount : 3);
+
+	m_SpectralMipMapLevels.resize(m_MipMapCount - 1);
+
+	for (unsigned short i = 0; i < m_SpectralMipMapLevels.size(); ++i)
+	{
+		SpectralMipMapLevel& level = m_SpectralMipMapLevels[i];
+
+		level.Size = m_FFTSize >> (i + 1);
+		level.BandOffset = (m_FFTSize - level.Size) / 2;
+
+		// The IFFT samples the band at the level texels corners, but a mipmap texel covers 2^l x 2^l base texels,
+		// its centre being (2^l - 1) / 2 base texels away. The wave n (-Size / 2 <= n < Size / 2) is shifted by exp(i * 2 * PI * n * offset / FFTSize).
+		float texelOffset = 0.5f * static_cast<float>((1 << (i + 1)) - 1);
+
+		level.PhaseShifts.resize(level.Size);
+		for (unsigned short j = 0; j < level.Size; ++j)
+		{
+			float phase = glm::two_pi<float>() * (j - 0.5f * level.Size) * texelOffset / m_FFTSize;
+			level.PhaseShifts[j] = std::complex<float>(glm::cos(phase), glm::sin(phase));
+		}
+
+		int levelSize[] = { level.Size, level.Size };
+		int levelDataSize = level.Size * level.Size;
+
+		for (unsigned short c = 0; c < m_kSpectralComponentCount; ++c)
+		{
+			level.pData[c] = nullptr;
+			level.Plans[c] = nullptr;
+
+			if (c < componentCount)
+			{
+				level.pData[c] = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * levelDataSize * m_CascadeCount);
+				assert(level.pData[c] != nullptr);
+
+				level.Plans[c] = fftw_plan_many_dft(2, levelSize, m_CascadeCount, level.pData[c], nullptr, 1, levelDataSize, level.pData[c], nullptr, 1, levelDataSize, FFTW_BACKWARD, FFTW_MEASURE);
+			}
+		}
+	}
+#endif //USE_FFTW
+}
+
+void CPUFFTW2DIFFT::Initialize ( const GlobalConfig& i_Config )
+{
+	Base2DIFFT::Initialize(i_Config);
+
+#ifdef USE_FFTW
+	m_TM.Initialize("CPUFFTW2DIFFT", i_Config);
+	// NOTE! no need for more than 3 levels of mipmaps
+	m_FFTDataTexId = m_TM.Create2DArrayTexture(m_FFTLayerCount, GL_RGBA16F, GL_RGBA, GL_FLOAT, m_FFTSize, m_FFTSize, GL_REPEAT, GL_LINEAR, nullptr, i_Config.TexUnit.Ocean.CPU2DIFFT.FFTMap, m_MipMapCount);
+#endif //USE_FFTW
 
 	LOG("CPUFFTW2DIFFT successfully created!");
 }
@@ -102,6 +196,16 @@ void CPUFFTW2DIFFT::Initialize ( const GlobalConfig& i_Config )
 void CPUFFTW2DIFFT::Destroy ( void )
 {
 #ifdef USE_FFTW
+	for (unsigned short i = 0; i < m_SpectralMipMapLevels.size(); ++i)
+	{
+		for (unsigned short c = 0; c < m_kSpectralComponentCount; ++c)
+		{
+			if (m_SpectralMipMapLevels[i].Plans[c]) fftw_destroy_plan(m_SpectralMipMapLevels[i].Plans[c]);
+			if (m_SpectralMipMapLevels[i].pData[c]) fftw_free(m_SpectralMipMapLevels[i].pData[c]);
+		}
+	}
+	m_SpectralMipMapLevels.clear();
+
 	if (m_PDY) fftw_destroy_plan(m_PDY);
 	if (m_PDX) fftw_destroy_plan(m_PDX);
 	if (m_PDZ) fftw_destroy_plan(m_PDZ);
@@ -129,7 +233,7 @@ void CPUFFTW2DIFFT::Destroy ( void )
 void CPUFFTW2DIFFT::Pre2DFFTSetup ( const std::complex<float>& i_DX, const std::complex<float>& i_DY, const std::complex<float>& i_DZ, const std::complex<float>& i_SX, const std::complex<float>& i_SZ, unsigned int i_Index )
 {
 #ifdef USE_FFTW
-	assert(i_Index < (unsigned int)(m_FFTSize * m_FFTSize));
+	assert(i_Index < (unsigned int)(m_FFTSize * m_FFTSize * m_CascadeCount));
 
 	if (m_pDY && m_pDX && m_pDZ)
 	{
@@ -154,6 +258,43 @@ void CPUFFTW2DIFFT::Pre2DFFTSetup ( const std::complex<float>& i_DX, const std::
 			m_pSZ[i_Index][1] = i_SZ.imag();
 		}
 	}
+
+	if (m_UseSpectralMipMaps)
+	{
+		unsigned int cascadeDataSize = m_FFTSize * m_FFTSize;
+		unsigned int cascade = i_Index / cascadeDataSize, cascadeIndex = i_Index % cascadeDataSize;
+
+		// negative values wrap around, so they are out of the band too
+		unsigned int row = cascadeIndex / m_FFTSize, column = cascadeIndex % m_FFTSize;
+		const std::complex<float> values[m_kSpectralComponentCount] = { i_DY, i_DX, i_DZ, i_SX, i_SZ };
+
+		for (unsigned short i = 0; i < m_SpectralMipMapLevels.size(); ++i)
+		{
+			SpectralMipMapLevel& level = m_SpectralMipMapLevels[i];
+
+			unsigned int bandRow = row - level.BandOffset, bandColumn = column - level.BandOffset;
+
+			// every level band is inside the previous level band
+			if (bandRow >= level.Size || bandColumn >= level.Size)
+			{
+				break;
+			}
+
+			std::complex<float> phaseShift = level.PhaseShifts[bandRow] * level.PhaseShifts[bandColumn];
+			unsigned int bandIndex = (cascade * level.Size + bandRow) * level.Size + bandColumn;
+
+			for (unsigned short c = 0; c < m_kSpectralComponentCount; ++c)
+			{
+				if (level.pData[c])
+				{
+					std::complex<float> value = values[c] * phaseShift;
+
+					level.pData[c][bandIndex][0] = value.real();
+					level.pData[c][bandIndex][1] = value.imag();
+				}
+			}
+		}
+	}
 #endif //USE_FFTW
 }
 
@@ -170,23 +311,36 @@ void CPUFFTW2DIFFT::Perform2DIFFT ( void )
 		if (m_PSX) fftw_execute(m_PSX);
 		if (m_PSZ) fftw_execute(m_PSZ);
 	}
+
+	for (unsigned short i = 0; i < m_SpectralMipMapLevels.size(); ++i)
+	{
+		for (unsigned short c = 0; c < m_kSpectralComponentCount; ++c)
+		{
+			if (m_SpectralMipMapLevels[i].Plans[c]) fftw_execute(m_SpectralMipMapLevels[i].Plans[c]);
+		}
+	}
 #endif //USE_FFTW
 }
 
 void CPUFFTW2DIFFT::Post2DFFTSetup ( short i_Sign, unsigned int i_Index )
 {
 #ifdef USE_FFTW
-	assert(i_Index < (unsigned int)(m_FFTSize * m_FFTSize));
+	assert(i_Index < (unsigned int)(m_FFTSize * m_FFTSize * m_CascadeCount));
 
 	const short k_lambda = -1;
 	short sign_correction = i_Sign * k_lambda;
 
+	unsigned int cascadeDataSize = m_FFTSize * m_FFTSize;
+	unsigned int cascade = i_Index / cascadeDataSize;
+	// the cascade layers: displacement, slopes
+	unsigned int dataIndex = i_Index + cascade * (m_FFTLayerCount / m_CascadeCount - 1) * cascadeDataSize;
+
 	if (m_pDX && m_pDY && m_pDZ)
 	{
 		// 1st texture layer - displacement
-		m_FFTProcessedData[i_Index].x = m_pDX[i_Index][0] * sign_correction;
-		m_FFTProcessedData[i_Index].y = m_pDY[i_Index][0] * i_Sign;
-		m_FFTProcessedData[i_Index].z = m_pDZ[i_Index][0] * sign_correction;
+		m_FFTProcessedData[dataIndex].x = m_pDX[i_Index][0] * sign_correction;
+		m_FFTProcessedData[dataIndex].y = m_pDY[i_Index][0] * i_Sign;
+		m_FFTProcessedData[dataIndex].z = m_pDZ[i_Index][0] * sign_correction;
 	}
 
 	if (m_UseFFTSlopes)
@@ -194,9 +348,9 @@ void CPUFFTW2DIFFT::Post2DFFTSetup ( short i_Sign, unsigned int i_Index )
 		if (m_pSX && m_pSZ)
 		{
 			// 2nd texture layer - slopes
-			unsigned int offset = m_FFTSize * m_FFTSize;
-			m_FFTProcessedData[i_Index + offset].x = m_pSX[i_Index][0] * sign_correction;
-			m_FFTProcessedData[i_Index + offset].y = m_pSZ[i_Index][0] * sign_correction;
+			unsigned int offset = cascadeDataSize;
+			m_FFTProcessedData[dataIndex + offset].x = m_pSX[i_Index][0] * sign_correction;
+			m_FFTProcessedData[dataIndex + offset].y = m_pSZ[i_Index][0] * sign_correction;
 		}
 	}
 #endif //USE_FFTW
@@ -212,7 +366,141 @@ void CPUFFTW2DIFFT::BindDestinationTexture ( void ) const
 void CPUFFTW2DIFFT::UpdateTextureData ( void )
 {
 #ifdef USE_FFTW
-	m_TM.Update2DArrayTextureData(m_FFTDataTexId, &m_FFTProcessedData[0]);
+	if (m_UseSpectralMipMaps)
+	{
+		ComputeSpectralMipMapLevels();
+
+		m_TM.Update2DArrayTextureData(m_FFTDataTexId, &m_FFTProcessedMipMapLevels[0], m_MipMapCount);
+	}
+	else if (m_UseCPUMipMaps)
+	{
+		for (unsigned short i = 0; i < m_FFTProcessedMipMapData.size(); ++i)
+		{
+			const glm::vec4* pSourceData = (i == 0 ? &m_FFTProcessedData[0] : &m_FFTProcessedMipMapData[i - 1][0]);
+			unsigned short sourceSize = m_FFTSize >> i;
+			unsigned short destinationSize = sourceSize >> 1;
+
+			// every layer is filtered separately
+			for (unsigned short layer = 0; layer < m_FFTLayerCount; ++layer)
+			{
+				ComputeMipMapLevel(pSourceData + layer * sourceSize * sourceSize, sourceSize, &m_FFTProcessedMipMapData[i][layer * destinationSize * destinationSize]);
+			}
+		}
+
+		m_TM.Update2DArrayTextureData(m_FFTDataTexId, &m_FFTProcessedMipMapLevels[0], m_MipMapCount);
+	}
+	else
+	{
+		m_TM.Update2DArrayTextureData(m_FFTDataTexId, &m_FFTProcessedData[0]);
+	}
+#endif //USE_FFTW
+}
+
+// 2x2 box filter, the FFT size is always a power of 2, so no odd sizes need to be handled
+void CPUFFTW2DIFFT::ComputeMipMapLevel ( const glm::vec4* i_pSourceData, unsigned short i_SourceSize, glm::vec4* o_pDestinationData ) const
+{
+	assert(i_pSourceData != nullptr);
+	assert(o_pDestinationData != nullptr);
+
+	unsigned short destinationSize = i_SourceSize >> 1;
+
+#ifdef USE_SSE
+	const __m128 kQuarter = _mm_set1_ps(0.25f);
+#endif // USE_SSE
+
+	for (unsigned short i = 0; i < destinationSize; ++i)
+	{
+		const glm::vec4* pRow0 = i_pSourceData + (2 * i) * i_SourceSize;
+		const glm::vec4* pRow1 = pRow0 + i_SourceSize;
+		glm::vec4* pDestinationRow = o_pDestinationData + i * destinationSize;
+
+		for (unsigned short j = 0; j < destinationSize; ++j)
+		{
+#ifdef USE_SSE
+			// glm::vec4 is 4 tightly packed floats
+			__m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(&pRow0[2 * j].x), _mm_loadu_ps(&pRow0[2 * j + 1].x)),
+									_mm_add_ps(_mm_loadu_ps(&pRow1[2 * j].x), _mm_loadu_ps(&pRow1[2 * j + 1].x)));
+			_mm_storeu_ps(&pDestinationRow[j].x, _mm_mul_ps(sum, kQuarter));
+#else
+			pDestinationRow[j] = (pRow0[2 * j] + pRow0[2 * j + 1] + pRow1[2 * j] + pRow1[2 * j + 1]) * 0.25f;
+#endif // USE_SSE
+		}
+	}
+}
+
+void CPUFFTW2DIFFT::ComputeSpectralMipMapLevels ( void )
+{
+#ifdef USE_FFTW
+	const short k_lambda = -1;
+	const short k_signs[] = { 1, -1 };
+
+	unsigned short cascadeLayerCount = m_FFTLayerCount / m_CascadeCount;
+
+	for (unsigned short i = 0; i < m_SpectralMipMapLevels.size(); ++i)
+	{
+		const SpectralMipMapLevel& level = m_SpectralMipMapLevels[i];
+		unsigned int levelTexelCount = level.Size * level.Size;
+
+		for (unsigned short cascade = 0; cascade < m_CascadeCount; ++cascade)
+		{
+			glm::vec4* pDisplacement = &m_FFTProcessedMipMapData[i][cascade * cascadeLayerCount * levelTexelCount];
+			glm::vec4* pSlopes = (m_UseFFTSlopes ? pDisplacement + levelTexelCount : nullptr);
+
+			for (unsigned short row = 0; row < level.Size; ++row)
+			{
+				for (unsigned short column = 0; column < level.Size; ++column)
+				{
+					unsigned int index = row * level.Size + column;
+					unsigned int bandIndex = cascade * levelTexelCount + index;
+
+					// same sign correction as the base level, the band is centred the same way
+					short sign = k_signs[(row + column) & 1];
+					short sign_correction = sign * k_lambda;
+
+					// 1st texture layer - displacement
+					pDisplacement[index].x = level.pData[1][bandIndex][0] * sign_correction;
+					pDisplacement[index].y = level.pData[0][bandIndex][0] * sign;
+					pDisplacement[index].z = level.pData[2][bandIndex][0] * sign_correction;
+
+					// 2nd texture layer - slopes
+					if (pSlopes)
+					{
+						pSlopes[index].x = level.pData[3][bandIndex][0] * sign_correction;
+						pSlopes[index].y = level.pData[4][bandIndex][0] * sign_correction;
+					}
+				}
+			}
+		}
+	}
+#endif //USE_FFTW
+}
+
+void CPUFFTW2DIFFT::EncodeProcessedData ( DisplacementCodec& io_Codec, std::vector<unsigned char>& o_EncodedData ) const
+{
+#ifdef USE_FFTW
+	io_Codec.EncodeFrame(&m_FFTProcessedData[0], m_FFTLayerCount, m_FFTSize * m_FFTSize, o_EncodedData);
+#endif //USE_FFTW
+}
+
+bool CPUFFTW2DIFFT::DecodeProcessedData ( DisplacementCodec& io_Codec, const std::vector<unsigned char>& i_EncodedData )
+{
+#ifdef USE_FFTW
+	if (i_EncodedData.empty())
+	{
+		ERR("Empty encoded data!");
+		return false;
+	}
+
+	return io_Codec.DecodeFrame(&i_EncodedData[0], i_EncodedData.size(), &m_FFTProcessedData[0], m_FFTLayerCount, m_FFTSize * m_FFTSize);
+#else
+	return false;
+#endif //USE_FFTW
+}
+
+void CPUFFTW2DIFFT::PublishProcessedData ( OceanFieldPublisher& io_Publisher, float i_SimulationTime ) const
+{
+#ifdef USE_FFTW
+	io_Publisher.Publish(&m_FFTProcessedData[0], i_SimulationTime);
 #endif //USE_FFTW
 }
 
@@ -232,4 +520,14 @@ unsigned short CPUFFTW2DIFFT::GetDestinationTexUnitId ( void ) const
 #else
 	return 0;
 #endif //USE_FFTW
+}
+
+const glm::vec4* CPUFFTW2DIFFT::GetProcessedData ( void ) const
+{
+	return (m_FFTProcessedData.empty() ? nullptr : &m_FFTProcessedData[0]);
+}
+
+unsigned short CPUFFTW2DIFFT::GetCascadeCount ( void ) const
+{
+	return m_CascadeCount;
 }
\ No newline at end of file
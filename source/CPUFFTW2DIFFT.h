@@ -14,6 +14,10 @@
 #include "glm/vec4.hpp"
 #include "MeshBufferManager.h"
 #include <complex> //to use std::complex numbers
+#include <vector>
+
+class DisplacementCodec;
+class OceanFieldPublisher;
 
 #ifdef USE_FFTW
 //OPTIMIZATION: use single precision(float) fftw, by default the double-precision(double) is used!
@@ -21,6 +25,7 @@
 #define fftw_plan            fftwf_plan
 #define fftw_destroy_plan    fftwf_destroy_plan
 #define fftw_plan_dft_2d     fftwf_plan_dft_2d
+#define fftw_plan_many_dft   fftwf_plan_many_dft
 #define fftw_execute         fftwf_execute
 #define fftw_malloc          fftwf_malloc
 #define fftw_free            fftwf_free
@@ -31,6 +36,18 @@ class GlobalConfig;
 /*
  CPU implementation of the 2D IFFT using the FFTW - a free 3rd party library
  More info about FFTW: http://fftw.org/
+
+ Optionally the mipmaps are built on the CPU (2x2 box filter, SSE if available) and all levels are uploaded together,
+ so no glGenerateMipmap call is needed on the GPU side
+
+ With spectral mipmaps every mipmap level is a smaller 2D IFFT of the low frequency band of the same spectrum
+ (the central Size x Size waves), instead of a filtered version of the displacement texture.
+ The distant waves (sampled from the smaller levels by the surface shaders, check textureGrad()/textureLod()) are then band limited
+ geometry, without the shimmering of the box filtered levels. There can be more levels than the default m_kMipmapCount.
+
+ Several cascades (patches with different sizes, check FFTOceanPatchCPUFFTW) can be transformed together:
+ every FFT component holds the cascades data one after the other and is transformed by one batched plan (fftw_plan_many_dft()).
+ Each cascade has its own texture layers: displacement (and slopes) of cascade 0, displacement (and slopes) of cascade 1, ...
 */
 
 class CPUFFTW2DIFFT: public Base2DIFFT
@@ -40,23 +57,47 @@ public:
 	CPUFFTW2DIFFT(const GlobalConfig& i_Config);
 	~CPUFFTW2DIFFT(void);
 
+	// allocates the FFT data and creates the FFTW plans
+	void Prepare(const GlobalConfig& i_Config) override;
 	void Initialize(const GlobalConfig& i_Config) override;
 
+	// i_Index - cascade * FFTSize * FFTSize + row * FFTSize + column
 	void Pre2DFFTSetup(const std::complex<float>& i_DX, const std::complex<float>& i_DY, const std::complex<float>& i_DZ, const std::complex<float>& i_SX, const std::complex<float>& i_SZ, unsigned int i_Index);
 	void Perform2DIFFT(void) override;
 	void Post2DFFTSetup(short i_Sign, unsigned int i_Index);
 
 	void UpdateTextureData(void);
 
+	// compact encoding of the processed (post FFT) data, check DisplacementCodec
+	// after a successful decoding, the texture can be updated as usual with UpdateTextureData()
+	void EncodeProcessedData(DisplacementCodec& io_Codec, std::vector<unsigned char>& o_EncodedData) const;
+	bool DecodeProcessedData(DisplacementCodec& io_Codec, const std::vector<unsigned char>& i_EncodedData);
+
+	// shares the processed (post FFT) data with other local processes, check OceanFieldPublisher
+	void PublishProcessedData(OceanFieldPublisher& io_Publisher, float i_SimulationTime) const;
+
 	void BindDestinationTexture(void) const override;
 
 	unsigned int GetDestinationTexId(void) const override;
 	unsigned short GetDestinationTexUnitId(void) const override;
 
+	// FFTSize * FFTSize rgba values per layer, layer after layer (displacement is layer 0)
+	const glm::vec4* GetProcessedData(void) const;
+
+	unsigned short GetCascadeCount(void) const;
+
+	// the cascades are sent to the shaders as a vec4
+	static const unsigned short m_kMaxCascadeCount = 4;
+
 private:
 	//// Methods ////
 	void Destroy(void);
 
+	void ComputeMipMapLevel(const glm::vec4* i_pSourceData, unsigned short i_SourceSize, glm::vec4* o_pDestinationData) const;
+	void PrepareSpectralMipMapLevels(void);
+	// sign correction of the spectral mipmap levels IFFT data, check Post2DFFTSetup()
+	void ComputeSpectralMipMapLevels(void);
+
 	//// Variables ////
 #ifdef USE_FFTW
 	// Pointers are needed here, because we don't know the exact FFT size
@@ -70,6 +111,40 @@ private:
 	unsigned int m_FFTDataTexId;
 
 	std::vector<glm::vec4> m_FFTProcessedData;
+
+	// index 0 - mipmap level 1, index 1 - mipmap level 2, ...
+	std::vector<std::vector<glm::vec4>> m_FFTProcessedMipMapData;
+	// all the levels, the base level included, as uploaded by UpdateTextureData()
+	std::vector<void*> m_FFTProcessedMipMapLevels;
+
+	bool m_UseCPUMipMaps;
+
+#ifdef USE_FFTW
+	// DY, DX, DZ, SX, SZ
+	static const unsigned short m_kSpectralComponentCount = 5;
+
+	struct SpectralMipMapLevel
+	{
+		unsigned short Size;
+		// the first spectrum row (and column) of the band
+		unsigned short BandOffset;
+
+		fftw_complex* pData[m_kSpectralComponentCount];
+		fftw_plan Plans[m_kSpectralComponentCount];
+
+		// per band row (and column), moves the level samples to the mipmap texel centres
+		std::vector<std::complex<float>> PhaseShifts;
+	};
+
+	// index 0 - mipmap level 1, index 1 - mipmap level 2, ...
+	std::vector<SpectralMipMapLevel> m_SpectralMipMapLevels;
+#endif //USE_FFTW
+
+	bool m_UseSpectralMipMaps;
+	// the texture mipmap levels, the base level included
+	unsigned short m_MipMapCount;
+
+	unsigned short m_CascadeCount;
 };
 
 #endif /* CPU_FFTW_2D_IFFT_H */
\ No newline at end of file
@@ -0,0 +1,331 @@
+/* Author: BAIRAC MIHAI */
+
+#include "CPUProjectedGrid.h"
+#include "CommonHeaders.h"
+#include "GlobalConfig.h"
+#include "HelperFunctions.h"
+#include "glm/common.hpp" //floor(), max(), mix()
+#include <thread> // std::thread
+#include <mutex> // std::mutex, std::unique_lock
+#include <condition_variable> // std::condition_variable
+#include <vector>
+#include <chrono> // std::chrono::steady_clock
+#include <cassert>
+#ifdef USE_SSE
+#include <xmmintrin.h> // _mm_add_ps(), _mm_mul_ps(), _mm_div_ps()
+#endif // USE_SSE
+
+
+CPUProjectedGrid::CPUProjectedGrid ( void )
+	: m_Width(0), m_Height(0), m_ThreadCount(0), m_RowsPerThread(0), m_LastGenerationTime(0.0f),
+	  m_pGenerationData(nullptr), m_GenerationIndex(0), m_PendingWorkerCount(0), m_IsStopping(false)
+{
+	LOG("CPUProjectedGrid successfully created!");
+}
+
+CPUProjectedGrid::CPUProjectedGrid ( const GlobalConfig& i_Config )
+	: m_Width(0), m_Height(0), m_ThreadCount(0), m_RowsPerThread(0), m_LastGenerationTime(0.0f),
+	  m_pGenerationData(nullptr), m_GenerationIndex(0), m_PendingWorkerCount(0), m_IsStopping(false)
+{
+	Initialize(i_Config);
+}
+
+CPUProjectedGrid::CPUProjectedGrid ( unsigned short i_Width, unsigned short i_Height, unsigned short i_ThreadCount )
+	: m_Width(0), m_Height(0), m_ThreadCount(0), m_RowsPerThread(0), m_LastGenerationTime(0.0f),
+	  m_pGenerationData(nullptr), m_GenerationIndex(0), m_PendingWorkerCount(0), m_IsStopping(false)
+{
+	Initialize(i_Width, i_Height, i_ThreadCount);
+}
+
+CPUProjectedGrid::~CPUProjectedGrid ( void )
+{
+	Destroy();
+}
+
+void CPUProjectedGrid::Destroy ( void )
+{
+	StopWorkers();
+
+	LOG("CPUProjectedGrid successfully destroyed!");
+}
+
+void CPUProjectedGrid::Initialize ( const GlobalConfig& i_Config )
+{
+	Initialize(i_Config.Scene.Ocean.Grid.CPUProjected.Width, i_Config.Scene.Ocean.Grid.CPUProjected.Height, i_Config.Scene.Ocean.Grid.CPUProjected.ThreadCount);
+}
+
+void CPUProjectedGrid::Initialize ( unsigned short i_Width, unsigned short i_Height, unsigned short i_ThreadCount )
+{
+	if (i_Width < 2 || i_Height < 2)
+	{
+		ERR("Invalid CPU projected grid size! At least 2 x 2 vertices are needed!");
+		return;
+	}
+
+	// the pool is sized for the previous grid
+	StopWorkers();
+
+	m_Width = i_Width;
+	m_Height = i_Height;
+
+	// 0 - one thread per hardware thread
+	m_ThreadCount = (i_ThreadCount > 0 ? i_ThreadCount : static_cast<unsigned short>(std::thread::hardware_concurrency()));
+	if (m_ThreadCount == 0)
+	{
+		m_ThreadCount = 1;
+	}
+	if (m_ThreadCount > m_Height)
+	{
+		m_ThreadCount = m_Height;
+	}
+
+	m_RowsPerThread = (m_Height + m_ThreadCount - 1) / m_ThreadCount;
+
+	StartWorkers();
+
+	LOG("CPUProjectedGrid - %u x %u vertices, %u thread(s)!", m_Width, m_Height, m_ThreadCount);
+
+	LOG("CPUProjectedGrid successfully created!");
+}
+
+bool CPUProjectedGrid::ComputeGridCorners ( const glm::mat4& i_ProjectingMatrix, const glm::vec4& i_Plane, glm::mat4& o_GridCorners )
+{
+	const glm::vec2 k_CornersUV[4] = { glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(0.0f, 1.0f), glm::vec2(1.0f, 1.0f) };
+
+	bool isValid = true;
+	for (unsigned short i = 0; i < 4; ++i)
+	{
+		// the ray through the grid corner, from the near to the far plane, in world space homogenous coordinates
+		glm::vec4 point1 = i_ProjectingMatrix * glm::vec4(k_CornersUV[i], -1.0f, 1.0f);
+		glm::vec4 point2 = i_ProjectingMatrix * glm::vec4(k_CornersUV[i], 1.0f, 1.0f);
+
+		isValid = HelperFunctions::PlaneIntersectSegment(i_Plane, point1, point2, o_GridCorners[i]) && isValid;
+	}
+
+	return isValid;
+}
+
+void CPUProjectedGrid::Generate ( const glm::mat4& i_GridCorners, const glm::vec4* i_pDisplacementData, unsigned short i_FFTSize, float i_UVScale, MeshBufferManager::VertexData* o_pVertexData )
+{
+	assert(o_pVertexData != nullptr);
+
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	GenerationData data;
+	data.GridCorners = i_GridCorners;
+	data.pDisplacementData = (i_FFTSize > 0 ? i_pDisplacementData : nullptr);
+	data.FFTSize = i_FFTSize;
+	data.UVScale = i_UVScale;
+	data.pVertexData = o_pVertexData;
+
+	// wake up the workers, the calling thread computes the first rows
+	if (!m_Workers.empty())
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		m_pGenerationData = &data;
+		m_PendingWorkerCount = static_cast<unsigned short>(m_Workers.size());
+		++ m_GenerationIndex;
+	}
+	m_WorkCondition.notify_all();
+
+	GenerateRows(data, 0, glm::min(static_cast<int>(m_RowsPerThread), static_cast<int>(m_Height)));
+
+	// data lives on this stack frame, so wait for all the workers
+	if (!m_Workers.empty())
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		while (m_PendingWorkerCount > 0)
+		{
+			m_DoneCondition.wait(lock);
+		}
+
+		m_pGenerationData = nullptr;
+	}
+
+	m_LastGenerationTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void CPUProjectedGrid::StartWorkers ( void )
+{
+	m_IsStopping = false;
+
+	// no thread is created when m_ThreadCount is 1
+	m_Workers.reserve(m_ThreadCount - 1);
+	for (unsigned short i = 1; i < m_ThreadCount; ++i)
+	{
+		m_Workers.push_back(std::thread(&CPUProjectedGrid::WorkerLoop, this, i, m_GenerationIndex));
+	}
+}
+
+void CPUProjectedGrid::StopWorkers ( void )
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsStopping = true;
+	}
+	m_WorkCondition.notify_all();
+
+	for (size_t i = 0; i < m_Workers.size(); ++i)
+	{
+		m_Workers[i].join();
+	}
+	m_Workers.clear();
+}
+
+void CPUProjectedGrid::WorkerLoop ( unsigned short i_Thread, unsigned int i_GenerationIndex )
+{
+	unsigned short firstRow = i_Thread * m_RowsPerThread;
+	unsigned short lastRow = glm::min(firstRow + m_RowsPerThread, static_cast<int>(m_Height));
+
+	// the index is passed by the creating thread, so no Generate() call is missed
+	unsigned int generationIndex = i_GenerationIndex;
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while (true)
+	{
+		while (!m_IsStopping && m_GenerationIndex == generationIndex)
+		{
+			m_WorkCondition.wait(lock);
+		}
+
+		if (m_IsStopping)
+		{
+			break;
+		}
+
+		generationIndex = m_GenerationIndex;
+		const GenerationData* pData = m_pGenerationData;
+
+		lock.unlock();
+
+		// the last threads might get no rows
+		if (firstRow < m_Height)
+		{
+			GenerateRows(*pData, firstRow, lastRow);
+		}
+
+		lock.lock();
+
+		if (-- m_PendingWorkerCount == 0)
+		{
+			m_DoneCondition.notify_one();
+		}
+	}
+}
+
+void CPUProjectedGrid::GenerateRows ( const GenerationData& i_Data, unsigned short i_FirstRow, unsigned short i_LastRow ) const
+{
+	const glm::mat4& corners = i_Data.GridCorners;
+
+	float du = 1.0f / static_cast<float>(m_Width - 1),
+		  dv = 1.0f / static_cast<float>(m_Height - 1);
+
+	for (unsigned short i = i_FirstRow; i < i_LastRow; ++i)
+	{
+		float v = i * dv;
+
+		// same interpolation as the world space grid shader: mix(mix(c0, c1, u), mix(c2, c3, u), v)
+		glm::vec4 left = glm::mix(corners[0], corners[2], v);
+		glm::vec4 delta = glm::mix(corners[1], corners[3], v) - left;
+
+		MeshBufferManager::VertexData* pRow = i_Data.pVertexData + static_cast<unsigned int>(i) * m_Width;
+
+		unsigned short j = 0;
+
+#ifdef USE_SSE
+		const __m128 kOffsets = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+		const __m128 kDU = _mm_set1_ps(du);
+		const __m128 kMinW = _mm_set1_ps(1e-6f);
+
+		float x[4], y[4], z[4];
+
+		for (; j + 4 <= m_Width; j += 4)
+		{
+			__m128 u = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(j)), kOffsets), kDU);
+
+			__m128 w = _mm_max_ps(_mm_add_ps(_mm_set1_ps(left.w), _mm_mul_ps(u, _mm_set1_ps(delta.w))), kMinW);
+
+			// only x and z get the perspective division, y is already on the plane
+			_mm_storeu_ps(x, _mm_div_ps(_mm_add_ps(_mm_set1_ps(left.x), _mm_mul_ps(u, _mm_set1_ps(delta.x))), w));
+			_mm_storeu_ps(y, _mm_add_ps(_mm_set1_ps(left.y), _mm_mul_ps(u, _mm_set1_ps(delta.y))));
+			_mm_storeu_ps(z, _mm_div_ps(_mm_add_ps(_mm_set1_ps(left.z), _mm_mul_ps(u, _mm_set1_ps(delta.z))), w));
+
+			for (unsigned short k = 0; k < 4; ++k)
+			{
+				WriteVertex(i_Data, glm::vec3(x[k], y[k], z[k]), glm::vec2((j + k) * du, v), pRow[j + k]);
+			}
+		}
+#endif // USE_SSE
+
+		for (; j < m_Width; ++j)
+		{
+			float u = j * du;
+
+			glm::vec4 result = left + delta * u;
+			result.w = glm::max(result.w, 1e-6f);
+
+			WriteVertex(i_Data, glm::vec3(result.x / result.w, result.y, result.z / result.w), glm::vec2(u, v), pRow[j]);
+		}
+	}
+}
+
+void CPUProjectedGrid::WriteVertex ( const GenerationData& i_Data, const glm::vec3& i_Position, const glm::vec2& i_UV, MeshBufferManager::VertexData& o_Vertex ) const
+{
+	o_Vertex.position = i_Position;
+	o_Vertex.normal = (i_Data.pDisplacementData ? SampleDisplacement(i_Data, i_Position.x, i_Position.z) : glm::vec3(0.0f));
+	o_Vertex.uv = i_UV;
+}
+
+glm::vec3 CPUProjectedGrid::SampleDisplacement ( const GenerationData& i_Data, float i_X, float i_Z ) const
+{
+	float size = static_cast<float>(i_Data.FFTSize);
+
+	// texel space, the texel centers are at 0.5
+	float s = i_X * i_Data.UVScale * size - 0.5f,
+		  t = i_Z * i_Data.UVScale * size - 0.5f;
+
+	// wrap around like GL_REPEAT
+	s -= size * glm::floor(s / size);
+	t -= size * glm::floor(t / size);
+
+	float s0 = glm::floor(s), t0 = glm::floor(t);
+	float fs = s - s0, ft = t - t0;
+
+	// the FFT size is a power of 2
+	int mask = i_Data.FFTSize - 1;
+	int x0 = static_cast<int>(s0) & mask, x1 = (x0 + 1) & mask,
+		z0 = static_cast<int>(t0) & mask, z1 = (z0 + 1) & mask;
+
+	const glm::vec4* pData = i_Data.pDisplacementData;
+
+	glm::vec3 bottom = glm::mix(glm::vec3(pData[z0 * i_Data.FFTSize + x0]), glm::vec3(pData[z0 * i_Data.FFTSize + x1]), fs);
+	glm::vec3 top = glm::mix(glm::vec3(pData[z1 * i_Data.FFTSize + x0]), glm::vec3(pData[z1 * i_Data.FFTSize + x1]), fs);
+
+	return glm::mix(bottom, top, ft);
+}
+
+unsigned short CPUProjectedGrid::GetWidth ( void ) const
+{
+	return m_Width;
+}
+
+unsigned short CPUProjectedGrid::GetHeight ( void ) const
+{
+	return m_Height;
+}
+
+unsigned int CPUProjectedGrid::GetVertexCount ( void ) const
+{
+	return static_cast<unsigned int>(m_Width) * m_Height;
+}
+
+unsigned short CPUProjectedGrid::GetThreadCount ( void ) const
+{
+	return m_ThreadCount;
+}
+
+float CPUProjectedGrid::GetLastGenerationTime ( void ) const
+{
+	return m_LastGenerationTime;
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+/* Author: BAIRAC MIHAI
+
+ Implemntation based on Claes Johanson work
+ paper: http://fileadmin.cs.lth.se/graphics/theses/projects/projgrid/
+ License: check the demo package
+
+*/
+
+#ifndef CPU_PROJECTED_GRID_H
+#define CPU_PROJECTED_GRID_H
+
+#include "MeshBufferManager.h"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "glm/mat4x4.hpp"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class GlobalConfig;
+
+/*
+ CPU projected grid vertex generator - an alternative to the screen space grid, which needs geometry shaders
+
+ The grid corners are obtained by intersecting the projector rays (check Projector::GetProjectingMatrix) with the ocean plane.
+ Then every grid vertex is interpolated in homogenous coordinates between the corners, like the world space grid does on the GPU.
+ The FFT displacement is sampled from the CPU snapshot (if the FFT is computed on the CPU),
+ so the ocean surface is drawn with a plain vertex shader.
+
+ The grid rows are split across threads and the vertices of a row are projected 4 at a time with SSE
+ The worker threads are created once by Initialize() and wait for the next Generate() call, the calling thread computes the first rows
+ The generation doesn't need a GL context, check tools/ProjectedGridBenchmark
+*/
+
+class CPUProjectedGrid
+{
+public:
+	CPUProjectedGrid(void);
+	CPUProjectedGrid(const GlobalConfig& i_Config);
+	CPUProjectedGrid(unsigned short i_Width, unsigned short i_Height, unsigned short i_ThreadCount);
+	~CPUProjectedGrid(void);
+
+	void Initialize(const GlobalConfig& i_Config);
+	void Initialize(unsigned short i_Width, unsigned short i_Height, unsigned short i_ThreadCount);
+
+	// world space homogenous corners: near left, near right, far left, far right (same as Projector::ComputeGridCorners)
+	static bool ComputeGridCorners(const glm::mat4& i_ProjectingMatrix, const glm::vec4& i_Plane, glm::mat4& o_GridCorners);
+
+	// o_pVertexData - Width * Height vertices, row after row (same layout as the world space grid)
+	// position - world space position on the ocean plane, normal - FFT displacement, uv - grid uv
+	// i_pDisplacementData - optional, FFTSize * FFTSize displacement (xyz) values, sampled like a GL_REPEAT + GL_LINEAR texture
+	// i_UVScale - from world space to FFT texture uv, TileScale / PatchSize
+	void Generate(const glm::mat4& i_GridCorners, const glm::vec4* i_pDisplacementData, unsigned short i_FFTSize, float i_UVScale, MeshBufferManager::VertexData* o_pVertexData);
+
+	unsigned short GetWidth(void) const;
+	unsigned short GetHeight(void) const;
+	unsigned int GetVertexCount(void) const;
+	unsigned short GetThreadCount(void) const;
+
+	// milliseconds, measured by the last Generate() call
+	float GetLastGenerationTime(void) const;
+
+private:
+	struct GenerationData
+	{
+		glm::mat4 GridCorners;
+		const glm::vec4* pDisplacementData;
+		unsigned short FFTSize;
+		float UVScale;
+		MeshBufferManager::VertexData* pVertexData;
+	};
+
+	//// Methods ////
+	void Destroy(void);
+
+	void StartWorkers(void);
+	void StopWorkers(void);
+	// worker thread, i_Thread - 1 .. m_ThreadCount - 1, i_GenerationIndex - the last Generate() call it doesn't compute
+	void WorkerLoop(unsigned short i_Thread, unsigned int i_GenerationIndex);
+
+	void GenerateRows(const GenerationData& i_Data, unsigned short i_FirstRow, unsigned short i_LastRow) const;
+	void WriteVertex(const GenerationData& i_Data, const glm::vec3& i_Position, const glm::vec2& i_UV, MeshBufferManager::VertexData& o_Vertex) const;
+	glm::vec3 SampleDisplacement(const GenerationData& i_Data, float i_X, float i_Z) const;
+
+	//// Variables ////
+	unsigned short m_Width, m_Height;
+	unsigned short m_ThreadCount;
+	unsigned short m_RowsPerThread;
+
+	float m_LastGenerationTime;
+
+	// the worker pool, the data of the current Generate() call is shared under m_Mutex
+	std::vector<std::thread> m_Workers;
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkCondition, m_DoneCondition;
+	const GenerationData* m_pGenerationData;
+	unsigned int m_GenerationIndex;
+	unsigned short m_PendingWorkerCount;
+	bool m_IsStopping;
+};
+
+#endif /* CPU_PROJECTED_GRID_H */
\ No newline at end of file
@@ -0,0 +1,428 @@
+/* Author: BAIRAC MIHAI */
+
+#include "CausticsBaker.h"
+#include "CommonHeaders.h"
+// glm::vec2, glm::vec3 come from the header
+#include "glm/common.hpp" //min(), max(), floor()
+#include "glm/exponential.hpp" //sqrt()
+#include "glm/geometric.hpp" //normalize(), refract()
+#include <thread> // std::thread
+#include <chrono> // std::chrono::steady_clock
+#include <cstring> // std::memset()
+#ifdef USE_SSE
+#include <xmmintrin.h> // _mm_add_ps(), _mm_sub_ps(), _mm_mul_ps(), _mm_div_ps(), _mm_sqrt_ps()
+#endif // USE_SSE
+
+
+namespace
+{
+	const float kWaterRefractionRatio = 1.0f / 1.33f;
+
+	// a grazing sun would throw the rays out of the patch, the caustics fade away with the sun anyway (check OceanBottom.frag.glsl)
+	const float kMinSunHeight = 0.1f;
+
+	glm::vec3 ClampSunDirection ( const glm::vec3& i_SunDirection )
+	{
+		glm::vec3 sunDirection = glm::normalize(i_SunDirection);
+		sunDirection.y = glm::max(sunDirection.y, kMinSunHeight);
+
+		return glm::normalize(sunDirection);
+	}
+
+	// o_pValue[i] = bilinear(i), for 4 rays
+	inline void Bilinear4 ( float* o_pValue, const float* i_pV00, const float* i_pV10, const float* i_pV01, const float* i_pV11, const float* i_pFX, const float* i_pFY )
+	{
+#ifdef USE_SSE
+		__m128 fx = _mm_loadu_ps(i_pFX);
+
+		__m128 v00 = _mm_loadu_ps(i_pV00);
+		__m128 bottom = _mm_add_ps(v00, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(i_pV10), v00), fx));
+		__m128 v01 = _mm_loadu_ps(i_pV01);
+		__m128 top = _mm_add_ps(v01, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(i_pV11), v01), fx));
+
+		_mm_storeu_ps(o_pValue, _mm_add_ps(bottom, _mm_mul_ps(_mm_sub_ps(top, bottom), _mm_loadu_ps(i_pFY))));
+#else
+		for (unsigned short i = 0; i < 4; ++i)
+		{
+			float bottom = i_pV00[i] + (i_pV10[i] - i_pV00[i]) * i_pFX[i];
+			float top = i_pV01[i] + (i_pV11[i] - i_pV01[i]) * i_pFX[i];
+
+			o_pValue[i] = bottom + (top - bottom) * i_pFY[i];
+		}
+#endif // USE_SSE
+	}
+
+	// refracts 4 rays of sun light by the surface normals normalize(slopeX, 1, slopeY) (same as OceanCausticsWorldGrid.vert.glsl)
+	// and intersects them with the plane i_Depth below the displaced surface points, io_pX, io_pZ - the points, then the landing positions
+	inline void RefractAndLand4 ( float* io_pX, float* io_pZ, const float* i_pSlopeX, const float* i_pSlopeY, const glm::vec3& i_SunDirection, float i_Depth )
+	{
+#ifdef USE_SSE
+		__m128 nx = _mm_loadu_ps(i_pSlopeX);
+		__m128 nz = _mm_loadu_ps(i_pSlopeY);
+
+		__m128 one = _mm_set1_ps(1.0f);
+		__m128 eta = _mm_set1_ps(kWaterRefractionRatio);
+
+		__m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(one, _mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(nz, nz)))));
+		nx = _mm_mul_ps(nx, invLength);
+		__m128 ny = invLength;
+		nz = _mm_mul_ps(nz, invLength);
+
+		// the incident direction is - i_SunDirection
+		__m128 cosI = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_set1_ps(i_SunDirection.x)), _mm_mul_ps(ny, _mm_set1_ps(i_SunDirection.y))), _mm_mul_ps(nz, _mm_set1_ps(i_SunDirection.z)));
+
+		// light goes into a denser medium, k > 0
+		__m128 k = _mm_sub_ps(one, _mm_mul_ps(_mm_mul_ps(eta, eta), _mm_sub_ps(one, _mm_mul_ps(cosI, cosI))));
+		__m128 normalFactor = _mm_sub_ps(_mm_mul_ps(eta, cosI), _mm_sqrt_ps(k));
+
+		__m128 rx = _mm_sub_ps(_mm_mul_ps(normalFactor, nx), _mm_mul_ps(eta, _mm_set1_ps(i_SunDirection.x)));
+		__m128 ry = _mm_sub_ps(_mm_mul_ps(normalFactor, ny), _mm_mul_ps(eta, _mm_set1_ps(i_SunDirection.y)));
+		__m128 rz = _mm_sub_ps(_mm_mul_ps(normalFactor, nz), _mm_mul_ps(eta, _mm_set1_ps(i_SunDirection.z)));
+
+		// ry < 0
+		__m128 t = _mm_div_ps(_mm_set1_ps(- i_Depth), ry);
+
+		_mm_storeu_ps(io_pX, _mm_add_ps(_mm_loadu_ps(io_pX), _mm_mul_ps(rx, t)));
+		_mm_storeu_ps(io_pZ, _mm_add_ps(_mm_loadu_ps(io_pZ), _mm_mul_ps(rz, t)));
+#else
+		for (unsigned short i = 0; i < 4; ++i)
+		{
+			glm::vec3 normal = glm::normalize(glm::vec3(i_pSlopeX[i], 1.0f, i_pSlopeY[i]));
+			glm::vec3 refraction = glm::refract(- i_SunDirection, normal, kWaterRefractionRatio);
+
+			float t = - i_Depth / refraction.y;
+
+			io_pX[i] += refraction.x * t;
+			io_pZ[i] += refraction.z * t;
+		}
+#endif // USE_SSE
+	}
+}
+
+// a flat surface gives a factor of 1, the focused light rarely goes over this
+const float CausticsBaker::m_kMaxFactor = 8.0f;
+
+CausticsBaker::CausticsBaker ( void )
+	: m_Name("Default"), m_Size(0), m_FrameCount(0), m_RayDensity(1), m_ThreadCount(1),
+	  m_PatchSize(1.0f), m_ChoppyScale(0.0f), m_SunDirection(0.0f, 1.0f, 0.0f), m_Depth(1.0f),
+	  m_IsFrameDone(true), m_StartedFrameIndex(0), m_StartedFFTSize(0)
+{
+}
+
+CausticsBaker::~CausticsBaker ( void )
+{
+	Destroy();
+}
+
+void CausticsBaker::Destroy ( void )
+{
+	// the worker uses the buffers
+	WaitForFrame();
+
+	LOG("CausticsBaker [%s] successfully destroyed!", m_Name.c_str());
+}
+
+bool CausticsBaker::Initialize ( const std::string& i_Name, unsigned short i_Size, unsigned short i_FrameCount, unsigned short i_RayDensity, unsigned short i_ThreadCount )
+{
+	m_Name = i_Name;
+
+	if (i_Size < 4 || (i_Size & (i_Size - 1)) != 0)
+	{
+		ERR("The caustics atlas size must be a power of 2, at least 4!");
+		return false;
+	}
+
+	if (i_FrameCount == 0)
+	{
+		ERR("The caustics atlas needs at least one frame!");
+		return false;
+	}
+
+	m_Size = i_Size;
+	m_FrameCount = i_FrameCount;
+	m_RayDensity = glm::max(i_RayDensity, static_cast<unsigned short>(1));
+
+	// 0 - one thread per hardware thread
+	m_ThreadCount = (i_ThreadCount > 0 ? i_ThreadCount : static_cast<unsigned short>(std::thread::hardware_concurrency()));
+	if (m_ThreadCount == 0)
+	{
+		m_ThreadCount = 1;
+	}
+
+	// the buffers are allocated by the first BakeFrame() call
+	ReleaseData();
+
+	LOG("CausticsBaker [%s] successfully created!", m_Name.c_str());
+
+	return true;
+}
+
+void CausticsBaker::SetSurfaceData ( float i_PatchSize, float i_ChoppyScale, const glm::vec3& i_SunDirection, float i_Depth )
+{
+	m_PatchSize = i_PatchSize;
+	m_ChoppyScale = i_ChoppyScale;
+	m_SunDirection = ClampSunDirection(i_SunDirection);
+	m_Depth = i_Depth;
+}
+
+void CausticsBaker::BakeFrame ( unsigned short i_FrameIndex, const float* i_pFFTWaveData, unsigned short i_FFTSize )
+{
+	if (m_Size == 0)
+	{
+		ERR("The caustics baker is not initialized!");
+		return;
+	}
+
+	if (i_FrameIndex >= m_FrameCount || i_pFFTWaveData == nullptr || i_FFTSize < 4 || (i_FFTSize & (i_FFTSize - 1)) != 0)
+	{
+		ERR("Invalid caustics frame %u!", i_FrameIndex);
+		return;
+	}
+
+	// released by the previous bake, check ReleaseData()
+	if (m_Data.empty())
+	{
+		m_Accumulations.assign(m_ThreadCount, std::vector<float>(m_Size * m_Size, 0.0f));
+		m_Data.assign(m_FrameCount * m_Size * m_Size, 0);
+	}
+
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	unsigned int rayCount = i_FFTSize * m_RayDensity;
+
+	// the calling thread computes the first rows, so no thread is created when m_ThreadCount is 1
+	unsigned int threadCount = glm::min(static_cast<unsigned int>(m_ThreadCount), rayCount);
+	unsigned int rowsPerThread = (rayCount + threadCount - 1) / threadCount;
+
+	std::vector<std::thread> workers;
+	workers.reserve(threadCount - 1);
+
+	for (unsigned int i = 1; i < threadCount; ++i)
+	{
+		unsigned int firstRow = i * rowsPerThread;
+		if (firstRow >= rayCount)
+		{
+			// nothing splatted by this thread
+			std::memset(m_Accumulations[i].data(), 0, m_Accumulations[i].size() * sizeof(float));
+			continue;
+		}
+
+		unsigned int lastRow = glm::min(firstRow + rowsPerThread, rayCount);
+
+		workers.push_back(std::thread(&CausticsBaker::ComputeRows, this, static_cast<unsigned short>(i), firstRow, lastRow, i_pFFTWaveData, i_FFTSize));
+	}
+
+	ComputeRows(0, 0, glm::min(rowsPerThread, rayCount), i_pFFTWaveData, i_FFTSize);
+
+	for (size_t i = 0; i < workers.size(); ++i)
+	{
+		workers[i].join();
+	}
+
+	// a ray lands (Size / rayCount)^2 texels' worth of light
+	float rayFactor = static_cast<float>(m_Size) / rayCount;
+	float toByte = 255.0f * rayFactor * rayFactor / m_kMaxFactor;
+
+	unsigned char* pFrame = &m_Data[i_FrameIndex * m_Size * m_Size];
+
+	for (size_t i = 0; i < m_Accumulations[0].size(); ++i)
+	{
+		float sum = 0.0f;
+		for (unsigned int j = 0; j < threadCount; ++j)
+		{
+			sum += m_Accumulations[j][i];
+		}
+
+		pFrame[i] = static_cast<unsigned char>(glm::min(sum * toByte + 0.5f, 255.0f));
+	}
+
+	float bakeTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count() * 1000.0f;
+
+	LOG("CausticsBaker [%s] baked frame %u from %u x %u rays in %.2f ms!", m_Name.c_str(), i_FrameIndex, rayCount, rayCount, bakeTime);
+}
+
+void CausticsBaker::StartFrame ( unsigned short i_FrameIndex, const float* i_pFFTWaveData, unsigned short i_FFTSize )
+{
+	WaitForFrame();
+
+	if (i_pFFTWaveData == nullptr)
+	{
+		ERR("Invalid caustics frame %u!", i_FrameIndex);
+		return;
+	}
+
+	// the displacement and the slopes layers
+	size_t fftDataSize = static_cast<size_t>(i_FFTSize) * i_FFTSize * 4 * 2;
+	m_StartedFFTWaveData.assign(i_pFFTWaveData, i_pFFTWaveData + fftDataSize);
+
+	m_StartedFrameIndex = i_FrameIndex;
+	m_StartedFFTSize = i_FFTSize;
+
+	m_IsFrameDone = false;
+	m_Thread = std::thread(&CausticsBaker::BakeStartedFrame, this);
+}
+
+void CausticsBaker::BakeStartedFrame ( void )
+{
+	BakeFrame(m_StartedFrameIndex, &m_StartedFFTWaveData[0], m_StartedFFTSize);
+
+	m_IsFrameDone = true;
+}
+
+bool CausticsBaker::IsFrameDone ( void )
+{
+	if (!m_IsFrameDone)
+	{
+		return false;
+	}
+
+	if (m_Thread.joinable())
+	{
+		m_Thread.join();
+	}
+
+	return true;
+}
+
+void CausticsBaker::WaitForFrame ( void )
+{
+	if (m_Thread.joinable())
+	{
+		m_Thread.join();
+	}
+}
+
+void CausticsBaker::ComputeRows ( unsigned short i_Thread, unsigned int i_FirstRow, unsigned int i_LastRow, const float* i_pFFTWaveData, unsigned short i_FFTSize )
+{
+	std::vector<float>& accumulation = m_Accumulations[i_Thread];
+	std::memset(accumulation.data(), 0, accumulation.size() * sizeof(float));
+
+	// rgba texels, layer 0 - the displacement, layer 1 - the slopes
+	const float* pDisplacement = i_pFFTWaveData;
+	const float* pSlopes = i_pFFTWaveData + i_FFTSize * i_FFTSize * 4;
+
+	int fftMask = i_FFTSize - 1;
+	int sizeMask = m_Size - 1;
+
+	unsigned int rayCount = i_FFTSize * m_RayDensity;
+	float raySpacing = m_PatchSize / rayCount;
+	float toAtlas = static_cast<float>(m_Size) / m_PatchSize;
+
+	float dispX[4][4], dispZ[4][4], slopeX[4][4], slopeY[4][4], fx[4], fy[4];
+	float x[4], z[4], value[4];
+
+	for (unsigned int row = i_FirstRow; row < i_LastRow; ++row)
+	{
+		// the GL sampler convention: texel i covers [i, i + 1), the filtering is done between the texel centers
+		// the rays start at the centers of the ray grid cells, so fftV >= -0.5 and the truncation is the floor
+		float fftV = (row + 0.5f) / m_RayDensity - 0.5f;
+		int y0 = static_cast<int>(fftV + 1.0f) - 1;
+		float rowFY = fftV - y0;
+		int y1 = (y0 + 1) & fftMask;
+		y0 &= fftMask;
+
+		for (unsigned int column = 0; column < rayCount; column += 4)
+		{
+			for (unsigned short j = 0; j < 4; ++j)
+			{
+				// 4 rays per step, the last ones of the row are wrapped around the patch (rayCount may not be a multiple of 4)
+				unsigned int rayColumn = (column + j) % rayCount;
+
+				float fftU = (rayColumn + 0.5f) / m_RayDensity - 0.5f;
+				int x0 = static_cast<int>(fftU + 1.0f) - 1;
+				fx[j] = fftU - x0;
+				fy[j] = rowFY;
+
+				int x1 = (x0 + 1) & fftMask;
+				x0 &= fftMask;
+
+				const int texels[4] = { y0 * i_FFTSize + x0, y0 * i_FFTSize + x1, y1 * i_FFTSize + x0, y1 * i_FFTSize + x1 };
+
+				for (unsigned short k = 0; k < 4; ++k)
+				{
+					const float* pDisplacementTexel = pDisplacement + texels[k] * 4;
+					const float* pSlopesTexel = pSlopes + texels[k] * 4;
+
+					dispX[k][j] = pDisplacementTexel[0];
+					dispZ[k][j] = pDisplacementTexel[2];
+					slopeX[k][j] = pSlopesTexel[0];
+					slopeY[k][j] = pSlopesTexel[1];
+				}
+
+				x[j] = (rayColumn + 0.5f) * raySpacing;
+				z[j] = (row + 0.5f) * raySpacing;
+			}
+
+			// the displaced surface points
+			Bilinear4(value, dispX[0], dispX[1], dispX[2], dispX[3], fx, fy);
+			for (unsigned short j = 0; j < 4; ++j)
+			{
+				x[j] += m_ChoppyScale * value[j];
+			}
+
+			Bilinear4(value, dispZ[0], dispZ[1], dispZ[2], dispZ[3], fx, fy);
+			for (unsigned short j = 0; j < 4; ++j)
+			{
+				z[j] += m_ChoppyScale * value[j];
+			}
+
+			float slopeXValue[4], slopeYValue[4];
+			Bilinear4(slopeXValue, slopeX[0], slopeX[1], slopeX[2], slopeX[3], fx, fy);
+			Bilinear4(slopeYValue, slopeY[0], slopeY[1], slopeY[2], slopeY[3], fx, fy);
+
+			RefractAndLand4(x, z, slopeXValue, slopeYValue, m_SunDirection, m_Depth);
+
+			// bilinear splat, wrapped around the atlas
+			unsigned short rayInStepCount = static_cast<unsigned short>(glm::min(rayCount - column, 4u));
+			for (unsigned short j = 0; j < rayInStepCount; ++j)
+			{
+				float atlasU = x[j] * toAtlas - 0.5f;
+				float atlasV = z[j] * toAtlas - 0.5f;
+
+				float floorU = glm::floor(atlasU);
+				float floorV = glm::floor(atlasV);
+				float splatFX = atlasU - floorU;
+				float splatFY = atlasV - floorV;
+
+				int u0 = static_cast<int>(floorU) & sizeMask;
+				int v0 = static_cast<int>(floorV) & sizeMask;
+				int u1 = (u0 + 1) & sizeMask;
+				int v1 = (v0 + 1) & sizeMask;
+
+				accumulation[v0 * m_Size + u0] += (1.0f - splatFX) * (1.0f - splatFY);
+				accumulation[v0 * m_Size + u1] += splatFX * (1.0f - splatFY);
+				accumulation[v1 * m_Size + u0] += (1.0f - splatFX) * splatFY;
+				accumulation[v1 * m_Size + u1] += splatFX * splatFY;
+			}
+		}
+	}
+}
+
+const unsigned char* CausticsBaker::GetData ( void ) const
+{
+	return m_Data.data();
+}
+
+unsigned short CausticsBaker::GetSize ( void ) const
+{
+	return m_Size;
+}
+
+unsigned short CausticsBaker::GetFrameCount ( void ) const
+{
+	return m_FrameCount;
+}
+
+void CausticsBaker::ReleaseData ( void )
+{
+	std::vector<unsigned char>().swap(m_Data);
+	std::vector<std::vector<float>>().swap(m_Accumulations);
+	std::vector<float>().swap(m_StartedFFTWaveData);
+}
+
+glm::vec2 CausticsBaker::ComputeLandingOffset ( const glm::vec3& i_SunDirection, float i_Depth )
+{
+	glm::vec3 refraction = glm::refract(- ClampSunDirection(i_SunDirection), glm::vec3(0.0f, 1.0f, 0.0f), kWaterRefractionRatio);
+
+	return glm::vec2(refraction.x, refraction.z) * (- i_Depth / refraction.y);
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef CAUSTICS_BAKER_H
+#define CAUSTICS_BAKER_H
+
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+/*
+ CPU baker of a looping caustics atlas
+
+ The ocean animation repeats itself after DispersionFrequencyTimePeriod seconds (check FFTOceanPatchBakedCache.h),
+ so the caustics repeat too. For every frame of one period, rays of sun light are refracted by the displaced ocean patch surface
+ and splatted (bilinear weights) where they hit the bottom plane. The landing positions wrap around the patch, so every frame tiles.
+
+ A texel keeps the caustics factor: the light landing on it compared to a flat surface (1 on average), divided by m_kMaxFactor.
+ The rows of rays are split across threads, each thread splats into its own accumulation buffer,
+ the surface interpolation and the refraction of 4 rays are done at once with SSE.
+
+ The atlas is baked for one sun direction, a different sun only shifts the lookup (check ComputeLandingOffset()).
+
+ A bake takes seconds, so the frames can be baked on a worker thread (check StartFrame()): the FFT data is read back
+ on the main thread (the only one with the GL context), one frame at a time, while the worker splats the previous one.
+*/
+
+class CausticsBaker
+{
+public:
+	CausticsBaker(void);
+	~CausticsBaker(void);
+
+	// i_Size - power of 2, i_RayDensity - rays per FFT texel, per axis
+	// i_ThreadCount - 0 means one thread per hardware thread
+	bool Initialize(const std::string& i_Name, unsigned short i_Size, unsigned short i_FrameCount, unsigned short i_RayDensity, unsigned short i_ThreadCount);
+
+	// i_Depth - from the mean water level down to the bottom plane
+	void SetSurfaceData(float i_PatchSize, float i_ChoppyScale, const glm::vec3& i_SunDirection, float i_Depth);
+
+	// i_pFFTWaveData - the FFT wave data texture layers, rgba: layer 0 - the displacement, layer 1 - the slopes
+	void BakeFrame(unsigned short i_FrameIndex, const float* i_pFFTWaveData, unsigned short i_FFTSize);
+
+	// BakeFrame() on a worker thread, the 2 layers of i_pFFTWaveData are copied, so the caller can reuse the buffer
+	// NOTE! The previous frame must be done (check IsFrameDone())
+	void StartFrame(unsigned short i_FrameIndex, const float* i_pFFTWaveData, unsigned short i_FFTSize);
+	// true if no frame is being baked, the worker thread is joined once it's done
+	bool IsFrameDone(void);
+	// blocks until the frame being baked is done
+	void WaitForFrame(void);
+
+	// m_FrameCount layers of Size x Size bytes
+	// NOTE! The data and the surface data mustn't be used while a frame is baked on the worker thread
+	const unsigned char* GetData(void) const;
+	unsigned short GetSize(void) const;
+	unsigned short GetFrameCount(void) const;
+
+	// frees the atlas, once it's uploaded, the next BakeFrame() call allocates it again
+	void ReleaseData(void);
+
+	// where a ray refracted by the flat surface at the origin lands on the bottom plane
+	static glm::vec2 ComputeLandingOffset(const glm::vec3& i_SunDirection, float i_Depth);
+
+	static const float m_kMaxFactor;
+
+private:
+	//// Methods ////
+	void Destroy(void);
+
+	void ComputeRows(unsigned short i_Thread, unsigned int i_FirstRow, unsigned int i_LastRow, const float* i_pFFTWaveData, unsigned short i_FFTSize);
+
+	// worker thread
+	void BakeStartedFrame(void);
+
+	//// Variables ////
+	std::string m_Name;
+
+	unsigned short m_Size;
+	unsigned short m_FrameCount;
+	unsigned short m_RayDensity;
+	unsigned short m_ThreadCount;
+
+	float m_PatchSize;
+	float m_ChoppyScale;
+	glm::vec3 m_SunDirection;
+	float m_Depth;
+
+	// one accumulation buffer per thread
+	std::vector<std::vector<float>> m_Accumulations;
+
+	std::vector<unsigned char> m_Data;
+
+	// the frame baked by the worker thread
+	std::thread m_Thread;
+	std::atomic<bool> m_IsFrameDone;
+	unsigned short m_StartedFrameIndex;
+	unsigned short m_StartedFFTSize;
+	std::vector<float> m_StartedFFTWaveData;
+};
+
+#endif /* CAUSTICS_BAKER_H */
\ No newline at end of file
@@ -0,0 +1,425 @@
+/* Author: BAIRAC MIHAI */
+
+#include "CloudsNoiseGenerator.h"
+#include "CommonHeaders.h"
+// glm::vec2, glm::mat2 come from the header
+#include "glm/common.hpp" //min(), round(), abs()
+#include "glm/exponential.hpp" //pow(), sqrt()
+#include "glm/trigonometric.hpp" //sin(), cos()
+#include "FileUtils.h"
+#include "MemoryMappedFile.h"
+#include <thread> // std::thread
+#include <chrono> // std::chrono::steady_clock
+#include <cstring> // std::memset()
+#include <cctype> // std::isspace(), std::isdigit()
+#ifdef USE_SSE
+#include <xmmintrin.h> // _mm_add_ps(), _mm_sub_ps(), _mm_mul_ps()
+#endif // USE_SSE
+
+
+namespace
+{
+	// skips the white spaces and the comments of a pgm header, then reads a number
+	bool ReadPGMNumber ( const unsigned char* i_pData, size_t i_Size, size_t& io_Offset, unsigned int& o_Number )
+	{
+		while (io_Offset < i_Size && (std::isspace(i_pData[io_Offset]) || i_pData[io_Offset] == '#'))
+		{
+			if (i_pData[io_Offset] == '#')
+			{
+				while (io_Offset < i_Size && i_pData[io_Offset] != '\n')
+				{
+					++ io_Offset;
+				}
+			}
+			else
+			{
+				++ io_Offset;
+			}
+		}
+
+		if (io_Offset >= i_Size || !std::isdigit(i_pData[io_Offset]))
+		{
+			return false;
+		}
+
+		o_Number = 0;
+		while (io_Offset < i_Size && std::isdigit(i_pData[io_Offset]))
+		{
+			o_Number = o_Number * 10 + (i_pData[io_Offset] - '0');
+			++ io_Offset;
+		}
+
+		return true;
+	}
+
+	// io_pSum[i] += i_Weight * bilinear(i), for 4 texels
+	inline void AddBilinear4 ( float* io_pSum, const float* i_pV00, const float* i_pV10, const float* i_pV01, const float* i_pV11, const float* i_pFX, const float* i_pFY, float i_Weight )
+	{
+#ifdef USE_SSE
+		__m128 fx = _mm_loadu_ps(i_pFX);
+
+		__m128 v00 = _mm_loadu_ps(i_pV00);
+		__m128 bottom = _mm_add_ps(v00, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(i_pV10), v00), fx));
+		__m128 v01 = _mm_loadu_ps(i_pV01);
+		__m128 top = _mm_add_ps(v01, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(i_pV11), v01), fx));
+
+		__m128 value = _mm_add_ps(bottom, _mm_mul_ps(_mm_sub_ps(top, bottom), _mm_loadu_ps(i_pFY)));
+
+		_mm_storeu_ps(io_pSum, _mm_add_ps(_mm_loadu_ps(io_pSum), _mm_mul_ps(value, _mm_set1_ps(i_Weight))));
+#else
+		for (unsigned short i = 0; i < 4; ++i)
+		{
+			float bottom = i_pV00[i] + (i_pV10[i] - i_pV00[i]) * i_pFX[i];
+			float top = i_pV01[i] + (i_pV11[i] - i_pV01[i]) * i_pFX[i];
+
+			io_pSum[i] += (bottom + (top - bottom) * i_pFY[i]) * i_Weight;
+		}
+#endif // USE_SSE
+	}
+
+	// i_Value mod i_Period, in [0, i_Period)
+	inline int PositiveMod ( int i_Value, int i_Period )
+	{
+		int value = i_Value % i_Period;
+
+		return (value < 0 ? value + i_Period : value);
+	}
+}
+
+// the first octave scale rounds to 2 (not rotated) or to a det 2 matrix (rotated), a smaller lacunarity rounds to the identity
+const float CloudsNoiseGenerator::m_kMinLacunarity = 1.5f;
+
+CloudsNoiseGenerator::CloudsNoiseGenerator ( void )
+	: m_Name("Default"), m_Size(0), m_OctavesPerGroup(1), m_OctaveAngle(0.0f), m_ThreadCount(1),
+	  m_NoiseSize(0), m_NoiseCellCount(1.0f), m_GroupCount(1), m_GroupMatrix(1.0f), m_GroupGain(1.0f)
+{
+	LOG("CloudsNoiseGenerator [%s] successfully created!", m_Name.c_str());
+}
+
+CloudsNoiseGenerator::~CloudsNoiseGenerator ( void )
+{
+	Destroy();
+}
+
+void CloudsNoiseGenerator::Destroy ( void )
+{
+	LOG("CloudsNoiseGenerator [%s] successfully destroyed!", m_Name.c_str());
+}
+
+bool CloudsNoiseGenerator::Initialize ( const std::string& i_Name, const std::string& i_NoiseFileName, unsigned short i_Size, unsigned short i_OctavesPerGroup, float i_OctaveAngle, unsigned short i_ThreadCount )
+{
+	m_Name = i_Name;
+
+	// 4 texels are filtered at once
+	if (i_Size < 4 || (i_Size & (i_Size - 1)) != 0)
+	{
+		ERR("The clouds noise size must be a power of 2, at least 4!");
+		return false;
+	}
+
+	m_Size = i_Size;
+	m_OctavesPerGroup = glm::max(i_OctavesPerGroup, static_cast<unsigned short>(1));
+	m_OctaveAngle = i_OctaveAngle;
+
+	// 0 - one thread per hardware thread
+	m_ThreadCount = (i_ThreadCount > 0 ? i_ThreadCount : static_cast<unsigned short>(std::thread::hardware_concurrency()));
+	if (m_ThreadCount == 0)
+	{
+		m_ThreadCount = 1;
+	}
+
+	if (!LoadNoise(i_NoiseFileName))
+	{
+		return false;
+	}
+
+	m_Data.assign(m_kLayerCount * m_Size * m_Size, 0.0f);
+
+	LOG("CloudsNoiseGenerator [%s] successfully created!", m_Name.c_str());
+
+	return true;
+}
+
+bool CloudsNoiseGenerator::LoadNoise ( const std::string& i_NoiseFileName )
+{
+	MemoryMappedFile noiseFile;
+	if (!noiseFile.Open(FileUtils::GetFullPath(i_NoiseFileName)))
+	{
+		ERR("Failed to open %s noise file!", i_NoiseFileName.c_str());
+		return false;
+	}
+
+	const unsigned char* pData = noiseFile.GetData();
+	size_t size = noiseFile.GetSize();
+
+	// binary pgm: P5 width height maxValue, then one byte per pixel
+	size_t offset = 2;
+	unsigned int width = 0, height = 0, maxValue = 0;
+
+	if (size < 2 || pData[0] != 'P' || pData[1] != '5' ||
+		!ReadPGMNumber(pData, size, offset, width) || !ReadPGMNumber(pData, size, offset, height) || !ReadPGMNumber(pData, size, offset, maxValue))
+	{
+		ERR("%s is not a binary pgm file!", i_NoiseFileName.c_str());
+		return false;
+	}
+
+	// a single white space separates the header from the pixels
+	++ offset;
+
+	if (width != height || width == 0 || (width & (width - 1)) != 0 || maxValue == 0 || maxValue > 255 || offset + width * height > size)
+	{
+		ERR("The %s noise must be a square 8 bit image, with a power of 2 size!", i_NoiseFileName.c_str());
+		return false;
+	}
+
+	m_NoiseSize = static_cast<unsigned short>(width);
+
+	m_NoiseLevels.clear();
+	m_NoiseLevels.push_back(std::vector<float>(width * height));
+
+	for (size_t i = 0; i < m_NoiseLevels[0].size(); ++i)
+	{
+		m_NoiseLevels[0][i] = 2.0f * pData[offset + i] / maxValue - 1.0f;
+	}
+
+	//// the noise cells, from the crossings of the mean value along the rows and the columns (the noise tiles, so the borders wrap around)
+	const std::vector<float>& noise = m_NoiseLevels[0];
+
+	float mean = 0.0f;
+	for (size_t i = 0; i < noise.size(); ++i)
+	{
+		mean += noise[i];
+	}
+	mean /= noise.size();
+
+	unsigned int crossingCount = 0;
+	for (unsigned int y = 0; y < height; ++y)
+	{
+		for (unsigned int x = 0; x < width; ++x)
+		{
+			bool isBelow = (noise[y * width + x] < mean);
+
+			crossingCount += (isBelow != (noise[y * width + (x + 1) % width] < mean));
+			crossingCount += (isBelow != (noise[((y + 1) % height) * width + x] < mean));
+		}
+	}
+
+	// the crossings of a row or a column, on average
+	m_NoiseCellCount = glm::max(crossingCount / (2.0f * width), 1.0f);
+
+	// box filtered mip levels, down to 1 x 1
+	for (unsigned short levelSize = m_NoiseSize / 2; levelSize > 0; levelSize /= 2)
+	{
+		const std::vector<float>& upper = m_NoiseLevels.back();
+		std::vector<float> level(levelSize * levelSize);
+
+		unsigned short upperSize = levelSize * 2;
+		for (unsigned short y = 0; y < levelSize; ++y)
+		{
+			for (unsigned short x = 0; x < levelSize; ++x)
+			{
+				const float* pUpper = &upper[(2 * y) * upperSize + 2 * x];
+
+				level[y * levelSize + x] = 0.25f * (pUpper[0] + pUpper[1] + pUpper[upperSize] + pUpper[upperSize + 1]);
+			}
+		}
+
+		m_NoiseLevels.push_back(level);
+	}
+
+	return true;
+}
+
+void CloudsNoiseGenerator::ComputeOctaveMatrix ( unsigned short i_Octave, float i_Lacunarity, glm::ivec2& o_Column0, glm::ivec2& o_Column1 ) const
+{
+	float scale = glm::pow(i_Lacunarity, static_cast<float>(i_Octave));
+	float angle = m_OctaveAngle * i_Octave;
+
+	float c = scale * glm::cos(angle);
+	float s = scale * glm::sin(angle);
+
+	// same as mat2(cos, sin, -sin, cos) in the shaders
+	o_Column0 = glm::ivec2(static_cast<int>(glm::round(c)), static_cast<int>(glm::round(s)));
+	o_Column1 = glm::ivec2(static_cast<int>(glm::round(-s)), static_cast<int>(glm::round(c)));
+}
+
+void CloudsNoiseGenerator::Generate ( unsigned short i_OctaveCount, float i_Lacunarity, float i_Gain )
+{
+	if (m_Data.empty())
+	{
+		ERR("The clouds noise generator is not initialized!");
+		return;
+	}
+
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	unsigned short octaveCount = glm::max(i_OctaveCount, static_cast<unsigned short>(1));
+	float lacunarity = glm::max(i_Lacunarity, m_kMinLacunarity);
+
+	m_GroupCount = (octaveCount + m_OctavesPerGroup - 1) / m_OctavesPerGroup;
+
+	// layer 0 is sampled only if there are more groups
+	unsigned short octaveCounts[m_kLayerCount] = { static_cast<unsigned short>(m_GroupCount > 1 ? m_OctavesPerGroup : 0), static_cast<unsigned short>(octaveCount - (m_GroupCount - 1) * m_OctavesPerGroup) };
+
+	for (unsigned short layer = 0; layer < m_kLayerCount; ++layer)
+	{
+		m_Octaves[layer].resize(octaveCounts[layer]);
+
+		for (unsigned short i = 0; i < octaveCounts[layer]; ++i)
+		{
+			OctaveData& octave = m_Octaves[layer][i];
+
+			ComputeOctaveMatrix(i, lacunarity, octave.Column0, octave.Column1);
+			octave.Weight = glm::pow(i_Gain, static_cast<float>(i));
+
+			// the coarsest noise level with at most one noise texel per generated texel
+			float scale = glm::sqrt(static_cast<float>(glm::abs(octave.Column0.x * octave.Column1.y - octave.Column0.y * octave.Column1.x)));
+
+			octave.NoiseLevel = 0;
+			while (octave.NoiseLevel + 1u < m_NoiseLevels.size() && (m_NoiseSize >> octave.NoiseLevel) * scale > m_Size)
+			{
+				++ octave.NoiseLevel;
+			}
+		}
+	}
+
+	glm::ivec2 column0, column1;
+	ComputeOctaveMatrix(m_OctavesPerGroup, lacunarity, column0, column1);
+
+	m_GroupMatrix = glm::mat2(glm::vec2(column0), glm::vec2(column1));
+	m_GroupGain = glm::pow(i_Gain, static_cast<float>(m_OctavesPerGroup));
+
+	// the calling thread computes the first rows, so no thread is created when m_ThreadCount is 1
+	unsigned short threadCount = glm::min(m_ThreadCount, m_Size);
+	unsigned short rowsPerThread = (m_Size + threadCount - 1) / threadCount;
+
+	std::vector<std::thread> workers;
+	workers.reserve(threadCount - 1);
+
+	for (unsigned short i = 1; i < threadCount; ++i)
+	{
+		unsigned int firstRow = i * rowsPerThread;
+		if (firstRow >= m_Size)
+		{
+			break;
+		}
+
+		unsigned short lastRow = static_cast<unsigned short>(glm::min(firstRow + rowsPerThread, static_cast<unsigned int>(m_Size)));
+
+		workers.push_back(std::thread(&CloudsNoiseGenerator::ComputeRows, this, static_cast<unsigned short>(firstRow), lastRow));
+	}
+
+	ComputeRows(0, glm::min(rowsPerThread, m_Size));
+
+	for (size_t i = 0; i < workers.size(); ++i)
+	{
+		workers[i].join();
+	}
+
+	float generateTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count() * 1000.0f;
+
+	LOG("CloudsNoiseGenerator [%s] generated %u octave(s) in %u group(s) in %.2f ms!", m_Name.c_str(), octaveCount, m_GroupCount, generateTime);
+}
+
+void CloudsNoiseGenerator::ComputeRows ( unsigned short i_FirstRow, unsigned short i_LastRow )
+{
+	for (unsigned short row = i_FirstRow; row < i_LastRow; ++row)
+	{
+		for (unsigned short layer = 0; layer < m_kLayerCount; ++layer)
+		{
+			ComputeRow(layer, row);
+		}
+	}
+}
+
+void CloudsNoiseGenerator::ComputeRow ( unsigned short i_Layer, unsigned short i_Row )
+{
+	float* pRow = &m_Data[(i_Layer * m_Size + i_Row) * m_Size];
+	std::memset(pRow, 0, m_Size * sizeof(float));
+
+	// the texel centers are at the odd multiples of 1 / (2 * size), so the coordinates are integers modulo 2 * size
+	// and the integer octave matrices keep them exact
+	int period = 2 * m_Size;
+
+	for (size_t i = 0; i < m_Octaves[i_Layer].size(); ++i)
+	{
+		const OctaveData& octave = m_Octaves[i_Layer][i];
+
+		const std::vector<float>& noise = m_NoiseLevels[octave.NoiseLevel];
+		int noiseSize = m_NoiseSize >> octave.NoiseLevel;
+		int noiseMask = noiseSize - 1;
+		float toNoise = static_cast<float>(noiseSize) / period;
+
+		// M * (2 * x + 1, 2 * y + 1), one step of x adds 2 * column0
+		int u = PositiveMod(octave.Column0.x + octave.Column1.x * (2 * i_Row + 1), period);
+		int v = PositiveMod(octave.Column0.y + octave.Column1.y * (2 * i_Row + 1), period);
+		int stepU = PositiveMod(2 * octave.Column0.x, period);
+		int stepV = PositiveMod(2 * octave.Column0.y, period);
+
+		float v00[4], v10[4], v01[4], v11[4], fx[4], fy[4];
+
+		for (unsigned short x = 0; x < m_Size; x += 4)
+		{
+			for (unsigned short j = 0; j < 4; ++j)
+			{
+				// the GL sampler convention: texel i covers [i, i + 1), the filtering is done between the texel centers
+				float noiseU = u * toNoise - 0.5f;
+				float noiseV = v * toNoise - 0.5f;
+
+				// noiseU, noiseV >= -0.5, so the truncation is the floor
+				int x0 = static_cast<int>(noiseU + 1.0f) - 1;
+				int y0 = static_cast<int>(noiseV + 1.0f) - 1;
+
+				fx[j] = noiseU - x0;
+				fy[j] = noiseV - y0;
+
+				int x1 = (x0 + 1) & noiseMask;
+				int y1 = (y0 + 1) & noiseMask;
+				x0 &= noiseMask;
+				y0 &= noiseMask;
+
+				v00[j] = noise[y0 * noiseSize + x0];
+				v10[j] = noise[y0 * noiseSize + x1];
+				v01[j] = noise[y1 * noiseSize + x0];
+				v11[j] = noise[y1 * noiseSize + x1];
+
+				u += stepU;
+				if (u >= period) u -= period;
+				v += stepV;
+				if (v >= period) v -= period;
+			}
+
+			AddBilinear4(pRow + x, v00, v10, v01, v11, fx, fy, octave.Weight);
+		}
+	}
+}
+
+const float* CloudsNoiseGenerator::GetData ( void ) const
+{
+	return m_Data.data();
+}
+
+unsigned short CloudsNoiseGenerator::GetSize ( void ) const
+{
+	return m_Size;
+}
+
+unsigned short CloudsNoiseGenerator::GetGroupCount ( void ) const
+{
+	return m_GroupCount;
+}
+
+const glm::mat2& CloudsNoiseGenerator::GetGroupMatrix ( void ) const
+{
+	return m_GroupMatrix;
+}
+
+float CloudsNoiseGenerator::GetGroupGain ( void ) const
+{
+	return m_GroupGain;
+}
+
+float CloudsNoiseGenerator::GetNoiseCellCount ( void ) const
+{
+	return m_NoiseCellCount;
+}
\ No newline at end of file
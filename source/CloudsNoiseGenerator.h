@@ -0,0 +1,104 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef CLOUDS_NOISE_GENERATOR_H
+#define CLOUDS_NOISE_GENERATOR_H
+
+#include "glm/mat2x2.hpp"
+#include "glm/vec2.hpp"
+#include <string>
+#include <vector>
+
+/*
+ CPU generator of the clouds fBm (fractal brownian motion) noise
+
+ The octaves are summed up on the CPU into a tileable texture, so the clouds shaders don't loop over the octaves.
+ octave j: weight Gain^j, coordinates (Lacunarity * rotation(OctaveAngle))^j * uv, the base noise is a tileable 8 bit pgm image.
+ The octave transforms are rounded to integer matrices, so every octave is periodic over the texture too
+ (the lacunarity is quantized, the low octaves mostly). Below m_kMinLacunarity the rounding would give the same
+ (or a zero) matrix for every octave, so the lacunarity is clamped to it.
+
+ The texture can't hold the high octaves of the ocean scale clouds, so the octaves are split in groups of OctavesPerGroup:
+ - layer 0 - the sum of a full group
+ - layer 1 - the sum of the last group (the remaining octaves)
+ group i + 1 is group i sampled with the coordinates transformed by the group matrix and weighted by the group gain,
+ so the shaders fetch the texture once per group, not once per octave.
+ Each octave samples the base noise mip level which matches the texture size, the finer details are left to the next group.
+
+ The rows are split across threads, the bilinear filtering of 4 texels is done at once with SSE.
+*/
+
+class CloudsNoiseGenerator
+{
+public:
+	CloudsNoiseGenerator(void);
+	~CloudsNoiseGenerator(void);
+
+	// i_Size - power of 2, i_OctaveAngle - the rotation between 2 octaves (radians)
+	// i_ThreadCount - 0 means one thread per hardware thread
+	bool Initialize(const std::string& i_Name, const std::string& i_NoiseFileName, unsigned short i_Size, unsigned short i_OctavesPerGroup, float i_OctaveAngle, unsigned short i_ThreadCount);
+
+	// the octaves sum up the base noise mapped to [-1, 1]
+	// i_Lacunarity - clamped to m_kMinLacunarity
+	void Generate(unsigned short i_OctaveCount, float i_Lacunarity, float i_Gain);
+
+	// m_kLayerCount layers of Size x Size floats
+	const float* GetData(void) const;
+	unsigned short GetSize(void) const;
+
+	// the number of texture fetches
+	unsigned short GetGroupCount(void) const;
+	// the coordinates of group i + 1 = GroupMatrix * the coordinates of group i
+	const glm::mat2& GetGroupMatrix(void) const;
+	float GetGroupGain(void) const;
+
+	// the average number of noise cells across the base noise (and the generated texture, the first octave isn't scaled)
+	// measured as the mean crossings per row and per column, a gradient noise crosses its mean about once per lattice cell
+	float GetNoiseCellCount(void) const;
+
+	static const unsigned short m_kLayerCount = 2;
+	static const float m_kMinLacunarity;
+
+private:
+	//// Methods ////
+	void Destroy(void);
+
+	bool LoadNoise(const std::string& i_NoiseFileName);
+
+	// the octave matrix is rounded from (i_Lacunarity * rotation(m_OctaveAngle))^i_Octave
+	void ComputeOctaveMatrix(unsigned short i_Octave, float i_Lacunarity, glm::ivec2& o_Column0, glm::ivec2& o_Column1) const;
+
+	void ComputeRows(unsigned short i_FirstRow, unsigned short i_LastRow);
+	void ComputeRow(unsigned short i_Layer, unsigned short i_Row);
+
+	//// Variables ////
+	std::string m_Name;
+
+	unsigned short m_Size;
+	unsigned short m_OctavesPerGroup;
+	float m_OctaveAngle;
+	unsigned short m_ThreadCount;
+
+	// base noise mip levels, [-1, 1] values
+	std::vector<std::vector<float>> m_NoiseLevels;
+	unsigned short m_NoiseSize;
+	float m_NoiseCellCount;
+
+	struct OctaveData
+	{
+		glm::ivec2 Column0;
+		glm::ivec2 Column1;
+		float Weight;
+		unsigned short NoiseLevel;
+	};
+
+	// the octaves of each layer
+	std::vector<OctaveData> m_Octaves[m_kLayerCount];
+
+	unsigned short m_GroupCount;
+	glm::mat2 m_GroupMatrix;
+	float m_GroupGain;
+
+	std::vector<float> m_Data;
+};
+
+#endif /* CLOUDS_NOISE_GENERATOR_H */
\ No newline at end of file
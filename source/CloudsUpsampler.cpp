@@ -0,0 +1,161 @@
+/* Author: BAIRAC MIHAI */
+
+#include "CloudsUpsampler.h"
+#include "CommonHeaders.h"
+#include "GLConfig.h"
+#include "GLStateCache.h"
+// glm::mat4 comes from the header
+#include "glm/vec4.hpp"
+#include "glm/common.hpp" //clamp(), max(), round()
+#include "glm/gtc/type_ptr.hpp" //value_ptr()
+#include "GlobalConfig.h"
+
+
+const char* const CloudsUpsampler::m_kUniformHandleNames[] =
+{
+	"u_WorldToClipMatrix",
+	"u_ObjectToWorldMatrix",
+	"u_IsLayered",
+	"u_Viewport"
+};
+
+CloudsUpsampler::CloudsUpsampler ( void )
+	: m_Name("Default"), m_ResolutionScale(1.0f), m_ColorTexUnitId(0), m_DepthTexUnitId(0),
+	  m_LowResWidth(0), m_LowResHeight(0), m_OldFBOId(0), m_VertexCount(0)
+{
+	for (unsigned short i = 0; i < 4; ++i)
+	{
+		m_Viewport[i] = 0;
+		m_OldClearColor[i] = 0.0f;
+	}
+
+	LOG("CloudsUpsampler [%s] successfully created!", m_Name.c_str());
+}
+
+CloudsUpsampler::~CloudsUpsampler ( void )
+{
+	Destroy();
+}
+
+void CloudsUpsampler::Destroy ( void )
+{
+	LOG("CloudsUpsampler [%s] successfully destroyed!", m_Name.c_str());
+}
+
+void CloudsUpsampler::Initialize ( const std::string& i_Name, const GlobalConfig& i_Config, const std::string& i_VertexFileName, const std::vector<MeshBufferManager::VertexData>& i_VertexData, float i_ResolutionScale, unsigned short i_ColorTexUnitId, unsigned short i_DepthTexUnitId )
+{
+	m_Name = i_Name;
+
+	m_ResolutionScale = glm::clamp(i_ResolutionScale, 0.1f, 1.0f);
+	m_ColorTexUnitId = i_ColorTexUnitId;
+	m_DepthTexUnitId = i_DepthTexUnitId;
+
+	std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int> attributes;
+	SetupShaders(i_Config, i_VertexFileName, attributes);
+
+	// the upsample program has its own attribute locations
+	m_VertexCount = static_cast<unsigned short>(i_VertexData.size());
+
+	m_MBM.Initialize(m_Name + " Clouds Upsampler");
+	m_MBM.CreateModelContext(i_VertexData, attributes, MeshBufferManager::ACCESS_TYPE::AT_STATIC);
+
+	// the real size is known on the first BeginLowResPass()
+	m_LowResWidth = 1;
+	m_LowResHeight = 1;
+
+	// float colors, so the alpha is not clamped before blending
+	m_FBM.Initialize(m_Name + " Clouds Upsampler", i_Config);
+	m_FBM.CreateSimple(1, GL_RGBA16F, GL_RGBA, GL_FLOAT, m_LowResWidth, m_LowResHeight, GL_CLAMP_TO_EDGE, GL_NEAREST, m_ColorTexUnitId, -1, false, FrameBufferManager::DEPTH_BUFFER_TYPE::DBT_TEXTURE_DEPTH);
+
+	LOG("CloudsUpsampler [%s] successfully created!", m_Name.c_str());
+}
+
+void CloudsUpsampler::SetupShaders ( const GlobalConfig& i_Config, const std::string& i_VertexFileName, std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& o_Attributes )
+{
+	m_SM.Initialize(m_Name + " Clouds Upsampler");
+	m_SM.BuildRenderingProgram(i_VertexFileName, "resources/shaders/CloudsUpsample.frag.glsl", i_Config);
+
+	m_SM.UseProgram();
+
+	// the uvs are used only by some of the clouds vertex shaders
+	o_Attributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_SM.GetAttributeLocation("a_position");
+	o_Attributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_UV] = m_SM.GetAttributeLocation("a_uv");
+
+	m_SM.SetUniform(m_SM.GetUniformLocation("u_LowResMap"), m_ColorTexUnitId);
+	m_SM.SetUniform(m_SM.GetUniformLocation("u_LowResDepthMap"), m_DepthTexUnitId);
+
+	m_Handles.Initialize(m_SM, m_kUniformHandleNames);
+
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_LAYERED], false);
+
+	m_SM.UnUseProgram();
+}
+
+void CloudsUpsampler::BeginLowResPass ( void )
+{
+	glGetIntegerv(GL_VIEWPORT, m_Viewport);
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_OldFBOId);
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, m_OldClearColor);
+
+	unsigned short width = static_cast<unsigned short>(glm::max(glm::round(m_Viewport[2] * m_ResolutionScale), 1.0f));
+	unsigned short height = static_cast<unsigned short>(glm::max(glm::round(m_Viewport[3] * m_ResolutionScale), 1.0f));
+
+	if (width != m_LowResWidth || height != m_LowResHeight)
+	{
+		m_LowResWidth = width;
+		m_LowResHeight = height;
+
+		m_FBM.UpdateColorAttachmentSize(0, m_LowResWidth, m_LowResHeight);
+		m_FBM.UpdateDepthBufferSize(m_LowResWidth, m_LowResHeight);
+	}
+
+	m_FBM.Bind();
+
+	glViewport(0, 0, m_LowResWidth, m_LowResHeight);
+
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	// rgb: the usual alpha blending, premultiplied, alpha: the coverage
+	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	glEnable(GL_BLEND);
+}
+
+void CloudsUpsampler::EndLowResPass ( void )
+{
+	glDisable(GL_BLEND);
+
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, m_OldFBOId);
+
+	glViewport(m_Viewport[0], m_Viewport[1], m_Viewport[2], m_Viewport[3]);
+	glClearColor(m_OldClearColor[0], m_OldClearColor[1], m_OldClearColor[2], m_OldClearColor[3]);
+}
+
+void CloudsUpsampler::SetViewData ( const glm::mat4& i_WorldToClipMatrix, const glm::mat4& i_ObjectToWorldMatrix )
+{
+	m_SM.UseProgram();
+
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_WORLD_TO_CLIP_MATRIX], 1, glm::value_ptr(i_WorldToClipMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_OBJECT_TO_WORLD_MATRIX], 1, glm::value_ptr(i_ObjectToWorldMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+}
+
+void CloudsUpsampler::Render ( void )
+{
+	m_SM.UseProgram();
+
+	// the viewport of the last low resolution pass
+	glm::vec4 viewport(m_Viewport[0], m_Viewport[1], m_Viewport[2], m_Viewport[3]);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_VIEWPORT], 1, glm::value_ptr(viewport), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_4);
+
+	m_FBM.BindColorAttachmentByIndex(0);
+	m_FBM.BindDepthAttachment(m_DepthTexUnitId);
+
+	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	glEnable(GL_BLEND);
+
+	m_MBM.BindModelContext();
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, m_VertexCount);
+	m_MBM.UnBindModelContext();
+
+	glDisable(GL_BLEND);
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef CLOUDS_UPSAMPLER_H
+#define CLOUDS_UPSAMPLER_H
+
+#include "glm/mat4x4.hpp"
+#include "ShaderManager.h"
+#include "MeshBufferManager.h"
+#include "FrameBufferManager.h"
+#include <string>
+#include <vector>
+
+class GlobalConfig;
+
+/*
+ Reduced resolution rendering of the clouds plane
+
+ The clouds are rendered into a low resolution target (color + depth), then the clouds plane is drawn again at full resolution
+ and every fragment blends the 4 nearest low resolution texels, weighted by the bilinear weights and by how close their depth is
+ to the fragment depth (bilateral upsampling), so the empty texels around the plane edges don't bleed into the clouds.
+ The full resolution pass is depth tested against the scene, so the objects in front of the clouds keep their sharp edges.
+
+ The low resolution target keeps premultiplied colors, so the texels are averaged correctly.
+
+ Usage (check ScatteringSkyModel):
+ BeginLowResPass(), render the clouds without setting the blending, EndLowResPass(), then SetViewData() + Render()
+*/
+
+class CloudsUpsampler
+{
+public:
+	CloudsUpsampler(void);
+	~CloudsUpsampler(void);
+
+	// i_VertexFileName - the clouds vertex shader, the clouds plane is drawn with it at full resolution
+	void Initialize(const std::string& i_Name, const GlobalConfig& i_Config, const std::string& i_VertexFileName, const std::vector<MeshBufferManager::VertexData>& i_VertexData, float i_ResolutionScale, unsigned short i_ColorTexUnitId, unsigned short i_DepthTexUnitId);
+
+	// the low resolution target is resized to match the current viewport
+	void BeginLowResPass(void);
+	void EndLowResPass(void);
+
+	void SetViewData(const glm::mat4& i_WorldToClipMatrix, const glm::mat4& i_ObjectToWorldMatrix);
+	void Render(void);
+
+private:
+	//// Methods ////
+	void SetupShaders(const GlobalConfig& i_Config, const std::string& i_VertexFileName, std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& o_Attributes);
+
+	void Destroy(void);
+
+	//// Variables ////
+	std::string m_Name;
+
+	ShaderManager m_SM;
+	MeshBufferManager m_MBM;
+	FrameBufferManager m_FBM;
+
+	enum class UNIFORM_HANDLE
+	{
+		UH_WORLD_TO_CLIP_MATRIX = 0,
+		UH_OBJECT_TO_WORLD_MATRIX,
+		UH_IS_LAYERED,
+		UH_VIEWPORT,
+		UH_COUNT
+	};
+
+	static const char* const m_kUniformHandleNames[static_cast<unsigned short>(UNIFORM_HANDLE::UH_COUNT)];
+
+	ShaderManager::UniformHandleTable<UNIFORM_HANDLE, static_cast<unsigned short>(UNIFORM_HANDLE::UH_COUNT)> m_Handles;
+
+	float m_ResolutionScale;
+	unsigned short m_ColorTexUnitId, m_DepthTexUnitId;
+
+	unsigned short m_LowResWidth, m_LowResHeight;
+
+	// the state replaced by the low resolution pass
+	int m_Viewport[4];
+	int m_OldFBOId;
+	float m_OldClearColor[4];
+
+	unsigned short m_VertexCount;
+};
+
+#endif /* CLOUDS_UPSAMPLER_H */
\ No newline at end of file
@@ -87,6 +87,8 @@ void CubeMapSkyModel::SetupShaders ( const GlobalConfig& i_Config, std::map<Mesh
 	m_Uniforms["u_UnderWaterFogColor"] = m_SM.GetUniformLocation("u_UnderWaterFogColor");
 	m_SM.SetUniform(m_Uniforms.find("u_UnderWaterFogColor")->second, 1, glm::value_ptr(i_Config.Scene.Ocean.UnderWater.Fog.Color), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
 
+	m_Handles.Initialize(m_SM, m_kUniformHandleNames);
+
 	m_SM.UnUseProgram();
 }
 
@@ -190,17 +192,18 @@ void CubeMapSkyModel::UpdateInternal ( const glm::mat4& i_ModelMatrix, bool i_Ap
 	/////////////////////////////
 	m_SM.UseProgram();
 
-	m_SM.SetUniform(m_Uniforms.find("u_ApplyHDR")->second, i_ApplyHDR);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_LAYERED], false);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_APPLY_HDR], i_ApplyHDR);
 
 	// we remove the translation vector from the view matrix !
 	// this allows the skybox to be still even if the camera moves !
 	// as explained in here:  https://learnopengl.com/#!Advanced-OpenGL/Cubemaps
 	glm::mat4 PV = i_Camera.GetProjectionMatrix() * glm::mat4(glm::mat3(i_Camera.GetViewMatrix()));
 
-	m_SM.SetUniform(m_Uniforms.find("u_WorldToClipMatrix")->second, 1, glm::value_ptr(PV), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-	m_SM.SetUniform(m_Uniforms.find("u_ObjectToWorldMatrix")->second, 1, glm::value_ptr(i_ModelMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_WORLD_TO_CLIP_MATRIX], 1, glm::value_ptr(PV), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_OBJECT_TO_WORLD_MATRIX], 1, glm::value_ptr(i_ModelMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 
-	m_SM.SetUniform(m_Uniforms.find("u_IsUnderWater")->second, i_IsUnderWater);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_UNDER_WATER], i_IsUnderWater);
 }
 
 void CubeMapSkyModel::Render ( void )
@@ -224,7 +227,31 @@ void CubeMapSkyModel::RenderRefracted ( void )
 	RenderInternal();
 }
 
-void CubeMapSkyModel::RenderInternal ( void )
+bool CubeMapSkyModel::IsLayeredReflRefrSupported ( void ) const
+{
+	return true;
+}
+
+void CubeMapSkyModel::UpdateReflectedRefracted ( const glm::mat4& i_ReflScaleMatrix, const glm::mat4& i_RefrScaleMatrix, const Camera& i_Camera, bool i_IsWireframeMode, float i_CrrTime )
+{
+	// the layers share everything but the model matrix
+	UpdateInternal(i_ReflScaleMatrix, false, i_Camera, false, i_IsWireframeMode, i_CrrTime);
+
+	// one matrix per layer (instance): 0 - reflection, 1 - refraction
+	glm::mat4 modelMatrices[2] = { i_ReflScaleMatrix, i_RefrScaleMatrix };
+
+	m_SM.UseProgram();
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_LAYERED], true);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_OBJECT_TO_WORLD_MATRIX], 2, glm::value_ptr(modelMatrices[0]), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+}
+
+void CubeMapSkyModel::RenderReflectedRefracted ( void )
+{
+	// the face culling is disabled by the caller, the reflection instance has the winding reverted
+	RenderInternal(2);
+}
+
+void CubeMapSkyModel::RenderInternal ( unsigned short i_InstanceCount )
 {
 	// we set a different depth function as explined here: https://learnopengl.com/#!Advanced-OpenGL/Cubemaps
 	glDepthFunc(GL_LEQUAL);
@@ -233,7 +260,7 @@ void CubeMapSkyModel::RenderInternal ( void )
 	m_SM.UseProgram();
 
 	m_MBM.BindModelContext();
-	glDrawElements(m_IsWireframeMode ? GL_LINES : GL_TRIANGLES, m_IndexCount, GL_UNSIGNED_INT, nullptr);
+	glDrawElementsInstanced(m_IsWireframeMode ? GL_LINES : GL_TRIANGLES, m_IndexCount, GL_UNSIGNED_INT, nullptr, i_InstanceCount);
 	m_MBM.UnBindModelContext();
 
 	glDepthFunc(GL_LESS);
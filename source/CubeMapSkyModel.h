@@ -37,6 +37,10 @@ public:
 	void RenderReflected(void) override;
 	void RenderRefracted(void) override;
 
+	bool IsLayeredReflRefrSupported(void) const override;
+	void UpdateReflectedRefracted(const glm::mat4& i_ReflScaleMatrix, const glm::mat4& i_RefrScaleMatrix, const Camera& i_Camera, bool i_IsWireframeMode, float i_CrrTime) override;
+	void RenderReflectedRefracted(void) override;
+
 	void SetSunDirection(float i_Phi, float i_Theta) override;
 
 private:
@@ -46,7 +50,7 @@ private:
 	void SetupTextures(const GlobalConfig& i_Config);
 
 	void UpdateInternal(const glm::mat4& i_ModelMatrix, bool i_ApplyHDR, const Camera& i_Camera, bool i_IsUnderWater, bool i_IsWireframeMode, float i_CrrTime);
-	void RenderInternal(void);
+	void RenderInternal(unsigned short i_InstanceCount = 1);
 
 	void Destroy(void);
 
@@ -22,6 +22,10 @@ namespace CustomTypes
 		{
 			GT_WORLD_SPACE = 0,
 			GT_SCREEN_SPACE,
+			GT_CPU_PROJECTED,
+			GT_CLIPMAP,
+			GT_QUADTREE,
+			GT_TESSELLATED,
 			GT_COUNT
 		};
 		
@@ -30,6 +34,7 @@ namespace CustomTypes
 			CFT_GPU_FRAG = 0,
 			CFT_GPU_COMP,
 			CFT_CPU_FFTW, 
+			CFT_BAKED_CACHE,
 			CFT_COUNT
 		};
 
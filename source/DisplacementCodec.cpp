@@ -0,0 +1,593 @@
+/* Author: BAIRAC MIHAI */
+
+#include "DisplacementCodec.h"
+#include "CommonHeaders.h"
+// glm::vec4 comes from the header
+#include "glm/common.hpp" //min(), max(), clamp(), abs()
+#include "glm/fwd.hpp" //uint64
+#include <cstring> // std::memcpy()
+#include <cfloat> // FLT_EPSILON
+#include <algorithm> // std::copy()
+#include <cassert>
+#ifdef USE_SSE2
+#include <emmintrin.h> // _mm_cvttps_epi32(), _mm_cvtepi32_ps()
+#endif // USE_SSE2
+
+namespace
+{
+	// identifies an encoded frame
+	const unsigned int kFrameMagic = 0x31464344; // "DCF1"
+
+	// residuals with a bigger Rice quotient are stored raw
+	const unsigned short kEscapeQuotient = 16;
+
+	// float rounding error of the quantization + dequantization, relative to the channel range + magnitude
+	const float kRoundingError = 4.0f * FLT_EPSILON;
+
+	struct FrameHeader
+	{
+		unsigned int magic;
+		unsigned short quantizationBits;
+		unsigned short isKeyFrame;
+		unsigned int layerCount;
+		unsigned int layerSize;
+	};
+
+	template <typename T>
+	void WriteValue ( std::vector<unsigned char>& io_Data, const T& i_Value )
+	{
+		const unsigned char* pValue = reinterpret_cast<const unsigned char*>(&i_Value);
+		io_Data.insert(io_Data.end(), pValue, pValue + sizeof(T));
+	}
+
+	template <typename T>
+	bool ReadValue ( const unsigned char* i_pData, size_t i_Size, size_t& io_Offset, T& o_Value )
+	{
+		if (io_Offset + sizeof(T) > i_Size)
+		{
+			return false;
+		}
+
+		std::memcpy(&o_Value, i_pData + io_Offset, sizeof(T));
+		io_Offset += sizeof(T);
+
+		return true;
+	}
+
+	// bits are written LSB first
+	class BitWriter
+	{
+	public:
+		BitWriter ( std::vector<unsigned char>& io_Data )
+			: m_Data(io_Data), m_Buffer(0), m_BitCount(0)
+		{}
+
+		// NOTE! i_Value must fit in i_BitCount bits, i_BitCount <= 32
+		void Write ( unsigned int i_Value, unsigned short i_BitCount )
+		{
+			m_Buffer |= static_cast<glm::uint64>(i_Value) << m_BitCount;
+			m_BitCount += i_BitCount;
+
+			while (m_BitCount >= 8)
+			{
+				m_Data.push_back(static_cast<unsigned char>(m_Buffer & 0xFF));
+				m_Buffer >>= 8;
+				m_BitCount -= 8;
+			}
+		}
+
+		void Flush ( void )
+		{
+			if (m_BitCount > 0)
+			{
+				m_Data.push_back(static_cast<unsigned char>(m_Buffer & 0xFF));
+				m_Buffer = 0;
+				m_BitCount = 0;
+			}
+		}
+
+	private:
+		std::vector<unsigned char>& m_Data;
+		glm::uint64 m_Buffer;
+		unsigned short m_BitCount;
+	};
+
+	// number of trailing ones of a 4 bits value
+	const unsigned char kTrailingOnes[16] = { 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4 };
+
+	// reads straight from the bit position, 8 bytes at once (little endian, like the rest of the frame)
+	class BitReader
+	{
+	public:
+		BitReader ( const unsigned char* i_pData, size_t i_Size )
+			: m_pData(i_pData), m_Size(i_Size), m_BitOffset(0)
+		{}
+
+		// i_BitCount <= 32
+		bool Read ( unsigned short i_BitCount, unsigned int& o_Value )
+		{
+			if (i_BitCount > GetBitsLeft())
+			{
+				return false;
+			}
+
+			o_Value = static_cast<unsigned int>(Peek() & ((static_cast<glm::uint64>(1) << i_BitCount) - 1));
+			m_BitOffset += i_BitCount;
+
+			return true;
+		}
+
+		// Rice code: quotient ones, a zero and the i_K bits remainder, or kEscapeQuotient ones and the raw 32 bits value
+		// the unary part is counted 4 bits at a time, instead of a Read(1) call per bit
+		bool ReadRice ( unsigned short i_K, unsigned int& o_Value )
+		{
+			glm::uint64 bits = Peek();
+
+			unsigned int quotient = 0, ones = 0;
+			do
+			{
+				ones = kTrailingOnes[(bits >> quotient) & 0xF];
+				quotient += ones;
+			} while (ones == 4 && quotient < kEscapeQuotient);
+
+			if (quotient >= kEscapeQuotient)
+			{
+				if (kEscapeQuotient > GetBitsLeft())
+				{
+					return false;
+				}
+
+				m_BitOffset += kEscapeQuotient;
+
+				return Read(32, o_Value);
+			}
+
+			size_t bitCount = quotient + 1 + i_K;
+			if (bitCount > GetBitsLeft())
+			{
+				return false;
+			}
+
+			o_Value = (quotient << i_K) | static_cast<unsigned int>((bits >> (quotient + 1)) & ((static_cast<glm::uint64>(1) << i_K) - 1));
+			m_BitOffset += bitCount;
+
+			return true;
+		}
+
+	private:
+		// at least 57 bits from the bit position, the bits after the end of the data are 0
+		glm::uint64 Peek ( void ) const
+		{
+			size_t byteOffset = m_BitOffset >> 3;
+			glm::uint64 value = 0;
+
+			if (byteOffset + sizeof(value) <= m_Size)
+			{
+				std::memcpy(&value, m_pData + byteOffset, sizeof(value));
+			}
+			else
+			{
+				for (size_t i = byteOffset; i < m_Size; ++i)
+				{
+					value |= static_cast<glm::uint64>(m_pData[i]) << (8 * (i - byteOffset));
+				}
+			}
+
+			return value >> (m_BitOffset & 7);
+		}
+
+		size_t GetBitsLeft ( void ) const
+		{
+			return m_Size * 8 - m_BitOffset;
+		}
+
+		const unsigned char* m_pData;
+		size_t m_Size;
+		size_t m_BitOffset;
+	};
+}
+
+
+DisplacementCodec::DisplacementCodec ( void )
+	: m_QuantizationBits(0), m_MaxQuantizedValue(0),
+	  m_KeyFrameInterval(0), m_FramesSinceKeyFrame(0),
+	  m_MaxError(0.0f)
+{
+	LOG("DisplacementCodec successfully created!");
+}
+
+DisplacementCodec::DisplacementCodec ( unsigned short i_QuantizationBits, unsigned short i_KeyFrameInterval )
+	: m_QuantizationBits(0), m_MaxQuantizedValue(0),
+	  m_KeyFrameInterval(0), m_FramesSinceKeyFrame(0),
+	  m_MaxError(0.0f)
+{
+	Initialize(i_QuantizationBits, i_KeyFrameInterval);
+}
+
+DisplacementCodec::~DisplacementCodec ( void )
+{
+	Destroy();
+}
+
+void DisplacementCodec::Destroy ( void )
+{
+	LOG("DisplacementCodec successfully destroyed!");
+}
+
+void DisplacementCodec::Initialize ( unsigned short i_QuantizationBits, unsigned short i_KeyFrameInterval )
+{
+	m_QuantizationBits = i_QuantizationBits;
+	if (m_QuantizationBits != 16 && m_QuantizationBits != 12)
+	{
+		ERR("Invalid quantization bits! Only 16 or 12 are supported!");
+		m_QuantizationBits = 16;
+	}
+	m_MaxQuantizedValue = (1u << m_QuantizationBits) - 1;
+
+	// 1 - only key frames
+	m_KeyFrameInterval = i_KeyFrameInterval;
+	if (m_KeyFrameInterval == 0)
+	{
+		ERR("Invalid key frame interval!");
+		m_KeyFrameInterval = 1;
+	}
+
+	Reset();
+
+	LOG("DisplacementCodec successfully created!");
+}
+
+void DisplacementCodec::Reset ( void )
+{
+	m_PreviousFrame.clear();
+	m_FramesSinceKeyFrame = 0;
+	m_MaxError = glm::vec4(0.0f);
+}
+
+void DisplacementCodec::EncodeFrame ( const glm::vec4* i_pData, unsigned short i_LayerCount, size_t i_LayerSize, std::vector<unsigned char>& o_EncodedData )
+{
+	assert(i_pData != nullptr);
+
+	size_t count = i_LayerCount * i_LayerSize;
+	bool isKeyFrame = (m_PreviousFrame.size() != count || m_FramesSinceKeyFrame >= m_KeyFrameInterval);
+
+	o_EncodedData.clear();
+
+	FrameHeader header;
+	header.magic = kFrameMagic;
+	header.quantizationBits = m_QuantizationBits;
+	header.isKeyFrame = (isKeyFrame ? 1 : 0);
+	header.layerCount = i_LayerCount;
+	header.layerSize = static_cast<unsigned int>(i_LayerSize);
+	WriteValue(o_EncodedData, header);
+
+	m_QuantizedData.resize(count * 4);
+	m_PredictedData.resize(count * 4);
+
+	std::vector<glm::vec4> layerMin(i_LayerCount), layerStep(i_LayerCount);
+	m_MaxError = glm::vec4(0.0f);
+
+	////////// Quantization + prediction, per layer
+	for (unsigned short i = 0; i < i_LayerCount; ++i)
+	{
+		size_t offset = i * i_LayerSize;
+
+		glm::vec4 max(0.0f), scale(0.0f);
+		ComputeMinMax(i_pData + offset, i_LayerSize, layerMin[i], max);
+		ComputeScaleAndStep(layerMin[i], max, scale, layerStep[i]);
+
+		WriteValue(o_EncodedData, layerMin[i]);
+		WriteValue(o_EncodedData, max);
+
+		Quantize(i_pData + offset, i_LayerSize, layerMin[i], scale, &m_QuantizedData[offset * 4]);
+
+		if (!isKeyFrame)
+		{
+			// the previous frame is quantized using the current range, so the residuals are small
+			Quantize(&m_PreviousFrame[offset], i_LayerSize, layerMin[i], scale, &m_PredictedData[offset * 4]);
+		}
+
+		m_MaxError = glm::max(m_MaxError, ComputeMaxError(layerMin[i], max, layerStep[i]));
+	}
+
+	////////// Residuals - zig-zag mapped, so small negative values stay small
+	for (size_t i = 0; i < m_QuantizedData.size(); ++i)
+	{
+		int delta = static_cast<int>(m_QuantizedData[i]) - (isKeyFrame ? 0 : static_cast<int>(m_PredictedData[i]));
+		m_PredictedData[i] = (static_cast<unsigned int>(delta) << 1) ^ static_cast<unsigned int>(delta >> 31);
+	}
+
+	EncodeResiduals(&m_PredictedData[0], m_PredictedData.size(), o_EncodedData);
+
+	////////// Keep the decoded frame, so the next prediction matches the decoder one
+	m_PreviousFrame.resize(count);
+	for (unsigned short i = 0; i < i_LayerCount; ++i)
+	{
+		size_t offset = i * i_LayerSize;
+		Dequantize(&m_QuantizedData[offset * 4], i_LayerSize, layerMin[i], layerStep[i], &m_PreviousFrame[offset]);
+	}
+
+	m_FramesSinceKeyFrame = (isKeyFrame ? 1 : m_FramesSinceKeyFrame + 1);
+}
+
+bool DisplacementCodec::DecodeFrame ( const unsigned char* i_pEncodedData, size_t i_EncodedSize, glm::vec4* o_pData, unsigned short i_LayerCount, size_t i_LayerSize )
+{
+	assert(i_pEncodedData != nullptr);
+	assert(o_pData != nullptr);
+
+	size_t offset = 0;
+
+	FrameHeader header;
+	if (!ReadValue(i_pEncodedData, i_EncodedSize, offset, header) || header.magic != kFrameMagic)
+	{
+		ERR("Invalid encoded frame!");
+		return false;
+	}
+
+	if (header.layerCount != i_LayerCount || header.layerSize != i_LayerSize)
+	{
+		ERR("Encoded frame size mismatch!");
+		return false;
+	}
+
+	if (header.quantizationBits != 16 && header.quantizationBits != 12)
+	{
+		ERR("Invalid quantization bits!");
+		return false;
+	}
+
+	// the decoder follows the encoder settings
+	m_QuantizationBits = header.quantizationBits;
+	m_MaxQuantizedValue = (1u << m_QuantizationBits) - 1;
+
+	size_t count = i_LayerCount * i_LayerSize;
+	bool isKeyFrame = (header.isKeyFrame != 0);
+
+	if (!isKeyFrame && m_PreviousFrame.size() != count)
+	{
+		ERR("Missing previous frame! Decoding must start with a key frame!");
+		return false;
+	}
+
+	std::vector<glm::vec4> layerMin(i_LayerCount), layerMax(i_LayerCount);
+	for (unsigned short i = 0; i < i_LayerCount; ++i)
+	{
+		if (!ReadValue(i_pEncodedData, i_EncodedSize, offset, layerMin[i]) || !ReadValue(i_pEncodedData, i_EncodedSize, offset, layerMax[i]))
+		{
+			ERR("Invalid encoded frame!");
+			return false;
+		}
+	}
+
+	m_QuantizedData.resize(count * 4);
+	m_PredictedData.resize(count * 4);
+
+	if (!DecodeResiduals(i_pEncodedData + offset, i_EncodedSize - offset, &m_QuantizedData[0], m_QuantizedData.size()))
+	{
+		ERR("Invalid encoded frame residuals!");
+		return false;
+	}
+
+	m_MaxError = glm::vec4(0.0f);
+
+	for (unsigned short i = 0; i < i_LayerCount; ++i)
+	{
+		size_t layerOffset = i * i_LayerSize;
+
+		glm::vec4 scale(0.0f), step(0.0f);
+		ComputeScaleAndStep(layerMin[i], layerMax[i], scale, step);
+
+		if (!isKeyFrame)
+		{
+			Quantize(&m_PreviousFrame[layerOffset], i_LayerSize, layerMin[i], scale, &m_PredictedData[layerOffset * 4]);
+		}
+
+		// undo the zig-zag mapping and the prediction
+		for (size_t j = layerOffset * 4; j < (layerOffset + i_LayerSize) * 4; ++j)
+		{
+			unsigned int residual = m_QuantizedData[j];
+			int delta = static_cast<int>(residual >> 1) ^ -static_cast<int>(residual & 1);
+
+			m_QuantizedData[j] = static_cast<unsigned int>((isKeyFrame ? 0 : static_cast<int>(m_PredictedData[j])) + delta);
+		}
+
+		Dequantize(&m_QuantizedData[layerOffset * 4], i_LayerSize, layerMin[i], step, o_pData + layerOffset);
+
+		m_MaxError = glm::max(m_MaxError, ComputeMaxError(layerMin[i], layerMax[i], step));
+	}
+
+	m_PreviousFrame.resize(count);
+	std::copy(o_pData, o_pData + count, m_PreviousFrame.begin());
+
+	return true;
+}
+
+void DisplacementCodec::ComputeMinMax ( const glm::vec4* i_pData, size_t i_Count, glm::vec4& o_Min, glm::vec4& o_Max ) const
+{
+	if (i_Count == 0)
+	{
+		o_Min = o_Max = glm::vec4(0.0f);
+		return;
+	}
+
+#ifdef USE_SSE2
+	__m128 min = _mm_loadu_ps(&i_pData[0].x);
+	__m128 max = min;
+
+	for (size_t i = 1; i < i_Count; ++i)
+	{
+		__m128 value = _mm_loadu_ps(&i_pData[i].x);
+		min = _mm_min_ps(min, value);
+		max = _mm_max_ps(max, value);
+	}
+
+	_mm_storeu_ps(&o_Min.x, min);
+	_mm_storeu_ps(&o_Max.x, max);
+#else
+	o_Min = o_Max = i_pData[0];
+
+	for (size_t i = 1; i < i_Count; ++i)
+	{
+		o_Min = glm::min(o_Min, i_pData[i]);
+		o_Max = glm::max(o_Max, i_pData[i]);
+	}
+#endif // USE_SSE2
+}
+
+void DisplacementCodec::ComputeScaleAndStep ( const glm::vec4& i_Min, const glm::vec4& i_Max, glm::vec4& o_Scale, glm::vec4& o_Step ) const
+{
+	float maxQuantizedValue = static_cast<float>(m_MaxQuantizedValue);
+
+	for (unsigned short i = 0; i < 4; ++i)
+	{
+		float range = i_Max[i] - i_Min[i];
+
+		// constant channel - all the values are quantized to 0
+		o_Scale[i] = (range > 0.0f ? maxQuantizedValue / range : 0.0f);
+		o_Step[i] = range / maxQuantizedValue;
+	}
+}
+
+// half of the quantization step + the float rounding of the quantization/dequantization math
+glm::vec4 DisplacementCodec::ComputeMaxError ( const glm::vec4& i_Min, const glm::vec4& i_Max, const glm::vec4& i_Step ) const
+{
+	glm::vec4 magnitude = glm::max(glm::abs(i_Min), glm::abs(i_Max));
+
+	return i_Step * 0.5f + (i_Max - i_Min + magnitude) * kRoundingError;
+}
+
+void DisplacementCodec::Quantize ( const glm::vec4* i_pData, size_t i_Count, const glm::vec4& i_Min, const glm::vec4& i_Scale, unsigned int* o_pQuantizedData ) const
+{
+	float maxQuantizedValue = static_cast<float>(m_MaxQuantizedValue);
+
+#ifdef USE_SSE2
+	const __m128 kMin = _mm_loadu_ps(&i_Min.x);
+	const __m128 kScale = _mm_loadu_ps(&i_Scale.x);
+	const __m128 kHalf = _mm_set1_ps(0.5f);
+	const __m128 kZero = _mm_setzero_ps();
+	const __m128 kMaxQuantizedValue = _mm_set1_ps(maxQuantizedValue);
+
+	for (size_t i = 0; i < i_Count; ++i)
+	{
+		__m128 value = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&i_pData[i].x), kMin), kScale), kHalf);
+		// values from the previous frame might be out of the current range
+		value = _mm_min_ps(_mm_max_ps(value, kZero), kMaxQuantizedValue);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(o_pQuantizedData + 4 * i), _mm_cvttps_epi32(value));
+	}
+#else
+	for (size_t i = 0; i < i_Count; ++i)
+	{
+		glm::vec4 value = glm::clamp((i_pData[i] - i_Min) * i_Scale + 0.5f, 0.0f, maxQuantizedValue);
+
+		o_pQuantizedData[4 * i] = static_cast<unsigned int>(value.x);
+		o_pQuantizedData[4 * i + 1] = static_cast<unsigned int>(value.y);
+		o_pQuantizedData[4 * i + 2] = static_cast<unsigned int>(value.z);
+		o_pQuantizedData[4 * i + 3] = static_cast<unsigned int>(value.w);
+	}
+#endif // USE_SSE2
+}
+
+void DisplacementCodec::Dequantize ( const unsigned int* i_pQuantizedData, size_t i_Count, const glm::vec4& i_Min, const glm::vec4& i_Step, glm::vec4* o_pData ) const
+{
+#ifdef USE_SSE2
+	const __m128 kMin = _mm_loadu_ps(&i_Min.x);
+	const __m128 kStep = _mm_loadu_ps(&i_Step.x);
+
+	for (size_t i = 0; i < i_Count; ++i)
+	{
+		__m128 value = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(i_pQuantizedData + 4 * i)));
+
+		_mm_storeu_ps(&o_pData[i].x, _mm_add_ps(_mm_mul_ps(value, kStep), kMin));
+	}
+#else
+	for (size_t i = 0; i < i_Count; ++i)
+	{
+		glm::vec4 value(static_cast<float>(i_pQuantizedData[4 * i]), static_cast<float>(i_pQuantizedData[4 * i + 1]), static_cast<float>(i_pQuantizedData[4 * i + 2]), static_cast<float>(i_pQuantizedData[4 * i + 3]));
+
+		o_pData[i] = value * i_Step + i_Min;
+	}
+#endif // USE_SSE2
+}
+
+// Rice coding: quotient in unary, remainder in k bits, k is chosen for every block from the mean residual
+void DisplacementCodec::EncodeResiduals ( const unsigned int* i_pResiduals, size_t i_Count, std::vector<unsigned char>& o_EncodedData ) const
+{
+	BitWriter writer(o_EncodedData);
+
+	for (size_t blockStart = 0; blockStart < i_Count; blockStart += m_kBlockSize)
+	{
+		size_t blockEnd = glm::min(blockStart + m_kBlockSize, i_Count);
+
+		glm::uint64 sum = 0;
+		for (size_t i = blockStart; i < blockEnd; ++i)
+		{
+			sum += i_pResiduals[i];
+		}
+
+		glm::uint64 mean = sum / (blockEnd - blockStart);
+
+		unsigned short k = 0;
+		while (k < 24 && (static_cast<glm::uint64>(1) << (k + 1)) <= mean)
+		{
+			++ k;
+		}
+
+		writer.Write(k, 5);
+
+		for (size_t i = blockStart; i < blockEnd; ++i)
+		{
+			unsigned int quotient = i_pResiduals[i] >> k;
+
+			if (quotient < kEscapeQuotient)
+			{
+				// quotient ones followed by a zero
+				writer.Write((1u << quotient) - 1, quotient + 1);
+				writer.Write(i_pResiduals[i] & ((1u << k) - 1), k);
+			}
+			else
+			{
+				writer.Write((1u << kEscapeQuotient) - 1, kEscapeQuotient);
+				writer.Write(i_pResiduals[i], 32);
+			}
+		}
+	}
+
+	writer.Flush();
+}
+
+bool DisplacementCodec::DecodeResiduals ( const unsigned char* i_pEncodedData, size_t i_EncodedSize, unsigned int* o_pResiduals, size_t i_Count ) const
+{
+	BitReader reader(i_pEncodedData, i_EncodedSize);
+
+	for (size_t blockStart = 0; blockStart < i_Count; blockStart += m_kBlockSize)
+	{
+		size_t blockEnd = glm::min(blockStart + m_kBlockSize, i_Count);
+
+		unsigned int k = 0;
+		if (!reader.Read(5, k))
+		{
+			return false;
+		}
+
+		for (size_t i = blockStart; i < blockEnd; ++i)
+		{
+			if (!reader.ReadRice(static_cast<unsigned short>(k), o_pResiduals[i]))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+const glm::vec4& DisplacementCodec::GetMaxError ( void ) const
+{
+	return m_MaxError;
+}
+
+unsigned short DisplacementCodec::GetQuantizationBits ( void ) const
+{
+	return m_QuantizationBits;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef DISPLACEMENT_CODEC_H
+#define DISPLACEMENT_CODEC_H
+
+#include "glm/vec4.hpp"
+#include <vector>
+#include <cstddef>
+
+/*
+ Compact codec for the FFT ocean displacement/slopes frames (FFTSize * FFTSize rgba floats per layer)
+ The frame layout is the one used by CPUFFTW2DIFFT: layer after layer
+
+ Encoding steps:
+ 1. quantization to 16 or 12 bits using the per frame min/max of every layer channel (SSE if available)
+ 2. prediction from the previous decoded frame (delta coding), except for the key frames
+ 3. entropy coding of the residuals: zig-zag mapping + Rice coding with an adaptive parameter per block
+
+ The max absolute error of a decoded value is half of the quantization step: (max - min) / (2^bits - 1) / 2, plus a few float ulps
+ tools/DisplacementCodecBenchmark checks the round trip against this bound
+ NOTE! The decoder must receive all the frames since the last key frame, in order
+*/
+
+class DisplacementCodec
+{
+public:
+	DisplacementCodec(void);
+	DisplacementCodec(unsigned short i_QuantizationBits, unsigned short i_KeyFrameInterval);
+	~DisplacementCodec(void);
+
+	void Initialize(unsigned short i_QuantizationBits, unsigned short i_KeyFrameInterval);
+
+	// the next frame is encoded as a key frame
+	void Reset(void);
+
+	void EncodeFrame(const glm::vec4* i_pData, unsigned short i_LayerCount, size_t i_LayerSize, std::vector<unsigned char>& o_EncodedData);
+	bool DecodeFrame(const unsigned char* i_pEncodedData, size_t i_EncodedSize, glm::vec4* o_pData, unsigned short i_LayerCount, size_t i_LayerSize);
+
+	// max absolute error per channel of the last encoded/decoded frame
+	const glm::vec4& GetMaxError(void) const;
+
+	unsigned short GetQuantizationBits(void) const;
+
+private:
+	//// Methods ////
+	void Destroy(void);
+
+	void ComputeMinMax(const glm::vec4* i_pData, size_t i_Count, glm::vec4& o_Min, glm::vec4& o_Max) const;
+	void Quantize(const glm::vec4* i_pData, size_t i_Count, const glm::vec4& i_Min, const glm::vec4& i_Scale, unsigned int* o_pQuantizedData) const;
+	void Dequantize(const unsigned int* i_pQuantizedData, size_t i_Count, const glm::vec4& i_Min, const glm::vec4& i_Step, glm::vec4* o_pData) const;
+
+	void ComputeScaleAndStep(const glm::vec4& i_Min, const glm::vec4& i_Max, glm::vec4& o_Scale, glm::vec4& o_Step) const;
+	glm::vec4 ComputeMaxError(const glm::vec4& i_Min, const glm::vec4& i_Max, const glm::vec4& i_Step) const;
+
+	void EncodeResiduals(const unsigned int* i_pResiduals, size_t i_Count, std::vector<unsigned char>& o_EncodedData) const;
+	bool DecodeResiduals(const unsigned char* i_pEncodedData, size_t i_EncodedSize, unsigned int* o_pResiduals, size_t i_Count) const;
+
+	///// statics
+	// number of residuals sharing the same Rice parameter
+	static const unsigned short m_kBlockSize = 64;
+
+	//// Variables ////
+	unsigned short m_QuantizationBits;
+	unsigned int m_MaxQuantizedValue;
+
+	unsigned short m_KeyFrameInterval;
+	unsigned short m_FramesSinceKeyFrame;
+
+	// previous decoded frame, used for prediction (both encoder and decoder keep it, so they stay in sync)
+	std::vector<glm::vec4> m_PreviousFrame;
+
+	std::vector<unsigned int> m_QuantizedData;
+	std::vector<unsigned int> m_PredictedData;
+
+	glm::vec4 m_MaxError;
+};
+
+#endif /* DISPLACEMENT_CODEC_H */
\ No newline at end of file
@@ -80,6 +80,8 @@ void FFTNormalGradientFoldingGPUComp::ComputeNormalGradientFolding (void)
 
 	// Make sure, all values are written.
 	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+	m_TM.MarkMipMapsDirty(m_TexId);
 }
 
 
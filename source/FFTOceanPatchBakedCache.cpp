@@ -0,0 +1,407 @@
+/* Author: BAIRAC MIHAI */
+
+#include "FFTOceanPatchBakedCache.h"
+#include "CommonHeaders.h"
+#include "GLConfig.h"
+// glm::vec2, glm::vec4 come from the header
+#include "glm/common.hpp" //mod(), floor(), ceil(), mix(), max()
+#include "FileUtils.h"
+#include "GlobalConfig.h"
+#include "FFTOceanPatchGPUFrag.h"
+#include "FFTOceanPatchGPUComp.h"
+#include "FFTOceanPatchCPUFFTW.h"
+#include "FFTNormalGradientFoldingBase.h"
+#include "SDL/SDL_rwops.h"
+#include <cstring> // std::memcpy(), std::memset(), std::memcmp()
+#include <cassert>
+
+
+namespace
+{
+	// IEEE 754 half float to float, the bits are copied with memcpy (no type punning, so no strict aliasing issues)
+	float HalfToFloat ( unsigned short i_Half )
+	{
+		unsigned int sign = static_cast<unsigned int>(i_Half & 0x8000u) << 16;
+		unsigned int exponent = (i_Half >> 10) & 0x1Fu;
+		unsigned int mantissa = i_Half & 0x3FFu;
+
+		unsigned int bits = sign;
+
+		if (exponent == 0x1Fu)
+		{
+			// inf, nan
+			bits |= 0x7F800000u | (mantissa << 13);
+		}
+		else if (exponent != 0)
+		{
+			// the exponent bias is 15 for half floats, 127 for floats
+			bits |= ((exponent + 112) << 23) | (mantissa << 13);
+		}
+		else if (mantissa != 0)
+		{
+			// a denormalized half float is a normalized float
+			exponent = 113;
+			while ((mantissa & 0x400u) == 0)
+			{
+				mantissa <<= 1;
+				-- exponent;
+			}
+
+			bits |= (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+		}
+
+		float value = 0.0f;
+		std::memcpy(&value, &bits, sizeof(float));
+
+		return value;
+	}
+
+	inline glm::vec4 UnpackHalf4 ( const unsigned short* i_pHalf )
+	{
+		return glm::vec4(HalfToFloat(i_pHalf[0]), HalfToFloat(i_pHalf[1]), HalfToFloat(i_pHalf[2]), HalfToFloat(i_pHalf[3]));
+	}
+}
+
+FFTOceanPatchBakedCache::FFTOceanPatchBakedCache ( void )
+	: m_UseInterpolation(false), m_FFTLayerCount(0), m_FrameCount(0), m_CrrFrameIndex(0),
+	  m_FFTFrameSize(0), m_NormalGradientFoldingFrameSize(0),
+	  m_FFTDataTexId(0), m_NormalGradientFoldingTexId(0)
+{
+	std::memset(&m_ExpectedHeader, 0, sizeof(CacheHeader));
+
+	LOG("FFTOceanPatchBakedCache successfully created!");
+}
+
+FFTOceanPatchBakedCache::FFTOceanPatchBakedCache ( const GlobalConfig& i_Config )
+	: m_UseInterpolation(false), m_FFTLayerCount(0), m_FrameCount(0), m_CrrFrameIndex(0),
+	  m_FFTFrameSize(0), m_NormalGradientFoldingFrameSize(0),
+	  m_FFTDataTexId(0), m_NormalGradientFoldingTexId(0)
+{
+	std::memset(&m_ExpectedHeader, 0, sizeof(CacheHeader));
+
+	Initialize(i_Config);
+}
+
+FFTOceanPatchBakedCache::~FFTOceanPatchBakedCache ( void )
+{
+	Destroy();
+}
+
+void FFTOceanPatchBakedCache::Destroy ( void )
+{
+	m_CacheFile.Close();
+
+	LOG("FFTOceanPatchBakedCache successfully destroyed!");
+}
+
+void FFTOceanPatchBakedCache::Initialize ( const GlobalConfig& i_Config )
+{
+	FFTOceanPatchBase::Initialize(i_Config);
+
+	// the normal gradients and folding are baked in the cache, so there is nothing to compute at runtime
+	SAFE_DELETE(m_pNormalGradientFolding);
+
+	// the base path may be read only, the cache is saved to the user application data folder
+	m_CacheFileName = FileUtils::GetCachePath(i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.BakedCache.FileName);
+	m_UseInterpolation = i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.BakedCache.UseInterpolation;
+
+	// NOTE! for FFT slopes we need 2 layers, otherwise only 1 is needed!
+	m_FFTLayerCount = (i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.UseFFTSlopes ? 2 : 1);
+
+	float frameRate = i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.BakedCache.FrameRate;
+	if (frameRate <= 0.0f)
+	{
+		ERR("Invalid baked cache frame rate!");
+		frameRate = 1.0f;
+	}
+
+	// one dispersion frequency time period is enough, because the animation loops after it
+	m_FrameCount = glm::max(1u, static_cast<unsigned int>(glm::ceil(m_DispersionFrequencyTimePeriod * frameRate)));
+
+	// rgba half floats
+	m_FFTFrameSize = static_cast<size_t>(m_FFTSize) * m_FFTSize * 4 * m_FFTLayerCount;
+	m_NormalGradientFoldingFrameSize = static_cast<size_t>(m_FFTSize) * m_FFTSize * 4;
+
+	//////// Cache header //////
+	static_assert(sizeof(CacheHeader) % 8 == 0, "The cache header size must be a multiple of 8 bytes!");
+
+	std::memset(&m_ExpectedHeader, 0, sizeof(CacheHeader));
+	std::memcpy(m_ExpectedHeader.magic, "OFFT", 4);
+	m_ExpectedHeader.version = m_kCacheVersion;
+	m_ExpectedHeader.fftSize = m_FFTSize;
+	m_ExpectedHeader.fftLayerCount = m_FFTLayerCount;
+	m_ExpectedHeader.frameCount = m_FrameCount;
+	m_ExpectedHeader.timePeriod = m_DispersionFrequencyTimePeriod;
+	m_ExpectedHeader.patchSize = m_PatchSize;
+	m_ExpectedHeader.spectrumType = static_cast<unsigned int>(m_SpectrumType);
+	m_ExpectedHeader.waveAmplitude = m_WaveAmplitude;
+	m_ExpectedHeader.windSpeed = m_WindSpeed;
+	m_ExpectedHeader.windDirectionX = m_WindDirection.x;
+	m_ExpectedHeader.windDirectionZ = m_WindDirection.y;
+	m_ExpectedHeader.opposingWavesFactor = m_OpposingWavesFactor;
+	m_ExpectedHeader.verySmallWavesFactor = m_VerySmallWavesFactor;
+	m_ExpectedHeader.seaState = m_SeaState;
+	m_ExpectedHeader.minimumPhaseSpeed = m_MinimumPhaseSpeed;
+	m_ExpectedHeader.secondaryGravityCapillaryPeak = m_SecondaryGravityCapillaryPeak;
+	m_ExpectedHeader.choppyScale = m_ChoppyScale;
+
+	if (!LoadCache())
+	{
+		LOG("Baking the ocean animation cache: %u frames!", m_FrameCount);
+
+		if (BakeCache(i_Config))
+		{
+			LoadCache();
+		}
+	}
+
+	//////// Textures //////
+	m_TM.Initialize("FFTOceanPatchBakedCache", i_Config);
+
+	// without interpolation the half float frames are uploaded directly from the mapped file
+	unsigned int dataType = (m_UseInterpolation ? GL_FLOAT : GL_HALF_FLOAT);
+
+	m_FFTDataTexId = m_TM.Create2DArrayTexture(m_FFTLayerCount, GL_RGBA16F, GL_RGBA, dataType, m_FFTSize, m_FFTSize, GL_REPEAT, GL_LINEAR, nullptr, i_Config.TexUnit.Ocean.FFTOceanPatchBakedCache.FFTMap, m_kMipmapCount);
+	// we need mipmaps for the folding factor that is used in simulating foam!
+	m_NormalGradientFoldingTexId = m_TM.Create2DTexture(GL_RGBA16F, GL_RGBA, dataType, m_FFTSize, m_FFTSize, GL_REPEAT, GL_LINEAR, nullptr, i_Config.TexUnit.Ocean.FFTNormalGradientFoldingBase.NormalGradientFoldingMap, m_kMipmapCount);
+
+	if (m_UseInterpolation)
+	{
+		m_FFTInterpolatedData.resize(m_FFTFrameSize / 4);
+		m_NormalGradientFoldingInterpolatedData.resize(m_NormalGradientFoldingFrameSize / 4);
+	}
+
+	// invalid index, so the first frame is always uploaded
+	m_CrrFrameIndex = m_FrameCount;
+
+	LOG("FFTOceanPatchBakedCache successfully created!");
+}
+
+bool FFTOceanPatchBakedCache::LoadCache ( void )
+{
+	if (!m_CacheFile.Open(m_CacheFileName))
+	{
+		return false;
+	}
+
+	size_t expectedSize = sizeof(CacheHeader) + static_cast<size_t>(m_FrameCount) * (m_FFTFrameSize + m_NormalGradientFoldingFrameSize) * sizeof(unsigned short);
+
+	if (m_CacheFile.GetSize() != expectedSize || std::memcmp(m_CacheFile.GetData(), &m_ExpectedHeader, sizeof(CacheHeader)) != 0)
+	{
+		LOG("The ocean animation cache %s is out of date!", m_CacheFileName.c_str());
+
+		m_CacheFile.Close();
+		return false;
+	}
+
+	LOG("The ocean animation cache %s successfully loaded!", m_CacheFileName.c_str());
+
+	return true;
+}
+
+bool FFTOceanPatchBakedCache::BakeCache ( const GlobalConfig& i_Config )
+{
+	FFTOceanPatchBase* pSourcePatch = nullptr;
+
+	switch (i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.BakedCache.BakeType)
+	{
+		case CustomTypes::Ocean::ComputeFFTType::CFT_GPU_FRAG:
+			pSourcePatch = new FFTOceanPatchGPUFrag(i_Config);
+			break;
+		case CustomTypes::Ocean::ComputeFFTType::CFT_GPU_COMP:
+			if (!i_Config.GLExtVars.IsComputeShaderSupported)
+			{
+				ERR("Compute shader extensions are required!");
+				return false;
+			}
+			pSourcePatch = new FFTOceanPatchGPUComp(i_Config);
+			break;
+		case CustomTypes::Ocean::ComputeFFTType::CFT_CPU_FFTW:
+			pSourcePatch = new FFTOceanPatchCPUFFTW(i_Config);
+			break;
+		case CustomTypes::Ocean::ComputeFFTType::CFT_BAKED_CACHE:
+		case CustomTypes::Ocean::ComputeFFTType::CFT_COUNT:
+		default: ERR("Invalid ocean bake compute fft type!");
+			return false;
+	}
+	assert(pSourcePatch != nullptr);
+
+	SDL_RWops* pF = SDL_RWFromFile(m_CacheFileName.c_str(), "wb");
+	if (!pF)
+	{
+		ERR("Failed to create %s file!", m_CacheFileName.c_str());
+		SAFE_DELETE(pSourcePatch);
+		return false;
+	}
+
+	bool isWriteOk = (SDL_RWwrite(pF, &m_ExpectedHeader, sizeof(CacheHeader), 1) == 1);
+
+	// NOTE! The source FFT texture might have more layers than we need (e.g. GPU implementations),
+	// so only the first m_FFTLayerCount layers are saved
+	std::vector<unsigned short> fftData;
+	std::vector<unsigned short> normalGradientFoldingData(m_NormalGradientFoldingFrameSize);
+
+	float frameTimeStep = m_DispersionFrequencyTimePeriod / m_FrameCount;
+
+	for (unsigned int i = 0; i < m_FrameCount && isWriteOk; ++i)
+	{
+		pSourcePatch->EvaluateWaves(i * frameTimeStep);
+
+		pSourcePatch->BindFFTWaveDataTexture();
+		if (fftData.empty())
+		{
+			int sourceLayerCount = 0;
+			glGetTexLevelParameteriv(GL_TEXTURE_2D_ARRAY, 0, GL_TEXTURE_DEPTH, &sourceLayerCount);
+
+			fftData.resize(static_cast<size_t>(m_FFTSize) * m_FFTSize * 4 * glm::max(sourceLayerCount, static_cast<int>(m_FFTLayerCount)));
+		}
+		glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, GL_HALF_FLOAT, &fftData[0]);
+
+		pSourcePatch->BindNormalFoldingTexture();
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_HALF_FLOAT, &normalGradientFoldingData[0]);
+
+		isWriteOk = (SDL_RWwrite(pF, &fftData[0], sizeof(unsigned short), m_FFTFrameSize) == m_FFTFrameSize) &&
+					(SDL_RWwrite(pF, &normalGradientFoldingData[0], sizeof(unsigned short), m_NormalGradientFoldingFrameSize) == m_NormalGradientFoldingFrameSize);
+
+		if ((i + 1) % 100 == 0)
+		{
+			LOG("Baked %u of %u ocean animation frames!", i + 1, m_FrameCount);
+		}
+	}
+
+	SDL_RWclose(pF);
+
+	SAFE_DELETE(pSourcePatch);
+
+	if (!isWriteOk)
+	{
+		ERR("Failed to write %s file!", m_CacheFileName.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+void FFTOceanPatchBakedCache::SetFFTData ( void )
+{
+	// the frames are precomputed, the new parameters are used only after the cache is baked again (next run)
+	LOG("Ocean patch parameter changes require the animation cache to be baked again!");
+}
+
+const unsigned short* FFTOceanPatchBakedCache::GetFrameFFTData ( unsigned int i_FrameIndex ) const
+{
+	const unsigned char* pFrameData = m_CacheFile.GetData() + sizeof(CacheHeader) + static_cast<size_t>(i_FrameIndex) * (m_FFTFrameSize + m_NormalGradientFoldingFrameSize) * sizeof(unsigned short);
+
+	return reinterpret_cast<const unsigned short*>(pFrameData);
+}
+
+const unsigned short* FFTOceanPatchBakedCache::GetFrameNormalGradientFoldingData ( unsigned int i_FrameIndex ) const
+{
+	return GetFrameFFTData(i_FrameIndex) + m_FFTFrameSize;
+}
+
+void FFTOceanPatchBakedCache::InterpolateFrames ( const unsigned short* i_pFrameData, const unsigned short* i_pNextFrameData, float i_Factor, std::vector<glm::vec4>& o_Data ) const
+{
+	// 4 half floats per texel
+	for (size_t i = 0; i < o_Data.size(); ++i)
+	{
+		o_Data[i] = glm::mix(UnpackHalf4(i_pFrameData + 4 * i), UnpackHalf4(i_pNextFrameData + 4 * i), i_Factor);
+	}
+}
+
+void FFTOceanPatchBakedCache::EvaluateWaves ( float i_CrrTime )
+{
+	if (!m_CacheFile.IsOpen())
+	{
+		return;
+	}
+
+	// the animation loops after one dispersion frequency time period
+	float frameTime = glm::mod(i_CrrTime, m_DispersionFrequencyTimePeriod) / m_DispersionFrequencyTimePeriod * m_FrameCount;
+	unsigned int frameIndex = static_cast<unsigned int>(frameTime) % m_FrameCount;
+
+	if (m_UseInterpolation)
+	{
+		// the last frame blends with the first one
+		unsigned int nextFrameIndex = (frameIndex + 1) % m_FrameCount;
+		float factor = frameTime - glm::floor(frameTime);
+
+		InterpolateFrames(GetFrameFFTData(frameIndex), GetFrameFFTData(nextFrameIndex), factor, m_FFTInterpolatedData);
+		InterpolateFrames(GetFrameNormalGradientFoldingData(frameIndex), GetFrameNormalGradientFoldingData(nextFrameIndex), factor, m_NormalGradientFoldingInterpolatedData);
+
+		m_TM.Update2DArrayTextureData(m_FFTDataTexId, &m_FFTInterpolatedData[0]);
+		m_TM.Update2DTextureData(m_NormalGradientFoldingTexId, &m_NormalGradientFoldingInterpolatedData[0]);
+	}
+	else if (frameIndex != m_CrrFrameIndex)
+	{
+		// the data is only read by GL
+		m_TM.Update2DArrayTextureData(m_FFTDataTexId, const_cast<unsigned short*>(GetFrameFFTData(frameIndex)));
+		m_TM.Update2DTextureData(m_NormalGradientFoldingTexId, const_cast<unsigned short*>(GetFrameNormalGradientFoldingData(frameIndex)));
+	}
+
+	m_CrrFrameIndex = frameIndex;
+}
+
+float FFTOceanPatchBakedCache::ComputeWaterHeightAt ( const glm::vec2& i_XZ ) const
+{
+	float waterHeight = 0.0f;
+
+	if (m_CacheFile.IsOpen() && m_CrrFrameIndex < m_FrameCount)
+	{
+		//// no need to read back the texture, the displacement (layer 0) is available in the mapped file
+		const unsigned short* pFFTData = GetFrameFFTData(m_CrrFrameIndex);
+
+		// Convert coords from world-space to data-space
+		int xINT = static_cast<int>(glm::floor(i_XZ.x)),
+			zINT = static_cast<int>(glm::floor(i_XZ.y));
+
+		// Calculate interpolation coefficients
+		float xDIFF = i_XZ.x - xINT,
+			  zDIFF = i_XZ.y - zINT;
+
+		// the data is wrapped, so make sure the data-space coords are positive
+		int x0 = (xINT % m_FFTSize + m_FFTSize) % m_FFTSize,
+			z0 = (zINT % m_FFTSize + m_FFTSize) % m_FFTSize,
+			x1 = (x0 + 1) % m_FFTSize,
+			z1 = (z0 + 1) % m_FFTSize;
+
+		// the data is an array of half floats groups as xyzw values
+		const int k_stride = 4;
+		const int k_yOffset = 1; // y - has offset 1, because x offset = 0, z offset = 2, w offset = 3
+
+		//   A      B
+		//
+		//
+		//   C      D
+		//interpolate among 4 adjacent neighbors
+		float heightA = HalfToFloat(pFFTData[k_stride * (z0 * m_FFTSize + x0) + k_yOffset]),
+			  heightB = HalfToFloat(pFFTData[k_stride * (z0 * m_FFTSize + x1) + k_yOffset]),
+			  heightC = HalfToFloat(pFFTData[k_stride * (z1 * m_FFTSize + x0) + k_yOffset]),
+			  heightD = HalfToFloat(pFFTData[k_stride * (z1 * m_FFTSize + x1) + k_yOffset]);
+
+		waterHeight = glm::mix(glm::mix(heightA, heightB, xDIFF), glm::mix(heightC, heightD, xDIFF), zDIFF);
+	}
+
+	return waterHeight;
+}
+
+void FFTOceanPatchBakedCache::BindFFTWaveDataTexture ( void ) const
+{
+	m_TM.BindTexture(m_FFTDataTexId, true);
+}
+
+void FFTOceanPatchBakedCache::BindNormalFoldingTexture ( void ) const
+{
+	// as explained in the init function we need mipmaps for the folding factor that is used in simulating foam!
+	m_TM.BindTexture(m_NormalGradientFoldingTexId, true);
+}
+
+unsigned short FFTOceanPatchBakedCache::GetFFTWaveDataTexUnitId ( void ) const
+{
+	return m_TM.GetTextureUnitId(0);
+}
+
+unsigned short FFTOceanPatchBakedCache::GetNormalGradientFoldingTexUnitId ( void ) const
+{
+	return m_TM.GetTextureUnitId(1);
+}
\ No newline at end of file
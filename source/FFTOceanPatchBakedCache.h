@@ -0,0 +1,117 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef FFT_OCEAN_PATCH_BAKED_CACHE_H
+#define FFT_OCEAN_PATCH_BAKED_CACHE_H
+
+#include "FFTOceanPatchBase.h"
+#include "TextureManager.h"
+#include "MemoryMappedFile.h"
+//#define GLM_SWIZZLE //offers the possibility to use: .xx(), xy(), xyz(), ...
+#include "glm/vec2.hpp"
+#include "glm/vec4.hpp"
+#include <string>
+#include <vector>
+
+class GlobalConfig;
+
+/*
+ Playback of a precomputed (baked) FFT ocean patch animation
+
+ The dispersion frequencies are multiples of 2 * PI / DispersionFrequencyTimePeriod (check FFTOceanPatchBase::DispersionFrequency()),
+ so the ocean animation repeats itself exactly after DispersionFrequencyTimePeriod seconds.
+ One period of the displacement, slopes and normal gradients + folding maps is baked once at the given frame rate
+ using one of the other FFT ocean patch implementations and saved as half floats in a cache file (in the user application data folder).
+ At runtime the cache file is memory mapped and the frames are streamed to the textures (optionally interpolated in time)
+ No FFT is performed at runtime!
+
+ The cache is rebuilt automatically if it's missing or if the ocean patch parameters changed.
+ NOTE! The cache file size is: frame count * (FFT layer count + 1) * FFT size * FFT size * 8 bytes
+*/
+
+class FFTOceanPatchBakedCache : public FFTOceanPatchBase
+{
+public:
+	FFTOceanPatchBakedCache(void);
+	FFTOceanPatchBakedCache(const GlobalConfig& i_Config);
+	~FFTOceanPatchBakedCache(void);
+
+	void Initialize(const GlobalConfig& i_Config) override;
+
+	void EvaluateWaves(float i_CrrTime) override;
+
+	float ComputeWaterHeightAt(const glm::vec2& i_XZ) const override;
+
+	void BindFFTWaveDataTexture(void) const override;
+	void BindNormalFoldingTexture(void) const override;
+
+	unsigned short GetFFTWaveDataTexUnitId(void) const override;
+	unsigned short GetNormalGradientFoldingTexUnitId(void) const override;
+
+private:
+	//// Methods ////
+	void Destroy(void);
+
+	void SetFFTData(void) override;
+
+	bool BakeCache(const GlobalConfig& i_Config);
+	bool LoadCache(void);
+
+	const unsigned short* GetFrameFFTData(unsigned int i_FrameIndex) const;
+	const unsigned short* GetFrameNormalGradientFoldingData(unsigned int i_FrameIndex) const;
+
+	void InterpolateFrames(const unsigned short* i_pFrameData, const unsigned short* i_pNextFrameData, float i_Factor, std::vector<glm::vec4>& o_Data) const;
+
+	//// Variables ////
+
+	// NOTE! Plain data only, the header is written/compared as raw bytes
+	// The size must be a multiple of 8 bytes, so the frame data that follows is 64 bit aligned
+	struct CacheHeader
+	{
+		char magic[4];
+		unsigned int version;
+		unsigned int fftSize;
+		unsigned int fftLayerCount;
+		unsigned int frameCount;
+		float timePeriod;
+
+		// ocean patch parameters, used to check if the cache is up to date
+		unsigned int patchSize;
+		unsigned int spectrumType;
+		float waveAmplitude;
+		float windSpeed;
+		float windDirectionX;
+		float windDirectionZ;
+		float opposingWavesFactor;
+		float verySmallWavesFactor;
+		float seaState;
+		float minimumPhaseSpeed;
+		float secondaryGravityCapillaryPeak;
+		float choppyScale;
+	};
+
+	static const unsigned int m_kCacheVersion = 1;
+
+	std::string m_CacheFileName;
+
+	MemoryMappedFile m_CacheFile;
+	CacheHeader m_ExpectedHeader;
+
+	bool m_UseInterpolation;
+
+	unsigned short m_FFTLayerCount;
+	unsigned int m_FrameCount;
+	unsigned int m_CrrFrameIndex;
+
+	// number of half floats
+	size_t m_FFTFrameSize;
+	size_t m_NormalGradientFoldingFrameSize;
+
+	std::vector<glm::vec4> m_FFTInterpolatedData;
+	std::vector<glm::vec4> m_NormalGradientFoldingInterpolatedData;
+
+	TextureManager m_TM;
+	unsigned int m_FFTDataTexId;
+	unsigned int m_NormalGradientFoldingTexId;
+};
+
+#endif /* FFT_OCEAN_PATCH_BAKED_CACHE_H */
\ No newline at end of file
@@ -14,7 +14,7 @@ Unified - based on work by: Phillips, Donel, Pierson, Moskowitz, etc. - 1997
 #include "FFTOceanPatchBase.h"
 #include "CommonHeaders.h"
 // glm::vec2, glm::vec3 come from the header
-#include "glm/common.hpp" //floor()
+#include "glm/common.hpp" //floor(), round()
 #include "glm/gtc/constants.hpp" //two_pi()
 #include "glm/exponential.hpp" //exp(), pow(), log(), sqrt()
 #include "glm/trigonometric.hpp" //cos(), atan(), tanh()
@@ -24,27 +24,31 @@ Unified - based on work by: Phillips, Donel, Pierson, Moskowitz, etc. - 1997
 #include "FFTNormalGradientFoldingGPUFrag.h"
 #include "FFTNormalGradientFoldingGPUComp.h"
 
+// the inverse FFT isn't normalized, so the wave height variance is the sum of the spectrum over the wave vectors (Parseval).
+// The wave vectors are 2 * pi * n / PatchSize, a bigger FFT size only adds very small waves the spectrum damps anyway,
+// so one scale keeps the wave height for every FFT size (the patches swapped at runtime match the ones they replace)
+const float FFTOceanPatchBase::m_kPhillipsAmplitudeScale = 1e-6f;
 
 FFTOceanPatchBase::FFTOceanPatchBase ( void )
-	: m_WaveAmplitudeScale(0), m_FFTSize(0), m_PatchSize(0),
+	: m_FFTSize(0), m_PatchSize(0),
 	  m_WaveAmplitude(0.0f), m_WindSpeed(0.0f), m_DispersionFrequencyTimePeriod(0.0f),
 	  m_ChoppyScale(0.0f), m_TileScale(0.0f),
 	  m_OpposingWavesFactor(0.0f), m_VerySmallWavesFactor(0.0f),
 	  m_SeaState(0.0f), m_MinimumPhaseSpeed(0.0f), m_SecondaryGravityCapillaryPeak(0.0f),
 	  m_SpectrumType(CustomTypes::Ocean::SpectrumType::ST_COUNT),
-	  m_pNormalGradientFolding(nullptr)
+	  m_pNormalGradientFolding(nullptr), m_IsPrepared(false)
 {
 	LOG("FFTOceanPatchBase successfully created!");
 }
 
 FFTOceanPatchBase::FFTOceanPatchBase ( const GlobalConfig& i_Config )
-	: m_WaveAmplitudeScale(0), m_FFTSize(0), m_PatchSize(0),
+	: m_FFTSize(0), m_PatchSize(0),
 	  m_WaveAmplitude(0.0f), m_WindSpeed(0.0f), m_DispersionFrequencyTimePeriod(0.0f),
 	  m_ChoppyScale(0.0f), m_TileScale(0.0f),
 	  m_OpposingWavesFactor(0.0f), m_VerySmallWavesFactor(0.0f),
 	  m_SeaState(0.0f), m_MinimumPhaseSpeed(0.0f), m_SecondaryGravityCapillaryPeak(0.0f),
 	  m_SpectrumType(CustomTypes::Ocean::SpectrumType::ST_COUNT),
-	  m_pNormalGradientFolding(nullptr)
+	  m_pNormalGradientFolding(nullptr), m_IsPrepared(false)
 {
 	Initialize(i_Config);
 }
@@ -62,7 +66,7 @@ void FFTOceanPatchBase::Destroy ( void )
 	LOG("FFTOceanPatchBase successfully destroyed!");
 }
 
-void FFTOceanPatchBase::Initialize ( const GlobalConfig& i_Config )
+void FFTOceanPatchBase::Prepare ( const GlobalConfig& i_Config )
 {
 	m_FFTSize = i_Config.Scene.Ocean.Surface.OceanPatch.FFTSize;
 	m_PatchSize = i_Config.Scene.Ocean.Surface.OceanPatch.PatchSize;
@@ -82,21 +86,14 @@ void FFTOceanPatchBase::Initialize ( const GlobalConfig& i_Config )
 
 	m_SpectrumType = i_Config.Scene.Ocean.Surface.OceanPatch.Spectrum.Type;
 
-	switch(m_FFTSize)
+	m_IsPrepared = true;
+}
+
+void FFTOceanPatchBase::Initialize ( const GlobalConfig& i_Config )
+{
+	if (!m_IsPrepared)
 	{
-		case 1024:
-			m_WaveAmplitudeScale = 1e-7f;
-			break;
-		case 512:
-			m_WaveAmplitudeScale = 1e-6f;
-			break;
-		case 256:
-			m_WaveAmplitudeScale = 1e-6f;
-			break;
-		case 128:
-			m_WaveAmplitudeScale = 1e-5f;
-			break;
-		default: ERR("Invalid fft size!");
+		Prepare(i_Config);
 	}
 
 	/////////// NORMAL, FOLDING SETUP ///////////
@@ -123,7 +120,7 @@ void FFTOceanPatchBase::SetFFTData ( void )
 
 void FFTOceanPatchBase::InitFFTData ( void )
 {
-	srand(0);
+	//stub
 }
 
 float FFTOceanPatchBase::PhillipsSpectrum ( const glm::vec2& i_WaveVector )
@@ -144,7 +141,7 @@ float FFTOceanPatchBase::PhillipsSpectrum ( const glm::vec2& i_WaveVector )
 	// Ec. (23)
 	// A - amplitude, influences the wave height
 
-	float phillips = m_WaveAmplitude * m_WaveAmplitudeScale * glm::exp(-1.0f / (waveVectorSqr * L * L)) * (waveDotWind * waveDotWind) / (waveVectorSqr * waveVectorSqr);
+	float phillips = m_WaveAmplitude * m_kPhillipsAmplitudeScale * glm::exp(-1.0f / (waveVectorSqr * L * L)) * (waveDotWind * waveDotWind) / (waveVectorSqr * waveVectorSqr);
 
 	//Avoid division by zero
 	if (L == 0.0f || waveVectorSqr == 0.0f)
@@ -271,12 +268,27 @@ float FFTOceanPatchBase::Sqr ( float i_X )
 float FFTOceanPatchBase::UniformRandomVariable ( void )
 {
 	// generates a random number between 0.0f and 1.0f
-	return static_cast<float>(std::rand()) / RAND_MAX;
+	return static_cast<float>(m_RandomEngine() - std::minstd_rand::min()) / (std::minstd_rand::max() - std::minstd_rand::min());
 }
 
 // Gaussian random number generator with mean 0 and standard deviation 1
-glm::vec2 FFTOceanPatchBase::GaussianRandomVariable ( void )
-{
+glm::vec2 FFTOceanPatchBase::GaussianRandomVariable ( const glm::vec2& i_WaveVector )
+{
+	// The generator is seeded with the wave numbers (n, m) of the wave vector K = 2 * PI * (n, m) / PatchSize,
+	// so the same wave always gets the same amplitude and phase. The patches with different FFT sizes share the common waves
+	// and a rebuilt patch continues the old one without a visible jump. It also keeps the generator state per patch,
+	// so the spectrum can be computed on a worker thread.
+	float waveNumberScale = m_PatchSize / glm::two_pi<float>();
+	unsigned int n = static_cast<unsigned int>(static_cast<int>(glm::round(i_WaveVector.x * waveNumberScale)));
+	unsigned int m = static_cast<unsigned int>(static_cast<int>(glm::round(i_WaveVector.y * waveNumberScale)));
+
+	// murmur3 finalizer, so the neighbour waves get unrelated seeds
+	unsigned int seed = (n * 73856093u) ^ (m * 19349663u);
+	seed ^= seed >> 16; seed *= 0x85ebca6bu;
+	seed ^= seed >> 13; seed *= 0xc2b2ae35u;
+	seed ^= seed >> 16;
+	m_RandomEngine.seed(seed);
+
 	/* Keith Lantz implementation
 	check the source code:
 	https://www.keithlantz.net/2011/11/ocean-simulation-part-two-using-the-fast-fourier-transform/
@@ -286,7 +298,7 @@ glm::vec2 FFTOceanPatchBase::GaussianRandomVariable ( void )
 		x1 = 2.0f * UniformRandomVariable() - 1.0f;
 		x2 = 2.0f * UniformRandomVariable() - 1.0f;
 		w = x1 * x1 + x2 * x2;
-	} while (w >= 1.0f);
+	} while (w >= 1.0f || w == 0.0f);
 
 	w = glm::sqrt((-2.0f * glm::log(w)) / w);
 
@@ -338,6 +350,27 @@ unsigned short FFTOceanPatchBase::GetFFTWaveDataTexUnitId ( void ) const
 	return 0;
 }
 
+const glm::vec4* FFTOceanPatchBase::GetDisplacementData ( void ) const
+{
+	//stub
+	return nullptr;
+}
+
+unsigned short FFTOceanPatchBase::GetCascadeCount ( void ) const
+{
+	return 1;
+}
+
+glm::vec4 FFTOceanPatchBase::GetCascadeUVScales ( void ) const
+{
+	return glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void FFTOceanPatchBase::SetSharingEnabled ( bool i_IsSharingEnabled )
+{
+	//stub
+}
+
 unsigned short FFTOceanPatchBase::GetNormalGradientFoldingTexUnitId ( void ) const
 {
 	unsigned short val = 0;
@@ -15,8 +15,10 @@
 //#define GLM_SWIZZLE //offers the possibility to use: .xx(), xy(), xyz(), ...
 #include "glm/vec2.hpp" 
 #include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
 #include <string>
 #include <map>
+#include <random>
 
 class FFTNormalGradientFoldingBase;
 class GlobalConfig;
@@ -35,6 +37,9 @@ public:
 	FFTOceanPatchBase(const GlobalConfig& i_Config);
 	virtual ~FFTOceanPatchBase(void);
 
+	// CPU only part of Initialize(): the wave parameters, the spectrum and the FFT setup
+	// no GL calls, so it can run on a worker thread (check FFTOceanPatchBuilder), Initialize() calls it, if it wasn't called before
+	virtual void Prepare(const GlobalConfig& i_Config);
 	virtual void Initialize(const GlobalConfig& i_Config);
 
 	virtual void EvaluateWaves(float i_CrrTime);
@@ -47,6 +52,17 @@ public:
 	virtual unsigned short GetFFTWaveDataTexUnitId(void) const;
 	virtual unsigned short GetNormalGradientFoldingTexUnitId(void) const;
 
+	// CPU side FFT displacement (FFTSize * FFTSize xyz values), nullptr if the FFT data lives only on the GPU
+	virtual const glm::vec4* GetDisplacementData(void) const;
+
+	// the FFT wave data texture holds the layers of every cascade (only 1 cascade by default)
+	virtual unsigned short GetCascadeCount(void) const;
+	// the uv multiplier of every cascade, compared to the first one
+	virtual glm::vec4 GetCascadeUVScales(void) const;
+
+	// the waves evaluated outside of the simulation (e.g. the caustics bake) mustn't be shared with other processes
+	virtual void SetSharingEnabled(bool i_IsSharingEnabled);
+
 	virtual float GetWaveAmplitude(void) const;
 	virtual unsigned short GetPatchSize(void) const;
 	virtual float GetWindSpeed(void) const;
@@ -74,7 +90,7 @@ protected:
 	virtual void InitFFTData(void);
 
 	virtual float PhillipsSpectrum(const glm::vec2& i_WaveVector);
-	virtual glm::vec2 GaussianRandomVariable(void);
+	virtual glm::vec2 GaussianRandomVariable(const glm::vec2& i_WaveVector);
 
 	virtual float UnifiedSpectrum(const glm::vec2& i_WaveVector);
 	virtual float Omega(float i_K, float i_KM);
@@ -84,6 +100,8 @@ protected:
 
 	///// statics
 	static const unsigned short m_kMipmapCount = 3;
+	// scales the Phillips spectrum amplitude A, the same for every FFT size
+	static const float m_kPhillipsAmplitudeScale;
 
 	//// Variables ////
 	unsigned short m_FFTSize;
@@ -91,7 +109,6 @@ protected:
 
 	// General FFT Wave spectrum
 	float m_WaveAmplitude;
-	float m_WaveAmplitudeScale;
 	float m_WindSpeed;
 	glm::vec2 m_WindDirection;
 	float m_DispersionFrequencyTimePeriod;
@@ -111,10 +128,15 @@ protected:
 
 	FFTNormalGradientFoldingBase* m_pNormalGradientFolding;
 
+	bool m_IsPrepared;
+
 private:
 	void Destroy ( void );
 
 	float UniformRandomVariable ( void );
+
+	// seeded for every wave vector, check GaussianRandomVariable()
+	std::minstd_rand m_RandomEngine;
 };
 
 #endif /* FFT_OCEAN_PATCH_BASE_H */
\ No newline at end of file
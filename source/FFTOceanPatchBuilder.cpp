@@ -0,0 +1,191 @@
+/* Author: BAIRAC MIHAI */
+
+#include "FFTOceanPatchBuilder.h"
+#include "CommonHeaders.h"
+#include "GlobalConfig.h"
+#include "FFTOceanPatchGPUFrag.h"
+#include "FFTOceanPatchGPUComp.h"
+#include "FFTOceanPatchCPUFFTW.h"
+#include <sstream> // std::stringstream
+#include <utility> // std::swap()
+
+
+FFTOceanPatchBuilder::FFTOceanPatchBuilder ( void )
+	: m_pBaseConfig(nullptr), m_pBuildConfig(nullptr), m_pQueuedConfig(nullptr), m_HasQueuedBuild(false),
+	  m_pPatch(nullptr), m_IsPatchReady(false)
+{
+	LOG("FFTOceanPatchBuilder successfully created!");
+}
+
+FFTOceanPatchBuilder::FFTOceanPatchBuilder ( const GlobalConfig& i_Config )
+	: m_pBaseConfig(nullptr), m_pBuildConfig(nullptr), m_pQueuedConfig(nullptr), m_HasQueuedBuild(false),
+	  m_pPatch(nullptr), m_IsPatchReady(false)
+{
+	Initialize(i_Config);
+}
+
+FFTOceanPatchBuilder::~FFTOceanPatchBuilder ( void )
+{
+	Destroy();
+}
+
+void FFTOceanPatchBuilder::Destroy ( void )
+{
+	// the worker uses the patch and the build configuration
+	if (m_Thread.joinable())
+	{
+		m_Thread.join();
+	}
+
+	SAFE_DELETE(m_pPatch);
+
+	SAFE_DELETE(m_pBaseConfig);
+	SAFE_DELETE(m_pBuildConfig);
+	SAFE_DELETE(m_pQueuedConfig);
+
+	LOG("FFTOceanPatchBuilder successfully destroyed!");
+}
+
+void FFTOceanPatchBuilder::Initialize ( const GlobalConfig& i_Config )
+{
+	m_pBaseConfig = new GlobalConfig(i_Config);
+	assert(m_pBaseConfig != nullptr);
+
+	m_pBuildConfig = new GlobalConfig(i_Config);
+	assert(m_pBuildConfig != nullptr);
+
+	m_pQueuedConfig = new GlobalConfig(i_Config);
+	assert(m_pQueuedConfig != nullptr);
+
+	LOG("FFTOceanPatchBuilder successfully created!");
+}
+
+bool FFTOceanPatchBuilder::Start ( const FFTOceanPatchBase& i_CurrentPatch, unsigned short i_FFTSize, unsigned short i_PatchSize )
+{
+	if (!m_pBaseConfig)
+	{
+		return false;
+	}
+
+	// the baked frames have a fixed size
+	if (m_pBaseConfig->Scene.Ocean.Surface.OceanPatch.ComputeFFT.Type == CustomTypes::Ocean::ComputeFFTType::CFT_BAKED_CACHE)
+	{
+		return false;
+	}
+
+	// the worker might still read the build configuration
+	GlobalConfig& config = (m_Thread.joinable() ? *m_pQueuedConfig : *m_pBuildConfig);
+
+	config = *m_pBaseConfig;
+	config.Scene.Ocean.Surface.OceanPatch.FFTSize = i_FFTSize;
+	config.Scene.Ocean.Surface.OceanPatch.PatchSize = i_PatchSize;
+	config.Scene.Ocean.Surface.OceanPatch.WaveAmpltitude = i_CurrentPatch.GetWaveAmplitude();
+	config.Scene.Ocean.Surface.OceanPatch.WindSpeed = i_CurrentPatch.GetWindSpeed();
+	config.Scene.Ocean.Surface.OceanPatch.WindDirection = glm::vec2(i_CurrentPatch.GetWindDirectionX(), i_CurrentPatch.GetWindDirectionZ());
+	config.Scene.Ocean.Surface.OceanPatch.ChoppyScale = i_CurrentPatch.GetChoppyScale();
+	config.Scene.Ocean.Surface.OceanPatch.TileScale = i_CurrentPatch.GetTileScale();
+	config.Scene.Ocean.Surface.OceanPatch.Spectrum.Phillips.OpposingWavesFactor = i_CurrentPatch.GetOpposingWavesFactor();
+	config.Scene.Ocean.Surface.OceanPatch.Spectrum.Phillips.VerySmallWavesFactor = i_CurrentPatch.GetVerySmallWavesFactor();
+
+	// the compute shaders FFT is unrolled for the FFT size (check GlobalConfig)
+	std::stringstream ss;
+	ss << "#define FFT_SIZE " << i_FFTSize << "\n";
+	config.ShaderDefines.Ocean.Surface.FFTSize = ss.str();
+
+	if (m_Thread.joinable())
+	{
+		// built after the current one
+		m_HasQueuedBuild = true;
+	}
+	else
+	{
+		StartThread();
+	}
+
+	return true;
+}
+
+void FFTOceanPatchBuilder::StartThread ( void )
+{
+	switch (m_pBuildConfig->Scene.Ocean.Surface.OceanPatch.ComputeFFT.Type)
+	{
+		case CustomTypes::Ocean::ComputeFFTType::CFT_GPU_FRAG:
+			m_pPatch = new FFTOceanPatchGPUFrag();
+			break;
+		case CustomTypes::Ocean::ComputeFFTType::CFT_GPU_COMP:
+			m_pPatch = new FFTOceanPatchGPUComp();
+			break;
+		case CustomTypes::Ocean::ComputeFFTType::CFT_CPU_FFTW:
+			m_pPatch = new FFTOceanPatchCPUFFTW();
+			break;
+		case CustomTypes::Ocean::ComputeFFTType::CFT_BAKED_CACHE:
+		case CustomTypes::Ocean::ComputeFFTType::CFT_COUNT:
+		default: ERR("Invalid ocean compute fft type!");
+	}
+	assert(m_pPatch != nullptr);
+
+	m_IsPatchReady = false;
+	m_StartTime = std::chrono::steady_clock::now();
+
+	m_Thread = std::thread(&FFTOceanPatchBuilder::Build, this);
+}
+
+void FFTOceanPatchBuilder::Build ( void )
+{
+	m_pPatch->Prepare(*m_pBuildConfig);
+
+	m_IsPatchReady = true;
+}
+
+FFTOceanPatchBase* FFTOceanPatchBuilder::Update ( void )
+{
+	if (!m_Thread.joinable() || !m_IsPatchReady)
+	{
+		return nullptr;
+	}
+
+	m_Thread.join();
+
+	if (m_HasQueuedBuild)
+	{
+		// outdated, the destruction is safe here, the worker is done with the FFTW planner
+		SAFE_DELETE(m_pPatch);
+
+		std::swap(m_pBuildConfig, m_pQueuedConfig);
+		m_HasQueuedBuild = false;
+
+		StartThread();
+
+		return nullptr;
+	}
+
+	// the GL resources
+	m_pPatch->Initialize(*m_pBuildConfig);
+
+	FFTOceanPatchBase* pPatch = m_pPatch;
+	m_pPatch = nullptr;
+
+	float buildTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_StartTime).count();
+	LOG("FFTOceanPatchBuilder - FFT size %u, patch size %u built in %.1f ms!", GetFFTSize(), GetPatchSize(), buildTime);
+
+	return pPatch;
+}
+
+bool FFTOceanPatchBuilder::IsBuilding ( void ) const
+{
+	return m_Thread.joinable();
+}
+
+unsigned short FFTOceanPatchBuilder::GetFFTSize ( void ) const
+{
+	const GlobalConfig* pConfig = (m_HasQueuedBuild ? m_pQueuedConfig : m_pBuildConfig);
+
+	return (pConfig ? pConfig->Scene.Ocean.Surface.OceanPatch.FFTSize : 0);
+}
+
+unsigned short FFTOceanPatchBuilder::GetPatchSize ( void ) const
+{
+	const GlobalConfig* pConfig = (m_HasQueuedBuild ? m_pQueuedConfig : m_pBuildConfig);
+
+	return (pConfig ? pConfig->Scene.Ocean.Surface.OceanPatch.PatchSize : 0);
+}
\ No newline at end of file
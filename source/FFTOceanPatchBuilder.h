@@ -0,0 +1,76 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef FFT_OCEAN_PATCH_BUILDER_H
+#define FFT_OCEAN_PATCH_BUILDER_H
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+class FFTOceanPatchBase;
+class GlobalConfig;
+
+/*
+ Builds FFT ocean patches on a worker thread
+
+ Changing the FFT size or the patch size means a new patch: FFTW planning (FFTW_MEASURE), the spectrum data, the textures, ...
+ Done synchronously it stalls the rendering for hundreds of milliseconds.
+ The CPU part of the patch creation (check FFTOceanPatchBase::Prepare()) runs on a worker thread, while the old patch is still used.
+ The GL part needs the main thread (the only one with the GL context), so it's done by Update(), at the frame boundary,
+ right before the new patch replaces the old one.
+
+ The spectrum random numbers depend only on the wave numbers (check FFTOceanPatchBase::GaussianRandomVariable())
+ and the patches use the same simulation time, so the common waves of the old and the new patch are the same (no visible jump).
+
+ Only one patch is built at a time (the FFTW planner isn't thread safe). A request made while building is queued and
+ the patch being built is dropped. The baked cache patches can't be rebuilt (their frames have a fixed size).
+*/
+
+class FFTOceanPatchBuilder
+{
+public:
+	FFTOceanPatchBuilder(void);
+	FFTOceanPatchBuilder(const GlobalConfig& i_Config);
+	~FFTOceanPatchBuilder(void);
+
+	// i_Config - the base configuration of the built patches
+	void Initialize(const GlobalConfig& i_Config);
+
+	// starts building a patch, with the wave parameters of i_CurrentPatch (they might have been changed from the GUI)
+	// returns false if the patch type can't be rebuilt
+	bool Start(const FFTOceanPatchBase& i_CurrentPatch, unsigned short i_FFTSize, unsigned short i_PatchSize);
+
+	// main thread, once per frame
+	// returns the new patch (the caller owns it) when it's ready, nullptr otherwise
+	FFTOceanPatchBase* Update(void);
+
+	bool IsBuilding(void) const;
+
+	// the sizes of the last requested patch
+	unsigned short GetFFTSize(void) const;
+	unsigned short GetPatchSize(void) const;
+
+private:
+	//// Methods ////
+	void Destroy(void);
+
+	void StartThread(void);
+	// worker thread
+	void Build(void);
+
+	//// Variables ////
+	GlobalConfig* m_pBaseConfig;
+	// the configuration of the patch being built and of the queued one
+	GlobalConfig* m_pBuildConfig;
+	GlobalConfig* m_pQueuedConfig;
+	bool m_HasQueuedBuild;
+
+	FFTOceanPatchBase* m_pPatch;
+
+	std::thread m_Thread;
+	std::atomic<bool> m_IsPatchReady;
+
+	std::chrono::steady_clock::time_point m_StartTime;
+};
+
+#endif /* FFT_OCEAN_PATCH_BUILDER_H */
\ No newline at end of file
@@ -4,26 +4,28 @@
 #include "CommonHeaders.h"
 #include "GLConfig.h"
 // glm::vec2 comes from the header
-#include "glm/common.hpp" //abs()
+#include "glm/common.hpp" //abs(), max()
 #include "glm/geometric.hpp" //length()
-#include "glm/exponential.hpp" //sqrt()
+#include "glm/exponential.hpp" //sqrt(), pow()
 #include "glm/trigonometric.hpp" //sin(), cos()
 #include "glm/gtc/constants.hpp" //pi(), two_pi()
 #include "FileUtils.h"
 #include "GlobalConfig.h"
 #include "FFTNormalGradientFoldingBase.h"
+#include "OceanFieldPublisher.h"
 #include <sstream> // std::stringstream
+#include <limits> // std::numeric_limits
 #include <time.h>
 
 
 FFTOceanPatchCPUFFTW::FFTOceanPatchCPUFFTW ( void )
-	: m_pFFTDisplaymentData(nullptr)
+	: m_CascadePatchSizeRatio(1.0f), m_pFFTDisplaymentData(nullptr), m_pPublisher(nullptr), m_IsSharingEnabled(true)
 {
 	LOG("FFTOceanPatchCPUFFTW successfully created!");
 }
 
 FFTOceanPatchCPUFFTW::FFTOceanPatchCPUFFTW ( const GlobalConfig& i_Config )
-	: m_pFFTDisplaymentData(nullptr)
+	: m_CascadePatchSizeRatio(1.0f), m_pFFTDisplaymentData(nullptr), m_pPublisher(nullptr), m_IsSharingEnabled(true)
 {
 	Initialize(i_Config);
 }
@@ -37,24 +39,43 @@ void FFTOceanPatchCPUFFTW::Destroy ( void )
 {
 	// should free resources
 	SAFE_ARRAY_DELETE(m_pFFTDisplaymentData);
+	SAFE_DELETE(m_pPublisher);
 
 	LOG("FFTOceanPatchCPUFFTW successfully destroyed!");
 }
 
-void FFTOceanPatchCPUFFTW::Initialize ( const GlobalConfig& i_Config )
+void FFTOceanPatchCPUFFTW::Prepare ( const GlobalConfig& i_Config )
 {
-	FFTOceanPatchBase::Initialize(i_Config);
+	FFTOceanPatchBase::Prepare(i_Config);
 
-	///////////////
-	m_2DIFFT.Initialize(i_Config);
+	// the FFTW planning (FFTW_MEASURE) is the slowest part of the patch creation
+	m_2DIFFT.Prepare(i_Config);
+
+	m_CascadePatchSizeRatio = glm::max(i_Config.Scene.Ocean.Surface.OceanPatch.Cascades.PatchSizeRatio, 1.0f);
+	m_CascadePatchSizes.resize(m_2DIFFT.GetCascadeCount());
 
 	////////// Initialize FFT Data /////////
-	m_FFTInitData.resize(m_FFTSize * m_FFTSize);
+	m_FFTInitData.resize(m_FFTSize * m_FFTSize * m_CascadePatchSizes.size());
 
 	InitFFTData();
 
-	m_pFFTDisplaymentData = new float[m_FFTSize * m_FFTSize * 4 * sizeof(float)];
+	// all the texture layers are read back
+	m_pFFTDisplaymentData = new float[m_FFTSize * m_FFTSize * 4 * m_2DIFFT.GetFFTLayerCount()];
 	assert(m_pFFTDisplaymentData != nullptr);
+}
+
+void FFTOceanPatchCPUFFTW::Initialize ( const GlobalConfig& i_Config )
+{
+	FFTOceanPatchBase::Initialize(i_Config);
+
+	///////////////
+	m_2DIFFT.Initialize(i_Config);
+
+	if (i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.SharedMemoryPublisher.Enabled)
+	{
+		m_pPublisher = new OceanFieldPublisher(i_Config, m_2DIFFT.GetFFTLayerCount());
+		assert(m_pPublisher != nullptr);
+	}
 
 	/////////// NORMAL, FOLDING SETUP ///////////
 	if (i_Config.Scene.Ocean.Surface.OceanPatch.NormalGradientFolding.Type == CustomTypes::Ocean::NormalGradientFoldingType::NGF_GPU_FRAG)
@@ -82,30 +103,47 @@ void FFTOceanPatchCPUFFTW::SetFFTData ( void )
 
 void FFTOceanPatchCPUFFTW::InitFFTData ( void )
 {
-	srand(0);
-
 	glm::vec2 waveVector(0.0f);
-	float fPatchSize = static_cast<float>(m_PatchSize);
 	float min = glm::pi<float>() / m_PatchSize;
-	for (unsigned short i = 0; i < m_FFTSize; ++ i)
+
+	unsigned short cascadeCount = static_cast<unsigned short>(m_CascadePatchSizes.size());
+	for (unsigned short c = 0; c < cascadeCount; ++ c)
 	{
-		waveVector.y = glm::pi<float>() * (2.0f * i - m_FFTSize) / fPatchSize;
+		m_CascadePatchSizes[c] = m_PatchSize / glm::pow(m_CascadePatchSizeRatio, static_cast<float>(c));
+	}
 
-		for (unsigned short j = 0; j < m_FFTSize; ++ j)
-		{
-			waveVector.x = glm::pi<float>() * (2.0f * j - m_FFTSize) / fPatchSize;
+	for (unsigned short c = 0; c < cascadeCount; ++ c)
+	{
+		float fPatchSize = m_CascadePatchSizes[c];
 
-			unsigned int index = i * m_FFTSize + j;
+		// the cascade band: from half of the previous cascade Nyquist wave number to half of this cascade one
+		float bandMin = (c > 0 ? glm::pi<float>() * m_FFTSize / (2.0f * m_CascadePatchSizes[c - 1]) : 0.0f);
+		float bandMax = (c < cascadeCount - 1 ? glm::pi<float>() * m_FFTSize / (2.0f * fPatchSize) : std::numeric_limits<float>::max());
 
-			if (glm::abs(waveVector.x) < min && glm::abs(waveVector.y) < min)
-			{
-				// values already initialzied to zero
-			}
-			else
+		for (unsigned short i = 0; i < m_FFTSize; ++ i)
+		{
+			waveVector.y = glm::pi<float>() * (2.0f * i - m_FFTSize) / fPatchSize;
+
+			for (unsigned short j = 0; j < m_FFTSize; ++ j)
 			{
-				m_FFTInitData[index].hTilde0 = HTilde0(waveVector);
-				m_FFTInitData[index].hTilde0Conj = std::conj(HTilde0(- waveVector));
-				m_FFTInitData[index].dispersionFrequency = DispersionFrequency(waveVector);
+				waveVector.x = glm::pi<float>() * (2.0f * j - m_FFTSize) / fPatchSize;
+
+				unsigned int index = (c * m_FFTSize + i) * m_FFTSize + j;
+				float waveVectorLength = glm::length(waveVector);
+
+				if ((glm::abs(waveVector.x) < min && glm::abs(waveVector.y) < min) || waveVectorLength < bandMin || waveVectorLength >= bandMax)
+				{
+					// the patch size can change, so the values outside the band are cleared
+					m_FFTInitData[index].hTilde0 = 0.0f;
+					m_FFTInitData[index].hTilde0Conj = 0.0f;
+					m_FFTInitData[index].dispersionFrequency = 0.0f;
+				}
+				else
+				{
+					m_FFTInitData[index].hTilde0 = HTilde0(waveVector, fPatchSize);
+					m_FFTInitData[index].hTilde0Conj = std::conj(HTilde0(- waveVector, fPatchSize));
+					m_FFTInitData[index].dispersionFrequency = DispersionFrequency(waveVector);
+				}
 			}
 		}
 	}
@@ -120,30 +158,34 @@ void FFTOceanPatchCPUFFTW::EvaluateWaves ( float i_CrrTime )
 	////////// Init Data for FFT / Pre FFT calc
 
 	float waveVectorLength; glm::vec2 waveVector(0.0f);
-	float fPatchSize = static_cast<float>(m_PatchSize);
 	std::complex<float> DX, DY, DZ, SX, SZ;
-	for (unsigned short i = 0; i < m_FFTSize; ++i)
+	for (unsigned short c = 0; c < m_CascadePatchSizes.size(); ++c)
 	{
-		waveVector.y = glm::pi<float>() * (2.0f * i - m_FFTSize) / m_PatchSize;
-		for (unsigned short j = 0; j < m_FFTSize; ++j)
+		float fPatchSize = m_CascadePatchSizes[c];
+
+		for (unsigned short i = 0; i < m_FFTSize; ++i)
 		{
-			waveVector.x = glm::pi<float>() * (2.0f * j - m_FFTSize) / m_PatchSize;
-			waveVectorLength = glm::length(waveVector);
+			waveVector.y = glm::pi<float>() * (2.0f * i - m_FFTSize) / fPatchSize;
+			for (unsigned short j = 0; j < m_FFTSize; ++j)
+			{
+				waveVector.x = glm::pi<float>() * (2.0f * j - m_FFTSize) / fPatchSize;
+				waveVectorLength = glm::length(waveVector);
 
-			index = i * m_FFTSize + j;
+				index = (c * m_FFTSize + i) * m_FFTSize + j;
 
-			DY = HTilde(index, i_CrrTime);
+				DY = HTilde(index, i_CrrTime);
 
-			DX = (waveVectorLength < 0.000001f ? 0.0f : (DY * std::complex<float>(0.0f, -waveVector.x / waveVectorLength)));
-			DZ = (waveVectorLength < 0.000001f ? 0.0f : (DY * std::complex<float>(0.0f, -waveVector.y / waveVectorLength)));
+				DX = (waveVectorLength < 0.000001f ? 0.0f : (DY * std::complex<float>(0.0f, -waveVector.x / waveVectorLength)));
+				DZ = (waveVectorLength < 0.000001f ? 0.0f : (DY * std::complex<float>(0.0f, -waveVector.y / waveVectorLength)));
 
-			if (m_2DIFFT.GetUseFFTSlopes())
-			{
-				SX = DY * std::complex<float>(0.0f, waveVector.x);
-				SZ = DY * std::complex<float>(0.0f, waveVector.y);
-			}
+				if (m_2DIFFT.GetUseFFTSlopes())
+				{
+					SX = DY * std::complex<float>(0.0f, waveVector.x);
+					SZ = DY * std::complex<float>(0.0f, waveVector.y);
+				}
 
-			m_2DIFFT.Pre2DFFTSetup(DX, DY, DZ, SX, SZ, index);
+				m_2DIFFT.Pre2DFFTSetup(DX, DY, DZ, SX, SZ, index);
+			}
 		}
 	}
 
@@ -154,25 +196,35 @@ void FFTOceanPatchCPUFFTW::EvaluateWaves ( float i_CrrTime )
 	short sign = 0;
 
 	const short k_signs[] = { 1, -1 };
-	for (unsigned short i = 0; i < m_FFTSize; ++i)
+	for (unsigned short c = 0; c < m_CascadePatchSizes.size(); ++c)
 	{
-		for (unsigned short j = 0; j < m_FFTSize; ++j)
+		for (unsigned short i = 0; i < m_FFTSize; ++i)
 		{
-			index = i * m_FFTSize + j;
-			sign = k_signs[(i + j) & 1];
+			for (unsigned short j = 0; j < m_FFTSize; ++j)
+			{
+				index = (c * m_FFTSize + i) * m_FFTSize + j;
+				sign = k_signs[(i + j) & 1];
 
-			//sign correction
-			m_2DIFFT.Post2DFFTSetup(sign, index);
+				//sign correction
+				m_2DIFFT.Post2DFFTSetup(sign, index);
+			}
 		}
 	}
 
+	////////// Share the fft data with other processes
+	// the readers expect the simulation frames only, in time order
+	if (m_pPublisher && m_IsSharingEnabled)
+	{
+		m_2DIFFT.PublishProcessedData(*m_pPublisher, i_CrrTime);
+	}
+
 	////////// Update the fft data texture
 	m_2DIFFT.UpdateTextureData();
 
 	FFTOceanPatchBase::EvaluateWaves(i_CrrTime);
 }
 
-std::complex<float> FFTOceanPatchCPUFFTW::HTilde0 ( const glm::vec2& i_WaveVector )
+std::complex<float> FFTOceanPatchCPUFFTW::HTilde0 ( const glm::vec2& i_WaveVector, float i_PatchSize )
 {
 	// Ec. (25) from Jerry Tessendorf's article
 
@@ -182,16 +234,17 @@ std::complex<float> FFTOceanPatchCPUFFTW::HTilde0 ( const glm::vec2& i_WaveVecto
 	switch (m_SpectrumType)
 	{
 		case CustomTypes::Ocean::SpectrumType::ST_PHILLIPS:
-			specFactor = glm::sqrt(PhillipsSpectrum(i_WaveVector) / 2.0f);
+			// the wave amplitude is tuned for the patch size, the smaller cascades have a bigger wave vector step
+			specFactor = glm::sqrt(PhillipsSpectrum(i_WaveVector) / 2.0f) * m_PatchSize / i_PatchSize;
 			break;
 		case CustomTypes::Ocean::SpectrumType::ST_UNIFIED:
-			specFactor = glm::sqrt(UnifiedSpectrum(i_WaveVector) / 2.0f) * glm::two_pi<float>() / m_PatchSize;
+			specFactor = glm::sqrt(UnifiedSpectrum(i_WaveVector) / 2.0f) * glm::two_pi<float>() / i_PatchSize;
 			break;
 		case CustomTypes::Ocean::SpectrumType::ST_COUNT:
 		default: ERR("Invalid ocean spectrum type!");
 	}
 
-	glm::vec2 res = GaussianRandomVariable() * specFactor;
+	glm::vec2 res = GaussianRandomVariable(i_WaveVector) * specFactor;
 
 	return std::complex<float>(res.x, res.y);
 }
@@ -273,4 +326,31 @@ void FFTOceanPatchCPUFFTW::BindFFTWaveDataTexture ( void ) const
 unsigned short FFTOceanPatchCPUFFTW::GetFFTWaveDataTexUnitId ( void ) const
 {
 	return m_2DIFFT.GetDestinationTexUnitId();
+}
+
+const glm::vec4* FFTOceanPatchCPUFFTW::GetDisplacementData ( void ) const
+{
+	return m_2DIFFT.GetProcessedData();
+}
+
+unsigned short FFTOceanPatchCPUFFTW::GetCascadeCount ( void ) const
+{
+	return static_cast<unsigned short>(m_CascadePatchSizes.size());
+}
+
+glm::vec4 FFTOceanPatchCPUFFTW::GetCascadeUVScales ( void ) const
+{
+	glm::vec4 uvScales(1.0f, 0.0f, 0.0f, 0.0f);
+
+	for (unsigned short c = 1; c < m_CascadePatchSizes.size(); ++c)
+	{
+		uvScales[c] = m_PatchSize / m_CascadePatchSizes[c];
+	}
+
+	return uvScales;
+}
+
+void FFTOceanPatchCPUFFTW::SetSharingEnabled ( bool i_IsSharingEnabled )
+{
+	m_IsSharingEnabled = i_IsSharingEnabled;
 }
\ No newline at end of file
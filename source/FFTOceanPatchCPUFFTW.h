@@ -11,11 +11,17 @@
 #include <complex>
 
 class GlobalConfig;
+class OceanFieldPublisher;
 
 /*
  CPU implementation of the FFT ocean patch uisng the FFTW thrid-party lib
  Check CPUFFTW2IFFT class for more details
  Havily based on complex numbers
+
+ The spectrum can be split in several cascades: cascade c has the patch size PatchSize / PatchSizeRatio^c
+ and keeps only its band of wave numbers (up to half of its Nyquist wave number, the next cascade continues from there),
+ so the cascades don't overlap and the sum of them has the detail of a much bigger FFT size (e.g. 3 x 256 instead of 2048).
+ All the cascades are transformed together (check CPUFFTW2DIFFT) and summed by the surface shaders.
 */
 
 class FFTOceanPatchCPUFFTW : public FFTOceanPatchBase
@@ -25,6 +31,7 @@ public:
 	FFTOceanPatchCPUFFTW(const GlobalConfig& i_Config);
 	~FFTOceanPatchCPUFFTW(void);
 
+	void Prepare(const GlobalConfig& i_Config) override;
 	void Initialize(const GlobalConfig& i_Config) override;
 
 	void EvaluateWaves(float i_CrrTime) override;
@@ -34,6 +41,13 @@ public:
 	void BindFFTWaveDataTexture(void) const override;
 	unsigned short GetFFTWaveDataTexUnitId(void) const override;
 
+	const glm::vec4* GetDisplacementData(void) const override;
+
+	unsigned short GetCascadeCount(void) const override;
+	glm::vec4 GetCascadeUVScales(void) const override;
+
+	void SetSharingEnabled(bool i_IsSharingEnabled) override;
+
 private:
 	//// Methods ////
 	void Destroy(void);
@@ -41,7 +55,8 @@ private:
 	void SetFFTData(void) override;
 	void InitFFTData(void) override;
 
-	std::complex<float> HTilde0(const glm::vec2& i_WaveVector);
+	// i_PatchSize - the cascade patch size
+	std::complex<float> HTilde0(const glm::vec2& i_WaveVector, float i_PatchSize);
 	std::complex<float> HTilde(unsigned int i_Index, float i_CrrTime);
 
 	//// Variables ////
@@ -55,9 +70,17 @@ private:
 		float dispersionFrequency; //ec. (17) from Jerry Tessendorf's article
 	};
 
+	// FFTSize * FFTSize values per cascade
 	std::vector<FFTInitData> m_FFTInitData;
 
+	float m_CascadePatchSizeRatio;
+	std::vector<float> m_CascadePatchSizes;
+
 	float* m_pFFTDisplaymentData;
+
+	// optional, shares the FFT data with other local processes
+	OceanFieldPublisher* m_pPublisher;
+	bool m_IsSharingEnabled;
 };
 
 #endif /* FFT_OCEAN_PATCH_CPU_FFTW_H */
\ No newline at end of file
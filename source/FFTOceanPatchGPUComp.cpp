@@ -41,27 +41,33 @@ void FFTOceanPatchGPUComp::Destroy ( void )
 	LOG("FFTOceanPatchGPUComp successfully destroyed!");
 }
 
-void FFTOceanPatchGPUComp::Initialize ( const GlobalConfig& i_Config )
+void FFTOceanPatchGPUComp::Prepare ( const GlobalConfig& i_Config )
 {
-	m_IsComputeShaderSupported = i_Config.GLExtVars.IsComputeShaderSupported;
-
-	FFTOceanPatchBase::Initialize(i_Config);
-	///////////////
-	m_2DIFFT.Initialize(i_Config);
+	FFTOceanPatchBase::Prepare(i_Config);
 
+	m_2DIFFT.Prepare(i_Config);
 
 	////////// Initialize FFT Data /////////
 	m_FFTInitData.resize(m_FFTSize * m_FFTSize);
 
 	InitFFTData();
 
+	m_pFFTDisplaymentData = new float[m_FFTSize * m_FFTSize * 4 * sizeof(float)];
+	assert(m_pFFTDisplaymentData != nullptr);
+}
+
+void FFTOceanPatchGPUComp::Initialize ( const GlobalConfig& i_Config )
+{
+	m_IsComputeShaderSupported = i_Config.GLExtVars.IsComputeShaderSupported;
+
+	FFTOceanPatchBase::Initialize(i_Config);
+	///////////////
+	m_2DIFFT.Initialize(i_Config);
+
 	//// Create H0Omega texture
 	m_FFTTM.Initialize("FFTOceanPatchGPUComp", i_Config);
 	m_FFTInitDataTexId = m_FFTTM.Create2DTexture(GL_RGBA16F, GL_RGBA, GL_FLOAT, m_FFTSize, m_FFTSize, GL_REPEAT, GL_NEAREST, &m_FFTInitData[0], i_Config.TexUnit.Ocean.FFTOceanPatchGPUComp.FFTInitDataMap);
 
-	m_pFFTDisplaymentData = new float[m_FFTSize * m_FFTSize * 4 * sizeof(float)];
-	assert(m_pFFTDisplaymentData != nullptr);
-
 	///////////// FFT Ht SETUP ///////////
 	m_FFTHtSM.Initialize("FFTOceanPatchGPUComp");
 
@@ -114,8 +120,6 @@ void FFTOceanPatchGPUComp::SetFFTData ( void )
 
 void FFTOceanPatchGPUComp::InitFFTData ( void )
 {
-	srand(0);
-
 	glm::vec2 waveVector(0.0f);
 	float fPatchSize = static_cast<float>(m_PatchSize);
 	float min = glm::pi<float>() / m_PatchSize;
@@ -148,7 +152,7 @@ void FFTOceanPatchGPUComp::InitFFTData ( void )
 					specFactor = glm::sqrt(UnifiedSpectrum(waveVector) / 2.0f) * glm::two_pi<float>() / m_PatchSize;
 				}
 
-				glm::vec2 hTilde0 = GaussianRandomVariable() * specFactor;
+				glm::vec2 hTilde0 = GaussianRandomVariable(waveVector) * specFactor;
 				m_FFTInitData[index].x = hTilde0.x;
 				m_FFTInitData[index].y = hTilde0.y;
 				m_FFTInitData[index].z = DispersionFrequency(waveVector);
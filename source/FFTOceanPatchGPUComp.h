@@ -28,6 +28,7 @@ public:
 	FFTOceanPatchGPUComp(const GlobalConfig& i_Config);
 	~FFTOceanPatchGPUComp(void);
 
+	void Prepare(const GlobalConfig& i_Config) override;
 	void Initialize(const GlobalConfig& i_Config) override;
 
 	void EvaluateWaves(float i_CrrTime) override;
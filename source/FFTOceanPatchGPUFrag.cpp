@@ -39,6 +39,21 @@ void FFTOceanPatchGPUFrag::Destroy ( void )
 	LOG("FFTOceanPatchGPUFrag successfully destroyed!");
 }
 
+void FFTOceanPatchGPUFrag::Prepare ( const GlobalConfig& i_Config )
+{
+	FFTOceanPatchBase::Prepare(i_Config);
+
+	m_2DIFFT.Prepare(i_Config);
+
+	////////// Initialize FFT Data /////////
+	m_FFTInitData.resize(m_FFTSize * m_FFTSize);
+
+	InitFFTData();
+
+	m_pFFTDisplaymentData = new float[m_FFTSize * m_FFTSize * 4 * sizeof(float)];
+	assert(m_pFFTDisplaymentData != nullptr);
+}
+
 void FFTOceanPatchGPUFrag::Initialize ( const GlobalConfig& i_Config )
 {	
 	FFTOceanPatchBase::Initialize(i_Config);
@@ -46,18 +61,10 @@ void FFTOceanPatchGPUFrag::Initialize ( const GlobalConfig& i_Config )
 	///////////////
 	m_2DIFFT.Initialize(i_Config);
 
-
-	////////// Initialize FFT Data /////////
-	m_FFTInitData.resize(m_FFTSize * m_FFTSize);
-
-	InitFFTData();
 	//// Create H0Omega texture
 	m_FFTTM.Initialize("FFTOceanPatchGPUFrag", i_Config);
 	m_FFTInitDataTexId = m_FFTTM.Create2DTexture(GL_RGB16F, GL_RGB, GL_FLOAT, m_FFTSize, m_FFTSize, GL_REPEAT, GL_NEAREST, &m_FFTInitData[0], i_Config.TexUnit.Ocean.FFTOceanPatchGPUFrag.FFTInitDataMap);
 
-	m_pFFTDisplaymentData = new float[m_FFTSize * m_FFTSize * 4 * sizeof(float)];
-	assert(m_pFFTDisplaymentData != nullptr);
-
 	///////////// FFT Ht SETUP ///////////
 	m_FFTHtSM.Initialize("FFTOceanPatchGPUFrag");
 
@@ -126,8 +133,6 @@ void FFTOceanPatchGPUFrag::SetFFTData ( void )
 
 void FFTOceanPatchGPUFrag::InitFFTData ( void )
 {
-	srand(0);
-
 	glm::vec2 waveVector(0.0f);
 	float fPatchSize = static_cast<float>(m_PatchSize);
 	float min = glm::pi<float>() / m_PatchSize;
@@ -163,7 +168,7 @@ void FFTOceanPatchGPUFrag::InitFFTData ( void )
 					default: ERR("Invalid ocean spectrum type!");
 				}
 
-				glm::vec2 hTilde0 = GaussianRandomVariable() * specFactor;
+				glm::vec2 hTilde0 = GaussianRandomVariable(waveVector) * specFactor;
 				m_FFTInitData[index].x = hTilde0.x;
 				m_FFTInitData[index].y = hTilde0.y;
 				m_FFTInitData[index].z = DispersionFrequency(waveVector);
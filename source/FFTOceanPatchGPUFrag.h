@@ -29,6 +29,7 @@ public:
 	FFTOceanPatchGPUFrag(const GlobalConfig& i_Config);
 	~FFTOceanPatchGPUFrag(void);
 
+	void Prepare(const GlobalConfig& i_Config) override;
 	void Initialize(const GlobalConfig& i_Config) override;
 
 	void EvaluateWaves(float i_CrrTime) override;
@@ -50,4 +50,33 @@ namespace FileUtils
 
 		return true;
 	}
+
+	std::string GetFullPath(const std::string& i_FileName)
+	{
+		char* basePath = SDL_GetBasePath();
+		std::string fileName(basePath ? basePath : "");
+		fileName += i_FileName;
+
+		SDL_free(basePath);
+
+		return fileName;
+	}
+
+	std::string GetCachePath(const std::string& i_FileName)
+	{
+		// the base path may be read only (installed application)
+		char* prefPath = SDL_GetPrefPath("BairacMihai", "MihaiFFTOcean");
+		if (!prefPath)
+		{
+			LOG("Failed to get the application data path, %s is saved to the base path!", i_FileName.c_str());
+			return GetFullPath(i_FileName);
+		}
+
+		std::string fileName(prefPath);
+		fileName += i_FileName;
+
+		SDL_free(prefPath);
+
+		return fileName;
+	}
 }
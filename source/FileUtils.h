@@ -12,6 +12,12 @@
 namespace FileUtils
 {
 	bool LoadFile(const std::string& i_FileName, std::string& o_Data);
+
+	// prepends the application base path to the given relative file name
+	std::string GetFullPath(const std::string& i_FileName);
+
+	// prepends the user writable application data path (the base path if it's not available) to the given file name
+	std::string GetCachePath(const std::string& i_FileName);
 }
 
 #endif /* FILE_UTILS_H */
@@ -3,6 +3,7 @@
 #include "FrameBufferManager.h"
 #include "CommonHeaders.h"
 #include "GLConfig.h"
+#include "GLStateCache.h"
 #include "GlobalConfig.h"
 #include "glm/vec2.hpp"
 #include "glm/vec3.hpp"
@@ -59,8 +60,9 @@ void FrameBufferManager::Destroy ( void )
 
 	if (m_FBOID)
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 		glDeleteFramebuffers(1, &m_FBOID);
+		GLStateCache::OnFramebufferDeleted(m_FBOID);
 		m_FBOID = 0;
 	}
 
@@ -191,7 +193,7 @@ void FrameBufferManager::SetupSimple ( unsigned short i_ColorAttachmentCount, un
 
 	CheckCompletenessStatus();
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void FrameBufferManager::SetupLayered ( unsigned short i_ColorAttachmentCount, unsigned short i_LayerCount, unsigned int i_FormatInternal, unsigned int i_FormatExternal, unsigned int i_FormatType, unsigned short i_Width, unsigned short i_Height, unsigned int i_WrapType, unsigned int i_FilterType, unsigned short i_StartTexUnitID, short i_MipMapCount, bool i_AnisoFiltering, FrameBufferManager::DEPTH_BUFFER_TYPE i_DepthBufferType )
@@ -237,7 +239,7 @@ void FrameBufferManager::SetupLayered ( unsigned short i_ColorAttachmentCount, u
 
 	CheckCompletenessStatus();
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void FrameBufferManager::SetupLayered ( unsigned int i_ColorAttachmentTexId, unsigned short i_ColorAttachmentLayerCount )
@@ -265,7 +267,7 @@ void FrameBufferManager::SetupLayered ( unsigned int i_ColorAttachmentTexId, uns
 
 	CheckCompletenessStatus();
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void FrameBufferManager::SetupCubeMaped ( unsigned int i_FormatInternal, unsigned int i_FormatExternal, unsigned int i_FormatType, unsigned short i_Width, unsigned short i_Height, unsigned int i_WrapType, unsigned int i_FilterType, unsigned short i_StartTexUnitID, short i_MipMapCount, FrameBufferManager::DEPTH_BUFFER_TYPE i_DepthBufferType )
@@ -300,13 +302,13 @@ void FrameBufferManager::SetupCubeMaped ( unsigned int i_FormatInternal, unsigne
 
 	CheckCompletenessStatus();
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void FrameBufferManager::GenAndBindFramebuffer()
 {
 	glGenFramebuffers(1, &m_FBOID);
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_FBOID);
+	GLStateCache::BindFramebuffer(GL_DRAW_FRAMEBUFFER, m_FBOID);
 }
 
 void FrameBufferManager::SetupDepthBuffer ( DEPTH_BUFFER_TYPE i_DepthBufferType, unsigned short i_Width, unsigned short i_Height )
@@ -383,8 +385,9 @@ void FrameBufferManager::CheckCompletenessStatus(void)
 	int error = 0;
 	if ((error = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER)) != GL_FRAMEBUFFER_COMPLETE)
 	{
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		GLStateCache::BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
 		glDeleteFramebuffers(1, &m_FBOID);
+		GLStateCache::OnFramebufferDeleted(m_FBOID);
 		m_FBOID = 0;
 		ERR("The Auxiliary Framebuffer is incomplete! err: %d", error);
 		return;
@@ -413,12 +416,15 @@ void FrameBufferManager::RenderToQuad ( void ) const
 
 void FrameBufferManager::Bind ( void ) const
 {
-	glBindFramebuffer(GL_FRAMEBUFFER, m_FBOID);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, m_FBOID);
+
+	// the attachments are going to be rendered to, so their mipmaps need to be regenerated on the next bind
+	m_TM.MarkAllMipMapsDirty();
 }
 
 void FrameBufferManager::UnBind ( void ) const
 {
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 
@@ -432,6 +438,11 @@ void FrameBufferManager::BindColorAttachmentByIndex ( unsigned short i_Index, bo
 	m_TM.BindTexture(m_TM.GetTextureId(i_Index), i_GenerateMipMaps, i_TexUnitId);
 }
 
+void FrameBufferManager::BindDepthAttachment ( short i_TexUnitId ) const
+{
+	m_TM.BindTexture(m_DepthTexID, false, i_TexUnitId);
+}
+
 void FrameBufferManager::UpdateColorAttachmentSize(unsigned short i_Index, unsigned short i_Width, unsigned short i_Height)
 {
 	m_TM.Update2DTextureSize(m_TM.GetTextureId(i_Index), i_Width, i_Height);
@@ -65,6 +65,8 @@ public:
 
 	void BindColorAttachmentByTexId(unsigned short i_TexId, bool i_GenerateMipMaps = false) const;
 	void BindColorAttachmentByIndex(unsigned short i_Index, bool i_GenerateMipMaps = false, short i_TexUnitId = -1) const;
+	// only for DBT_TEXTURE_DEPTH, the depth texture has no tex unit of its own
+	void BindDepthAttachment(short i_TexUnitId) const;
 
 	void UpdateColorAttachmentSize(unsigned short i_Index, unsigned short i_Width, unsigned short i_Height);
 	void UpdateDepthBufferSize(unsigned short i_Width, unsigned short i_Height);
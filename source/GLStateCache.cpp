@@ -0,0 +1,280 @@
+/* Author: BAIRAC MIHAI */
+
+#include "GLStateCache.h"
+#include "GLConfig.h"
+
+
+namespace
+{
+	// the value of a binding which is not known (never set or invalidated)
+	const unsigned int kUnknownId = 0xFFFFFFFF;
+
+	// the units above this one are not cached, their binds are always issued
+	const unsigned short kMaxCachedTexUnitCount = 32;
+
+	// the targets used by TextureManager
+	const unsigned int kTexTargets[] = { GL_TEXTURE_1D, GL_TEXTURE_1D_ARRAY, GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP };
+	const unsigned short kTexTargetCount = sizeof(kTexTargets) / sizeof(kTexTargets[0]);
+
+	const unsigned short kCallTypeCount = static_cast<unsigned short>(GLStateCache::CALL_TYPE::CT_COUNT);
+
+	struct State
+	{
+		State ( void )
+		{
+			Reset();
+
+			for (unsigned short i = 0; i < kCallTypeCount; ++i)
+			{
+				issuedCallCounts[i] = 0;
+				elidedCallCounts[i] = 0;
+			}
+		}
+
+		void Reset ( void )
+		{
+			programId = kUnknownId;
+			activeTexUnitId = kUnknownId;
+
+			for (unsigned short i = 0; i < kMaxCachedTexUnitCount; ++i)
+			{
+				for (unsigned short j = 0; j < kTexTargetCount; ++j)
+				{
+					texIds[i][j] = kUnknownId;
+				}
+			}
+
+			drawFBOId = kUnknownId;
+			readFBOId = kUnknownId;
+			VAOId = kUnknownId;
+		}
+
+		unsigned int programId;
+		unsigned int activeTexUnitId;
+		unsigned int texIds[kMaxCachedTexUnitCount][kTexTargetCount];
+		unsigned int drawFBOId, readFBOId;
+		unsigned int VAOId;
+
+		unsigned int issuedCallCounts[kCallTypeCount];
+		unsigned int elidedCallCounts[kCallTypeCount];
+	};
+
+	State g_State;
+
+	// returns -1 for the targets which are not cached
+	short GetTexTargetIndex ( unsigned int i_Target )
+	{
+		for (unsigned short i = 0; i < kTexTargetCount; ++i)
+		{
+			if (kTexTargets[i] == i_Target)
+			{
+				return i;
+			}
+		}
+
+		return -1;
+	}
+
+	void CountCall ( GLStateCache::CALL_TYPE i_CallType, bool i_IsIssued )
+	{
+		unsigned short type = static_cast<unsigned short>(i_CallType);
+
+		if (i_IsIssued)
+		{
+			++ g_State.issuedCallCounts[type];
+		}
+		else
+		{
+			++ g_State.elidedCallCounts[type];
+		}
+	}
+
+	// returns true if the call must be issued
+	bool CheckBinding ( GLStateCache::CALL_TYPE i_CallType, unsigned int& io_CachedId, unsigned int i_Id )
+	{
+		bool isIssued = (io_CachedId != i_Id);
+		io_CachedId = i_Id;
+
+		CountCall(i_CallType, isIssued);
+
+		return isIssued;
+	}
+
+	void ForgetId ( unsigned int& io_CachedId, unsigned int i_Id, unsigned int i_NewId )
+	{
+		if (io_CachedId == i_Id)
+		{
+			io_CachedId = i_NewId;
+		}
+	}
+}
+
+namespace GLStateCache
+{
+	void UseProgram ( unsigned int i_ProgramId )
+	{
+		if (CheckBinding(CALL_TYPE::CT_USE_PROGRAM, g_State.programId, i_ProgramId))
+		{
+			glUseProgram(i_ProgramId);
+		}
+	}
+
+	void ActiveTexture ( unsigned short i_TexUnitId )
+	{
+		if (CheckBinding(CALL_TYPE::CT_ACTIVE_TEXTURE, g_State.activeTexUnitId, i_TexUnitId))
+		{
+			glActiveTexture(GL_TEXTURE0 + i_TexUnitId);
+		}
+	}
+
+	void BindTexture ( unsigned int i_Target, unsigned int i_TexId )
+	{
+		short targetIndex = GetTexTargetIndex(i_Target);
+		unsigned int texUnitId = g_State.activeTexUnitId;
+
+		if (targetIndex < 0 || texUnitId >= kMaxCachedTexUnitCount)
+		{
+			// the active unit can also be unknown (after Invalidate())
+			CountCall(CALL_TYPE::CT_BIND_TEXTURE, true);
+			glBindTexture(i_Target, i_TexId);
+
+			return;
+		}
+
+		if (CheckBinding(CALL_TYPE::CT_BIND_TEXTURE, g_State.texIds[texUnitId][targetIndex], i_TexId))
+		{
+			glBindTexture(i_Target, i_TexId);
+		}
+	}
+
+	void BindTexture ( unsigned short i_TexUnitId, unsigned int i_Target, unsigned int i_TexId )
+	{
+		short targetIndex = GetTexTargetIndex(i_Target);
+
+		if (targetIndex >= 0 && i_TexUnitId < kMaxCachedTexUnitCount && g_State.texIds[i_TexUnitId][targetIndex] == i_TexId)
+		{
+			// neither the unit selection nor the bind is needed
+			CountCall(CALL_TYPE::CT_BIND_TEXTURE, false);
+
+			return;
+		}
+
+		ActiveTexture(i_TexUnitId);
+		BindTexture(i_Target, i_TexId);
+	}
+
+	void BindFramebuffer ( unsigned int i_Target, unsigned int i_FBOId )
+	{
+		bool isIssued = false;
+
+		switch (i_Target)
+		{
+			case GL_FRAMEBUFFER:
+				// binds both the draw and the read framebuffers
+				isIssued = (g_State.drawFBOId != i_FBOId || g_State.readFBOId != i_FBOId);
+				g_State.drawFBOId = i_FBOId;
+				g_State.readFBOId = i_FBOId;
+				break;
+			case GL_DRAW_FRAMEBUFFER:
+				isIssued = (g_State.drawFBOId != i_FBOId);
+				g_State.drawFBOId = i_FBOId;
+				break;
+			case GL_READ_FRAMEBUFFER:
+				isIssued = (g_State.readFBOId != i_FBOId);
+				g_State.readFBOId = i_FBOId;
+				break;
+			default:
+				isIssued = true;
+		}
+
+		CountCall(CALL_TYPE::CT_BIND_FRAMEBUFFER, isIssued);
+
+		if (isIssued)
+		{
+			glBindFramebuffer(i_Target, i_FBOId);
+		}
+	}
+
+	void BindVertexArray ( unsigned int i_VAOId )
+	{
+		if (CheckBinding(CALL_TYPE::CT_BIND_VERTEX_ARRAY, g_State.VAOId, i_VAOId))
+		{
+			glBindVertexArray(i_VAOId);
+		}
+	}
+
+	void OnProgramDeleted ( unsigned int i_ProgramId )
+	{
+		// NOTE! A deleted program stays in use until another program is used, but its id can be reused,
+		// so the next UseProgram() call must be issued
+		ForgetId(g_State.programId, i_ProgramId, kUnknownId);
+	}
+
+	void OnTextureDeleted ( unsigned int i_TexId )
+	{
+		for (unsigned short i = 0; i < kMaxCachedTexUnitCount; ++i)
+		{
+			for (unsigned short j = 0; j < kTexTargetCount; ++j)
+			{
+				ForgetId(g_State.texIds[i][j], i_TexId, 0);
+			}
+		}
+	}
+
+	void OnFramebufferDeleted ( unsigned int i_FBOId )
+	{
+		ForgetId(g_State.drawFBOId, i_FBOId, 0);
+		ForgetId(g_State.readFBOId, i_FBOId, 0);
+	}
+
+	void OnVertexArrayDeleted ( unsigned int i_VAOId )
+	{
+		ForgetId(g_State.VAOId, i_VAOId, 0);
+	}
+
+	void Invalidate ( void )
+	{
+		g_State.Reset();
+	}
+
+	unsigned int GetIssuedCallCount ( CALL_TYPE i_CallType )
+	{
+		return g_State.issuedCallCounts[static_cast<unsigned short>(i_CallType)];
+	}
+
+	unsigned int GetElidedCallCount ( CALL_TYPE i_CallType )
+	{
+		return g_State.elidedCallCounts[static_cast<unsigned short>(i_CallType)];
+	}
+
+	unsigned int GetIssuedCallCount ( void )
+	{
+		unsigned int count = 0;
+		for (unsigned short i = 0; i < kCallTypeCount; ++i)
+		{
+			count += g_State.issuedCallCounts[i];
+		}
+
+		return count;
+	}
+
+	unsigned int GetElidedCallCount ( void )
+	{
+		unsigned int count = 0;
+		for (unsigned short i = 0; i < kCallTypeCount; ++i)
+		{
+			count += g_State.elidedCallCounts[i];
+		}
+
+		return count;
+	}
+
+	void ResetCounters ( void )
+	{
+		for (unsigned short i = 0; i < kCallTypeCount; ++i)
+		{
+			g_State.issuedCallCounts[i] = 0;
+			g_State.elidedCallCounts[i] = 0;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+/*
+ Shadow of the GL binding state shared by all the managers (there is only one GL context)
+
+ The program, the active texture unit, the textures bound to each unit, the framebuffers and the vertex array
+ are bound only through these functions, so a bind of the object which is already bound is dropped.
+ Every call is counted either as issued or as elided (check GetIssuedCallCount() and GetElidedCallCount()).
+
+ GL unbinds the deleted objects, so the managers must call the On*Deleted() functions after deleting them,
+ otherwise a new object getting the same id would be considered bound.
+ Invalidate() must be called after the state was changed outside the cache (e.g. by AntTweakBar).
+*/
+
+namespace GLStateCache
+{
+	enum class CALL_TYPE
+	{
+		CT_USE_PROGRAM = 0,
+		CT_ACTIVE_TEXTURE,
+		CT_BIND_TEXTURE,
+		CT_BIND_FRAMEBUFFER,
+		CT_BIND_VERTEX_ARRAY,
+		CT_COUNT
+	};
+
+	void UseProgram(unsigned int i_ProgramId);
+
+	void ActiveTexture(unsigned short i_TexUnitId);
+	// binds the texture to the active texture unit
+	void BindTexture(unsigned int i_Target, unsigned int i_TexId);
+	// the texture unit is activated only if the texture is not already bound to it
+	void BindTexture(unsigned short i_TexUnitId, unsigned int i_Target, unsigned int i_TexId);
+
+	// i_Target - GL_FRAMEBUFFER, GL_DRAW_FRAMEBUFFER or GL_READ_FRAMEBUFFER
+	void BindFramebuffer(unsigned int i_Target, unsigned int i_FBOId);
+
+	void BindVertexArray(unsigned int i_VAOId);
+
+	void OnProgramDeleted(unsigned int i_ProgramId);
+	void OnTextureDeleted(unsigned int i_TexId);
+	void OnFramebufferDeleted(unsigned int i_FBOId);
+	void OnVertexArrayDeleted(unsigned int i_VAOId);
+
+	// forgets the whole state, the next bind of every kind is issued
+	void Invalidate(void);
+
+	// counted since the last ResetCounters() call
+	unsigned int GetIssuedCallCount(CALL_TYPE i_CallType);
+	unsigned int GetElidedCallCount(CALL_TYPE i_CallType);
+	// all the call types
+	unsigned int GetIssuedCallCount(void);
+	unsigned int GetElidedCallCount(void);
+
+	void ResetCounters(void);
+}
+
+#endif /* GL_STATE_CACHE_H */
\ No newline at end of file
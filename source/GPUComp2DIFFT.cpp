@@ -259,6 +259,8 @@ void GPUComp2DIFFT::Perform2DIFFT ( void )
 		// Make sure, all values are written.
 		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
 	}
+
+	m_TM.MarkMipMapsDirty(m_PingPongTexIds[0]);
 }
 
 void GPUComp2DIFFT::BindDestinationTexture ( void ) const
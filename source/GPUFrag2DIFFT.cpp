@@ -12,14 +12,25 @@
 #include <sstream> // std::stringstream
 
 
+const char* const GPUFrag2DIFFT::m_kPassUniformHandleNames[] =
+{
+	"u_PingPongMap",
+	"u_Step",
+	"u_IsLastStep",
+	"u_IndicesStep",
+	"u_WeightsStep"
+};
+
 GPUFrag2DIFFT::GPUFrag2DIFFT ( void )
-  : m_pFFTFBM(nullptr), m_IsPongTarget(false), m_Use2FBOs(false)
+  : m_pFFTFBM(nullptr), m_Radix(2), m_NumRadix2Passes(0), m_NumRadix4Passes(0),
+	m_IsPongTarget(false), m_Use2FBOs(false)
 {
 	LOG("GPUFrag2DIFFT successfully created!");
 }
 
 GPUFrag2DIFFT::GPUFrag2DIFFT ( const GlobalConfig& i_Config )
-  : m_pFFTFBM(nullptr), m_IsPongTarget(false), m_Use2FBOs(false)
+  : m_pFFTFBM(nullptr), m_Radix(2), m_NumRadix2Passes(0), m_NumRadix4Passes(0),
+	m_IsPongTarget(false), m_Use2FBOs(false)
 {
 	Initialize(i_Config);
 }
@@ -54,6 +65,26 @@ void GPUFrag2DIFFT::Initialize ( const GlobalConfig& i_Config )
 
 	m_Use2FBOs = i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.Use2FBOs;
 
+	m_Radix = i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.Radix;
+	if (m_Radix != 2 && m_Radix != 4)
+	{
+		ERR("Invalid FFT radix! Only radix 2 and 4 are supported! Radix 2 will be used instead!");
+		m_Radix = 2;
+	}
+
+	if (m_Radix == 4)
+	{
+		// for an odd number of butterfly stages, the first stage is computed as a radix-2 pass
+		// NOTE! the total number of passes (horizontal + vertical) stays even, so the final result still ends up in Ping
+		m_NumRadix2Passes = m_NumButterflies % 2;
+		m_NumRadix4Passes = m_NumButterflies / 2;
+	}
+	else
+	{
+		m_NumRadix2Passes = m_NumButterflies;
+		m_NumRadix4Passes = 0;
+	}
+
 	//////////////
 	/*
 	Now, the init data for FFT is being created.
@@ -72,6 +103,18 @@ void GPUFrag2DIFFT::Initialize ( const GlobalConfig& i_Config )
 	m_TM.Initialize("GPUFrag2DIFFT - Butterfly Lookup Texture", i_Config);
 	m_TM.Create2DTexture(GL_RGBA16F, GL_RGBA, GL_FLOAT, m_FFTSize, m_NumButterflies, GL_CLAMP_TO_EDGE, GL_NEAREST, pButterFlyData, i_Config.TexUnit.Ocean.GPU2DIFFT.ButterflyMap);
 
+	if (m_NumRadix4Passes > 0)
+	{
+		// 2 rows per radix-4 pass: 4 source indices and 2 complex weights
+		float* pRadix4ButterFlyData = new float[m_FFTSize * 2 * m_NumRadix4Passes * 4];
+		assert(pRadix4ButterFlyData != nullptr);
+		ComputeRadix4ButterflyLookupTexture(pButterFlyData, pRadix4ButterFlyData);
+
+		m_TM.Create2DTexture(GL_RGBA16F, GL_RGBA, GL_FLOAT, m_FFTSize, 2 * m_NumRadix4Passes, GL_CLAMP_TO_EDGE, GL_NEAREST, pRadix4ButterFlyData, i_Config.TexUnit.Ocean.GPU2DIFFT.Radix4ButterflyMap);
+
+		SAFE_ARRAY_DELETE(pRadix4ButterFlyData);
+	}
+
 	SAFE_ARRAY_DELETE(pButterFlyData);
 	//////////////
 
@@ -129,13 +172,11 @@ void GPUFrag2DIFFT::Initialize ( const GlobalConfig& i_Config )
 	m_HorizontalUniforms["u_ButterflyMap"] = m_HorizontalSM.GetUniformLocation("u_ButterflyMap");
 	m_HorizontalSM.SetUniform(m_HorizontalUniforms.find("u_ButterflyMap")->second, i_Config.TexUnit.Ocean.GPU2DIFFT.ButterflyMap);
 
-	m_HorizontalUniforms["u_PingPongMap"] = m_HorizontalSM.GetUniformLocation("u_PingPongMap");
-
 	if (m_Use2FBOs)
 	{
 		m_HorizontalSM.SetupFragmentOutputStreams(m_FFTLayerCount, 0);
 	}
-	m_HorizontalUniforms["u_Step"] = m_HorizontalSM.GetUniformLocation("u_Step");
+	m_HorizontalHandles.Initialize(m_HorizontalSM, m_kPassUniformHandleNames);
 
 	m_HorizontalSM.UnUseProgram();
 	//////////
@@ -176,7 +217,6 @@ void GPUFrag2DIFFT::Initialize ( const GlobalConfig& i_Config )
 
 	m_VerticalUniforms["u_ButterflyMap"] = m_VerticalSM.GetUniformLocation("u_ButterflyMap");
 	m_VerticalSM.SetUniform(m_VerticalUniforms.find("u_ButterflyMap")->second, i_Config.TexUnit.Ocean.GPU2DIFFT.ButterflyMap);
-	m_VerticalUniforms["u_PingPongMap"] = m_VerticalSM.GetUniformLocation("u_PingPongMap");
 
 	if (m_Use2FBOs)
 	{
@@ -185,8 +225,7 @@ void GPUFrag2DIFFT::Initialize ( const GlobalConfig& i_Config )
 
 	m_VerticalUniforms["u_FFTSize"] = m_VerticalSM.GetUniformLocation("u_FFTSize");
 	m_VerticalSM.SetUniform(m_VerticalUniforms.find("u_FFTSize")->second, static_cast<float>(m_FFTSize));
-	m_VerticalUniforms["u_Step"] = m_VerticalSM.GetUniformLocation("u_Step");
-	m_VerticalUniforms["u_IsLastStep"] = m_VerticalSM.GetUniformLocation("u_IsLastStep");
+	m_VerticalHandles.Initialize(m_VerticalSM, m_kPassUniformHandleNames);
 
 	m_VerticalSM.UnUseProgram();
 
@@ -208,6 +247,105 @@ void GPUFrag2DIFFT::Initialize ( const GlobalConfig& i_Config )
 		}
 	}
 
+	if (m_NumRadix4Passes > 0)
+	{
+		/////////// RADIX-4 HORIZONTAL ///////////
+		m_HorizontalRadix4SM.Initialize("GPUFrag2DIFFT - Radix-4 Horizontal FFT");
+
+		if (m_UseFFTSlopes)
+		{
+			m_HorizontalRadix4SM.BuildRenderingProgram("resources/shaders/Quad.vert.glsl", "resources/shaders/FFTHorizontalRadix4.frag.glsl", i_Config);
+		}
+		else
+		{
+			m_HorizontalRadix4SM.BuildRenderingProgram("resources/shaders/Quad.vert.glsl", "resources/shaders/FFTHorizontalRadix4_NoFFTSlopes.frag.glsl", i_Config);
+		}
+
+		m_HorizontalRadix4SM.UseProgram();
+
+		std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int> horizontalRadix4Attributes;
+		horizontalRadix4Attributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_HorizontalRadix4SM.GetAttributeLocation("a_position");
+		horizontalRadix4Attributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_UV] = m_HorizontalRadix4SM.GetAttributeLocation("a_uv");
+
+		m_HorizontalRadix4Uniforms["u_Radix4ButterflyMap"] = m_HorizontalRadix4SM.GetUniformLocation("u_Radix4ButterflyMap");
+		m_HorizontalRadix4SM.SetUniform(m_HorizontalRadix4Uniforms.find("u_Radix4ButterflyMap")->second, i_Config.TexUnit.Ocean.GPU2DIFFT.Radix4ButterflyMap);
+
+		if (m_Use2FBOs)
+		{
+			m_HorizontalRadix4SM.SetupFragmentOutputStreams(m_FFTLayerCount, 0);
+		}
+		m_HorizontalRadix4Handles.Initialize(m_HorizontalRadix4SM, m_kPassUniformHandleNames);
+
+		m_HorizontalRadix4SM.UnUseProgram();
+		//////////
+		m_HorizontalRadix4MBM.Initialize("GPUFrag2DIFFT - Radix-4 Horizontal FFT");
+
+		if (m_Use2FBOs)
+		{
+			if (&m_pFFTFBM[0])
+			{
+				m_HorizontalRadix4MBM.CreateModelContext(horizontalRadix4Attributes, m_pFFTFBM[0].GetQuadVBOID(), m_pFFTFBM[0].GetQuadAccessType());
+			}
+		}
+		else
+		{
+			if (m_pFFTFBM)
+			{
+				m_HorizontalRadix4MBM.CreateModelContext(horizontalRadix4Attributes, m_pFFTFBM->GetQuadVBOID(), m_pFFTFBM->GetQuadAccessType());
+			}
+		}
+
+		/////////// RADIX-4 VERTICAL ////////////
+		m_VerticalRadix4SM.Initialize("GPUFrag2DIFFT - Radix-4 Vertical FFT");
+
+		if (m_UseFFTSlopes)
+		{
+			m_VerticalRadix4SM.BuildRenderingProgram("resources/shaders/Quad.vert.glsl", "resources/shaders/FFTVerticalRadix4.frag.glsl", i_Config);
+		}
+		else
+		{
+			m_VerticalRadix4SM.BuildRenderingProgram("resources/shaders/Quad.vert.glsl", "resources/shaders/FFTVerticalRadix4_NoFFTSlopes.frag.glsl", i_Config);
+		}
+
+		m_VerticalRadix4SM.UseProgram();
+
+		std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int> verticalRadix4Attributes;
+		verticalRadix4Attributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_VerticalRadix4SM.GetAttributeLocation("a_position");
+		verticalRadix4Attributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_UV] = m_VerticalRadix4SM.GetAttributeLocation("a_uv");
+
+		m_VerticalRadix4Uniforms["u_Radix4ButterflyMap"] = m_VerticalRadix4SM.GetUniformLocation("u_Radix4ButterflyMap");
+		m_VerticalRadix4SM.SetUniform(m_VerticalRadix4Uniforms.find("u_Radix4ButterflyMap")->second, i_Config.TexUnit.Ocean.GPU2DIFFT.Radix4ButterflyMap);
+
+		if (m_Use2FBOs)
+		{
+			m_VerticalRadix4SM.SetupFragmentOutputStreams(m_FFTLayerCount, 0);
+		}
+
+		m_VerticalRadix4Uniforms["u_FFTSize"] = m_VerticalRadix4SM.GetUniformLocation("u_FFTSize");
+		m_VerticalRadix4SM.SetUniform(m_VerticalRadix4Uniforms.find("u_FFTSize")->second, static_cast<float>(m_FFTSize));
+		m_VerticalRadix4Handles.Initialize(m_VerticalRadix4SM, m_kPassUniformHandleNames);
+
+		m_VerticalRadix4SM.UnUseProgram();
+
+		//////////
+		m_VerticalRadix4MBM.Initialize("GPUFrag2DIFFT - Radix-4 Vertical FFT");
+
+		if (m_Use2FBOs)
+		{
+			if (&m_pFFTFBM[1])
+			{
+				m_VerticalRadix4MBM.CreateModelContext(verticalRadix4Attributes, m_pFFTFBM[1].GetQuadVBOID(), m_pFFTFBM[1].GetQuadAccessType());
+			}
+		}
+		else
+		{
+			if (m_pFFTFBM)
+			{
+				m_VerticalRadix4MBM.CreateModelContext(verticalRadix4Attributes, m_pFFTFBM->GetQuadVBOID(), m_pFFTFBM->GetQuadAccessType());
+			}
+		}
+	}
+
 	LOG("GPUFrag2DIFFT successfully created!");
 }
 
@@ -261,6 +399,50 @@ void GPUFrag2DIFFT::ComputeButterflyLookupTexture ( float* i_pData )
 	}
 }
 
+/*
+ Merges 2 consecutive radix-2 stages (s, s + 1) into a single radix-4 pass:
+ stage s + 1 reads y1, y2 from stage s, which in turn read (a, b) and (c, d) from the previous stage
+ out = (A + W1 * B) + W2 * (C + W1 * D)
+ NOTE! y1 and y2 have the same position inside their stage s blocks, so both share the same W1 weight
+ Row 2 * p holds the 4 source indices, row 2 * p + 1 holds the 2 complex weights (W1, W2)
+*/
+void GPUFrag2DIFFT::ComputeRadix4ButterflyLookupTexture ( const float* i_pButterflyData, float* o_pData )
+{
+	assert(i_pButterflyData != nullptr);
+	assert(o_pData != nullptr);
+
+	float fFFTSize = static_cast<float>(m_FFTSize);
+
+	for (unsigned short p = 0; p < m_NumRadix4Passes; ++p)
+	{
+		unsigned short s = m_NumRadix2Passes + 2 * p;
+
+		for (unsigned short x = 0; x < m_FFTSize; ++x)
+		{
+			const float* pStage2 = &i_pButterflyData[4 * (x + (s + 1) * m_FFTSize)];
+
+			// stored indices are (j + 0.5) / FFTSize
+			unsigned short y1 = static_cast<unsigned short>(pStage2[0] * fFFTSize);
+			unsigned short y2 = static_cast<unsigned short>(pStage2[1] * fFFTSize);
+
+			const float* pStage1A = &i_pButterflyData[4 * (y1 + s * m_FFTSize)];
+			const float* pStage1B = &i_pButterflyData[4 * (y2 + s * m_FFTSize)];
+
+			unsigned int indicesOffset = 4 * (x + 2 * p * m_FFTSize);
+			o_pData[indicesOffset + 0] = pStage1A[0];
+			o_pData[indicesOffset + 1] = pStage1A[1];
+			o_pData[indicesOffset + 2] = pStage1B[0];
+			o_pData[indicesOffset + 3] = pStage1B[1];
+
+			unsigned int weightsOffset = 4 * (x + (2 * p + 1) * m_FFTSize);
+			o_pData[weightsOffset + 0] = pStage1A[2];
+			o_pData[weightsOffset + 1] = pStage1A[3];
+			o_pData[weightsOffset + 2] = pStage2[2];
+			o_pData[weightsOffset + 3] = pStage2[3];
+		}
+	}
+}
+
 unsigned short GPUFrag2DIFFT::BitReverse ( unsigned short i_I )
 {
 	unsigned short Sum = 0;
@@ -284,6 +466,55 @@ void GPUFrag2DIFFT::ComputeWeight ( unsigned short i_K, float& i_Wr, float& i_Wi
 }
 ////////////////////////////////
 
+void GPUFrag2DIFFT::RenderPingPongPass ( const ShaderManager& i_SM, int i_PingPongMapLocation )
+{
+	if (m_Use2FBOs)
+	{
+		if (&m_pFFTFBM[0] && &m_pFFTFBM[1])
+		{
+			m_pFFTFBM[m_IsPongTarget].Bind();
+
+			m_pFFTFBM[!m_IsPongTarget].BindColorAttachmentByIndex(0);
+			i_SM.SetUniform(i_PingPongMapLocation, m_pFFTFBM[!m_IsPongTarget].GetColorAttachmentTexUnitId(0));
+
+			m_IsPongTarget = !m_IsPongTarget;
+
+			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		}
+	}
+	else
+	{
+		if (m_pFFTFBM)
+		{
+			if (m_IsPongTarget)
+			{
+				// read from Ping (first time Ping texture contains Ht data)
+				m_pFFTFBM->BindColorAttachmentByIndex(0);
+				unsigned short kPingMapTexUnitId = m_pFFTFBM->GetColorAttachmentTexUnitId(0);
+				i_SM.SetUniform(i_PingPongMapLocation, kPingMapTexUnitId);
+				i_SM.SetupFragmentOutputStreams(m_FFTLayerCount, m_FFTLayerCount);
+
+				// write to Pong
+				m_pFFTFBM->SetupDrawBuffers(m_FFTLayerCount, m_FFTLayerCount);
+			}
+			else
+			{
+				// read from Pong
+				m_pFFTFBM->BindColorAttachmentByIndex(1);
+				unsigned short kPongMapTexUnitId = m_pFFTFBM->GetColorAttachmentTexUnitId(1);
+				i_SM.SetUniform(i_PingPongMapLocation, kPongMapTexUnitId);
+				i_SM.SetupFragmentOutputStreams(m_FFTLayerCount, 0);
+
+				// write to Ping
+				m_pFFTFBM->SetupDrawBuffers(m_FFTLayerCount, 0);
+			}
+			m_IsPongTarget = !m_IsPongTarget;
+
+			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		}
+	}
+}
+
 void GPUFrag2DIFFT::Perform2DIFFT ( void )
 {
 	glm::ivec4 oldViewport;
@@ -303,121 +534,74 @@ void GPUFrag2DIFFT::Perform2DIFFT ( void )
 		if (m_pFFTFBM) m_pFFTFBM->Bind();
 	}
 
-	///// Horizontal pass
-	m_HorizontalSM.UseProgram();
-	m_HorizontalMBM.BindModelContext();
+	// rows are sampled at their texel centers inside the radix-4 lookup texture
+	float radix4RowCount = 2.0f * m_NumRadix4Passes;
 
 	m_IsPongTarget = true;
 
-	for (unsigned short i = 0; i < m_NumButterflies; ++ i)
+	///// Horizontal pass
+	if (m_NumRadix2Passes > 0)
 	{
-		m_HorizontalSM.SetUniform(m_HorizontalUniforms.find("u_Step")->second, i / static_cast<float>(m_NumButterflies - 1));
+		m_HorizontalSM.UseProgram();
+		m_HorizontalMBM.BindModelContext();
 
-		if (m_Use2FBOs)
+		for (unsigned short i = 0; i < m_NumRadix2Passes; ++ i)
 		{
-			if (&m_pFFTFBM[0] && &m_pFFTFBM[1])
-			{
-				m_pFFTFBM[m_IsPongTarget].Bind();
+			m_HorizontalSM.SetUniform(m_HorizontalHandles[PASS_UNIFORM_HANDLE::PUH_STEP], i / static_cast<float>(m_NumButterflies - 1));
 
-				m_pFFTFBM[!m_IsPongTarget].BindColorAttachmentByIndex(0);
-				m_HorizontalSM.SetUniform(m_HorizontalUniforms.find("u_PingPongMap")->second, m_pFFTFBM[!m_IsPongTarget].GetColorAttachmentTexUnitId(0));
+			RenderPingPongPass(m_HorizontalSM, m_HorizontalHandles[PASS_UNIFORM_HANDLE::PUH_PING_PONG_MAP]);
+		}
+		m_HorizontalMBM.UnBindModelContext();
+	}
 
-				m_IsPongTarget = !m_IsPongTarget;
+	if (m_NumRadix4Passes > 0)
+	{
+		m_HorizontalRadix4SM.UseProgram();
+		m_HorizontalRadix4MBM.BindModelContext();
 
-				glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-			}
-		}
-		else
+		for (unsigned short i = 0; i < m_NumRadix4Passes; ++ i)
 		{
-			if (m_pFFTFBM)
-			{
-				if (m_IsPongTarget)
-				{
-					// read from Ping (first time Ping texture contains Ht data)
-					m_pFFTFBM->BindColorAttachmentByIndex(0);
-					unsigned short kPingMapTexUnitId = m_pFFTFBM->GetColorAttachmentTexUnitId(0);
-					m_HorizontalSM.SetUniform(m_HorizontalUniforms.find("u_PingPongMap")->second, kPingMapTexUnitId);
-					m_HorizontalSM.SetupFragmentOutputStreams(m_FFTLayerCount, m_FFTLayerCount);
-
-					// write to Pong
-					m_pFFTFBM->SetupDrawBuffers(m_FFTLayerCount, m_FFTLayerCount);
-				}
-				else
-				{
-					// read from Pong
-					m_pFFTFBM->BindColorAttachmentByIndex(1);
-					unsigned short kPongMapTexUnitId = m_pFFTFBM->GetColorAttachmentTexUnitId(1);
-					m_HorizontalSM.SetUniform(m_HorizontalUniforms.find("u_PingPongMap")->second, kPongMapTexUnitId);
-					m_HorizontalSM.SetupFragmentOutputStreams(m_FFTLayerCount, 0);
-
-					// write to Ping
-					m_pFFTFBM->SetupDrawBuffers(m_FFTLayerCount, 0);
-				}
-				m_IsPongTarget = !m_IsPongTarget;
+			m_HorizontalRadix4SM.SetUniform(m_HorizontalRadix4Handles[PASS_UNIFORM_HANDLE::PUH_INDICES_STEP], (2 * i + 0.5f) / radix4RowCount);
+			m_HorizontalRadix4SM.SetUniform(m_HorizontalRadix4Handles[PASS_UNIFORM_HANDLE::PUH_WEIGHTS_STEP], (2 * i + 1.5f) / radix4RowCount);
 
-				glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-			}
+			RenderPingPongPass(m_HorizontalRadix4SM, m_HorizontalRadix4Handles[PASS_UNIFORM_HANDLE::PUH_PING_PONG_MAP]);
 		}
+		m_HorizontalRadix4MBM.UnBindModelContext();
 	}
-	m_HorizontalMBM.UnBindModelContext();
 	
 	/////// Vertical pass
-	m_VerticalSM.UseProgram();
-	m_VerticalMBM.BindModelContext();
-
-	for (unsigned short i = 0; i < m_NumButterflies; ++ i)
+	if (m_NumRadix2Passes > 0)
 	{
-		m_VerticalSM.SetUniform(m_VerticalUniforms.find("u_Step")->second, i / static_cast<float>(m_NumButterflies - 1));
-		if (i == 0) m_VerticalSM.SetUniform(m_VerticalUniforms.find("u_IsLastStep")->second, false);
-		if (i == m_NumButterflies - 1) m_VerticalSM.SetUniform(m_VerticalUniforms.find("u_IsLastStep")->second, true);
+		m_VerticalSM.UseProgram();
+		m_VerticalMBM.BindModelContext();
 
-		if (m_Use2FBOs)
+		for (unsigned short i = 0; i < m_NumRadix2Passes; ++ i)
 		{
-			if (&m_pFFTFBM[0] && &m_pFFTFBM[1])
-			{
-				m_pFFTFBM[m_IsPongTarget].Bind();
+			m_VerticalSM.SetUniform(m_VerticalHandles[PASS_UNIFORM_HANDLE::PUH_STEP], i / static_cast<float>(m_NumButterflies - 1));
+			if (i == 0) m_VerticalSM.SetUniform(m_VerticalHandles[PASS_UNIFORM_HANDLE::PUH_IS_LAST_STEP], false);
+			if (i == m_NumButterflies - 1) m_VerticalSM.SetUniform(m_VerticalHandles[PASS_UNIFORM_HANDLE::PUH_IS_LAST_STEP], true);
 
-				m_pFFTFBM[!m_IsPongTarget].BindColorAttachmentByIndex(0);
-				m_VerticalSM.SetUniform(m_VerticalUniforms.find("u_PingPongMap")->second, m_pFFTFBM[!m_IsPongTarget].GetColorAttachmentTexUnitId(0));
+			RenderPingPongPass(m_VerticalSM, m_VerticalHandles[PASS_UNIFORM_HANDLE::PUH_PING_PONG_MAP]);
+		}
+		m_VerticalMBM.UnBindModelContext();
+	}
 
-				m_IsPongTarget = !m_IsPongTarget;
+	if (m_NumRadix4Passes > 0)
+	{
+		m_VerticalRadix4SM.UseProgram();
+		m_VerticalRadix4MBM.BindModelContext();
 
-				glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-			}
-		}
-		else
+		for (unsigned short i = 0; i < m_NumRadix4Passes; ++ i)
 		{
-			if (m_pFFTFBM)
-			{
-				if (m_IsPongTarget)
-				{
-					// read from Ping
-					m_pFFTFBM->BindColorAttachmentByIndex(0);
-					const unsigned short& kPingMapTexUnitId = m_pFFTFBM->GetColorAttachmentTexUnitId(0);
-					m_VerticalSM.SetUniform(m_VerticalUniforms.find("u_PingPongMap")->second, kPingMapTexUnitId);
-					m_VerticalSM.SetupFragmentOutputStreams(m_FFTLayerCount, m_FFTLayerCount);
-
-					// write to Pong
-					m_pFFTFBM->SetupDrawBuffers(m_FFTLayerCount, m_FFTLayerCount);
-				}
-				else
-				{
-					// read from Pong
-					m_pFFTFBM->BindColorAttachmentByIndex(1);
-					const unsigned short& kPongMapTexUnitId = m_pFFTFBM->GetColorAttachmentTexUnitId(1);
-					m_VerticalSM.SetUniform(m_VerticalUniforms.find("u_PingPongMap")->second, kPongMapTexUnitId);
-					m_VerticalSM.SetupFragmentOutputStreams(m_FFTLayerCount, 0);
-
-					// write to Ping
-					m_pFFTFBM->SetupDrawBuffers(m_FFTLayerCount, 0);
-				}
-				m_IsPongTarget = !m_IsPongTarget;
+			m_VerticalRadix4SM.SetUniform(m_VerticalRadix4Handles[PASS_UNIFORM_HANDLE::PUH_INDICES_STEP], (2 * i + 0.5f) / radix4RowCount);
+			m_VerticalRadix4SM.SetUniform(m_VerticalRadix4Handles[PASS_UNIFORM_HANDLE::PUH_WEIGHTS_STEP], (2 * i + 1.5f) / radix4RowCount);
+			if (i == 0) m_VerticalRadix4SM.SetUniform(m_VerticalRadix4Handles[PASS_UNIFORM_HANDLE::PUH_IS_LAST_STEP], false);
+			if (i == m_NumRadix4Passes - 1) m_VerticalRadix4SM.SetUniform(m_VerticalRadix4Handles[PASS_UNIFORM_HANDLE::PUH_IS_LAST_STEP], true);
 
-				glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-			}
+			RenderPingPongPass(m_VerticalRadix4SM, m_VerticalRadix4Handles[PASS_UNIFORM_HANDLE::PUH_PING_PONG_MAP]);
 		}
+		m_VerticalRadix4MBM.UnBindModelContext();
 	}
-	m_VerticalMBM.UnBindModelContext();
 	
 	// go back to default framebuffer
 	if (m_pFFTFBM) m_pFFTFBM->UnBind();
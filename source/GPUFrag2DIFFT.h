@@ -33,6 +33,10 @@ class GlobalConfig;
  http://stackoverflow.com/questions/25835374/multiple-output-from-fragment-shader-using-a-fbo
  16 bit floating point texture
  http://gamedev.stackexchange.com/questions/67420/how-do-i-efficiently-use-16-bit-texture-coordinates
+
+ Radix-4 mode: every 2 consecutive radix-2 butterfly stages are merged into a single pass,
+ so the number of render passes is halved (for an odd number of stages, the first stage is still done as a radix-2 pass)
+ More details about higher radix FFT: https://en.wikipedia.org/wiki/Cooley%E2%80%93Tukey_FFT_algorithm#Variations
 */
 
 class GPUFrag2DIFFT: public Base2DIFFT
@@ -55,9 +59,12 @@ private:
 	void Destroy(void);
 
 	void ComputeButterflyLookupTexture (float* i_pData);
+	void ComputeRadix4ButterflyLookupTexture (const float* i_pButterflyData, float* o_pData);
 	unsigned short BitReverse(unsigned short i_I);
 	void ComputeWeight(unsigned short i_K, float& i_Wr, float& i_Wi);
 
+	void RenderPingPongPass(const ShaderManager& i_SM, int i_PingPongMapLocation);
+
 	//// Variables ////
 	static const unsigned short m_kPingPongLayerCount = 2;
 
@@ -71,6 +78,35 @@ private:
 	std::map<std::string, int> m_HorizontalUniforms;
 	std::map<std::string, int> m_VerticalUniforms;
 
+	//////// Radix-4 Horizontal and Vertical passes
+	ShaderManager m_HorizontalRadix4SM, m_VerticalRadix4SM;
+	MeshBufferManager m_HorizontalRadix4MBM, m_VerticalRadix4MBM;
+
+	// self init
+	// name, location
+	std::map<std::string, int> m_HorizontalRadix4Uniforms;
+	std::map<std::string, int> m_VerticalRadix4Uniforms;
+
+	// the uniforms set by every butterfly pass (check UniformHandleTable)
+	enum class PASS_UNIFORM_HANDLE
+	{
+		PUH_PING_PONG_MAP = 0,
+		PUH_STEP,
+		PUH_IS_LAST_STEP,
+		PUH_INDICES_STEP,
+		PUH_WEIGHTS_STEP,
+		PUH_COUNT
+	};
+
+	static const char* const m_kPassUniformHandleNames[static_cast<unsigned short>(PASS_UNIFORM_HANDLE::PUH_COUNT)];
+
+	typedef ShaderManager::UniformHandleTable<PASS_UNIFORM_HANDLE, static_cast<unsigned short>(PASS_UNIFORM_HANDLE::PUH_COUNT)> PassUniformHandles;
+	PassUniformHandles m_HorizontalHandles, m_VerticalHandles, m_HorizontalRadix4Handles, m_VerticalRadix4Handles;
+
+	unsigned short m_Radix;
+	// number of passes per direction
+	unsigned short m_NumRadix2Passes, m_NumRadix4Passes;
+
 	bool m_IsPongTarget;
 	bool m_Use2FBOs;
 };
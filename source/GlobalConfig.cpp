@@ -83,6 +83,14 @@ bool GlobalConfig::Setup ( void )
 	Rendering.HDR.Enabled = keyMap["GlobalConfig.Rendering.HDR.Enabled"].ToBool();
 	Rendering.HDR.Exposure = keyMap["GlobalConfig.Rendering.HDR.Exposure"].ToFloat();
 
+	Rendering.QualityGovernor.Enabled = keyMap["GlobalConfig.Rendering.QualityGovernor.Enabled"].ToBool();
+	Rendering.QualityGovernor.TargetFrameTime = keyMap["GlobalConfig.Rendering.QualityGovernor.TargetFrameTime"].ToFloat();
+	Rendering.QualityGovernor.Hysteresis = keyMap["GlobalConfig.Rendering.QualityGovernor.Hysteresis"].ToFloat();
+	Rendering.QualityGovernor.LevelCount = keyMap["GlobalConfig.Rendering.QualityGovernor.LevelCount"].ToInt();
+	Rendering.QualityGovernor.StepDownFrameCount = keyMap["GlobalConfig.Rendering.QualityGovernor.StepDownFrameCount"].ToInt();
+	Rendering.QualityGovernor.StepUpFrameCount = keyMap["GlobalConfig.Rendering.QualityGovernor.StepUpFrameCount"].ToInt();
+	Rendering.QualityGovernor.CooldownFrameCount = keyMap["GlobalConfig.Rendering.QualityGovernor.CooldownFrameCount"].ToInt();
+
 	Shaders.UseStrictVerification = keyMap["GlobalConfig.Shaders.UseStrictVerification"].ToBool();
 
 	// Texture Allocation
@@ -90,12 +98,21 @@ bool GlobalConfig::Setup ( void )
 	TexUnit.Global.RefractionMap = keyMap["GlobalConfig.TexUnit.Global.RefractionMap"].ToInt();
 	TexUnit.Global.PostProcessingMap = keyMap["GlobalConfig.TexUnit.Global.PostProcessingMap"].ToInt();
 	TexUnit.Sky.CubeMapSkyModel.CubeMap = keyMap["GlobalConfig.TexUnit.Sky.CubeMapSkyModel.CubeMap"].ToInt();
+	TexUnit.Sky.ScatteringSkyModel.CubeMapCache = keyMap["GlobalConfig.TexUnit.Sky.ScatteringSkyModel.CubeMapCache"].ToInt();
+	TexUnit.Sky.ScatteringSkyModel.SkyViewLUT = keyMap["GlobalConfig.TexUnit.Sky.ScatteringSkyModel.SkyViewLUT"].ToInt();
+	TexUnit.Sky.ScatteringSkyModel.TransmittanceLUT = keyMap["GlobalConfig.TexUnit.Sky.ScatteringSkyModel.TransmittanceLUT"].ToInt();
+	TexUnit.Sky.ScatteringSkyModel.CloudsNoiseMap = keyMap["GlobalConfig.TexUnit.Sky.ScatteringSkyModel.CloudsNoiseMap"].ToInt();
+	TexUnit.Sky.ScatteringSkyModel.CloudsLowResMap = keyMap["GlobalConfig.TexUnit.Sky.ScatteringSkyModel.CloudsLowResMap"].ToInt();
+	TexUnit.Sky.ScatteringSkyModel.CloudsLowResDepthMap = keyMap["GlobalConfig.TexUnit.Sky.ScatteringSkyModel.CloudsLowResDepthMap"].ToInt();
 	TexUnit.Sky.PrecomputedScatteringSkyModel.IrradianceMap = keyMap["GlobalConfig.TexUnit.Sky.PrecomputedScatteringSkyModel.IrradianceMap"].ToInt();
 	TexUnit.Sky.PrecomputedScatteringSkyModel.InscatterMap = keyMap["GlobalConfig.TexUnit.Sky.PrecomputedScatteringSkyModel.InscatterMap"].ToInt();
 	TexUnit.Sky.PrecomputedScatteringSkyModel.TransmittanceMap = keyMap["GlobalConfig.TexUnit.Sky.PrecomputedScatteringSkyModel.TransmittanceMap"].ToInt();
 	TexUnit.Sky.PrecomputedScatteringSkyModel.NoiseMap = keyMap["GlobalConfig.TexUnit.Sky.PrecomputedScatteringSkyModel.NoiseMap"].ToInt();
+	TexUnit.Sky.PrecomputedScatteringSkyModel.CloudsLowResMap = keyMap["GlobalConfig.TexUnit.Sky.PrecomputedScatteringSkyModel.CloudsLowResMap"].ToInt();
+	TexUnit.Sky.PrecomputedScatteringSkyModel.CloudsLowResDepthMap = keyMap["GlobalConfig.TexUnit.Sky.PrecomputedScatteringSkyModel.CloudsLowResDepthMap"].ToInt();
 	TexUnit.Ocean.CPU2DIFFT.FFTMap = keyMap["GlobalConfig.TexUnit.Ocean.CPU2DIFFT.FFTMap"].ToInt();
 	TexUnit.Ocean.GPU2DIFFT.ButterflyMap = keyMap["GlobalConfig.TexUnit.Ocean.GPU2DIFFT.ButterflyMap"].ToInt();
+	TexUnit.Ocean.GPU2DIFFT.Radix4ButterflyMap = keyMap["GlobalConfig.TexUnit.Ocean.GPU2DIFFT.Radix4ButterflyMap"].ToInt();
 	TexUnit.Ocean.GPU2DIFFT.PingArrayMap = keyMap["GlobalConfig.TexUnit.Ocean.GPU2DIFFT.PingArrayMap"].ToInt(); //11, 12
 	TexUnit.Ocean.GPU2DIFFTComp.IndicesMap = keyMap["GlobalConfig.TexUnit.Ocean.GPU2DIFFTComp.IndicesMap"].ToInt();
 	TexUnit.Ocean.GPU2DIFFTComp.WeightsMap = keyMap["GlobalConfig.TexUnit.Ocean.GPU2DIFFTComp.WeightsMap"].ToInt();
@@ -103,6 +120,7 @@ bool GlobalConfig::Setup ( void )
 	TexUnit.Ocean.FFTNormalGradientFoldingBase.NormalGradientFoldingMap = keyMap["GlobalConfig.TexUnit.Ocean.FFTNormalGradientFoldingBase.NormalGradientFoldingMap"].ToInt();
 	TexUnit.Ocean.FFTOceanPatchGPUFrag.FFTInitDataMap = keyMap["GlobalConfig.TexUnit.Ocean.FFTOceanPatchGPUFrag.FFTInitDataMap"].ToInt();
 	TexUnit.Ocean.FFTOceanPatchGPUComp.FFTInitDataMap = keyMap["GlobalConfig.TexUnit.Ocean.FFTOceanPatchGPUComp.FFTInitDataMap"].ToInt();
+	TexUnit.Ocean.FFTOceanPatchBakedCache.FFTMap = keyMap["GlobalConfig.TexUnit.Ocean.FFTOceanPatchBakedCache.FFTMap"].ToInt();
 	TexUnit.Ocean.Surface.PerlinDisplacementMap = keyMap["GlobalConfig.TexUnit.Ocean.Surface.PerlinDisplacementMap"].ToInt();
 	TexUnit.Ocean.Surface.WavesFoamMap = keyMap["GlobalConfig.TexUnit.Ocean.Surface.WavesFoamMap"].ToInt();
 	TexUnit.Ocean.Surface.BoatFoamMap = keyMap["GlobalConfig.TexUnit.Ocean.Surface.BoatFoamMap"].ToInt();
@@ -110,6 +128,7 @@ bool GlobalConfig::Setup ( void )
 	TexUnit.Ocean.Surface.KelvinWakeDispNormMap = keyMap["GlobalConfig.TexUnit.Ocean.Surface.KelvinWakeDispNormMap"].ToInt();
 	TexUnit.Ocean.Surface.KelvinWakeFoamMap = keyMap["GlobalConfig.TexUnit.Ocean.Surface.KelvinWakeFoamMap"].ToInt();
 	TexUnit.Ocean.UnderWater.GodRaysMap = keyMap["GlobalConfig.TexUnit.Ocean.UnderWater.GodRaysMap"].ToInt();
+	TexUnit.Ocean.UnderWater.GodRaysPassMap = keyMap["GlobalConfig.TexUnit.Ocean.UnderWater.GodRaysPassMap"].ToInt();
 	TexUnit.Ocean.Bottom.SandDiffuseMap = keyMap["GlobalConfig.TexUnit.Ocean.Bottom.SandDiffuseMap"].ToInt();
 	TexUnit.Ocean.Bottom.CausticsMap = keyMap["GlobalConfig.TexUnit.Ocean.Bottom.CausticsMap"].ToInt();
 	TexUnit.MotorBoat.BoatDiffMap = keyMap["GlobalConfig.TexUnit.MotorBoat.BoatDiffMap"].ToInt();
@@ -117,6 +136,10 @@ bool GlobalConfig::Setup ( void )
 
 	VisualEffects.ShowReflections = keyMap["GlobalConfig.VisualEffects.ShowReflections"].ToBool();
 	VisualEffects.ShowRefractions = keyMap["GlobalConfig.VisualEffects.ShowRefractions"].ToBool();
+	VisualEffects.ReflectionRefraction.ResolutionScale = keyMap["GlobalConfig.VisualEffects.ReflectionRefraction.ResolutionScale"].ToFloat();
+	VisualEffects.ReflectionRefraction.UpdateInterval = keyMap["GlobalConfig.VisualEffects.ReflectionRefraction.UpdateInterval"].ToInt();
+	VisualEffects.ReflectionRefraction.MaxReprojectionAngle = keyMap["GlobalConfig.VisualEffects.ReflectionRefraction.MaxReprojectionAngle"].ToFloat();
+	VisualEffects.ReflectionRefraction.UseLayeredRendering = keyMap["GlobalConfig.VisualEffects.ReflectionRefraction.UseLayeredRendering"].ToBool();
 	VisualEffects.PostProcessing.Enabled = keyMap["GlobalConfig.VisualEffects.PostProcessing.Enabled"].ToBool();
 	VisualEffects.PostProcessing.EffectType = keyMap["GlobalConfig.VisualEffects.PostProcessing.EffectType"].ToPostProcessingEffectType();
 
@@ -156,6 +179,17 @@ bool GlobalConfig::Setup ( void )
 	Scene.Sky.Model.Scattering.Clouds.ScaleFactor = keyMap["GlobalConfig.Scene.Sky.Model.Scattering.Clouds.ScaleFactor"].ToFloat();
 	Scene.Sky.Model.Scattering.Clouds.Offset = keyMap["GlobalConfig.Scene.Sky.Model.Scattering.Clouds.Offset"].ToFloat();
 	Scene.Sky.Model.Scattering.Clouds.Altitude = keyMap["GlobalConfig.Scene.Sky.Model.Scattering.Clouds.Altitude"].ToFloat();
+	Scene.Sky.Model.Scattering.Clouds.NoiseBake.Size = keyMap["GlobalConfig.Scene.Sky.Model.Scattering.Clouds.NoiseBake.Size"].ToInt();
+	Scene.Sky.Model.Scattering.Clouds.NoiseBake.OctavesPerGroup = keyMap["GlobalConfig.Scene.Sky.Model.Scattering.Clouds.NoiseBake.OctavesPerGroup"].ToInt();
+	Scene.Sky.Model.Scattering.Clouds.NoiseBake.ThreadCount = keyMap["GlobalConfig.Scene.Sky.Model.Scattering.Clouds.NoiseBake.ThreadCount"].ToInt();
+	Scene.Sky.Model.Scattering.Clouds.Upsampling.Enabled = keyMap["GlobalConfig.Scene.Sky.Model.Scattering.Clouds.Upsampling.Enabled"].ToBool();
+	Scene.Sky.Model.Scattering.Clouds.Upsampling.ResolutionScale = keyMap["GlobalConfig.Scene.Sky.Model.Scattering.Clouds.Upsampling.ResolutionScale"].ToFloat();
+	Scene.Sky.Model.Scattering.CubeMapCache.Enabled = keyMap["GlobalConfig.Scene.Sky.Model.Scattering.CubeMapCache.Enabled"].ToBool();
+	Scene.Sky.Model.Scattering.CubeMapCache.Size = keyMap["GlobalConfig.Scene.Sky.Model.Scattering.CubeMapCache.Size"].ToInt();
+	Scene.Sky.Model.Scattering.CubeMapCache.SunAngleThreshold = glm::radians(keyMap["GlobalConfig.Scene.Sky.Model.Scattering.CubeMapCache.SunAngleThreshold"].ToFloat()); // degrees to radians
+	Scene.Sky.Model.Scattering.SkyViewLUT.Enabled = keyMap["GlobalConfig.Scene.Sky.Model.Scattering.SkyViewLUT.Enabled"].ToBool();
+	Scene.Sky.Model.Scattering.SkyViewLUT.Width = keyMap["GlobalConfig.Scene.Sky.Model.Scattering.SkyViewLUT.Width"].ToInt();
+	Scene.Sky.Model.Scattering.SkyViewLUT.Height = keyMap["GlobalConfig.Scene.Sky.Model.Scattering.SkyViewLUT.Height"].ToInt();
 
 	if (Scene.Sky.Model.Scattering.Sun.IsDynamic) Scene.Sky.Model.Scattering.Sun.AllowChangeDirWithMouse = false;
 
@@ -168,6 +202,12 @@ bool GlobalConfig::Setup ( void )
 	Scene.Sky.Model.PrecomputedScattering.Atmosphere.MieScattering = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Atmosphere.MieScattering"].ToFloat();
 	Scene.Sky.Model.PrecomputedScattering.Atmosphere.Rgtl = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Atmosphere.Rgtl"].ToVec3();
 	Scene.Sky.Model.PrecomputedScattering.Atmosphere.BetaR = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Atmosphere.BetaR"].ToVec3();
+	Scene.Sky.Model.PrecomputedScattering.Atmosphere.RayleighScaleHeight = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Atmosphere.RayleighScaleHeight"].ToFloat();
+	Scene.Sky.Model.PrecomputedScattering.Atmosphere.MieScaleHeight = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Atmosphere.MieScaleHeight"].ToFloat();
+	Scene.Sky.Model.PrecomputedScattering.Atmosphere.MieBeta = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Atmosphere.MieBeta"].ToFloat();
+	Scene.Sky.Model.PrecomputedScattering.Atmosphere.GroundReflectance = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Atmosphere.GroundReflectance"].ToFloat();
+	Scene.Sky.Model.PrecomputedScattering.Precompute.ThreadCount = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Precompute.ThreadCount"].ToInt();
+	Scene.Sky.Model.PrecomputedScattering.Precompute.CacheFileName = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Precompute.CacheFileName"].ToString();
 	Scene.Sky.Model.PrecomputedScattering.Clouds.Enabled = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Clouds.Enabled"].ToBool();
 	Scene.Sky.Model.PrecomputedScattering.Clouds.Octaves = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Clouds.Octaves"].ToInt();
 	Scene.Sky.Model.PrecomputedScattering.Clouds.Lacunarity = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Clouds.Lacunarity"].ToFloat();
@@ -179,6 +219,11 @@ bool GlobalConfig::Setup ( void )
 	Scene.Sky.Model.PrecomputedScattering.Clouds.Offset = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Clouds.Offset"].ToFloat();
 	Scene.Sky.Model.PrecomputedScattering.Clouds.Altitude = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Clouds.Altitude"].ToFloat();
 	Scene.Sky.Model.PrecomputedScattering.Clouds.AltitudeOffset = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Clouds.AltitudeOffset"].ToFloat();
+	Scene.Sky.Model.PrecomputedScattering.Clouds.NoiseBake.Size = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Clouds.NoiseBake.Size"].ToInt();
+	Scene.Sky.Model.PrecomputedScattering.Clouds.NoiseBake.OctavesPerGroup = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Clouds.NoiseBake.OctavesPerGroup"].ToInt();
+	Scene.Sky.Model.PrecomputedScattering.Clouds.NoiseBake.ThreadCount = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Clouds.NoiseBake.ThreadCount"].ToInt();
+	Scene.Sky.Model.PrecomputedScattering.Clouds.Upsampling.Enabled = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Clouds.Upsampling.Enabled"].ToBool();
+	Scene.Sky.Model.PrecomputedScattering.Clouds.Upsampling.ResolutionScale = keyMap["GlobalConfig.Scene.Sky.Model.PrecomputedScattering.Clouds.Upsampling.ResolutionScale"].ToFloat();
 
 	if (Scene.Sky.Model.PrecomputedScattering.Sun.IsDynamic) Scene.Sky.Model.PrecomputedScattering.Sun.AllowChangeDirWithMouse = false;
 
@@ -187,7 +232,24 @@ bool GlobalConfig::Setup ( void )
 	Scene.Ocean.Grid.Type = keyMap["GlobalConfig.Scene.Ocean.Grid.Type"].ToOceanGridType();
 	Scene.Ocean.Grid.WorldSpace.Width = keyMap["GlobalConfig.Scene.Ocean.Grid.WorldSpace.Width"].ToInt();
 	Scene.Ocean.Grid.WorldSpace.Height = keyMap["GlobalConfig.Scene.Ocean.Grid.WorldSpace.Height"].ToInt();
+	Scene.Ocean.Grid.UseProceduralGrid = keyMap["GlobalConfig.Scene.Ocean.Grid.UseProceduralGrid"].ToBool();
 	Scene.Ocean.Grid.ScreenSpace.GridResolution = keyMap["GlobalConfig.Scene.Ocean.Grid.ScreenSpace.GridResolution"].ToFloat();
+	Scene.Ocean.Grid.CPUProjected.Width = keyMap["GlobalConfig.Scene.Ocean.Grid.CPUProjected.Width"].ToInt();
+	Scene.Ocean.Grid.CPUProjected.Height = keyMap["GlobalConfig.Scene.Ocean.Grid.CPUProjected.Height"].ToInt();
+	Scene.Ocean.Grid.CPUProjected.ThreadCount = keyMap["GlobalConfig.Scene.Ocean.Grid.CPUProjected.ThreadCount"].ToInt();
+	Scene.Ocean.Grid.Clipmap.TileResolution = keyMap["GlobalConfig.Scene.Ocean.Grid.Clipmap.TileResolution"].ToInt();
+	Scene.Ocean.Grid.Clipmap.LevelCount = keyMap["GlobalConfig.Scene.Ocean.Grid.Clipmap.LevelCount"].ToInt();
+	Scene.Ocean.Grid.Clipmap.CellSize = keyMap["GlobalConfig.Scene.Ocean.Grid.Clipmap.CellSize"].ToFloat();
+	Scene.Ocean.Grid.Clipmap.MorphRegion = keyMap["GlobalConfig.Scene.Ocean.Grid.Clipmap.MorphRegion"].ToFloat();
+	Scene.Ocean.Grid.Quadtree.TileResolution = keyMap["GlobalConfig.Scene.Ocean.Grid.Quadtree.TileResolution"].ToInt();
+	Scene.Ocean.Grid.Quadtree.LODCount = keyMap["GlobalConfig.Scene.Ocean.Grid.Quadtree.LODCount"].ToInt();
+	Scene.Ocean.Grid.Quadtree.CellSize = keyMap["GlobalConfig.Scene.Ocean.Grid.Quadtree.CellSize"].ToFloat();
+	Scene.Ocean.Grid.Quadtree.MaxScreenSpaceError = keyMap["GlobalConfig.Scene.Ocean.Grid.Quadtree.MaxScreenSpaceError"].ToFloat();
+	Scene.Ocean.Grid.Quadtree.MorphRegion = keyMap["GlobalConfig.Scene.Ocean.Grid.Quadtree.MorphRegion"].ToFloat();
+	Scene.Ocean.Grid.Tessellated.PatchCount = keyMap["GlobalConfig.Scene.Ocean.Grid.Tessellated.PatchCount"].ToInt();
+	Scene.Ocean.Grid.Tessellated.PatchSize = keyMap["GlobalConfig.Scene.Ocean.Grid.Tessellated.PatchSize"].ToFloat();
+	Scene.Ocean.Grid.Tessellated.MaxTessLevel = keyMap["GlobalConfig.Scene.Ocean.Grid.Tessellated.MaxTessLevel"].ToFloat();
+	Scene.Ocean.Grid.Tessellated.TargetEdgeLength = keyMap["GlobalConfig.Scene.Ocean.Grid.Tessellated.TargetEdgeLength"].ToFloat();
 
 	Scene.Ocean.Surface.Projector.Position = keyMap["GlobalConfig.Scene.Ocean.Surface.Projector.Position"].ToVec3();
 	Scene.Ocean.Surface.Projector.Normal = keyMap["GlobalConfig.Scene.Ocean.Surface.Projector.Normal"].ToVec3();
@@ -227,6 +289,9 @@ bool GlobalConfig::Setup ( void )
 	Scene.Ocean.Surface.OceanPatch.DispersionFrequencyTimePeriod = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.DispersionFrequencyTimePeriod"].ToFloat();
 	Scene.Ocean.Surface.OceanPatch.ChoppyScale = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ChoppyScale"].ToFloat();
 	Scene.Ocean.Surface.OceanPatch.TileScale = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.TileScale"].ToFloat();
+	//Available only for CFT_CPU_FFTW type
+	Scene.Ocean.Surface.OceanPatch.Cascades.Count = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.Cascades.Count"].ToInt();
+	Scene.Ocean.Surface.OceanPatch.Cascades.PatchSizeRatio = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.Cascades.PatchSizeRatio"].ToFloat();
 
 	Scene.Ocean.Surface.OceanPatch.Spectrum.Phillips.OpposingWavesFactor = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.Spectrum.Phillips.OpposingWavesFactor"].ToFloat();
 	Scene.Ocean.Surface.OceanPatch.Spectrum.Phillips.VerySmallWavesFactor = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.Spectrum.Phillips.VerySmallWavesFactor"].ToFloat();
@@ -237,7 +302,20 @@ bool GlobalConfig::Setup ( void )
 
 	Scene.Ocean.Surface.OceanPatch.ComputeFFT.UseFFTSlopes = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.UseFFTSlopes"].ToBool();
 	Scene.Ocean.Surface.OceanPatch.ComputeFFT.Use2FBOs = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.Use2FBOs"].ToBool(); //Available only for CFT_GPU_FRAG type
+	Scene.Ocean.Surface.OceanPatch.ComputeFFT.Radix = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.Radix"].ToInt(); //Available only for CFT_GPU_FRAG type: 2 or 4
+	Scene.Ocean.Surface.OceanPatch.ComputeFFT.UseCPUMipMaps = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.UseCPUMipMaps"].ToBool(); //Available only for CFT_CPU_FFTW type
+	Scene.Ocean.Surface.OceanPatch.ComputeFFT.SpectralMipMaps.Enabled = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.SpectralMipMaps.Enabled"].ToBool(); //Available only for CFT_CPU_FFTW type
+	Scene.Ocean.Surface.OceanPatch.ComputeFFT.SpectralMipMaps.LevelCount = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.SpectralMipMaps.LevelCount"].ToInt();
 	Scene.Ocean.Surface.OceanPatch.ComputeFFT.Type = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.Type"].ToOceanComputeFFTType();
+	//Available only for CFT_BAKED_CACHE type
+	Scene.Ocean.Surface.OceanPatch.ComputeFFT.BakedCache.FileName = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.BakedCache.FileName"].ToString();
+	Scene.Ocean.Surface.OceanPatch.ComputeFFT.BakedCache.FrameRate = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.BakedCache.FrameRate"].ToFloat();
+	Scene.Ocean.Surface.OceanPatch.ComputeFFT.BakedCache.BakeType = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.BakedCache.BakeType"].ToOceanComputeFFTType();
+	Scene.Ocean.Surface.OceanPatch.ComputeFFT.BakedCache.UseInterpolation = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.BakedCache.UseInterpolation"].ToBool();
+	//Available only for CFT_CPU_FFTW type
+	Scene.Ocean.Surface.OceanPatch.ComputeFFT.SharedMemoryPublisher.Enabled = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.SharedMemoryPublisher.Enabled"].ToBool();
+	Scene.Ocean.Surface.OceanPatch.ComputeFFT.SharedMemoryPublisher.Name = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.SharedMemoryPublisher.Name"].ToString();
+	Scene.Ocean.Surface.OceanPatch.ComputeFFT.SharedMemoryPublisher.SlotCount = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.ComputeFFT.SharedMemoryPublisher.SlotCount"].ToInt();
 
 	Scene.Ocean.Surface.OceanPatch.Spectrum.Type = keyMap["GlobalConfig.Scene.Ocean.Surface.OceanPatch.Spectrum.Type"].ToOceanSpectrumType();
 
@@ -274,6 +352,11 @@ bool GlobalConfig::Setup ( void )
 	Scene.Ocean.UnderWater.GodRays.Occluder.Size = keyMap["GlobalConfig.Scene.Ocean.UnderWater.GodRays.Occluder.Size"].ToInt();
 	Scene.Ocean.UnderWater.GodRays.Occluder.Step = keyMap["GlobalConfig.Scene.Ocean.UnderWater.GodRays.Occluder.Step"].ToInt();
 
+	Scene.Ocean.UnderWater.GodRays.MultiPass.Enabled = keyMap["GlobalConfig.Scene.Ocean.UnderWater.GodRays.MultiPass.Enabled"].ToBool();
+	Scene.Ocean.UnderWater.GodRays.MultiPass.PassCount = keyMap["GlobalConfig.Scene.Ocean.UnderWater.GodRays.MultiPass.PassCount"].ToInt();
+	Scene.Ocean.UnderWater.GodRays.MultiPass.SamplesPerPass = keyMap["GlobalConfig.Scene.Ocean.UnderWater.GodRays.MultiPass.SamplesPerPass"].ToInt();
+	Scene.Ocean.UnderWater.GodRays.MultiPass.ResolutionScale = keyMap["GlobalConfig.Scene.Ocean.UnderWater.GodRays.MultiPass.ResolutionScale"].ToFloat();
+
 	Scene.Ocean.Bottom.PatchSize = keyMap["GlobalConfig.Scene.Ocean.Bottom.PatchSize"].ToFloat();
 
 	Scene.Ocean.Bottom.Projector.Position = keyMap["GlobalConfig.Scene.Ocean.Bottom.Projector.Position"].ToVec3();
@@ -299,6 +382,11 @@ bool GlobalConfig::Setup ( void )
 	Scene.Ocean.Bottom.Caustics.Intensity = keyMap["GlobalConfig.Scene.Ocean.Bottom.Caustics.Intensity"].ToFloat();
 	Scene.Ocean.Bottom.Caustics.PlaneDistanceOffset = keyMap["GlobalConfig.Scene.Ocean.Bottom.Caustics.PlaneDistanceOffset"].ToFloat();
 	Scene.Ocean.Bottom.Caustics.Scale = keyMap["GlobalConfig.Scene.Ocean.Bottom.Caustics.Scale"].ToFloat();
+	Scene.Ocean.Bottom.Caustics.Baked.Enabled = keyMap["GlobalConfig.Scene.Ocean.Bottom.Caustics.Baked.Enabled"].ToBool();
+	Scene.Ocean.Bottom.Caustics.Baked.Size = keyMap["GlobalConfig.Scene.Ocean.Bottom.Caustics.Baked.Size"].ToInt();
+	Scene.Ocean.Bottom.Caustics.Baked.FrameCount = keyMap["GlobalConfig.Scene.Ocean.Bottom.Caustics.Baked.FrameCount"].ToInt();
+	Scene.Ocean.Bottom.Caustics.Baked.RayDensity = keyMap["GlobalConfig.Scene.Ocean.Bottom.Caustics.Baked.RayDensity"].ToInt();
+	Scene.Ocean.Bottom.Caustics.Baked.ThreadCount = keyMap["GlobalConfig.Scene.Ocean.Bottom.Caustics.Baked.ThreadCount"].ToInt();
 
 	Scene.Boat.Position = keyMap["GlobalConfig.Scene.Boat.Position"].ToVec3();
 	Scene.Boat.KelvinWakeOffset = keyMap["GlobalConfig.Scene.Boat.KelvinWakeOffset"].ToFloat();
@@ -347,6 +435,10 @@ bool GlobalConfig::Setup ( void )
 	ShaderDefines.Ocean.Surface.FFTSize = ss.str();
 
 	ShaderDefines.HDR = Rendering.HDR.Enabled ? "#define HDR\n" : "#define NO_HDR\n";
+	ShaderDefines.LayeredReflRefr = VisualEffects.ReflectionRefraction.UseLayeredRendering ? "#define LAYERED_REFL_REFR\n" : "#define NO_LAYERED_REFL_REFR\n";
+	ShaderDefines.Sky.SkyViewLUT = Scene.Sky.Model.Scattering.SkyViewLUT.Enabled ? "#define SKY_VIEW_LUT\n" : "#define NO_SKY_VIEW_LUT\n";
+	// the CPU projected grid streams its own vertices, so it keeps the buffers (check Ocean::Initialize())
+	ShaderDefines.Ocean.Grid.Procedural = (Scene.Ocean.Grid.UseProceduralGrid && Scene.Ocean.Grid.Type != CustomTypes::Ocean::GridType::GT_CPU_PROJECTED) ? "#define PROCEDURAL_GRID\n" : "#define NO_PROCEDURAL_GRID\n";
 	ShaderDefines.Ocean.Surface.GridCorners = Scene.Ocean.Surface.Projector.UseGridCorners ? "#define USE_GRID_CORNERS_SURFACE\n" : "#define NO_USE_GRID_CORNERS_SURFACE\n";
 	ShaderDefines.Ocean.Surface.Foam = Scene.Ocean.Surface.Foam.Enabled ? "#define WAVES_FOAM\n" : "#define NO_WAVES_FOAM\n";
 	ShaderDefines.Ocean.Surface.SSS = Scene.Ocean.Surface.SubSurfaceScattering.Enabled ? "#define WAVES_SSS\n" : "#define NO_WAVES_SSS\n";
@@ -359,6 +451,7 @@ bool GlobalConfig::Setup ( void )
 	ShaderDefines.Ocean.Bottom.GridCorners = Scene.Ocean.Bottom.Projector.UseGridCorners ? "#define USE_GRID_CORNERS_BOTTOM\n" : "#define NO_USE_GRID_CORNERS_BOTTOM\n";
 	ShaderDefines.Ocean.Bottom.UnderWaterFog = Scene.Ocean.Bottom.Fog.Enabled ? "#define UNDERWATER_FOG_BOTTOM\n" : "#define NO_UNDERWATER_FOG_BOTTOM\n";
 	ShaderDefines.Ocean.Bottom.Caustics = Scene.Ocean.Bottom.Caustics.Enabled ? "#define UNDERWATER_CAUSTICS\n" : "#define NO_UNDERWATER_CAUSTICS\n";
+	ShaderDefines.Ocean.Bottom.BakedCaustics = (Scene.Ocean.Bottom.Caustics.Enabled && Scene.Ocean.Bottom.Caustics.Baked.Enabled) ? "#define BAKED_CAUSTICS\n" : "#define NO_BAKED_CAUSTICS\n";
 
 	return true;
 }
@@ -72,6 +72,18 @@ public:
 			bool Enabled;
 			float Exposure;
 		} HDR;
+
+		struct QualityGovernor
+		{
+			bool Enabled;
+			// milliseconds
+			float TargetFrameTime;
+			float Hysteresis;
+			unsigned short LevelCount;
+			unsigned short StepDownFrameCount;
+			unsigned short StepUpFrameCount;
+			unsigned short CooldownFrameCount;
+		} QualityGovernor;
 	} Rendering;
 
 	struct Shaders
@@ -97,6 +109,12 @@ public:
 
 			struct ScatteringSkyModel
 			{
+				unsigned short CubeMapCache;
+				unsigned short SkyViewLUT;
+				unsigned short TransmittanceLUT;
+				unsigned short CloudsNoiseMap;
+				unsigned short CloudsLowResMap;
+				unsigned short CloudsLowResDepthMap;
 			} ScatteringSkyModel;
 
 			struct PrecomputedScatteringSkyModel
@@ -105,6 +123,8 @@ public:
 				unsigned short InscatterMap;
 				unsigned short TransmittanceMap;
 				unsigned short NoiseMap;
+				unsigned short CloudsLowResMap;
+				unsigned short CloudsLowResDepthMap;
 			} PrecomputedScatteringSkyModel;
 		} Sky;
 
@@ -118,6 +138,7 @@ public:
 			struct GPU2DIFFT
 			{
 				unsigned short ButterflyMap;
+				unsigned short Radix4ButterflyMap;
 				unsigned short PingArrayMap;
 			} GPU2DIFFT;
 
@@ -159,6 +180,11 @@ public:
 				unsigned short FFTInitDataMap;
 			} FFTOceanPatchGPUComp;
 
+			struct FFTOceanPatchBakedCache
+			{
+				unsigned short FFTMap;
+			} FFTOceanPatchBakedCache;
+
 			struct Surface
 			{
 				unsigned short PerlinDisplacementMap;
@@ -172,6 +198,7 @@ public:
 			struct UnderWater
 			{
 				unsigned short GodRaysMap;
+				unsigned short GodRaysPassMap;
 			} UnderWater;
 
 			struct Bottom
@@ -193,6 +220,19 @@ public:
 		bool ShowReflections;
 		bool ShowRefractions;
 
+		// the local reflection and refraction maps
+		struct ReflectionRefraction
+		{
+			// of the window size
+			float ResolutionScale;
+			// the maps are rendered every UpdateInterval frames and reprojected in between
+			unsigned short UpdateInterval;
+			// degrees, a bigger camera rotation since the last update renders the maps right away
+			float MaxReprojectionAngle;
+			// both maps are rendered in one pass, side by side in a double width map
+			bool UseLayeredRendering;
+		} ReflectionRefraction;
+
 		struct PostProcessing
 		{
 			bool Enabled;
@@ -258,7 +298,34 @@ public:
 						float ScaleFactor;
 						float Offset;
 						float Altitude;
+
+						struct NoiseBake
+						{
+							unsigned short Size;
+							unsigned short OctavesPerGroup;
+							unsigned short ThreadCount;
+						} NoiseBake;
+
+						struct Upsampling
+						{
+							bool Enabled;
+							float ResolutionScale;
+						} Upsampling;
 					} Clouds;
+
+					struct CubeMapCache
+					{
+						bool Enabled;
+						unsigned short Size;
+						float SunAngleThreshold;
+					} CubeMapCache;
+
+					struct SkyViewLUT
+					{
+						bool Enabled;
+						unsigned short Width;
+						unsigned short Height;
+					} SkyViewLUT;
 				} Scattering;
 
 				struct PrecomputedScattering
@@ -278,8 +345,18 @@ public:
 						float MieScattering;
 						glm::vec3 Rgtl;
 						glm::vec3 BetaR;
+						float RayleighScaleHeight;
+						float MieScaleHeight;
+						float MieBeta;
+						float GroundReflectance;
 					} Atmosphere;
 
+					struct Precompute
+					{
+						unsigned short ThreadCount;
+						std::string CacheFileName;
+					} Precompute;
+
 					struct Clouds
 					{
 						bool Enabled;
@@ -293,6 +370,19 @@ public:
 						float Offset;
 						float Altitude;
 						float AltitudeOffset;
+
+						struct NoiseBake
+						{
+							unsigned short Size;
+							unsigned short OctavesPerGroup;
+							unsigned short ThreadCount;
+						} NoiseBake;
+
+						struct Upsampling
+						{
+							bool Enabled;
+							float ResolutionScale;
+						} Upsampling;
 					} Clouds;
 				} PrecomputedScattering;
 			} Model;
@@ -305,6 +395,8 @@ public:
 			struct Grid
 			{
 				CustomTypes::Ocean::GridType Type;
+				// the grid vertices are generated in the vertex shaders from gl_VertexID, there are no vertex and index buffers
+				bool UseProceduralGrid;
 
 				struct WorldSpace
 				{
@@ -316,6 +408,38 @@ public:
 				{
 					float GridResolution;
 				} ScreenSpace;
+
+				struct CPUProjected
+				{
+					unsigned short Width;
+					unsigned short Height;
+					unsigned short ThreadCount;
+				} CPUProjected;
+
+				struct Clipmap
+				{
+					unsigned short TileResolution;
+					unsigned short LevelCount;
+					float CellSize;
+					float MorphRegion;
+				} Clipmap;
+
+				struct Quadtree
+				{
+					unsigned short TileResolution;
+					unsigned short LODCount;
+					float CellSize;
+					float MaxScreenSpaceError;
+					float MorphRegion;
+				} Quadtree;
+
+				struct Tessellated
+				{
+					unsigned short PatchCount;
+					float PatchSize;
+					float MaxTessLevel;
+					float TargetEdgeLength;
+				} Tessellated;
 			} Grid;
 
 			struct Surface
@@ -350,11 +474,40 @@ public:
 					float ChoppyScale;
 					float TileScale;
 
+					struct Cascades
+					{
+						unsigned short Count;
+						float PatchSizeRatio;
+					} Cascades;
+
 					struct ComputeFFT
 					{
 						CustomTypes::Ocean::ComputeFFTType Type;
 						bool UseFFTSlopes;
 						bool Use2FBOs;
+						unsigned short Radix;
+						bool UseCPUMipMaps;
+
+						struct SpectralMipMaps
+						{
+							bool Enabled;
+							unsigned short LevelCount;
+						} SpectralMipMaps;
+
+						struct BakedCache
+						{
+							std::string FileName;
+							float FrameRate;
+							CustomTypes::Ocean::ComputeFFTType BakeType;
+							bool UseInterpolation;
+						} BakedCache;
+
+						struct SharedMemoryPublisher
+						{
+							bool Enabled;
+							std::string Name;
+							unsigned short SlotCount;
+						} SharedMemoryPublisher;
 					} ComputeFFT;
 
 					struct Spectrum
@@ -479,6 +632,14 @@ public:
 						unsigned short Size;
 						unsigned short Step;
 					} Occluder;
+
+					struct MultiPass
+					{
+						bool Enabled;
+						unsigned short PassCount;
+						unsigned short SamplesPerPass;
+						float ResolutionScale;
+					} MultiPass;
 				} GodRays;
 			} UnderWater;
 
@@ -522,6 +683,16 @@ public:
 					float Intensity;
 					float PlaneDistanceOffset;
 					float Scale;
+
+					// looping atlas baked on the CPU (check CausticsBaker)
+					struct Baked
+					{
+						bool Enabled;
+						unsigned short Size;
+						unsigned short FrameCount;
+						unsigned short RayDensity;
+						unsigned short ThreadCount;
+					} Baked;
 				} Caustics;
 			} Bottom;
 		} Ocean;
@@ -550,8 +721,20 @@ public:
 
 		std::string HDR;
 
+		std::string LayeredReflRefr;
+
+		struct Sky
+		{
+			std::string SkyViewLUT;
+		} Sky;
+
 		struct Ocean
 		{
+			struct Grid
+			{
+				std::string Procedural;
+			} Grid;
+
 			struct Surface
 			{
 				std::string GridCorners;
@@ -581,15 +764,16 @@ public:
 				std::string GridCorners;
 				std::string UnderWaterFog;
 				std::string Caustics;
+				std::string BakedCaustics;
 			} Bottom;
 		} Ocean;
 
 		std::string GetOptionsString (void) const
 		{
-			std::string options = HDR + Ocean.Surface.FFTSize + Ocean.Surface.GridCorners + Ocean.Surface.Foam + Ocean.Surface.SSS +
+			std::string options = HDR + LayeredReflRefr + Sky.SkyViewLUT + Ocean.Grid.Procedural + Ocean.Surface.FFTSize + Ocean.Surface.GridCorners + Ocean.Surface.Foam + Ocean.Surface.SSS +
 				Ocean.Surface.BoatEffects.Foam + Ocean.Surface.BoatEffects.KelvinWake + Ocean.Surface.BoatEffects.PropellerWash +
 				Ocean.Surface.UnderWaterFog + Ocean.UnderWater.Fog + Ocean.UnderWater.GodRays + Ocean.Bottom.GridCorners +
-				Ocean.Bottom.UnderWaterFog + Ocean.Bottom.Caustics;
+				Ocean.Bottom.UnderWaterFog + Ocean.Bottom.Caustics + Ocean.Bottom.BakedCaustics;
 
 			return options;
 		}
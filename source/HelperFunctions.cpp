@@ -4,7 +4,7 @@
 // glm::vec3, glm::vec4, glm::mat4 come from the header
 #include "glm/mat3x3.hpp"
 #include "glm/common.hpp" //abs()
-#include "glm/geometric.hpp" //dot(), normalize()
+#include "glm/geometric.hpp" //dot(), normalize(), length()
 #include "glm/gtc/constants.hpp" //epsilon()
 
 
@@ -151,4 +151,44 @@ namespace HelperFunctions
 
 		return mirrored;
 	}
+
+	void ExtractFrustumPlanes ( const glm::mat4& i_ProjectionViewMatrix, glm::vec4 o_Planes[6] )
+	{
+		// glm matrices are column major, so the rows are built by hand
+		glm::vec4 row[4];
+		for (unsigned short i = 0; i < 4; ++i)
+		{
+			row[i] = glm::vec4(i_ProjectionViewMatrix[0][i], i_ProjectionViewMatrix[1][i], i_ProjectionViewMatrix[2][i], i_ProjectionViewMatrix[3][i]);
+		}
+
+		o_Planes[0] = row[3] + row[0]; // left
+		o_Planes[1] = row[3] - row[0]; // right
+		o_Planes[2] = row[3] + row[1]; // bottom
+		o_Planes[3] = row[3] - row[1]; // top
+		o_Planes[4] = row[3] + row[2]; // near
+		o_Planes[5] = row[3] - row[2]; // far
+
+		for (unsigned short i = 0; i < 6; ++i)
+		{
+			o_Planes[i] /= glm::length(o_Planes[i].xyz());
+		}
+	}
+
+	bool IsBoxInsideFrustum ( const glm::vec4 i_Planes[6], const glm::vec3& i_BoxMin, const glm::vec3& i_BoxMax )
+	{
+		for (unsigned short i = 0; i < 6; ++i)
+		{
+			// the box corner that is the farthest along the plane normal
+			glm::vec3 positiveVertex(i_Planes[i].x >= 0.0f ? i_BoxMax.x : i_BoxMin.x,
+									 i_Planes[i].y >= 0.0f ? i_BoxMax.y : i_BoxMin.y,
+									 i_Planes[i].z >= 0.0f ? i_BoxMax.z : i_BoxMin.z);
+
+			if (PlaneDotPosition(i_Planes[i], positiveVertex) < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
 }
\ No newline at end of file
@@ -67,6 +67,15 @@ namespace HelperFunctions
 	glm::vec3 ProjectPositionOnPlane ( const glm::vec4& i_Plane, const glm::vec3& i_Position );
 
 	glm::vec3 MirrorPointToPlane ( const glm::vec4& i_Plane, const glm::vec3& i_Point );
+
+	////// FRUSTUM ///////////////
+	// extracts the 6 clipping planes (left, right, bottom, top, near, far) from a projection * view matrix
+	// the planes are normalized and point inside the frustum
+	// source: http://www.cs.otago.ac.nz/postgrads/alexis/planeExtraction.pdf
+	void ExtractFrustumPlanes ( const glm::mat4& i_ProjectionViewMatrix, glm::vec4 o_Planes[6] );
+
+	// conservative test, a box that is close to a frustum corner may be reported as visible
+	bool IsBoxInsideFrustum ( const glm::vec4 i_Planes[6], const glm::vec3& i_BoxMin, const glm::vec3& i_BoxMax );
 }
 
 #endif /* HELPER_FUNCTIONS_H */
@@ -569,8 +569,11 @@ SDL_Window* InitGLContext(void)
 	{
 		LOG("NO to Geometry Shaders!");
 
-		// Fallback to world_space grid
-		g_Config.Scene.Ocean.Grid.Type = CustomTypes::Ocean::GridType::GT_WORLD_SPACE;
+		// Fallback to world_space grid, only the screen space grid needs geometry shaders
+		if (g_Config.Scene.Ocean.Grid.Type == CustomTypes::Ocean::GridType::GT_SCREEN_SPACE)
+		{
+			g_Config.Scene.Ocean.Grid.Type = CustomTypes::Ocean::GridType::GT_WORLD_SPACE;
+		}
 	}
 
 	if (g_Config.GLExtVars.IsComputeShaderSupported)
@@ -612,6 +615,39 @@ SDL_Window* InitGLContext(void)
 		LOG("NO to Compute Shaders!");
 	}
 
+	if (g_Config.GLExtVars.IsTessellationShaderSupported)
+	{
+		LOG("YES to Tessellation Shaders!");
+
+		int maxTessGenLevel = 0;
+		glGetIntegerv(GL_MAX_TESS_GEN_LEVEL, &maxTessGenLevel);
+		LOG("Max Tessellation Level: %d", maxTessGenLevel);
+
+		int maxPatchVertices = 0;
+		glGetIntegerv(GL_MAX_PATCH_VERTICES, &maxPatchVertices);
+		LOG("Max Patch Vertices: %d", maxPatchVertices);
+	}
+	else
+	{
+		LOG("NO to Tessellation Shaders!");
+
+		// Fallback to world_space grid, only the tessellated grid needs tessellation shaders
+		if (g_Config.Scene.Ocean.Grid.Type == CustomTypes::Ocean::GridType::GT_TESSELLATED)
+		{
+			g_Config.Scene.Ocean.Grid.Type = CustomTypes::Ocean::GridType::GT_WORLD_SPACE;
+		}
+	}
+
+	if (g_Config.GLExtVars.IsTimerQuerySupported)
+	{
+		LOG("YES to Timer Queries!");
+	}
+	else
+	{
+		// the quality governor uses the frame delta time instead of the GPU time
+		LOG("NO to Timer Queries!");
+	}
+
 	if (g_Config.GLExtVars.IsTexAnisoFilterSupported)
 	{
 		LOG("YES to Anisotropic Filtering!");
@@ -0,0 +1,162 @@
+/* Author: BAIRAC MIHAI */
+
+#include "MemoryMappedFile.h"
+#include "CommonHeaders.h"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h> // mmap(), munmap()
+#include <sys/stat.h> // fstat()
+#include <fcntl.h> // open()
+#include <unistd.h> // close()
+#endif // _WIN32
+
+
+MemoryMappedFile::MemoryMappedFile ( void )
+	: m_pData(nullptr), m_Size(0),
+#ifdef _WIN32
+	  m_FileHandle(INVALID_HANDLE_VALUE), m_MappingHandle(nullptr)
+#else
+	  m_FileDescriptor(-1)
+#endif // _WIN32
+{
+	LOG("MemoryMappedFile successfully created!");
+}
+
+MemoryMappedFile::MemoryMappedFile ( const std::string& i_FileName )
+	: m_pData(nullptr), m_Size(0),
+#ifdef _WIN32
+	  m_FileHandle(INVALID_HANDLE_VALUE), m_MappingHandle(nullptr)
+#else
+	  m_FileDescriptor(-1)
+#endif // _WIN32
+{
+	Open(i_FileName);
+}
+
+MemoryMappedFile::~MemoryMappedFile ( void )
+{
+	Close();
+
+	LOG("MemoryMappedFile successfully destroyed!");
+}
+
+bool MemoryMappedFile::Open ( const std::string& i_FileName )
+{
+	if (i_FileName.empty())
+	{
+		ERR("Empty file name!");
+		return false;
+	}
+
+	// a file might already be mapped
+	Close();
+
+#ifdef _WIN32
+	m_FileHandle = CreateFileA(i_FileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_FileHandle == INVALID_HANDLE_VALUE)
+	{
+		ERR("Failed to open %s file!", i_FileName.c_str());
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(m_FileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		ERR("Failed to get the size of %s file!", i_FileName.c_str());
+		Close();
+		return false;
+	}
+	m_Size = static_cast<size_t>(fileSize.QuadPart);
+
+	m_MappingHandle = CreateFileMappingA(m_FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m_MappingHandle)
+	{
+		ERR("Failed to create the file mapping of %s file!", i_FileName.c_str());
+		Close();
+		return false;
+	}
+
+	m_pData = static_cast<const unsigned char*>(MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+	m_FileDescriptor = open(i_FileName.c_str(), O_RDONLY);
+	if (m_FileDescriptor == -1)
+	{
+		ERR("Failed to open %s file!", i_FileName.c_str());
+		return false;
+	}
+
+	struct stat fileStat;
+	if (fstat(m_FileDescriptor, &fileStat) == -1 || fileStat.st_size == 0)
+	{
+		ERR("Failed to get the size of %s file!", i_FileName.c_str());
+		Close();
+		return false;
+	}
+	m_Size = static_cast<size_t>(fileStat.st_size);
+
+	void* pData = mmap(nullptr, m_Size, PROT_READ, MAP_SHARED, m_FileDescriptor, 0);
+	m_pData = (pData == MAP_FAILED ? nullptr : static_cast<const unsigned char*>(pData));
+#endif // _WIN32
+
+	if (!m_pData)
+	{
+		ERR("Failed to map %s file in memory!", i_FileName.c_str());
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void MemoryMappedFile::Close ( void )
+{
+#ifdef _WIN32
+	if (m_pData)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+
+	if (m_MappingHandle)
+	{
+		CloseHandle(m_MappingHandle);
+		m_MappingHandle = nullptr;
+	}
+
+	if (m_FileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_FileHandle);
+		m_FileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (m_pData)
+	{
+		munmap(const_cast<unsigned char*>(m_pData), m_Size);
+	}
+
+	if (m_FileDescriptor != -1)
+	{
+		close(m_FileDescriptor);
+		m_FileDescriptor = -1;
+	}
+#endif // _WIN32
+
+	m_pData = nullptr;
+	m_Size = 0;
+}
+
+bool MemoryMappedFile::IsOpen ( void ) const
+{
+	return (m_pData != nullptr);
+}
+
+const unsigned char* MemoryMappedFile::GetData ( void ) const
+{
+	return m_pData;
+}
+
+size_t MemoryMappedFile::GetSize ( void ) const
+{
+	return m_Size;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef MEMORY_MAPPED_FILE_H
+#define MEMORY_MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+/*
+ Small helper class to map a whole file in memory (read only)
+ The OS pages the data in on demand, so big files can be streamed without loading them upfront
+ Windows: CreateFileMapping/MapViewOfFile, other platforms: POSIX mmap
+*/
+
+class MemoryMappedFile
+{
+public:
+	MemoryMappedFile(void);
+	MemoryMappedFile(const std::string& i_FileName);
+	~MemoryMappedFile(void);
+
+	bool Open(const std::string& i_FileName);
+	void Close(void);
+
+	bool IsOpen(void) const;
+
+	const unsigned char* GetData(void) const;
+	size_t GetSize(void) const;
+
+private:
+	//// Variables ////
+	const unsigned char* m_pData;
+	size_t m_Size;
+
+#ifdef _WIN32
+	void* m_FileHandle;
+	void* m_MappingHandle;
+#else
+	int m_FileDescriptor;
+#endif // _WIN32
+};
+
+#endif /* MEMORY_MAPPED_FILE_H */
\ No newline at end of file
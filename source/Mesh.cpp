@@ -115,11 +115,11 @@ void Mesh::Render ( const ShaderManager& i_SM, const TextureManager& i_TM, unsig
 	m_MBM.UnBindModelContext();
 }
 
-void Mesh::Render ( bool i_IsWireframeMode )
+void Mesh::Render ( bool i_IsWireframeMode, unsigned short i_InstanceCount )
 {
 	m_MBM.BindModelContext();
 
-	glDrawArrays(i_IsWireframeMode ? GL_LINES : GL_TRIANGLES, 0, m_VertexCount);
+	glDrawArraysInstanced(i_IsWireframeMode ? GL_LINES : GL_TRIANGLES, 0, m_VertexCount, i_InstanceCount);
 
 	m_MBM.UnBindModelContext();
 }
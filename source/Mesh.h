@@ -32,7 +32,8 @@ public:
 	~Mesh(void);
 
 	void Render(const ShaderManager& i_SM, const TextureManager& i_TM, unsigned short i_StartTexUnitId, bool i_IsWireframeMode);
-	void Render(bool i_IsWireframeMode);
+	// i_InstanceCount - check MotorBoat::RenderReflectedRefracted()
+	void Render(bool i_IsWireframeMode, unsigned short i_InstanceCount = 1);
 	void RenderFlattened(void);
 
 	const Mesh::Limits& GetLimits(void) const;
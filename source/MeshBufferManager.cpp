@@ -3,6 +3,7 @@
 #include "MeshBufferManager.h"
 #include "CommonHeaders.h"
 #include "GLConfig.h"
+#include "GLStateCache.h"
 #include <new> //new, delete
 #include <vector>
 // glm::vec2, glm::vec3 come from the header
@@ -41,8 +42,9 @@ void MeshBufferManager::Destroy ( void )
 {
 	if (m_VAOID)
 	{
-		glBindVertexArray(0);
+		GLStateCache::BindVertexArray(0);
 		glDeleteVertexArrays(1, &m_VAOID);
+		GLStateCache::OnVertexArrayDeleted(m_VAOID);
 		m_VAOID = 0;
 	}
 
@@ -91,7 +93,8 @@ void MeshBufferManager::CreateModel ( const std::vector<MeshBufferManager::Verte
 	m_DrawingType = DRAWING_TYPE::DT_NON_INDEXED;
 }
 
-void MeshBufferManager::CreateModel ( const std::vector<MeshBufferManager::VertexData>& i_ModelVertexData, const std::vector<unsigned int>& i_ModelIndexes, MeshBufferManager::ACCESS_TYPE i_AccessType )
+template <typename T>
+void MeshBufferManager::CreateModel ( const std::vector<MeshBufferManager::VertexData>& i_ModelVertexData, const std::vector<T>& i_ModelIndexes, MeshBufferManager::ACCESS_TYPE i_AccessType )
 {
 	if (i_ModelVertexData.empty())
 	{
@@ -111,17 +114,23 @@ void MeshBufferManager::CreateModel ( const std::vector<MeshBufferManager::Verte
 		return;
 	}
 
-	glGenBuffers(1, &m_VBOID);
+	if (!m_VBOID)
+	{
+		glGenBuffers(1, &m_VBOID);
+	}
 	glBindBuffer(GL_ARRAY_BUFFER, m_VBOID);
 
 	glBufferData(GL_ARRAY_BUFFER, i_ModelVertexData.size() * sizeof(MeshBufferManager::VertexData), &i_ModelVertexData[0], i_AccessType == ACCESS_TYPE::AT_STATIC ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW);
 
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-	glGenBuffers(1, &m_IBOID);
+	if (!m_IBOID)
+	{
+		glGenBuffers(1, &m_IBOID);
+	}
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IBOID);
 
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, i_ModelIndexes.size() * sizeof(unsigned int), &i_ModelIndexes[0], GL_STATIC_DRAW);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, i_ModelIndexes.size() * sizeof(T), &i_ModelIndexes[0], GL_STATIC_DRAW);
 
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
@@ -129,6 +138,9 @@ void MeshBufferManager::CreateModel ( const std::vector<MeshBufferManager::Verte
 	m_DrawingType = DRAWING_TYPE::DT_INDEXED;
 }
 
+template void MeshBufferManager::CreateModel<unsigned int> ( const std::vector<MeshBufferManager::VertexData>& i_ModelVertexData, const std::vector<unsigned int>& i_ModelIndexes, MeshBufferManager::ACCESS_TYPE i_AccessType );
+template void MeshBufferManager::CreateModel<unsigned short> ( const std::vector<MeshBufferManager::VertexData>& i_ModelVertexData, const std::vector<unsigned short>& i_ModelIndexes, MeshBufferManager::ACCESS_TYPE i_AccessType );
+
 void MeshBufferManager::CreateModelContext ( const std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& i_ModelVertexAttributes, unsigned int i_VBOID, MeshBufferManager::ACCESS_TYPE i_AccessType )
 {
 	if (i_ModelVertexAttributes.empty())
@@ -144,7 +156,7 @@ void MeshBufferManager::CreateModelContext ( const std::map<MeshBufferManager::V
 	}
 
 	glGenVertexArrays(1, &m_VAOID);
-	glBindVertexArray(m_VAOID);
+	GLStateCache::BindVertexArray(m_VAOID);
 
 	glBindBuffer(GL_ARRAY_BUFFER, i_VBOID);
 
@@ -166,7 +178,7 @@ void MeshBufferManager::CreateModelContext ( const std::map<MeshBufferManager::V
 		glEnableVertexAttribArray(location);
 	}
 
-	glBindVertexArray(0);
+	GLStateCache::BindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 	m_AccessType = i_AccessType;
@@ -188,7 +200,7 @@ void MeshBufferManager::CreateModelContext ( const std::map<MeshBufferManager::V
 	}
 
 	glGenVertexArrays(1, &m_VAOID);
-	glBindVertexArray(m_VAOID);
+	GLStateCache::BindVertexArray(m_VAOID);
 
 	glBindBuffer(GL_ARRAY_BUFFER, i_VBOID);
 
@@ -212,7 +224,7 @@ void MeshBufferManager::CreateModelContext ( const std::map<MeshBufferManager::V
 
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, i_IBOID);
 
-	glBindVertexArray(0);
+	GLStateCache::BindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
@@ -242,7 +254,7 @@ void MeshBufferManager::CreateModelContext ( const std::vector<MeshBufferManager
 	}
 
 	glGenVertexArrays(1, &m_VAOID);
-	glBindVertexArray(m_VAOID);
+	GLStateCache::BindVertexArray(m_VAOID);
 
 	glGenBuffers(1, &m_VBOID);
 	glBindBuffer(GL_ARRAY_BUFFER, m_VBOID);
@@ -267,7 +279,7 @@ void MeshBufferManager::CreateModelContext ( const std::vector<MeshBufferManager
 		glEnableVertexAttribArray(location);
 	}
 
-	glBindVertexArray(0);
+	GLStateCache::BindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 	m_AccessType = i_AccessType;
@@ -301,7 +313,7 @@ void MeshBufferManager::CreateModelContext ( const std::vector<MeshBufferManager
 	}
 
 	glGenVertexArrays(1, &m_VAOID);
-	glBindVertexArray(m_VAOID);
+	GLStateCache::BindVertexArray(m_VAOID);
 
 	glGenBuffers(1, &m_VBOID);
 	glBindBuffer(GL_ARRAY_BUFFER, m_VBOID);
@@ -331,7 +343,7 @@ void MeshBufferManager::CreateModelContext ( const std::vector<MeshBufferManager
 
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, i_ModelIndexes.size() * sizeof(unsigned int), &i_ModelIndexes[0], GL_STATIC_DRAW);
 
-	glBindVertexArray(0);
+	GLStateCache::BindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
@@ -339,11 +351,19 @@ void MeshBufferManager::CreateModelContext ( const std::vector<MeshBufferManager
 	m_DrawingType = DRAWING_TYPE::DT_INDEXED;
 }
 
+void MeshBufferManager::CreateEmptyModelContext ( void )
+{
+	glGenVertexArrays(1, &m_VAOID);
+
+	m_AccessType = ACCESS_TYPE::AT_STATIC;
+	m_DrawingType = DRAWING_TYPE::DT_NON_INDEXED;
+}
+
 void MeshBufferManager::BindModelContext ( void ) const
 {
 	if (m_DrawingType == DRAWING_TYPE::DT_INDEXED || m_DrawingType == DRAWING_TYPE::DT_NON_INDEXED)
 	{
-		glBindVertexArray(m_VAOID);
+		GLStateCache::BindVertexArray(m_VAOID);
 	}
 }
 
@@ -353,7 +373,7 @@ void MeshBufferManager::UnBindModelContext ( void ) const
 	{
 		// http://ogldev.atspace.co.uk/www/tutorial32/tutorial32.html
 		// Before leaving we reset the current VAO back to zero and the reason is the same as when we initially created the VAO - we don't want outside code to bind a VB (for example) and change our VAO unintentinally.
-		glBindVertexArray(0);
+		GLStateCache::BindVertexArray(0);
 	}
 }
 
@@ -374,6 +394,42 @@ void MeshBufferManager::UpdateModelVertexData ( const std::vector<MeshBufferMana
 	}
 }
 
+MeshBufferManager::VertexData* MeshBufferManager::MapModelVertexData ( unsigned int i_FirstVertex, unsigned int i_VertexCount ) const
+{
+	MeshBufferManager::VertexData* pVertexData = nullptr;
+
+	if (m_AccessType == ACCESS_TYPE::AT_DYNAMIC)
+	{
+		// The range is mapped unsynchronized, so the driver doesn't stall until the GPU finished with the whole buffer.
+		// The caller must make sure the GPU doesn't read the mapped range anymore (e.g. with a fence).
+		// https://www.opengl.org/wiki/Buffer_Object_Streaming#Buffer_re-specification
+		glBindBuffer(GL_ARRAY_BUFFER, m_VBOID);
+		pVertexData = static_cast<MeshBufferManager::VertexData*>(glMapBufferRange(GL_ARRAY_BUFFER, i_FirstVertex * sizeof(MeshBufferManager::VertexData), i_VertexCount * sizeof(MeshBufferManager::VertexData), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		if (!pVertexData)
+		{
+			ERR("Failed to map the %s vertex buffer!", m_Name.c_str());
+		}
+	}
+
+	return pVertexData;
+}
+
+void MeshBufferManager::UnMapModelVertexData ( void ) const
+{
+	if (m_AccessType == ACCESS_TYPE::AT_DYNAMIC)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, m_VBOID);
+		if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE)
+		{
+			// the buffer content is undefined, it will be rewritten the next time it is mapped
+			ERR("The %s vertex buffer data got corrupted while mapped!", m_Name.c_str());
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+}
+
 unsigned int MeshBufferManager::GetVBOID ( void ) const
 {
 	return m_VBOID;
@@ -53,18 +53,27 @@ public:
 	void Initialize(const std::string& i_Name);
 
 	void CreateModel(const std::vector<MeshBufferManager::VertexData>& i_ModelVertexData, MeshBufferManager::ACCESS_TYPE i_AccessType);
-	void CreateModel(const std::vector<MeshBufferManager::VertexData>& i_ModelVertexData, const std::vector<unsigned int>& i_ModelIndexes, MeshBufferManager::ACCESS_TYPE i_AccessType);
+	// calling this again reuses the buffers, so the model contexts created with them stay valid
+	// T - the index type: unsigned int or unsigned short (instantiated in MeshBufferManager.cpp)
+	template <typename T>
+	void CreateModel(const std::vector<MeshBufferManager::VertexData>& i_ModelVertexData, const std::vector<T>& i_ModelIndexes, MeshBufferManager::ACCESS_TYPE i_AccessType);
 
 	void CreateModelContext(const std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& i_ModelVertexAttributes, unsigned int i_VBOID, MeshBufferManager::ACCESS_TYPE i_AccessType);
 	void CreateModelContext(const std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& i_ModelVertexAttributes, unsigned int i_VBOID, unsigned int i_IBOID, MeshBufferManager::ACCESS_TYPE i_AccessType);
 	void CreateModelContext(const std::vector<MeshBufferManager::VertexData>& i_ModelVertexData, const std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& i_ModelVertexAttributes, MeshBufferManager::ACCESS_TYPE i_AccessType);
 	void CreateModelContext(const std::vector<MeshBufferManager::VertexData>& i_ModelVertexData, const std::vector<unsigned int>& i_ModelIndexes, const std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& i_ModelVertexAttributes, MeshBufferManager::ACCESS_TYPE i_AccessType);
+	// no buffers, the vertices are generated in the vertex shader (from gl_VertexID), but the core profile still needs a VAO to draw
+	void CreateEmptyModelContext(void);
 
 	void BindModelContext(void) const;
 	void UnBindModelContext(void) const;
 
 	void UpdateModelVertexData(const std::vector<MeshBufferManager::VertexData>& i_ModelVertexData) const;
 
+	// streaming without the extra copy of UpdateModelVertexData, only for AT_DYNAMIC models
+	MeshBufferManager::VertexData* MapModelVertexData(unsigned int i_FirstVertex, unsigned int i_VertexCount) const;
+	void UnMapModelVertexData(void) const;
+
 	unsigned int GetVBOID(void) const;
 	unsigned int GetIBOID(void) const;
 	MeshBufferManager::ACCESS_TYPE GetAccessType(void) const;
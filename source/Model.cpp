@@ -659,13 +659,13 @@ void Model::Render ( const ShaderManager& i_SM, unsigned short i_StartTexUnitId,
 	}
 }
 
-void Model::Render ( bool i_IsWireframeMode )
+void Model::Render ( bool i_IsWireframeMode, unsigned short i_InstanceCount )
 {
 	for (unsigned int i = 0; i < m_Meshes.size(); ++i)
 	{
 		if (m_Meshes[i])
 		{
-			m_Meshes[i]->Render(i_IsWireframeMode);
+			m_Meshes[i]->Render(i_IsWireframeMode, i_InstanceCount);
 		}
 	}
 }
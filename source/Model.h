@@ -45,7 +45,8 @@ public:
 	bool Initialize(const std::string& i_Name, const std::string& i_Path, bool i_UseMaterial, const std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& i_ModelVertexAttributes, bool i_UseFlattenedModel, const GlobalConfig& i_Config);
 
 	void Render(const ShaderManager& i_SM, unsigned short i_StartTexUnitId, bool i_IsWireframeMode);
-	void Render(bool i_IsWireframeMode);
+	// i_InstanceCount - check MotorBoat::RenderReflectedRefracted()
+	void Render(bool i_IsWireframeMode, unsigned short i_InstanceCount = 1);
 	void RenderFlattened(void);
 
 	const Model::Limits& GetLimits(void) const;
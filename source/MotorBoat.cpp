@@ -16,6 +16,15 @@
 
 const short MotorBoat::m_kBoatTrailVertexCount = 48 * 2;
 
+const char* const MotorBoat::m_kUniformHandleNames[] =
+{
+	"u_ApplyHDR",
+	"u_WorldToClipMatrix",
+	"u_ObjectToWorldMatrix",
+	"u_SunDirection",
+	"u_IsLayered"
+};
+
 MotorBoat::MotorBoat ( void ) 
 	: m_BoatCurrentPosition(0.0f), m_BoatVelocity(0.0f), m_PropellerWashWidth(0.0f),
 	  m_BoatTurnAngle(0.0f), m_BoatAxis(0.0f, 0.0f, -1.0f),
@@ -112,6 +121,8 @@ void MotorBoat::Initialize ( const GlobalConfig& i_Config )
 	m_Uniforms["u_RefrClipPlane"] = m_SM.GetUniformLocation("u_RefrClipPlane");
 	m_SM.SetUniform(m_Uniforms.find("u_RefrClipPlane")->second, 1, glm::value_ptr(glm::vec4(0.0f, 1.0f, 0.0f, 0.0f)), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_4);
 
+	m_Handles.Initialize(m_SM, m_kUniformHandleNames);
+
 	m_SM.UnUseProgram();
 
 	/////
@@ -155,6 +166,8 @@ void MotorBoat::Initialize ( const GlobalConfig& i_Config )
 		m_TrailUniforms["u_WorldToClipMatrix"] = m_TrailSM.GetUniformLocation("u_WorldToClipMatrix");
 		m_TrailUniforms["u_ObjectToWorldMatrix"] = m_TrailSM.GetUniformLocation("u_ObjectToWorldMatrix");
 
+		m_TrailHandles.Initialize(m_TrailSM, m_kUniformHandleNames);
+
 		m_TrailSM.UnUseProgram();
 
 		/////
@@ -270,12 +283,52 @@ void MotorBoat::UpdateRefracted ( const glm::mat4& i_ScaleMatrix, const Camera&
 	UpdateInternal(i_ScaleMatrix, false, true, i_Camera, i_SunDirection, i_IsWireframeMode, i_CrrTime);
 }
 
+void MotorBoat::UpdateReflectedRefracted ( const glm::mat4& i_ReflScaleMatrix, const glm::mat4& i_RefrScaleMatrix, const Camera& i_Camera, const glm::vec3& i_SunDirection, bool i_IsWireframeMode, float i_CrrTime )
+{
+	m_IsWireframeMode = i_IsWireframeMode;
+
+	// one value per layer (instance): 0 - reflection, 1 - refraction (check MotorBoat.vert.glsl)
+	glm::mat4 modelMatrices[2] = { ComputeModelMatrix(i_ReflScaleMatrix, true), ComputeModelMatrix(i_RefrScaleMatrix, false) };
+	int applyHDR[2] = { false, true };
+
+	m_SM.UseProgram();
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_LAYERED], true);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_APPLY_HDR], 2, applyHDR);
+
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_WORLD_TO_CLIP_MATRIX], 1, glm::value_ptr(i_Camera.GetProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_OBJECT_TO_WORLD_MATRIX], 2, glm::value_ptr(modelMatrices[0]), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_SUN_DIRECTION], 1, glm::value_ptr(i_SunDirection), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+}
+
 void MotorBoat::UpdateInternal(const glm::mat4& i_ScaleMatrix, bool i_ApplyBoatPositionCorrection, bool i_ApplyHDR, const Camera& i_Camera, const glm::vec3& i_SunDirection, bool i_IsWireframeMode, float i_CrrTime)
 {
 	m_IsWireframeMode = i_IsWireframeMode;
 
-	//////////////////////////////////////
+	glm::mat4 modelMatrix = ComputeModelMatrix(i_ScaleMatrix, i_ApplyBoatPositionCorrection);
+
+	m_SM.UseProgram();
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_LAYERED], false);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_APPLY_HDR], i_ApplyHDR);
+
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_WORLD_TO_CLIP_MATRIX], 1, glm::value_ptr(i_Camera.GetProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_OBJECT_TO_WORLD_MATRIX], 1, glm::value_ptr(modelMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_SUN_DIRECTION], 1, glm::value_ptr(i_SunDirection), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
 
+	////////////////////
+	if (m_EnableBoatPropellerWash)
+	{
+		glm::mat4 TrailModelMatrix = i_ScaleMatrix;
+
+		m_TrailSM.UseProgram();
+		m_TrailSM.SetUniform(m_TrailHandles[UNIFORM_HANDLE::UH_WORLD_TO_CLIP_MATRIX], 1, glm::value_ptr(i_Camera.GetProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+		m_TrailSM.SetUniform(m_TrailHandles[UNIFORM_HANDLE::UH_OBJECT_TO_WORLD_MATRIX], 1, glm::value_ptr(TrailModelMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+	}
+}
+
+glm::mat4 MotorBoat::ComputeModelMatrix ( const glm::mat4& i_ScaleMatrix, bool i_ApplyBoatPositionCorrection ) const
+{
 	// correct rotation transform order:
 	// R = RZ * RX * RY
 
@@ -294,26 +347,7 @@ void MotorBoat::UpdateInternal(const glm::mat4& i_ScaleMatrix, bool i_ApplyBoatP
 
 	glm::mat4 T = glm::translate(glm::mat4(1.0f), tempPos);
 
-	glm::mat4 modelMatrix = T * R * i_ScaleMatrix;
-
-
-	m_SM.UseProgram();
-	m_SM.SetUniform(m_Uniforms.find("u_ApplyHDR")->second, i_ApplyHDR);
-
-	m_SM.SetUniform(m_Uniforms.find("u_WorldToClipMatrix")->second, 1, glm::value_ptr(i_Camera.GetProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-	m_SM.SetUniform(m_Uniforms.find("u_ObjectToWorldMatrix")->second, 1, glm::value_ptr(modelMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-
-	m_SM.SetUniform(m_Uniforms.find("u_SunDirection")->second, 1, glm::value_ptr(i_SunDirection), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
-
-	////////////////////
-	if (m_EnableBoatPropellerWash)
-	{
-		glm::mat4 TrailModelMatrix = i_ScaleMatrix;
-
-		m_TrailSM.UseProgram();
-		m_TrailSM.SetUniform(m_TrailUniforms.find("u_WorldToClipMatrix")->second, 1, glm::value_ptr(i_Camera.GetProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-		m_TrailSM.SetUniform(m_TrailUniforms.find("u_ObjectToWorldMatrix")->second, 1, glm::value_ptr(TrailModelMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-	}
+	return T * R * i_ScaleMatrix;
 }
 
 void MotorBoat::Render ( void )
@@ -350,6 +384,15 @@ void MotorBoat::RenderRefracted ( void )
 	RenderInternal();
 }
 
+void MotorBoat::RenderReflectedRefracted ( void )
+{
+	// one instance per layer, the mirrored (reflection) instance has the winding reverted,
+	// so the face culling must be disabled by the caller
+	m_SM.UseProgram();
+
+	m_M.Render(m_IsWireframeMode, 2);
+}
+
 void MotorBoat::RenderInternal ( void )
 {
 	m_SM.UseProgram();
@@ -36,10 +36,13 @@ public:
 	void Update(const Camera& i_Camera, const glm::vec3& i_SunDirection, bool i_IsWireframeMode, float i_CrrTime);
 	void UpdateReflected(const glm::mat4& i_ScaleMatrix, const Camera& i_Camera, const glm::vec3& i_SunDirection, bool i_IsWireframeMode, float i_CrrTime);
 	void UpdateRefracted(const glm::mat4& i_ScaleMatrix, const Camera& i_Camera, const glm::vec3& i_SunDirection, bool i_IsWireframeMode, float i_CrrTime);
+	// both layers of the layered reflection/refraction pass (check Application::RenderReflectedRefractedScene())
+	void UpdateReflectedRefracted(const glm::mat4& i_ReflScaleMatrix, const glm::mat4& i_RefrScaleMatrix, const Camera& i_Camera, const glm::vec3& i_SunDirection, bool i_IsWireframeMode, float i_CrrTime);
 
 	void Render(void);
 	void RenderReflected(void);
 	void RenderRefracted(void);
+	void RenderReflectedRefracted(void);
 	void RenderFlattened(void);
 
 	void Accelerate(float i_DeltaTime);
@@ -72,6 +75,7 @@ public:
 private:
 	//// Methods ////
 	void UpdateInternal(const glm::mat4& i_ScaleMatrix, bool i_ApplyBoatPositionCorrection, bool i_ApplyHDR, const Camera& i_Camera, const glm::vec3& i_SunDirection, bool i_IsWireframeMode, float i_CrrTime);
+	glm::mat4 ComputeModelMatrix(const glm::mat4& i_ScaleMatrix, bool i_ApplyBoatPositionCorrection) const;
 
 	void RenderInternal(void);
 	void RenderTrail(void);
@@ -93,6 +97,22 @@ private:
 	std::map<std::string, int> m_Uniforms;
 	std::map<std::string, int> m_TrailUniforms;
 
+	// the uniforms set every frame (check UniformHandleTable)
+	enum class UNIFORM_HANDLE
+	{
+		UH_APPLY_HDR = 0,
+		UH_WORLD_TO_CLIP_MATRIX,
+		UH_OBJECT_TO_WORLD_MATRIX,
+		UH_SUN_DIRECTION,
+		UH_IS_LAYERED,
+		UH_COUNT
+	};
+
+	static const char* const m_kUniformHandleNames[static_cast<unsigned short>(UNIFORM_HANDLE::UH_COUNT)];
+
+	typedef ShaderManager::UniformHandleTable<UNIFORM_HANDLE, static_cast<unsigned short>(UNIFORM_HANDLE::UH_COUNT)> UniformHandles;
+	UniformHandles m_Handles, m_TrailHandles;
+
 	glm::vec3 m_BoatCurrentPosition;
 	float m_BoatVelocity;
 	float m_BoatTurnAngle;
@@ -3,13 +3,15 @@
 #include "Ocean.h"
 #include "CommonHeaders.h"
 #include "GLConfig.h"
+#include "GLStateCache.h"
 // glm::vec2, glm::vec3, glm::mat4 come from the header
 #include "glm/vec4.hpp"
-#include "glm/common.hpp" //ceil()
+#include "glm/common.hpp" //ceil(), clamp(), max(), mod(), round()
 #include <glm/gtc/matrix_transform.hpp> //glm::translate()
 #include <glm/gtx/rotate_vector.hpp> //rotateY()
 #include "glm/gtc/constants.hpp" //pi()
 #include "glm/gtc/type_ptr.hpp" //value_ptr()
+#include "glm/exponential.hpp" //pow()
 #include "glm/vector_relational.hpp" //any(), notEqual()
 #include "HelperFunctions.h"
 #include "FileUtils.h"
@@ -19,34 +21,74 @@
 #include "FFTOceanPatchGPUFrag.h"
 #include "FFTOceanPatchGPUComp.h"
 #include "FFTOceanPatchCPUFFTW.h"
+#include "FFTOceanPatchBakedCache.h"
 #include "MotorBoat.h"
 #include <sstream> // std::stringstream
+#include <chrono> // std::chrono::steady_clock
 #include <time.h>
 #include <cassert>
 
 
+const char* const Ocean::m_kUniformHandleNames[] =
+{
+	"u_ProjectingMatrix",
+	"u_BottomProjectingMatrix",
+	"u_ClipmapData.Levels",
+	"u_ClipmapData.Tiles",
+	"u_QuadtreeData.LODs",
+	"u_QuadtreeData.Tiles",
+	"u_TessellatedData.Origin",
+	"u_TessellatedData.FrustumPlanes",
+	"u_TessellatedData.Bounds",
+	"u_TessellatedData.TessFactor",
+	"u_WorldToClipMatrix",
+	"u_SunDirY",
+	"u_GodRaysData.LightDirectionOnScreen",
+	"u_ViewClipToWorldMatrix",
+	"u_ProjectorClipToWorldMatrix",
+	"u_IsViewFrustum",
+	"u_Color",
+	"u_ReflRefrWorldToClipMatrix",
+	"u_GodRaysData.StepFraction",
+	"u_GodRaysData.IsFirstPass",
+	"u_CausticsData.Frame",
+	"u_CausticsData.SunOffset"
+};
+
 Ocean::Ocean ( void )
 	: m_pFFTOceanPatch(nullptr), m_pCurrentCamera(nullptr), 
-	  m_GridVertexCount(0), m_GridIndexCount(0), m_ScreenSpaceGridResolution(0.0f),
-	  m_OccluderIndexCount(0), m_IsWireframeMode(false), m_IsFrustumVisible(false),
+	  m_GridVertexCount(0), m_GridIndexCount(0), m_OccluderIndexCount(0), m_ScreenSpaceGridResolution(0.0f),
+	  m_UseProceduralGrid(false), m_ProceduralGridWidth(0), m_ProceduralGridHeight(0),
+	  m_GridIndexType(GL_UNSIGNED_INT), m_GridRestartIndex(0), m_UseGridPrimitiveRestart(false),
+	  m_ScreenSpaceGridCacheWidth(0), m_ScreenSpaceGridCacheHeight(0), m_ScreenSpaceGridCacheResolution(0.0f),
+	  m_IsWireframeMode(false), m_IsFrustumVisible(false),
 	  m_GridType(CustomTypes::Ocean::GridType::GT_COUNT), m_SkyModelType(CustomTypes::Sky::ModelType::MT_COUNT),
-	  m_SurfaceUseGridCorners(false), m_BottomUseGridCorners(false), m_EnableBottomCaustics(false),
+	  m_SurfaceUseGridCorners(false), m_BottomUseGridCorners(false), m_EnableMultiPassGodRays(false), m_EnableBottomCaustics(false), m_EnableBakedCaustics(false),
 	  m_EnableBoatFoam(false), m_EnableBoatKelvinWake(false), m_EnableBoatPropellerWash(false),
-	  m_EnableUnderWaterGodRays(false),  m_GodRaysMapWidth(0), m_GodRaysMapHeight(0), m_CausticsMapSize(0),
-	  m_PerlinNoiseSpeed(0.0f), m_SunDirY(0.0f)
+	  m_EnableUnderWaterGodRays(false), m_GodRaysMapWidth(0), m_GodRaysMapHeight(0), m_GodRaysPassMapWidth(0), m_GodRaysPassMapHeight(0), m_CausticsMapSize(0),
+	  m_CausticsAtlasTexId(0), m_IsCausticsAtlasBaked(false), m_CausticsTimePeriod(0.0f), m_CausticsDepth(0.0f), m_CausticsRebakeFrameDelay(0),
+	  m_IsCausticsBaking(false), m_CausticsBakeFrameIndex(0), m_CausticsBakeSunDirection(0.0f, 1.0f, 0.0f),
+	  m_PerlinNoiseSpeed(0.0f), m_SunDirY(0.0f), m_FFTSize(0), m_CPUGridFences(), m_CPUGridRegion(0), m_TileIndexCount(0), m_ClipmapMaxWaveAmplitude(0.0f),
+	  m_TessellatedPatchCount(0), m_TessellatedPatchSize(0.0f), m_TessellatedTargetEdgeLength(0.0f)
 {
 	LOG("Ocean successfully created!");
 }
 
 Ocean::Ocean ( const GlobalConfig& i_Config )
 	: m_pFFTOceanPatch(nullptr), m_pCurrentCamera(nullptr),
-	  m_GridVertexCount(0), m_GridIndexCount(0), m_ScreenSpaceGridResolution(0.0f),
-	  m_OccluderIndexCount(0), m_IsWireframeMode(false), m_IsFrustumVisible(false),
+	  m_GridVertexCount(0), m_GridIndexCount(0), m_OccluderIndexCount(0), m_ScreenSpaceGridResolution(0.0f),
+	  m_UseProceduralGrid(false), m_ProceduralGridWidth(0), m_ProceduralGridHeight(0),
+	  m_GridIndexType(GL_UNSIGNED_INT), m_GridRestartIndex(0), m_UseGridPrimitiveRestart(false),
+	  m_ScreenSpaceGridCacheWidth(0), m_ScreenSpaceGridCacheHeight(0), m_ScreenSpaceGridCacheResolution(0.0f),
+	  m_IsWireframeMode(false), m_IsFrustumVisible(false),
 	  m_GridType(CustomTypes::Ocean::GridType::GT_COUNT), m_SkyModelType(CustomTypes::Sky::ModelType::MT_COUNT),
-	  m_SurfaceUseGridCorners(false), m_BottomUseGridCorners(false), m_EnableBottomCaustics(false),
+	  m_SurfaceUseGridCorners(false), m_BottomUseGridCorners(false), m_EnableMultiPassGodRays(false), m_EnableBottomCaustics(false), m_EnableBakedCaustics(false),
 	  m_EnableBoatFoam(false), m_EnableBoatKelvinWake(false), m_EnableBoatPropellerWash(false),
-	  m_EnableUnderWaterGodRays(false), m_GodRaysMapWidth(0), m_GodRaysMapHeight(0), m_CausticsMapSize(0),
-	  m_PerlinNoiseSpeed(0.0f), m_SunDirY(0.0f)
+	  m_EnableUnderWaterGodRays(false), m_GodRaysMapWidth(0), m_GodRaysMapHeight(0), m_GodRaysPassMapWidth(0), m_GodRaysPassMapHeight(0), m_CausticsMapSize(0),
+	  m_CausticsAtlasTexId(0), m_IsCausticsAtlasBaked(false), m_CausticsTimePeriod(0.0f), m_CausticsDepth(0.0f), m_CausticsRebakeFrameDelay(0),
+	  m_IsCausticsBaking(false), m_CausticsBakeFrameIndex(0), m_CausticsBakeSunDirection(0.0f, 1.0f, 0.0f),
+	  m_PerlinNoiseSpeed(0.0f), m_SunDirY(0.0f), m_FFTSize(0), m_CPUGridFences(), m_CPUGridRegion(0), m_TileIndexCount(0), m_ClipmapMaxWaveAmplitude(0.0f),
+	  m_TessellatedPatchCount(0), m_TessellatedPatchSize(0.0f), m_TessellatedTargetEdgeLength(0.0f)
 {
 	Initialize(i_Config);
 }
@@ -58,6 +100,15 @@ Ocean::~Ocean ( void )
 
 void Ocean::Destroy ( void )
 {
+	for (unsigned short i = 0; i < m_kCPUGridRegionCount; ++i)
+	{
+		if (m_CPUGridFences[i])
+		{
+			glDeleteSync(m_CPUGridFences[i]);
+			m_CPUGridFences[i] = nullptr;
+		}
+	}
+
 	SAFE_DELETE(m_pFFTOceanPatch);
 	LOG("Ocean successfully destroyed!");
 }
@@ -66,12 +117,16 @@ void Ocean::Initialize ( const GlobalConfig& i_Config )
 {
 	m_GridType = i_Config.Scene.Ocean.Grid.Type;
 	m_ScreenSpaceGridResolution = i_Config.Scene.Ocean.Grid.ScreenSpace.GridResolution;
+	// the CPU projected grid streams its own vertices (check the PROCEDURAL_GRID define in GlobalConfig)
+	m_UseProceduralGrid = i_Config.Scene.Ocean.Grid.UseProceduralGrid && m_GridType != CustomTypes::Ocean::GridType::GT_CPU_PROJECTED;
 
 	m_SkyModelType = i_Config.Scene.Sky.Model.Type;
 	m_SurfaceUseGridCorners = i_Config.Scene.Ocean.Surface.Projector.UseGridCorners;
 	m_BottomUseGridCorners = i_Config.Scene.Ocean.Bottom.Projector.UseGridCorners;
 	m_EnableUnderWaterGodRays = i_Config.Scene.Ocean.UnderWater.GodRays.Enabled;
+	m_EnableMultiPassGodRays = m_EnableUnderWaterGodRays && i_Config.Scene.Ocean.UnderWater.GodRays.MultiPass.Enabled;
 	m_EnableBottomCaustics = i_Config.Scene.Ocean.Bottom.Caustics.Enabled;
+	m_EnableBakedCaustics = m_EnableBottomCaustics && i_Config.Scene.Ocean.Bottom.Caustics.Baked.Enabled;
 	m_EnableBoatFoam = i_Config.Scene.Ocean.Surface.BoatEffects.Foam.Enabled;
 	m_EnableBoatKelvinWake = i_Config.Scene.Ocean.Surface.BoatEffects.KelvinWake.Enabled;
 	m_EnableBoatPropellerWash = i_Config.Scene.Ocean.Surface.BoatEffects.PropellerWash.Enabled;
@@ -81,11 +136,24 @@ void Ocean::Initialize ( const GlobalConfig& i_Config )
 	m_UnderWaterGodRaysData.Decay = 0.0f;
 	m_UnderWaterGodRaysData.Density = 0.0f;
 	m_UnderWaterGodRaysData.Weight = 0.0f;
+	m_UnderWaterGodRaysData.PassCount = 0;
+	m_UnderWaterGodRaysData.SamplesPerPass = 0;
 
 	m_CausticsMapSize = i_Config.Scene.Ocean.Bottom.Caustics.MapSize;
+	m_CausticsTimePeriod = i_Config.Scene.Ocean.Surface.OceanPatch.DispersionFrequencyTimePeriod;
+	// same as the per frame caustics, the rays start on the bottom plane (check OceanCausticsWorldGrid.vert.glsl)
+	m_CausticsDepth = i_Config.Scene.Ocean.Bottom.Caustics.PlaneDistanceOffset;
 
 	m_PerlinNoiseSpeed = i_Config.Scene.Ocean.Surface.PerlinNoise.Speed;
 
+	m_FFTSize = i_Config.Scene.Ocean.Surface.OceanPatch.FFTSize;
+
+	m_ClipmapMaxWaveAmplitude = i_Config.Scene.Ocean.Surface.Projector.MaxWaveAmplitude;
+
+	m_TessellatedPatchCount = i_Config.Scene.Ocean.Grid.Tessellated.PatchCount;
+	m_TessellatedPatchSize = i_Config.Scene.Ocean.Grid.Tessellated.PatchSize;
+	m_TessellatedTargetEdgeLength = i_Config.Scene.Ocean.Grid.Tessellated.TargetEdgeLength;
+
 	///////////////////////////
 
 	m_WaveProjector.Initialize(i_Config, Projector::PROJ_TYPE::PT_SURFACE);
@@ -94,6 +162,32 @@ void Ocean::Initialize ( const GlobalConfig& i_Config )
 
 	//////////////////////////////
 
+	// every block starts at an aligned offset (usually 256 bytes)
+	m_UBM.Initialize("Ocean");
+	m_UBM.CreateBuffer(4096);
+
+	CreateFFTOceanPatch(i_Config);
+
+	m_FFTOceanPatchBuilder.Initialize(i_Config);
+
+	///////////
+
+	SetupGrid(i_Config);
+	SetupOceanSurface(i_Config);
+
+	SetupOceanBottom(i_Config);
+	SetupOceanBottomCaustics(i_Config);
+	SetupOceanBottomGodRays(i_Config);
+
+	SetupDebugFrustum(i_Config);
+
+	SetupTextures(i_Config);
+
+	LOG("Ocean successfully created!");
+}
+
+void Ocean::CreateFFTOceanPatch ( const GlobalConfig& i_Config )
+{
 	switch (i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.Type)
 	{
 		case CustomTypes::Ocean::ComputeFFTType::CFT_GPU_FRAG:
@@ -110,25 +204,49 @@ void Ocean::Initialize ( const GlobalConfig& i_Config )
 		case CustomTypes::Ocean::ComputeFFTType::CFT_CPU_FFTW:
 			m_pFFTOceanPatch = new FFTOceanPatchCPUFFTW(i_Config);
 			break;
+		case CustomTypes::Ocean::ComputeFFTType::CFT_BAKED_CACHE:
+			m_pFFTOceanPatch = new FFTOceanPatchBakedCache(i_Config);
+			break;
 		case CustomTypes::Ocean::ComputeFFTType::CFT_COUNT:
 		default: ERR("Invalid ocean compute fft type!");
 	}
 	assert(m_pFFTOceanPatch != nullptr);
+}
 
-	///////////
+void Ocean::UpdateFFTOceanPatch ( void )
+{
+	// the frame boundary, nothing uses the old patch anymore
+	FFTOceanPatchBase* pFFTOceanPatch = m_FFTOceanPatchBuilder.Update();
 
-	SetupGrid(i_Config);
-	SetupOceanSurface(i_Config);
+	if (!pFFTOceanPatch)
+	{
+		return;
+	}
 
-	SetupOceanBottom(i_Config);
-	SetupOceanBottomCaustics(i_Config);
-	SetupOceanBottomGodRays(i_Config);
+	bool isPatchSizeChanged = (m_pFFTOceanPatch && m_pFFTOceanPatch->GetPatchSize() != pFFTOceanPatch->GetPatchSize());
 
-	SetupDebugFrustum(i_Config);
+	SAFE_DELETE(m_pFFTOceanPatch);
+	m_pFFTOceanPatch = pFFTOceanPatch;
 
-	SetupTextures(i_Config);
+	// the texture units are the same, only the patch size uniforms change
+	if (isPatchSizeChanged)
+	{
+		m_OceanSurfaceSM.UseProgram();
+		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_FFTOceanPatchData.PatchSize")->second, static_cast<float>(m_pFFTOceanPatch->GetPatchSize()));
 
-	LOG("Ocean successfully created!");
+		// the baked caustics keep the patch size they were baked for, until they are baked again
+		if (m_EnableBottomCaustics && !m_EnableBakedCaustics)
+		{
+			m_OceanCausticsSM.UseProgram();
+			m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_PatchSize")->second, static_cast<float>(m_pFFTOceanPatch->GetPatchSize()));
+		}
+	}
+
+	m_FFTSize = m_FFTOceanPatchBuilder.GetFFTSize();
+
+	InvalidateBakedCaustics();
+
+	LOG("Ocean - the FFT size is %u, the patch size is %u!", m_FFTSize, m_pFFTOceanPatch->GetPatchSize());
 }
 
 void Ocean::SetupGrid ( const GlobalConfig& i_Config )
@@ -146,141 +264,285 @@ void Ocean::SetupGrid ( const GlobalConfig& i_Config )
 
 		SetupScreenSpaceGrid(screenWidth, screenHeight);
 	}
-	else if (m_GridType == CustomTypes::Ocean::GridType::GT_WORLD_SPACE)
+	else if (m_GridType == CustomTypes::Ocean::GridType::GT_WORLD_SPACE || m_GridType == CustomTypes::Ocean::GridType::GT_CPU_PROJECTED ||
+			 m_GridType == CustomTypes::Ocean::GridType::GT_CLIPMAP || m_GridType == CustomTypes::Ocean::GridType::GT_QUADTREE ||
+			 m_GridType == CustomTypes::Ocean::GridType::GT_TESSELLATED)
 	{
-		unsigned short i_GridWidth = i_Config.Scene.Ocean.Grid.WorldSpace.Width;
-		unsigned short i_GridHeight = i_Config.Scene.Ocean.Grid.WorldSpace.Height;
+		// the CPU projected grid uses the same layout as the world space grid, the bottom and the caustics are still projected on the GPU
+		// the clipmap, the quadtree and the tessellated grids have their own mesh, the world space grid is still used by the bottom and the caustics
+		bool isCPUProjected = (m_GridType == CustomTypes::Ocean::GridType::GT_CPU_PROJECTED);
 
-		std::vector<MeshBufferManager::VertexData> gridVertexData;
-		std::vector<unsigned int> gridIndices;
+		unsigned short i_GridWidth = (isCPUProjected ? i_Config.Scene.Ocean.Grid.CPUProjected.Width : i_Config.Scene.Ocean.Grid.WorldSpace.Width);
+		unsigned short i_GridHeight = (isCPUProjected ? i_Config.Scene.Ocean.Grid.CPUProjected.Height : i_Config.Scene.Ocean.Grid.WorldSpace.Height);
 
-		gridVertexData.resize(i_GridWidth * i_GridHeight);
+		if (m_UseProceduralGrid)
+		{
+			// the vertices follow the same triangle strip as the indices below, check OceanSurfaceWorldGrid.vert.glsl
+			m_ProceduralGridWidth = i_GridWidth;
+			m_ProceduralGridHeight = i_GridHeight;
 
-		float du = 1.0f / static_cast<float>(i_GridWidth - 1),
-			dv = 1.0f / static_cast<float>(i_GridHeight - 1),
-			u = 0.0f, v = 0.0f;
-		unsigned int index = 0;
-		for (unsigned short i = 0; i < i_GridHeight; ++i)
+			m_GridVertexCount = i_GridWidth * i_GridHeight;
+			m_GridIndexCount = 2 * i_GridWidth * (i_GridHeight - 1);
+		}
+		else
 		{
-			u = 0.0f;
-			for (unsigned short j = 0; j < i_GridWidth; ++j)
+			std::vector<MeshBufferManager::VertexData> gridVertexData;
+			std::vector<unsigned int> gridIndices;
+
+			gridVertexData.resize(i_GridWidth * i_GridHeight);
+
+			float du = 1.0f / static_cast<float>(i_GridWidth - 1),
+				dv = 1.0f / static_cast<float>(i_GridHeight - 1),
+				u = 0.0f, v = 0.0f;
+			unsigned int index = 0;
+			for (unsigned short i = 0; i < i_GridHeight; ++i)
 			{
-				index = i * i_GridWidth + j;
+				u = 0.0f;
+				for (unsigned short j = 0; j < i_GridWidth; ++j)
+				{
+					index = i * i_GridWidth + j;
 
-				gridVertexData[index].uv.x = u;
-				gridVertexData[index].uv.y = v;
+					gridVertexData[index].uv.x = u;
+					gridVertexData[index].uv.y = v;
 
-				u += du;
+					u += du;
+				}
+				v += dv;
 			}
-			v += dv;
-		}
 
-		/////////// Indices //////////////
-		gridIndices.resize(2 * i_GridWidth * (i_GridHeight - 1));
+			/////////// Indices //////////////
+			gridIndices.resize(2 * i_GridWidth * (i_GridHeight - 1));
 
-		for (unsigned short i = 0; i < i_GridHeight - 1; ++i)
-		{
-			for (unsigned short j = 0; j < i_GridWidth; ++j)
+			for (unsigned short i = 0; i < i_GridHeight - 1; ++i)
 			{
-				index = (j + i * i_GridWidth) * 2;
-				if (i % 2 == 0)
-				{
-					gridIndices[index] = j + (i + 1) * i_GridWidth;
-					gridIndices[index + 1] = j + i * i_GridWidth;
-				}
-				else
+				for (unsigned short j = 0; j < i_GridWidth; ++j)
 				{
-					gridIndices[index] = i_GridWidth - 1 - j + i * i_GridWidth;
-					gridIndices[index + 1] = i_GridWidth - 1 - j + (i + 1) * i_GridWidth;
+					index = (j + i * i_GridWidth) * 2;
+					if (i % 2 == 0)
+					{
+						gridIndices[index] = j + (i + 1) * i_GridWidth;
+						gridIndices[index + 1] = j + i * i_GridWidth;
+					}
+					else
+					{
+						gridIndices[index] = i_GridWidth - 1 - j + i * i_GridWidth;
+						gridIndices[index + 1] = i_GridWidth - 1 - j + (i + 1) * i_GridWidth;
+					}
 				}
 			}
+
+			///////////////////////////////////
+
+			m_GridVertexCount = gridVertexData.size();
+			m_GridIndexCount = gridIndices.size();
+
+
+			//////////
+			m_GridMBM.Initialize("Ocean Grid");
+			m_GridMBM.CreateModel(gridVertexData, gridIndices, MeshBufferManager::ACCESS_TYPE::AT_STATIC);
 		}
 
-		///////////////////////////////////
+		if (isCPUProjected)
+		{
+			m_CPUGrid.Initialize(i_Config);
 
-		m_GridVertexCount = gridVertexData.size();
-		m_GridIndexCount = gridIndices.size();
+			// the vertices are streamed in a ring of buffer regions, so the CPU never writes a region the GPU still reads from
+			std::vector<MeshBufferManager::VertexData> cpuGridVertexData(m_kCPUGridRegionCount * m_CPUGrid.GetVertexCount());
 
+			m_CPUGridMBM.Initialize("Ocean CPU Grid");
+			m_CPUGridMBM.CreateModel(cpuGridVertexData, MeshBufferManager::ACCESS_TYPE::AT_DYNAMIC);
+		}
 
-		//////////
-		m_GridMBM.Initialize("Ocean Grid");
-		m_GridMBM.CreateModel(gridVertexData, gridIndices, MeshBufferManager::ACCESS_TYPE::AT_STATIC);
+		if (m_GridType == CustomTypes::Ocean::GridType::GT_CLIPMAP || m_GridType == CustomTypes::Ocean::GridType::GT_QUADTREE)
+		{
+			std::vector<MeshBufferManager::VertexData> tileVertexData;
+			std::vector<unsigned int> tileIndices;
+
+			if (m_GridType == CustomTypes::Ocean::GridType::GT_CLIPMAP)
+			{
+				m_Clipmap.Initialize(i_Config);
+				m_Clipmap.CreateTileMesh(tileVertexData, tileIndices);
+			}
+			else
+			{
+				m_Quadtree.Initialize(i_Config);
+				m_Quadtree.CreateTileMesh(tileVertexData, tileIndices);
+			}
+
+			m_TileIndexCount = tileIndices.size();
+
+			m_TileMBM.Initialize("Ocean Tile");
+			m_TileMBM.CreateModel(tileVertexData, tileIndices, MeshBufferManager::ACCESS_TYPE::AT_STATIC);
+		}
+
+		if (m_GridType == CustomTypes::Ocean::GridType::GT_TESSELLATED)
+		{
+			// the grid is centred on the camera, so it needs an even number of patches per side
+			if (m_TessellatedPatchCount < 2 || m_TessellatedPatchCount > 254 || m_TessellatedPatchCount % 2 != 0 || m_TessellatedPatchSize <= 0.0f)
+			{
+				ERR("Invalid tessellated grid patch count or patch size! The patch count must be an even number!");
+				return;
+			}
+
+			std::vector<MeshBufferManager::VertexData> patchVertexData;
+			std::vector<unsigned int> patchIndices;
+
+			// same vertices as a clipmap tile, but every quad is a patch of 4 vertices: (0, 0), (1, 0), (1, 1), (0, 1)
+			OceanClipmap::CreateTileMesh(m_TessellatedPatchCount, patchVertexData, patchIndices);
+
+			unsigned int width = m_TessellatedPatchCount + 1, index = 0;
+
+			patchIndices.resize(4 * m_TessellatedPatchCount * m_TessellatedPatchCount);
+
+			for (unsigned int i = 0; i < m_TessellatedPatchCount; ++i)
+			{
+				for (unsigned int j = 0; j < m_TessellatedPatchCount; ++j)
+				{
+					index = (i * m_TessellatedPatchCount + j) * 4;
+
+					patchIndices[index] = j + i * width;
+					patchIndices[index + 1] = j + 1 + i * width;
+					patchIndices[index + 2] = j + 1 + (i + 1) * width;
+					patchIndices[index + 3] = j + (i + 1) * width;
+				}
+			}
+
+			m_TileIndexCount = patchIndices.size();
+
+			m_TileMBM.Initialize("Ocean Patches");
+			m_TileMBM.CreateModel(patchVertexData, patchIndices, MeshBufferManager::ACCESS_TYPE::AT_STATIC);
+		}
 	}
 }
 
 void Ocean::SetupScreenSpaceGrid ( unsigned short i_WindowWidth, unsigned short i_WindowHeight )
 {
-	std::vector<MeshBufferManager::VertexData> gridVertexData;
-	std::vector<unsigned int> gridIndices;
+	// the grid depends only on the window size and the grid resolution
+	if (i_WindowWidth == m_ScreenSpaceGridCacheWidth && i_WindowHeight == m_ScreenSpaceGridCacheHeight && m_ScreenSpaceGridResolution == m_ScreenSpaceGridCacheResolution)
+	{
+		return;
+	}
 
-	const float s = 1.0f;
+	m_ScreenSpaceGridCacheWidth = i_WindowWidth;
+	m_ScreenSpaceGridCacheHeight = i_WindowHeight;
+	m_ScreenSpaceGridCacheResolution = m_ScreenSpaceGridResolution;
 
 	const float vmargin = 0.1f;
 	const float hmargin = 0.1f;
 
+	//// generating a screen space grid
+	// from -hmargin to 1 + hmargin horizontally and from 1 to -vmargin vertically (in window units)
+	// the vertices are computed from integer counts, so the float errors don't accumulate over the rows and columns
+	unsigned int cols = static_cast<unsigned int>(glm::ceil(i_WindowWidth * (1.0f + 2.0f * hmargin) / m_ScreenSpaceGridResolution)) + 1;
+	unsigned int rows = static_cast<unsigned int>(glm::ceil(i_WindowHeight * (1.0f + vmargin) / m_ScreenSpaceGridResolution)) + 1;
 
-	unsigned int index = 0, size = 0;
+	// clip space position of the first vertex and the distance between two vertices
+	glm::vec2 origin(-1.0f - 2.0f * hmargin, 1.0f - 0.2f / i_WindowHeight);
+	glm::vec2 step(2.0f * m_ScreenSpaceGridResolution / i_WindowWidth, - 2.0f * m_ScreenSpaceGridResolution / i_WindowHeight);
 
-	//// generating a screen space grid
-	unsigned int rows = static_cast<unsigned int>(glm::ceil(i_WindowHeight * (s + vmargin) / m_ScreenSpaceGridResolution) + 5.0f);
-	unsigned int cols = static_cast<unsigned int>(glm::ceil(i_WindowWidth * (1.0f + 2.0f * hmargin) / m_ScreenSpaceGridResolution) + 5.0f);
+	m_GridVertexCount = cols * rows;
+
+	if (m_UseProceduralGrid)
+	{
+		// check OceanScreenGrid.vert.glsl
+		m_ProceduralGridWidth = cols;
+		m_ProceduralGridHeight = rows;
 
-	size = rows * cols;
-	gridVertexData.resize(size);
+		m_ProceduralScreenGridOrigin = origin;
+		m_ProceduralScreenGridStep = step;
 
-	index = 0;
-	unsigned int n = 0, r = 0, c = 0;
-	for (float j = i_WindowHeight * s - 0.1f; j > -i_WindowHeight * vmargin - m_ScreenSpaceGridResolution; j -= m_ScreenSpaceGridResolution)
+		m_GridIndexCount = 2 * cols * (rows - 1);
+
+		return;
+	}
+
+	std::vector<MeshBufferManager::VertexData> gridVertexData(m_GridVertexCount);
+
+	unsigned int index = 0;
+	for (unsigned int r = 0; r < rows; ++r)
 	{
-		n = 0; c = 0;
-		for (float i = -i_WindowWidth * hmargin; i < i_WindowWidth * (1.0f + hmargin) + m_ScreenSpaceGridResolution; i += m_ScreenSpaceGridResolution)
+		for (unsigned int c = 0; c < cols; ++c)
 		{
-			gridVertexData[index].position = glm::vec3(-1.0f + 2.0f * i / i_WindowWidth, -1.0f + 2.0f * j / i_WindowHeight, 0.0f);
+			index = r * cols + c;
+
+			gridVertexData[index].position = glm::vec3(origin + glm::vec2(c, r) * step, 0.0f);
 			gridVertexData[index].uv = glm::vec2(static_cast<float>(c) / static_cast<float>(cols), static_cast<float>(r) / static_cast<float>(rows));
-			++index;
-			++n;
-			++c;
 		}
-		++r;
 	}
 
 	////////// Indices //////
-	size = 2 * (rows - 2) * (cols - 1);
-	gridIndices.resize(size);
+	// one strip per row, the strips are separated by the primitive restart index (no degenerate triangles)
+	// the grid is split in vertical bands, so the vertices shared by two consecutive strips are still in the post-transform vertex cache
+	// the bands overlap by one column
+	bool useShortIndices = (m_GridVertexCount < 0xFFFF);
+	m_GridRestartIndex = (useShortIndices ? 0xFFFF : 0xFFFFFFFF);
+
+	std::vector<unsigned int> gridIndices;
+	gridIndices.reserve((cols / (m_kScreenSpaceGridBandWidth - 1) + 1) * (rows - 1) * (2 * m_kScreenSpaceGridBandWidth + 1));
 
-	index = 0;
-	unsigned int ni = 0;
-	for (float i = i_WindowHeight * s - vmargin; i > -i_WindowHeight * vmargin; i -= m_ScreenSpaceGridResolution)
+	for (unsigned int bandStart = 0; bandStart < cols - 1; bandStart += m_kScreenSpaceGridBandWidth - 1)
 	{
-		unsigned int nj = 0;
-		for (float j = -i_WindowWidth * hmargin; j < i_WindowWidth * (1.0f + hmargin); j += m_ScreenSpaceGridResolution)
-		{
-			index = (ni * n + nj) * 2;
+		unsigned int bandEnd = glm::min(bandStart + m_kScreenSpaceGridBandWidth - 1, cols - 1);
 
+		for (unsigned int r = 0; r < rows - 1; ++r)
+		{
 			// CCW winding
-			if (ni % 2 == 0)
-			{
-				gridIndices[index] = nj + ni * n;
-				gridIndices[index + 1] = nj + (ni + 1) * n;
-			}
-			else
+			for (unsigned int c = bandStart; c <= bandEnd; ++c)
 			{
-				gridIndices[index] = n - 1 - nj + (ni + 1) * n;
-				gridIndices[index + 1] = n - 1 - nj + ni * n;
+				gridIndices.push_back(c + r * cols);
+				gridIndices.push_back(c + (r + 1) * cols);
 			}
 
-			++nj;
+			gridIndices.push_back(m_GridRestartIndex);
 		}
-		++ni;
 	}
 
-	m_GridVertexCount = gridVertexData.size();
 	m_GridIndexCount = gridIndices.size();
 
 
 	//////////
+	// the buffers are reused, so the model contexts created with them stay valid after a resize
 	m_GridMBM.Initialize("Ocean");
-	m_GridMBM.CreateModel(gridVertexData, gridIndices, MeshBufferManager::ACCESS_TYPE::AT_STATIC);
+	if (useShortIndices)
+	{
+		m_GridIndexType = GL_UNSIGNED_SHORT;
+		m_GridMBM.CreateModel(gridVertexData, std::vector<unsigned short>(gridIndices.begin(), gridIndices.end()), MeshBufferManager::ACCESS_TYPE::AT_STATIC);
+	}
+	else
+	{
+		m_GridIndexType = GL_UNSIGNED_INT;
+		m_GridMBM.CreateModel(gridVertexData, gridIndices, MeshBufferManager::ACCESS_TYPE::AT_STATIC);
+	}
+
+	m_UseGridPrimitiveRestart = true;
+}
+
+void Ocean::SetupProceduralGridUniforms ( const ShaderManager& i_SM, std::map<std::string, int>& io_Uniforms ) const
+{
+	io_Uniforms["u_ProceduralGridData.Width"] = i_SM.GetUniformLocation("u_ProceduralGridData.Width");
+	i_SM.SetUniform(io_Uniforms.find("u_ProceduralGridData.Width")->second, static_cast<int>(m_ProceduralGridWidth));
+
+	io_Uniforms["u_ProceduralGridData.Height"] = i_SM.GetUniformLocation("u_ProceduralGridData.Height");
+	i_SM.SetUniform(io_Uniforms.find("u_ProceduralGridData.Height")->second, static_cast<int>(m_ProceduralGridHeight));
+
+	if (m_GridType == CustomTypes::Ocean::GridType::GT_SCREEN_SPACE)
+	{
+		io_Uniforms["u_ProceduralGridData.Origin"] = i_SM.GetUniformLocation("u_ProceduralGridData.Origin");
+		i_SM.SetUniform(io_Uniforms.find("u_ProceduralGridData.Origin")->second, 1, glm::value_ptr(m_ProceduralScreenGridOrigin), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_2);
+
+		io_Uniforms["u_ProceduralGridData.Step"] = i_SM.GetUniformLocation("u_ProceduralGridData.Step");
+		i_SM.SetUniform(io_Uniforms.find("u_ProceduralGridData.Step")->second, 1, glm::value_ptr(m_ProceduralScreenGridStep), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_2);
+	}
+}
+
+void Ocean::BindUniformBlocks ( const ShaderManager& i_SM ) const
+{
+	for (unsigned short i = 0; i < static_cast<unsigned short>(UniformBufferManager::UNIFORM_BLOCK_TYPE::UBT_COUNT); ++i)
+	{
+		UniformBufferManager::UNIFORM_BLOCK_TYPE blockType = static_cast<UniformBufferManager::UNIFORM_BLOCK_TYPE>(i);
+
+		i_SM.BindUniformBlock(UniformBufferManager::GetBlockName(blockType), UniformBufferManager::GetBlockBindingPoint(blockType));
+	}
 }
 
 void Ocean::SetupOceanSurface ( const GlobalConfig& i_Config )
@@ -314,6 +576,24 @@ void Ocean::SetupOceanSurface ( const GlobalConfig& i_Config )
 			m_OceanSurfaceSM.BuildRenderingProgram("resources/shaders/OceanSurfaceWorldGrid.vert.glsl", fragmentShaderPath, i_Config);
 			oceanSurfaceAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_UV] = m_OceanSurfaceSM.GetAttributeLocation("a_uv");
 			break;
+		case CustomTypes::Ocean::GridType::GT_CPU_PROJECTED:
+			m_OceanSurfaceSM.BuildRenderingProgram("resources/shaders/OceanSurfaceCPUGrid.vert.glsl", fragmentShaderPath, i_Config);
+			// the normal slot holds the FFT displacement sampled on the CPU
+			oceanSurfaceAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_OceanSurfaceSM.GetAttributeLocation("a_position");
+			oceanSurfaceAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_NORMAL] = m_OceanSurfaceSM.GetAttributeLocation("a_displacement");
+			break;
+		case CustomTypes::Ocean::GridType::GT_CLIPMAP:
+			m_OceanSurfaceSM.BuildRenderingProgram("resources/shaders/OceanSurfaceClipmap.vert.glsl", fragmentShaderPath, i_Config);
+			oceanSurfaceAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_OceanSurfaceSM.GetAttributeLocation("a_position");
+			break;
+		case CustomTypes::Ocean::GridType::GT_QUADTREE:
+			m_OceanSurfaceSM.BuildRenderingProgram("resources/shaders/OceanSurfaceQuadtree.vert.glsl", fragmentShaderPath, i_Config);
+			oceanSurfaceAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_OceanSurfaceSM.GetAttributeLocation("a_position");
+			break;
+		case CustomTypes::Ocean::GridType::GT_TESSELLATED:
+			m_OceanSurfaceSM.BuildRenderingProgram("resources/shaders/OceanSurfaceTessellated.vert.glsl", "resources/shaders/OceanSurfaceTessellated.tesc.glsl", "resources/shaders/OceanSurfaceTessellated.tese.glsl", fragmentShaderPath, i_Config);
+			oceanSurfaceAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_OceanSurfaceSM.GetAttributeLocation("a_position");
+			break;
 		case CustomTypes::Ocean::GridType::GT_COUNT:
 		default: ERR("Invalid ocean grid type!");
 	}
@@ -322,24 +602,28 @@ void Ocean::SetupOceanSurface ( const GlobalConfig& i_Config )
 
 	m_OceanSurfaceUniforms["u_HDRExposure"] = m_OceanSurfaceSM.GetUniformLocation("u_HDRExposure");
 	m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_HDRExposure")->second, i_Config.Rendering.HDR.Exposure);
-	m_OceanSurfaceUniforms["u_CrrTime"] = m_OceanSurfaceSM.GetUniformLocation("u_CrrTime");
+
+	// the camera, sun, ocean patch and boat effects data
+	BindUniformBlocks(m_OceanSurfaceSM);
+
+	// the uniforms set every frame: the projecting matrix and the clipmap, quadtree and tessellated grid data
+	m_OceanSurfaceHandles.Initialize(m_OceanSurfaceSM, m_kUniformHandleNames);
 
 	// Projector data
-	m_OceanSurfaceUniforms["u_ProjectingMatrix"] = m_OceanSurfaceSM.GetUniformLocation("u_ProjectingMatrix");
 	m_OceanSurfaceUniforms["u_PlaneDistance"] = m_OceanSurfaceSM.GetUniformLocation("u_PlaneDistance");
 	m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_PlaneDistance")->second, m_WaveProjector.GetPlaneDistance());
 
-	// Matrices
-	m_OceanSurfaceUniforms["u_WorldToCameraMatrix"] = m_OceanSurfaceSM.GetUniformLocation("u_WorldToCameraMatrix");
-	m_OceanSurfaceUniforms["u_WorldToClipMatrix"] = m_OceanSurfaceSM.GetUniformLocation("u_WorldToClipMatrix");
-
-	if (m_GridType == CustomTypes::Ocean::GridType::GT_SCREEN_SPACE)
+	if (m_GridType == CustomTypes::Ocean::GridType::GT_TESSELLATED)
 	{
-		m_OceanSurfaceUniforms["u_ClipToCameraMatrix"] = m_OceanSurfaceSM.GetUniformLocation("u_ClipToCameraMatrix");
-		m_OceanSurfaceUniforms["u_CameraToWorldMatrix"] = m_OceanSurfaceSM.GetUniformLocation("u_CameraToWorldMatrix");
-	}
+		m_OceanSurfaceUniforms["u_TessellatedData.PatchSize"] = m_OceanSurfaceSM.GetUniformLocation("u_TessellatedData.PatchSize");
+		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_TessellatedData.PatchSize")->second, m_TessellatedPatchSize);
 
-	m_OceanSurfaceUniforms["u_CameraPosition"] = m_OceanSurfaceSM.GetUniformLocation("u_CameraPosition");
+		int maxTessGenLevel = 0;
+		glGetIntegerv(GL_MAX_TESS_GEN_LEVEL, &maxTessGenLevel);
+
+		m_OceanSurfaceUniforms["u_TessellatedData.MaxTessLevel"] = m_OceanSurfaceSM.GetUniformLocation("u_TessellatedData.MaxTessLevel");
+		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_TessellatedData.MaxTessLevel")->second, glm::clamp(i_Config.Scene.Ocean.Grid.Tessellated.MaxTessLevel, 1.0f, static_cast<float>(maxTessGenLevel)));
+	}
 
 	// FFT Ocean Patch data
 	if (m_pFFTOceanPatch)
@@ -356,8 +640,6 @@ void Ocean::SetupOceanSurface ( const GlobalConfig& i_Config )
 		m_OceanSurfaceUniforms["u_FFTOceanPatchData.WaveAmplitude"] = m_OceanSurfaceSM.GetUniformLocation("u_FFTOceanPatchData.WaveAmplitude");
 		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_FFTOceanPatchData.WaveAmplitude")->second, m_pFFTOceanPatch->GetWaveAmplitude());
 
-		m_OceanSurfaceUniforms["u_FFTOceanPatchData.WindSpeed"] = m_OceanSurfaceSM.GetUniformLocation("u_FFTOceanPatchData.WindSpeed");
-
 		m_OceanSurfaceUniforms["u_FFTOceanPatchData.WindSpeedMixLimit"] = m_OceanSurfaceSM.GetUniformLocation("u_FFTOceanPatchData.WindSpeedMixLimit");
 		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_FFTOceanPatchData.WindSpeedMixLimit")->second, i_Config.Scene.Ocean.Surface.OceanPatch.WindSpeedMixLimit);
 
@@ -369,12 +651,24 @@ void Ocean::SetupOceanSurface ( const GlobalConfig& i_Config )
 
 		m_OceanSurfaceUniforms["u_FFTOceanPatchData.UseFFTSlopes"] = m_OceanSurfaceSM.GetUniformLocation("u_FFTOceanPatchData.UseFFTSlopes");
 		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_FFTOceanPatchData.UseFFTSlopes")->second, i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.UseFFTSlopes);
+
+		// the cascades don't depend on the patch size, only on the config
+		m_OceanSurfaceUniforms["u_FFTOceanPatchData.CascadeCount"] = m_OceanSurfaceSM.GetUniformLocation("u_FFTOceanPatchData.CascadeCount");
+		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_FFTOceanPatchData.CascadeCount")->second, m_pFFTOceanPatch->GetCascadeCount());
+
+		m_OceanSurfaceUniforms["u_FFTOceanPatchData.CascadeUVScales"] = m_OceanSurfaceSM.GetUniformLocation("u_FFTOceanPatchData.CascadeUVScales");
+		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_FFTOceanPatchData.CascadeUVScales")->second, 1, glm::value_ptr(m_pFFTOceanPatch->GetCascadeUVScales()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_4);
+
+		if (m_GridType == CustomTypes::Ocean::GridType::GT_CPU_PROJECTED)
+		{
+			m_OceanSurfaceUniforms["u_UseCPUDisplacement"] = m_OceanSurfaceSM.GetUniformLocation("u_UseCPUDisplacement");
+			m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_UseCPUDisplacement")->second, m_pFFTOceanPatch->GetDisplacementData() != nullptr);
+		}
 	}
 
 	// Perlin Noise data
 	m_OceanSurfaceUniforms["u_PerlinNoiseData.DisplacementMap"] = m_OceanSurfaceSM.GetUniformLocation("u_PerlinNoiseData.DisplacementMap");
 	m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_PerlinNoiseData.DisplacementMap")->second, i_Config.TexUnit.Ocean.Surface.PerlinDisplacementMap);
-	m_OceanSurfaceUniforms["u_PerlinNoiseData.Movement"] = m_OceanSurfaceSM.GetUniformLocation("u_PerlinNoiseData.Movement");
 	m_OceanSurfaceUniforms["u_PerlinNoiseData.Octaves"] = m_OceanSurfaceSM.GetUniformLocation("u_PerlinNoiseData.Octaves");
 	m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_PerlinNoiseData.Octaves")->second, 1, glm::value_ptr(i_Config.Scene.Ocean.Surface.PerlinNoise.Octaves), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
 	m_OceanSurfaceUniforms["u_PerlinNoiseData.Amplitudes"] = m_OceanSurfaceSM.GetUniformLocation("u_PerlinNoiseData.Amplitudes");
@@ -454,10 +748,6 @@ void Ocean::SetupOceanSurface ( const GlobalConfig& i_Config )
 	m_OceanSurfaceUniforms["u_MaxFadeAltitude"] = m_OceanSurfaceSM.GetUniformLocation("u_MaxFadeAltitude");
 	m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_MaxFadeAltitude")->second, i_Config.Scene.Ocean.Surface.MaxFadeAltitude);
 
-	m_OceanSurfaceUniforms["u_IsUnderWater"] = m_OceanSurfaceSM.GetUniformLocation("u_IsUnderWater");
-	m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_IsUnderWater")->second, false);
-
-
 	// Sun data
 	if (m_SkyModelType == CustomTypes::Sky::ModelType::MT_CUBE_MAP || m_SkyModelType == CustomTypes::Sky::ModelType::MT_SCATTERING)
 	{
@@ -484,8 +774,6 @@ void Ocean::SetupOceanSurface ( const GlobalConfig& i_Config )
 		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_SunData.Strength")->second, sunStrength);
 	}
 
-	m_OceanSurfaceUniforms["u_SunData.Direction"] = m_OceanSurfaceSM.GetUniformLocation("u_SunData.Direction");
-
 	if (m_EnableBoatFoam)
 	{
 		m_OceanSurfaceUniforms["u_BoatFoamData.Map"] = m_OceanSurfaceSM.GetUniformLocation("u_BoatFoamData.Map");
@@ -504,11 +792,6 @@ void Ocean::SetupOceanSurface ( const GlobalConfig& i_Config )
 
 		m_OceanSurfaceUniforms["u_BoatKelvinWakeData.Scale"] = m_OceanSurfaceSM.GetUniformLocation("u_BoatKelvinWakeData.Scale");
 		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_BoatKelvinWakeData.Scale")->second, i_Config.Scene.Ocean.Surface.BoatEffects.KelvinWake.Scale);
-
-		m_OceanSurfaceUniforms["u_BoatKelvinWakeData.BoatPosition"] = m_OceanSurfaceSM.GetUniformLocation("u_BoatKelvinWakeData.BoatPosition");
-		m_OceanSurfaceUniforms["u_BoatKelvinWakeData.WakePosition"] = m_OceanSurfaceSM.GetUniformLocation("u_BoatKelvinWakeData.WakePosition");
-		m_OceanSurfaceUniforms["u_BoatKelvinWakeData.Amplitude"] = m_OceanSurfaceSM.GetUniformLocation("u_BoatKelvinWakeData.Amplitude");
-		m_OceanSurfaceUniforms["u_BoatKelvinWakeData.FoamAmount"] = m_OceanSurfaceSM.GetUniformLocation("u_BoatKelvinWakeData.FoamAmount");
 	}
 
 	if (m_EnableBoatPropellerWash)
@@ -519,11 +802,33 @@ void Ocean::SetupOceanSurface ( const GlobalConfig& i_Config )
 		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_BoatPropellerWashData.DistortFactor")->second, i_Config.Scene.Ocean.Surface.BoatEffects.PropellerWash.DistortFactor);
 	}
 
+	// the other grid types draw their own meshes
+	if (m_UseProceduralGrid && (m_GridType == CustomTypes::Ocean::GridType::GT_WORLD_SPACE || m_GridType == CustomTypes::Ocean::GridType::GT_SCREEN_SPACE))
+	{
+		SetupProceduralGridUniforms(m_OceanSurfaceSM, m_OceanSurfaceUniforms);
+	}
+
 	m_OceanSurfaceSM.UnUseProgram();
 
 	//////////////////////
 	m_OceanSurfaceMBM.Initialize("Ocean Surface");
-	m_OceanSurfaceMBM.CreateModelContext(oceanSurfaceAttributes, m_GridMBM.GetVBOID(), m_GridMBM.GetIBOID(), m_GridMBM.GetAccessType());
+	if (m_GridType == CustomTypes::Ocean::GridType::GT_CPU_PROJECTED)
+	{
+		m_OceanSurfaceMBM.CreateModelContext(oceanSurfaceAttributes, m_CPUGridMBM.GetVBOID(), m_GridMBM.GetIBOID(), m_CPUGridMBM.GetAccessType());
+	}
+	else if (m_GridType == CustomTypes::Ocean::GridType::GT_CLIPMAP || m_GridType == CustomTypes::Ocean::GridType::GT_QUADTREE ||
+			 m_GridType == CustomTypes::Ocean::GridType::GT_TESSELLATED)
+	{
+		m_OceanSurfaceMBM.CreateModelContext(oceanSurfaceAttributes, m_TileMBM.GetVBOID(), m_TileMBM.GetIBOID(), m_TileMBM.GetAccessType());
+	}
+	else if (m_UseProceduralGrid)
+	{
+		m_OceanSurfaceMBM.CreateEmptyModelContext();
+	}
+	else
+	{
+		m_OceanSurfaceMBM.CreateModelContext(oceanSurfaceAttributes, m_GridMBM.GetVBOID(), m_GridMBM.GetIBOID(), m_GridMBM.GetAccessType());
+	}
 }
 
 void Ocean::SetupOceanBottom ( const GlobalConfig& i_Config )
@@ -539,6 +844,10 @@ void Ocean::SetupOceanBottom ( const GlobalConfig& i_Config )
 			oceanBottomAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_OceanBottomSM.GetAttributeLocation("a_position");
 			break;
 		case CustomTypes::Ocean::GridType::GT_WORLD_SPACE:
+		case CustomTypes::Ocean::GridType::GT_CPU_PROJECTED:
+		case CustomTypes::Ocean::GridType::GT_CLIPMAP:
+		case CustomTypes::Ocean::GridType::GT_QUADTREE:
+		case CustomTypes::Ocean::GridType::GT_TESSELLATED:
 			m_OceanBottomSM.BuildRenderingProgram("resources/shaders/OceanBottomWorldGrid.vert.glsl", "resources/shaders/OceanBottom.frag.glsl", i_Config);
 			break;
 		case CustomTypes::Ocean::GridType::GT_COUNT:
@@ -555,18 +864,8 @@ void Ocean::SetupOceanBottom ( const GlobalConfig& i_Config )
 	m_OceanBottomUniforms["u_PlaneDistance"] = m_OceanBottomSM.GetUniformLocation("u_PlaneDistance");
 	m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_PlaneDistance")->second, m_BottomProjector.GetPlaneDistance());
 
-	m_OceanBottomUniforms["u_ProjectingMatrix"] = m_OceanBottomSM.GetUniformLocation("u_ProjectingMatrix");
-	m_OceanBottomUniforms["u_WorldToCameraMatrix"] = m_OceanBottomSM.GetUniformLocation("u_WorldToCameraMatrix");
-	m_OceanBottomUniforms["u_WorldToClipMatrix"] = m_OceanBottomSM.GetUniformLocation("u_WorldToClipMatrix");
-
-	if (m_GridType == CustomTypes::Ocean::GridType::GT_SCREEN_SPACE)
-	{
-		m_OceanBottomUniforms["u_ClipToCameraMatrix"] = m_OceanBottomSM.GetUniformLocation("u_ClipToCameraMatrix");
-		m_OceanBottomUniforms["u_CameraToWorldMatrix"] = m_OceanBottomSM.GetUniformLocation("u_CameraToWorldMatrix");
-		m_OceanBottomUniforms["u_CameraPosition"] = m_OceanBottomSM.GetUniformLocation("u_CameraPosition");
-	}
-
-	m_OceanBottomUniforms["u_SunDirection"] = m_OceanBottomSM.GetUniformLocation("u_SunDirection");
+	BindUniformBlocks(m_OceanBottomSM);
+	m_OceanBottomHandles.Initialize(m_OceanBottomSM, m_kUniformHandleNames);
 
 	m_OceanBottomUniforms["u_SandData.DiffuseMap"] = m_OceanBottomSM.GetUniformLocation("u_SandData.DiffuseMap");
 	m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_SandData.DiffuseMap")->second, i_Config.TexUnit.Ocean.Bottom.SandDiffuseMap);
@@ -588,6 +887,22 @@ void Ocean::SetupOceanBottom ( const GlobalConfig& i_Config )
 	m_OceanBottomUniforms["u_CausticsData.Scale"] = m_OceanBottomSM.GetUniformLocation("u_CausticsData.Scale");
 	m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_CausticsData.Scale")->second, i_Config.Scene.Ocean.Bottom.Caustics.Scale);
 
+	if (m_EnableBakedCaustics)
+	{
+		// the per frame caustics program applies these when it renders the caustics map
+		m_OceanBottomUniforms["u_CausticsData.Color"] = m_OceanBottomSM.GetUniformLocation("u_CausticsData.Color");
+		m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_CausticsData.Color")->second, 1, glm::value_ptr(i_Config.Scene.Ocean.Bottom.Caustics.Color), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+		// the atlas keeps the caustics factor divided by m_kMaxFactor
+		m_OceanBottomUniforms["u_CausticsData.Intensity"] = m_OceanBottomSM.GetUniformLocation("u_CausticsData.Intensity");
+		m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_CausticsData.Intensity")->second, i_Config.Scene.Ocean.Bottom.Caustics.Intensity * CausticsBaker::m_kMaxFactor);
+
+		if (m_pFFTOceanPatch)
+		{
+			m_OceanBottomUniforms["u_CausticsData.PatchSize"] = m_OceanBottomSM.GetUniformLocation("u_CausticsData.PatchSize");
+			m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_CausticsData.PatchSize")->second, static_cast<float>(m_pFFTOceanPatch->GetPatchSize()));
+		}
+	}
+
 	if (m_pFFTOceanPatch)
 	{
 		m_OceanBottomUniforms["u_TileScale"] = m_OceanBottomSM.GetUniformLocation("u_TileScale");
@@ -599,16 +914,46 @@ void Ocean::SetupOceanBottom ( const GlobalConfig& i_Config )
 	m_OceanBottomUniforms["u_FogData.Density"] = m_OceanBottomSM.GetUniformLocation("u_FogData.Density");
 	m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_FogData.Density")->second, i_Config.Scene.Ocean.Bottom.Fog.Density);
 
+	if (m_UseProceduralGrid)
+	{
+		SetupProceduralGridUniforms(m_OceanBottomSM, m_OceanBottomUniforms);
+	}
+
 	m_OceanBottomSM.UnUseProgram();
 
 	///////////////////
 	m_OceanBottomMBM.Initialize("Ocean Bottom");
-	m_OceanBottomMBM.CreateModelContext(oceanBottomAttributes, m_GridMBM.GetVBOID(), m_GridMBM.GetIBOID(), m_GridMBM.GetAccessType());
+	if (m_UseProceduralGrid)
+	{
+		m_OceanBottomMBM.CreateEmptyModelContext();
+	}
+	else
+	{
+		m_OceanBottomMBM.CreateModelContext(oceanBottomAttributes, m_GridMBM.GetVBOID(), m_GridMBM.GetIBOID(), m_GridMBM.GetAccessType());
+	}
 }
 
 void Ocean::SetupOceanBottomCaustics ( const GlobalConfig& i_Config )
 {
-	if (m_EnableBottomCaustics)
+	if (m_EnableBakedCaustics)
+	{
+		// the atlas is a single array texture
+		unsigned short frameCount = i_Config.Scene.Ocean.Bottom.Caustics.Baked.FrameCount;
+		while (frameCount > 1 && !TextureManager::CheckLayerCount(frameCount))
+		{
+			frameCount /= 2;
+		}
+
+		if (m_CausticsBaker.Initialize("Ocean Caustics", i_Config.Scene.Ocean.Bottom.Caustics.Baked.Size, frameCount, i_Config.Scene.Ocean.Bottom.Caustics.Baked.RayDensity, i_Config.Scene.Ocean.Bottom.Caustics.Baked.ThreadCount))
+		{
+			unsigned short size = m_CausticsBaker.GetSize();
+
+			// filled by UpdateBakedCaustics(), the bake takes a few seconds, until then there are no caustics
+			std::vector<unsigned char> emptyData(static_cast<size_t>(frameCount) * size * size, 0);
+			m_CausticsAtlasTexId = m_OceanTM.Create2DArrayTexture(frameCount, GL_R8, GL_RED, GL_UNSIGNED_BYTE, size, size, GL_REPEAT, GL_LINEAR, &emptyData[0], i_Config.TexUnit.Ocean.Bottom.CausticsMap, 0, true);
+		}
+	}
+	else if (m_EnableBottomCaustics)
 	{
 		m_OceanCausticsSM.Initialize("Ocean Bottom Caustics");
 
@@ -621,6 +966,10 @@ void Ocean::SetupOceanBottomCaustics ( const GlobalConfig& i_Config )
 				oceanCausticsAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_OceanCausticsSM.GetAttributeLocation("a_position");
 				break;
 			case CustomTypes::Ocean::GridType::GT_WORLD_SPACE:
+			case CustomTypes::Ocean::GridType::GT_CPU_PROJECTED:
+			case CustomTypes::Ocean::GridType::GT_CLIPMAP:
+			case CustomTypes::Ocean::GridType::GT_QUADTREE:
+			case CustomTypes::Ocean::GridType::GT_TESSELLATED:
 				m_OceanCausticsSM.BuildRenderingProgram("resources/shaders/OceanCausticsWorldGrid.vert.glsl", "resources/shaders/OceanCaustics.frag.glsl", i_Config);
 				oceanCausticsAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_UV] = m_OceanCausticsSM.GetAttributeLocation("a_uv");
 				break;
@@ -636,18 +985,8 @@ void Ocean::SetupOceanBottomCaustics ( const GlobalConfig& i_Config )
 		m_OceanCausticsUniforms["u_PlaneDistanceOffset"] = m_OceanCausticsSM.GetUniformLocation("u_PlaneDistanceOffset");
 		m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_PlaneDistanceOffset")->second, i_Config.Scene.Ocean.Bottom.Caustics.PlaneDistanceOffset);
 
-		m_OceanCausticsUniforms["u_BottomProjectingMatrix"] = m_OceanCausticsSM.GetUniformLocation("u_BottomProjectingMatrix");
-
-		m_OceanCausticsUniforms["u_WorldToClipMatrix"] = m_OceanCausticsSM.GetUniformLocation("u_WorldToClipMatrix");
-
-		if (m_GridType == CustomTypes::Ocean::GridType::GT_SCREEN_SPACE)
-		{
-			m_OceanCausticsUniforms["u_ClipToCameraMatrix"] = m_OceanCausticsSM.GetUniformLocation("u_ClipToCameraMatrix");
-			m_OceanCausticsUniforms["u_CameraToWorldMatrix"] = m_OceanCausticsSM.GetUniformLocation("u_CameraToWorldMatrix");
-			m_OceanCausticsUniforms["u_CameraPosition"] = m_OceanCausticsSM.GetUniformLocation("u_CameraPosition");
-		}
-
-		m_OceanCausticsUniforms["u_SunDirection"] = m_OceanCausticsSM.GetUniformLocation("u_SunDirection");
+		BindUniformBlocks(m_OceanCausticsSM);
+		m_OceanCausticsHandles.Initialize(m_OceanCausticsSM, m_kUniformHandleNames);
 
 		if (m_pFFTOceanPatch)
 		{
@@ -664,18 +1003,122 @@ void Ocean::SetupOceanBottomCaustics ( const GlobalConfig& i_Config )
 		m_OceanCausticsUniforms["u_CausticsData.Color"] = m_OceanCausticsSM.GetUniformLocation("u_CausticsData.Color");
 		m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_CausticsData.Color")->second, 1, glm::value_ptr(i_Config.Scene.Ocean.Bottom.Caustics.Color), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3),
 		m_OceanCausticsUniforms["u_CausticsData.Intensity"] = m_OceanCausticsSM.GetUniformLocation("u_CausticsData.Intensity");
-		m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_CausticsData.Intensity")->second, i_Config.Scene.Ocean.Bottom.Caustics.Intensity),
+		m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_CausticsData.Intensity")->second, i_Config.Scene.Ocean.Bottom.Caustics.Intensity);
+
+		if (m_UseProceduralGrid)
+		{
+			SetupProceduralGridUniforms(m_OceanCausticsSM, m_OceanCausticsUniforms);
+		}
 
 		m_OceanCausticsSM.UnUseProgram();
 
 		m_OceanCausticsMBM.Initialize("Ocean Caustics");
-		m_OceanCausticsMBM.CreateModelContext(oceanCausticsAttributes, m_GridMBM.GetVBOID(), m_GridMBM.GetIBOID(), m_GridMBM.GetAccessType());
+		if (m_UseProceduralGrid)
+		{
+			m_OceanCausticsMBM.CreateEmptyModelContext();
+		}
+		else
+		{
+			m_OceanCausticsMBM.CreateModelContext(oceanCausticsAttributes, m_GridMBM.GetVBOID(), m_GridMBM.GetIBOID(), m_GridMBM.GetAccessType());
+		}
 
 		m_OceanCausticsFBM.Initialize("Ocean Caustics", i_Config);
 		m_OceanCausticsFBM.CreateSimple(1, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE, m_CausticsMapSize, m_CausticsMapSize, GL_REPEAT, GL_LINEAR, i_Config.TexUnit.Ocean.Bottom.CausticsMap, 5);
 	}
 }
 
+void Ocean::BakeOceanBottomCaustics ( const glm::vec3& i_SunDirection )
+{
+	// a single try, the atlas stays black if the baker failed
+	m_IsCausticsAtlasBaked = true;
+	m_CausticsRebakeFrameDelay = 0;
+
+	if (m_CausticsAtlasTexId == 0 || !m_pFFTOceanPatch)
+	{
+		return;
+	}
+
+	// a frame of the dropped bake might still be splatted
+	m_CausticsBaker.WaitForFrame();
+
+	m_CausticsBaker.SetSurfaceData(static_cast<float>(m_pFFTOceanPatch->GetPatchSize()), m_pFFTOceanPatch->GetChoppyScale(), i_SunDirection, m_CausticsDepth);
+
+	m_IsCausticsBaking = true;
+	m_CausticsBakeFrameIndex = 0;
+	m_CausticsBakeSunDirection = i_SunDirection;
+	m_CausticsBakeFFTData.clear();
+	m_CausticsBakeStartTime = std::chrono::steady_clock::now();
+}
+
+void Ocean::UpdateBakedCaustics ( void )
+{
+	// one frame at a time, the worker might still splat the previous one
+	if (!m_IsCausticsBaking || !m_CausticsBaker.IsFrameDone())
+	{
+		return;
+	}
+
+	unsigned short frameCount = m_CausticsBaker.GetFrameCount();
+
+	if (m_CausticsBakeFrameIndex < frameCount)
+	{
+		// the frames span the animation period, so the atlas loops
+		float frameTimeStep = m_CausticsTimePeriod / frameCount;
+
+		// the bake frames aren't part of the simulation (the time goes back to 0), the other processes mustn't see them
+		m_pFFTOceanPatch->SetSharingEnabled(false);
+		m_pFFTOceanPatch->EvaluateWaves(m_CausticsBakeFrameIndex * frameTimeStep);
+		m_pFFTOceanPatch->SetSharingEnabled(true);
+
+		m_pFFTOceanPatch->BindFFTWaveDataTexture();
+		// the bind might have been dropped, without selecting the texture unit
+		GLStateCache::ActiveTexture(m_pFFTOceanPatch->GetFFTWaveDataTexUnitId());
+
+		// NOTE! The FFT texture might have more layers than the baker needs (e.g. the cascades), only the first 2 are used
+		if (m_CausticsBakeFFTData.empty())
+		{
+			int layerCount = 0;
+			glGetTexLevelParameteriv(GL_TEXTURE_2D_ARRAY, 0, GL_TEXTURE_DEPTH, &layerCount);
+
+			m_CausticsBakeFFTData.resize(static_cast<size_t>(m_FFTSize) * m_FFTSize * 4 * glm::max(layerCount, 2));
+		}
+		glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, GL_FLOAT, &m_CausticsBakeFFTData[0]);
+
+		m_CausticsBaker.StartFrame(m_CausticsBakeFrameIndex, &m_CausticsBakeFFTData[0], m_FFTSize);
+
+		++ m_CausticsBakeFrameIndex;
+
+		return;
+	}
+
+	////////// All the frames are baked, the new atlas replaces the old one
+	m_IsCausticsBaking = false;
+
+	m_OceanTM.Update2DArrayTextureData(m_CausticsAtlasTexId, const_cast<unsigned char*>(m_CausticsBaker.GetData()));
+	m_CausticsBaker.ReleaseData();
+	std::vector<float>().swap(m_CausticsBakeFFTData);
+
+	m_CausticsBakedLandingOffset = CausticsBaker::ComputeLandingOffset(m_CausticsBakeSunDirection, m_CausticsDepth);
+
+	// the patch size might have changed since the last bake
+	m_OceanBottomSM.UseProgram();
+	m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_CausticsData.PatchSize")->second, static_cast<float>(m_pFFTOceanPatch->GetPatchSize()));
+
+	float bakeTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_CausticsBakeStartTime).count();
+
+	LOG("Ocean - baked %u caustics frames in %.2f s!", frameCount, bakeTime);
+}
+
+void Ocean::InvalidateBakedCaustics ( void )
+{
+	if (m_EnableBakedCaustics)
+	{
+		// the frames baked so far are outdated (e.g. the FFT size changed), the old atlas is used until the new bake is done
+		m_IsCausticsBaking = false;
+		m_CausticsRebakeFrameDelay = m_kCausticsRebakeFrameDelay;
+	}
+}
+
 void Ocean::SetupOceanBottomGodRays ( const GlobalConfig& i_Config )
 {
 	if (m_EnableUnderWaterGodRays)
@@ -742,7 +1185,7 @@ void Ocean::SetupOceanBottomGodRays ( const GlobalConfig& i_Config )
 		oceanOccluderAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_OceanOccluderSM.GetAttributeLocation("a_position");
 		oceanOccluderAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_UV] = m_OceanOccluderSM.GetAttributeLocation("a_uv");
 
-		m_OceanOccluderUniforms["u_WorldToClipMatrix"] = m_OceanOccluderSM.GetUniformLocation("u_WorldToClipMatrix");
+		m_OceanOccluderHandles.Initialize(m_OceanOccluderSM, m_kUniformHandleNames);
 
 		if (m_pFFTOceanPatch)
 		{
@@ -753,16 +1196,15 @@ void Ocean::SetupOceanBottomGodRays ( const GlobalConfig& i_Config )
 			m_OceanOccluderSM.SetUniform(m_OceanOccluderUniforms.find("u_ChoppyScale")->second, m_pFFTOceanPatch->GetChoppyScale());
 		}
 
-		m_OceanOccluderUniforms["u_SunDirY"] = m_OceanOccluderSM.GetUniformLocation("u_SunDirY");
-
 		m_OceanOccluderSM.UnUseProgram();
 
 		m_OceanOccluderMBM.Initialize("Ocean Occluders");
 		m_OceanOccluderMBM.CreateModelContext(occluderVertexData, occluderIndices, oceanOccluderAttributes, MeshBufferManager::ACCESS_TYPE::AT_STATIC);
 
 		////// GOD RAYS SETUP ///////
+		// the multi-pass version only upsamples the rays of the last pass and adds them to the scene
 		m_OceanGodRaysSM.Initialize("Ocean God Rays");
-		m_OceanGodRaysSM.BuildRenderingProgram("resources/shaders/Quad.vert.glsl", "resources/shaders/OceanGodRays.frag.glsl", i_Config);
+		m_OceanGodRaysSM.BuildRenderingProgram("resources/shaders/Quad.vert.glsl", m_EnableMultiPassGodRays ? "resources/shaders/OceanGodRaysUpsample.frag.glsl" : "resources/shaders/OceanGodRays.frag.glsl", i_Config);
 
 		m_OceanGodRaysSM.UseProgram();
 
@@ -781,11 +1223,17 @@ void Ocean::SetupOceanBottomGodRays ( const GlobalConfig& i_Config )
 		m_OceanGodRaysSM.SetUniform(m_OceanGodRaysUniforms.find("u_GodRaysData.Density")->second, m_UnderWaterGodRaysData.Density);
 		m_OceanGodRaysUniforms["u_GodRaysData.Weight"] = m_OceanGodRaysSM.GetUniformLocation("u_GodRaysData.Weight");
 		m_OceanGodRaysSM.SetUniform(m_OceanGodRaysUniforms.find("u_GodRaysData.Weight")->second, m_UnderWaterGodRaysData.Weight);
-		m_OceanGodRaysUniforms["u_GodRaysData.LightDirectionOnScreen"] = m_OceanGodRaysSM.GetUniformLocation("u_GodRaysData.LightDirectionOnScreen");
+		m_OceanGodRaysHandles.Initialize(m_OceanGodRaysSM, m_kUniformHandleNames);
 
 		m_OceanGodRaysUniforms["u_GodRaysData.OccluderMap"] = m_OceanGodRaysSM.GetUniformLocation("u_GodRaysData.OccluderMap");
 		m_OceanGodRaysSM.SetUniform(m_OceanGodRaysUniforms.find("u_GodRaysData.OccluderMap")->second, i_Config.TexUnit.Ocean.UnderWater.GodRaysMap);
 
+		if (m_EnableMultiPassGodRays)
+		{
+			m_OceanGodRaysUniforms["u_GodRaysData.RaysMap"] = m_OceanGodRaysSM.GetUniformLocation("u_GodRaysData.RaysMap");
+			m_OceanGodRaysSM.SetUniform(m_OceanGodRaysUniforms.find("u_GodRaysData.RaysMap")->second, i_Config.TexUnit.Ocean.UnderWater.GodRaysPassMap);
+		}
+
 		m_OceanCausticsSM.UnUseProgram();
 
 		m_OceanGodRaysFBM.Initialize("Ocean God Rays", i_Config);
@@ -799,6 +1247,50 @@ void Ocean::SetupOceanBottomGodRays ( const GlobalConfig& i_Config )
 		// NOTE! For some reason the god rays depth works only when the render buffer is used, there are issues when using the texture as depth only or depth-stencil buffer
 		m_OceanGodRaysFBM.CreateSimple(oceanGodRaysAttributes, 1, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, m_GodRaysMapWidth, m_GodRaysMapHeight, GL_CLAMP_TO_EDGE, GL_LINEAR, i_Config.TexUnit.Ocean.UnderWater.GodRaysMap, -1, false, FrameBufferManager::DEPTH_BUFFER_TYPE::DBT_RENDER_BUFFER_DEPTH);
 		/////////
+
+		////// MULTI-PASS GOD RAYS SETUP ///////
+		if (m_EnableMultiPassGodRays)
+		{
+			m_UnderWaterGodRaysData.PassCount = glm::max(i_Config.Scene.Ocean.UnderWater.GodRays.MultiPass.PassCount, static_cast<unsigned short>(1));
+			m_UnderWaterGodRaysData.SamplesPerPass = glm::max(i_Config.Scene.Ocean.UnderWater.GodRays.MultiPass.SamplesPerPass, static_cast<unsigned short>(2));
+
+			m_OceanGodRaysPassSM.Initialize("Ocean God Rays Pass");
+			m_OceanGodRaysPassSM.BuildRenderingProgram("resources/shaders/Quad.vert.glsl", "resources/shaders/OceanGodRaysPass.frag.glsl", i_Config);
+
+			m_OceanGodRaysPassSM.UseProgram();
+
+			std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int> oceanGodRaysPassAttributes;
+			oceanGodRaysPassAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_OceanGodRaysPassSM.GetAttributeLocation("a_position");
+			oceanGodRaysPassAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_UV] = m_OceanGodRaysPassSM.GetAttributeLocation("a_uv");
+
+			// every pass reads its source (the occluder map or the previous pass) from the same texture unit
+			m_OceanGodRaysPassUniforms["u_GodRaysData.SourceMap"] = m_OceanGodRaysPassSM.GetUniformLocation("u_GodRaysData.SourceMap");
+			m_OceanGodRaysPassSM.SetUniform(m_OceanGodRaysPassUniforms.find("u_GodRaysData.SourceMap")->second, i_Config.TexUnit.Ocean.UnderWater.GodRaysPassMap);
+
+			m_OceanGodRaysPassUniforms["u_GodRaysData.NumberOfSamples"] = m_OceanGodRaysPassSM.GetUniformLocation("u_GodRaysData.NumberOfSamples");
+			m_OceanGodRaysPassSM.SetUniform(m_OceanGodRaysPassUniforms.find("u_GodRaysData.NumberOfSamples")->second, m_UnderWaterGodRaysData.NumberOfSamples);
+			m_OceanGodRaysPassUniforms["u_GodRaysData.SamplesPerPass"] = m_OceanGodRaysPassSM.GetUniformLocation("u_GodRaysData.SamplesPerPass");
+			m_OceanGodRaysPassSM.SetUniform(m_OceanGodRaysPassUniforms.find("u_GodRaysData.SamplesPerPass")->second, m_UnderWaterGodRaysData.SamplesPerPass);
+			m_OceanGodRaysPassUniforms["u_GodRaysData.Decay"] = m_OceanGodRaysPassSM.GetUniformLocation("u_GodRaysData.Decay");
+			m_OceanGodRaysPassSM.SetUniform(m_OceanGodRaysPassUniforms.find("u_GodRaysData.Decay")->second, m_UnderWaterGodRaysData.Decay);
+			m_OceanGodRaysPassUniforms["u_GodRaysData.Density"] = m_OceanGodRaysPassSM.GetUniformLocation("u_GodRaysData.Density");
+			m_OceanGodRaysPassSM.SetUniform(m_OceanGodRaysPassUniforms.find("u_GodRaysData.Density")->second, m_UnderWaterGodRaysData.Density);
+			m_OceanGodRaysPassHandles.Initialize(m_OceanGodRaysPassSM, m_kUniformHandleNames);
+
+			m_OceanGodRaysPassSM.UnUseProgram();
+
+			float resolutionScale = glm::clamp(i_Config.Scene.Ocean.UnderWater.GodRays.MultiPass.ResolutionScale, 0.1f, 1.0f);
+
+			m_GodRaysPassMapWidth = static_cast<unsigned short>(glm::max(glm::round(m_GodRaysMapWidth * resolutionScale), 1.0f));
+			m_GodRaysPassMapHeight = static_cast<unsigned short>(glm::max(glm::round(m_GodRaysMapHeight * resolutionScale), 1.0f));
+
+			// float colors, the passes average many dim taps
+			for (unsigned short i = 0; i < 2; ++i)
+			{
+				m_OceanGodRaysPassFBMs[i].Initialize("Ocean God Rays Pass " + std::to_string(i), i_Config);
+				m_OceanGodRaysPassFBMs[i].CreateSimple(oceanGodRaysPassAttributes, 1, GL_RGBA16F, GL_RGBA, GL_FLOAT, m_GodRaysPassMapWidth, m_GodRaysPassMapHeight, GL_CLAMP_TO_EDGE, GL_LINEAR, i_Config.TexUnit.Ocean.UnderWater.GodRaysPassMap, -1, false);
+			}
+		}
 	}
 }
 
@@ -812,13 +1304,7 @@ void Ocean::SetupDebugFrustum ( const GlobalConfig& i_Config )
 	std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int> frustumAttributes;
 	frustumAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_FrustumSM.GetAttributeLocation("a_position");
 
-	m_FrustumUniforms["u_ViewClipToWorldMatrix"] = m_FrustumSM.GetUniformLocation("u_ViewClipToWorldMatrix");
-	m_FrustumUniforms["u_ProjectorClipToWorldMatrix"] = m_FrustumSM.GetUniformLocation("u_ProjectorClipToWorldMatrix");
-	m_FrustumUniforms["u_WorldToClipMatrix"] = m_FrustumSM.GetUniformLocation("u_WorldToClipMatrix");
-
-	m_FrustumUniforms["u_IsViewFrustum"] = m_FrustumSM.GetUniformLocation("u_IsViewFrustum");
-
-	m_FrustumUniforms["u_Color"] = m_FrustumSM.GetUniformLocation("u_Color");
+	m_FrustumHandles.Initialize(m_FrustumSM, m_kUniformHandleNames);
 
 	m_FrustumSM.UnUseProgram();
 
@@ -960,13 +1446,33 @@ void Ocean::Update ( const Camera& i_Camera, const glm::vec3& i_SunDirection, bo
 
 	m_pCurrentCamera = &const_cast<Camera&>(i_Camera);
 
+	// the blocks of the previous frames might still be read by the GPU
+	m_UBM.BeginFrame();
+
+	UniformBufferManager::SunBlockData sunBlockData;
+	sunBlockData.SunDirection = i_SunDirection;
+	sunBlockData.Padding = 0.0f;
+	m_UBM.SetBlockData(UniformBufferManager::UNIFORM_BLOCK_TYPE::UBT_SUN, &sunBlockData, sizeof(sunBlockData));
+
+	UpdateFFTOceanPatch();
+
+	if (m_CausticsRebakeFrameDelay > 0 && -- m_CausticsRebakeFrameDelay == 0)
+	{
+		m_IsCausticsAtlasBaked = false;
+	}
+
+	// the frames are baked by UpdateBakedCaustics()
+	if (m_EnableBakedCaustics && !m_IsCausticsAtlasBaked)
+	{
+		BakeOceanBottomCaustics(i_SunDirection);
+	}
 
 	UpdateOceanSurface(i_Camera, i_SunDirection, i_CrrTime);
 
 	glm::mat4 bottomGridCorners;
-	UpdateOceanBottom(i_Camera, i_SunDirection, bottomGridCorners);
+	UpdateOceanBottom(i_Camera, bottomGridCorners);
 
-	UpdateOceanBottomCaustics(bottomGridCorners, i_SunDirection);
+	UpdateOceanBottomCaustics(bottomGridCorners, i_SunDirection, i_CrrTime);
 
 	UpdateOceanBottomGodRays(i_Camera, i_SunDirection);
 
@@ -979,10 +1485,32 @@ void Ocean::UpdateOceanSurface ( const Camera& i_Camera, const glm::vec3& i_SunD
 
 	if (m_WaveProjector.IsPlaneWithinFrustum() || m_BottomProjector.IsPlaneWithinFrustum())
 	{
+		// the bake evaluates its own frame, so it's done before the waves of this frame are evaluated
+		// (it waits while the ocean isn't visible, nothing would evaluate the waves of this frame after it)
+		UpdateBakedCaustics();
+
 		m_pFFTOceanPatch->EvaluateWaves(i_CrrTime);
 
+		if (m_GridType == CustomTypes::Ocean::GridType::GT_CPU_PROJECTED && m_WaveProjector.IsPlaneWithinFrustum())
+		{
+			UpdateCPUProjectedGrid();
+		}
+
 		m_OceanSurfaceSM.UseProgram();
 
+		if (m_GridType == CustomTypes::Ocean::GridType::GT_CLIPMAP && m_WaveProjector.IsPlaneWithinFrustum())
+		{
+			UpdateClipmap(i_Camera);
+		}
+		else if (m_GridType == CustomTypes::Ocean::GridType::GT_QUADTREE && m_WaveProjector.IsPlaneWithinFrustum())
+		{
+			UpdateQuadtree(i_Camera);
+		}
+		else if (m_GridType == CustomTypes::Ocean::GridType::GT_TESSELLATED && m_WaveProjector.IsPlaneWithinFrustum())
+		{
+			UpdateTessellatedGrid(i_Camera);
+		}
+
 		//// Perlin Noise vars
 		glm::vec2 perlinNoiseMovement;
 
@@ -996,28 +1524,109 @@ void Ocean::UpdateOceanSurface ( const Camera& i_Camera, const glm::vec3& i_SunD
 		{
 			glm::mat4 waveGridCorners = m_WaveProjector.ComputeGridCorners();
 
-			m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_ProjectingMatrix")->second, 1, glm::value_ptr(waveGridCorners), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+			m_OceanSurfaceSM.SetUniform(m_OceanSurfaceHandles[UNIFORM_HANDLE::UH_PROJECTING_MATRIX], 1, glm::value_ptr(waveGridCorners), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 		}
 		else
 		{
-			m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_ProjectingMatrix")->second, 1, glm::value_ptr(m_WaveProjector.GetProjectingMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+			m_OceanSurfaceSM.SetUniform(m_OceanSurfaceHandles[UNIFORM_HANDLE::UH_PROJECTING_MATRIX], 1, glm::value_ptr(m_WaveProjector.GetProjectingMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 		}
 
-		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_PerlinNoiseData.Movement")->second, 1, glm::value_ptr(perlinNoiseMovement), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_2);
-		if (m_pFFTOceanPatch)
-		{
-			m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_FFTOceanPatchData.WindSpeed")->second, m_pFFTOceanPatch->GetWindSpeed());
-		}
+		UniformBufferManager::OceanPatchBlockData oceanPatchBlockData;
+		oceanPatchBlockData.PerlinNoiseMovement = perlinNoiseMovement;
+		oceanPatchBlockData.WindSpeed = (m_pFFTOceanPatch ? m_pFFTOceanPatch->GetWindSpeed() : 0.0f);
+		oceanPatchBlockData.IsUnderWater = m_WaveProjector.IsUnderMainPlane();
+		m_UBM.SetBlockData(UniformBufferManager::UNIFORM_BLOCK_TYPE::UBT_OCEAN_PATCH, &oceanPatchBlockData, sizeof(oceanPatchBlockData));
+	}
+}
 
-		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_IsUnderWater")->second, m_WaveProjector.IsUnderMainPlane());
+void Ocean::UpdateCPUProjectedGrid ( void )
+{
+	glm::mat4 gridCorners;
+	if (!CPUProjectedGrid::ComputeGridCorners(m_WaveProjector.GetProjectingMatrix(), m_WaveProjector.GetPlane(), gridCorners))
+	{
+		return;
+	}
+
+	m_CPUGridRegion = (m_CPUGridRegion + 1) % m_kCPUGridRegionCount;
+
+	// wait for the GPU to finish drawing from this region (it was used m_kCPUGridRegionCount frames ago)
+	GLsync& fence = m_CPUGridFences[m_CPUGridRegion];
+	if (fence)
+	{
+		glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000); // nanoseconds
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	unsigned int vertexCount = m_CPUGrid.GetVertexCount();
+
+	// the worker threads write directly in the mapped memory
+	MeshBufferManager::VertexData* pVertexData = m_CPUGridMBM.MapModelVertexData(m_CPUGridRegion * vertexCount, vertexCount);
+	if (pVertexData)
+	{
+		// same as the surface shaders, from world space to FFT texture uv
+		float uvScale = m_pFFTOceanPatch->GetTileScale() / m_pFFTOceanPatch->GetPatchSize();
 
-		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_SunData.Direction")->second, 1, glm::value_ptr(i_SunDirection), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+		m_CPUGrid.Generate(gridCorners, m_pFFTOceanPatch->GetDisplacementData(), m_FFTSize, uvScale, pVertexData);
 
-		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_CrrTime")->second, i_CrrTime);
+		m_CPUGridMBM.UnMapModelVertexData();
 	}
 }
 
-void Ocean::UpdateOceanBottom ( const Camera& i_Camera, const glm::vec3& i_SunDirection, glm::mat4& o_BottomGridCorners )
+void Ocean::UpdateClipmap ( const Camera& i_Camera )
+{
+	// the plane distance is measured along the plane normal (0, 1, 0)
+	m_Clipmap.Update(i_Camera.GetPosition(), i_Camera.GetProjectionViewMatrix(), - m_WaveProjector.GetPlaneDistance(), m_ClipmapMaxWaveAmplitude);
+
+	const std::vector<glm::vec4>& levelData = m_Clipmap.GetLevelData();
+	const std::vector<glm::vec4>& visibleTileData = m_Clipmap.GetVisibleTileData();
+
+	m_OceanSurfaceSM.SetUniform(m_OceanSurfaceHandles[UNIFORM_HANDLE::UH_CLIPMAP_LEVELS], levelData.size(), glm::value_ptr(levelData[0]), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_4);
+	if (!visibleTileData.empty())
+	{
+		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceHandles[UNIFORM_HANDLE::UH_CLIPMAP_TILES], visibleTileData.size(), glm::value_ptr(visibleTileData[0]), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_4);
+	}
+}
+
+void Ocean::UpdateQuadtree ( const Camera& i_Camera )
+{
+	int viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	m_Quadtree.Update(i_Camera.GetPosition(), i_Camera.GetProjectionMatrix(), i_Camera.GetProjectionViewMatrix(), viewport[3], m_WaveProjector.GetUpperPlane(), m_WaveProjector.GetLowerPlane());
+
+	// the tiles are sent in batches when rendering
+	const std::vector<glm::vec4>& lodData = m_Quadtree.GetLODData();
+	m_OceanSurfaceSM.SetUniform(m_OceanSurfaceHandles[UNIFORM_HANDLE::UH_QUADTREE_LODS], lodData.size(), glm::value_ptr(lodData[0]), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_4);
+}
+
+void Ocean::UpdateTessellatedGrid ( const Camera& i_Camera )
+{
+	// the grid moves with the camera, in steps of a patch, so the patch vertices never swim over the waves
+	glm::vec2 cameraXZ(i_Camera.GetPosition().x, i_Camera.GetPosition().z);
+	glm::vec2 origin = glm::floor(cameraXZ / m_TessellatedPatchSize) * m_TessellatedPatchSize - 0.5f * m_TessellatedPatchCount * m_TessellatedPatchSize;
+
+	glm::vec4 frustumPlanes[6];
+	HelperFunctions::ExtractFrustumPlanes(i_Camera.GetProjectionViewMatrix(), frustumPlanes);
+
+	// the plane distance is measured along the plane normal (0, 1, 0)
+	float lowerHeight = glm::min(- m_WaveProjector.GetLowerPlane().w, - m_WaveProjector.GetUpperPlane().w);
+	float upperHeight = glm::max(- m_WaveProjector.GetLowerPlane().w, - m_WaveProjector.GetUpperPlane().w);
+	glm::vec4 bounds(lowerHeight, upperHeight, 0.5f * (upperHeight - lowerHeight), 0.0f);
+
+	// an edge of length l, at distance d, covers l * ProjectionMatrix[1][1] * ViewportHeight / (2 * d) pixels
+	int viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	float tessFactor = i_Camera.GetProjectionMatrix()[1][1] * viewport[3] / (2.0f * m_TessellatedTargetEdgeLength);
+
+	m_OceanSurfaceSM.SetUniform(m_OceanSurfaceHandles[UNIFORM_HANDLE::UH_TESSELLATED_ORIGIN], 1, glm::value_ptr(origin), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_2);
+	m_OceanSurfaceSM.SetUniform(m_OceanSurfaceHandles[UNIFORM_HANDLE::UH_TESSELLATED_FRUSTUM_PLANES], 6, glm::value_ptr(frustumPlanes[0]), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_4);
+	m_OceanSurfaceSM.SetUniform(m_OceanSurfaceHandles[UNIFORM_HANDLE::UH_TESSELLATED_BOUNDS], 1, glm::value_ptr(bounds), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_4);
+	m_OceanSurfaceSM.SetUniform(m_OceanSurfaceHandles[UNIFORM_HANDLE::UH_TESSELLATED_TESS_FACTOR], tessFactor);
+}
+
+void Ocean::UpdateOceanBottom ( const Camera& i_Camera, glm::mat4& o_BottomGridCorners )
 {
 	if (m_WaveProjector.IsUnderMainPlane())
 	{
@@ -1031,33 +1640,42 @@ void Ocean::UpdateOceanBottom ( const Camera& i_Camera, const glm::vec3& i_SunDi
 			{
 				o_BottomGridCorners = m_BottomProjector.ComputeGridCorners();
 
-				m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_ProjectingMatrix")->second, 1, glm::value_ptr(o_BottomGridCorners), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+				m_OceanBottomSM.SetUniform(m_OceanBottomHandles[UNIFORM_HANDLE::UH_PROJECTING_MATRIX], 1, glm::value_ptr(o_BottomGridCorners), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 			}
 			else
 			{
-				m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_ProjectingMatrix")->second, 1, glm::value_ptr(m_BottomProjector.GetProjectingMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+				m_OceanBottomSM.SetUniform(m_OceanBottomHandles[UNIFORM_HANDLE::UH_PROJECTING_MATRIX], 1, glm::value_ptr(m_BottomProjector.GetProjectingMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 			}
-			m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_SunDirection")->second, 1, glm::value_ptr(i_SunDirection), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
 		}
 	}
 }
 
-void Ocean::UpdateOceanBottomCaustics ( const glm::mat4& i_BottomGridCorners, const glm::vec3& i_SunDirection )
+void Ocean::UpdateOceanBottomCaustics ( const glm::mat4& i_BottomGridCorners, const glm::vec3& i_SunDirection, float i_CrrTime )
 {
-	if (m_EnableBottomCaustics && m_WaveProjector.IsUnderMainPlane() && m_BottomProjector.IsPlaneWithinFrustum())
+	if (m_EnableBakedCaustics && m_WaveProjector.IsUnderMainPlane() && m_BottomProjector.IsPlaneWithinFrustum())
+	{
+		// same time wrapping as FFTOceanPatchBakedCache::EvaluateWaves()
+		float frame = glm::mod(i_CrrTime, m_CausticsTimePeriod) / m_CausticsTimePeriod * m_CausticsBaker.GetFrameCount();
+
+		// the atlas is baked for one sun direction, the others shift the pattern
+		glm::vec2 sunOffset = CausticsBaker::ComputeLandingOffset(i_SunDirection, m_CausticsDepth) - m_CausticsBakedLandingOffset;
+
+		m_OceanBottomSM.UseProgram();
+		m_OceanBottomSM.SetUniform(m_OceanBottomHandles[UNIFORM_HANDLE::UH_CAUSTICS_FRAME], frame);
+		m_OceanBottomSM.SetUniform(m_OceanBottomHandles[UNIFORM_HANDLE::UH_CAUSTICS_SUN_OFFSET], 1, glm::value_ptr(sunOffset), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_2);
+	}
+	else if (m_EnableBottomCaustics && m_WaveProjector.IsUnderMainPlane() && m_BottomProjector.IsPlaneWithinFrustum())
 	{
 		m_OceanCausticsSM.UseProgram();
 
 		if (m_BottomUseGridCorners)
 		{
-			m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_BottomProjectingMatrix")->second, 1, glm::value_ptr(i_BottomGridCorners), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+			m_OceanCausticsSM.SetUniform(m_OceanCausticsHandles[UNIFORM_HANDLE::UH_BOTTOM_PROJECTING_MATRIX], 1, glm::value_ptr(i_BottomGridCorners), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 		}
 		else
 		{
-			m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_BottomProjectingMatrix")->second, 1, glm::value_ptr(m_BottomProjector.GetProjectingMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+			m_OceanCausticsSM.SetUniform(m_OceanCausticsHandles[UNIFORM_HANDLE::UH_BOTTOM_PROJECTING_MATRIX], 1, glm::value_ptr(m_BottomProjector.GetProjectingMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 		}
-
-		m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_SunDirection")->second, 1, glm::value_ptr(i_SunDirection), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);			
 	}
 }
 
@@ -1078,14 +1696,12 @@ void Ocean::UpdateOceanBottomGodRays ( const Camera& i_Camera, const glm::vec3&
 
 			glm::mat4 PVM = i_Camera.GetProjectionViewMatrix() * glm::translate(glm::mat4(1.0f), occluderPos);
 
-			m_OceanOccluderSM.SetUniform(m_OceanOccluderUniforms.find("u_WorldToClipMatrix")->second, 1, glm::value_ptr(PVM), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+			m_OceanOccluderSM.SetUniform(m_OceanOccluderHandles[UNIFORM_HANDLE::UH_WORLD_TO_CLIP_MATRIX], 1, glm::value_ptr(PVM), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 
-			m_OceanOccluderSM.SetUniform(m_OceanOccluderUniforms.find("u_SunDirY")->second, i_SunDirection.y);
+			m_OceanOccluderSM.SetUniform(m_OceanOccluderHandles[UNIFORM_HANDLE::UH_SUN_DIR_Y], i_SunDirection.y);
 
 
 			//// God Rays Update
-			m_OceanGodRaysSM.UseProgram();
-
 			//// calculte light dir in screen space
 			int viewport[4];
 			glGetIntegerv(GL_VIEWPORT, viewport);
@@ -1110,7 +1726,17 @@ void Ocean::UpdateOceanBottomGodRays ( const Camera& i_Camera, const glm::vec3&
 			lightDirScreen.x /= m_GodRaysMapWidth;
 			lightDirScreen.y /= m_GodRaysMapHeight;
 
-			m_OceanGodRaysSM.SetUniform(m_OceanGodRaysUniforms.find("u_GodRaysData.LightDirectionOnScreen")->second, 1, glm::value_ptr(lightDirScreen), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_2);
+			// the multi-pass version blurs the rays in the passes
+			if (m_EnableMultiPassGodRays)
+			{
+				m_OceanGodRaysPassSM.UseProgram();
+				m_OceanGodRaysPassSM.SetUniform(m_OceanGodRaysPassHandles[UNIFORM_HANDLE::UH_GOD_RAYS_LIGHT_DIRECTION_ON_SCREEN], 1, glm::value_ptr(lightDirScreen), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_2);
+			}
+			else
+			{
+				m_OceanGodRaysSM.UseProgram();
+				m_OceanGodRaysSM.SetUniform(m_OceanGodRaysHandles[UNIFORM_HANDLE::UH_GOD_RAYS_LIGHT_DIRECTION_ON_SCREEN], 1, glm::value_ptr(lightDirScreen), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_2);
+			}
 		}
 	}
 }
@@ -1120,15 +1746,15 @@ void Ocean::UpdateDebugFrustum ( const Camera& i_Camera )
 	if (m_IsFrustumVisible)
 	{
 		m_FrustumSM.UseProgram();
-		m_FrustumSM.SetUniform(m_FrustumUniforms.find("u_ViewClipToWorldMatrix")->second, 1, glm::value_ptr(i_Camera.GetInverseProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+		m_FrustumSM.SetUniform(m_FrustumHandles[UNIFORM_HANDLE::UH_VIEW_CLIP_TO_WORLD_MATRIX], 1, glm::value_ptr(i_Camera.GetInverseProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 
 		if (m_WaveProjector.IsUnderMainPlane())
 		{
-			m_FrustumSM.SetUniform(m_FrustumUniforms.find("u_ProjectorClipToWorldMatrix")->second, 1, glm::value_ptr(m_BottomProjector.GetProjectingCamera().GetInverseProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+			m_FrustumSM.SetUniform(m_FrustumHandles[UNIFORM_HANDLE::UH_PROJECTOR_CLIP_TO_WORLD_MATRIX], 1, glm::value_ptr(m_BottomProjector.GetProjectingCamera().GetInverseProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 		}
 		else
 		{
-			m_FrustumSM.SetUniform(m_FrustumUniforms.find("u_ProjectorClipToWorldMatrix")->second, 1, glm::value_ptr(m_WaveProjector.GetProjectingCamera().GetInverseProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+			m_FrustumSM.SetUniform(m_FrustumHandles[UNIFORM_HANDLE::UH_PROJECTOR_CLIP_TO_WORLD_MATRIX], 1, glm::value_ptr(m_WaveProjector.GetProjectingCamera().GetInverseProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 		}
 	}
 }
@@ -1138,6 +1764,24 @@ void Ocean::UpdateGrid ( unsigned short i_WindowWidth, unsigned short i_WindowHe
 	if (m_GridType == CustomTypes::Ocean::GridType::GT_SCREEN_SPACE)
 	{
 		SetupScreenSpaceGrid(i_WindowWidth, i_WindowHeight);
+
+		// no buffers to rebuild, only the grid size changes
+		if (m_UseProceduralGrid)
+		{
+			m_OceanSurfaceSM.UseProgram();
+			SetupProceduralGridUniforms(m_OceanSurfaceSM, m_OceanSurfaceUniforms);
+
+			m_OceanBottomSM.UseProgram();
+			SetupProceduralGridUniforms(m_OceanBottomSM, m_OceanBottomUniforms);
+
+			if (m_EnableBottomCaustics && !m_EnableBakedCaustics)
+			{
+				m_OceanCausticsSM.UseProgram();
+				SetupProceduralGridUniforms(m_OceanCausticsSM, m_OceanCausticsUniforms);
+			}
+
+			m_OceanBottomSM.UnUseProgram();
+		}
 	}
 }
 
@@ -1147,12 +1791,12 @@ void Ocean::UpdateBoatEffects ( const MotorBoat& i_MotorBoat )
 	{
 		if (m_EnableBoatFoam || m_EnableBoatKelvinWake)
 		{
-			m_OceanSurfaceSM.UseProgram();
-
-			m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_BoatKelvinWakeData.BoatPosition")->second, 1, glm::value_ptr(i_MotorBoat.GetKelvinWakeData().BoatPosition), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
-			m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_BoatKelvinWakeData.WakePosition")->second, 1, glm::value_ptr(i_MotorBoat.GetKelvinWakeData().WakePosition), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
-			m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_BoatKelvinWakeData.Amplitude")->second, i_MotorBoat.GetKelvinWakeData().Amplitude);
-			m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_BoatKelvinWakeData.FoamAmount")->second, i_MotorBoat.GetKelvinWakeData().FoamAmount);
+			UniformBufferManager::BoatEffectsBlockData boatEffectsBlockData;
+			boatEffectsBlockData.BoatPosition = i_MotorBoat.GetKelvinWakeData().BoatPosition;
+			boatEffectsBlockData.KelvinWakeAmplitude = i_MotorBoat.GetKelvinWakeData().Amplitude;
+			boatEffectsBlockData.WakePosition = i_MotorBoat.GetKelvinWakeData().WakePosition;
+			boatEffectsBlockData.KelvinWakeFoamAmount = i_MotorBoat.GetKelvinWakeData().FoamAmount;
+			m_UBM.SetBlockData(UniformBufferManager::UNIFORM_BLOCK_TYPE::UBT_BOAT_EFFECTS, &boatEffectsBlockData, sizeof(boatEffectsBlockData));
 		}
 
 		if (m_EnableBoatPropellerWash)
@@ -1171,6 +1815,16 @@ void Ocean::Render ( const Camera& i_CurrentViewingCamera )
 		m_pFFTOceanPatch->BindNormalFoldingTexture();
 	}
 
+	// shared by the surface, bottom and caustics programs
+	UniformBufferManager::CameraBlockData cameraBlockData;
+	cameraBlockData.WorldToCameraMatrix = i_CurrentViewingCamera.GetViewMatrix();
+	cameraBlockData.WorldToClipMatrix = i_CurrentViewingCamera.GetProjectionViewMatrix();
+	cameraBlockData.ClipToCameraMatrix = i_CurrentViewingCamera.GetInverseProjectionMatrix();
+	cameraBlockData.CameraToWorldMatrix = i_CurrentViewingCamera.GetInverseViewMatrix();
+	cameraBlockData.CameraPosition = i_CurrentViewingCamera.GetPosition();
+	cameraBlockData.Padding = 0.0f;
+	m_UBM.SetBlockData(UniformBufferManager::UNIFORM_BLOCK_TYPE::UBT_CAMERA, &cameraBlockData, sizeof(cameraBlockData));
+
 	RenderOceanSurface(i_CurrentViewingCamera);
 
 	RenderOceanBottomCaustics(i_CurrentViewingCamera);
@@ -1183,9 +1837,32 @@ void Ocean::Render ( const Camera& i_CurrentViewingCamera )
 }
 
 
+void Ocean::DrawGrid ( void ) const
+{
+	if (m_UseProceduralGrid)
+	{
+		glDrawArrays(m_IsWireframeMode ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, 0, m_GridIndexCount);
+	}
+	else
+	{
+		if (m_UseGridPrimitiveRestart)
+		{
+			glEnable(GL_PRIMITIVE_RESTART);
+			glPrimitiveRestartIndex(m_GridRestartIndex);
+		}
+
+		glDrawElements(m_IsWireframeMode ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, m_GridIndexCount, m_GridIndexType, nullptr);
+
+		if (m_UseGridPrimitiveRestart)
+		{
+			glDisable(GL_PRIMITIVE_RESTART);
+		}
+	}
+}
+
 void Ocean::RenderOceanSurface ( const Camera& i_CurrentViewingCamera )
 {
-	if (m_WaveProjector.IsUnderMainPlane() && m_GridType == CustomTypes::Ocean::GridType::GT_WORLD_SPACE)
+	if (m_WaveProjector.IsUnderMainPlane() && m_GridType != CustomTypes::Ocean::GridType::GT_SCREEN_SPACE)
 	{
 		glFrontFace(GL_CW);
 	}
@@ -1194,26 +1871,59 @@ void Ocean::RenderOceanSurface ( const Camera& i_CurrentViewingCamera )
 	{
 		m_OceanSurfaceSM.UseProgram();
 
-		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_WorldToCameraMatrix")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceHandles[UNIFORM_HANDLE::UH_REFL_REFR_WORLD_TO_CLIP_MATRIX], 1, glm::value_ptr(m_ReflRefrWorldToClipMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 
-		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_WorldToClipMatrix")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+		m_OceanSurfaceMBM.BindModelContext();
 
-		if (m_GridType == CustomTypes::Ocean::GridType::GT_SCREEN_SPACE)
+		if (m_GridType == CustomTypes::Ocean::GridType::GT_CPU_PROJECTED)
+		{
+			// draw the region written by the last UpdateCPUProjectedGrid() call
+			glDrawElementsBaseVertex(m_IsWireframeMode ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, m_GridIndexCount, GL_UNSIGNED_INT, nullptr, m_CPUGridRegion * m_CPUGrid.GetVertexCount());
+
+			GLsync& fence = m_CPUGridFences[m_CPUGridRegion];
+			if (fence)
+			{
+				glDeleteSync(fence);
+			}
+			fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+		else if (m_GridType == CustomTypes::Ocean::GridType::GT_CLIPMAP)
 		{
-			m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_ClipToCameraMatrix")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetInverseProjectionMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-			m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_CameraToWorldMatrix")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetInverseViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+			// every instance is a visible tile, check UpdateClipmap()
+			if (m_Clipmap.GetVisibleTileCount() > 0)
+			{
+				glDrawElementsInstanced(m_IsWireframeMode ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, m_TileIndexCount, GL_UNSIGNED_INT, nullptr, m_Clipmap.GetVisibleTileCount());
+			}
 		}
+		else if (m_GridType == CustomTypes::Ocean::GridType::GT_QUADTREE)
+		{
+			// every instance is a visible tile, usually all of them fit in one batch
+			const std::vector<glm::vec4>& visibleTileData = m_Quadtree.GetVisibleTileData();
 
-		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_CameraPosition")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetPosition()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+			for (unsigned int i = 0; i < visibleTileData.size(); i += OceanQuadtree::m_kMaxBatchTileCount)
+			{
+				unsigned int batchTileCount = glm::min(static_cast<unsigned int>(visibleTileData.size()) - i, static_cast<unsigned int>(OceanQuadtree::m_kMaxBatchTileCount));
 
-		m_OceanSurfaceMBM.BindModelContext();
+				m_OceanSurfaceSM.SetUniform(m_OceanSurfaceHandles[UNIFORM_HANDLE::UH_QUADTREE_TILES], batchTileCount, glm::value_ptr(visibleTileData[i]), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_4);
 
-		glDrawElements(m_IsWireframeMode ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, m_GridIndexCount, GL_UNSIGNED_INT, nullptr);
+				glDrawElementsInstanced(m_IsWireframeMode ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, m_TileIndexCount, GL_UNSIGNED_INT, nullptr, batchTileCount);
+			}
+		}
+		else if (m_GridType == CustomTypes::Ocean::GridType::GT_TESSELLATED)
+		{
+			// the tessellation shaders accept only patches, the wireframe mode is done by the polygon mode
+			glPatchParameteri(GL_PATCH_VERTICES, 4);
+			glDrawElements(GL_PATCHES, m_TileIndexCount, GL_UNSIGNED_INT, nullptr);
+		}
+		else
+		{
+			DrawGrid();
+		}
 
 		m_OceanSurfaceMBM.UnBindModelContext();
 	}
 
-	if (m_WaveProjector.IsUnderMainPlane() && m_GridType == CustomTypes::Ocean::GridType::GT_WORLD_SPACE)
+	if (m_WaveProjector.IsUnderMainPlane() && m_GridType != CustomTypes::Ocean::GridType::GT_SCREEN_SPACE)
 	{
 		glFrontFace(GL_CCW);
 	}
@@ -1228,27 +1938,20 @@ void Ocean::RenderOceanBottom ( const Camera& i_CurrentViewingCamera )
 
 	if (m_WaveProjector.IsUnderMainPlane() && m_BottomProjector.IsPlaneWithinFrustum())
 	{
-		if (m_EnableBottomCaustics)
+		if (m_EnableBakedCaustics)
+		{
+			m_OceanTM.BindTexture(m_CausticsAtlasTexId, true);
+		}
+		else if (m_EnableBottomCaustics)
 		{
 			m_OceanCausticsFBM.BindColorAttachmentByIndex(0, true);
 		}
 
 		m_OceanBottomSM.UseProgram();
 
-		m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_WorldToCameraMatrix")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-
-		m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_WorldToClipMatrix")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-
-		if (m_GridType == CustomTypes::Ocean::GridType::GT_SCREEN_SPACE)
-		{
-			m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_ClipToCameraMatrix")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetInverseProjectionMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-			m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_CameraToWorldMatrix")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetInverseViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-			m_OceanBottomSM.SetUniform(m_OceanBottomUniforms.find("u_CameraPosition")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetPosition()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
-		}
-
 		m_OceanBottomMBM.BindModelContext();
 
-		glDrawElements(m_IsWireframeMode ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, m_GridIndexCount, GL_UNSIGNED_INT, nullptr);
+		DrawGrid();
 
 		m_OceanBottomMBM.UnBindModelContext();
 	}
@@ -1256,7 +1959,7 @@ void Ocean::RenderOceanBottom ( const Camera& i_CurrentViewingCamera )
 
 void Ocean::RenderOceanBottomCaustics ( const Camera& i_CurrentViewingCamera )
 {
-	if (m_EnableBottomCaustics && m_WaveProjector.IsUnderMainPlane() && m_BottomProjector.IsPlaneWithinFrustum())
+	if (m_EnableBottomCaustics && !m_EnableBakedCaustics && m_WaveProjector.IsUnderMainPlane() && m_BottomProjector.IsPlaneWithinFrustum())
 	{
 		glm::ivec4 oldViewport, newViewport;
 
@@ -1277,18 +1980,9 @@ void Ocean::RenderOceanBottomCaustics ( const Camera& i_CurrentViewingCamera )
 
 		m_OceanCausticsSM.UseProgram();
 
-		m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_WorldToClipMatrix")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-
-		if (m_GridType == CustomTypes::Ocean::GridType::GT_SCREEN_SPACE)
-		{
-			m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_ClipToCameraMatrix")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetInverseProjectionMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-			m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_CameraToWorldMatrix")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetInverseViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-			m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_CameraPosition")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetPosition()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
-		}
-
 		m_OceanCausticsMBM.BindModelContext();
 
-		glDrawElements(m_IsWireframeMode ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, m_GridIndexCount, GL_UNSIGNED_INT, nullptr);
+		DrawGrid();
 
 		m_OceanCausticsMBM.UnBindModelContext();
 
@@ -1314,6 +2008,10 @@ void Ocean::RenderOceanBottomGodRays ( void )
 		// save current viewport
 		glGetIntegerv(GL_VIEWPORT, &oldViewport[0]);
 
+		// the scene framebuffer, the post processing one or the default one
+		int oldFBOId = 0;
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &oldFBOId);
+
 		newViewport = glm::ivec4(0, 0, m_GodRaysMapWidth, m_GodRaysMapHeight);
 
 		// set new viewport
@@ -1339,7 +2037,44 @@ void Ocean::RenderOceanBottomGodRays ( void )
 
 		m_OceanOccluderMBM.UnBindModelContext();
 
-		m_OceanGodRaysFBM.UnBind();
+		/////////////////////
+		// Blur the occluders towards the light at low resolution, every pass steps SamplesPerPass times as far as the previous one
+		if (m_EnableMultiPassGodRays)
+		{
+			glViewport(0, 0, m_GodRaysPassMapWidth, m_GodRaysPassMapHeight);
+
+			m_OceanGodRaysPassSM.UseProgram();
+
+			// the tap offsets of the passes are the base SamplesPerPass digits of the SamplesPerPass ^ PassCount distinct offsets,
+			// the smallest step is 1 / (SamplesPerPass ^ PassCount - 1), so the steps of all the passes add up to the whole ray
+			float stepFraction = 1.0f / (glm::pow(static_cast<float>(m_UnderWaterGodRaysData.SamplesPerPass), static_cast<float>(m_UnderWaterGodRaysData.PassCount)) - 1.0f);
+			unsigned short passTexUnitId = m_OceanGodRaysPassFBMs[0].GetColorAttachmentTexUnitId(0);
+
+			for (unsigned short i = 0; i < m_UnderWaterGodRaysData.PassCount; ++i)
+			{
+				if (i == 0)
+				{
+					m_OceanGodRaysFBM.BindColorAttachmentByIndex(0, false, passTexUnitId);
+				}
+				else
+				{
+					m_OceanGodRaysPassFBMs[(i - 1) % 2].BindColorAttachmentByIndex(0);
+				}
+
+				m_OceanGodRaysPassFBMs[i % 2].Bind();
+
+				m_OceanGodRaysPassSM.SetUniform(m_OceanGodRaysPassHandles[UNIFORM_HANDLE::UH_GOD_RAYS_STEP_FRACTION], stepFraction);
+				m_OceanGodRaysPassSM.SetUniform(m_OceanGodRaysPassHandles[UNIFORM_HANDLE::UH_GOD_RAYS_IS_FIRST_PASS], i == 0);
+
+				m_OceanGodRaysPassFBMs[i % 2].RenderToQuad();
+
+				stepFraction *= m_UnderWaterGodRaysData.SamplesPerPass;
+			}
+
+			glViewport(oldViewport.x, oldViewport.y, oldViewport.z, oldViewport.w);
+		}
+
+		GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, oldFBOId);
 
 		/////////////////////
 		// Add the light scattering effect
@@ -1347,6 +2082,12 @@ void Ocean::RenderOceanBottomGodRays ( void )
 		// bind occluder texture
 		m_OceanGodRaysFBM.BindColorAttachmentByIndex(0);
 
+		// the multi-pass version upsamples the last pass
+		if (m_EnableMultiPassGodRays)
+		{
+			m_OceanGodRaysPassFBMs[(m_UnderWaterGodRaysData.PassCount - 1) % 2].BindColorAttachmentByIndex(0);
+		}
+
 		m_OceanGodRaysSM.UseProgram();
 
 		// blend
@@ -1365,31 +2106,31 @@ void Ocean::RenderDebugFrustum ( const Camera& i_CurrentViewingCamera )
 	{
 		m_FrustumSM.UseProgram();
 
-		m_FrustumSM.SetUniform(m_FrustumUniforms.find("u_WorldToClipMatrix")->second, 1, glm::value_ptr(i_CurrentViewingCamera.GetProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+		m_FrustumSM.SetUniform(m_FrustumHandles[UNIFORM_HANDLE::UH_WORLD_TO_CLIP_MATRIX], 1, glm::value_ptr(i_CurrentViewingCamera.GetProjectionViewMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 
 		m_FrustumMBM.BindModelContext();
 
 		// Camera frustum - black or white color
-		m_FrustumSM.SetUniform(m_FrustumUniforms.find("u_IsViewFrustum")->second, 1);
+		m_FrustumSM.SetUniform(m_FrustumHandles[UNIFORM_HANDLE::UH_IS_VIEW_FRUSTUM], 1);
 		if (m_WaveProjector.IsUnderMainPlane())
 		{
-			m_FrustumSM.SetUniform(m_FrustumUniforms.find("u_Color")->second, 1, glm::value_ptr(glm::vec3(1.0f, 1.0f, 1.0f)), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+			m_FrustumSM.SetUniform(m_FrustumHandles[UNIFORM_HANDLE::UH_COLOR], 1, glm::value_ptr(glm::vec3(1.0f, 1.0f, 1.0f)), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
 		}
 		else
 		{
-			m_FrustumSM.SetUniform(m_FrustumUniforms.find("u_Color")->second, 1, glm::value_ptr(glm::vec3(0.0f, 0.0f, 0.0f)), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+			m_FrustumSM.SetUniform(m_FrustumHandles[UNIFORM_HANDLE::UH_COLOR], 1, glm::value_ptr(glm::vec3(0.0f, 0.0f, 0.0f)), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
 		}
 		glDrawArrays(GL_LINES, 0, 24);
 
 		// Projector frustum - red or green color
-		m_FrustumSM.SetUniform(m_FrustumUniforms.find("u_IsViewFrustum")->second, 0);
+		m_FrustumSM.SetUniform(m_FrustumHandles[UNIFORM_HANDLE::UH_IS_VIEW_FRUSTUM], 0);
 		if (m_WaveProjector.IsUnderMainPlane())
 		{
-			m_FrustumSM.SetUniform(m_FrustumUniforms.find("u_Color")->second, 1, glm::value_ptr(glm::vec3(0.0f, 1.0f, 0.0f)), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+			m_FrustumSM.SetUniform(m_FrustumHandles[UNIFORM_HANDLE::UH_COLOR], 1, glm::value_ptr(glm::vec3(0.0f, 1.0f, 0.0f)), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
 		}
 		else
 		{
-			m_FrustumSM.SetUniform(m_FrustumUniforms.find("u_Color")->second, 1, glm::value_ptr(glm::vec3(1.0f, 0.0f, 0.0f)), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+			m_FrustumSM.SetUniform(m_FrustumHandles[UNIFORM_HANDLE::UH_COLOR], 1, glm::value_ptr(glm::vec3(1.0f, 0.0f, 0.0f)), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
 		}
 		glDrawArrays(GL_LINES, 24, 24);
 
@@ -1564,6 +2305,41 @@ float Ocean::GetGodRaysWeight ( void ) const
 	return m_UnderWaterGodRaysData.Weight;
 }
 
+CustomTypes::Ocean::GridType Ocean::GetGridType ( void ) const
+{
+	return m_GridType;
+}
+
+unsigned short Ocean::GetFFTSize ( void ) const
+{
+	return m_FFTSize;
+}
+
+float Ocean::GetScreenSpaceGridResolution ( void ) const
+{
+	return m_ScreenSpaceGridResolution;
+}
+
+unsigned short Ocean::GetCausticsMapSize ( void ) const
+{
+	return m_CausticsMapSize;
+}
+
+float Ocean::GetQuadtreeSelectionTime ( void ) const
+{
+	return m_Quadtree.GetLastSelectionTime();
+}
+
+unsigned int Ocean::GetQuadtreeVisibleTileCount ( void ) const
+{
+	return m_Quadtree.GetVisibleTileCount();
+}
+
+unsigned int Ocean::GetQuadtreeCulledTileCount ( void ) const
+{
+	return m_Quadtree.GetCulledTileCount();
+}
+
 bool Ocean::IsUnderWater ( void ) const
 {
 	return m_WaveProjector.IsUnderMainPlane();
@@ -1577,6 +2353,8 @@ void Ocean::SetWaveAmplitude ( float i_WaveAmplitude )
 
 		m_OceanSurfaceSM.UseProgram();
 		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_FFTOceanPatchData.WaveAmplitude")->second, i_WaveAmplitude);
+
+		InvalidateBakedCaustics();
 	}
 }
 
@@ -1584,13 +2362,26 @@ void Ocean::SetPatchSize ( unsigned short i_PatchSize )
 {
 	if (m_pFFTOceanPatch)
 	{
+		unsigned short fftSize = (m_FFTOceanPatchBuilder.IsBuilding() ? m_FFTOceanPatchBuilder.GetFFTSize() : m_FFTSize);
+
+		// rebuilt on a worker thread, check UpdateFFTOceanPatch()
+		if (m_FFTOceanPatchBuilder.Start(*m_pFFTOceanPatch, fftSize, i_PatchSize))
+		{
+			return;
+		}
+
 		m_pFFTOceanPatch->SetPatchSize(i_PatchSize);
 
 		m_OceanSurfaceSM.UseProgram();
 		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_FFTOceanPatchData.PatchSize")->second, static_cast<float>(i_PatchSize));
 
-		m_OceanCausticsSM.UseProgram();
-		m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_PatchSize")->second, static_cast<float>(i_PatchSize));
+		if (m_EnableBottomCaustics && !m_EnableBakedCaustics)
+		{
+			m_OceanCausticsSM.UseProgram();
+			m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_PatchSize")->second, static_cast<float>(i_PatchSize));
+		}
+
+		InvalidateBakedCaustics();
 	}
 }
 
@@ -1600,8 +2391,7 @@ void Ocean::SetWindSpeed ( float i_WindSpeed )
 	{
 		m_pFFTOceanPatch->SetWindSpeed(i_WindSpeed);
 
-		m_OceanSurfaceSM.UseProgram();
-		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_FFTOceanPatchData.WindSpeed")->second, static_cast<float>(i_WindSpeed));
+		InvalidateBakedCaustics();
 	}
 }
 
@@ -1610,6 +2400,8 @@ void Ocean::SetWindDirectionX ( float i_WindDirectionX )
 	if (m_pFFTOceanPatch)
 	{
 		m_pFFTOceanPatch->SetWindDirectionX(i_WindDirectionX);
+
+		InvalidateBakedCaustics();
 	}
 }
 
@@ -1618,6 +2410,8 @@ void Ocean::SetWindDirectionZ ( float i_WindDirectionZ )
 	if (m_pFFTOceanPatch)
 	{
 		m_pFFTOceanPatch->SetWindDirectionZ(i_WindDirectionZ);
+
+		InvalidateBakedCaustics();
 	}
 }
 
@@ -1626,6 +2420,8 @@ void Ocean::SetOpposingWavesFactor ( float i_OpposingWavesFactor )
 	if (m_pFFTOceanPatch)
 	{
 		m_pFFTOceanPatch->SetOpposingWavesFactor(i_OpposingWavesFactor);
+
+		InvalidateBakedCaustics();
 	}
 }
 
@@ -1634,6 +2430,8 @@ void Ocean::SetVerySmallWavesFactor ( float i_VerySmallWavesFactor )
 	if (m_pFFTOceanPatch)
 	{
 		m_pFFTOceanPatch->SetVerySmallWavesFactor(i_VerySmallWavesFactor);
+
+		InvalidateBakedCaustics();
 	}
 }
 
@@ -1646,8 +2444,13 @@ void Ocean::SetChoppyScale ( float i_ChoppyScale )
 		m_OceanSurfaceSM.UseProgram();
 		m_OceanSurfaceSM.SetUniform(m_OceanSurfaceUniforms.find("u_FFTOceanPatchData.ChoppyScale")->second, i_ChoppyScale);
 
-		m_OceanCausticsSM.UseProgram();
-		m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_ChoppyScale")->second, static_cast<float>(i_ChoppyScale));
+		if (m_EnableBottomCaustics && !m_EnableBakedCaustics)
+		{
+			m_OceanCausticsSM.UseProgram();
+			m_OceanCausticsSM.SetUniform(m_OceanCausticsUniforms.find("u_ChoppyScale")->second, static_cast<float>(i_ChoppyScale));
+		}
+
+		InvalidateBakedCaustics();
 	}
 }
 
@@ -1671,6 +2474,12 @@ void Ocean::SetGodRaysNumberOfSamples ( unsigned short i_NumberOfSamples )
 
 	m_OceanGodRaysSM.UseProgram();
 	m_OceanGodRaysSM.SetUniform(m_OceanGodRaysUniforms.find("u_GodRaysData.NumberOfSamples")->second, m_UnderWaterGodRaysData.NumberOfSamples);
+
+	if (m_EnableMultiPassGodRays)
+	{
+		m_OceanGodRaysPassSM.UseProgram();
+		m_OceanGodRaysPassSM.SetUniform(m_OceanGodRaysPassUniforms.find("u_GodRaysData.NumberOfSamples")->second, m_UnderWaterGodRaysData.NumberOfSamples);
+	}
 }
 
 void Ocean::SetGodRaysExposure ( float i_Exposure )
@@ -1687,6 +2496,12 @@ void Ocean::SetGodRaysDecay ( float i_Decay )
 
 	m_OceanGodRaysSM.UseProgram();
 	m_OceanGodRaysSM.SetUniform(m_OceanGodRaysUniforms.find("u_GodRaysData.Decay")->second, m_UnderWaterGodRaysData.Decay);
+
+	if (m_EnableMultiPassGodRays)
+	{
+		m_OceanGodRaysPassSM.UseProgram();
+		m_OceanGodRaysPassSM.SetUniform(m_OceanGodRaysPassUniforms.find("u_GodRaysData.Decay")->second, m_UnderWaterGodRaysData.Decay);
+	}
 }
 
 void Ocean::SetGodRaysDensity ( float i_Density )
@@ -1695,6 +2510,12 @@ void Ocean::SetGodRaysDensity ( float i_Density )
 
 	m_OceanGodRaysSM.UseProgram();
 	m_OceanGodRaysSM.SetUniform(m_OceanGodRaysUniforms.find("u_GodRaysData.Density")->second, m_UnderWaterGodRaysData.Density);
+
+	if (m_EnableMultiPassGodRays)
+	{
+		m_OceanGodRaysPassSM.UseProgram();
+		m_OceanGodRaysPassSM.SetUniform(m_OceanGodRaysPassUniforms.find("u_GodRaysData.Density")->second, m_UnderWaterGodRaysData.Density);
+	}
 }
 
 void Ocean::SetGodRaysWeight ( float i_Weight )
@@ -1703,4 +2524,58 @@ void Ocean::SetGodRaysWeight ( float i_Weight )
 
 	m_OceanGodRaysSM.UseProgram();
 	m_OceanGodRaysSM.SetUniform(m_OceanGodRaysUniforms.find("u_GodRaysData.Weight")->second, m_UnderWaterGodRaysData.Weight);
+}
+
+void Ocean::SetFFTSize ( unsigned short i_FFTSize )
+{
+	if (!m_pFFTOceanPatch)
+	{
+		return;
+	}
+
+	bool isBuilding = m_FFTOceanPatchBuilder.IsBuilding();
+
+	// the last requested patch might not be ready yet
+	unsigned short fftSize = (isBuilding ? m_FFTOceanPatchBuilder.GetFFTSize() : m_FFTSize);
+	unsigned short patchSize = (isBuilding ? m_FFTOceanPatchBuilder.GetPatchSize() : m_pFFTOceanPatch->GetPatchSize());
+
+	if (i_FFTSize == fftSize)
+	{
+		return;
+	}
+
+	// rebuilt on a worker thread, check UpdateFFTOceanPatch()
+	m_FFTOceanPatchBuilder.Start(*m_pFFTOceanPatch, i_FFTSize, patchSize);
+}
+
+void Ocean::SetScreenSpaceGridResolution ( float i_Resolution )
+{
+	if (i_Resolution == m_ScreenSpaceGridResolution)
+	{
+		return;
+	}
+
+	m_ScreenSpaceGridResolution = i_Resolution;
+
+	// same window size, the grid is rebuilt because the resolution changed
+	UpdateGrid(m_ScreenSpaceGridCacheWidth, m_ScreenSpaceGridCacheHeight);
+}
+
+void Ocean::SetCausticsMapSize ( unsigned short i_CausticsMapSize )
+{
+	// the baked atlas has its own size (check CausticsBaker)
+	if (!m_EnableBottomCaustics || m_EnableBakedCaustics || i_CausticsMapSize == m_CausticsMapSize)
+	{
+		return;
+	}
+
+	m_CausticsMapSize = i_CausticsMapSize;
+
+	// the mipmaps are regenerated when the map is bound
+	m_OceanCausticsFBM.UpdateColorAttachmentSize(0, m_CausticsMapSize, m_CausticsMapSize);
+}
+
+void Ocean::SetReflRefrWorldToClipMatrix ( const glm::mat4& i_WorldToClipMatrix )
+{
+	m_ReflRefrWorldToClipMatrix = i_WorldToClipMatrix;
 }
\ No newline at end of file
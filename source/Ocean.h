@@ -5,10 +5,17 @@
 
 #include "CustomTypes.h"
 #include "ShaderManager.h"
+#include "UniformBufferManager.h"
 #include "MeshBufferManager.h"
 #include "FrameBufferManager.h"
 #include "TextureManager.h"
 #include "Projector.h"
+#include "CPUProjectedGrid.h"
+#include "OceanClipmap.h"
+#include "OceanQuadtree.h"
+#include "FFTOceanPatchBuilder.h"
+#include "CausticsBaker.h"
+#include "GLConfig.h"
 //#define GLM_SWIZZLE //offers the possibility to use: xx(), xy(), xyz(), ...
 #include "glm/vec2.hpp"
 #include "glm/vec3.hpp"
@@ -16,6 +23,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <chrono>
 
 class Camera;
 class MotorBoat;
@@ -87,6 +95,18 @@ public:
 
 	bool IsUnderWater(void) const;
 
+	CustomTypes::Ocean::GridType GetGridType(void) const;
+
+	// quality settings (check QualityGovernor)
+	unsigned short GetFFTSize(void) const;
+	float GetScreenSpaceGridResolution(void) const;
+	unsigned short GetCausticsMapSize(void) const;
+
+	// quadtree grid stats
+	float GetQuadtreeSelectionTime(void) const;
+	unsigned int GetQuadtreeVisibleTileCount(void) const;
+	unsigned int GetQuadtreeCulledTileCount(void) const;
+
 	void SetWaveAmplitude(float i_WaveAmplitude);
 	void SetPatchSize(unsigned short i_PatchSize);
 	void SetWindSpeed(float i_WindSpeed);
@@ -103,21 +123,51 @@ public:
 	void SetGodRaysDensity(float i_Density);
 	void SetGodRaysWeight(float i_Weight);
 
+	// rebuilds the FFT ocean patch on a worker thread, the current wave parameters are kept (the baked cache keeps its own FFT size)
+	// the new patch replaces the old one in Update(), once it's ready
+	void SetFFTSize(unsigned short i_FFTSize);
+	// only the screen space grid uses it
+	void SetScreenSpaceGridResolution(float i_Resolution);
+	void SetCausticsMapSize(unsigned short i_CausticsMapSize);
+
+	// the world to clip matrix the local reflection and refraction maps were rendered with,
+	// the surface reprojects the maps with it when they are older than the current frame
+	void SetReflRefrWorldToClipMatrix(const glm::mat4& i_WorldToClipMatrix);
+
 private:
 	//// Methods ////
+	void CreateFFTOceanPatch(const GlobalConfig& i_Config);
+	// swaps in the patch built by m_FFTOceanPatchBuilder
+	void UpdateFFTOceanPatch(void);
+
 	void SetupGrid(const GlobalConfig& i_Config);
 	void SetupOceanSurface(const GlobalConfig& i_Config);
 	void SetupScreenSpaceGrid(unsigned short i_WindowWidth, unsigned short i_WindowHeight);
+	// the world space or the screen space grid, the model context must be bound
+	void DrawGrid(void) const;
+	// the program must be in use
+	void SetupProceduralGridUniforms(const ShaderManager& i_SM, std::map<std::string, int>& io_Uniforms) const;
 
 	void SetupOceanBottom(const GlobalConfig& i_Config);
 	void SetupOceanBottomCaustics(const GlobalConfig& i_Config);
+	// starts baking the looping caustics atlas, on the first update, for the current sun direction
+	void BakeOceanBottomCaustics(const glm::vec3& i_SunDirection);
+	// once per frame, before the waves of the frame are evaluated: reads back the next bake frame and splats it on a worker thread
+	// the atlas in use is replaced when all the frames are baked
+	void UpdateBakedCaustics(void);
+	// the waves changed, the bake in progress is dropped, the atlas is baked again once they stop changing (check m_kCausticsRebakeFrameDelay)
+	void InvalidateBakedCaustics(void);
 	void SetupOceanBottomGodRays(const GlobalConfig& i_Config);
 	void SetupDebugFrustum(const GlobalConfig& i_Config);
 	void SetupTextures(const GlobalConfig& i_Config);
 
 	void UpdateOceanSurface(const Camera& i_Camera, const glm::vec3& i_SunDirection, float i_CrrTime);
-	void UpdateOceanBottom(const Camera& i_Camera, const glm::vec3& i_SunDirection, glm::mat4& o_BottomGridCorners);
-	void UpdateOceanBottomCaustics(const glm::mat4& i_BottomGridCorners, const glm::vec3& i_SunDirection);
+	void UpdateCPUProjectedGrid(void);
+	void UpdateClipmap(const Camera& i_Camera);
+	void UpdateQuadtree(const Camera& i_Camera);
+	void UpdateTessellatedGrid(const Camera& i_Camera);
+	void UpdateOceanBottom(const Camera& i_Camera, glm::mat4& o_BottomGridCorners);
+	void UpdateOceanBottomCaustics(const glm::mat4& i_BottomGridCorners, const glm::vec3& i_SunDirection, float i_CrrTime);
 	void UpdateOceanBottomGodRays(const Camera& i_Camera, const glm::vec3& i_SunDirection);
 	void UpdateDebugFrustum(const Camera& i_Camera);
 
@@ -129,25 +179,72 @@ private:
 
 	void Destroy(void);
 
+	void BindUniformBlocks(const ShaderManager& i_SM) const;
+
 	//// Projector
 	Projector m_WaveProjector, m_BottomProjector;
 
 	//// FFT Ocen Patch
 	FFTOceanPatchBase* m_pFFTOceanPatch;
+	FFTOceanPatchBuilder m_FFTOceanPatchBuilder;
 
 	//// Variables ////
-	ShaderManager m_OceanSurfaceSM, m_OceanBottomSM, m_OceanCausticsSM, m_OceanOccluderSM, m_OceanGodRaysSM;
+	ShaderManager m_OceanSurfaceSM, m_OceanBottomSM, m_OceanCausticsSM, m_OceanOccluderSM, m_OceanGodRaysSM, m_OceanGodRaysPassSM;
 	MeshBufferManager m_GridMBM, m_OceanSurfaceMBM, m_OceanBottomMBM, m_OceanCausticsMBM , m_OceanOccluderMBM;
 	FrameBufferManager m_OceanCausticsFBM, m_OceanGodRaysFBM;
+	// the multi-pass god rays ping-pong between these low resolution maps
+	FrameBufferManager m_OceanGodRaysPassFBMs[2];
 	TextureManager m_OceanTM;
 
 	unsigned int m_GridVertexCount, m_GridIndexCount;
 	unsigned int m_OccluderIndexCount;
 	float m_ScreenSpaceGridResolution;
 
+	// the world and screen space grids are generated in the vertex shaders from gl_VertexID, without vertex and index buffers
+	bool m_UseProceduralGrid;
+	unsigned int m_ProceduralGridWidth, m_ProceduralGridHeight;
+	// clip space position of the first vertex and the distance between two vertices
+	glm::vec2 m_ProceduralScreenGridOrigin, m_ProceduralScreenGridStep;
+
+	// GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, the screen space grid uses 16 bit indices when they fit
+	unsigned int m_GridIndexType;
+	// the screen space grid rows are separate strips
+	unsigned int m_GridRestartIndex;
+	bool m_UseGridPrimitiveRestart;
+
+	// vertices per band of the screen space grid strips, small enough for the post-transform vertex cache
+	static const unsigned short m_kScreenSpaceGridBandWidth = 32;
+	// the screen space grid is rebuilt only when these change
+	unsigned short m_ScreenSpaceGridCacheWidth, m_ScreenSpaceGridCacheHeight;
+	float m_ScreenSpaceGridCacheResolution;
+
 	unsigned short m_GodRaysMapWidth, m_GodRaysMapHeight;
+	unsigned short m_GodRaysPassMapWidth, m_GodRaysPassMapHeight;
 	unsigned short m_CausticsMapSize;
 
+	//// Baked caustics
+	// replaces the per frame caustics map (m_OceanCausticsSM, m_OceanCausticsFBM)
+	CausticsBaker m_CausticsBaker;
+	unsigned int m_CausticsAtlasTexId;
+	bool m_IsCausticsAtlasBaked;
+	// the ocean animation period, the atlas frames span it
+	float m_CausticsTimePeriod;
+	// the depth of the caustics plane below the surface
+	float m_CausticsDepth;
+	// where the flat surface refraction lands for the baked sun direction
+	glm::vec2 m_CausticsBakedLandingOffset;
+	// the frames left until the atlas is baked again, 0 - it's up to date
+	// a GUI slider changes the waves every frame while it's dragged, so the bake waits for the last change
+	static const unsigned short m_kCausticsRebakeFrameDelay = 30;
+	unsigned short m_CausticsRebakeFrameDelay;
+	// the bake in progress: the next frame to read back, m_CausticsBaker.GetFrameCount() - all of them were read back
+	bool m_IsCausticsBaking;
+	unsigned short m_CausticsBakeFrameIndex;
+	glm::vec3 m_CausticsBakeSunDirection;
+	// the FFT wave data texture read back
+	std::vector<float> m_CausticsBakeFFTData;
+	std::chrono::steady_clock::time_point m_CausticsBakeStartTime;
+
 	float m_PerlinNoiseSpeed;
 
 	// self init
@@ -157,6 +254,46 @@ private:
 	std::map<std::string, int> m_OceanCausticsUniforms;
 	std::map<std::string, int> m_OceanOccluderUniforms;
 	std::map<std::string, int> m_OceanGodRaysUniforms;
+	std::map<std::string, int> m_OceanGodRaysPassUniforms;
+
+	// the uniforms set every frame (the maps above are used only by the setup code)
+	// one handle enum for all the programs, the names missing from a program get the -1 location
+	enum class UNIFORM_HANDLE
+	{
+		UH_PROJECTING_MATRIX = 0,
+		UH_BOTTOM_PROJECTING_MATRIX,
+		UH_CLIPMAP_LEVELS,
+		UH_CLIPMAP_TILES,
+		UH_QUADTREE_LODS,
+		UH_QUADTREE_TILES,
+		UH_TESSELLATED_ORIGIN,
+		UH_TESSELLATED_FRUSTUM_PLANES,
+		UH_TESSELLATED_BOUNDS,
+		UH_TESSELLATED_TESS_FACTOR,
+		UH_WORLD_TO_CLIP_MATRIX,
+		UH_SUN_DIR_Y,
+		UH_GOD_RAYS_LIGHT_DIRECTION_ON_SCREEN,
+		UH_VIEW_CLIP_TO_WORLD_MATRIX,
+		UH_PROJECTOR_CLIP_TO_WORLD_MATRIX,
+		UH_IS_VIEW_FRUSTUM,
+		UH_COLOR,
+		UH_REFL_REFR_WORLD_TO_CLIP_MATRIX,
+		UH_GOD_RAYS_STEP_FRACTION,
+		UH_GOD_RAYS_IS_FIRST_PASS,
+		UH_CAUSTICS_FRAME,
+		UH_CAUSTICS_SUN_OFFSET,
+		UH_COUNT
+	};
+
+	static const char* const m_kUniformHandleNames[static_cast<unsigned short>(UNIFORM_HANDLE::UH_COUNT)];
+
+	typedef ShaderManager::UniformHandleTable<UNIFORM_HANDLE, static_cast<unsigned short>(UNIFORM_HANDLE::UH_COUNT)> UniformHandles;
+	UniformHandles m_OceanSurfaceHandles, m_OceanBottomHandles, m_OceanCausticsHandles, m_OceanOccluderHandles, m_OceanGodRaysHandles, m_OceanGodRaysPassHandles;
+
+	// the camera, sun, ocean patch and boat effects blocks (check UniformBufferManager)
+	UniformBufferManager m_UBM;
+
+	glm::mat4 m_ReflRefrWorldToClipMatrix;
 
 	bool m_IsWireframeMode;
 
@@ -164,6 +301,7 @@ private:
 	ShaderManager m_FrustumSM;
 	MeshBufferManager m_FrustumMBM;
 	std::map<std::string, int> m_FrustumUniforms;
+	UniformHandles m_FrustumHandles;
 
 	bool m_IsFrustumVisible;
 
@@ -179,14 +317,42 @@ private:
 		float Decay;
 		float Density;
 		float Weight;
+		// multi-pass version
+		unsigned short PassCount;
+		unsigned short SamplesPerPass;
 	} m_UnderWaterGodRaysData;
 
 	float m_SunDirY;
 
+	unsigned short m_FFTSize;
+
+	//// CPU projected grid
+	static const unsigned short m_kCPUGridRegionCount = 3;
+
+	CPUProjectedGrid m_CPUGrid;
+	MeshBufferManager m_CPUGridMBM;
+	GLsync m_CPUGridFences[m_kCPUGridRegionCount];
+	unsigned short m_CPUGridRegion;
+
+	//// Clipmap and quadtree grids
+	OceanClipmap m_Clipmap;
+	OceanQuadtree m_Quadtree;
+	// the tile mesh shared by all the clipmap or quadtree tiles (the patches mesh for the tessellated grid)
+	MeshBufferManager m_TileMBM;
+	unsigned int m_TileIndexCount;
+	float m_ClipmapMaxWaveAmplitude;
+
+	//// Tessellated grid
+	unsigned short m_TessellatedPatchCount;
+	float m_TessellatedPatchSize;
+	float m_TessellatedTargetEdgeLength;
+
 	bool m_SurfaceUseGridCorners;
 	bool m_BottomUseGridCorners;
 	bool m_EnableUnderWaterGodRays;
+	bool m_EnableMultiPassGodRays;
 	bool m_EnableBottomCaustics;
+	bool m_EnableBakedCaustics;
 	bool m_EnableBoatFoam;
 	bool m_EnableBoatKelvinWake;
 	bool m_EnableBoatPropellerWash;
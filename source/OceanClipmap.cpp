@@ -0,0 +1,219 @@
+/* Author: BAIRAC MIHAI */
+
+#include "OceanClipmap.h"
+#include "CommonHeaders.h"
+#include "GlobalConfig.h"
+#include "HelperFunctions.h"
+#include "glm/common.hpp" //floor(), clamp()
+
+
+OceanClipmap::OceanClipmap ( void )
+	: m_TileResolution(0), m_LevelCount(0), m_CellSize(0.0f), m_MorphRegion(0.0f)
+{
+	LOG("OceanClipmap successfully created!");
+}
+
+OceanClipmap::OceanClipmap ( const GlobalConfig& i_Config )
+	: m_TileResolution(0), m_LevelCount(0), m_CellSize(0.0f), m_MorphRegion(0.0f)
+{
+	Initialize(i_Config);
+}
+
+OceanClipmap::~OceanClipmap ( void )
+{
+	Destroy();
+}
+
+void OceanClipmap::Destroy ( void )
+{
+	LOG("OceanClipmap successfully destroyed!");
+}
+
+void OceanClipmap::Initialize ( const GlobalConfig& i_Config )
+{
+	Initialize(i_Config.Scene.Ocean.Grid.Clipmap.TileResolution, i_Config.Scene.Ocean.Grid.Clipmap.LevelCount, i_Config.Scene.Ocean.Grid.Clipmap.CellSize, i_Config.Scene.Ocean.Grid.Clipmap.MorphRegion);
+}
+
+void OceanClipmap::Initialize ( unsigned short i_TileResolution, unsigned short i_LevelCount, float i_CellSize, float i_MorphRegion )
+{
+	// the morphing needs an even number of quads per tile side
+	if (i_TileResolution < 2 || i_TileResolution % 2 != 0)
+	{
+		ERR("Invalid clipmap tile resolution! It must be an even number!");
+		return;
+	}
+
+	if (i_LevelCount < 1 || i_LevelCount > m_kMaxLevelCount)
+	{
+		ERR("Invalid clipmap level count! It must be between 1 and %u!", m_kMaxLevelCount);
+		return;
+	}
+
+	if (i_CellSize <= 0.0f)
+	{
+		ERR("Invalid clipmap cell size!");
+		return;
+	}
+
+	m_TileResolution = i_TileResolution;
+	m_LevelCount = i_LevelCount;
+	m_CellSize = i_CellSize;
+	m_MorphRegion = glm::clamp(i_MorphRegion, 0.01f, 1.0f);
+
+	m_LevelData.resize(m_LevelCount);
+	m_VisibleTileData.reserve(GetTileCount());
+
+	LOG("OceanClipmap - %u levels, %u x %u quads per tile, %u tiles!", m_LevelCount, m_TileResolution, m_TileResolution, GetTileCount());
+
+	LOG("OceanClipmap successfully created!");
+}
+
+void OceanClipmap::CreateTileMesh ( std::vector<MeshBufferManager::VertexData>& o_VertexData, std::vector<unsigned int>& o_Indices ) const
+{
+	CreateTileMesh(m_TileResolution, o_VertexData, o_Indices);
+}
+
+void OceanClipmap::CreateTileMesh ( unsigned short i_TileResolution, std::vector<MeshBufferManager::VertexData>& o_VertexData, std::vector<unsigned int>& o_Indices )
+{
+	unsigned int width = i_TileResolution + 1;
+
+	o_VertexData.resize(width * width);
+
+	unsigned int index = 0;
+	for (unsigned int i = 0; i < width; ++i)
+	{
+		for (unsigned int j = 0; j < width; ++j)
+		{
+			index = i * width + j;
+
+			o_VertexData[index].position = glm::vec3(static_cast<float>(j), 0.0f, static_cast<float>(i));
+			o_VertexData[index].uv = glm::vec2(j, i) / static_cast<float>(i_TileResolution);
+		}
+	}
+
+	// same zig-zag strip as the world space grid, but with the opposite winding, so the triangles face upwards
+	o_Indices.resize(2 * width * (width - 1));
+
+	for (unsigned int i = 0; i < width - 1; ++i)
+	{
+		for (unsigned int j = 0; j < width; ++j)
+		{
+			index = (j + i * width) * 2;
+			if (i % 2 == 0)
+			{
+				o_Indices[index] = j + i * width;
+				o_Indices[index + 1] = j + (i + 1) * width;
+			}
+			else
+			{
+				o_Indices[index] = width - 1 - j + (i + 1) * width;
+				o_Indices[index + 1] = width - 1 - j + i * width;
+			}
+		}
+	}
+}
+
+void OceanClipmap::Update ( const glm::vec3& i_CameraPosition, const glm::mat4& i_ProjectionViewMatrix, float i_PlaneHeight, float i_MaxWaveAmplitude )
+{
+	m_VisibleTileData.clear();
+
+	if (m_LevelCount == 0)
+	{
+		return;
+	}
+
+	glm::vec4 frustumPlanes[6];
+	HelperFunctions::ExtractFrustumPlanes(i_ProjectionViewMatrix, frustumPlanes);
+
+	glm::vec2 cameraXZ(i_CameraPosition.x, i_CameraPosition.z);
+
+	//// Level centres, from the coarsest to the finest level
+	// a level centre is snapped to twice the level tile size (the coarser level tile size),
+	// so the level border always falls on the coarser level vertices and the hole in the coarser level is made of whole tiles
+	for (int l = m_LevelCount - 1; l >= 0; --l)
+	{
+		float tileSize = m_TileResolution * m_CellSize * static_cast<float>(1 << l);
+		float snapSize = 2.0f * tileSize;
+
+		glm::vec2 centre = glm::floor(cameraXZ / snapSize + 0.5f) * snapSize;
+
+		if (l < m_LevelCount - 1)
+		{
+			// keep the level inside the hole of the coarser level
+			glm::vec2 coarserCentre(m_LevelData[l + 1].x, m_LevelData[l + 1].y);
+			centre = glm::clamp(centre, coarserCentre - snapSize, coarserCentre + snapSize);
+		}
+
+		// the coarsest level has nothing to morph to, the morphing starts at the level border (the shader guards the zero region)
+		float morphStart = (l < m_LevelCount - 1 ? 1.0f - m_MorphRegion : 1.0f);
+
+		m_LevelData[l] = glm::vec4(centre, 2.0f * tileSize, morphStart);
+	}
+
+	//// Tiles
+	for (unsigned short l = 0; l < m_LevelCount; ++l)
+	{
+		float cellSize = m_CellSize * static_cast<float>(1 << l);
+		float tileSize = m_TileResolution * cellSize;
+
+		glm::vec2 levelOrigin = glm::vec2(m_LevelData[l].x, m_LevelData[l].y) - 2.0f * tileSize;
+
+		// the finer level window (whole tiles of this level)
+		glm::vec2 holeMin(0.0f), holeMax(0.0f);
+		if (l > 0)
+		{
+			holeMin = glm::vec2(m_LevelData[l - 1].x, m_LevelData[l - 1].y) - tileSize;
+			holeMax = glm::vec2(m_LevelData[l - 1].x, m_LevelData[l - 1].y) + tileSize;
+		}
+
+		for (unsigned short i = 0; i < 4; ++i)
+		{
+			for (unsigned short j = 0; j < 4; ++j)
+			{
+				glm::vec2 tileMin = levelOrigin + glm::vec2(j, i) * tileSize;
+				glm::vec2 tileMax = tileMin + tileSize;
+
+				// half a cell of tolerance for the floating point errors
+				if (l > 0 && tileMin.x > holeMin.x - 0.5f * cellSize && tileMax.x < holeMax.x + 0.5f * cellSize &&
+							 tileMin.y > holeMin.y - 0.5f * cellSize && tileMax.y < holeMax.y + 0.5f * cellSize)
+				{
+					continue;
+				}
+
+				// the waves displace the vertices in all directions
+				glm::vec3 boxMin(tileMin.x - i_MaxWaveAmplitude, i_PlaneHeight - i_MaxWaveAmplitude, tileMin.y - i_MaxWaveAmplitude);
+				glm::vec3 boxMax(tileMax.x + i_MaxWaveAmplitude, i_PlaneHeight + i_MaxWaveAmplitude, tileMax.y + i_MaxWaveAmplitude);
+
+				if (HelperFunctions::IsBoxInsideFrustum(frustumPlanes, boxMin, boxMax))
+				{
+					m_VisibleTileData.push_back(glm::vec4(tileMin, cellSize, static_cast<float>(l)));
+				}
+			}
+		}
+	}
+}
+
+const std::vector<glm::vec4>& OceanClipmap::GetLevelData ( void ) const
+{
+	return m_LevelData;
+}
+
+const std::vector<glm::vec4>& OceanClipmap::GetVisibleTileData ( void ) const
+{
+	return m_VisibleTileData;
+}
+
+unsigned short OceanClipmap::GetLevelCount ( void ) const
+{
+	return m_LevelCount;
+}
+
+unsigned short OceanClipmap::GetTileCount ( void ) const
+{
+	return (m_LevelCount > 0 ? 16 + 12 * (m_LevelCount - 1) : 0);
+}
+
+unsigned short OceanClipmap::GetVisibleTileCount ( void ) const
+{
+	return static_cast<unsigned short>(m_VisibleTileData.size());
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+/* Author: BAIRAC MIHAI
+
+ Implementation based on the geometry clipmaps and CDLOD works
+ Geometry clipmaps paper: http://hhoppe.com/proj/gpugcm/
+ CDLOD paper: https://github.com/fstrugar/CDLOD
+
+*/
+
+#ifndef OCEAN_CLIPMAP_H
+#define OCEAN_CLIPMAP_H
+
+#include "MeshBufferManager.h"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "glm/mat4x4.hpp"
+#include <vector>
+
+class GlobalConfig;
+
+/*
+ Geometry clipmap for the world space ocean grid
+
+ Every level is a 4 x 4 tiles square centred on the camera, each level being twice as big as the previous one.
+ The finest level is drawn whole, the other levels are rings of 12 tiles (the middle 2 x 2 tiles are covered by the finer level).
+ So the number of tiles and triangles stays the same, no matter how far the camera sees.
+
+ All the tiles share the same mesh (TileResolution x TileResolution quads), the tile origin and the level cell size are
+ applied in the vertex shader (check OceanSurfaceClipmap.vert.glsl), so the visible tiles are drawn with one instanced call.
+ The level centres are snapped to the coarser level grid, so the vertices never swim over the waves,
+ and the vertices close to the border of a level are morphed to the coarser level vertices, so there are no cracks.
+
+ The tiles are culled on the CPU against the camera frustum.
+*/
+
+class OceanClipmap
+{
+public:
+	// the levels and the tiles are sent to the vertex shader as uniform arrays (the instance data)
+	static const unsigned short m_kMaxLevelCount = 10;
+	static const unsigned short m_kMaxTileCount = 16 + 12 * (m_kMaxLevelCount - 1);
+
+	OceanClipmap(void);
+	OceanClipmap(const GlobalConfig& i_Config);
+	~OceanClipmap(void);
+
+	void Initialize(const GlobalConfig& i_Config);
+	void Initialize(unsigned short i_TileResolution, unsigned short i_LevelCount, float i_CellSize, float i_MorphRegion);
+
+	// position - tile vertex coordinates (x and z in [0, TileResolution]), uv - tile uv
+	// the indices form a triangle strip, the triangles face upwards
+	void CreateTileMesh(std::vector<MeshBufferManager::VertexData>& o_VertexData, std::vector<unsigned int>& o_Indices) const;
+	static void CreateTileMesh(unsigned short i_TileResolution, std::vector<MeshBufferManager::VertexData>& o_VertexData, std::vector<unsigned int>& o_Indices);
+
+	// i_PlaneHeight - the ocean plane height, i_MaxWaveAmplitude - how much the waves displace the tiles (used for culling)
+	void Update(const glm::vec3& i_CameraPosition, const glm::mat4& i_ProjectionViewMatrix, float i_PlaneHeight, float i_MaxWaveAmplitude);
+
+	// per level: xy - level centre, z - level half size, w - where the morphing starts (relative to the half size)
+	const std::vector<glm::vec4>& GetLevelData(void) const;
+	// per visible tile: xy - tile origin, z - cell size, w - level index
+	const std::vector<glm::vec4>& GetVisibleTileData(void) const;
+
+	unsigned short GetLevelCount(void) const;
+	unsigned short GetTileCount(void) const;
+	unsigned short GetVisibleTileCount(void) const;
+
+private:
+	//// Methods ////
+	void Destroy(void);
+
+	//// Variables ////
+	unsigned short m_TileResolution;
+	unsigned short m_LevelCount;
+	float m_CellSize;
+	float m_MorphRegion;
+
+	std::vector<glm::vec4> m_LevelData;
+	std::vector<glm::vec4> m_VisibleTileData;
+};
+
+#endif /* OCEAN_CLIPMAP_H */
\ No newline at end of file
@@ -0,0 +1,166 @@
+/* Author: BAIRAC MIHAI */
+
+#include "OceanFieldPublisher.h"
+#include "CommonHeaders.h"
+#include "GlobalConfig.h"
+#include <new> // placement new
+#include <cassert>
+#ifndef _WIN32
+#include <sys/mman.h> // shm_open(), shm_unlink(), mmap(), munmap()
+#include <sys/stat.h> // mode constants, fstat()
+#include <fcntl.h> // O_* constants
+#include <unistd.h> // ftruncate(), close()
+#endif // _WIN32
+
+
+OceanFieldPublisher::OceanFieldPublisher ( void )
+	: m_pRing(nullptr), m_RingSize(0), m_FileDescriptor(-1)
+{
+	LOG("OceanFieldPublisher successfully created!");
+}
+
+OceanFieldPublisher::OceanFieldPublisher ( const GlobalConfig& i_Config, unsigned short i_LayerCount )
+	: m_pRing(nullptr), m_RingSize(0), m_FileDescriptor(-1)
+{
+	Initialize(i_Config, i_LayerCount);
+}
+
+OceanFieldPublisher::~OceanFieldPublisher ( void )
+{
+	Destroy();
+}
+
+void OceanFieldPublisher::Destroy ( void )
+{
+#ifndef _WIN32
+	if (m_pRing)
+	{
+		// the readers which still have it mapped open the name again
+		OceanFieldRing::Close(m_pRing);
+
+		munmap(m_pRing, m_RingSize);
+		m_pRing = nullptr;
+	}
+
+	if (m_FileDescriptor != -1)
+	{
+		// a patch swapped at runtime creates the shared memory of its publisher before the replaced patch is destroyed,
+		// so the name is removed only if it still refers to this shared memory, otherwise the new readers couldn't open it
+		bool isNameOwned = false;
+
+		struct stat ownStat;
+		if (fstat(m_FileDescriptor, &ownStat) == 0)
+		{
+			int nameFileDescriptor = shm_open(m_Name.c_str(), O_RDONLY, 0);
+			if (nameFileDescriptor != -1)
+			{
+				struct stat nameStat;
+				isNameOwned = (fstat(nameFileDescriptor, &nameStat) == 0 && nameStat.st_dev == ownStat.st_dev && nameStat.st_ino == ownStat.st_ino);
+
+				close(nameFileDescriptor);
+			}
+		}
+
+		close(m_FileDescriptor);
+		m_FileDescriptor = -1;
+
+		// the readers that still have it mapped keep their mapping
+		if (isNameOwned)
+		{
+			shm_unlink(m_Name.c_str());
+		}
+	}
+#endif // _WIN32
+
+	LOG("OceanFieldPublisher successfully destroyed!");
+}
+
+void OceanFieldPublisher::Initialize ( const GlobalConfig& i_Config, unsigned short i_LayerCount )
+{
+	static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2, "Lock free 32 and 64 bit atomics are required by the shared memory ring!");
+
+	m_Name = i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.SharedMemoryPublisher.Name;
+
+	unsigned short fftSize = i_Config.Scene.Ocean.Surface.OceanPatch.FFTSize;
+	unsigned short slotCount = i_Config.Scene.Ocean.Surface.OceanPatch.ComputeFFT.SharedMemoryPublisher.SlotCount;
+
+	// a reader needs at least one slot that is not being overwritten
+	if (slotCount < 2)
+	{
+		ERR("Invalid shared memory publisher slot count! At least 2 slots are needed!");
+		slotCount = 2;
+	}
+
+	uint32_t frameDataSize = static_cast<uint32_t>(fftSize) * fftSize * i_LayerCount * sizeof(glm::vec4);
+
+#ifdef _WIN32
+	ERR("The shared memory publisher is available only on POSIX platforms!");
+	return;
+#else
+	if (m_Name.empty() || m_Name[0] != '/')
+	{
+		ERR("Invalid shared memory name! It must start with '/'!");
+		return;
+	}
+
+	// a previous instance might have crashed, so start from scratch
+	shm_unlink(m_Name.c_str());
+
+	m_FileDescriptor = shm_open(m_Name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if (m_FileDescriptor == -1)
+	{
+		ERR("Failed to create %s shared memory!", m_Name.c_str());
+		return;
+	}
+
+	m_RingSize = OceanFieldRing::GetRingSize(slotCount, frameDataSize);
+
+	if (ftruncate(m_FileDescriptor, static_cast<off_t>(m_RingSize)) == -1)
+	{
+		ERR("Failed to resize %s shared memory!", m_Name.c_str());
+		Destroy();
+		return;
+	}
+
+	void* pMemory = mmap(nullptr, m_RingSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_FileDescriptor, 0);
+	if (pMemory == MAP_FAILED)
+	{
+		ERR("Failed to map %s shared memory!", m_Name.c_str());
+		Destroy();
+		return;
+	}
+
+	// the memory is zero filled by ftruncate(), so all the slot sequences start at 0
+	m_pRing = new (pMemory) OceanFieldRing::RingHeader;
+	m_pRing->fftSize = fftSize;
+	m_pRing->layerCount = i_LayerCount;
+	m_pRing->slotCount = slotCount;
+	m_pRing->frameDataSize = frameDataSize;
+	m_pRing->latestFrame.store(0, std::memory_order_relaxed);
+	m_pRing->isClosed.store(0, std::memory_order_relaxed);
+	m_pRing->version = OceanFieldRing::kVersion;
+
+	// the magic is written last, the readers check it to know the ring is ready
+	std::atomic_thread_fence(std::memory_order_release);
+	m_pRing->magic = OceanFieldRing::kMagic;
+
+	LOG("OceanFieldPublisher - %s shared memory: %u slots, %u bytes per frame!", m_Name.c_str(), slotCount, frameDataSize);
+#endif // _WIN32
+
+	LOG("OceanFieldPublisher successfully created!");
+}
+
+void OceanFieldPublisher::Publish ( const glm::vec4* i_pFrameData, float i_SimulationTime )
+{
+	assert(i_pFrameData != nullptr);
+
+	if (m_pRing)
+	{
+		OceanFieldRing::WriteFrame(m_pRing, i_pFrameData, i_SimulationTime);
+	}
+}
+
+bool OceanFieldPublisher::IsOpen ( void ) const
+{
+	return (m_pRing != nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef OCEAN_FIELD_PUBLISHER_H
+#define OCEAN_FIELD_PUBLISHER_H
+
+#include "OceanFieldRing.h"
+#include "glm/vec4.hpp"
+#include <string>
+
+class GlobalConfig;
+
+/*
+ Publishes the CPU FFT ocean fields (displacement + slopes) to other local processes
+ (e.g. radar, sensors, motion platform) through a POSIX shared memory ring buffer
+
+ Check OceanFieldRing for the memory layout and the lock free synchronization
+ The readers map the memory read only and never block the producer, check tools/OceanFieldReader
+ The ring is marked closed when the publisher is destroyed, so the readers of a swapped patch open its new ring
+*/
+
+class OceanFieldPublisher
+{
+public:
+	OceanFieldPublisher(void);
+	OceanFieldPublisher(const GlobalConfig& i_Config, unsigned short i_LayerCount);
+	~OceanFieldPublisher(void);
+
+	void Initialize(const GlobalConfig& i_Config, unsigned short i_LayerCount);
+
+	// i_pFrameData - FFTSize * FFTSize rgba values per layer, layer after layer
+	void Publish(const glm::vec4* i_pFrameData, float i_SimulationTime);
+
+	bool IsOpen(void) const;
+
+private:
+	//// Methods ////
+	void Destroy(void);
+
+	//// Variables ////
+	std::string m_Name;
+
+	OceanFieldRing::RingHeader* m_pRing;
+	size_t m_RingSize;
+
+	int m_FileDescriptor;
+};
+
+#endif /* OCEAN_FIELD_PUBLISHER_H */
\ No newline at end of file
@@ -0,0 +1,175 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef OCEAN_FIELD_RING_H
+#define OCEAN_FIELD_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+/*
+ Memory layout of the ocean fields ring buffer shared with other local processes (check OceanFieldPublisher)
+ It has NO dependencies on the rest of the application, so the reader library (tools/OceanFieldReader) uses it too
+
+ Layout: RingHeader | Slot 0 | Slot 1 | ... | Slot n - 1
+ Slot: SlotHeader | frame data (FFTSize * FFTSize rgba floats per layer, layer after layer)
+ Layer 0 - displacement (x, y, z), layer 1 (optional) - slopes (x, z)
+
+ Synchronization - a lock free sequence counter per slot:
+ frame f (starting from 1) is written in slot f % slotCount
+ slot sequence = 2 * f - 1 while the frame is written, 2 * f after it's complete
+ The producer never waits for the readers. A reader copies the frame and checks that the slot sequence
+ didn't change meanwhile, otherwise it retries with the latest frame.
+
+ The producer sets isClosed before it unmaps the ring (exit, or a patch swapped at runtime which creates a new ring under the same name),
+ the readers then open the name again.
+
+ NOTE! std::atomic<uint64_t> must be lock free, so it can live in shared memory
+*/
+
+namespace OceanFieldRing
+{
+	const uint32_t kMagic = 0x4E52464F; // "OFRN"
+	const uint32_t kVersion = 2;
+
+	// every slot starts on its own cache line
+	const size_t kAlignment = 64;
+
+	struct RingHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t fftSize;
+		uint32_t layerCount;
+		uint32_t slotCount;
+		uint32_t frameDataSize; // in bytes
+		std::atomic<uint64_t> latestFrame; // 0 - nothing published yet
+		std::atomic<uint32_t> isClosed; // 1 - no more frames are published in this ring
+	};
+
+	struct SlotHeader
+	{
+		std::atomic<uint64_t> sequence;
+		uint64_t publishTime; // steady clock, in nanoseconds
+		float simulationTime;
+		uint32_t reserved;
+	};
+
+	inline size_t Align ( size_t i_Size )
+	{
+		return (i_Size + kAlignment - 1) / kAlignment * kAlignment;
+	}
+
+	inline size_t GetSlotSize ( uint32_t i_FrameDataSize )
+	{
+		return Align(sizeof(SlotHeader) + i_FrameDataSize);
+	}
+
+	inline size_t GetRingSize ( uint32_t i_SlotCount, uint32_t i_FrameDataSize )
+	{
+		return Align(sizeof(RingHeader)) + i_SlotCount * GetSlotSize(i_FrameDataSize);
+	}
+
+	inline SlotHeader* GetSlot ( RingHeader* i_pRing, uint64_t i_Frame )
+	{
+		unsigned char* pSlots = reinterpret_cast<unsigned char*>(i_pRing) + Align(sizeof(RingHeader));
+
+		return reinterpret_cast<SlotHeader*>(pSlots + (i_Frame % i_pRing->slotCount) * GetSlotSize(i_pRing->frameDataSize));
+	}
+
+	inline const SlotHeader* GetSlot ( const RingHeader* i_pRing, uint64_t i_Frame )
+	{
+		return GetSlot(const_cast<RingHeader*>(i_pRing), i_Frame);
+	}
+
+	// the frame data follows the slot header
+	inline unsigned char* GetSlotData ( SlotHeader* i_pSlot )
+	{
+		return reinterpret_cast<unsigned char*>(i_pSlot) + sizeof(SlotHeader);
+	}
+
+	inline const unsigned char* GetSlotData ( const SlotHeader* i_pSlot )
+	{
+		return reinterpret_cast<const unsigned char*>(i_pSlot) + sizeof(SlotHeader);
+	}
+
+	// same clock in all the local processes
+	inline uint64_t GetTimeNow ( void )
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// producer side
+	inline void WriteFrame ( RingHeader* io_pRing, const void* i_pFrameData, float i_SimulationTime )
+	{
+		uint64_t frame = io_pRing->latestFrame.load(std::memory_order_relaxed) + 1;
+		SlotHeader* pSlot = GetSlot(io_pRing, frame);
+
+		// odd - the slot is being written
+		pSlot->sequence.store(2 * frame - 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		std::memcpy(GetSlotData(pSlot), i_pFrameData, io_pRing->frameDataSize);
+		pSlot->simulationTime = i_SimulationTime;
+		pSlot->publishTime = GetTimeNow();
+
+		pSlot->sequence.store(2 * frame, std::memory_order_release);
+		io_pRing->latestFrame.store(frame, std::memory_order_release);
+	}
+
+	// producer side, the last write to the ring
+	inline void Close ( RingHeader* io_pRing )
+	{
+		io_pRing->isClosed.store(1, std::memory_order_release);
+	}
+
+	// consumer side
+	inline bool IsClosed ( const RingHeader* i_pRing )
+	{
+		return (i_pRing->isClosed.load(std::memory_order_acquire) != 0);
+	}
+
+	// consumer side, returns false if nothing was published yet or the producer kept overwriting the frames
+	inline bool ReadLatestFrame ( const RingHeader* i_pRing, void* o_pFrameData, uint64_t& o_Frame, uint64_t& o_PublishTime, float& o_SimulationTime, unsigned short i_MaxRetryCount = 8 )
+	{
+		for (unsigned short i = 0; i <= i_MaxRetryCount; ++i)
+		{
+			uint64_t frame = i_pRing->latestFrame.load(std::memory_order_acquire);
+			if (frame == 0)
+			{
+				return false;
+			}
+
+			const SlotHeader* pSlot = GetSlot(i_pRing, frame);
+
+			uint64_t sequence = pSlot->sequence.load(std::memory_order_acquire);
+			if (sequence != 2 * frame)
+			{
+				// already overwritten by a newer frame
+				continue;
+			}
+
+			std::memcpy(o_pFrameData, GetSlotData(pSlot), i_pRing->frameDataSize);
+			uint64_t publishTime = pSlot->publishTime;
+			float simulationTime = pSlot->simulationTime;
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (pSlot->sequence.load(std::memory_order_relaxed) != sequence)
+			{
+				continue;
+			}
+
+			o_Frame = frame;
+			o_PublishTime = publishTime;
+			o_SimulationTime = simulationTime;
+
+			return true;
+		}
+
+		return false;
+	}
+}
+
+#endif /* OCEAN_FIELD_RING_H */
\ No newline at end of file
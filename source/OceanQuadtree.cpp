@@ -0,0 +1,219 @@
+/* Author: BAIRAC MIHAI */
+
+#include "OceanQuadtree.h"
+#include "OceanClipmap.h"
+#include "CommonHeaders.h"
+#include "GlobalConfig.h"
+#include "HelperFunctions.h"
+#include "PhysicsConstants.h"
+#include "glm/common.hpp" //floor(), clamp(), max()
+#include "glm/geometric.hpp" //length()
+#include "glm/exponential.hpp" //sqrt()
+#include <chrono> // std::chrono::steady_clock
+
+
+OceanQuadtree::OceanQuadtree ( void )
+	: m_TileResolution(0), m_LODCount(0), m_CellSize(0.0f), m_MaxScreenSpaceError(0.0f), m_MorphRegion(0.0f),
+	  m_CulledTileCount(0), m_LastSelectionTime(0.0f)
+{
+	LOG("OceanQuadtree successfully created!");
+}
+
+OceanQuadtree::OceanQuadtree ( const GlobalConfig& i_Config )
+	: m_TileResolution(0), m_LODCount(0), m_CellSize(0.0f), m_MaxScreenSpaceError(0.0f), m_MorphRegion(0.0f),
+	  m_CulledTileCount(0), m_LastSelectionTime(0.0f)
+{
+	Initialize(i_Config);
+}
+
+OceanQuadtree::~OceanQuadtree ( void )
+{
+	Destroy();
+}
+
+void OceanQuadtree::Destroy ( void )
+{
+	LOG("OceanQuadtree successfully destroyed!");
+}
+
+void OceanQuadtree::Initialize ( const GlobalConfig& i_Config )
+{
+	Initialize(i_Config.Scene.Ocean.Grid.Quadtree.TileResolution, i_Config.Scene.Ocean.Grid.Quadtree.LODCount, i_Config.Scene.Ocean.Grid.Quadtree.CellSize,
+			   i_Config.Scene.Ocean.Grid.Quadtree.MaxScreenSpaceError, i_Config.Scene.Ocean.Grid.Quadtree.MorphRegion);
+}
+
+void OceanQuadtree::Initialize ( unsigned short i_TileResolution, unsigned short i_LODCount, float i_CellSize, float i_MaxScreenSpaceError, float i_MorphRegion )
+{
+	// the morphing needs an even number of quads per tile side
+	if (i_TileResolution < 2 || i_TileResolution % 2 != 0)
+	{
+		ERR("Invalid quadtree tile resolution! It must be an even number!");
+		return;
+	}
+
+	if (i_LODCount < 1 || i_LODCount > m_kMaxLODCount)
+	{
+		ERR("Invalid quadtree LOD count! It must be between 1 and %u!", m_kMaxLODCount);
+		return;
+	}
+
+	if (i_CellSize <= 0.0f || i_MaxScreenSpaceError <= 0.0f)
+	{
+		ERR("Invalid quadtree cell size or screen space error!");
+		return;
+	}
+
+	m_TileResolution = i_TileResolution;
+	m_LODCount = i_LODCount;
+	m_CellSize = i_CellSize;
+	m_MaxScreenSpaceError = i_MaxScreenSpaceError;
+	// a bigger morph region would reach the previous LOD range
+	m_MorphRegion = glm::clamp(i_MorphRegion, 0.01f, 0.5f);
+
+	m_LODRanges.resize(m_LODCount);
+	m_LODData.resize(m_LODCount);
+
+	LOG("OceanQuadtree - %u LODs, %u x %u quads per tile!", m_LODCount, m_TileResolution, m_TileResolution);
+
+	LOG("OceanQuadtree successfully created!");
+}
+
+void OceanQuadtree::CreateTileMesh ( std::vector<MeshBufferManager::VertexData>& o_VertexData, std::vector<unsigned int>& o_Indices ) const
+{
+	OceanClipmap::CreateTileMesh(m_TileResolution, o_VertexData, o_Indices);
+}
+
+void OceanQuadtree::Update ( const glm::vec3& i_CameraPosition, const glm::mat4& i_ProjectionMatrix, const glm::mat4& i_ProjectionViewMatrix, unsigned short i_ViewportHeight,
+							 const glm::vec4& i_UpperPlane, const glm::vec4& i_LowerPlane )
+{
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	m_VisibleTileData.clear();
+	m_CulledTileCount = 0;
+
+	if (m_LODCount == 0)
+	{
+		return;
+	}
+
+	//// LOD ranges
+	// a cell of size c, at distance d, covers c * ProjectionMatrix[1][1] * ViewportHeight / (2 * d) pixels
+	float errorFactor = i_ProjectionMatrix[1][1] * i_ViewportHeight / (2.0f * m_MaxScreenSpaceError);
+
+	for (unsigned short l = 0; l < m_LODCount; ++l)
+	{
+		m_LODRanges[l] = m_CellSize * static_cast<float>(1 << l) * errorFactor;
+
+		// the last LOD has nothing to morph to
+		m_LODData[l] = (l < m_LODCount - 1 ? glm::vec4(m_LODRanges[l] * (1.0f - m_MorphRegion), m_LODRanges[l], 0.0f, 0.0f) : glm::vec4(1e30f, 2e30f, 0.0f, 0.0f));
+	}
+
+	//// Bounds
+	SelectionData data;
+	data.CameraPosition = i_CameraPosition;
+	HelperFunctions::ExtractFrustumPlanes(i_ProjectionViewMatrix, data.FrustumPlanes);
+
+	// the plane distance is measured along the plane normal (0, 1, 0)
+	data.LowerHeight = glm::min(- i_LowerPlane.w, - i_UpperPlane.w);
+	data.UpperHeight = glm::max(- i_LowerPlane.w, - i_UpperPlane.w);
+	data.WaveExtent = 0.5f * (data.UpperHeight - data.LowerHeight);
+
+	// the waves crests are visible up to the sum of the camera and the crests horizon distances
+	float cameraHeight = i_CameraPosition.y - data.LowerHeight;
+	float wavesHeight = data.UpperHeight - data.LowerHeight;
+	if (cameraHeight > 0.0f)
+	{
+		data.HorizonDistance = glm::sqrt(2.0f * PhysicsConstants::kEarthRadius * cameraHeight + cameraHeight * cameraHeight) +
+							   glm::sqrt(2.0f * PhysicsConstants::kEarthRadius * wavesHeight + wavesHeight * wavesHeight);
+	}
+	else
+	{
+		data.HorizonDistance = 0.0f;
+	}
+
+	//// Selection
+	float rootSize = m_TileResolution * m_CellSize * static_cast<float>(1 << (m_LODCount - 1));
+	glm::vec2 rootCentre = glm::floor(glm::vec2(i_CameraPosition.x, i_CameraPosition.z) / rootSize + 0.5f) * rootSize;
+
+	for (short i = -2; i < 2; ++i)
+	{
+		for (short j = -2; j < 2; ++j)
+		{
+			SelectNode(data, m_LODCount - 1, rootCentre + glm::vec2(j, i) * rootSize);
+		}
+	}
+
+	m_LastSelectionTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void OceanQuadtree::SelectNode ( const SelectionData& i_Data, unsigned short i_LOD, const glm::vec2& i_Origin )
+{
+	float cellSize = m_CellSize * static_cast<float>(1 << i_LOD);
+	float nodeSize = m_TileResolution * cellSize;
+
+	glm::vec3 boxMin(i_Origin.x - i_Data.WaveExtent, i_Data.LowerHeight, i_Origin.y - i_Data.WaveExtent);
+	glm::vec3 boxMax(i_Origin.x + nodeSize + i_Data.WaveExtent, i_Data.UpperHeight, i_Origin.y + nodeSize + i_Data.WaveExtent);
+
+	// the closest box point to the camera
+	glm::vec3 closestPoint = glm::clamp(i_Data.CameraPosition, boxMin, boxMax);
+
+	if (i_Data.HorizonDistance > 0.0f && glm::length(glm::vec2(closestPoint.x - i_Data.CameraPosition.x, closestPoint.z - i_Data.CameraPosition.z)) > i_Data.HorizonDistance)
+	{
+		++ m_CulledTileCount;
+		return;
+	}
+
+	if (!HelperFunctions::IsBoxInsideFrustum(i_Data.FrustumPlanes, boxMin, boxMax))
+	{
+		++ m_CulledTileCount;
+		return;
+	}
+
+	float distance = glm::length(closestPoint - i_Data.CameraPosition);
+
+	// the whole node is far enough for this LOD
+	if (i_LOD == 0 || distance >= m_LODRanges[i_LOD - 1])
+	{
+		m_VisibleTileData.push_back(glm::vec4(i_Origin, cellSize, static_cast<float>(i_LOD)));
+		return;
+	}
+
+	float childSize = 0.5f * nodeSize;
+	for (unsigned short i = 0; i < 2; ++i)
+	{
+		for (unsigned short j = 0; j < 2; ++j)
+		{
+			SelectNode(i_Data, i_LOD - 1, i_Origin + glm::vec2(j, i) * childSize);
+		}
+	}
+}
+
+const std::vector<glm::vec4>& OceanQuadtree::GetLODData ( void ) const
+{
+	return m_LODData;
+}
+
+const std::vector<glm::vec4>& OceanQuadtree::GetVisibleTileData ( void ) const
+{
+	return m_VisibleTileData;
+}
+
+unsigned short OceanQuadtree::GetLODCount ( void ) const
+{
+	return m_LODCount;
+}
+
+unsigned int OceanQuadtree::GetVisibleTileCount ( void ) const
+{
+	return static_cast<unsigned int>(m_VisibleTileData.size());
+}
+
+unsigned int OceanQuadtree::GetCulledTileCount ( void ) const
+{
+	return m_CulledTileCount;
+}
+
+float OceanQuadtree::GetLastSelectionTime ( void ) const
+{
+	return m_LastSelectionTime;
+}
\ No newline at end of file
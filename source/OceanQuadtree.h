@@ -0,0 +1,103 @@
+/* Author: BAIRAC MIHAI
+
+ Implementation based on the CDLOD work
+ CDLOD paper: https://github.com/fstrugar/CDLOD
+
+*/
+
+#ifndef OCEAN_QUADTREE_H
+#define OCEAN_QUADTREE_H
+
+#include "MeshBufferManager.h"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "glm/mat4x4.hpp"
+#include <vector>
+
+class GlobalConfig;
+
+/*
+ Quadtree of world space ocean tiles
+
+ The quadtree covers 4 x 4 root tiles around the camera. A node is split while its vertices would be
+ more than MaxScreenSpaceError pixels apart on the screen, so every LOD has a distance range (twice the previous one).
+ The vertices close to the end of the LOD range are morphed to the next LOD vertices, so there are no cracks.
+ This holds while the tiles are small compared to the LOD ranges: LODRange * (0.5 - MorphRegion) > 1.41 * TileResolution * CellSize
+ (the LOD range being CellSize * ProjectionMatrix[1][1] * ViewportHeight / (2 * MaxScreenSpaceError))
+
+ The nodes are culled against the camera frustum and the Earth horizon, the node bounds being the wave amplitude planes
+ (check Projector::GetUpperPlane() and Projector::GetLowerPlane()).
+
+ All the tiles share the same mesh (the same as the clipmap one), the visible tiles are drawn with instanced calls,
+ m_kMaxBatchTileCount tiles at a time (check OceanSurfaceQuadtree.vert.glsl)
+*/
+
+class OceanQuadtree
+{
+public:
+	// the LODs and the tiles are sent to the vertex shader as uniform arrays (the instance data)
+	static const unsigned short m_kMaxLODCount = 16;
+	static const unsigned short m_kMaxBatchTileCount = 128;
+
+	OceanQuadtree(void);
+	OceanQuadtree(const GlobalConfig& i_Config);
+	~OceanQuadtree(void);
+
+	void Initialize(const GlobalConfig& i_Config);
+	void Initialize(unsigned short i_TileResolution, unsigned short i_LODCount, float i_CellSize, float i_MaxScreenSpaceError, float i_MorphRegion);
+
+	// check OceanClipmap::CreateTileMesh()
+	void CreateTileMesh(std::vector<MeshBufferManager::VertexData>& o_VertexData, std::vector<unsigned int>& o_Indices) const;
+
+	// i_ViewportHeight - in pixels, used by the screen space error
+	// i_UpperPlane, i_LowerPlane - the planes which bound the displaced waves (the plane normal must be (0, 1, 0))
+	void Update(const glm::vec3& i_CameraPosition, const glm::mat4& i_ProjectionMatrix, const glm::mat4& i_ProjectionViewMatrix, unsigned short i_ViewportHeight,
+				const glm::vec4& i_UpperPlane, const glm::vec4& i_LowerPlane);
+
+	// per LOD: x - morph start distance, y - morph end distance
+	const std::vector<glm::vec4>& GetLODData(void) const;
+	// per visible tile: xy - tile origin, z - cell size, w - LOD
+	const std::vector<glm::vec4>& GetVisibleTileData(void) const;
+
+	unsigned short GetLODCount(void) const;
+	unsigned int GetVisibleTileCount(void) const;
+	unsigned int GetCulledTileCount(void) const;
+
+	// milliseconds, measured by the last Update() call
+	float GetLastSelectionTime(void) const;
+
+private:
+	struct SelectionData
+	{
+		glm::vec3 CameraPosition;
+		glm::vec4 FrustumPlanes[6];
+		float LowerHeight, UpperHeight;
+		// horizontal displacement of the waves
+		float WaveExtent;
+		// 0 - no horizon test
+		float HorizonDistance;
+	};
+
+	//// Methods ////
+	void Destroy(void);
+
+	void SelectNode(const SelectionData& i_Data, unsigned short i_LOD, const glm::vec2& i_Origin);
+
+	//// Variables ////
+	unsigned short m_TileResolution;
+	unsigned short m_LODCount;
+	float m_CellSize;
+	float m_MaxScreenSpaceError;
+	float m_MorphRegion;
+
+	// where each LOD ends
+	std::vector<float> m_LODRanges;
+
+	std::vector<glm::vec4> m_LODData;
+	std::vector<glm::vec4> m_VisibleTileData;
+	unsigned int m_CulledTileCount;
+
+	float m_LastSelectionTime;
+};
+
+#endif /* OCEAN_QUADTREE_H */
\ No newline at end of file
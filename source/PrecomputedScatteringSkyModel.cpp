@@ -6,22 +6,24 @@
 // glm::mat4 comes from the header
 #include "glm/vec3.hpp"
 #include "glm/mat3x3.hpp"
+#include "glm/trigonometric.hpp" //radians()
 #include "glm/gtc/matrix_transform.hpp" //translate(), rotate()
 #include "glm/gtc/type_ptr.hpp" //value_ptr()
 #include "glm/gtc/constants.hpp" //pi(). half_pi(), two_pi()
 #include "glm/gtx/rotate_vector.hpp" //just for reference
 #include "PhysicsConstants.h"
 #include "GlobalConfig.h"
+#include "PrecomputedScatteringTables.h"
 
 
 PrecomputedScatteringSkyModel::PrecomputedScatteringSkyModel ( void )
-	: m_AreCloudsEnabled(false)
+	: m_AreCloudsEnabled(false), m_CloudsNoiseTexId(0), m_IsCloudsUpsamplingEnabled(false)
 {
 	LOG("PrecomputedScatteringSkyModel successfully created!");
 }
 
 PrecomputedScatteringSkyModel::PrecomputedScatteringSkyModel ( const GlobalConfig& i_Config )
-	: m_AreCloudsEnabled(false)
+	: m_AreCloudsEnabled(false), m_CloudsNoiseTexId(0), m_IsCloudsUpsamplingEnabled(false)
 {
 	Initialize(i_Config);
 }
@@ -61,8 +63,8 @@ void PrecomputedScatteringSkyModel::Initialize ( const GlobalConfig& i_Config )
 	SetupCloudsShaders(i_Config, cloudsAttributes);
 	SetupCloudsGeometry(i_Config, cloudsAttributes);
 
-
 	SetupTextures(i_Config);
+	SetupCloudsNoise(i_Config);
 
 	LOG("PrecomputedScatteringSkyModel successfully created!");
 }
@@ -115,6 +117,8 @@ void PrecomputedScatteringSkyModel::SetupSkyShaders ( const GlobalConfig& i_Conf
 	m_Uniforms["u_IsUnderWater"] = m_SM.GetUniformLocation("u_IsUnderWater");
 	m_SM.SetUniform(m_Uniforms.find("u_IsUnderWater")->second, false);
 
+	m_Handles.Initialize(m_SM, m_kUniformHandleNames);
+
 	m_SM.UnUseProgram();
 }
 
@@ -161,12 +165,10 @@ void PrecomputedScatteringSkyModel::SetupCloudsShaders ( const GlobalConfig& i_C
 	m_CloudsUniforms["u_CloudsData.NoiseMap"] = m_CloudsSM.GetUniformLocation("u_CloudsData.NoiseMap");
 	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.NoiseMap")->second, i_Config.TexUnit.Sky.PrecomputedScatteringSkyModel.NoiseMap);
 
-	m_CloudsUniforms["u_CloudsData.Octaves"] = m_CloudsSM.GetUniformLocation("u_CloudsData.Octaves");
-	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Octaves")->second, m_CloudsData.Octaves);
-	m_CloudsUniforms["u_CloudsData.Lacunarity"] = m_CloudsSM.GetUniformLocation("u_CloudsData.Lacunarity");
-	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Lacunarity")->second, m_CloudsData.Lacunarity);
-	m_CloudsUniforms["u_CloudsData.Gain"] = m_CloudsSM.GetUniformLocation("u_CloudsData.Gain");
-	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Gain")->second, m_CloudsData.Gain);
+	// set by UpdateCloudsNoise()
+	m_CloudsUniforms["u_CloudsData.GroupCount"] = m_CloudsSM.GetUniformLocation("u_CloudsData.GroupCount");
+	m_CloudsUniforms["u_CloudsData.GroupMatrix"] = m_CloudsSM.GetUniformLocation("u_CloudsData.GroupMatrix");
+	m_CloudsUniforms["u_CloudsData.GroupGain"] = m_CloudsSM.GetUniformLocation("u_CloudsData.GroupGain");
 	m_CloudsUniforms["u_CloudsData.Norm"] = m_CloudsSM.GetUniformLocation("u_CloudsData.Norm");
 	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Norm")->second, m_CloudsData.Norm);
 	m_CloudsUniforms["u_CloudsData.Clamp1"] = m_CloudsSM.GetUniformLocation("u_CloudsData.Clamp1");
@@ -178,6 +180,8 @@ void PrecomputedScatteringSkyModel::SetupCloudsShaders ( const GlobalConfig& i_C
 	m_CloudsUniforms["u_CloudsData.Height"] = m_CloudsSM.GetUniformLocation("u_CloudsData.Height");
 	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Height")->second, i_Config.Scene.Sky.Model.PrecomputedScattering.Clouds.AltitudeOffset);
 
+	m_CloudsHandles.Initialize(m_CloudsSM, m_kUniformHandleNames);
+
 	m_CloudsSM.UnUseProgram();
 }
 
@@ -212,17 +216,60 @@ void PrecomputedScatteringSkyModel::SetupCloudsGeometry ( const GlobalConfig& i_
 
 	m_CloudsMBM.Initialize("PrecomputedScatteringSkyModel Clouds");
 	m_CloudsMBM.CreateModelContext(cloudVertexData, i_Attributes, MeshBufferManager::ACCESS_TYPE::AT_STATIC);
+
+	// the upsampler draws the clouds plane again, at full resolution
+	m_IsCloudsUpsamplingEnabled = i_Config.Scene.Sky.Model.PrecomputedScattering.Clouds.Upsampling.Enabled;
+	if (m_IsCloudsUpsamplingEnabled)
+	{
+		m_CloudsUpsampler.Initialize("PrecomputedScatteringSkyModel", i_Config, "resources/shaders/PrecomputedScatteringSkyModelClouds.vert.glsl", cloudVertexData, i_Config.Scene.Sky.Model.PrecomputedScattering.Clouds.Upsampling.ResolutionScale, i_Config.TexUnit.Sky.PrecomputedScatteringSkyModel.CloudsLowResMap, i_Config.TexUnit.Sky.PrecomputedScatteringSkyModel.CloudsLowResDepthMap);
+	}
 }
 
 void PrecomputedScatteringSkyModel::SetupTextures ( const GlobalConfig& i_Config )
 {
 	m_TM.Initialize("PrecomputedScatteringSkyModel", i_Config);
 
-	m_TM.Load2DRawTexture("resources/textures/irradiance.raw", GL_RGB16F, GL_RGB, GL_FLOAT, 64, 16, GL_CLAMP_TO_EDGE, GL_LINEAR, i_Config.TexUnit.Sky.PrecomputedScatteringSkyModel.IrradianceMap);
-	m_TM.Load3DRawTexture("resources/textures/inscatter.raw", GL_RGBA16F, GL_RGBA, GL_FLOAT, 256, 128, 32, GL_CLAMP_TO_EDGE, GL_LINEAR, i_Config.TexUnit.Sky.PrecomputedScatteringSkyModel.InscatterMap);
-	m_TM.Load2DRawTexture("resources/textures/transmittance.raw", GL_RGB16F, GL_RGB, GL_FLOAT, 256, 64, GL_CLAMP_TO_EDGE, GL_LINEAR, i_Config.TexUnit.Sky.PrecomputedScatteringSkyModel.TransmittanceMap);
+	// loaded from the cache or computed for the current atmosphere parameters, the tables are released after the upload
+	PrecomputedScatteringTables tables;
+	if (! tables.Initialize(i_Config))
+	{
+		return;
+	}
+
+	m_TM.Create2DTexture(GL_RGB16F, GL_RGBA, GL_FLOAT, PrecomputedScatteringTables::m_kIrradianceWidth, PrecomputedScatteringTables::m_kIrradianceHeight, GL_CLAMP_TO_EDGE, GL_LINEAR, const_cast<glm::vec4*>(tables.GetIrradianceData()), i_Config.TexUnit.Sky.PrecomputedScatteringSkyModel.IrradianceMap, -1, false);
+	m_TM.Create3DTexture(GL_RGBA16F, GL_RGBA, GL_FLOAT, PrecomputedScatteringTables::m_kInscatterWidth, PrecomputedScatteringTables::m_kInscatterHeight, PrecomputedScatteringTables::m_kInscatterDepth, GL_CLAMP_TO_EDGE, GL_LINEAR, const_cast<glm::vec4*>(tables.GetInscatterData()), i_Config.TexUnit.Sky.PrecomputedScatteringSkyModel.InscatterMap, -1, false);
+	m_TM.Create2DTexture(GL_RGB16F, GL_RGBA, GL_FLOAT, PrecomputedScatteringTables::m_kTransmittanceWidth, PrecomputedScatteringTables::m_kTransmittanceHeight, GL_CLAMP_TO_EDGE, GL_LINEAR, const_cast<glm::vec4*>(tables.GetTransmittanceData()), i_Config.TexUnit.Sky.PrecomputedScatteringSkyModel.TransmittanceMap, -1, false);
+}
+
+void PrecomputedScatteringSkyModel::SetupCloudsNoise ( const GlobalConfig& i_Config )
+{
+	// noise.pgm is the base noise, the octaves are rotated by 23 degrees
+	if (! m_CloudsNoiseGenerator.Initialize("PrecomputedScatteringSkyModel Clouds", "resources/textures/noise.pgm", i_Config.Scene.Sky.Model.PrecomputedScattering.Clouds.NoiseBake.Size, i_Config.Scene.Sky.Model.PrecomputedScattering.Clouds.NoiseBake.OctavesPerGroup, glm::radians(23.0f), i_Config.Scene.Sky.Model.PrecomputedScattering.Clouds.NoiseBake.ThreadCount))
+	{
+		return;
+	}
+
+	unsigned short size = m_CloudsNoiseGenerator.GetSize();
+
+	m_CloudsNoiseTexId = m_TM.Create2DArrayTexture(CloudsNoiseGenerator::m_kLayerCount, GL_R16F, GL_RED, GL_FLOAT, size, size, GL_REPEAT, GL_LINEAR, nullptr, i_Config.TexUnit.Sky.PrecomputedScatteringSkyModel.NoiseMap, 0, true);
+
+	UpdateCloudsNoise();
+}
+
+void PrecomputedScatteringSkyModel::UpdateCloudsNoise ( void )
+{
+	if (m_CloudsNoiseTexId == 0)
+	{
+		return;
+	}
+
+	m_CloudsNoiseGenerator.Generate(m_CloudsData.Octaves, m_CloudsData.Lacunarity, m_CloudsData.Gain);
+	m_TM.Update2DArrayTextureData(m_CloudsNoiseTexId, const_cast<float*>(m_CloudsNoiseGenerator.GetData()));
 
-	m_TM.Load2DRawTexture("resources/textures/noise.pgm", GL_RED, GL_RED, GL_UNSIGNED_BYTE, 512, 512, GL_REPEAT, GL_LINEAR, i_Config.TexUnit.Sky.PrecomputedScatteringSkyModel.NoiseMap, 0, true, 38);
+	m_CloudsSM.UseProgram();
+	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.GroupCount")->second, m_CloudsNoiseGenerator.GetGroupCount());
+	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.GroupMatrix")->second, 1, glm::value_ptr(m_CloudsNoiseGenerator.GetGroupMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_2);
+	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.GroupGain")->second, m_CloudsNoiseGenerator.GetGroupGain());
 }
 
 void PrecomputedScatteringSkyModel::Update ( const Camera& i_Camera, bool i_IsUnderWater, bool i_IsWireframeMode, float i_CrrTime )
@@ -265,14 +312,14 @@ void PrecomputedScatteringSkyModel::UpdateInternal ( float i_RotateAngle, bool i
 	/////// Update Sky Shader //////////
 	m_SM.UseProgram();
 
-	m_SM.SetUniform(m_Uniforms.find("u_ClipToCameraMatrix")->second, 1, glm::value_ptr(i_Camera.GetInverseProjectionMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-	m_SM.SetUniform(m_Uniforms.find("u_CameraToWorldMatrix")->second, 1, glm::value_ptr(glm::inverse(correctedViewMatrix)), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_CLIP_TO_CAMERA_MATRIX], 1, glm::value_ptr(i_Camera.GetInverseProjectionMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_CAMERA_TO_WORLD_MATRIX], 1, glm::value_ptr(glm::inverse(correctedViewMatrix)), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 
-	m_SM.SetUniform(m_Uniforms.find("u_CameraPosition")->second, 1, glm::value_ptr(glm::vec3(0.0f, i_Camera.GetAltitude(), 0.0f)), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_CAMERA_POSITION], 1, glm::value_ptr(glm::vec3(0.0f, i_Camera.GetAltitude(), 0.0f)), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
 
-	m_SM.SetUniform(m_Uniforms.find("u_IsReflMode")->second, i_IsReflMode);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_REFL_MODE], i_IsReflMode);
 
-	m_SM.SetUniform(m_Uniforms.find("u_IsUnderWater")->second, i_IsUnderWater);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_UNDER_WATER], i_IsUnderWater);
 
 	////// Update Clouds Shader /////////
 	glm::mat4 T(1.0f);
@@ -291,9 +338,17 @@ void PrecomputedScatteringSkyModel::UpdateInternal ( float i_RotateAngle, bool i
 
 	if (m_AreCloudsEnabled)
 	{
+		glm::mat4 cloudsWorldToClipMatrix = i_Camera.GetProjectionMatrix() * crrViewMatrix;
+
 		m_CloudsSM.UseProgram();
-		m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_WorldToClipMatrix")->second, 1, glm::value_ptr(i_Camera.GetProjectionMatrix() * crrViewMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-		m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CameraPosition")->second, 1, glm::value_ptr(i_Camera.GetPosition()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+		m_CloudsSM.SetUniform(m_CloudsHandles[UNIFORM_HANDLE::UH_WORLD_TO_CLIP_MATRIX], 1, glm::value_ptr(cloudsWorldToClipMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+		m_CloudsSM.SetUniform(m_CloudsHandles[UNIFORM_HANDLE::UH_CAMERA_POSITION], 1, glm::value_ptr(i_Camera.GetPosition()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+
+		// only the main view is upsampled, it is updated last
+		if (m_IsCloudsUpsamplingEnabled)
+		{
+			m_CloudsUpsampler.SetViewData(cloudsWorldToClipMatrix, glm::mat4(1.0f));
+		}
 	}
 
 	// correction needed only for reflection - sky map
@@ -303,17 +358,17 @@ void PrecomputedScatteringSkyModel::UpdateInternal ( float i_RotateAngle, bool i
 
 		glm::vec3 correctedSunDir = m_SunData.Direction;
 		correctedSunDir.y *= -1.0f;
-		m_SM.SetUniform(m_Uniforms.find("u_SunDirection")->second, 1, glm::value_ptr(correctedSunDir), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+		m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_SUN_DIRECTION], 1, glm::value_ptr(correctedSunDir), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
 	}
 	else
 	{
 		m_SM.UseProgram();
-		m_SM.SetUniform(m_Uniforms.find("u_SunDirection")->second, 1, glm::value_ptr(m_SunData.Direction), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+		m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_SUN_DIRECTION], 1, glm::value_ptr(m_SunData.Direction), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
 
 		if (m_AreCloudsEnabled)
 		{
 			m_CloudsSM.UseProgram();
-			m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_SunDirection")->second, 1, glm::value_ptr(m_SunData.Direction), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+			m_CloudsSM.SetUniform(m_CloudsHandles[UNIFORM_HANDLE::UH_SUN_DIRECTION], 1, glm::value_ptr(m_SunData.Direction), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
 		}
 	}
 }
@@ -329,7 +384,7 @@ void PrecomputedScatteringSkyModel::UpdateSunPosition ( float i_CrrTime )
 
 void PrecomputedScatteringSkyModel::Render ( void )
 {
-	RenderInternal();
+	RenderInternal(false, true);
 }
 
 void PrecomputedScatteringSkyModel::RenderReflected ( void )
@@ -344,7 +399,7 @@ void PrecomputedScatteringSkyModel::RenderRefracted ( void )
 	RenderInternal();
 }
 
-void PrecomputedScatteringSkyModel::RenderInternal ( bool i_RevertWinding )
+void PrecomputedScatteringSkyModel::RenderInternal ( bool i_RevertWinding, bool i_IsMainView )
 {
 	/////// RENDER SKY ////////
 	m_SM.UseProgram();
@@ -356,23 +411,42 @@ void PrecomputedScatteringSkyModel::RenderInternal ( bool i_RevertWinding )
 	////////// RENDER CLOUDS /////////
 	if (m_AreCloudsEnabled)
 	{
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glEnable(GL_BLEND);
+		if (i_IsMainView && m_IsCloudsUpsamplingEnabled && ! m_IsWireframeMode)
+		{
+			m_CloudsUpsampler.BeginLowResPass();
+			RenderClouds();
+			m_CloudsUpsampler.EndLowResPass();
 
-		m_CloudsSM.UseProgram();
+			m_CloudsUpsampler.Render();
+		}
+		else
+		{
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			glEnable(GL_BLEND);
 
-		if (i_RevertWinding) glFrontFace(GL_CW);
+			if (i_RevertWinding) glFrontFace(GL_CW);
 
-		m_CloudsMBM.BindModelContext();
-		glDrawArrays(m_IsWireframeMode ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, 0, 4);
-		m_CloudsMBM.UnBindModelContext();
+			RenderClouds();
 
-		if (i_RevertWinding) glFrontFace(GL_CCW);
+			if (i_RevertWinding) glFrontFace(GL_CCW);
 
-		glDisable(GL_BLEND);
+			glDisable(GL_BLEND);
+		}
 	}
 }
 
+void PrecomputedScatteringSkyModel::RenderClouds ( void )
+{
+	m_CloudsSM.UseProgram();
+
+	// the mipmaps are generated again only after the noise was baked again
+	m_TM.BindTexture(m_CloudsNoiseTexId, true);
+
+	m_CloudsMBM.BindModelContext();
+	glDrawArrays(m_IsWireframeMode ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, 0, 4);
+	m_CloudsMBM.UnBindModelContext();
+}
+
 void PrecomputedScatteringSkyModel::SetSunDirection ( float i_Phi, float i_Theta )
 {
 	BaseSkyModel::SetSunDirection(i_Phi, i_Theta);
@@ -394,8 +468,7 @@ void PrecomputedScatteringSkyModel::SetCloudsOctaves ( unsigned short i_Octaves
 	{
 		m_CloudsData.Octaves = i_Octaves;
 
-		m_CloudsSM.UseProgram();
-		m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Octaves")->second, m_CloudsData.Octaves);
+		UpdateCloudsNoise();
 	}
 }
 
@@ -410,8 +483,7 @@ void PrecomputedScatteringSkyModel::SetCloudsLacunarity ( float i_Lacunarity )
 	{
 		m_CloudsData.Lacunarity = i_Lacunarity;
 
-		m_CloudsSM.UseProgram();
-		m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Lacunarity")->second, m_CloudsData.Lacunarity);
+		UpdateCloudsNoise();
 	}
 }
 
@@ -426,8 +498,7 @@ void PrecomputedScatteringSkyModel::SetCloudsGain ( float i_Gain )
 	{
 		m_CloudsData.Gain = i_Gain;
 
-		m_CloudsSM.UseProgram();
-		m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Gain")->second, m_CloudsData.Gain);
+		UpdateCloudsNoise();
 	}
 }
 
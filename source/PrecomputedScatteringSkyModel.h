@@ -14,6 +14,8 @@
 #include "glm/mat4x4.hpp"
 #include "Camera.h"
 #include "TextureManager.h"
+#include "CloudsNoiseGenerator.h"
+#include "CloudsUpsampler.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -73,9 +75,16 @@ private:
 	void SetupCloudsGeometry(const GlobalConfig& i_Config, const std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& i_Attributes);
 
 	void SetupTextures(const GlobalConfig& i_Config);
+	void SetupCloudsNoise(const GlobalConfig& i_Config);
+
+	// bakes the octaves again, after the clouds parameters changed
+	void UpdateCloudsNoise(void);
 
 	void UpdateInternal(float i_RotateAngle, bool i_ApplyCloudsCorrection, bool i_ApplySunDirCorrection, const Camera& i_Camera, bool i_IsReflMode, bool i_IsUnderWater, bool i_IsWireframeMode, float i_CrrTime);
-	void RenderInternal(bool i_RevertWinding = false);
+	// i_IsMainView - the clouds are rendered at reduced resolution, if enabled
+	void RenderInternal(bool i_RevertWinding = false, bool i_IsMainView = false);
+	// no blending setup
+	void RenderClouds(void);
 
 	void Destroy(void);
 
@@ -88,6 +97,7 @@ private:
 	TextureManager m_TM;
 
 	std::map<std::string, int> m_CloudsUniforms;
+	UniformHandles m_CloudsHandles;
 
 	struct CloudsData
 	{
@@ -98,6 +108,13 @@ private:
 	} m_CloudsData;
 
 	bool m_AreCloudsEnabled;
+
+	// the fBm is baked on the CPU when the clouds parameters change
+	CloudsNoiseGenerator m_CloudsNoiseGenerator;
+	unsigned int m_CloudsNoiseTexId;
+
+	CloudsUpsampler m_CloudsUpsampler;
+	bool m_IsCloudsUpsamplingEnabled;
 };
 
 #endif /* PRECOMPUTED_SCATTERING_SKY_MODEL_H */
\ No newline at end of file
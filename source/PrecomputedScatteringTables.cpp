@@ -0,0 +1,922 @@
+/* Author: BAIRAC MIHAI */
+
+#include "PrecomputedScatteringTables.h"
+#include "CommonHeaders.h"
+// glm::vec3, glm::vec4 come from the header
+#include "glm/common.hpp" //min(), max(), clamp(), floor(), mod()
+#include "glm/exponential.hpp" //exp(), sqrt()
+#include "glm/trigonometric.hpp" //sin(), cos(), tan(), atan()
+#include "glm/geometric.hpp" //dot()
+#include "glm/gtc/constants.hpp" //pi()
+#include "GlobalConfig.h"
+#include "FileUtils.h"
+#include "MemoryMappedFile.h"
+#include "SDL/SDL_rwops.h"
+#include <thread> // std::thread
+#include <chrono> // std::chrono::steady_clock
+#include <cstring> // std::memcpy(), std::memset(), std::memcmp()
+#include <cmath> // std::sqrt()
+#ifdef USE_SSE
+#include <xmmintrin.h> // _mm_add_ps(), _mm_sub_ps(), _mm_mul_ps()
+#endif // USE_SSE
+
+
+namespace
+{
+	// same as the original precomputation
+	const unsigned short kScatteringOrderCount = 4;
+
+	const unsigned short kTransmittanceIntegralSamples = 500;
+	const unsigned short kInscatterIntegralSamples = 50;
+	const unsigned short kIrradianceIntegralSamples = 32;
+	// NOTE! The original uses 16, but the spherical integral is the most expensive one on the CPU
+	// and the multiple scattering is smooth enough for 8
+	const unsigned short kInscatterSphericalIntegralSamples = 8;
+
+	// Mie scattering to extinction ratio
+	const float kMieScatteringAlbedo = 0.9f;
+
+	// i_A + (i_B - i_A) * i_T on the 4 channels
+	inline glm::vec4 Mix4 ( const glm::vec4& i_A, const glm::vec4& i_B, float i_T )
+	{
+#ifdef USE_SSE
+		// glm::vec4 is 4 tightly packed floats
+		__m128 a = _mm_loadu_ps(&i_A.x);
+
+		glm::vec4 result;
+		_mm_storeu_ps(&result.x, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&i_B.x), a), _mm_set1_ps(i_T))));
+
+		return result;
+#else
+		return i_A + (i_B - i_A) * i_T;
+#endif // USE_SSE
+	}
+
+	// io_Sum += i_A * i_B on the 4 channels
+	inline void MulAdd4 ( glm::vec4& io_Sum, const glm::vec4& i_A, const glm::vec4& i_B )
+	{
+#ifdef USE_SSE
+		_mm_storeu_ps(&io_Sum.x, _mm_add_ps(_mm_loadu_ps(&io_Sum.x), _mm_mul_ps(_mm_loadu_ps(&i_A.x), _mm_loadu_ps(&i_B.x))));
+#else
+		io_Sum += i_A * i_B;
+#endif // USE_SSE
+	}
+
+	// io_Sum += (i_A + i_B) * i_Scale on the 4 channels, a trapezoid of an integral
+	inline void AddTrapezoid4 ( glm::vec4& io_Sum, const glm::vec4& i_A, const glm::vec4& i_B, float i_Scale )
+	{
+#ifdef USE_SSE
+		_mm_storeu_ps(&io_Sum.x, _mm_add_ps(_mm_loadu_ps(&io_Sum.x), _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&i_A.x), _mm_loadu_ps(&i_B.x)), _mm_set1_ps(i_Scale))));
+#else
+		io_Sum += (i_A + i_B) * i_Scale;
+#endif // USE_SSE
+	}
+
+	// linear filtering and clamp to edge, like the GL sampler, (i_U, i_V) are texture coordinates
+	glm::vec4 Sample2D ( const std::vector<glm::vec4>& i_Table, unsigned short i_Width, unsigned short i_Height, float i_U, float i_V )
+	{
+		float x = glm::clamp(i_U * i_Width - 0.5f, 0.0f, i_Width - 1.0f);
+		float y = glm::clamp(i_V * i_Height - 0.5f, 0.0f, i_Height - 1.0f);
+
+		unsigned int x0 = static_cast<unsigned int>(x), y0 = static_cast<unsigned int>(y);
+		unsigned int x1 = glm::min(x0 + 1, i_Width - 1u), y1 = glm::min(y0 + 1, i_Height - 1u);
+
+		float fx = x - x0, fy = y - y0;
+
+		const glm::vec4* pRow0 = &i_Table[y0 * i_Width];
+		const glm::vec4* pRow1 = &i_Table[y1 * i_Width];
+
+		return Mix4(Mix4(pRow0[x0], pRow0[x1], fx), Mix4(pRow1[x0], pRow1[x1], fx), fy);
+	}
+
+	glm::vec4 Sample3D ( const std::vector<glm::vec4>& i_Table, unsigned short i_Width, unsigned short i_Height, unsigned short i_Depth, float i_U, float i_V, float i_W )
+	{
+		float x = glm::clamp(i_U * i_Width - 0.5f, 0.0f, i_Width - 1.0f);
+		float y = glm::clamp(i_V * i_Height - 0.5f, 0.0f, i_Height - 1.0f);
+		float z = glm::clamp(i_W * i_Depth - 0.5f, 0.0f, i_Depth - 1.0f);
+
+		unsigned int x0 = static_cast<unsigned int>(x), y0 = static_cast<unsigned int>(y), z0 = static_cast<unsigned int>(z);
+		unsigned int x1 = glm::min(x0 + 1, i_Width - 1u), y1 = glm::min(y0 + 1, i_Height - 1u), z1 = glm::min(z0 + 1, i_Depth - 1u);
+
+		float fx = x - x0, fy = y - y0, fz = z - z0;
+
+		const glm::vec4* pRow00 = &i_Table[(z0 * i_Height + y0) * i_Width];
+		const glm::vec4* pRow01 = &i_Table[(z0 * i_Height + y1) * i_Width];
+		const glm::vec4* pRow10 = &i_Table[(z1 * i_Height + y0) * i_Width];
+		const glm::vec4* pRow11 = &i_Table[(z1 * i_Height + y1) * i_Width];
+
+		glm::vec4 layer0 = Mix4(Mix4(pRow00[x0], pRow00[x1], fx), Mix4(pRow01[x0], pRow01[x1], fx), fy);
+		glm::vec4 layer1 = Mix4(Mix4(pRow10[x0], pRow10[x1], fx), Mix4(pRow11[x0], pRow11[x1], fx), fy);
+
+		return Mix4(layer0, layer1, fz);
+	}
+}
+
+PrecomputedScatteringTables::PrecomputedScatteringTables ( void )
+	: m_ThreadCount(1), m_Rg(0.0f), m_Rt(0.0f), m_RL(0.0f), m_HR(0.0f), m_HM(0.0f),
+	  m_BetaMSca(0.0f), m_BetaMEx(0.0f), m_MieG(0.0f), m_GroundReflectance(0.0f)
+{
+	std::memset(&m_Header, 0, sizeof(CacheHeader));
+
+	LOG("PrecomputedScatteringTables successfully created!");
+}
+
+PrecomputedScatteringTables::PrecomputedScatteringTables ( const GlobalConfig& i_Config )
+	: m_ThreadCount(1), m_Rg(0.0f), m_Rt(0.0f), m_RL(0.0f), m_HR(0.0f), m_HM(0.0f),
+	  m_BetaMSca(0.0f), m_BetaMEx(0.0f), m_MieG(0.0f), m_GroundReflectance(0.0f)
+{
+	std::memset(&m_Header, 0, sizeof(CacheHeader));
+
+	Initialize(i_Config);
+}
+
+PrecomputedScatteringTables::~PrecomputedScatteringTables ( void )
+{
+	Destroy();
+}
+
+void PrecomputedScatteringTables::Destroy ( void )
+{
+	LOG("PrecomputedScatteringTables successfully destroyed!");
+}
+
+bool PrecomputedScatteringTables::Initialize ( const GlobalConfig& i_Config )
+{
+	m_Rg = i_Config.Scene.Sky.Model.PrecomputedScattering.Atmosphere.Rgtl.x;
+	m_Rt = i_Config.Scene.Sky.Model.PrecomputedScattering.Atmosphere.Rgtl.y;
+	m_RL = i_Config.Scene.Sky.Model.PrecomputedScattering.Atmosphere.Rgtl.z;
+	m_BetaR = i_Config.Scene.Sky.Model.PrecomputedScattering.Atmosphere.BetaR;
+	m_HR = i_Config.Scene.Sky.Model.PrecomputedScattering.Atmosphere.RayleighScaleHeight;
+	m_HM = i_Config.Scene.Sky.Model.PrecomputedScattering.Atmosphere.MieScaleHeight;
+	m_BetaMSca = i_Config.Scene.Sky.Model.PrecomputedScattering.Atmosphere.MieBeta;
+	m_BetaMEx = m_BetaMSca / kMieScatteringAlbedo;
+	m_MieG = i_Config.Scene.Sky.Model.PrecomputedScattering.Atmosphere.MieScattering;
+	m_GroundReflectance = i_Config.Scene.Sky.Model.PrecomputedScattering.Atmosphere.GroundReflectance;
+
+	if (m_Rg <= 0.0f || m_Rt <= m_Rg || m_RL < m_Rt || m_HR <= 0.0f || m_HM <= 0.0f)
+	{
+		ERR("Invalid precomputed scattering atmosphere parameters!");
+		return false;
+	}
+
+	m_CacheFileName = FileUtils::GetCachePath(i_Config.Scene.Sky.Model.PrecomputedScattering.Precompute.CacheFileName);
+
+	// 0 - one thread per hardware thread
+	unsigned short threadCount = i_Config.Scene.Sky.Model.PrecomputedScattering.Precompute.ThreadCount;
+	m_ThreadCount = (threadCount > 0 ? threadCount : static_cast<unsigned short>(std::thread::hardware_concurrency()));
+	if (m_ThreadCount == 0)
+	{
+		m_ThreadCount = 1;
+	}
+
+	//////// Cache header //////
+	static_assert(sizeof(CacheHeader) % 8 == 0, "The cache header size must be a multiple of 8 bytes!");
+
+	std::memset(&m_Header, 0, sizeof(CacheHeader));
+	std::memcpy(m_Header.magic, "OPSC", 4);
+	m_Header.version = m_kCacheVersion;
+	m_Header.scatteringOrderCount = kScatteringOrderCount;
+	m_Header.Rg = m_Rg;
+	m_Header.Rt = m_Rt;
+	m_Header.RL = m_RL;
+	m_Header.betaRX = m_BetaR.x;
+	m_Header.betaRY = m_BetaR.y;
+	m_Header.betaRZ = m_BetaR.z;
+	m_Header.HR = m_HR;
+	m_Header.HM = m_HM;
+	m_Header.betaMSca = m_BetaMSca;
+	m_Header.mieG = m_MieG;
+	m_Header.groundReflectance = m_GroundReflectance;
+
+	m_Transmittance.resize(m_kTransmittanceWidth * m_kTransmittanceHeight);
+	m_Irradiance.resize(m_kIrradianceWidth * m_kIrradianceHeight);
+	m_Inscatter.resize(m_kInscatterWidth * m_kInscatterHeight * m_kInscatterDepth);
+
+	if (!LoadCache())
+	{
+		Compute();
+		SaveCache();
+	}
+
+	LOG("PrecomputedScatteringTables successfully created!");
+
+	return true;
+}
+
+const glm::vec4* PrecomputedScatteringTables::GetTransmittanceData ( void ) const
+{
+	return (m_Transmittance.empty() ? nullptr : &m_Transmittance[0]);
+}
+
+const glm::vec4* PrecomputedScatteringTables::GetIrradianceData ( void ) const
+{
+	return (m_Irradiance.empty() ? nullptr : &m_Irradiance[0]);
+}
+
+const glm::vec4* PrecomputedScatteringTables::GetInscatterData ( void ) const
+{
+	return (m_Inscatter.empty() ? nullptr : &m_Inscatter[0]);
+}
+
+bool PrecomputedScatteringTables::LoadCache ( void )
+{
+	MemoryMappedFile cacheFile;
+	if (!cacheFile.Open(m_CacheFileName))
+	{
+		return false;
+	}
+
+	size_t transmittanceSize = m_Transmittance.size() * sizeof(glm::vec4);
+	size_t irradianceSize = m_Irradiance.size() * sizeof(glm::vec4);
+	size_t inscatterSize = m_Inscatter.size() * sizeof(glm::vec4);
+
+	if (cacheFile.GetSize() != sizeof(CacheHeader) + transmittanceSize + irradianceSize + inscatterSize || std::memcmp(cacheFile.GetData(), &m_Header, sizeof(CacheHeader)) != 0)
+	{
+		LOG("The precomputed scattering cache %s is out of date!", m_CacheFileName.c_str());
+
+		return false;
+	}
+
+	const unsigned char* pData = cacheFile.GetData() + sizeof(CacheHeader);
+
+	std::memcpy(&m_Transmittance[0], pData, transmittanceSize);
+	pData += transmittanceSize;
+	std::memcpy(&m_Irradiance[0], pData, irradianceSize);
+	pData += irradianceSize;
+	std::memcpy(&m_Inscatter[0], pData, inscatterSize);
+
+	LOG("The precomputed scattering cache %s successfully loaded!", m_CacheFileName.c_str());
+
+	return true;
+}
+
+bool PrecomputedScatteringTables::SaveCache ( void ) const
+{
+	SDL_RWops* pF = SDL_RWFromFile(m_CacheFileName.c_str(), "wb");
+	if (!pF)
+	{
+		ERR("Failed to create %s file!", m_CacheFileName.c_str());
+		return false;
+	}
+
+	bool isWriteOk = (SDL_RWwrite(pF, &m_Header, sizeof(CacheHeader), 1) == 1) &&
+					 (SDL_RWwrite(pF, &m_Transmittance[0], sizeof(glm::vec4), m_Transmittance.size()) == m_Transmittance.size()) &&
+					 (SDL_RWwrite(pF, &m_Irradiance[0], sizeof(glm::vec4), m_Irradiance.size()) == m_Irradiance.size()) &&
+					 (SDL_RWwrite(pF, &m_Inscatter[0], sizeof(glm::vec4), m_Inscatter.size()) == m_Inscatter.size());
+
+	SDL_RWclose(pF);
+
+	if (!isWriteOk)
+	{
+		ERR("Failed to write %s file!", m_CacheFileName.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+void PrecomputedScatteringTables::Compute ( void )
+{
+	LOG("Precomputing the atmosphere scattering tables with %u thread(s)!", m_ThreadCount);
+
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	m_DeltaE.resize(m_Irradiance.size());
+	m_DeltaSR.resize(m_Inscatter.size());
+	m_DeltaSM.resize(m_Inscatter.size());
+	m_DeltaJ.resize(m_Inscatter.size());
+
+	// the irradiance table keeps only the light scattered by the sky, the direct sun light is computed in the shaders
+	RunPass(PASS_TYPE::PT_TRANSMITTANCE, true);
+	RunPass(PASS_TYPE::PT_IRRADIANCE_1, true);
+	RunPass(PASS_TYPE::PT_INSCATTER_1, true);
+
+	for (unsigned short order = 2; order <= kScatteringOrderCount; ++order)
+	{
+		// the single scattering is stored without the phase functions
+		bool isFirstOrder = (order == 2);
+
+		RunPass(PASS_TYPE::PT_INSCATTER_S, isFirstOrder);
+		RunPass(PASS_TYPE::PT_IRRADIANCE_N, isFirstOrder);
+		RunPass(PASS_TYPE::PT_INSCATTER_N, isFirstOrder);
+
+		LOG("Scattering order %u of %u precomputed!", order, kScatteringOrderCount);
+	}
+
+	// the intermediate tables are big, so they are released right away
+	std::vector<glm::vec4>().swap(m_DeltaE);
+	std::vector<glm::vec4>().swap(m_DeltaSR);
+	std::vector<glm::vec4>().swap(m_DeltaSM);
+	std::vector<glm::vec4>().swap(m_DeltaJ);
+
+	float computeTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+
+	LOG("The atmosphere scattering tables precomputed in %.2f seconds!", computeTime);
+}
+
+void PrecomputedScatteringTables::RunPass ( PASS_TYPE i_PassType, bool i_IsFirstOrder )
+{
+	unsigned int rowCount = 0;
+
+	switch (i_PassType)
+	{
+		case PASS_TYPE::PT_TRANSMITTANCE:
+			rowCount = m_kTransmittanceHeight;
+			break;
+		case PASS_TYPE::PT_IRRADIANCE_1:
+		case PASS_TYPE::PT_IRRADIANCE_N:
+			rowCount = m_kIrradianceHeight;
+			break;
+		case PASS_TYPE::PT_INSCATTER_1:
+		case PASS_TYPE::PT_INSCATTER_S:
+		case PASS_TYPE::PT_INSCATTER_N:
+			// one row per (r, mu) pair
+			rowCount = m_kInscatterHeight * m_kInscatterDepth;
+			break;
+		case PASS_TYPE::PT_COUNT:
+		default:
+			ERR("Invalid precomputed scattering pass type!");
+			return;
+	}
+
+	// the calling thread computes the first rows, so no thread is created when m_ThreadCount is 1
+	unsigned short threadCount = static_cast<unsigned short>(glm::min(static_cast<unsigned int>(m_ThreadCount), rowCount));
+	unsigned int rowsPerThread = (rowCount + threadCount - 1) / threadCount;
+
+	std::vector<std::thread> workers;
+	workers.reserve(threadCount - 1);
+
+	for (unsigned short i = 1; i < threadCount; ++i)
+	{
+		unsigned int firstRow = i * rowsPerThread;
+		if (firstRow >= rowCount)
+		{
+			break;
+		}
+
+		unsigned int lastRow = glm::min(firstRow + rowsPerThread, rowCount);
+
+		workers.push_back(std::thread(&PrecomputedScatteringTables::ComputeRows, this, i_PassType, i_IsFirstOrder, firstRow, lastRow));
+	}
+
+	ComputeRows(i_PassType, i_IsFirstOrder, 0, glm::min(rowsPerThread, rowCount));
+
+	for (size_t i = 0; i < workers.size(); ++i)
+	{
+		workers[i].join();
+	}
+}
+
+void PrecomputedScatteringTables::ComputeRows ( PASS_TYPE i_PassType, bool i_IsFirstOrder, unsigned int i_FirstRow, unsigned int i_LastRow )
+{
+	// NOTE! A pass never reads the tables it writes, so the rows are independent
+	for (unsigned int row = i_FirstRow; row < i_LastRow; ++row)
+	{
+		switch (i_PassType)
+		{
+			case PASS_TYPE::PT_TRANSMITTANCE:
+				ComputeTransmittanceRow(row);
+				break;
+			case PASS_TYPE::PT_IRRADIANCE_1:
+				ComputeIrradiance1Row(row);
+				break;
+			case PASS_TYPE::PT_INSCATTER_1:
+				ComputeInscatter1Row(row);
+				break;
+			case PASS_TYPE::PT_INSCATTER_S:
+				ComputeInscatterSRow(row, i_IsFirstOrder);
+				break;
+			case PASS_TYPE::PT_IRRADIANCE_N:
+				ComputeIrradianceNRow(row, i_IsFirstOrder);
+				break;
+			case PASS_TYPE::PT_INSCATTER_N:
+				ComputeInscatterNRow(row);
+				break;
+			case PASS_TYPE::PT_COUNT:
+			default:
+				ERR("Invalid precomputed scattering pass type!");
+				return;
+		}
+	}
+}
+
+void PrecomputedScatteringTables::ComputeTransmittanceRow ( unsigned int i_Row )
+{
+	// non linear parameterization, more precision near the ground and the horizon
+	float r = (i_Row + 0.5f) / m_kTransmittanceHeight;
+	r = m_Rg + (r * r) * (m_Rt - m_Rg);
+
+	glm::vec4* pRow = &m_Transmittance[i_Row * m_kTransmittanceWidth];
+
+	for (unsigned short x = 0; x < m_kTransmittanceWidth; ++x)
+	{
+		float mu = (x + 0.5f) / m_kTransmittanceWidth;
+		mu = -0.15f + glm::tan(1.5f * mu) / glm::tan(1.5f) * (1.0f + 0.15f);
+
+		glm::vec3 depth = m_BetaR * OpticalDepth(m_HR, r, mu) + m_BetaMEx * OpticalDepth(m_HM, r, mu);
+
+		// the alpha is 1, so the transmittance ratios are always defined
+		pRow[x] = glm::vec4(glm::exp(-depth), 1.0f);
+	}
+}
+
+void PrecomputedScatteringTables::ComputeIrradiance1Row ( unsigned int i_Row )
+{
+	float r = m_Rg + i_Row / (m_kIrradianceHeight - 1.0f) * (m_Rt - m_Rg);
+
+	glm::vec4* pRow = &m_DeltaE[i_Row * m_kIrradianceWidth];
+
+	for (unsigned short x = 0; x < m_kIrradianceWidth; ++x)
+	{
+		float muS = -0.2f + x / (m_kIrradianceWidth - 1.0f) * (1.0f + 0.2f);
+
+		pRow[x] = Transmittance(r, muS) * glm::max(muS, 0.0f);
+
+		// the direct irradiance is not part of the final table
+		m_Irradiance[i_Row * m_kIrradianceWidth + x] = glm::vec4(0.0f);
+	}
+}
+
+void PrecomputedScatteringTables::ComputeInscatter1Row ( unsigned int i_Row )
+{
+	unsigned short layer = i_Row / m_kInscatterHeight;
+	unsigned short y = i_Row % m_kInscatterHeight;
+
+	float r = 0.0f;
+	glm::vec4 dhdH;
+	GetLayer(layer, r, dhdH);
+
+	size_t rowOffset = static_cast<size_t>(i_Row) * m_kInscatterWidth;
+
+	for (unsigned short x = 0; x < m_kInscatterWidth; ++x)
+	{
+		float mu = 0.0f, muS = 0.0f, nu = 0.0f;
+		GetMuMuSNu(x, y, r, dhdH, mu, muS, nu);
+
+		glm::vec4 ray(0.0f), mie(0.0f);
+		glm::vec4 rayi(0.0f), miei(0.0f);
+
+		glm::vec4 transmittance0 = Transmittance(r, glm::abs(mu));
+
+		float dx = Limit(r, mu) / kInscatterIntegralSamples;
+
+		for (unsigned short i = 0; i <= kInscatterIntegralSamples; ++i)
+		{
+			float t = i * dx;
+
+			glm::vec4 rayj(0.0f), miej(0.0f);
+
+			float ri = glm::sqrt(r * r + t * t + 2.0f * r * mu * t);
+			float muSi = (nu * t + muS * r) / ri;
+			ri = glm::max(m_Rg, ri);
+
+			// the sun is not behind the ground
+			if (muSi >= -glm::sqrt(1.0f - m_Rg * m_Rg / (ri * ri)))
+			{
+				glm::vec4 ti = Transmittance(r, mu, t, transmittance0) * Transmittance(ri, muSi);
+
+				rayj = glm::exp(-(ri - m_Rg) / m_HR) * ti;
+				miej = glm::exp(-(ri - m_Rg) / m_HM) * ti;
+			}
+
+			if (i > 0)
+			{
+				AddTrapezoid4(ray, rayi, rayj, 0.5f * dx);
+				AddTrapezoid4(mie, miei, miej, 0.5f * dx);
+			}
+
+			rayi = rayj;
+			miei = miej;
+		}
+
+		glm::vec4 deltaSR = ray * glm::vec4(m_BetaR, 0.0f);
+		glm::vec4 deltaSM = mie * glm::vec4(glm::vec3(m_BetaMSca), 0.0f);
+
+		m_DeltaSR[rowOffset + x] = deltaSR;
+		m_DeltaSM[rowOffset + x] = deltaSM;
+
+		// rgb - Rayleigh, alpha - red channel of Mie (check getMie() in the shaders)
+		m_Inscatter[rowOffset + x] = glm::vec4(deltaSR.x, deltaSR.y, deltaSR.z, deltaSM.x);
+	}
+}
+
+void PrecomputedScatteringTables::ComputeInscatterSRow ( unsigned int i_Row, bool i_IsFirstOrder )
+{
+	unsigned short layer = i_Row / m_kInscatterHeight;
+	unsigned short y = i_Row % m_kInscatterHeight;
+
+	float r = 0.0f;
+	glm::vec4 dhdH;
+	GetLayer(layer, r, dhdH);
+
+	r = glm::clamp(r, m_Rg, m_Rt);
+
+	const float pi = glm::pi<float>();
+	const float dphi = pi / kInscatterSphericalIntegralSamples;
+	const float dtheta = pi / kInscatterSphericalIntegralSamples;
+
+	const unsigned short directionCount = 2 * kInscatterSphericalIntegralSamples * kInscatterSphericalIntegralSamples;
+
+	// the sampled directions, the ground and the scattering towards the view direction
+	// depend only on r and mu, so they are the same for the whole row
+	struct Direction
+	{
+		glm::vec3 w;
+		bool isGroundVisible;
+		// ground transmittance * reflectance / PI
+		glm::vec4 groundFactor;
+		float groundDistance;
+		// scattering coefficients * phase functions * solid angle
+		glm::vec4 scatteringFactor;
+		// Texture4D() coordinate of (r, w.z)
+		float uMu;
+	};
+
+	std::vector<Direction> directions(directionCount);
+
+	float uR = 0.0f;
+
+	float cthetamin = -glm::sqrt(1.0f - (m_Rg / r) * (m_Rg / r));
+
+	float betaRFactor = glm::exp(-(r - m_Rg) / m_HR);
+	float betaMFactor = m_BetaMSca * glm::exp(-(r - m_Rg) / m_HM);
+
+	// the same mu for the whole row
+	float mu = 0.0f, muS = 0.0f, nu = 0.0f;
+	GetMuMuSNu(0, y, r, dhdH, mu, muS, nu);
+	mu = glm::clamp(mu, -1.0f, 1.0f);
+
+	glm::vec3 v(glm::sqrt(1.0f - mu * mu), 0.0f, mu);
+
+	for (unsigned short itheta = 0, k = 0; itheta < kInscatterSphericalIntegralSamples; ++itheta)
+	{
+		float theta = (itheta + 0.5f) * dtheta;
+		float ctheta = glm::cos(theta);
+
+		bool isGroundVisible = (ctheta < cthetamin);
+		glm::vec4 groundFactor(0.0f);
+		float groundDistance = 0.0f;
+
+		if (isGroundVisible)
+		{
+			groundDistance = -r * ctheta - glm::sqrt(glm::max(r * r * (ctheta * ctheta - 1.0f) + m_Rg * m_Rg, 0.0f));
+			groundFactor = Transmittance(m_Rg, -(r * ctheta + groundDistance) / m_Rg, groundDistance) * (m_GroundReflectance / pi);
+		}
+
+		for (unsigned short iphi = 0; iphi < 2 * kInscatterSphericalIntegralSamples; ++iphi, ++k)
+		{
+			float phi = (iphi + 0.5f) * dphi;
+			float dw = dtheta * dphi * glm::sin(theta);
+
+			Direction& direction = directions[k];
+			direction.w = glm::vec3(glm::cos(phi) * glm::sin(theta), glm::sin(phi) * glm::sin(theta), ctheta);
+			direction.isGroundVisible = isGroundVisible;
+			direction.groundFactor = groundFactor;
+			direction.groundDistance = groundDistance;
+
+			float nu2 = glm::dot(v, direction.w);
+			glm::vec3 scatteringFactor = (m_BetaR * betaRFactor * PhaseFunctionR(nu2) + betaMFactor * PhaseFunctionM(nu2)) * dw;
+			direction.scatteringFactor = glm::vec4(scatteringFactor, 0.0f);
+
+			GetTexture4DCoords(r, ctheta, uR, direction.uMu);
+		}
+	}
+
+	size_t rowOffset = static_cast<size_t>(i_Row) * m_kInscatterWidth;
+
+	for (unsigned short x = 0; x < m_kInscatterWidth; ++x)
+	{
+		GetMuMuSNu(x, y, r, dhdH, mu, muS, nu);
+		mu = glm::clamp(mu, -1.0f, 1.0f);
+		muS = glm::clamp(muS, -1.0f, 1.0f);
+
+		float var = glm::sqrt(1.0f - mu * mu) * glm::sqrt(1.0f - muS * muS);
+		nu = glm::clamp(nu, muS * mu - var, muS * mu + var);
+
+		float sx = (v.x == 0.0f ? 0.0f : (nu - muS * mu) / v.x);
+		glm::vec3 s(sx, glm::sqrt(glm::max(0.0f, 1.0f - sx * sx - muS * muS)), muS);
+
+		float uMuS = GetTexture4DMuSCoord(muS);
+
+		glm::vec4 raymie(0.0f);
+
+		// integral over 4.PI around x -- Eq (7)
+		for (unsigned short k = 0; k < directionCount; ++k)
+		{
+			const Direction& direction = directions[k];
+			const glm::vec3& w = direction.w;
+
+			float nu1 = glm::dot(s, w);
+
+			// light arriving at x from direction w
+			// first term = light reflected from the ground and attenuated before reaching x, =T.alpha/PI.deltaE
+			glm::vec4 raymie1(0.0f);
+			if (direction.isGroundVisible)
+			{
+				glm::vec3 groundNormal = (glm::vec3(0.0f, 0.0f, r) + direction.groundDistance * w) / m_Rg;
+				glm::vec4 groundIrradiance = Irradiance(m_DeltaE, m_Rg, glm::dot(groundNormal, s));
+
+				raymie1 = direction.groundFactor * groundIrradiance;
+			}
+
+			// second term = inscattered light, =deltaS
+			if (i_IsFirstOrder)
+			{
+				// Rayleigh and Mie were stored separately, without the phase functions
+				glm::vec4 ray1 = SampleTexture4D(m_DeltaSR, uR, direction.uMu, uMuS, nu1);
+				glm::vec4 mie1 = SampleTexture4D(m_DeltaSM, uR, direction.uMu, uMuS, nu1);
+
+				MulAdd4(raymie1, ray1, glm::vec4(PhaseFunctionR(nu1)));
+				MulAdd4(raymie1, mie1, glm::vec4(PhaseFunctionM(nu1)));
+			}
+			else
+			{
+				raymie1 += SampleTexture4D(m_DeltaSR, uR, direction.uMu, uMuS, nu1);
+			}
+
+			// light coming from direction w and scattered in direction v
+			MulAdd4(raymie, raymie1, direction.scatteringFactor);
+		}
+
+		m_DeltaJ[rowOffset + x] = raymie;
+	}
+}
+
+void PrecomputedScatteringTables::ComputeIrradianceNRow ( unsigned int i_Row, bool i_IsFirstOrder )
+{
+	float r = m_Rg + i_Row / (m_kIrradianceHeight - 1.0f) * (m_Rt - m_Rg);
+
+	const float pi = glm::pi<float>();
+	const float dphi = pi / kIrradianceIntegralSamples;
+	const float dtheta = pi / kIrradianceIntegralSamples;
+
+	glm::vec4* pRow = &m_DeltaE[i_Row * m_kIrradianceWidth];
+
+	for (unsigned short x = 0; x < m_kIrradianceWidth; ++x)
+	{
+		float muS = -0.2f + x / (m_kIrradianceWidth - 1.0f) * (1.0f + 0.2f);
+
+		glm::vec3 s(glm::sqrt(glm::max(1.0f - muS * muS, 0.0f)), 0.0f, muS);
+
+		glm::vec4 result(0.0f);
+
+		// integral over 2.PI around x -- Eq (15)
+		for (unsigned short iphi = 0; iphi < 2 * kIrradianceIntegralSamples; ++iphi)
+		{
+			float phi = (iphi + 0.5f) * dphi;
+
+			for (unsigned short itheta = 0; itheta < kIrradianceIntegralSamples / 2; ++itheta)
+			{
+				float theta = (itheta + 0.5f) * dtheta;
+				float dw = dtheta * dphi * glm::sin(theta);
+
+				glm::vec3 w(glm::cos(phi) * glm::sin(theta), glm::sin(phi) * glm::sin(theta), glm::cos(theta));
+				float nu = glm::dot(s, w);
+
+				glm::vec4 raymie;
+				if (i_IsFirstOrder)
+				{
+					raymie = Texture4D(m_DeltaSR, r, w.z, muS, nu) * PhaseFunctionR(nu);
+					MulAdd4(raymie, Texture4D(m_DeltaSM, r, w.z, muS, nu), glm::vec4(PhaseFunctionM(nu)));
+				}
+				else
+				{
+					raymie = Texture4D(m_DeltaSR, r, w.z, muS, nu);
+				}
+
+				MulAdd4(result, raymie, glm::vec4(w.z * dw));
+			}
+		}
+
+		pRow[x] = result;
+
+		// E += deltaE
+		m_Irradiance[i_Row * m_kIrradianceWidth + x] += result;
+	}
+}
+
+void PrecomputedScatteringTables::ComputeInscatterNRow ( unsigned int i_Row )
+{
+	unsigned short layer = i_Row / m_kInscatterHeight;
+	unsigned short y = i_Row % m_kInscatterHeight;
+
+	float r = 0.0f;
+	glm::vec4 dhdH;
+	GetLayer(layer, r, dhdH);
+
+	size_t rowOffset = static_cast<size_t>(i_Row) * m_kInscatterWidth;
+
+	for (unsigned short x = 0; x < m_kInscatterWidth; ++x)
+	{
+		float mu = 0.0f, muS = 0.0f, nu = 0.0f;
+		GetMuMuSNu(x, y, r, dhdH, mu, muS, nu);
+
+		glm::vec4 raymie(0.0f);
+		glm::vec4 raymiei(0.0f);
+
+		glm::vec4 transmittance0 = Transmittance(r, glm::abs(mu));
+
+		float dx = Limit(r, mu) / kInscatterIntegralSamples;
+
+		for (unsigned short i = 0; i <= kInscatterIntegralSamples; ++i)
+		{
+			float t = i * dx;
+
+			float ri = glm::sqrt(r * r + t * t + 2.0f * r * mu * t);
+			float mui = (r * mu + t) / ri;
+			float muSi = (nu * t + muS * r) / ri;
+
+			glm::vec4 raymiej = Texture4D(m_DeltaJ, ri, mui, muSi, nu) * Transmittance(r, mu, t, transmittance0);
+
+			if (i > 0)
+			{
+				AddTrapezoid4(raymie, raymiei, raymiej, 0.5f * dx);
+			}
+
+			raymiei = raymiej;
+		}
+
+		// the next order scatters this light
+		m_DeltaSR[rowOffset + x] = raymie;
+
+		// S += deltaS, without the Rayleigh phase function which is applied in the shaders
+		m_Inscatter[rowOffset + x] += glm::vec4(glm::vec3(raymie) / PhaseFunctionR(nu), 0.0f);
+	}
+}
+
+glm::vec4 PrecomputedScatteringTables::Transmittance ( float i_R, float i_Mu ) const
+{
+	float uR = glm::sqrt(glm::max(i_R - m_Rg, 0.0f) / (m_Rt - m_Rg));
+	float uMu = glm::atan((i_Mu + 0.15f) / (1.0f + 0.15f) * glm::tan(1.5f)) / 1.5f;
+
+	return Sample2D(m_Transmittance, m_kTransmittanceWidth, m_kTransmittanceHeight, uMu, uR);
+}
+
+glm::vec4 PrecomputedScatteringTables::Transmittance ( float i_R, float i_Mu, float i_D ) const
+{
+	return Transmittance(i_R, i_Mu, i_D, Transmittance(i_R, glm::abs(i_Mu)));
+}
+
+glm::vec4 PrecomputedScatteringTables::Transmittance ( float i_R, float i_Mu, float i_D, const glm::vec4& i_Transmittance0 ) const
+{
+	float r1 = glm::sqrt(i_R * i_R + i_D * i_D + 2.0f * i_R * i_Mu * i_D);
+	float mu1 = (i_R * i_Mu + i_D) / r1;
+
+	if (i_Mu > 0.0f)
+	{
+		return glm::min(i_Transmittance0 / Transmittance(r1, mu1), glm::vec4(1.0f));
+	}
+	else
+	{
+		return glm::min(Transmittance(r1, -mu1) / i_Transmittance0, glm::vec4(1.0f));
+	}
+}
+
+glm::vec4 PrecomputedScatteringTables::Irradiance ( const std::vector<glm::vec4>& i_Table, float i_R, float i_MuS ) const
+{
+	float uR = (i_R - m_Rg) / (m_Rt - m_Rg);
+	float uMuS = (i_MuS + 0.2f) / (1.0f + 0.2f);
+
+	return Sample2D(i_Table, m_kIrradianceWidth, m_kIrradianceHeight, uMuS, uR);
+}
+
+glm::vec4 PrecomputedScatteringTables::Texture4D ( const std::vector<glm::vec4>& i_Table, float i_R, float i_Mu, float i_MuS, float i_Nu ) const
+{
+	float uR = 0.0f, uMu = 0.0f;
+	GetTexture4DCoords(i_R, i_Mu, uR, uMu);
+
+	return SampleTexture4D(i_Table, uR, uMu, GetTexture4DMuSCoord(i_MuS), i_Nu);
+}
+
+void PrecomputedScatteringTables::GetTexture4DCoords ( float i_R, float i_Mu, float& o_UR, float& o_UMu ) const
+{
+	float H = glm::sqrt(m_Rt * m_Rt - m_Rg * m_Rg);
+	float rho = glm::sqrt(glm::max(i_R * i_R - m_Rg * m_Rg, 0.0f));
+
+	float rmu = i_R * i_Mu;
+	float delta = rmu * rmu - i_R * i_R + m_Rg * m_Rg;
+
+	glm::vec4 cst = (rmu < 0.0f && delta > 0.0f ? glm::vec4(1.0f, 0.0f, 0.0f, 0.5f - 0.5f / m_kResMu) : glm::vec4(-1.0f, H * H, H, 0.5f + 0.5f / m_kResMu));
+
+	o_UR = 0.5f / m_kResR + rho / H * (1.0f - 1.0f / m_kResR);
+	o_UMu = cst.w + (rmu * cst.x + glm::sqrt(glm::max(delta + cst.y, 0.0f))) / (rho + cst.z) * (0.5f - 1.0f / m_kResMu);
+}
+
+float PrecomputedScatteringTables::GetTexture4DMuSCoord ( float i_MuS ) const
+{
+	return 0.5f / m_kResMuS + (glm::atan(glm::max(i_MuS, -0.1975f) * glm::tan(1.26f * 1.1f)) / 1.1f + (1.0f - 0.26f)) * 0.5f * (1.0f - 1.0f / m_kResMuS);
+}
+
+glm::vec4 PrecomputedScatteringTables::SampleTexture4D ( const std::vector<glm::vec4>& i_Table, float i_UR, float i_UMu, float i_UMuS, float i_Nu ) const
+{
+	float lerp = (i_Nu + 1.0f) / 2.0f * (m_kResNu - 1.0f);
+	float uNu = glm::floor(lerp);
+	lerp = lerp - uNu;
+
+	return Mix4(Sample3D(i_Table, m_kInscatterWidth, m_kInscatterHeight, m_kInscatterDepth, (uNu + i_UMuS) / m_kResNu, i_UMu, i_UR),
+				Sample3D(i_Table, m_kInscatterWidth, m_kInscatterHeight, m_kInscatterDepth, (uNu + i_UMuS + 1.0f) / m_kResNu, i_UMu, i_UR), lerp);
+}
+
+float PrecomputedScatteringTables::Limit ( float i_R, float i_Mu ) const
+{
+	float dout = -i_R * i_Mu + glm::sqrt(glm::max(i_R * i_R * (i_Mu * i_Mu - 1.0f) + m_RL * m_RL, 0.0f));
+
+	float delta2 = i_R * i_R * (i_Mu * i_Mu - 1.0f) + m_Rg * m_Rg;
+	if (delta2 >= 0.0f)
+	{
+		float din = -i_R * i_Mu - glm::sqrt(delta2);
+		if (din >= 0.0f)
+		{
+			dout = glm::min(dout, din);
+		}
+	}
+
+	return dout;
+}
+
+float PrecomputedScatteringTables::OpticalDepth ( float i_H, float i_R, float i_Mu ) const
+{
+	// the ray hits the ground
+	if (i_Mu < -glm::sqrt(1.0f - (m_Rg / i_R) * (m_Rg / i_R)))
+	{
+		return 1e9f;
+	}
+
+	float result = 0.0f;
+	float dx = Limit(i_R, i_Mu) / kTransmittanceIntegralSamples;
+	float yi = glm::exp(-(i_R - m_Rg) / i_H);
+
+	for (unsigned short i = 1; i <= kTransmittanceIntegralSamples; ++i)
+	{
+		float xj = i * dx;
+		float yj = glm::exp(-(glm::sqrt(i_R * i_R + xj * xj + 2.0f * xj * i_R * i_Mu) - m_Rg) / i_H);
+
+		result += (yi + yj) / 2.0f * dx;
+		yi = yj;
+	}
+
+	return result;
+}
+
+float PrecomputedScatteringTables::PhaseFunctionR ( float i_Mu ) const
+{
+	return (3.0f / (16.0f * glm::pi<float>())) * (1.0f + i_Mu * i_Mu);
+}
+
+float PrecomputedScatteringTables::PhaseFunctionM ( float i_Mu ) const
+{
+	float mieG2 = m_MieG * m_MieG;
+
+	// pow(x, -3/2) without pow(), it is called for every sampled direction
+	float x = 1.0f + mieG2 - 2.0f * m_MieG * i_Mu;
+
+	return 1.5f * 1.0f / (4.0f * glm::pi<float>()) * (1.0f - mieG2) / (x * glm::sqrt(x)) * (1.0f + i_Mu * i_Mu) / (2.0f + mieG2);
+}
+
+void PrecomputedScatteringTables::GetLayer ( unsigned short i_Layer, float& o_R, glm::vec4& o_DhdH ) const
+{
+	// double precision, like the original precomputation (the squared radii are big numbers)
+	double rg = m_Rg, rt = m_Rt;
+
+	double r = i_Layer / (m_kResR - 1.0);
+	r = r * r;
+	// the first and the last layers are moved a bit inside the atmosphere
+	r = std::sqrt(rg * rg + r * (rt * rt - rg * rg)) + (i_Layer == 0 ? 10.0 : (i_Layer == m_kResR - 1 ? -1.0 : 0.0));
+
+	double dmin = rt - r;
+	double dmax = std::sqrt(r * r - rg * rg) + std::sqrt(rt * rt - rg * rg);
+	double dminp = r - rg;
+	double dmaxp = std::sqrt(r * r - rg * rg);
+
+	o_R = static_cast<float>(r);
+	o_DhdH = glm::vec4(static_cast<float>(dmin), static_cast<float>(dmax), static_cast<float>(dminp), static_cast<float>(dmaxp));
+}
+
+void PrecomputedScatteringTables::GetMuMuSNu ( unsigned short i_X, unsigned short i_Y, float i_R, const glm::vec4& i_DhdH, float& o_Mu, float& o_MuS, float& o_Nu ) const
+{
+	float x = i_X;
+	float y = i_Y;
+
+	// the lower half of the table - the rays which hit the ground
+	if (y < m_kResMu / 2.0f)
+	{
+		float d = 1.0f - y / (m_kResMu / 2.0f - 1.0f);
+		d = glm::min(glm::max(i_DhdH.z, d * i_DhdH.w), i_DhdH.w * 0.999f);
+
+		o_Mu = (m_Rg * m_Rg - i_R * i_R - d * d) / (2.0f * i_R * d);
+		o_Mu = glm::min(o_Mu, -glm::sqrt(1.0f - (m_Rg / i_R) * (m_Rg / i_R)) - 0.001f);
+	}
+	else
+	{
+		float d = (y - m_kResMu / 2.0f) / (m_kResMu / 2.0f - 1.0f);
+		d = glm::min(glm::max(i_DhdH.x, d * i_DhdH.y), i_DhdH.y * 0.999f);
+
+		o_Mu = (m_Rt * m_Rt - i_R * i_R - d * d) / (2.0f * i_R * d);
+	}
+
+	o_MuS = glm::mod(x, static_cast<float>(m_kResMuS)) / (m_kResMuS - 1.0f);
+	// same formula as the one used by the lookup (check Texture4D())
+	o_MuS = glm::tan((2.0f * o_MuS - 1.0f + 0.26f) * 1.1f) / glm::tan(1.26f * 1.1f);
+
+	o_Nu = -1.0f + glm::floor(x / m_kResMuS) / (m_kResNu - 1.0f) * 2.0f;
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+/* Author: BAIRAC MIHAI
+
+ Implementation based on Eric Bruneton's work
+ Precomputed Atmospheric Scattering paper
+ Code + paper: http://www-evasion.imag.fr/people/Eric.Bruneton/
+ License: check the package
+
+*/
+
+#ifndef PRECOMPUTED_SCATTERING_TABLES_H
+#define PRECOMPUTED_SCATTERING_TABLES_H
+
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include <string>
+#include <vector>
+
+class GlobalConfig;
+
+/*
+ CPU precomputation of the PrecomputedScatteringSkyModel tables:
+ transmittance (256 x 64), ground irradiance (64 x 16) and inscatter (RES_MU_S * RES_NU x RES_MU x RES_R = 256 x 128 x 32)
+ The tables use the parameterization of the PrecomputedScatteringSkyModel shaders, in meters.
+
+ The multiple scattering is computed order by order (algorithm 4.1 of the paper), like the original GPU passes.
+ Every pass splits the table rows across threads, the texels are rgba floats blended 4 channels at a time with SSE.
+
+ The tables are saved to a cache file (in the user application data folder) together with the atmosphere parameters,
+ so they are computed again only when these parameters change.
+ The computation doesn't need a GL context.
+*/
+
+class PrecomputedScatteringTables
+{
+public:
+	PrecomputedScatteringTables(void);
+	PrecomputedScatteringTables(const GlobalConfig& i_Config);
+	~PrecomputedScatteringTables(void);
+
+	// loads the tables from the cache file or computes and saves them
+	// returns false if the atmosphere parameters are invalid, the tables are empty then
+	bool Initialize(const GlobalConfig& i_Config);
+
+	// rgba floats, the alpha of the transmittance and irradiance tables is not used
+	const glm::vec4* GetTransmittanceData(void) const;
+	const glm::vec4* GetIrradianceData(void) const;
+	const glm::vec4* GetInscatterData(void) const;
+
+	static const unsigned short m_kTransmittanceWidth = 256;
+	static const unsigned short m_kTransmittanceHeight = 64;
+	static const unsigned short m_kIrradianceWidth = 64;
+	static const unsigned short m_kIrradianceHeight = 16;
+	static const unsigned short m_kResR = 32;
+	static const unsigned short m_kResMu = 128;
+	static const unsigned short m_kResMuS = 32;
+	static const unsigned short m_kResNu = 8;
+	static const unsigned short m_kInscatterWidth = m_kResMuS * m_kResNu;
+	static const unsigned short m_kInscatterHeight = m_kResMu;
+	static const unsigned short m_kInscatterDepth = m_kResR;
+
+private:
+	//// Methods ////
+	void Destroy(void);
+
+	bool LoadCache(void);
+	bool SaveCache(void) const;
+
+	void Compute(void);
+
+	enum class PASS_TYPE
+	{
+		PT_TRANSMITTANCE = 0,
+		PT_IRRADIANCE_1, // direct sun light on the ground
+		PT_INSCATTER_1, // single scattering
+		PT_INSCATTER_S, // light scattered once more at each point (deltaJ)
+		PT_IRRADIANCE_N, // ground irradiance of the previous order (deltaE)
+		PT_INSCATTER_N, // deltaJ integrated along the view rays (deltaS)
+		PT_COUNT
+	};
+
+	// splits the rows of the pass output table across the threads
+	void RunPass(PASS_TYPE i_PassType, bool i_IsFirstOrder);
+	void ComputeRows(PASS_TYPE i_PassType, bool i_IsFirstOrder, unsigned int i_FirstRow, unsigned int i_LastRow);
+
+	void ComputeTransmittanceRow(unsigned int i_Row);
+	void ComputeIrradiance1Row(unsigned int i_Row);
+	void ComputeInscatter1Row(unsigned int i_Row);
+	void ComputeInscatterSRow(unsigned int i_Row, bool i_IsFirstOrder);
+	void ComputeIrradianceNRow(unsigned int i_Row, bool i_IsFirstOrder);
+	void ComputeInscatterNRow(unsigned int i_Row);
+
+	//// Table lookups, same as the shader functions ////
+	glm::vec4 Transmittance(float i_R, float i_Mu) const;
+	// between the point (r, mu) and the point at distance d along the ray
+	glm::vec4 Transmittance(float i_R, float i_Mu, float i_D) const;
+	// i_Transmittance0 - Transmittance(r, abs(mu)), the same for all the points of a ray
+	glm::vec4 Transmittance(float i_R, float i_Mu, float i_D, const glm::vec4& i_Transmittance0) const;
+	glm::vec4 Irradiance(const std::vector<glm::vec4>& i_Table, float i_R, float i_MuS) const;
+	glm::vec4 Texture4D(const std::vector<glm::vec4>& i_Table, float i_R, float i_Mu, float i_MuS, float i_Nu) const;
+
+	// Texture4D() split in parts, so the integrals compute the coordinates of (r, mu) and muS only once
+	void GetTexture4DCoords(float i_R, float i_Mu, float& o_UR, float& o_UMu) const;
+	float GetTexture4DMuSCoord(float i_MuS) const;
+	glm::vec4 SampleTexture4D(const std::vector<glm::vec4>& i_Table, float i_UR, float i_UMu, float i_UMuS, float i_Nu) const;
+
+	// distance to the top atmosphere boundary (RL) or to the ground
+	float Limit(float i_R, float i_Mu) const;
+	float OpticalDepth(float i_H, float i_R, float i_Mu) const;
+
+	float PhaseFunctionR(float i_Mu) const;
+	float PhaseFunctionM(float i_Mu) const;
+
+	// texel parameters
+	void GetLayer(unsigned short i_Layer, float& o_R, glm::vec4& o_DhdH) const;
+	void GetMuMuSNu(unsigned short i_X, unsigned short i_Y, float i_R, const glm::vec4& i_DhdH, float& o_Mu, float& o_MuS, float& o_Nu) const;
+
+	//// Variables ////
+	std::string m_CacheFileName;
+	unsigned short m_ThreadCount;
+
+	// header of the cache file, the atmosphere parameters are used to check if the cache is up to date
+	struct CacheHeader
+	{
+		char magic[4];
+		unsigned int version;
+		unsigned int scatteringOrderCount;
+		float Rg, Rt, RL;
+		float betaRX, betaRY, betaRZ;
+		float HR, HM;
+		float betaMSca;
+		float mieG;
+		float groundReflectance;
+	};
+
+	static const unsigned int m_kCacheVersion = 1;
+
+	CacheHeader m_Header;
+
+	// atmosphere parameters (meters)
+	float m_Rg, m_Rt, m_RL;
+	glm::vec3 m_BetaR;
+	float m_HR, m_HM;
+	float m_BetaMSca, m_BetaMEx;
+	float m_MieG;
+	float m_GroundReflectance;
+
+	// final tables
+	std::vector<glm::vec4> m_Transmittance;
+	std::vector<glm::vec4> m_Irradiance;
+	std::vector<glm::vec4> m_Inscatter;
+
+	// intermediate tables of the current scattering order
+	std::vector<glm::vec4> m_DeltaE;
+	std::vector<glm::vec4> m_DeltaSR;
+	std::vector<glm::vec4> m_DeltaSM;
+	std::vector<glm::vec4> m_DeltaJ;
+};
+
+#endif /* PRECOMPUTED_SCATTERING_TABLES_H */
\ No newline at end of file
@@ -284,6 +284,16 @@ const glm::vec4& Projector::GetPlane ( void ) const
 	return m_Plane;
 }
 
+const glm::vec4& Projector::GetUpperPlane ( void ) const
+{
+	return m_UpperPlane;
+}
+
+const glm::vec4& Projector::GetLowerPlane ( void ) const
+{
+	return m_LowerPlane;
+}
+
 float Projector::GetPlaneDistance ( void ) const
 {
 	return m_Plane.w;
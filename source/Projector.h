@@ -51,6 +51,9 @@ public:
 	const Camera& GetProjectingCamera(void)  const;
 
 	const glm::vec4& GetPlane(void) const;
+	// the planes which bound the displaced waves
+	const glm::vec4& GetUpperPlane(void) const;
+	const glm::vec4& GetLowerPlane(void) const;
 	float GetPlaneDistance(void) const;
 
 	bool IsPlaneWithinFrustum(void) const;
@@ -0,0 +1,298 @@
+/* Author: BAIRAC MIHAI */
+
+#include "QualityGovernor.h"
+#include "CommonHeaders.h"
+#include "GLConfig.h"
+#include "GlobalConfig.h"
+#include "glm/common.hpp" //max(), mix()
+
+
+const float QualityGovernor::m_kSmoothingFactor = 0.1f;
+
+QualityGovernor::QualityGovernor ( void )
+	: m_IsEnabled(false), m_IsTimerQuerySupported(false),
+	  m_TargetFrameTime(0.0f), m_Hysteresis(0.0f), m_LevelCount(0),
+	  m_StepDownFrameCount(0), m_StepUpFrameCount(0), m_CooldownFrameCount(0),
+	  m_BaseSettings(), m_Settings(),
+	  m_Level(0), m_RequestedLevel(0), m_LastDecision(DECISION_TYPE::DT_NONE), m_DecisionCount(0),
+	  m_OverBudgetFrameCount(0), m_UnderBudgetFrameCount(0), m_RemainingCooldownFrameCount(0),
+	  m_FrameStartTime(), m_CPUTime(0.0f), m_GPUTime(0.0f), m_HasCPUTime(false), m_HasGPUTime(false),
+	  m_QueryIDs(), m_IsQueryPending(), m_QueryIndex(0)
+{
+	LOG("QualityGovernor successfully created!");
+}
+
+QualityGovernor::QualityGovernor ( const GlobalConfig& i_Config )
+	: m_IsEnabled(false), m_IsTimerQuerySupported(false),
+	  m_TargetFrameTime(0.0f), m_Hysteresis(0.0f), m_LevelCount(0),
+	  m_StepDownFrameCount(0), m_StepUpFrameCount(0), m_CooldownFrameCount(0),
+	  m_BaseSettings(), m_Settings(),
+	  m_Level(0), m_RequestedLevel(0), m_LastDecision(DECISION_TYPE::DT_NONE), m_DecisionCount(0),
+	  m_OverBudgetFrameCount(0), m_UnderBudgetFrameCount(0), m_RemainingCooldownFrameCount(0),
+	  m_FrameStartTime(), m_CPUTime(0.0f), m_GPUTime(0.0f), m_HasCPUTime(false), m_HasGPUTime(false),
+	  m_QueryIDs(), m_IsQueryPending(), m_QueryIndex(0)
+{
+	Initialize(i_Config);
+}
+
+QualityGovernor::~QualityGovernor ( void )
+{
+	Destroy();
+}
+
+void QualityGovernor::Destroy ( void )
+{
+	if (m_IsTimerQuerySupported)
+	{
+		glDeleteQueries(m_kQueryCount, m_QueryIDs);
+	}
+
+	LOG("QualityGovernor successfully destroyed!");
+}
+
+void QualityGovernor::Initialize ( const GlobalConfig& i_Config )
+{
+	m_IsEnabled = i_Config.Rendering.QualityGovernor.Enabled;
+	m_IsTimerQuerySupported = i_Config.GLExtVars.IsTimerQuerySupported;
+
+	m_TargetFrameTime = glm::max(i_Config.Rendering.QualityGovernor.TargetFrameTime, 1.0f);
+	m_Hysteresis = glm::clamp(i_Config.Rendering.QualityGovernor.Hysteresis, 0.0f, 0.9f);
+	m_LevelCount = glm::max(i_Config.Rendering.QualityGovernor.LevelCount, static_cast<unsigned short>(1));
+	m_StepDownFrameCount = glm::max(i_Config.Rendering.QualityGovernor.StepDownFrameCount, static_cast<unsigned short>(1));
+	m_StepUpFrameCount = glm::max(i_Config.Rendering.QualityGovernor.StepUpFrameCount, static_cast<unsigned short>(1));
+	m_CooldownFrameCount = i_Config.Rendering.QualityGovernor.CooldownFrameCount;
+
+	m_BaseSettings.FFTSize = i_Config.Scene.Ocean.Surface.OceanPatch.FFTSize;
+	m_BaseSettings.ScreenSpaceGridResolution = i_Config.Scene.Ocean.Grid.ScreenSpace.GridResolution;
+	m_BaseSettings.CausticsMapSize = i_Config.Scene.Ocean.Bottom.Caustics.MapSize;
+	m_BaseSettings.GodRaysNumberOfSamples = i_Config.Scene.Ocean.UnderWater.GodRays.NumberOfSamples;
+
+	// start with the configuration settings
+	m_Level = m_RequestedLevel = m_LevelCount - 1;
+	ComputeSettings(m_Level, m_Settings);
+
+	if (m_IsTimerQuerySupported)
+	{
+		glGenQueries(m_kQueryCount, m_QueryIDs);
+	}
+
+	LOG("QualityGovernor - %u levels, target frame time: %f ms, GPU timer queries: %s!", m_LevelCount, m_TargetFrameTime, m_IsTimerQuerySupported ? "yes" : "no");
+
+	LOG("QualityGovernor successfully created!");
+}
+
+void QualityGovernor::ComputeSettings ( unsigned short i_Level, QualitySettings& o_Settings ) const
+{
+	// how many levels below the configuration
+	unsigned short steps = m_LevelCount - 1 - i_Level;
+
+	// the FFT supports 128 to 1024, so the smallest FFT size is 128
+	o_Settings.FFTSize = (m_BaseSettings.FFTSize > 128 ? glm::max(m_BaseSettings.FFTSize >> steps, 128) : m_BaseSettings.FFTSize);
+	// a bigger resolution means a sparser grid
+	o_Settings.ScreenSpaceGridResolution = m_BaseSettings.ScreenSpaceGridResolution * (1.0f + 0.5f * steps);
+	o_Settings.CausticsMapSize = (m_BaseSettings.CausticsMapSize > 64 ? glm::max(m_BaseSettings.CausticsMapSize >> steps, 64) : m_BaseSettings.CausticsMapSize);
+	o_Settings.GodRaysNumberOfSamples = (m_BaseSettings.GodRaysNumberOfSamples > 16 ? glm::max(m_BaseSettings.GodRaysNumberOfSamples >> steps, 16) : m_BaseSettings.GodRaysNumberOfSamples);
+}
+
+void QualityGovernor::BeginFrame ( void )
+{
+	m_FrameStartTime = std::chrono::steady_clock::now();
+
+	// the query was issued m_kQueryCount frames ago, so its result should be available by now
+	if (m_IsTimerQuerySupported && !m_IsQueryPending[m_QueryIndex])
+	{
+		glBeginQuery(GL_TIME_ELAPSED, m_QueryIDs[m_QueryIndex]);
+	}
+}
+
+bool QualityGovernor::EndFrame ( float i_DeltaTime )
+{
+	//// CPU time
+	float cpuTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_FrameStartTime).count();
+	m_CPUTime = (m_HasCPUTime ? glm::mix(m_CPUTime, cpuTime, m_kSmoothingFactor) : cpuTime);
+	m_HasCPUTime = true;
+
+	//// GPU time
+	if (m_IsTimerQuerySupported)
+	{
+		if (!m_IsQueryPending[m_QueryIndex])
+		{
+			glEndQuery(GL_TIME_ELAPSED);
+			m_IsQueryPending[m_QueryIndex] = true;
+		}
+
+		m_QueryIndex = (m_QueryIndex + 1) % m_kQueryCount;
+
+		// the oldest query, it's reused in the next frame if its result is available
+		if (m_IsQueryPending[m_QueryIndex])
+		{
+			int isAvailable = 0;
+			glGetQueryObjectiv(m_QueryIDs[m_QueryIndex], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+
+			if (isAvailable)
+			{
+				GLuint64 elapsedTime = 0; // nanoseconds
+				glGetQueryObjectui64v(m_QueryIDs[m_QueryIndex], GL_QUERY_RESULT, &elapsedTime);
+				m_IsQueryPending[m_QueryIndex] = false;
+
+				float gpuTime = static_cast<float>(elapsedTime) * 1e-6f;
+				m_GPUTime = (m_HasGPUTime ? glm::mix(m_GPUTime, gpuTime, m_kSmoothingFactor) : gpuTime);
+				m_HasGPUTime = true;
+			}
+		}
+	}
+	else
+	{
+		// the frame delta time includes the buffer swap, so it's bound by the GPU
+		float gpuTime = i_DeltaTime * 1000.0f;
+		m_GPUTime = (m_HasGPUTime ? glm::mix(m_GPUTime, gpuTime, m_kSmoothingFactor) : gpuTime);
+		m_HasGPUTime = true;
+	}
+
+	//// Decision
+	if (m_RequestedLevel != m_Level)
+	{
+		ChangeLevel(m_RequestedLevel, DECISION_TYPE::DT_MANUAL);
+		return true;
+	}
+
+	if (!m_IsEnabled)
+	{
+		return false;
+	}
+
+	if (m_RemainingCooldownFrameCount > 0)
+	{
+		-- m_RemainingCooldownFrameCount;
+
+		// the frames after the cooldown start a new average
+		if (m_RemainingCooldownFrameCount == 0)
+		{
+			m_HasCPUTime = m_HasGPUTime = false;
+		}
+
+		return false;
+	}
+
+	if (!m_HasCPUTime || !m_HasGPUTime)
+	{
+		return false;
+	}
+
+	float frameTime = glm::max(m_CPUTime, m_GPUTime);
+
+	if (frameTime > m_TargetFrameTime * (1.0f + m_Hysteresis))
+	{
+		++ m_OverBudgetFrameCount;
+		m_UnderBudgetFrameCount = 0;
+	}
+	else if (frameTime < m_TargetFrameTime * (1.0f - m_Hysteresis))
+	{
+		++ m_UnderBudgetFrameCount;
+		m_OverBudgetFrameCount = 0;
+	}
+	else
+	{
+		m_OverBudgetFrameCount = 0;
+		m_UnderBudgetFrameCount = 0;
+	}
+
+	if (m_OverBudgetFrameCount >= m_StepDownFrameCount && m_Level > 0)
+	{
+		ChangeLevel(m_Level - 1, DECISION_TYPE::DT_STEP_DOWN);
+		return true;
+	}
+
+	if (m_UnderBudgetFrameCount >= m_StepUpFrameCount && m_Level < m_LevelCount - 1)
+	{
+		ChangeLevel(m_Level + 1, DECISION_TYPE::DT_STEP_UP);
+		return true;
+	}
+
+	return false;
+}
+
+void QualityGovernor::ChangeLevel ( unsigned short i_Level, DECISION_TYPE i_Decision )
+{
+	LOG("QualityGovernor - %s from level %u to level %u (CPU: %f ms, GPU: %f ms, target: %f ms)!",
+		i_Decision == DECISION_TYPE::DT_STEP_DOWN ? "step down" : (i_Decision == DECISION_TYPE::DT_STEP_UP ? "step up" : "manual change"),
+		m_Level, i_Level, m_CPUTime, m_GPUTime, m_TargetFrameTime);
+
+	m_Level = m_RequestedLevel = i_Level;
+	ComputeSettings(m_Level, m_Settings);
+
+	m_LastDecision = i_Decision;
+	++ m_DecisionCount;
+
+	m_OverBudgetFrameCount = 0;
+	m_UnderBudgetFrameCount = 0;
+	m_RemainingCooldownFrameCount = m_CooldownFrameCount;
+
+	if (m_RemainingCooldownFrameCount == 0)
+	{
+		m_HasCPUTime = m_HasGPUTime = false;
+	}
+}
+
+const QualityGovernor::QualitySettings& QualityGovernor::GetSettings ( void ) const
+{
+	return m_Settings;
+}
+
+unsigned short QualityGovernor::GetLevel ( void ) const
+{
+	return m_Level;
+}
+
+unsigned short QualityGovernor::GetLevelCount ( void ) const
+{
+	return m_LevelCount;
+}
+
+QualityGovernor::DECISION_TYPE QualityGovernor::GetLastDecision ( void ) const
+{
+	return m_LastDecision;
+}
+
+unsigned int QualityGovernor::GetDecisionCount ( void ) const
+{
+	return m_DecisionCount;
+}
+
+float QualityGovernor::GetCPUTime ( void ) const
+{
+	return m_CPUTime;
+}
+
+float QualityGovernor::GetGPUTime ( void ) const
+{
+	return m_GPUTime;
+}
+
+float QualityGovernor::GetTargetFrameTime ( void ) const
+{
+	return m_TargetFrameTime;
+}
+
+bool QualityGovernor::GetIsEnabled ( void ) const
+{
+	return m_IsEnabled;
+}
+
+void QualityGovernor::SetIsEnabled ( bool i_Value )
+{
+	m_IsEnabled = i_Value;
+
+	m_OverBudgetFrameCount = 0;
+	m_UnderBudgetFrameCount = 0;
+}
+
+void QualityGovernor::SetLevel ( unsigned short i_Level )
+{
+	m_RequestedLevel = glm::min(i_Level, static_cast<unsigned short>(m_LevelCount - 1));
+}
+
+void QualityGovernor::SetTargetFrameTime ( float i_TargetFrameTime )
+{
+	m_TargetFrameTime = glm::max(i_TargetFrameTime, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+#include <chrono>
+
+class GlobalConfig;
+
+/*
+ Frame time driven quality governor
+
+ It measures the CPU time (Update + Render, without the buffer swap) and the GPU time (GL_TIME_ELAPSED queries)
+ of every frame and compares the slowest of them against a target frame time.
+ The quality goes one level down after StepDownFrameCount frames over the budget and one level up after StepUpFrameCount frames
+ under the budget. The budget has a hysteresis band (TargetFrameTime * (1 +/- Hysteresis)), so the level doesn't oscillate.
+ The frames right after a level change are not measured, because they include the rebuild of the changed resources.
+
+ The highest level is the configuration from GlobalConfig.xml, every lower level halves the FFT size, the caustics map size and
+ the god rays samples and makes the screen space grid sparser.
+ The timer queries are read a few frames later, so the GPU is never stalled.
+ Without GL_ARB_timer_query the frame delta time is used as the GPU time.
+*/
+
+class QualityGovernor
+{
+public:
+	struct QualitySettings
+	{
+		unsigned short FFTSize;
+		float ScreenSpaceGridResolution;
+		unsigned short CausticsMapSize;
+		unsigned short GodRaysNumberOfSamples;
+	};
+
+	enum class DECISION_TYPE
+	{
+		DT_NONE = 0,
+		DT_STEP_DOWN,
+		DT_STEP_UP,
+		DT_MANUAL,
+		DT_COUNT
+	};
+
+	QualityGovernor(void);
+	QualityGovernor(const GlobalConfig& i_Config);
+	~QualityGovernor(void);
+
+	void Initialize(const GlobalConfig& i_Config);
+
+	// brackets the measured work of a frame
+	void BeginFrame(void);
+	// i_DeltaTime - seconds between the last two frames, used when the GPU time can't be measured
+	// returns true if the quality level changed (check GetSettings())
+	bool EndFrame(float i_DeltaTime);
+
+	const QualitySettings& GetSettings(void) const;
+
+	unsigned short GetLevel(void) const;
+	unsigned short GetLevelCount(void) const;
+	DECISION_TYPE GetLastDecision(void) const;
+	unsigned int GetDecisionCount(void) const;
+
+	// milliseconds, smoothed over the last frames
+	float GetCPUTime(void) const;
+	float GetGPUTime(void) const;
+	float GetTargetFrameTime(void) const;
+
+	bool GetIsEnabled(void) const;
+
+	void SetIsEnabled(bool i_Value);
+	// the level is used on the next EndFrame() call
+	void SetLevel(unsigned short i_Level);
+	void SetTargetFrameTime(float i_TargetFrameTime);
+
+private:
+	//// Methods ////
+	void Destroy(void);
+
+	void ChangeLevel(unsigned short i_Level, DECISION_TYPE i_Decision);
+	void ComputeSettings(unsigned short i_Level, QualitySettings& o_Settings) const;
+
+	//// Variables ////
+	static const unsigned short m_kQueryCount = 4;
+	// exponential moving average weight of the newest frame
+	static const float m_kSmoothingFactor;
+
+	bool m_IsEnabled;
+	bool m_IsTimerQuerySupported;
+
+	float m_TargetFrameTime;
+	float m_Hysteresis;
+	unsigned short m_LevelCount;
+	unsigned short m_StepDownFrameCount, m_StepUpFrameCount, m_CooldownFrameCount;
+
+	// the configuration settings (the highest level)
+	QualitySettings m_BaseSettings;
+	QualitySettings m_Settings;
+
+	unsigned short m_Level, m_RequestedLevel;
+	DECISION_TYPE m_LastDecision;
+	unsigned int m_DecisionCount;
+
+	unsigned short m_OverBudgetFrameCount, m_UnderBudgetFrameCount, m_RemainingCooldownFrameCount;
+
+	std::chrono::steady_clock::time_point m_FrameStartTime;
+	float m_CPUTime, m_GPUTime;
+	bool m_HasCPUTime, m_HasGPUTime;
+
+	// GL_TIME_ELAPSED queries, used round robin
+	unsigned int m_QueryIDs[m_kQueryCount];
+	bool m_IsQueryPending[m_kQueryCount];
+	unsigned short m_QueryIndex;
+};
+
+#endif /* QUALITY_GOVERNOR_H */
\ No newline at end of file
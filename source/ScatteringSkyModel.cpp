@@ -8,7 +8,8 @@
 #include "glm/vec3.hpp"
 #include "glm/mat3x3.hpp"
 #include "glm/exponential.hpp" //pow()
-#include "glm/trigonometric.hpp" //sin(), cos()
+#include "glm/trigonometric.hpp" //sin(), cos(), atan()
+#include "glm/common.hpp" //min(), max()
 #include "glm/gtc/matrix_transform.hpp" //perspective(), ortho(), lookAt()
 #include "glm/gtc/type_ptr.hpp" //value_ptr()
 #include "glm/gtc/constants.hpp" //pi(), two_pi()
@@ -16,14 +17,86 @@
 #include "GlobalConfig.h"
 
 
+namespace
+{
+	// u - the cosine of the angle with the up vector, v - the height
+	const unsigned short kTransmittanceLUTWidth = 256;
+	const unsigned short kTransmittanceLUTHeight = 128;
+
+	glm::mat4 ComputeSkyWorldToClipMatrix ( const Camera& i_Camera )
+	{
+		// remove the translation matrix from the view matrix
+		return i_Camera.GetProjectionMatrix() * glm::mat4(glm::mat3(i_Camera.GetViewMatrix()));
+	}
+
+	glm::vec3 ComputeWavelength4 ( const GlobalConfig& i_Config )
+	{
+		glm::vec3 wavelength4;
+		wavelength4.x = glm::pow(i_Config.Scene.Sky.Model.Scattering.Atmosphere.WaveLength.x, 4.0f);
+		wavelength4.y = glm::pow(i_Config.Scene.Sky.Model.Scattering.Atmosphere.WaveLength.y, 4.0f);
+		wavelength4.z = glm::pow(i_Config.Scene.Sky.Model.Scattering.Atmosphere.WaveLength.z, 4.0f);
+
+		return wavelength4;
+	}
+
+	// the sky and the LUTs programs share the atmosphere constants, the members missing from a program are skipped
+	void SetScatteringDataUniforms ( const ShaderManager& i_SM, const GlobalConfig& i_Config )
+	{
+		float Kr4PI = 4.0f * glm::pi<float>() * i_Config.Scene.Sky.Model.Scattering.Atmosphere.RayleighScatteringConstant;
+		float Km4PI = 4.0f * glm::pi<float>() * i_Config.Scene.Sky.Model.Scattering.Atmosphere.MieScatteringConstant;
+		float KrESun = i_Config.Scene.Sky.Model.Scattering.Atmosphere.RayleighScatteringConstant * i_Config.Scene.Sky.Model.Scattering.Atmosphere.SunBrightnessConstant;
+		float KmESun = i_Config.Scene.Sky.Model.Scattering.Atmosphere.MieScatteringConstant * i_Config.Scene.Sky.Model.Scattering.Atmosphere.SunBrightnessConstant;
+
+		float scaleDepth = i_Config.Scene.Sky.Model.Scattering.Atmosphere.OuterRadius - i_Config.Scene.Sky.Model.Scattering.Atmosphere.InnerRadius;
+		float scale = 1.0f / scaleDepth;
+		float scaleOverScaleDepth = scale / scaleDepth;
+
+		glm::vec3 wavelength4 = ComputeWavelength4(i_Config);
+
+		i_SM.SetUniform(i_SM.GetUniformLocation("u_ScatteringData.SampleCount"), i_Config.Scene.Sky.Model.Scattering.Atmosphere.SampleCount);
+		i_SM.SetUniform(i_SM.GetUniformLocation("u_ScatteringData.EarthRadius"), PhysicsConstants::kEarthRadius);
+		i_SM.SetUniform(i_SM.GetUniformLocation("u_ScatteringData.InvWavelength"), 1, glm::value_ptr(1.0f / wavelength4), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+		i_SM.SetUniform(i_SM.GetUniformLocation("u_ScatteringData.InnerRadius"), i_Config.Scene.Sky.Model.Scattering.Atmosphere.InnerRadius);
+		i_SM.SetUniform(i_SM.GetUniformLocation("u_ScatteringData.KrESun"), KrESun);
+		i_SM.SetUniform(i_SM.GetUniformLocation("u_ScatteringData.KmESun"), KmESun);
+		i_SM.SetUniform(i_SM.GetUniformLocation("u_ScatteringData.Kr4PI"), Kr4PI);
+		i_SM.SetUniform(i_SM.GetUniformLocation("u_ScatteringData.Km4PI"), Km4PI);
+		i_SM.SetUniform(i_SM.GetUniformLocation("u_ScatteringData.Scale"), scale);
+		i_SM.SetUniform(i_SM.GetUniformLocation("u_ScatteringData.ScaleDepth"), scaleDepth);
+		i_SM.SetUniform(i_SM.GetUniformLocation("u_ScatteringData.ScaleOverScaleDepth"), scaleOverScaleDepth);
+	}
+
+	void RenderToLUT ( const FrameBufferManager& i_FBM, const ShaderManager& i_SM, unsigned short i_Width, unsigned short i_Height )
+	{
+		// save current viewport
+		int oldViewport[4];
+		glGetIntegerv(GL_VIEWPORT, oldViewport);
+
+		i_FBM.Bind();
+
+		glViewport(0, 0, i_Width, i_Height);
+
+		i_SM.UseProgram();
+
+		i_FBM.RenderToQuad();
+
+		i_FBM.UnBind();
+
+		// restore viewport
+		glViewport(oldViewport[0], oldViewport[1], oldViewport[2], oldViewport[3]);
+	}
+}
+
 ScatteringSkyModel::ScatteringSkyModel ( void )
-	: m_AtmosphereInnerRadius(0.0f), m_AreCloudsEnabled(false)
+	: m_AtmosphereInnerRadius(0.0f), m_AreCloudsEnabled(false), m_CloudsNoiseTexId(0), m_IsCloudsUpsamplingEnabled(false), m_IsCubeMapCached(false), m_IsReflCubeMapCacheUsed(false),
+	  m_SkyViewLUTWidth(0), m_SkyViewLUTHeight(0), m_SkyViewLUTCameraHeight(0.0f), m_IsSkyViewLUTEnabled(false)
 {
 	LOG("ScatteringSkyModel successfully created!");
 }
 
 ScatteringSkyModel::ScatteringSkyModel ( const GlobalConfig& i_Config )
-	: m_AtmosphereInnerRadius(0.0f), m_AreCloudsEnabled(false)
+	: m_AtmosphereInnerRadius(0.0f), m_AreCloudsEnabled(false), m_CloudsNoiseTexId(0), m_IsCloudsUpsamplingEnabled(false), m_IsCubeMapCached(false), m_IsReflCubeMapCacheUsed(false),
+	  m_SkyViewLUTWidth(0), m_SkyViewLUTHeight(0), m_SkyViewLUTCameraHeight(0.0f), m_IsSkyViewLUTEnabled(false)
 {
 	Initialize(i_Config);
 }
@@ -64,28 +137,32 @@ void ScatteringSkyModel::Initialize ( const GlobalConfig& i_Config )
 	std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int> cloudsAttributes;
 	SetupCloudsShaders(i_Config, cloudsAttributes);
 	SetupCloudsGeometry(i_Config, cloudsAttributes);
+	SetupCloudsNoise(i_Config);
+
+	//// Setup CubeMap Cache
+	m_IsCubeMapCached = i_Config.Scene.Sky.Model.Scattering.CubeMapCache.Enabled;
+	if (m_IsCubeMapCached)
+	{
+		m_CubeMapCache.Initialize("ScatteringSkyModel", i_Config, i_Config.Scene.Sky.Model.Scattering.CubeMapCache.Size, i_Config.Scene.Sky.Model.Scattering.CubeMapCache.SunAngleThreshold, i_Config.TexUnit.Sky.ScatteringSkyModel.CubeMapCache);
+		// the caches bind their cubemap before every draw, so they share the texture unit
+		m_ReflCubeMapCache.Initialize("ScatteringSkyModel Reflection", i_Config, i_Config.Scene.Sky.Model.Scattering.CubeMapCache.Size, i_Config.Scene.Sky.Model.Scattering.CubeMapCache.SunAngleThreshold, i_Config.TexUnit.Sky.ScatteringSkyModel.CubeMapCache);
+	}
+
+	//// Setup Sky View LUT
+	// the sky shaders are built with the SKY_VIEW_LUT define (check GlobalConfig::ShaderDefines)
+	m_IsSkyViewLUTEnabled = i_Config.Scene.Sky.Model.Scattering.SkyViewLUT.Enabled;
+	if (m_IsSkyViewLUTEnabled)
+	{
+		SetupSkyViewLUT(i_Config);
+	}
 
 	LOG("ScatteringSkyModel successfully created!");
 }
 
 void ScatteringSkyModel::SetupSkyShaders ( const GlobalConfig& i_Config, std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& o_Attributes )
 {
-	float Kr4PI = 4.0f * glm::pi<float>() * i_Config.Scene.Sky.Model.Scattering.Atmosphere.RayleighScatteringConstant;
-	float Km4PI = 4.0f * glm::pi<float>() * i_Config.Scene.Sky.Model.Scattering.Atmosphere.MieScatteringConstant;
-	float KrESun = i_Config.Scene.Sky.Model.Scattering.Atmosphere.RayleighScatteringConstant * i_Config.Scene.Sky.Model.Scattering.Atmosphere.SunBrightnessConstant;
-	float KmESun = i_Config.Scene.Sky.Model.Scattering.Atmosphere.MieScatteringConstant * i_Config.Scene.Sky.Model.Scattering.Atmosphere.SunBrightnessConstant;
-
 	float g = - 0.1f * PhysicsConstants::kG;
 
-	float scaleDepth = i_Config.Scene.Sky.Model.Scattering.Atmosphere.OuterRadius - i_Config.Scene.Sky.Model.Scattering.Atmosphere.InnerRadius;
-	float scale = 1.0f / scaleDepth;
-	float scaleOverScaleDepth = scale / scaleDepth;
-
-	glm::vec3 wavelength4;
-	wavelength4.x = glm::pow(i_Config.Scene.Sky.Model.Scattering.Atmosphere.WaveLength.x, 4.0f);
-	wavelength4.y = glm::pow(i_Config.Scene.Sky.Model.Scattering.Atmosphere.WaveLength.y, 4.0f);
-	wavelength4.z = glm::pow(i_Config.Scene.Sky.Model.Scattering.Atmosphere.WaveLength.z, 4.0f);
-
 	m_SM.Initialize("ScatteringSkyModel");
 	m_SM.BuildRenderingProgram("resources/shaders/ScatteringSkyModel.vert.glsl", "resources/shaders/ScatteringSkyModel.frag.glsl", i_Config);
 
@@ -116,34 +193,15 @@ void ScatteringSkyModel::SetupSkyShaders ( const GlobalConfig& i_Config, std::ma
 	m_Uniforms["u_SunDirection"] = m_SM.GetUniformLocation("u_SunDirection");
 	SetSunDirection(i_Config.Scene.Sky.Model.Scattering.Sun.InitialPhi, i_Config.Scene.Sky.Model.Scattering.Sun.InitialTheta);
 
-	m_Uniforms["u_ScatteringData.SampleCount"] = m_SM.GetUniformLocation("u_ScatteringData.SampleCount");
-	m_SM.SetUniform(m_Uniforms.find("u_ScatteringData.SampleCount")->second, i_Config.Scene.Sky.Model.Scattering.Atmosphere.SampleCount);
-	m_Uniforms["u_ScatteringData.EarthRadius"] = m_SM.GetUniformLocation("u_ScatteringData.EarthRadius");
-	m_SM.SetUniform(m_Uniforms.find("u_ScatteringData.EarthRadius")->second, PhysicsConstants::kEarthRadius);
-	m_Uniforms["u_ScatteringData.InvWavelength"] = m_SM.GetUniformLocation("u_ScatteringData.InvWavelength");
-	m_SM.SetUniform(m_Uniforms.find("u_ScatteringData.InvWavelength")->second, 1, glm::value_ptr(1.0f / wavelength4), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
-	m_Uniforms["u_ScatteringData.InnerRadius"] = m_SM.GetUniformLocation("u_ScatteringData.InnerRadius");
-	m_SM.SetUniform(m_Uniforms.find("u_ScatteringData.InnerRadius")->second, i_Config.Scene.Sky.Model.Scattering.Atmosphere.InnerRadius);
-	m_Uniforms["u_ScatteringData.KrESun"] = m_SM.GetUniformLocation("u_ScatteringData.KrESun");
-	m_SM.SetUniform(m_Uniforms.find("u_ScatteringData.KrESun")->second, KrESun);
-	m_Uniforms["u_ScatteringData.KmESun"] = m_SM.GetUniformLocation("u_ScatteringData.KmESun");
-	m_SM.SetUniform(m_Uniforms.find("u_ScatteringData.KmESun")->second, KmESun);
-	m_Uniforms["u_ScatteringData.Kr4PI"] = m_SM.GetUniformLocation("u_ScatteringData.Kr4PI");
-	m_SM.SetUniform(m_Uniforms.find("u_ScatteringData.Kr4PI")->second, Kr4PI);
-	m_Uniforms["u_ScatteringData.Km4PI"] = m_SM.GetUniformLocation("u_ScatteringData.Km4PI");
-	m_SM.SetUniform(m_Uniforms.find("u_ScatteringData.Km4PI")->second, Km4PI);
-	m_Uniforms["u_ScatteringData.Scale"] = m_SM.GetUniformLocation("u_ScatteringData.Scale");
-	m_SM.SetUniform(m_Uniforms.find("u_ScatteringData.Scale")->second, scale);
-	m_Uniforms["u_ScatteringData.ScaleDepth"] = m_SM.GetUniformLocation("u_ScatteringData.ScaleDepth");
-	m_SM.SetUniform(m_Uniforms.find("u_ScatteringData.ScaleDepth")->second, scaleDepth);
-	m_Uniforms["u_ScatteringData.ScaleOverScaleDepth"] = m_SM.GetUniformLocation("u_ScatteringData.ScaleOverScaleDepth");
-	m_SM.SetUniform(m_Uniforms.find("u_ScatteringData.ScaleOverScaleDepth")->second, scaleOverScaleDepth);
+	SetScatteringDataUniforms(m_SM, i_Config);
 
 	m_Uniforms["u_g"] = m_SM.GetUniformLocation("u_g");
 	m_SM.SetUniform(m_Uniforms.find("u_g")->second, g);
 	m_Uniforms["u_yOffset"] = m_SM.GetUniformLocation("u_yOffset");
 	m_SM.SetUniform(m_Uniforms.find("u_yOffset")->second, i_Config.Scene.Sky.Model.Scattering.Atmosphere.AltitudeOffset);
 
+	m_Handles.Initialize(m_SM, m_kUniformHandleNames);
+
 	m_SM.UnUseProgram();
 }
 
@@ -167,15 +225,21 @@ void ScatteringSkyModel::SetupCloudsShaders ( const GlobalConfig& i_Config, std:
 
 	m_CloudsUniforms["u_SunDirY"] = m_CloudsSM.GetUniformLocation("u_SunDirY");
 
-	m_CloudsUniforms["u_CloudsData.Octaves"] = m_CloudsSM.GetUniformLocation("u_CloudsData.Octaves");
-	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Octaves")->second, m_CloudsData.Octaves);
-	m_CloudsUniforms["u_CloudsData.Lacunarity"] = m_CloudsSM.GetUniformLocation("u_CloudsData.Lacunarity");
-	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Lacunarity")->second, m_CloudsData.Lacunarity);
-	m_CloudsUniforms["u_CloudsData.Gain"] = m_CloudsSM.GetUniformLocation("u_CloudsData.Gain");
-	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Gain")->second, m_CloudsData.Gain);
+	m_CloudsUniforms["u_CloudsData.NoiseMap"] = m_CloudsSM.GetUniformLocation("u_CloudsData.NoiseMap");
+	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.NoiseMap")->second, i_Config.TexUnit.Sky.ScatteringSkyModel.CloudsNoiseMap);
+
+	// set by UpdateCloudsNoise()
+	m_CloudsUniforms["u_CloudsData.GroupCount"] = m_CloudsSM.GetUniformLocation("u_CloudsData.GroupCount");
+	m_CloudsUniforms["u_CloudsData.GroupMatrix"] = m_CloudsSM.GetUniformLocation("u_CloudsData.GroupMatrix");
+	m_CloudsUniforms["u_CloudsData.GroupGain"] = m_CloudsSM.GetUniformLocation("u_CloudsData.GroupGain");
+	m_CloudsUniforms["u_CloudsData.Amplitude"] = m_CloudsSM.GetUniformLocation("u_CloudsData.Amplitude");
+	m_CloudsUniforms["u_CloudsData.NoiseTileScale"] = m_CloudsSM.GetUniformLocation("u_CloudsData.NoiseTileScale");
+
 	m_CloudsUniforms["u_CloudsData.ScaleFactor"] = m_CloudsSM.GetUniformLocation("u_CloudsData.ScaleFactor");
 	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.ScaleFactor")->second, m_CloudsData.ScaleFactor);
 
+	m_CloudsHandles.Initialize(m_CloudsSM, m_kUniformHandleNames);
+
 	m_CloudsSM.UnUseProgram();
 }
 
@@ -254,6 +318,57 @@ void ScatteringSkyModel::SetupCloudsGeometry ( const GlobalConfig& i_Config, con
 
 	m_CloudsMBM.Initialize("ScatteringSkyModel Clouds");
 	m_CloudsMBM.CreateModelContext(cloudVertexData, i_Attributes, MeshBufferManager::ACCESS_TYPE::AT_STATIC);
+
+	// the upsampler draws the clouds plane again, at full resolution
+	m_IsCloudsUpsamplingEnabled = i_Config.Scene.Sky.Model.Scattering.Clouds.Upsampling.Enabled;
+	if (m_IsCloudsUpsamplingEnabled)
+	{
+		m_CloudsUpsampler.Initialize("ScatteringSkyModel", i_Config, "resources/shaders/ScatteringSkyModelClouds.vert.glsl", cloudVertexData, i_Config.Scene.Sky.Model.Scattering.Clouds.Upsampling.ResolutionScale, i_Config.TexUnit.Sky.ScatteringSkyModel.CloudsLowResMap, i_Config.TexUnit.Sky.ScatteringSkyModel.CloudsLowResDepthMap);
+	}
+}
+
+void ScatteringSkyModel::SetupCloudsNoise ( const GlobalConfig& i_Config )
+{
+	// the simplex noise is not periodic, so the tileable noise.pgm is the base noise, the octaves are not rotated
+	if (! m_CloudsNoiseGenerator.Initialize("ScatteringSkyModel Clouds", "resources/textures/noise.pgm", i_Config.Scene.Sky.Model.Scattering.Clouds.NoiseBake.Size, i_Config.Scene.Sky.Model.Scattering.Clouds.NoiseBake.OctavesPerGroup, 0.0f, i_Config.Scene.Sky.Model.Scattering.Clouds.NoiseBake.ThreadCount))
+	{
+		return;
+	}
+
+	unsigned short size = m_CloudsNoiseGenerator.GetSize();
+
+	m_CloudsTM.Initialize("ScatteringSkyModel Clouds", i_Config);
+	m_CloudsNoiseTexId = m_CloudsTM.Create2DArrayTexture(CloudsNoiseGenerator::m_kLayerCount, GL_R16F, GL_RED, GL_FLOAT, size, size, GL_REPEAT, GL_LINEAR, nullptr, i_Config.TexUnit.Sky.ScatteringSkyModel.CloudsNoiseMap, 0, true);
+
+	UpdateCloudsNoise();
+}
+
+void ScatteringSkyModel::UpdateCloudsNoise ( void )
+{
+	if (m_CloudsNoiseTexId == 0)
+	{
+		return;
+	}
+
+	// the shader used to sum up Octaves + 1 octaves
+	m_CloudsNoiseGenerator.Generate(m_CloudsData.Octaves + 1, m_CloudsData.Lacunarity, m_CloudsData.Gain);
+	m_CloudsTM.Update2DArrayTextureData(m_CloudsNoiseTexId, const_cast<float*>(m_CloudsNoiseGenerator.GetData()));
+
+	// the same normalization as before: 1 + the weights of all the octaves but the last one
+	float amplitude = 1.0f;
+	float weight = 1.0f;
+	for (unsigned short i = 0; i < m_CloudsData.Octaves; ++i)
+	{
+		amplitude += weight;
+		weight *= m_CloudsData.Gain;
+	}
+
+	m_CloudsSM.UseProgram();
+	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.GroupCount")->second, m_CloudsNoiseGenerator.GetGroupCount());
+	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.GroupMatrix")->second, 1, glm::value_ptr(m_CloudsNoiseGenerator.GetGroupMatrix()), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_2);
+	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.GroupGain")->second, m_CloudsNoiseGenerator.GetGroupGain());
+	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Amplitude")->second, 1.0f / amplitude);
+	m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.NoiseTileScale")->second, 1.0f / m_CloudsNoiseGenerator.GetNoiseCellCount());
 }
 
 void ScatteringSkyModel::Update ( const Camera& i_Camera, bool i_IsUnderWater, bool i_IsWireframeMode, float i_CrrTime )
@@ -278,42 +393,209 @@ void ScatteringSkyModel::UpdateInternal ( const glm::mat4& i_ModelMatrix, bool i
 	BaseSkyModel::UpdateSunPosition(i_CrrTime);
 
 	////////////////////////////
-	// remove the translation matrix from the view matrix
-	glm::mat4 PV = i_Camera.GetProjectionMatrix() * glm::mat4(glm::mat3(i_Camera.GetViewMatrix()));
+	glm::mat4 PV = ComputeSkyWorldToClipMatrix(i_Camera);
 
-	glm::vec3 vecCamera = i_Camera.GetPosition();
-	vecCamera /= PhysicsConstants::kEarthRadius;
-	vecCamera.y += m_AtmosphereInnerRadius;
-	vecCamera.x = 0;
-	vecCamera.z = 0;
+	glm::vec3 vecCamera = ComputeCameraPosition(i_Camera);
 
+	if (m_IsSkyViewLUTEnabled)
+	{
+		UpdateSkyViewLUT(vecCamera);
+	}
+
+	if (m_IsCubeMapCached)
+	{
+		m_IsReflCubeMapCacheUsed = i_IsReflMode;
+
+		SkyCubeMapCache& cubeMapCache = (i_IsReflMode ? m_ReflCubeMapCache : m_CubeMapCache);
+
+		UpdateCubeMapCache(cubeMapCache, vecCamera, i_Camera.GetAltitude(), i_IsReflMode, i_CrrTime);
+
+		cubeMapCache.SetViewData(PV, &i_ModelMatrix, 1, 0, i_ApplyHDR, i_IsWireframeMode);
+	}
+	else
+	{
+		UpdateScatteringData(PV, i_ModelMatrix, i_ApplyHDR, vecCamera, i_IsReflMode, i_IsUnderWater);
+	}
+}
+
+void ScatteringSkyModel::UpdateScatteringData ( const glm::mat4& i_WorldToClipMatrix, const glm::mat4& i_ModelMatrix, bool i_ApplyHDR, const glm::vec3& i_CameraPosition, bool i_IsReflMode, bool i_IsUnderWater )
+{
 	////////// SKY ///////
 	m_SM.UseProgram();
-	m_SM.SetUniform(m_Uniforms.find("u_ApplyHDR")->second, i_ApplyHDR);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_LAYERED], false);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_APPLY_HDR], i_ApplyHDR);
 
-	m_SM.SetUniform(m_Uniforms.find("u_CameraPosition")->second, 1, glm::value_ptr(vecCamera), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_CAMERA_POSITION], 1, glm::value_ptr(i_CameraPosition), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
 
-	m_SM.SetUniform(m_Uniforms.find("u_IsReflMode")->second, i_IsReflMode);
-	m_SM.SetUniform(m_Uniforms.find("u_IsUnderWater")->second, i_IsUnderWater);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_REFL_MODE], i_IsReflMode);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_UNDER_WATER], i_IsUnderWater);
 
-	m_SM.SetUniform(m_Uniforms.find("u_WorldToClipMatrix")->second, 1, glm::value_ptr(PV), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-	m_SM.SetUniform(m_Uniforms.find("u_ObjectToWorldMatrix")->second, 1, glm::value_ptr(i_ModelMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_WORLD_TO_CLIP_MATRIX], 1, glm::value_ptr(i_WorldToClipMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_OBJECT_TO_WORLD_MATRIX], 1, glm::value_ptr(i_ModelMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 
 	///////// CLOUDS /////////
 	if (m_AreCloudsEnabled)
 	{
 		m_CloudsSM.UseProgram();
-		m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_ApplyHDR")->second, i_ApplyHDR);
-		m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_SunDirY")->second, m_SunData.Direction.y);
+		m_CloudsSM.SetUniform(m_CloudsHandles[UNIFORM_HANDLE::UH_IS_LAYERED], false);
+		m_CloudsSM.SetUniform(m_CloudsHandles[UNIFORM_HANDLE::UH_APPLY_HDR], i_ApplyHDR);
+		m_CloudsSM.SetUniform(m_CloudsHandles[UNIFORM_HANDLE::UH_SUN_DIR_Y], m_SunData.Direction.y);
+
+		m_CloudsSM.SetUniform(m_CloudsHandles[UNIFORM_HANDLE::UH_WORLD_TO_CLIP_MATRIX], 1, glm::value_ptr(i_WorldToClipMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+		m_CloudsSM.SetUniform(m_CloudsHandles[UNIFORM_HANDLE::UH_OBJECT_TO_WORLD_MATRIX], 1, glm::value_ptr(i_ModelMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
 
-		m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_WorldToClipMatrix")->second, 1, glm::value_ptr(PV), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
-		m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_ObjectToWorldMatrix")->second, 1, glm::value_ptr(i_ModelMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+		// only the main view is upsampled, it is updated last
+		if (m_IsCloudsUpsamplingEnabled)
+		{
+			m_CloudsUpsampler.SetViewData(i_WorldToClipMatrix, i_ModelMatrix);
+		}
 	}
 }
 
+glm::vec3 ScatteringSkyModel::ComputeCameraPosition ( const Camera& i_Camera ) const
+{
+	glm::vec3 vecCamera = i_Camera.GetPosition();
+	vecCamera /= PhysicsConstants::kEarthRadius;
+	vecCamera.y += m_AtmosphereInnerRadius;
+	vecCamera.x = 0;
+	vecCamera.z = 0;
+
+	return vecCamera;
+}
+
+void ScatteringSkyModel::UpdateCubeMapCache ( SkyCubeMapCache& io_CubeMapCache, const glm::vec3& i_CameraPosition, float i_CameraAltitude, bool i_IsReflMode, float i_CrrTime )
+{
+	io_CubeMapCache.Update(m_SunData.Direction, i_CameraAltitude, m_SunData.IsDynamic, i_CrrTime);
+
+	// the faces are always filled, the wireframe mode is applied to the cached sky (check SkyCubeMapCache::SetViewData())
+	m_IsWireframeMode = false;
+
+	for (unsigned short i = 0; i < SkyCubeMapCache::m_kFaceCount; ++i)
+	{
+		if (io_CubeMapCache.IsFaceUpdateNeeded(i))
+		{
+			UpdateScatteringData(io_CubeMapCache.GetFaceWorldToClipMatrix(i), glm::mat4(1.0f), false, i_CameraPosition, i_IsReflMode, false);
+
+			io_CubeMapCache.BeginFaceUpdate(i);
+			RenderScattering();
+			io_CubeMapCache.EndFaceUpdate();
+		}
+	}
+}
+
+void ScatteringSkyModel::InvalidateCubeMapCaches ( void )
+{
+	m_CubeMapCache.Invalidate();
+	m_ReflCubeMapCache.Invalidate();
+}
+
+void ScatteringSkyModel::SetupSkyViewLUT ( const GlobalConfig& i_Config )
+{
+	m_SkyViewLUTWidth = i_Config.Scene.Sky.Model.Scattering.SkyViewLUT.Width;
+	m_SkyViewLUTHeight = i_Config.Scene.Sky.Model.Scattering.SkyViewLUT.Height;
+
+	float innerRadius = i_Config.Scene.Sky.Model.Scattering.Atmosphere.InnerRadius;
+	float altitudeOffset = i_Config.Scene.Sky.Model.Scattering.Atmosphere.AltitudeOffset;
+
+	// the heights of the sample points, from the lowest sky dome point above the sea up to the zenith of the sky dome (the atmosphere units)
+	// the camera altitude is small enough, higher samples have no optical depth left anyway
+	float offset = altitudeOffset / PhysicsConstants::kEarthRadius;
+	glm::vec2 transmittanceHeightRange(innerRadius + glm::min(offset, 0.0f), innerRadius + 1.0f + glm::max(offset, 0.0f));
+
+	// the elevation of the sky dome points at the sea level, the elevations between it and the horizon get half of the sky view rows
+	// (the points below the sea level are never seen)
+	float minElevation = glm::atan(glm::min(altitudeOffset, -1.0f), PhysicsConstants::kEarthRadius);
+
+	//// Transmittance LUT, it only depends on the atmosphere so it is computed once
+	std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int> transmittanceAttributes;
+
+	m_TransmittanceLUTSM.Initialize("ScatteringSkyModel Transmittance LUT");
+	m_TransmittanceLUTSM.BuildRenderingProgram("resources/shaders/Quad.vert.glsl", "resources/shaders/ScatteringSkyModelTransmittanceLUT.frag.glsl", i_Config);
+
+	m_TransmittanceLUTSM.UseProgram();
+
+	transmittanceAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_TransmittanceLUTSM.GetAttributeLocation("a_position");
+	transmittanceAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_UV] = m_TransmittanceLUTSM.GetAttributeLocation("a_uv");
+
+	SetScatteringDataUniforms(m_TransmittanceLUTSM, i_Config);
+	m_TransmittanceLUTSM.SetUniform(m_TransmittanceLUTSM.GetUniformLocation("u_HeightRange"), 1, glm::value_ptr(transmittanceHeightRange), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_2);
+
+	m_TransmittanceLUTSM.UnUseProgram();
+
+	m_TransmittanceLUTFBM.Initialize("ScatteringSkyModel Transmittance LUT", i_Config);
+	m_TransmittanceLUTFBM.CreateSimple(transmittanceAttributes, 1, GL_RGB16F, GL_RGB, GL_FLOAT, kTransmittanceLUTWidth, kTransmittanceLUTHeight, GL_CLAMP_TO_EDGE, GL_LINEAR, i_Config.TexUnit.Sky.ScatteringSkyModel.TransmittanceLUT, -1, false);
+
+	RenderToLUT(m_TransmittanceLUTFBM, m_TransmittanceLUTSM, kTransmittanceLUTWidth, kTransmittanceLUTHeight);
+
+	//// Sky View LUT
+	std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int> skyViewAttributes;
+
+	m_SkyViewLUTSM.Initialize("ScatteringSkyModel Sky View LUT");
+	m_SkyViewLUTSM.BuildRenderingProgram("resources/shaders/Quad.vert.glsl", "resources/shaders/ScatteringSkyModelSkyViewLUT.frag.glsl", i_Config);
+
+	m_SkyViewLUTSM.UseProgram();
+
+	skyViewAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_SkyViewLUTSM.GetAttributeLocation("a_position");
+	skyViewAttributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_UV] = m_SkyViewLUTSM.GetAttributeLocation("a_uv");
+
+	SetScatteringDataUniforms(m_SkyViewLUTSM, i_Config);
+	m_SkyViewLUTSM.SetUniform(m_SkyViewLUTSM.GetUniformLocation("u_TransmittanceLUT"), i_Config.TexUnit.Sky.ScatteringSkyModel.TransmittanceLUT);
+	m_SkyViewLUTSM.SetUniform(m_SkyViewLUTSM.GetUniformLocation("u_TransmittanceHeightRange"), 1, glm::value_ptr(transmittanceHeightRange), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_2);
+	m_SkyViewLUTSM.SetUniform(m_SkyViewLUTSM.GetUniformLocation("u_MinElevation"), minElevation);
+	m_SkyViewLUTSM.SetUniform(m_SkyViewLUTSM.GetUniformLocation("u_yOffset"), altitudeOffset);
+
+	m_SkyViewLUTHandles.Initialize(m_SkyViewLUTSM, m_kUniformHandleNames);
+
+	m_SkyViewLUTSM.UnUseProgram();
+
+	// the azimuth wraps around, the sky shader keeps the elevation inside the table
+	m_SkyViewLUTFBM.Initialize("ScatteringSkyModel Sky View LUT", i_Config);
+	m_SkyViewLUTFBM.CreateSimple(skyViewAttributes, 1, GL_RGB16F, GL_RGB, GL_FLOAT, m_SkyViewLUTWidth, m_SkyViewLUTHeight, GL_REPEAT, GL_LINEAR, i_Config.TexUnit.Sky.ScatteringSkyModel.SkyViewLUT, -1, false);
+
+	//// Sky
+	// the Mie color is proportional to the Rayleigh color: KmESun / (InvWavelength * KrESun)
+	glm::vec3 wavelength4 = ComputeWavelength4(i_Config);
+	glm::vec3 mieOverRayleigh = wavelength4 * (i_Config.Scene.Sky.Model.Scattering.Atmosphere.MieScatteringConstant / i_Config.Scene.Sky.Model.Scattering.Atmosphere.RayleighScatteringConstant);
+
+	glm::vec2 skyViewLUTRowRange(0.5f / m_SkyViewLUTHeight, 1.0f - 0.5f / m_SkyViewLUTHeight);
+
+	m_SM.UseProgram();
+
+	m_Uniforms["u_SkyViewLUT"] = m_SM.GetUniformLocation("u_SkyViewLUT");
+	m_SM.SetUniform(m_Uniforms.find("u_SkyViewLUT")->second, i_Config.TexUnit.Sky.ScatteringSkyModel.SkyViewLUT);
+	m_Uniforms["u_MieOverRayleigh"] = m_SM.GetUniformLocation("u_MieOverRayleigh");
+	m_SM.SetUniform(m_Uniforms.find("u_MieOverRayleigh")->second, 1, glm::value_ptr(mieOverRayleigh), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+	m_Uniforms["u_MinElevation"] = m_SM.GetUniformLocation("u_MinElevation");
+	m_SM.SetUniform(m_Uniforms.find("u_MinElevation")->second, minElevation);
+	m_Uniforms["u_SkyViewLUTRowRange"] = m_SM.GetUniformLocation("u_SkyViewLUTRowRange");
+	m_SM.SetUniform(m_Uniforms.find("u_SkyViewLUTRowRange")->second, 1, glm::value_ptr(skyViewLUTRowRange), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_2);
+
+	m_SM.UnUseProgram();
+}
+
+void ScatteringSkyModel::UpdateSkyViewLUT ( const glm::vec3& i_CameraPosition )
+{
+	// the sky model is updated several times per frame, but the sky view only depends on the sun direction and on the camera altitude
+	if (m_SunData.Direction == m_SkyViewLUTSunDirection && i_CameraPosition.y == m_SkyViewLUTCameraHeight)
+	{
+		return;
+	}
+
+	m_SkyViewLUTSunDirection = m_SunData.Direction;
+	m_SkyViewLUTCameraHeight = i_CameraPosition.y;
+
+	m_SkyViewLUTSM.UseProgram();
+	m_SkyViewLUTSM.SetUniform(m_SkyViewLUTHandles[UNIFORM_HANDLE::UH_CAMERA_POSITION], 1, glm::value_ptr(i_CameraPosition), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+	m_SkyViewLUTSM.SetUniform(m_SkyViewLUTHandles[UNIFORM_HANDLE::UH_SUN_DIRECTION], 1, glm::value_ptr(m_SunData.Direction), ShaderManager::UNIFORM_TYPE::UT_FLOAT_VEC_3);
+
+	m_TransmittanceLUTFBM.BindColorAttachmentByIndex(0);
+
+	RenderToLUT(m_SkyViewLUTFBM, m_SkyViewLUTSM, m_SkyViewLUTWidth, m_SkyViewLUTHeight);
+}
+
 void ScatteringSkyModel::Render ( void )
 {
-	RenderInternal();
+	RenderInternal(1, true);
 }
 
 void ScatteringSkyModel::RenderReflected ( void )
@@ -332,15 +614,94 @@ void ScatteringSkyModel::RenderRefracted ( void )
 	RenderInternal();
 }
 
-void ScatteringSkyModel::RenderInternal ( void )
+bool ScatteringSkyModel::IsLayeredReflRefrSupported ( void ) const
+{
+	return true;
+}
+
+void ScatteringSkyModel::UpdateReflectedRefracted ( const glm::mat4& i_ReflScaleMatrix, const glm::mat4& i_RefrScaleMatrix, const Camera& i_Camera, bool i_IsWireframeMode, float i_CrrTime )
+{
+	// the layers share everything but the model matrix and the reflection mode
+	UpdateInternal(i_ReflScaleMatrix, false, i_Camera, true, false, i_IsWireframeMode, i_CrrTime);
+
+	// one value per layer (instance): 0 - reflection, 1 - refraction
+	glm::mat4 modelMatrices[2] = { i_ReflScaleMatrix, i_RefrScaleMatrix };
+
+	if (m_IsCubeMapCached)
+	{
+		// each cache renders its own layer (check RenderReflectedRefracted()), the reflection one is updated above
+		glm::mat4 PV = ComputeSkyWorldToClipMatrix(i_Camera);
+
+		m_ReflCubeMapCache.SetViewData(PV, modelMatrices, 2, 0, false, i_IsWireframeMode);
+
+		UpdateCubeMapCache(m_CubeMapCache, ComputeCameraPosition(i_Camera), i_Camera.GetAltitude(), false, i_CrrTime);
+		m_CubeMapCache.SetViewData(PV, modelMatrices, 2, 1, false, i_IsWireframeMode);
+
+		return;
+	}
+
+	int isReflMode[2] = { true, false };
+
+	m_SM.UseProgram();
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_LAYERED], true);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_REFL_MODE], 2, isReflMode);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_OBJECT_TO_WORLD_MATRIX], 2, glm::value_ptr(modelMatrices[0]), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+
+	if (m_AreCloudsEnabled)
+	{
+		m_CloudsSM.UseProgram();
+		m_CloudsSM.SetUniform(m_CloudsHandles[UNIFORM_HANDLE::UH_IS_LAYERED], true);
+		m_CloudsSM.SetUniform(m_CloudsHandles[UNIFORM_HANDLE::UH_OBJECT_TO_WORLD_MATRIX], 2, glm::value_ptr(modelMatrices[0]), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+	}
+}
+
+void ScatteringSkyModel::RenderReflectedRefracted ( void )
+{
+	// the face culling is disabled by the caller, the reflection instance has the winding reverted
+	if (m_IsCubeMapCached)
+	{
+		m_ReflCubeMapCache.Render(1);
+		m_CubeMapCache.Render(1);
+	}
+	else
+	{
+		RenderInternal(2);
+	}
+}
+
+void ScatteringSkyModel::RenderInternal ( unsigned short i_InstanceCount, bool i_IsMainView )
+{
+	if (m_IsCubeMapCached)
+	{
+		if (m_IsReflCubeMapCacheUsed)
+		{
+			m_ReflCubeMapCache.Render(i_InstanceCount);
+		}
+		else
+		{
+			m_CubeMapCache.Render(i_InstanceCount);
+		}
+	}
+	else
+	{
+		RenderScattering(i_InstanceCount, i_IsMainView);
+	}
+}
+
+void ScatteringSkyModel::RenderScattering ( unsigned short i_InstanceCount, bool i_IsMainView )
 {
 	glDepthFunc(GL_LEQUAL);
 
 	//////////// RENDER SKY /////////
 	m_SM.UseProgram();
-	
+
+	if (m_IsSkyViewLUTEnabled)
+	{
+		m_SkyViewLUTFBM.BindColorAttachmentByIndex(0);
+	}
+
 	m_MBM.BindModelContext();
-	glDrawElements(m_IsWireframeMode ? GL_LINES : GL_TRIANGLES, m_IndexCount, GL_UNSIGNED_INT, nullptr);
+	glDrawElementsInstanced(m_IsWireframeMode ? GL_LINES : GL_TRIANGLES, m_IndexCount, GL_UNSIGNED_INT, nullptr, i_InstanceCount);
 	m_MBM.UnBindModelContext();
 
 	glDepthFunc(GL_LESS);
@@ -348,19 +709,38 @@ void ScatteringSkyModel::RenderInternal ( void )
 	/////////// RENDER CLOUDS //////////
 	if (m_AreCloudsEnabled)
 	{
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glEnable(GL_BLEND);
+		if (i_IsMainView && m_IsCloudsUpsamplingEnabled && ! m_IsWireframeMode)
+		{
+			m_CloudsUpsampler.BeginLowResPass();
+			RenderClouds(i_InstanceCount);
+			m_CloudsUpsampler.EndLowResPass();
 
-		m_CloudsSM.UseProgram();
+			m_CloudsUpsampler.Render();
+		}
+		else
+		{
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			glEnable(GL_BLEND);
 
-		m_CloudsMBM.BindModelContext();
-		glDrawArrays(m_IsWireframeMode ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, 0, 4);
-		m_CloudsMBM.UnBindModelContext();
+			RenderClouds(i_InstanceCount);
 
-		glDisable(GL_BLEND);
+			glDisable(GL_BLEND);
+		}
 	}
 }
 
+void ScatteringSkyModel::RenderClouds ( unsigned short i_InstanceCount )
+{
+	m_CloudsSM.UseProgram();
+
+	// the mipmaps are generated again only after the noise was baked again
+	m_CloudsTM.BindTexture(m_CloudsNoiseTexId, true);
+
+	m_CloudsMBM.BindModelContext();
+	glDrawArraysInstanced(m_IsWireframeMode ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, 0, 4, i_InstanceCount);
+	m_CloudsMBM.UnBindModelContext();
+}
+
 void ScatteringSkyModel::SetSunDirection ( float i_Phi, float i_Theta )
 {
 	//////
@@ -373,6 +753,8 @@ void ScatteringSkyModel::SetSunDirection ( float i_Phi, float i_Theta )
 void ScatteringSkyModel::SetEnabledClouds ( bool i_Value )
 {
 	m_AreCloudsEnabled = i_Value;
+
+	InvalidateCubeMapCaches();
 }
 
 bool ScatteringSkyModel::GetEnabledClouds ( void ) const
@@ -386,8 +768,9 @@ void ScatteringSkyModel::SetCloudsOctaves ( unsigned short i_Octaves )
 	{
 		m_CloudsData.Octaves = i_Octaves;
 
-		m_CloudsSM.UseProgram();
-		m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Octaves")->second, m_CloudsData.Octaves);
+		UpdateCloudsNoise();
+
+		InvalidateCubeMapCaches();
 	}
 }
 
@@ -402,8 +785,9 @@ void ScatteringSkyModel::SetCloudsLacunarity ( float i_Lacunarity )
 	{
 		m_CloudsData.Lacunarity = i_Lacunarity;
 
-		m_CloudsSM.UseProgram();
-		m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Lacunarity")->second, m_CloudsData.Lacunarity);
+		UpdateCloudsNoise();
+
+		InvalidateCubeMapCaches();
 	}
 }
 
@@ -418,8 +802,9 @@ void ScatteringSkyModel::SetCloudsGain ( float i_Gain )
 	{
 		m_CloudsData.Gain = i_Gain;
 
-		m_CloudsSM.UseProgram();
-		m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.Gain")->second, m_CloudsData.Gain);
+		UpdateCloudsNoise();
+
+		InvalidateCubeMapCaches();
 	}
 }
 
@@ -436,6 +821,8 @@ void ScatteringSkyModel::SetCloudsScaleFactor ( float i_ScaleFactor )
 
 		m_CloudsSM.UseProgram();
 		m_CloudsSM.SetUniform(m_CloudsUniforms.find("u_CloudsData.ScaleFactor")->second, m_CloudsData.ScaleFactor);
+
+		InvalidateCubeMapCaches();
 	}
 }
 
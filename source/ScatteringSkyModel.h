@@ -13,6 +13,10 @@
 #include "glm/mat4x4.hpp"
 #include "Camera.h"
 #include "FrameBufferManager.h"
+#include "TextureManager.h"
+#include "SkyCubeMapCache.h"
+#include "CloudsNoiseGenerator.h"
+#include "CloudsUpsampler.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -44,6 +48,10 @@ public:
 	void RenderReflected(void) override;
 	void RenderRefracted(void) override;
 
+	bool IsLayeredReflRefrSupported(void) const override;
+	void UpdateReflectedRefracted(const glm::mat4& i_ReflScaleMatrix, const glm::mat4& i_RefrScaleMatrix, const Camera& i_Camera, bool i_IsWireframeMode, float i_CrrTime) override;
+	void RenderReflectedRefracted(void) override;
+
 	void SetSunDirection(float i_Phi, float i_Theta) override;
 
 	void SetEnabledClouds(bool i_Value) override;
@@ -65,19 +73,41 @@ private:
 
 	void SetupSkyGeometry(const GlobalConfig& i_Config, const std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& i_Attributes);
 	void SetupCloudsGeometry(const GlobalConfig& i_Config, const std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& i_Attributes);
+	void SetupCloudsNoise(const GlobalConfig& i_Config);
+
+	// bakes the octaves again, after the clouds parameters changed
+	void UpdateCloudsNoise(void);
 
 	void UpdateInternal(const glm::mat4& i_ModelMatrix, bool i_ApplyHDR, const Camera& i_Camera, bool i_IsReflMode, bool i_IsUnderWater, bool i_IsWireframeMode, float i_CrrTime);
-	void RenderInternal(void);
+	void UpdateScatteringData(const glm::mat4& i_WorldToClipMatrix, const glm::mat4& i_ModelMatrix, bool i_ApplyHDR, const glm::vec3& i_CameraPosition, bool i_IsReflMode, bool i_IsUnderWater);
+	// re-renders the faces selected by the cache, with the linear sky of the given mode
+	void UpdateCubeMapCache(SkyCubeMapCache& io_CubeMapCache, const glm::vec3& i_CameraPosition, float i_CameraAltitude, bool i_IsReflMode, float i_CrrTime);
+	// in Earth radius units, above the center of the Earth
+	glm::vec3 ComputeCameraPosition(const Camera& i_Camera) const;
+	void InvalidateCubeMapCaches(void);
+
+	void SetupSkyViewLUT(const GlobalConfig& i_Config);
+	// the sky view LUT is computed again only if the sun direction or the camera altitude changed
+	void UpdateSkyViewLUT(const glm::vec3& i_CameraPosition);
+
+	// the cached sky or the scattering sky
+	// i_IsMainView - the clouds are rendered at reduced resolution, if enabled
+	void RenderInternal(unsigned short i_InstanceCount = 1, bool i_IsMainView = false);
+	void RenderScattering(unsigned short i_InstanceCount = 1, bool i_IsMainView = false);
+	// no blending setup
+	void RenderClouds(unsigned short i_InstanceCount);
 
 	void Destroy(void);
 
 	//// Variables ////
 	ShaderManager m_CloudsSM;
 	MeshBufferManager m_CloudsMBM;
+	TextureManager m_CloudsTM;
 
 	// self init
 	// name, location
 	std::map<std::string, int> m_CloudsUniforms;
+	UniformHandles m_CloudsHandles;
 
 	float m_AtmosphereInnerRadius;
 
@@ -90,6 +120,37 @@ private:
 	} m_CloudsData;
 
 	bool m_AreCloudsEnabled;
+
+	// the fBm is baked on the CPU when the clouds parameters change
+	CloudsNoiseGenerator m_CloudsNoiseGenerator;
+	unsigned int m_CloudsNoiseTexId;
+
+	CloudsUpsampler m_CloudsUpsampler;
+	bool m_IsCloudsUpsamplingEnabled;
+
+	// the sky is rendered into a cubemap only when it changes (check SkyCubeMapCache.h)
+	SkyCubeMapCache m_CubeMapCache;
+	// the reflected sky keeps only the Rayleigh scattering, so it has its own cubemap
+	SkyCubeMapCache m_ReflCubeMapCache;
+	bool m_IsCubeMapCached;
+	// the reflection cubemap is rendered instead of the main one (set by the last update)
+	bool m_IsReflCubeMapCacheUsed;
+
+	// the sky colors are looked up per fragment instead of being scattered per vertex (check ScatteringSkyModelSkyViewLUT.frag.glsl)
+	ShaderManager m_TransmittanceLUTSM;
+	FrameBufferManager m_TransmittanceLUTFBM;
+
+	ShaderManager m_SkyViewLUTSM;
+	FrameBufferManager m_SkyViewLUTFBM;
+	UniformHandles m_SkyViewLUTHandles;
+
+	unsigned short m_SkyViewLUTWidth, m_SkyViewLUTHeight;
+
+	// the sun direction and the camera altitude of the last sky view LUT update
+	glm::vec3 m_SkyViewLUTSunDirection;
+	float m_SkyViewLUTCameraHeight;
+
+	bool m_IsSkyViewLUTEnabled;
 };
 
 #endif /* SCATTERING_SKY_MODEL_H */
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "GLConfig.h"
 #include "FileUtils.h"
 #include "GlobalConfig.h"
+#include "GLStateCache.h"
 #include <sstream>
 #include <cassert>
 #include <new>
@@ -12,7 +13,8 @@
 
 ShaderManager::ShaderManager ( void )
 	: m_Name("Default"), m_ShaderProgramID(0), m_VertexShaderID(0),
-	  m_GeometryShaderID(0), m_FragmentShaderID(0), m_ComputeShaderID(0),
+	  m_GeometryShaderID(0), m_TessControlShaderID(0), m_TessEvaluationShaderID(0),
+	  m_FragmentShaderID(0), m_ComputeShaderID(0),
 	  m_UseStrictVerification(false)
 {
 	LOG("Shader Manager [%s] successfully created!", m_Name.c_str());
@@ -20,7 +22,8 @@ ShaderManager::ShaderManager ( void )
 
 ShaderManager::ShaderManager ( const std::string &i_Name )
 	: m_ShaderProgramID(0), m_VertexShaderID(0),
-	  m_GeometryShaderID(0), m_FragmentShaderID(0), m_ComputeShaderID(0),
+	  m_GeometryShaderID(0), m_TessControlShaderID(0), m_TessEvaluationShaderID(0),
+	  m_FragmentShaderID(0), m_ComputeShaderID(0),
 	  m_UseStrictVerification(false)
 {
 	Initialize(i_Name);
@@ -40,7 +43,7 @@ void ShaderManager::Initialize ( const std::string &i_Name )
 
 void ShaderManager::Destroy ( void )
 {
-	glUseProgram(0);
+	GLStateCache::UseProgram(0);
 
 	if (m_ShaderProgramID)
 	{
@@ -58,6 +61,20 @@ void ShaderManager::Destroy ( void )
 			m_GeometryShaderID = 0;
 		}
 
+		if (m_TessControlShaderID)
+		{
+			glDetachShader(m_ShaderProgramID, m_TessControlShaderID);
+			glDeleteShader(m_TessControlShaderID);
+			m_TessControlShaderID = 0;
+		}
+
+		if (m_TessEvaluationShaderID)
+		{
+			glDetachShader(m_ShaderProgramID, m_TessEvaluationShaderID);
+			glDeleteShader(m_TessEvaluationShaderID);
+			m_TessEvaluationShaderID = 0;
+		}
+
 		if (m_FragmentShaderID)
 		{
 			glDetachShader(m_ShaderProgramID, m_FragmentShaderID);
@@ -73,6 +90,7 @@ void ShaderManager::Destroy ( void )
 		}
 
 		glDeleteProgram(m_ShaderProgramID);
+		GLStateCache::OnProgramDeleted(m_ShaderProgramID);
 		m_ShaderProgramID = 0;
 	}
 
@@ -115,6 +133,27 @@ void ShaderManager::BuildRenderingProgram ( const std::string& i_VertexFileName,
 	}
 }
 
+void ShaderManager::BuildRenderingProgram ( const std::string& i_VertexFileName, const std::string& i_TessControlFileName, const std::string& i_TessEvaluationFileName, const std::string& i_FragmentFileName, const GlobalConfig& i_Config )
+{
+	if (!i_Config.GLExtVars.IsTessellationShaderSupported)
+	{
+		ERR("Tessellation shaders not supported!");
+		return;
+	}
+
+	if (!CreateRenderingProgram(i_VertexFileName, i_TessControlFileName, i_TessEvaluationFileName, i_FragmentFileName, i_Config))
+	{
+		ERR("Rendering program creation failed!");
+		return;
+	}
+
+	if (!LinkProgram())
+	{
+		ERR("Rendering program linking failed!");
+		return;
+	}
+}
+
 void ShaderManager::BuildComputeProgram ( const std::string& i_ComputeFileName, const GlobalConfig& i_Config )
 {
 	if (!i_Config.GLExtVars.IsComputeShaderSupported)
@@ -199,6 +238,47 @@ bool ShaderManager::CreateRenderingProgram ( const std::string& i_VertexFileName
 	return true;
 }
 
+bool ShaderManager::CreateRenderingProgram ( const std::string& i_VertexFileName, const std::string& i_TessControlFileName, const std::string& i_TessEvaluationFileName, const std::string& i_FragmentFileName, const GlobalConfig& i_Config )
+{
+	if (i_VertexFileName.empty() || i_TessControlFileName.empty() || i_TessEvaluationFileName.empty() || i_FragmentFileName.empty())
+	{
+		ERR("Empty shader file name!");
+		return false;
+	}
+
+	if (!CreateShader(i_VertexFileName, GL_VERTEX_SHADER, i_Config))
+	{
+		ERR("Vertex shader %s creation failed!", i_VertexFileName.c_str());
+		return false;
+	}
+
+	if (!CreateShader(i_TessControlFileName, GL_TESS_CONTROL_SHADER, i_Config))
+	{
+		ERR("Tessellation control shader %s creation failed!", i_TessControlFileName.c_str());
+		return false;
+	}
+
+	if (!CreateShader(i_TessEvaluationFileName, GL_TESS_EVALUATION_SHADER, i_Config))
+	{
+		ERR("Tessellation evaluation shader %s creation failed!", i_TessEvaluationFileName.c_str());
+		return false;
+	}
+
+	if (!CreateShader(i_FragmentFileName, GL_FRAGMENT_SHADER, i_Config))
+	{
+		ERR("Fragment shader %s creation failed!", i_FragmentFileName.c_str());
+		return false;
+	}
+
+	m_ShaderProgramID = glCreateProgram();
+	glAttachShader(m_ShaderProgramID, m_VertexShaderID);
+	glAttachShader(m_ShaderProgramID, m_TessControlShaderID);
+	glAttachShader(m_ShaderProgramID, m_TessEvaluationShaderID);
+	glAttachShader(m_ShaderProgramID, m_FragmentShaderID);
+
+	return true;
+}
+
 bool ShaderManager::CreateComputeProgram ( const std::string& i_ComputeFileName, const GlobalConfig& i_Config )
 {
 	if (i_ComputeFileName.empty())
@@ -246,6 +326,10 @@ bool ShaderManager::CreateShader ( const std::string& i_ShaderFileName, unsigned
 
 		computeOptions = ss.str();
 	}
+	else if ((i_ShaderType == GL_TESS_CONTROL_SHADER || i_ShaderType == GL_TESS_EVALUATION_SHADER) && i_Config.GLExtVars.IsTessellationShaderSupported)
+	{
+		computeOptions = "#extension GL_ARB_tessellation_shader : require\n";
+	}
 	////
 	std::string optionsString = computeOptions + i_Config.ShaderDefines.GetOptionsString();
 
@@ -290,6 +374,14 @@ bool ShaderManager::CreateShader ( const std::string& i_ShaderFileName, unsigned
 		{
 			ERR("Geometry shader compile error:");
 		}
+		else if (i_ShaderType == GL_TESS_CONTROL_SHADER)
+		{
+			ERR("Tessellation control shader compile error:");
+		}
+		else if (i_ShaderType == GL_TESS_EVALUATION_SHADER)
+		{
+			ERR("Tessellation evaluation shader compile error:");
+		}
 		else if (i_ShaderType == GL_FRAGMENT_SHADER)
 		{
 			ERR("Fragment shader compile error:");
@@ -308,6 +400,8 @@ bool ShaderManager::CreateShader ( const std::string& i_ShaderFileName, unsigned
 
 	if (i_ShaderType == GL_VERTEX_SHADER) m_VertexShaderID = shaderID;
 	if (i_ShaderType == GL_GEOMETRY_SHADER) m_GeometryShaderID = shaderID;
+	if (i_ShaderType == GL_TESS_CONTROL_SHADER) m_TessControlShaderID = shaderID;
+	if (i_ShaderType == GL_TESS_EVALUATION_SHADER) m_TessEvaluationShaderID = shaderID;
 	if (i_ShaderType == GL_FRAGMENT_SHADER) m_FragmentShaderID = shaderID;
 	if (i_ShaderType == GL_COMPUTE_SHADER) m_ComputeShaderID = shaderID;
 
@@ -392,12 +486,13 @@ bool ShaderManager::LinkProgram ( void )
 
 void ShaderManager::UseProgram ( void ) const
 {
-	glUseProgram(m_ShaderProgramID);
+	GLStateCache::UseProgram(m_ShaderProgramID);
 }
 
 GLvoid ShaderManager::UnUseProgram ( void ) const
 {
-	glUseProgram(0);
+	// NOTE! The program is left in use, every uniform update and draw call is preceded by a UseProgram() call,
+	// so unbinding it would only make the next UseProgram() call of the same program a real GL call
 }
 
 unsigned int ShaderManager::GetProgramID ( void ) const
@@ -528,6 +623,38 @@ void ShaderManager::SetUniform ( int i_UniformLocation, int i_ValueCount, const
 
 }
 
+void ShaderManager::SetUniform ( int i_UniformLocation, int i_ValueCount, const int* i_pUniformValue ) const
+{
+	if (m_UseStrictVerification)
+	{
+		if (!m_ShaderProgramID)
+		{
+			ERR("Invalid program when setting uniform value!");
+			return;
+		}
+
+		if (i_UniformLocation == -1)
+		{
+			ERR("Uniform has a invalid location!");
+			return;
+		}
+
+		if (i_ValueCount <= 0)
+		{
+			ERR("Invalid value count!");
+			return;
+		}
+
+		if (!i_pUniformValue)
+		{
+			ERR("Invalid uniform value!");
+			return;
+		}
+	}
+
+	glUniform1iv(i_UniformLocation, i_ValueCount, i_pUniformValue);
+}
+
 void ShaderManager::SetupFragmentOutputStreams ( unsigned short i_LayerCount, unsigned short i_Stride ) const
 {
 	// setup output streams for fragment shader
@@ -541,4 +668,18 @@ void ShaderManager::SetupFragmentOutputStreams ( unsigned short i_LayerCount, un
 			glBindFragDataLocation(m_ShaderProgramID, i_Stride + i, outputColor.c_str());
 		}
 	}
+}
+
+void ShaderManager::BindUniformBlock ( const char* i_pBlockName, unsigned int i_BindingPoint ) const
+{
+	if (m_ShaderProgramID > 0 && i_pBlockName)
+	{
+		unsigned int blockIndex = glGetUniformBlockIndex(m_ShaderProgramID, i_pBlockName);
+
+		// the block might be unused by all the program stages
+		if (blockIndex != GL_INVALID_INDEX)
+		{
+			glUniformBlockBinding(m_ShaderProgramID, blockIndex, i_BindingPoint);
+		}
+	}
 }
\ No newline at end of file
@@ -12,6 +12,9 @@ class GlobalConfig;
  Manager for shader programs
  Can load: verte, geoemtry, tesselation, compute and fragment shaders
  Working with transform fedback is also possible!
+
+ The uniforms set every frame should use compile time handles (check UniformHandleTable) or uniform blocks (check UniformBufferManager),
+ the std::map<std::string, int> lookups are meant only for the setup code.
 */
 
 class ShaderManager
@@ -28,6 +31,38 @@ public:
 		UT_COUNT
 	};
 
+	// Compile time uniform handles
+	// The handles are the values of an enum class (0 .. N - 1), the uniform locations are looked up by name only once (Initialize()),
+	// so setting a uniform is an array access. The names missing from the program get the -1 location.
+	template <typename T, unsigned short N>
+	class UniformHandleTable
+	{
+	public:
+		UniformHandleTable(void)
+		{
+			for (unsigned short i = 0; i < N; ++i)
+			{
+				m_Locations[i] = -1;
+			}
+		}
+
+		void Initialize(const ShaderManager& i_SM, const char* const (&i_pUniformNames)[N])
+		{
+			for (unsigned short i = 0; i < N; ++i)
+			{
+				m_Locations[i] = (i_pUniformNames[i] ? i_SM.GetUniformLocation(i_pUniformNames[i]) : -1);
+			}
+		}
+
+		int operator[] (T i_Handle) const
+		{
+			return m_Locations[static_cast<unsigned short>(i_Handle)];
+		}
+
+	private:
+		int m_Locations[N];
+	};
+
 	//// Methods ////
 	ShaderManager(void);
 	ShaderManager(const std::string& i_Name);
@@ -37,9 +72,12 @@ public:
 
 	void BuildRenderingProgram(const std::string& i_VertexFileName, const std::string& i_FragmentFileName, const GlobalConfig& i_Config);
 	void BuildRenderingProgram(const std::string& i_VertexFileName, const std::string& i_GeometryFileName, const std::string& i_FragmentFileName, const GlobalConfig& i_Config);
+	void BuildRenderingProgram(const std::string& i_VertexFileName, const std::string& i_TessControlFileName, const std::string& i_TessEvaluationFileName, const std::string& i_FragmentFileName, const GlobalConfig& i_Config);
 	void BuildComputeProgram(const std::string& i_ComputeFileName, const GlobalConfig& i_Config);
 
+	// NOTE! the program is used through GLStateCache, so using the current program again costs no GL call
 	void UseProgram(void) const;
+	// the program is NOT unbound (check the definition)
 	void UnUseProgram(void) const;
 
 	unsigned int GetProgramID(void) const;
@@ -49,13 +87,19 @@ public:
 	void SetUniform(int i_UniformLocation, int i_UniformValue) const;
 	void SetUniform(int i_UniformLocation, float i_UniformValue) const;
 	void SetUniform(int i_UniformLocation, int i_ValueCount, const float* i_pUniformValue, ShaderManager::UNIFORM_TYPE i_UniformType) const;
+	// int and bool arrays
+	void SetUniform(int i_UniformLocation, int i_ValueCount, const int* i_pUniformValue) const;
 
 	void SetupFragmentOutputStreams(unsigned short i_LayerCount, unsigned short i_Stride) const;
 
+	// binds the uniform block to the binding point (check UniformBufferManager), nothing happens if the program doesn't use the block
+	void BindUniformBlock(const char* i_pBlockName, unsigned int i_BindingPoint) const;
+
 private:
 	//// Methods ////
 	bool CreateRenderingProgram(const std::string& i_VertexFileName, const std::string& i_FragmentFileName, const GlobalConfig& i_Config);
 	bool CreateRenderingProgram(const std::string& i_VertexFileName, const std::string& i_GeometryFileName, const std::string& i_FragmentFileName, const GlobalConfig& i_Config);
+	bool CreateRenderingProgram(const std::string& i_VertexFileName, const std::string& i_TessControlFileName, const std::string& i_TessEvaluationFileName, const std::string& i_FragmentFileName, const GlobalConfig& i_Config);
 	bool CreateComputeProgram(const std::string& i_ComputeFileName, const GlobalConfig& i_Config);
 
 	bool CreateShader(const std::string& i_ShaderFileName, unsigned int i_ShaderType, const GlobalConfig& i_Config);
@@ -69,6 +113,8 @@ private:
 	unsigned int m_ShaderProgramID;
 	unsigned int m_VertexShaderID;
 	unsigned int m_GeometryShaderID; // since OpenGL 3.2, better in 4.1
+	unsigned int m_TessControlShaderID; // since OpenGL 4.0
+	unsigned int m_TessEvaluationShaderID; // since OpenGL 4.0
 	unsigned int m_FragmentShaderID;
 	unsigned int m_ComputeShaderID; // since OpenGL 4.3
 
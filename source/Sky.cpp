@@ -105,6 +105,27 @@ void Sky::RenderRefracted ( void )
 	}
 }
 
+bool Sky::IsLayeredReflRefrSupported ( void ) const
+{
+	return (m_pSkyModel && m_pSkyModel->IsLayeredReflRefrSupported());
+}
+
+void Sky::UpdateReflectedRefracted ( const glm::mat4& i_ReflScaleMatrix, const glm::mat4& i_RefrScaleMatrix, const Camera& i_Camera, bool i_IsWireframeMode, float i_CrrTime )
+{
+	if (m_pSkyModel)
+	{
+		m_pSkyModel->UpdateReflectedRefracted(i_ReflScaleMatrix, i_RefrScaleMatrix, i_Camera, i_IsWireframeMode, i_CrrTime);
+	}
+}
+
+void Sky::RenderReflectedRefracted ( void )
+{
+	if (m_pSkyModel)
+	{
+		m_pSkyModel->RenderReflectedRefracted();
+	}
+}
+
 
 void Sky::SetSunDirection ( float i_Phi, float i_Theta )
 {
@@ -38,6 +38,11 @@ public:
 	void RenderReflected(void);
 	void RenderRefracted(void);
 
+	// both layers of the layered reflection/refraction pass (check Application::RenderReflectedRefractedScene())
+	bool IsLayeredReflRefrSupported(void) const;
+	void UpdateReflectedRefracted(const glm::mat4& i_ReflScaleMatrix, const glm::mat4& i_RefrScaleMatrix, const Camera& i_Camera, bool i_IsWireframeMode, float i_CrrTime);
+	void RenderReflectedRefracted(void);
+
 	void SetSunDirection(float i_Phi, float i_Theta);
 	glm::vec3 GetSunDirection(void) const;
 
@@ -0,0 +1,274 @@
+/* Author: BAIRAC MIHAI */
+
+#include "SkyCubeMapCache.h"
+#include "CommonHeaders.h"
+#include "GLConfig.h"
+// glm::vec3, glm::mat4 come from the header
+#include "glm/common.hpp" //abs(), max()
+#include "glm/geometric.hpp" //dot()
+#include "glm/trigonometric.hpp" //cos()
+#include "glm/gtc/matrix_transform.hpp" //perspective(), lookAt()
+#include "glm/gtc/type_ptr.hpp" //value_ptr()
+#include "glm/gtc/constants.hpp" //half_pi()
+#include "GlobalConfig.h"
+#include <cassert>
+
+
+namespace
+{
+	// the view direction and the up vector of each face, in the GL_TEXTURE_CUBE_MAP_POSITIVE_X + i order
+	// the up vectors follow the cubemap faces orientation (the faces are stored upside down)
+	const glm::vec3 kFaceDirections[] = { glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f) };
+	const glm::vec3 kFaceUps[] = { glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f) };
+
+	const unsigned short kAllFacesMask = (1 << SkyCubeMapCache::m_kFaceCount) - 1;
+}
+
+const char* const SkyCubeMapCache::m_kUniformHandleNames[] =
+{
+	"u_ApplyHDR",
+	"u_WorldToClipMatrix",
+	"u_ObjectToWorldMatrix",
+	"u_IsLayered",
+	"u_FirstLayer"
+};
+
+// the sky and the horizon change slowly with the altitude, a moving camera only refreshes the faces one by one
+const float SkyCubeMapCache::m_kCameraAltitudeThreshold = 0.1f;
+// meters, so the faces aren't refreshed when the camera bobs around the sea level
+const float SkyCubeMapCache::m_kMinCameraAltitudeThreshold = 10.0f;
+
+SkyCubeMapCache::SkyCubeMapCache ( void )
+	: m_Name("Default"), m_Size(0), m_SunCosThreshold(1.0f), m_CameraAltitude(0.0f), m_LastUpdateTime(-1.0f),
+	  m_FaceUpdateMask(0), m_NextFaceId(0), m_PendingFaceCount(0), m_IsInvalid(true), m_IndexCount(0), m_IsWireframeMode(false)
+{
+	for (unsigned short i = 0; i < 4; ++i)
+	{
+		m_OldViewport[i] = 0;
+	}
+
+	LOG("SkyCubeMapCache [%s] successfully created!", m_Name.c_str());
+}
+
+SkyCubeMapCache::~SkyCubeMapCache ( void )
+{
+	Destroy();
+}
+
+void SkyCubeMapCache::Destroy ( void )
+{
+	LOG("SkyCubeMapCache [%s] successfully destroyed!", m_Name.c_str());
+}
+
+void SkyCubeMapCache::Initialize ( const std::string& i_Name, const GlobalConfig& i_Config, unsigned short i_Size, float i_SunAngleThreshold, unsigned short i_TexUnitId )
+{
+	m_Name = i_Name;
+
+	m_Size = i_Size;
+	m_SunCosThreshold = glm::cos(i_SunAngleThreshold);
+
+	std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int> attributes;
+	SetupShaders(i_Config, i_TexUnitId, attributes);
+	SetupGeometry(attributes);
+
+	SetupFaceMatrices(i_Config);
+
+	// the sky is rendered over the whole face, so no depth buffer is needed
+	m_FBM.Initialize(m_Name + " CubeMap Cache", i_Config);
+	m_FBM.CreateCubeMaped(GL_RGB16F, GL_RGB, GL_FLOAT, m_Size, m_Size, GL_CLAMP_TO_EDGE, GL_LINEAR, i_TexUnitId);
+
+	// no seams between the faces when the cubemap is sampled
+	glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+	m_IsInvalid = true;
+
+	LOG("SkyCubeMapCache [%s] successfully created!", m_Name.c_str());
+}
+
+void SkyCubeMapCache::SetupShaders ( const GlobalConfig& i_Config, unsigned short i_TexUnitId, std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& o_Attributes )
+{
+	m_SM.Initialize(m_Name + " CubeMap Cache");
+	m_SM.BuildRenderingProgram("resources/shaders/SkyCubeMapCache.vert.glsl", "resources/shaders/SkyCubeMapCache.frag.glsl", i_Config);
+
+	m_SM.UseProgram();
+
+	o_Attributes[MeshBufferManager::VERTEX_ATTRIBUTE_TYPE::VAT_POSITION] = m_SM.GetAttributeLocation("a_position");
+
+	m_SM.SetUniform(m_SM.GetUniformLocation("u_HDRExposure"), i_Config.Rendering.HDR.Exposure);
+	m_SM.SetUniform(m_SM.GetUniformLocation("u_CubeMap"), i_TexUnitId);
+
+	m_Handles.Initialize(m_SM, m_kUniformHandleNames);
+
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_APPLY_HDR], true);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_LAYERED], false);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_FIRST_LAYER], 0);
+
+	m_SM.UnUseProgram();
+}
+
+void SkyCubeMapCache::SetupGeometry ( const std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& i_Attributes )
+{
+	// the same box as the one of the CubeMapSkyModel
+	float cube_vertices[] = {
+		-1.0, 1.0, 1.0, //0
+		-1.0, -1.0, 1.0, //1
+		1.0, -1.0, 1.0, //2
+		1.0, 1.0, 1.0, //3
+		-1.0, 1.0, -1.0, //4
+		-1.0, -1.0, -1.0, //5
+		1.0, -1.0, -1.0, //6
+		1.0, 1.0, -1.0, //7
+	};
+
+	std::vector<MeshBufferManager::VertexData> vertexData;
+	vertexData.resize(8);
+
+	for (size_t i = 0, j = 0; i < 8; ++i, j += 3)
+	{
+		vertexData[i].position.x = cube_vertices[j];
+		vertexData[i].position.y = cube_vertices[j + 1];
+		vertexData[i].position.z = cube_vertices[j + 2];
+	}
+
+	// CW winding
+	unsigned int cube_indices[] = {
+		0, 3, 1, 1, 3, 2,
+		4, 6, 7, 4, 5, 6,
+		0, 5, 4, 0, 1, 5,
+		2, 3, 7, 2, 7, 6,
+		0, 4, 3, 3, 4, 7,
+		1, 2, 5, 2, 6, 5
+	};
+
+	std::vector<unsigned int> indices(cube_indices, cube_indices + 36);
+
+	m_IndexCount = indices.size();
+
+	m_MBM.Initialize(m_Name + " CubeMap Cache");
+	m_MBM.CreateModelContext(vertexData, indices, i_Attributes, MeshBufferManager::ACCESS_TYPE::AT_STATIC);
+}
+
+void SkyCubeMapCache::SetupFaceMatrices ( const GlobalConfig& i_Config )
+{
+	// 90 degrees, so the faces cover all the directions
+	glm::mat4 projectionMatrix = glm::perspective(glm::half_pi<float>(), 1.0f, i_Config.Camera.InitialZNear, i_Config.Camera.InitialZFar);
+
+	for (unsigned short i = 0; i < m_kFaceCount; ++i)
+	{
+		m_FaceWorldToClipMatrices[i] = projectionMatrix * glm::lookAt(glm::vec3(0.0f), kFaceDirections[i], kFaceUps[i]);
+	}
+}
+
+void SkyCubeMapCache::Invalidate ( void )
+{
+	m_IsInvalid = true;
+}
+
+void SkyCubeMapCache::Update ( const glm::vec3& i_SunDirection, float i_CameraAltitude, bool i_IsSunDynamic, float i_CrrTime )
+{
+	m_FaceUpdateMask = 0;
+
+	// the sky model is updated several times per frame (main view, reflection, refraction)
+	bool isNewFrame = (i_CrrTime != m_LastUpdateTime);
+	m_LastUpdateTime = i_CrrTime;
+
+	bool hasSunMoved = (i_SunDirection != m_SunDirection && glm::dot(i_SunDirection, m_SunDirection) < m_SunCosThreshold);
+	float altitudeThreshold = glm::max(m_kCameraAltitudeThreshold * glm::abs(m_CameraAltitude), m_kMinCameraAltitudeThreshold);
+	bool hasCameraMoved = (glm::abs(i_CameraAltitude - m_CameraAltitude) > altitudeThreshold);
+
+	if (m_IsInvalid || (! i_IsSunDynamic && hasSunMoved))
+	{
+		m_FaceUpdateMask = kAllFacesMask;
+
+		m_SunDirection = i_SunDirection;
+		m_CameraAltitude = i_CameraAltitude;
+		m_PendingFaceCount = 0;
+		m_IsInvalid = false;
+	}
+	else if ((i_IsSunDynamic || hasCameraMoved || m_PendingFaceCount > 0) && isNewFrame)
+	{
+		// the altitude change is spread over the next m_kFaceCount frames, instead of re-rendering all the faces at once
+		if (hasCameraMoved)
+		{
+			m_CameraAltitude = i_CameraAltitude;
+			m_PendingFaceCount = m_kFaceCount;
+		}
+
+		// the dynamic sun moves every frame, the faces are at most m_kFaceCount frames old
+		m_FaceUpdateMask = (1 << m_NextFaceId);
+		m_NextFaceId = (m_NextFaceId + 1) % m_kFaceCount;
+
+		if (m_PendingFaceCount > 0)
+		{
+			-- m_PendingFaceCount;
+		}
+
+		if (i_IsSunDynamic)
+		{
+			m_SunDirection = i_SunDirection;
+		}
+	}
+}
+
+bool SkyCubeMapCache::IsFaceUpdateNeeded ( unsigned short i_FaceId ) const
+{
+	assert(i_FaceId < m_kFaceCount);
+
+	return (m_FaceUpdateMask & (1 << i_FaceId)) != 0;
+}
+
+void SkyCubeMapCache::BeginFaceUpdate ( unsigned short i_FaceId )
+{
+	glGetIntegerv(GL_VIEWPORT, m_OldViewport);
+
+	m_FBM.Bind();
+	m_FBM.AttachCubeMapFace(i_FaceId);
+
+	glViewport(0, 0, m_Size, m_Size);
+
+	glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void SkyCubeMapCache::EndFaceUpdate ( void )
+{
+	m_FBM.UnBind();
+
+	glViewport(m_OldViewport[0], m_OldViewport[1], m_OldViewport[2], m_OldViewport[3]);
+}
+
+const glm::mat4& SkyCubeMapCache::GetFaceWorldToClipMatrix ( unsigned short i_FaceId ) const
+{
+	assert(i_FaceId < m_kFaceCount);
+
+	return m_FaceWorldToClipMatrices[i_FaceId];
+}
+
+void SkyCubeMapCache::SetViewData ( const glm::mat4& i_WorldToClipMatrix, const glm::mat4* i_pObjectToWorldMatrices, unsigned short i_LayerCount, unsigned short i_FirstLayer, bool i_ApplyHDR, bool i_IsWireframeMode )
+{
+	m_IsWireframeMode = i_IsWireframeMode;
+
+	m_SM.UseProgram();
+
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_IS_LAYERED], i_LayerCount > 1);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_FIRST_LAYER], i_FirstLayer);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_APPLY_HDR], i_ApplyHDR);
+
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_WORLD_TO_CLIP_MATRIX], 1, glm::value_ptr(i_WorldToClipMatrix), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+	m_SM.SetUniform(m_Handles[UNIFORM_HANDLE::UH_OBJECT_TO_WORLD_MATRIX], i_LayerCount, glm::value_ptr(i_pObjectToWorldMatrices[0]), ShaderManager::UNIFORM_TYPE::UT_FLOAT_MAT_4);
+}
+
+void SkyCubeMapCache::Render ( unsigned short i_InstanceCount )
+{
+	// we set a different depth function as explined here: https://learnopengl.com/#!Advanced-OpenGL/Cubemaps
+	glDepthFunc(GL_LEQUAL);
+
+	m_SM.UseProgram();
+
+	m_FBM.BindColorAttachmentByIndex(0);
+
+	m_MBM.BindModelContext();
+	glDrawElementsInstanced(m_IsWireframeMode ? GL_LINES : GL_TRIANGLES, m_IndexCount, GL_UNSIGNED_INT, nullptr, i_InstanceCount);
+	m_MBM.UnBindModelContext();
+
+	glDepthFunc(GL_LESS);
+}
\ No newline at end of file
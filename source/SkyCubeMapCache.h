@@ -0,0 +1,123 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef SKY_CUBE_MAP_CACHE_H
+#define SKY_CUBE_MAP_CACHE_H
+
+#include "glm/vec3.hpp"
+#include "glm/mat4x4.hpp"
+#include "ShaderManager.h"
+#include "MeshBufferManager.h"
+#include "FrameBufferManager.h"
+#include <string>
+
+class GlobalConfig;
+
+/*
+ Cubemap cache of a sky model
+
+ The sky only changes when the sun moves (or when the clouds parameters are changed),
+ so the sky model renders itself into the faces of a cubemap and the cubemap is sampled instead,
+ by the main view and by the reflection/refraction maps (the mirrored box samples the mirrored directions).
+
+ The faces are re-rendered:
+ - all of them, after Invalidate() or after the sun direction changed more than the threshold angle
+ - one face per frame (round robin), if the sun is dynamic or if the camera altitude changed
+   more than m_kCameraAltitudeThreshold (relative to the altitude, at least m_kMinCameraAltitudeThreshold)
+
+ The cubemap keeps the linear (not tone mapped) sky colors, the HDR is applied when the cubemap is sampled.
+ The sky is rendered from the origin, at the camera altitude of the face update.
+ The reflected sky of ScatteringSkyModel (reflection mode) is different, so it's kept by a second cache.
+
+ Usage (check ScatteringSkyModel):
+ Update(), then for every face for which IsFaceUpdateNeeded():
+ BeginFaceUpdate(), render the sky with GetFaceWorldToClipMatrix(), EndFaceUpdate()
+ and finally SetViewData() + Render() instead of rendering the sky.
+*/
+
+class SkyCubeMapCache
+{
+public:
+	SkyCubeMapCache(void);
+	~SkyCubeMapCache(void);
+
+	void Initialize(const std::string& i_Name, const GlobalConfig& i_Config, unsigned short i_Size, float i_SunAngleThreshold, unsigned short i_TexUnitId);
+
+	// all the faces are re-rendered on the next Update()
+	void Invalidate(void);
+
+	// selects the faces which must be re-rendered, only once per frame (i_CrrTime)
+	// i_CameraAltitude - meters
+	void Update(const glm::vec3& i_SunDirection, float i_CameraAltitude, bool i_IsSunDynamic, float i_CrrTime);
+	bool IsFaceUpdateNeeded(unsigned short i_FaceId) const;
+
+	// the face is the render target until EndFaceUpdate()
+	void BeginFaceUpdate(unsigned short i_FaceId);
+	void EndFaceUpdate(void);
+
+	// no translation, the sky is rendered from the origin
+	const glm::mat4& GetFaceWorldToClipMatrix(unsigned short i_FaceId) const;
+
+	// one model matrix per layer (check Application::RenderReflectedRefractedScene())
+	// i_FirstLayer - the layer of the first instance, so two caches can render one layer each
+	void SetViewData(const glm::mat4& i_WorldToClipMatrix, const glm::mat4* i_pObjectToWorldMatrices, unsigned short i_LayerCount, unsigned short i_FirstLayer, bool i_ApplyHDR, bool i_IsWireframeMode);
+	void Render(unsigned short i_InstanceCount = 1);
+
+	static const unsigned short m_kFaceCount = 6;
+	static const float m_kCameraAltitudeThreshold;
+	static const float m_kMinCameraAltitudeThreshold;
+
+private:
+	//// Methods ////
+	void SetupShaders(const GlobalConfig& i_Config, unsigned short i_TexUnitId, std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& o_Attributes);
+	void SetupGeometry(const std::map<MeshBufferManager::VERTEX_ATTRIBUTE_TYPE, int>& i_Attributes);
+	void SetupFaceMatrices(const GlobalConfig& i_Config);
+
+	void Destroy(void);
+
+	//// Variables ////
+	std::string m_Name;
+
+	ShaderManager m_SM;
+	MeshBufferManager m_MBM;
+	FrameBufferManager m_FBM;
+
+	enum class UNIFORM_HANDLE
+	{
+		UH_APPLY_HDR = 0,
+		UH_WORLD_TO_CLIP_MATRIX,
+		UH_OBJECT_TO_WORLD_MATRIX,
+		UH_IS_LAYERED,
+		UH_FIRST_LAYER,
+		UH_COUNT
+	};
+
+	static const char* const m_kUniformHandleNames[static_cast<unsigned short>(UNIFORM_HANDLE::UH_COUNT)];
+
+	ShaderManager::UniformHandleTable<UNIFORM_HANDLE, static_cast<unsigned short>(UNIFORM_HANDLE::UH_COUNT)> m_Handles;
+
+	glm::mat4 m_FaceWorldToClipMatrices[m_kFaceCount];
+
+	unsigned short m_Size;
+	// cosine of the threshold angle
+	float m_SunCosThreshold;
+
+	// the sun direction of the last update of all the faces
+	glm::vec3 m_SunDirection;
+	// the camera altitude which started the last refresh of the faces
+	float m_CameraAltitude;
+	float m_LastUpdateTime;
+
+	// bit i - face i
+	unsigned short m_FaceUpdateMask;
+	unsigned short m_NextFaceId;
+	// faces left to refresh after the camera altitude changed
+	unsigned short m_PendingFaceCount;
+	bool m_IsInvalid;
+
+	int m_OldViewport[4];
+
+	unsigned int m_IndexCount;
+	bool m_IsWireframeMode;
+};
+
+#endif /* SKY_CUBE_MAP_CACHE_H */
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include "CommonHeaders.h"
 #include "GLConfig.h"
 #include "GlobalConfig.h"
+#include "GLStateCache.h"
 #include "glm/vec3.hpp"
 #include "SDL/SDL_rwops.h"
 #include "SDL/SDL_filesystem.h"
@@ -64,17 +65,20 @@ void TextureManager::Init (const GlobalConfig& i_Config)
 void TextureManager::Destroy ( void )
 {
 	// These are the targets we use
-	glBindTexture(GL_TEXTURE_1D, 0);
-	glBindTexture(GL_TEXTURE_1D_ARRAY, 0);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
-	glBindTexture(GL_TEXTURE_3D, 0);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_1D, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_1D_ARRAY, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_3D, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
 
 	for (size_t i = 0; i < m_TextureDataArray.size(); ++ i)
 	{
 		glDeleteTextures(1, &m_TextureDataArray[i].texId);
+		GLStateCache::OnTextureDeleted(m_TextureDataArray[i].texId);
 	}
+	m_TextureDataArray.clear();
+	m_TextureIndexMap.clear();
 
 	LOG("Texture Manager [%s] successfully destroyed!", m_Name.c_str());
 }
@@ -109,7 +113,7 @@ unsigned int TextureManager::Load1DTexture ( const std::string& i_ImageFileName,
 
 	SetupPixelFormat(pSurface->format, i_IsGammaCorrected, format, internalFormat);
 
-	m_TextureDataArray.push_back(TextureInfo(texId, i_TexUnitId, target, internalFormat, format, type, pSurface->w, pSurface->h, i_WrapType, i_FilterType, i_MipMapCount, 1));
+	AddTextureInfo(TextureInfo(texId, i_TexUnitId, target, internalFormat, format, type, pSurface->w, pSurface->h, i_WrapType, i_FilterType, i_MipMapCount, 1));
 
 	glTexImage1D(target, 0, internalFormat, pSurface->w, 0, format, type, pSurface->pixels);
 
@@ -161,7 +165,7 @@ unsigned int TextureManager::Load1DArrayTexture ( const std::vector<std::string>
 		{
 			texId = GenAndBindTexture(target, i_TexUnitId);
 
-			m_TextureDataArray.push_back(TextureInfo(texId, i_TexUnitId, target, internalFormat, format, type, pSurface->w, pSurface->h, i_WrapType, i_FilterType, i_MipMapCount, i_ImageFileNameArray.size()));
+			AddTextureInfo(TextureInfo(texId, i_TexUnitId, target, internalFormat, format, type, pSurface->w, pSurface->h, i_WrapType, i_FilterType, i_MipMapCount, i_ImageFileNameArray.size()));
 
 			// allocate space for 1d texture array
 			glTexImage2D(target, 0, internalFormat, pSurface->w, i_ImageFileNameArray.size(), 0, format, type, nullptr);
@@ -208,7 +212,7 @@ unsigned int TextureManager::Load2DTexture ( const std::string& i_ImageFileName,
 
 	SetupPixelFormat(pSurface->format, i_IsGammaCorrected, format, internalFormat);
 
-	m_TextureDataArray.push_back(TextureInfo(texId, i_TexUnitId, target, internalFormat, format, type, pSurface->w, pSurface->h, i_WrapType, i_FilterType, i_MipMapCount, 1));
+	AddTextureInfo(TextureInfo(texId, i_TexUnitId, target, internalFormat, format, type, pSurface->w, pSurface->h, i_WrapType, i_FilterType, i_MipMapCount, 1));
 	glTexImage2D(target, 0, internalFormat, pSurface->w, pSurface->h, 0, format, type, pSurface->pixels);
 
 	SDL_FreeSurface(pSurface);
@@ -259,7 +263,7 @@ unsigned int TextureManager::Load2DArrayTexture ( const std::vector<std::string>
 		{
 			texId = GenAndBindTexture(target, i_TexUnitId);
 
-			m_TextureDataArray.push_back(TextureInfo(texId, i_TexUnitId, target, internalFormat, format, type, pSurface->w, pSurface->h, i_WrapType, i_FilterType, i_MipMapCount, i_ImageFileNameArray.size()));
+			AddTextureInfo(TextureInfo(texId, i_TexUnitId, target, internalFormat, format, type, pSurface->w, pSurface->h, i_WrapType, i_FilterType, i_MipMapCount, i_ImageFileNameArray.size()));
 
 			// allocate space for 2d texture array
 			glTexImage3D(target, 0, internalFormat, pSurface->w, pSurface->h, i_ImageFileNameArray.size(), 0, format, type, nullptr);
@@ -322,7 +326,7 @@ unsigned int TextureManager::LoadCubeMapTexture ( const std::vector<std::string>
 
 		if (i == 0)
 		{
-			m_TextureDataArray.push_back(TextureInfo(texId, i_TexUnitId, target, internalFormat, format, type, pSurface->w, pSurface->h, i_WrapType, i_FilterType, i_MipMapCount, 1));
+			AddTextureInfo(TextureInfo(texId, i_TexUnitId, target, internalFormat, format, type, pSurface->w, pSurface->h, i_WrapType, i_FilterType, i_MipMapCount, 1));
 		}
 		// allocate memory and load the texture data
 		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, internalFormat, pSurface->w, pSurface->h, 0, format, type, pSurface->pixels);
@@ -420,7 +424,7 @@ unsigned int TextureManager::Load2DRawTexture(const std::string& i_ImageFileName
 
 	unsigned int texId = GenAndBindTexture(target, i_TexUnitId);
 
-	m_TextureDataArray.push_back(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_DataType, i_Width, i_Height, i_WrapType, i_FilterType, i_MipMapCount, 1));
+	AddTextureInfo(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_DataType, i_Width, i_Height, i_WrapType, i_FilterType, i_MipMapCount, 1));
 	// allocate memory and load the texture data
 
 	if (i_DataType == GL_UNSIGNED_BYTE)
@@ -511,7 +515,7 @@ unsigned int TextureManager::Load3DRawTexture(const std::string& i_ImageFileName
 	{
 		pFloatData = new float[fileSize];
 		assert(pFloatData != nullptr);
-		nbRead = (size_t)SDL_RWread(pF, pFloatData, sizeof(unsigned char), fileSize);
+		nbRead = (size_t)SDL_RWread(pF, pFloatData, sizeof(float), fileSize);
 	}
 
 	if (nbRead != fileSize)
@@ -526,7 +530,7 @@ unsigned int TextureManager::Load3DRawTexture(const std::string& i_ImageFileName
 
 	unsigned int texId = GenAndBindTexture(target, i_TexUnitId);
 
-	m_TextureDataArray.push_back(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_DataType, i_Width, i_Height, i_WrapType, i_FilterType, i_MipMapCount, 1));
+	AddTextureInfo(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_DataType, i_Width, i_Height, i_WrapType, i_FilterType, i_MipMapCount, 1));
 	// allocate memory and load the texture data
 	if (i_DataType == GL_UNSIGNED_BYTE)
 	{
@@ -552,7 +556,7 @@ unsigned int TextureManager::Create1DTexture ( unsigned int i_FormatInternal, un
 
 	unsigned int texId = GenAndBindTexture(target, i_TexUnitId);
 
-	m_TextureDataArray.push_back(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_FormatType, i_Width, 0, i_WrapType, i_FilterType, i_MipMapCount, 1));
+	AddTextureInfo(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_FormatType, i_Width, 0, i_WrapType, i_FilterType, i_MipMapCount, 1));
 	// allocate memory and load the texture data
 	glTexImage1D(target, 0, i_FormatInternal, i_Width, 0, i_FormatExternal, i_FormatType, i_pData);
 
@@ -573,7 +577,7 @@ unsigned int TextureManager::Create1DArrayTexture ( unsigned short i_LayerCount,
 
 	unsigned int texId = GenAndBindTexture(target, i_TexUnitId);
 
-	m_TextureDataArray.push_back(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_FormatType, i_Width, 0, i_WrapType, i_FilterType, i_MipMapCount, i_LayerCount));
+	AddTextureInfo(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_FormatType, i_Width, 0, i_WrapType, i_FilterType, i_MipMapCount, i_LayerCount));
 	// allocate memory and load the texture data
 	glTexImage2D(target, 0, i_FormatInternal, i_Width, i_LayerCount, 0, i_FormatExternal, i_FormatType, i_pData);
 
@@ -588,7 +592,7 @@ unsigned int TextureManager::Create2DTexture ( unsigned int i_FormatInternal, un
 
 	unsigned int texId = GenAndBindTexture(target, i_TexUnitId);
 
-	m_TextureDataArray.push_back(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_FormatType, i_Width, i_Height, i_WrapType, i_FilterType, i_MipMapCount, 1));
+	AddTextureInfo(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_FormatType, i_Width, i_Height, i_WrapType, i_FilterType, i_MipMapCount, 1));
 	// allocate memory and load the texture data
 	glTexImage2D(target, 0, i_FormatInternal, i_Width, i_Height, 0, i_FormatExternal, i_FormatType, i_pData);
 
@@ -597,6 +601,21 @@ unsigned int TextureManager::Create2DTexture ( unsigned int i_FormatInternal, un
 	return texId;
 }
 
+unsigned int TextureManager::Create3DTexture ( unsigned int i_FormatInternal, unsigned int i_FormatExternal, unsigned int i_FormatType, unsigned short i_Width, unsigned short i_Height, unsigned short i_Depth, unsigned int i_WrapType, unsigned int i_FilterType, void* i_pData, short i_TexUnitId, short i_MipMapCount, bool i_AnisoFiltering )
+{
+	unsigned int target = GL_TEXTURE_3D;
+
+	unsigned int texId = GenAndBindTexture(target, i_TexUnitId);
+
+	AddTextureInfo(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_FormatType, i_Width, i_Height, i_WrapType, i_FilterType, i_MipMapCount, 1));
+	// allocate memory and load the texture data
+	glTexImage3D(target, 0, i_FormatInternal, i_Width, i_Height, i_Depth, 0, i_FormatExternal, i_FormatType, i_pData);
+
+	SetupTextureParameteres(target, i_WrapType, i_FilterType, i_MipMapCount, i_AnisoFiltering);
+
+	return texId;
+}
+
 unsigned int TextureManager::Create2DArrayTexture(unsigned short i_LayerCount, unsigned int i_FormatInternal, unsigned int i_FormatExternal, unsigned int i_FormatType, unsigned short i_Width, unsigned short i_Height, unsigned int i_WrapType, unsigned int i_FilterType, void* i_pData, short i_TexUnitId, short i_MipMapCount, bool i_AnisoFiltering)
 {
 	if (!TextureManager::CheckLayerCount(i_LayerCount))
@@ -609,7 +628,7 @@ unsigned int TextureManager::Create2DArrayTexture(unsigned short i_LayerCount, u
 
 	unsigned int texId = GenAndBindTexture(target, i_TexUnitId);
 
-	m_TextureDataArray.push_back(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_FormatType, i_Width, i_Height, i_WrapType, i_FilterType, i_MipMapCount, i_LayerCount));
+	AddTextureInfo(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_FormatType, i_Width, i_Height, i_WrapType, i_FilterType, i_MipMapCount, i_LayerCount));
 	// allocate memory and load the texture data
 	glTexImage3D(target, 0, i_FormatInternal, i_Width, i_Height, i_LayerCount, 0, i_FormatExternal, i_FormatType, i_pData);
 
@@ -624,7 +643,7 @@ unsigned int TextureManager::CreateCubeMapTexture ( unsigned int i_FormatInterna
 
 	unsigned int texId = GenAndBindTexture(target, i_TexUnitId);
 
-	m_TextureDataArray.push_back(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_FormatType, i_Width, i_Height, i_WrapType, i_FilterType, i_MipMapCount, 1));
+	AddTextureInfo(TextureInfo(texId, i_TexUnitId, target, i_FormatInternal, i_FormatExternal, i_FormatType, i_Width, i_Height, i_WrapType, i_FilterType, i_MipMapCount, 1));
 
 	for (unsigned short i = 0; i < 6; ++i)
 	{
@@ -662,8 +681,8 @@ unsigned int TextureManager::GenAndBindTexture(unsigned int i_Target, short i_Te
 	unsigned int texId = 0;
 	glGenTextures(1, &texId);
 
-	if (i_TexUnitId >= 0) glActiveTexture(GL_TEXTURE0 + i_TexUnitId);
-	glBindTexture(i_Target, texId);
+	if (i_TexUnitId >= 0) GLStateCache::ActiveTexture(i_TexUnitId);
+	GLStateCache::BindTexture(i_Target, texId);
 
 	return texId;
 }
@@ -786,115 +805,137 @@ void TextureManager::Update1DTextureData ( unsigned int i_TexId, void* i_pNewDat
 {
 	assert(i_pNewData != nullptr);
 
-	//NOTE! maybe use a std::map instead of std::vector for faster lookup
-
-	for (unsigned short i = 0; i < m_TextureDataArray.size(); ++i)
+	int index = FindTextureIndex(i_TexId);
+	if (index < 0 || m_TextureDataArray[index].target != GL_TEXTURE_1D)
 	{
-		if (m_TextureDataArray[i].texId == i_TexId)
-		{
-			const TextureInfo& ti = m_TextureDataArray[i];
+		return;
+	}
 
-			glBindTexture(ti.target, i_TexId);
+	const TextureInfo& ti = m_TextureDataArray[index];
 
-			if (ti.target == GL_TEXTURE_1D)
-			{
-				glTexImage1D(ti.target, 0, ti.formatInternal, ti.width, 0, ti.formatExternal, ti.formatType, i_pNewData);
+	GLStateCache::BindTexture(ti.target, i_TexId);
 
-				return;
-			}
-		}
-	}
+	glTexImage1D(ti.target, 0, ti.formatInternal, ti.width, 0, ti.formatExternal, ti.formatType, i_pNewData);
+	ti.isMipMapDirty = true;
 }
 
 void TextureManager::Update2DTextureData ( unsigned int i_TexId, void* i_pNewData ) const
 {
 	assert(i_pNewData != nullptr);
 
-	//TODO maybe use a std::map instead of std::vector for faster lookup
-
-	for (unsigned short i = 0; i < m_TextureDataArray.size(); ++i)
+	int index = FindTextureIndex(i_TexId);
+	if (index < 0 || m_TextureDataArray[index].target != GL_TEXTURE_2D)
 	{
-		if (m_TextureDataArray[i].texId == i_TexId)
-		{
-			const TextureInfo& ti = m_TextureDataArray[i];
+		return;
+	}
 
-			glBindTexture(ti.target, i_TexId);
+	const TextureInfo& ti = m_TextureDataArray[index];
 
-			if (ti.target == GL_TEXTURE_2D)
-			{
-				glTexImage2D(ti.target, 0, ti.formatInternal, ti.width, ti.height, 0, ti.formatExternal, ti.formatType, i_pNewData);
+	GLStateCache::BindTexture(ti.target, i_TexId);
 
-				return;
-			}
-		}
-	}
+	glTexImage2D(ti.target, 0, ti.formatInternal, ti.width, ti.height, 0, ti.formatExternal, ti.formatType, i_pNewData);
+	ti.isMipMapDirty = true;
 }
 
 void TextureManager::Update2DArrayTextureData ( unsigned int i_TexId, void* i_pNewData ) const
 {
 	assert(i_pNewData != nullptr);
 
-	//TODO maybe use a std::map instead of std::vector for faster lookup
+	int index = FindTextureIndex(i_TexId);
+	if (index < 0 || m_TextureDataArray[index].target != GL_TEXTURE_2D_ARRAY)
+	{
+		return;
+	}
+
+	const TextureInfo& ti = m_TextureDataArray[index];
+
+	GLStateCache::BindTexture(ti.target, i_TexId);
+
+	glTexImage3D(ti.target, 0, ti.formatInternal, ti.width, ti.height, ti.layerCount, 0, ti.formatExternal, ti.formatType, i_pNewData);
+	ti.isMipMapDirty = true;
+}
 
-	for (unsigned short i = 0; i < m_TextureDataArray.size(); ++i)
+void TextureManager::Update2DArrayTextureData ( unsigned int i_TexId, void** i_ppMipMapData, unsigned short i_MipMapLevelCount ) const
+{
+	assert(i_ppMipMapData != nullptr);
+
+	int index = FindTextureIndex(i_TexId);
+	if (index < 0 || m_TextureDataArray[index].target != GL_TEXTURE_2D_ARRAY)
 	{
-		if (m_TextureDataArray[i].texId == i_TexId)
-		{
-			const TextureInfo& ti = m_TextureDataArray[i];
+		return;
+	}
 
-			glBindTexture(ti.target, i_TexId);
+	const TextureInfo& ti = m_TextureDataArray[index];
 
-			if (ti.target == GL_TEXTURE_2D_ARRAY)
-			{
-				glTexImage3D(ti.target, 0, ti.formatInternal, ti.width, ti.height, ti.layerCount, 0, ti.formatExternal, ti.formatType, i_pNewData);
+	GLStateCache::BindTexture(ti.target, i_TexId);
 
-				return;
-			}
-		}
+	for (unsigned short level = 0; level < i_MipMapLevelCount; ++level)
+	{
+		assert(i_ppMipMapData[level] != nullptr);
+
+		glTexImage3D(ti.target, level, ti.formatInternal, ti.width >> level, ti.height >> level, ti.layerCount, 0, ti.formatExternal, ti.formatType, i_ppMipMapData[level]);
 	}
+	ti.isMipMapDirty = false;
 }
 
 void TextureManager::Update2DTextureSize ( unsigned int i_TexId, unsigned short i_Width, unsigned short i_Height )
 {
-	for (unsigned short i = 0; i < m_TextureDataArray.size(); ++i)
+	int index = FindTextureIndex(i_TexId);
+	if (index < 0 || m_TextureDataArray[index].target != GL_TEXTURE_2D)
 	{
-		if (m_TextureDataArray[i].texId == i_TexId)
-		{
-			TextureInfo& ti = m_TextureDataArray[i];
+		return;
+	}
 
-			ti.width = i_Width;
-			ti.height = i_Height;
+	TextureInfo& ti = m_TextureDataArray[index];
 
-			glBindTexture(ti.target, i_TexId);
+	ti.width = i_Width;
+	ti.height = i_Height;
 
-			// NOTE! Update the texture with NO DATA !!!!
-			if (ti.target == GL_TEXTURE_2D)
-			{
-				glTexImage2D(ti.target, 0, ti.formatInternal, ti.width, ti.height, 0, ti.formatExternal, ti.formatType, nullptr);
+	GLStateCache::BindTexture(ti.target, i_TexId);
 
-				return;
-			}
-		}
-	}
+	// NOTE! Update the texture with NO DATA !!!!
+	glTexImage2D(ti.target, 0, ti.formatInternal, ti.width, ti.height, 0, ti.formatExternal, ti.formatType, nullptr);
+	ti.isMipMapDirty = true;
 }
 
 void TextureManager::BindTexture ( unsigned int i_TexId,  bool i_GenerateMipMaps, short i_TexUnitId ) const
 {
-	for (unsigned short i = 0; i < m_TextureDataArray.size(); ++ i)
+	int index = FindTextureIndex(i_TexId);
+	if (index < 0)
 	{
-		if (m_TextureDataArray[i].texId == i_TexId)
-		{
-			const TextureInfo& ti = m_TextureDataArray[i];
+		return;
+	}
 
-			short texUnitId = ti.texUnitId;
-			if (i_TexUnitId >= 0) texUnitId = i_TexUnitId;
-			glActiveTexture(GL_TEXTURE0 + texUnitId);
-			glBindTexture(ti.target, ti.texId);
+	const TextureInfo& ti = m_TextureDataArray[index];
 
-			if (i_GenerateMipMaps && ti.mipMapCount >= 0) glGenerateMipmap(ti.target);
+	short texUnitId = ti.texUnitId;
+	if (i_TexUnitId >= 0) texUnitId = i_TexUnitId;
+	GLStateCache::BindTexture(texUnitId, ti.target, ti.texId);
 
-			return;
-		}
+	if (i_GenerateMipMaps && ti.mipMapCount >= 0 && ti.isMipMapDirty)
+	{
+		// the bind might have been dropped, without selecting the texture unit
+		GLStateCache::ActiveTexture(texUnitId);
+
+		glGenerateMipmap(ti.target);
+		ti.isMipMapDirty = false;
+	}
+}
+
+void TextureManager::MarkMipMapsDirty ( unsigned int i_TexId ) const
+{
+	int index = FindTextureIndex(i_TexId);
+	if (index >= 0)
+	{
+		m_TextureDataArray[index].isMipMapDirty = true;
+	}
+}
+
+void TextureManager::MarkAllMipMapsDirty ( void ) const
+{
+	for (unsigned short i = 0; i < m_TextureDataArray.size(); ++ i)
+	{
+		m_TextureDataArray[i].isMipMapDirty = true;
 	}
 }
 
@@ -919,6 +960,23 @@ unsigned int TextureManager::GetDepthTextureId ( void ) const
 	return m_TextureDataArray[m_TextureDataArray.size() - 1].texId;
 }
 
+void TextureManager::AddTextureInfo ( const TextureInfo& i_TextureInfo )
+{
+	m_TextureIndexMap[i_TextureInfo.texId] = static_cast<unsigned short>(m_TextureDataArray.size());
+	m_TextureDataArray.push_back(i_TextureInfo);
+}
+
+int TextureManager::FindTextureIndex ( unsigned int i_TexId ) const
+{
+	std::unordered_map<unsigned int, unsigned short>::const_iterator it = m_TextureIndexMap.find(i_TexId);
+	if (it == m_TextureIndexMap.end())
+	{
+		return -1;
+	}
+
+	return it->second;
+}
+
 bool TextureManager::CheckLayerCount ( unsigned short i_LayerCount )
 {
 	if (i_LayerCount == 0 || i_LayerCount >= m_MaxTextureArrayLayers)
@@ -11,6 +11,7 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 
 class GlobalConfig;
 struct SDL_PixelFormat;
@@ -20,6 +21,9 @@ struct SDL_PixelFormat;
  Manager for textures: loads and creates: 1D, 1D arrays, 2D, 2D arrays and cubemaps textures
 
  It uses SDL2_image lib
+
+ The textures are looked up by id in a hash map (O(1)) and bound through GLStateCache,
+ so binding a texture which is already bound to the texture unit costs no GL call.
 */
 
 
@@ -48,6 +52,7 @@ public:
 	unsigned int Create1DTexture(unsigned int i_FormatInternal, unsigned int i_FormatExternal, unsigned int i_FormatType, unsigned short i_Width, unsigned int i_WrapType, unsigned int i_FilterType, void* i_pData = nullptr, short i_TexUnitId = -1, short i_MipMapCount = -1, bool i_AnisoFiltering = true);
 	unsigned int Create1DArrayTexture(unsigned short i_LayerCount, unsigned int i_FormatInternal, unsigned int i_FormatExternal, unsigned int i_FormatType, unsigned short i_Width, unsigned int i_WrapType, unsigned int i_FilterType, void* i_pData = nullptr, short i_TexUnitId = -1, short i_MipMapCount = -1, bool i_AnisoFiltering = true);
 	unsigned int Create2DTexture(unsigned int i_FormatInternal, unsigned int i_FormatExternal, unsigned int i_DataType, unsigned short i_Width, unsigned short i_Height, unsigned int i_WrapType, unsigned int i_FilterType, void* i_pData = nullptr, short i_TexUnitId = -1, short i_MipMapCount = -1, bool i_AnisoFiltering = true);
+	unsigned int Create3DTexture(unsigned int i_FormatInternal, unsigned int i_FormatExternal, unsigned int i_FormatType, unsigned short i_Width, unsigned short i_Height, unsigned short i_Depth, unsigned int i_WrapType, unsigned int i_FilterType, void* i_pData = nullptr, short i_TexUnitId = -1, short i_MipMapCount = -1, bool i_AnisoFiltering = true);
 	unsigned int Create2DArrayTexture(unsigned short i_LayerCount, unsigned int i_FormatInternal, unsigned int i_FormatExternal, unsigned int i_FormatType, unsigned short i_Width, unsigned short i_Height, unsigned int i_WrapType, unsigned int i_FilterType, void* i_pData = nullptr, short i_TexUnitId = -1, short i_MipMapCount = -1, bool i_AnisoFiltering = true);
 	unsigned int CreateCubeMapTexture(unsigned int i_FormatInternal, unsigned int i_FormatExternal, unsigned int i_FormatType, unsigned short i_Width, unsigned short i_Height, unsigned int i_WrapType, unsigned int i_FilterType, void* i_pData = nullptr, short i_TexUnitId = -1, short i_MipMapCount = -1);
 
@@ -58,13 +63,21 @@ public:
 	void Update1DTextureData(unsigned int i_TexId, void* i_pNewData) const;
 	void Update2DTextureData(unsigned int i_TexId, void* i_pNewData) const;
 	void Update2DArrayTextureData(unsigned int i_TexId, void* i_pNewData) const;
+	// uploads all the mipmap levels at once: i_ppMipMapData[0] - base level, i_ppMipMapData[i] - level i
+	// NOTE! the mipmaps are considered up to date afterwards, so no glGenerateMipmap call will be done on bind
+	void Update2DArrayTextureData(unsigned int i_TexId, void** i_ppMipMapData, unsigned short i_MipMapLevelCount) const;
 	// NOTE! No update for cubemap textures
 
 	// for now only 2d textures can be updated
 	void Update2DTextureSize(unsigned int i_TexId, unsigned short i_Width, unsigned short i_Height);
 
+	// NOTE! the mipmaps are regenerated only if the texture content changed since the last generation
 	void BindTexture(unsigned int i_TexId, bool i_GenerateMipMaps = false, short i_TexUnitId = -1) const;
 
+	// used when the texture content is changed outside of this manager (e.g. render to texture, image store)
+	void MarkMipMapsDirty(unsigned int i_TexId) const;
+	void MarkAllMipMapsDirty(void) const;
+
 	unsigned int GetTextureId(unsigned short i_Index) const;
 	unsigned short GetTextureUnitId(unsigned short i_Index) const;
 
@@ -76,7 +89,7 @@ private:
 	struct TextureInfo
 	{
 		TextureInfo ( unsigned int i_TexId, unsigned short i_TexUnitId, unsigned int i_Target, unsigned int i_FormatInternal, unsigned int i_FormatExternal, unsigned int i_FormatType, unsigned short i_Width, unsigned short i_Height, unsigned int i_WrapType, unsigned int i_FilterType, unsigned short i_MipMapCount, unsigned int i_LayerCount)
-			: texId(i_TexId), texUnitId(i_TexUnitId), target(i_Target), formatInternal(i_FormatInternal), formatExternal(i_FormatExternal), formatType(i_FormatType), width(i_Width), height(i_Height), wrapType(i_WrapType), filterType(i_FilterType), mipMapCount(i_MipMapCount), layerCount(i_LayerCount)
+			: texId(i_TexId), texUnitId(i_TexUnitId), target(i_Target), formatInternal(i_FormatInternal), formatExternal(i_FormatExternal), formatType(i_FormatType), width(i_Width), height(i_Height), wrapType(i_WrapType), filterType(i_FilterType), mipMapCount(i_MipMapCount), layerCount(i_LayerCount), isMipMapDirty(true)
 		{}
 
 		unsigned int texId;
@@ -92,11 +105,17 @@ private:
 		unsigned int filterType;
 		unsigned short mipMapCount;
 		unsigned int layerCount;
+		// true when the base level changed, but the mipmaps were not regenerated yet
+		mutable bool isMipMapDirty;
 	};
 
 	//// Methods ////
 	void Init(const GlobalConfig& i_Config);
 
+	void AddTextureInfo(const TextureInfo& i_TextureInfo);
+	// returns -1 if the texture doesn't belong to this manager
+	int FindTextureIndex(unsigned int i_TexId) const;
+
 	//// Variables ////
 	// self init
 	std::string m_Name;
@@ -107,6 +126,8 @@ private:
 	static float m_MaxAnisotropy;
 
 	std::vector<TextureInfo> m_TextureDataArray;
+	// texture id -> index in m_TextureDataArray
+	std::unordered_map<unsigned int, unsigned short> m_TextureIndexMap;
 
 	bool m_IsTexAnisoFilterSupported;
 };
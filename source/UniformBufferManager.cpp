@@ -0,0 +1,168 @@
+/* Author: BAIRAC MIHAI */
+
+#include "UniformBufferManager.h"
+#include "CommonHeaders.h"
+#include <cstring> // std::memcpy
+
+
+UniformBufferManager::UniformBufferManager ( void )
+	: m_Name("Default"), m_UBOID(0), m_FrameSize(0), m_OffsetAlignment(0),
+	  m_FrameIndex(0), m_FrameOffset(0), m_IsFrameStarted(false)
+{
+	for (unsigned short i = 0; i < m_kFrameCount; ++i)
+	{
+		m_Fences[i] = nullptr;
+	}
+
+	LOG("Uniform Buffer Manager [%s] successfully created!", m_Name.c_str());
+}
+
+UniformBufferManager::UniformBufferManager ( const std::string& i_Name )
+	: m_UBOID(0), m_FrameSize(0), m_OffsetAlignment(0),
+	  m_FrameIndex(0), m_FrameOffset(0), m_IsFrameStarted(false)
+{
+	for (unsigned short i = 0; i < m_kFrameCount; ++i)
+	{
+		m_Fences[i] = nullptr;
+	}
+
+	Initialize(i_Name);
+}
+
+UniformBufferManager::~UniformBufferManager ( void )
+{
+	Destroy();
+}
+
+void UniformBufferManager::Initialize ( const std::string& i_Name )
+{
+	m_Name = i_Name;
+
+	LOG("Uniform Buffer Manager [%s] successfully created!", m_Name.c_str());
+}
+
+void UniformBufferManager::Destroy ( void )
+{
+	for (unsigned short i = 0; i < m_kFrameCount; ++i)
+	{
+		if (m_Fences[i])
+		{
+			glDeleteSync(m_Fences[i]);
+			m_Fences[i] = nullptr;
+		}
+	}
+
+	if (m_UBOID)
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		glDeleteBuffers(1, &m_UBOID);
+		m_UBOID = 0;
+	}
+
+	LOG("Uniform Buffer Manager [%s] successfully destroyed!", m_Name.c_str());
+}
+
+void UniformBufferManager::CreateBuffer ( unsigned int i_FrameSize )
+{
+	if (m_UBOID)
+	{
+		ERR("The %s uniform buffer is already created!", m_Name.c_str());
+		return;
+	}
+
+	int offsetAlignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+	m_OffsetAlignment = (offsetAlignment > 0 ? offsetAlignment : 256);
+
+	// every frame region starts at an aligned offset
+	m_FrameSize = (i_FrameSize + m_OffsetAlignment - 1) / m_OffsetAlignment * m_OffsetAlignment;
+
+	glGenBuffers(1, &m_UBOID);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_UBOID);
+	glBufferData(GL_UNIFORM_BUFFER, m_FrameSize * m_kFrameCount, nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	LOG("Uniform Buffer Manager [%s] - %u bytes per frame, %u frames!", m_Name.c_str(), m_FrameSize, m_kFrameCount);
+}
+
+void UniformBufferManager::BeginFrame ( void )
+{
+	if (m_IsFrameStarted)
+	{
+		// the GPU reads the current region until all the commands issued so far are done
+		m_Fences[m_FrameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		m_FrameIndex = (m_FrameIndex + 1) % m_kFrameCount;
+	}
+
+	// wait for the GPU to finish reading the region (it was used m_kFrameCount - 1 frames ago)
+	GLsync& fence = m_Fences[m_FrameIndex];
+	if (fence)
+	{
+		glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000); // nanoseconds
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	m_FrameOffset = 0;
+	m_IsFrameStarted = true;
+}
+
+void UniformBufferManager::SetBlockData ( UNIFORM_BLOCK_TYPE i_BlockType, const void* i_pData, unsigned int i_DataSize )
+{
+	if (!m_UBOID || !m_IsFrameStarted || !i_pData)
+	{
+		return;
+	}
+
+	unsigned int offset = (m_FrameOffset + m_OffsetAlignment - 1) / m_OffsetAlignment * m_OffsetAlignment;
+	if (offset + i_DataSize > m_FrameSize)
+	{
+		ERR("The %s uniform buffer frame region is too small!", m_Name.c_str());
+		return;
+	}
+
+	unsigned int bufferOffset = m_FrameIndex * m_FrameSize + offset;
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_UBOID);
+	void* pBufferData = glMapBufferRange(GL_UNIFORM_BUFFER, bufferOffset, i_DataSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if (pBufferData)
+	{
+		std::memcpy(pBufferData, i_pData, i_DataSize);
+
+		if (glUnmapBuffer(GL_UNIFORM_BUFFER) == GL_FALSE)
+		{
+			ERR("The %s uniform buffer data got corrupted while mapped!", m_Name.c_str());
+		}
+	}
+	else
+	{
+		ERR("Failed to map the %s uniform buffer!", m_Name.c_str());
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	glBindBufferRange(GL_UNIFORM_BUFFER, GetBlockBindingPoint(i_BlockType), m_UBOID, bufferOffset, i_DataSize);
+
+	m_FrameOffset = offset + i_DataSize;
+}
+
+const char* UniformBufferManager::GetBlockName ( UNIFORM_BLOCK_TYPE i_BlockType )
+{
+	switch (i_BlockType)
+	{
+		case UNIFORM_BLOCK_TYPE::UBT_CAMERA: return "CameraBlock";
+		case UNIFORM_BLOCK_TYPE::UBT_SUN: return "SunBlock";
+		case UNIFORM_BLOCK_TYPE::UBT_OCEAN_PATCH: return "OceanPatchBlock";
+		case UNIFORM_BLOCK_TYPE::UBT_BOAT_EFFECTS: return "BoatEffectsBlock";
+		case UNIFORM_BLOCK_TYPE::UBT_COUNT:
+		default: ERR("Invalid uniform block type!");
+	}
+
+	return nullptr;
+}
+
+unsigned int UniformBufferManager::GetBlockBindingPoint ( UNIFORM_BLOCK_TYPE i_BlockType )
+{
+	// one binding point per block type
+	return static_cast<unsigned int>(i_BlockType);
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef UNIFORM_BUFFER_MANAGER_H
+#define UNIFORM_BUFFER_MANAGER_H
+
+#include "GLConfig.h"
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/mat4x4.hpp"
+#include <string>
+
+/*
+ Manager for the uniform blocks shared by the shader programs (std140 layout)
+
+ All the blocks live in one uniform buffer, used as a ring of m_kFrameCount regions (one region per frame in flight).
+ SetBlockData() writes the block in the current frame region (mapped unsynchronized, so the driver doesn't stall)
+ and binds the written range to the block binding point, so a program needs only one ShaderManager::BindUniformBlock() call per block.
+ A block can be written several times per frame (e.g. the camera block, once per view), every write gets its own range.
+ A region is written again m_kFrameCount frames later, after its fence was signaled.
+
+ The GLSL blocks must match the structs below (check OceanSurface*.glsl)
+
+ https://www.opengl.org/wiki/Uniform_Buffer_Object
+ https://www.opengl.org/wiki/Buffer_Object_Streaming
+*/
+
+class UniformBufferManager
+{
+public:
+	enum class UNIFORM_BLOCK_TYPE
+	{
+		UBT_CAMERA = 0,
+		UBT_SUN,
+		UBT_OCEAN_PATCH,
+		UBT_BOAT_EFFECTS,
+		UBT_COUNT
+	};
+
+	struct CameraBlockData
+	{
+		glm::mat4 WorldToCameraMatrix; //0
+		glm::mat4 WorldToClipMatrix; //64
+		glm::mat4 ClipToCameraMatrix; //128
+		glm::mat4 CameraToWorldMatrix; //192
+		glm::vec3 CameraPosition; //256
+		float Padding; //268
+	};
+
+	struct SunBlockData
+	{
+		glm::vec3 SunDirection; //0
+		float Padding; //12
+	};
+
+	struct OceanPatchBlockData
+	{
+		glm::vec2 PerlinNoiseMovement; //0
+		float WindSpeed; //8
+		int IsUnderWater; //12
+	};
+
+	struct BoatEffectsBlockData
+	{
+		glm::vec3 BoatPosition; //0
+		float KelvinWakeAmplitude; //12
+		glm::vec3 WakePosition; //16
+		float KelvinWakeFoamAmount; //28
+	};
+
+	//// Methods ////
+	UniformBufferManager(void);
+	UniformBufferManager(const std::string& i_Name);
+	~UniformBufferManager(void);
+
+	void Initialize(const std::string& i_Name);
+
+	// i_FrameSize - the bytes written during a frame, by all the SetBlockData() calls
+	void CreateBuffer(unsigned int i_FrameSize);
+
+	// fences the current frame region and waits for the GPU to finish with the next one
+	void BeginFrame(void);
+	void SetBlockData(UNIFORM_BLOCK_TYPE i_BlockType, const void* i_pData, unsigned int i_DataSize);
+
+	// the GLSL block name, use it with ShaderManager::BindUniformBlock()
+	static const char* GetBlockName(UNIFORM_BLOCK_TYPE i_BlockType);
+	static unsigned int GetBlockBindingPoint(UNIFORM_BLOCK_TYPE i_BlockType);
+
+private:
+	//// Methods ////
+	void Destroy(void);
+
+	//// Variables ////
+	static const unsigned short m_kFrameCount = 3;
+
+	std::string m_Name;
+
+	unsigned int m_UBOID;
+	// multiple of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+	unsigned int m_FrameSize;
+	unsigned int m_OffsetAlignment;
+
+	unsigned short m_FrameIndex;
+	unsigned int m_FrameOffset;
+	bool m_IsFrameStarted;
+
+	GLsync m_Fences[m_kFrameCount];
+};
+
+#endif /* UNIFORM_BUFFER_MANAGER_H */
\ No newline at end of file
@@ -476,6 +476,16 @@ glm::vec3 XMLGenericType::ToVec3 ( void )
 	return val;
 }
 
+std::string XMLGenericType::ToString ( void )
+{
+	if (m_Value.empty())
+	{
+		ERR("Generic value is empty!");
+	}
+
+	return m_Value;
+}
+
 
 CustomTypes::Sky::ModelType XMLGenericType::ToSkyModelType ( void )
 {
@@ -497,7 +507,7 @@ CustomTypes::Sky::ModelType XMLGenericType::ToSkyModelType ( void )
 
 CustomTypes::Ocean::ComputeFFTType XMLGenericType::ToOceanComputeFFTType ( void )
 {
-	if (m_Value == "FFTGpuFrag" || m_Value == "FFTGpuComp" || m_Value == "FFTCpuFFTW") // FFT compute
+	if (m_Value == "FFTGpuFrag" || m_Value == "FFTGpuComp" || m_Value == "FFTCpuFFTW" || m_Value == "FFTBakedCache") // FFT compute
 	{
 		if (m_Value == "FFTGpuFrag")
 			return CustomTypes::Ocean::ComputeFFTType::CFT_GPU_FRAG;
@@ -507,6 +517,9 @@ CustomTypes::Ocean::ComputeFFTType XMLGenericType::ToOceanComputeFFTType ( void
 
 		if (m_Value == "FFTCpuFFTW")
 			return CustomTypes::Ocean::ComputeFFTType::CFT_CPU_FFTW;
+
+		if (m_Value == "FFTBakedCache")
+			return CustomTypes::Ocean::ComputeFFTType::CFT_BAKED_CACHE;
 	}
 
 	ERR("Invalid token: %s", m_Value.c_str());
@@ -546,13 +559,25 @@ CustomTypes::Ocean::SpectrumType XMLGenericType::ToOceanSpectrumType ( void )
 
 CustomTypes::Ocean::GridType XMLGenericType::ToOceanGridType ( void )
 {
-	if (m_Value == "GridWorldSpace" || m_Value == "GridScreenSpace") // grid
+	if (m_Value == "GridWorldSpace" || m_Value == "GridScreenSpace" || m_Value == "GridCPUProjected" || m_Value == "GridClipmap" || m_Value == "GridQuadtree" || m_Value == "GridTessellated") // grid
 	{
 		if (m_Value == "GridWorldSpace")
 			return CustomTypes::Ocean::GridType::GT_WORLD_SPACE;
 
 		if (m_Value == "GridScreenSpace")
 			return CustomTypes::Ocean::GridType::GT_SCREEN_SPACE;
+
+		if (m_Value == "GridCPUProjected")
+			return CustomTypes::Ocean::GridType::GT_CPU_PROJECTED;
+
+		if (m_Value == "GridClipmap")
+			return CustomTypes::Ocean::GridType::GT_CLIPMAP;
+
+		if (m_Value == "GridQuadtree")
+			return CustomTypes::Ocean::GridType::GT_QUADTREE;
+
+		if (m_Value == "GridTessellated")
+			return CustomTypes::Ocean::GridType::GT_TESSELLATED;
 	}
 
 	ERR("Invalid token: %s", m_Value.c_str());
@@ -14,7 +14,7 @@
 
  Small helper class to mange geenric types available in my XML confif file
  Supported types:
- bool, int, float, vec2, vec3, customs ones (see below)
+ bool, int, float, vec2, vec3, string, customs ones (see below)
 
 */
 
@@ -34,6 +34,7 @@ public:
 	float ToFloat(void);
 	glm::vec2 ToVec2(void);
 	glm::vec3 ToVec3(void);
+	std::string ToString(void);
 
 	CustomTypes::Sky::ModelType ToSkyModelType(void);
 	CustomTypes::Ocean::ComputeFFTType ToOceanComputeFFTType(void);
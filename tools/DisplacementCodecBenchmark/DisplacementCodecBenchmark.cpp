@@ -0,0 +1,183 @@
+/* Author: BAIRAC MIHAI */
+
+/*
+ Round trip check and timings of the FFT displacement codec (check source/DisplacementCodec) without a window or a GL context
+ The frames are a sum of moving waves (displacement + height in layer 0, slopes in layer 1), like the CPUFFTW2DIFFT output
+ Every frame is encoded and decoded by two separate codecs, the check fails if a decoded value is further than GetMaxError() from the original one
+
+ Usage: DisplacementCodecBenchmark [FFT size] [quantization bits] [key frame interval] [frame count]
+ The frame budget at 60 fps is 16.6 ms, the decode time per frame should stay well below it
+*/
+
+#include "../../source/DisplacementCodec.h"
+#include "glm/gtc/constants.hpp" //pi(), two_pi()
+#include "glm/common.hpp" //abs(), max()
+#include "glm/geometric.hpp" //dot(), length()
+#include "glm/exponential.hpp" //sqrt()
+#include "glm/trigonometric.hpp" //sin(), cos()
+#include <chrono> // std::chrono::steady_clock
+#include <algorithm> // std::sort()
+#include <cstdio>
+#include <cstdlib> // std::atoi(), std::rand()
+#include <vector>
+
+namespace
+{
+	struct Wave
+	{
+		glm::vec2 direction;
+		float wavenumber;
+		float frequency;
+		float amplitude;
+		float phase;
+	};
+
+	const unsigned short kLayerCount = 2;
+	const float kPatchSize = 384.0f;
+	const float kFrameTimeStep = 1.0f / 30.0f;
+	const float kChoppiness = 1.5f;
+
+	void GenerateFrame ( const std::vector<Wave>& i_Waves, unsigned short i_FFTSize, float i_Time, std::vector<glm::vec4>& o_Data )
+	{
+		size_t layerSize = i_FFTSize * i_FFTSize;
+
+		for (unsigned short z = 0; z < i_FFTSize; ++z)
+		{
+			for (unsigned short x = 0; x < i_FFTSize; ++x)
+			{
+				glm::vec2 position(x * kPatchSize / i_FFTSize, z * kPatchSize / i_FFTSize);
+
+				glm::vec4 displacement(0.0f), slopes(0.0f);
+				for (size_t i = 0; i < i_Waves.size(); ++i)
+				{
+					const Wave& wave = i_Waves[i];
+
+					float angle = wave.wavenumber * glm::dot(wave.direction, position) - wave.frequency * i_Time + wave.phase;
+					float s = glm::sin(angle), c = glm::cos(angle);
+
+					displacement.x -= kChoppiness * wave.direction.x * wave.amplitude * s;
+					displacement.y += wave.amplitude * c;
+					displacement.z -= kChoppiness * wave.direction.y * wave.amplitude * s;
+
+					slopes.x -= wave.wavenumber * wave.direction.x * wave.amplitude * s;
+					slopes.y -= wave.wavenumber * wave.direction.y * wave.amplitude * s;
+				}
+
+				o_Data[z * i_FFTSize + x] = displacement;
+				o_Data[layerSize + z * i_FFTSize + x] = slopes;
+			}
+		}
+	}
+
+	float Random ( void )
+	{
+		return std::rand() / static_cast<float>(RAND_MAX);
+	}
+}
+
+int main ( int argc, char* argv[] )
+{
+	int fftSize = (argc > 1 ? std::atoi(argv[1]) : 256);
+	int quantizationBits = (argc > 2 ? std::atoi(argv[2]) : 12);
+	int keyFrameInterval = (argc > 3 ? std::atoi(argv[3]) : 30);
+	int frameCount = (argc > 4 ? std::atoi(argv[4]) : 60);
+	if (fftSize < 2 || fftSize > 4096 || (quantizationBits != 12 && quantizationBits != 16) || keyFrameInterval <= 0 || keyFrameInterval > 65535 || frameCount <= 0)
+	{
+		fprintf(stderr, "Invalid arguments!\n");
+		return 1;
+	}
+
+	// waves which tile the patch (integer number of periods), with the deep water dispersion relation
+	std::vector<Wave> waves(16);
+	for (size_t i = 0; i < waves.size(); ++i)
+	{
+		glm::vec2 k(static_cast<float>(std::rand() % 17 - 8), static_cast<float>(std::rand() % 17 - 8));
+		if (k.x == 0.0f && k.y == 0.0f)
+		{
+			k.x = 1.0f;
+		}
+		k *= glm::two_pi<float>() / kPatchSize;
+
+		waves[i].wavenumber = glm::length(k);
+		waves[i].direction = k / waves[i].wavenumber;
+		waves[i].frequency = glm::sqrt(9.81f * waves[i].wavenumber);
+		waves[i].amplitude = (0.2f + Random()) / (waves[i].wavenumber * 40.0f);
+		waves[i].phase = Random() * glm::two_pi<float>();
+	}
+
+	size_t layerSize = static_cast<size_t>(fftSize) * fftSize;
+	size_t rawSize = kLayerCount * layerSize * sizeof(glm::vec4);
+
+	std::vector<glm::vec4> frameData(kLayerCount * layerSize), decodedData(kLayerCount * layerSize);
+	std::vector<unsigned char> encodedData;
+
+	DisplacementCodec encoder(static_cast<unsigned short>(quantizationBits), static_cast<unsigned short>(keyFrameInterval));
+	DisplacementCodec decoder(static_cast<unsigned short>(quantizationBits), static_cast<unsigned short>(keyFrameInterval));
+
+	std::vector<float> encodeTimes, decodeTimes; // milliseconds
+	encodeTimes.reserve(frameCount);
+	decodeTimes.reserve(frameCount);
+
+	size_t encodedSize = 0;
+	float worstErrorRatio = 0.0f;
+
+	for (int i = 0; i < frameCount; ++i)
+	{
+		GenerateFrame(waves, static_cast<unsigned short>(fftSize), i * kFrameTimeStep, frameData);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		encoder.EncodeFrame(&frameData[0], kLayerCount, layerSize, encodedData);
+		std::chrono::steady_clock::time_point encoded = std::chrono::steady_clock::now();
+		bool isDecoded = decoder.DecodeFrame(&encodedData[0], encodedData.size(), &decodedData[0], kLayerCount, layerSize);
+		std::chrono::steady_clock::time_point decoded = std::chrono::steady_clock::now();
+
+		if (!isDecoded)
+		{
+			fprintf(stderr, "Frame %d: decoding failed!\n", i);
+			return 1;
+		}
+
+		encodeTimes.push_back(std::chrono::duration<float, std::milli>(encoded - start).count());
+		decodeTimes.push_back(std::chrono::duration<float, std::milli>(decoded - encoded).count());
+		encodedSize += encodedData.size();
+
+		// the error bound is per layer channel, GetMaxError() returns the biggest one of the frame
+		glm::vec4 maxError = decoder.GetMaxError();
+		for (size_t j = 0; j < frameData.size(); ++j)
+		{
+			glm::vec4 error = glm::abs(decodedData[j] - frameData[j]);
+
+			for (unsigned short c = 0; c < 4; ++c)
+			{
+				if (error[c] > maxError[c])
+				{
+					fprintf(stderr, "Frame %d, value %u, channel %u: error %g is bigger than the max error %g!\n", i, static_cast<unsigned int>(j), c, error[c], maxError[c]);
+					return 1;
+				}
+
+				if (maxError[c] > 0.0f)
+				{
+					worstErrorRatio = glm::max(worstErrorRatio, error[c] / maxError[c]);
+				}
+			}
+		}
+	}
+
+	std::sort(encodeTimes.begin(), encodeTimes.end());
+	std::sort(decodeTimes.begin(), decodeTimes.end());
+
+	float encodeSum = 0.0f, decodeSum = 0.0f;
+	for (size_t i = 0; i < decodeTimes.size(); ++i)
+	{
+		encodeSum += encodeTimes[i];
+		decodeSum += decodeTimes[i];
+	}
+
+	printf("frames: %d x %d x %u layers, %d bits, key frame every %d frames, %d frames\n", fftSize, fftSize, kLayerCount, quantizationBits, keyFrameInterval, frameCount);
+	printf("round trip: OK, worst error %.3f of the max error\n", worstErrorRatio);
+	printf("size: %.1f KB raw, %.1f KB encoded on average, ratio %.2f\n", rawSize / 1024.0f, encodedSize / 1024.0f / frameCount, static_cast<float>(rawSize) * frameCount / encodedSize);
+	printf("encoding (ms): avg %.3f, p50 %.3f, max %.3f\n", encodeSum / frameCount, encodeTimes[encodeTimes.size() / 2], encodeTimes.back());
+	printf("decoding (ms): avg %.3f, p50 %.3f, max %.3f\n", decodeSum / frameCount, decodeTimes[decodeTimes.size() / 2], decodeTimes.back());
+
+	return 0;
+}
@@ -0,0 +1,120 @@
+/* Author: BAIRAC MIHAI */
+
+/*
+ Measures the latency between the moment MyFFTOcean publishes an ocean fields frame
+ and the moment a reader process has a complete copy of it
+
+ Usage: OceanFieldLatencyBenchmark [shared memory name] [frame count]
+ MyFFTOcean must run with SharedMemoryPublisher enabled (CFT_CPU_FFTW compute type)
+ The benchmark stops early if no new frame is published for kFrameTimeout (the producer stopped or exited)
+*/
+
+#include "OceanFieldReader.h"
+#include <algorithm> // std::sort()
+#include <cstdio>
+#include <cstdlib> // std::atoi()
+#include <thread> // std::this_thread::yield()
+
+namespace
+{
+	// nanoseconds
+	const uint64_t kFrameTimeout = 5000000000ull;
+}
+
+int main ( int argc, char* argv[] )
+{
+	std::string name = (argc > 1 ? argv[1] : "/MyFFTOceanFields");
+	int frameCount = (argc > 2 ? std::atoi(argv[2]) : 1000);
+	if (frameCount <= 0)
+	{
+		fprintf(stderr, "Invalid frame count!\n");
+		return 1;
+	}
+
+	OceanFieldReader reader;
+	if (!reader.Open(name))
+	{
+		return 1;
+	}
+
+	printf("%s: FFT size %u, %u layer(s), %u slots\n", name.c_str(), reader.GetFFTSize(), reader.GetLayerCount(), reader.GetSlotCount());
+
+	std::vector<float> data;
+	std::vector<double> latencies; // microseconds
+	latencies.reserve(frameCount);
+
+	OceanFieldReader::FrameInfo info;
+	uint64_t lastFrame = 0, missedFrames = 0, failedReads = 0;
+
+	// wait for the first frame, so the startup is not measured
+	uint64_t lastFrameTime = OceanFieldReader::GetTimeNow();
+	while (!reader.ReadLatestFrame(data, info))
+	{
+		if (!reader.IsOpen() || OceanFieldReader::GetTimeNow() - lastFrameTime > kFrameTimeout)
+		{
+			fprintf(stderr, "No frame was published!\n");
+			return 1;
+		}
+
+		std::this_thread::yield();
+	}
+	lastFrame = info.frame;
+	lastFrameTime = OceanFieldReader::GetTimeNow();
+
+	unsigned int ringGeneration = reader.GetRingGeneration();
+
+	while (latencies.size() < static_cast<size_t>(frameCount))
+	{
+		if (!reader.IsOpen() || OceanFieldReader::GetTimeNow() - lastFrameTime > kFrameTimeout)
+		{
+			fprintf(stderr, "No new frame was published, the producer stopped!\n");
+			break;
+		}
+
+		if (!reader.ReadLatestFrame(data, info))
+		{
+			++ failedReads;
+			continue;
+		}
+
+		if (reader.GetRingGeneration() != ringGeneration)
+		{
+			// the patch was swapped, the frames of the new ring start again from 1
+			ringGeneration = reader.GetRingGeneration();
+			lastFrame = info.frame - 1;
+		}
+
+		if (info.frame == lastFrame)
+		{
+			// busy polling gives the best case latency
+			std::this_thread::yield();
+			continue;
+		}
+
+		uint64_t readTime = OceanFieldReader::GetTimeNow();
+
+		latencies.push_back((readTime - info.publishTime) / 1000.0);
+		missedFrames += info.frame - lastFrame - 1;
+		lastFrame = info.frame;
+		lastFrameTime = readTime;
+	}
+
+	if (latencies.empty())
+	{
+		return 1;
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+
+	double sum = 0.0;
+	for (size_t i = 0; i < latencies.size(); ++i)
+	{
+		sum += latencies[i];
+	}
+
+	printf("frames: %d, missed: %llu, failed reads: %llu\n", static_cast<int>(latencies.size()), static_cast<unsigned long long>(missedFrames), static_cast<unsigned long long>(failedReads));
+	printf("latency (us): min %.1f, avg %.1f, p50 %.1f, p99 %.1f, max %.1f\n",
+		   latencies.front(), sum / latencies.size(), latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], latencies.back());
+
+	return 0;
+}
\ No newline at end of file
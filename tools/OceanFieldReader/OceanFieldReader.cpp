@@ -0,0 +1,145 @@
+/* Author: BAIRAC MIHAI */
+
+#include "OceanFieldReader.h"
+#include <cstdio>
+#include <sys/mman.h> // shm_open(), mmap(), munmap()
+#include <sys/stat.h> // fstat()
+#include <fcntl.h> // O_* constants
+#include <unistd.h> // close()
+
+
+OceanFieldReader::OceanFieldReader ( void )
+	: m_pRing(nullptr), m_RingSize(0), m_FileDescriptor(-1), m_RingGeneration(0)
+{
+}
+
+OceanFieldReader::~OceanFieldReader ( void )
+{
+	Close();
+}
+
+bool OceanFieldReader::Open ( const std::string& i_Name )
+{
+	Close();
+
+	m_Name = i_Name;
+
+	m_FileDescriptor = shm_open(i_Name.c_str(), O_RDONLY, 0);
+	if (m_FileDescriptor == -1)
+	{
+		fprintf(stderr, "Failed to open %s shared memory!\n", i_Name.c_str());
+		return false;
+	}
+
+	struct stat memoryStat;
+	if (fstat(m_FileDescriptor, &memoryStat) == -1 || static_cast<size_t>(memoryStat.st_size) < sizeof(OceanFieldRing::RingHeader))
+	{
+		fprintf(stderr, "Invalid %s shared memory size!\n", i_Name.c_str());
+		Close();
+		return false;
+	}
+	m_RingSize = static_cast<size_t>(memoryStat.st_size);
+
+	void* pMemory = mmap(nullptr, m_RingSize, PROT_READ, MAP_SHARED, m_FileDescriptor, 0);
+	if (pMemory == MAP_FAILED)
+	{
+		fprintf(stderr, "Failed to map %s shared memory!\n", i_Name.c_str());
+		Close();
+		return false;
+	}
+	m_pRing = static_cast<const OceanFieldRing::RingHeader*>(pMemory);
+
+	// the producer writes the magic last
+	bool isValid = (m_pRing->magic == OceanFieldRing::kMagic);
+	std::atomic_thread_fence(std::memory_order_acquire);
+	isValid = isValid && (m_pRing->version == OceanFieldRing::kVersion) &&
+						 (OceanFieldRing::GetRingSize(m_pRing->slotCount, m_pRing->frameDataSize) <= m_RingSize);
+
+	if (!isValid)
+	{
+		fprintf(stderr, "The %s shared memory is not ready or has an unknown format!\n", i_Name.c_str());
+		Close();
+		return false;
+	}
+
+	// left behind by a producer which couldn't remove the name
+	if (OceanFieldRing::IsClosed(m_pRing))
+	{
+		fprintf(stderr, "The %s shared memory is closed!\n", i_Name.c_str());
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void OceanFieldReader::Close ( void )
+{
+	if (m_pRing)
+	{
+		munmap(const_cast<OceanFieldRing::RingHeader*>(m_pRing), m_RingSize);
+		m_pRing = nullptr;
+	}
+
+	if (m_FileDescriptor != -1)
+	{
+		close(m_FileDescriptor);
+		m_FileDescriptor = -1;
+	}
+
+	m_RingSize = 0;
+}
+
+bool OceanFieldReader::IsOpen ( void ) const
+{
+	return (m_pRing != nullptr);
+}
+
+bool OceanFieldReader::ReadLatestFrame ( std::vector<float>& o_Data, FrameInfo& o_Info )
+{
+	if (!m_pRing)
+	{
+		return false;
+	}
+
+	if (OceanFieldRing::IsClosed(m_pRing))
+	{
+		// the producer swapped its patch (a new ring under the same name) or exited
+		std::string name = m_Name;
+		if (!Open(name))
+		{
+			return false;
+		}
+
+		++ m_RingGeneration;
+	}
+
+	o_Data.resize(m_pRing->frameDataSize / sizeof(float));
+
+	return OceanFieldRing::ReadLatestFrame(m_pRing, &o_Data[0], o_Info.frame, o_Info.publishTime, o_Info.simulationTime);
+}
+
+unsigned int OceanFieldReader::GetRingGeneration ( void ) const
+{
+	return m_RingGeneration;
+}
+
+unsigned int OceanFieldReader::GetFFTSize ( void ) const
+{
+	return (m_pRing ? m_pRing->fftSize : 0);
+}
+
+unsigned int OceanFieldReader::GetLayerCount ( void ) const
+{
+	return (m_pRing ? m_pRing->layerCount : 0);
+}
+
+unsigned int OceanFieldReader::GetSlotCount ( void ) const
+{
+	return (m_pRing ? m_pRing->slotCount : 0);
+}
+
+uint64_t OceanFieldReader::GetTimeNow ( void )
+{
+	return OceanFieldRing::GetTimeNow();
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+/* Author: BAIRAC MIHAI */
+
+#ifndef OCEAN_FIELD_READER_H
+#define OCEAN_FIELD_READER_H
+
+#include "../../source/OceanFieldRing.h"
+#include <string>
+#include <vector>
+
+/*
+ Small reader library for the ocean fields published by MyFFTOcean (check source/OceanFieldPublisher)
+ The shared memory is mapped read only, so a reader never blocks or corrupts the producer
+ When the producer closes the ring (patch swapped at runtime, or exit), the reader opens the name again,
+ the frame numbers of the new ring start again from 1. IsOpen() is false once the producer is gone.
+
+ Usage:
+ OceanFieldReader reader;
+ if (reader.Open("/MyFFTOceanFields"))
+ {
+	OceanFieldReader::FrameInfo info;
+	std::vector<float> data;
+	if (reader.ReadLatestFrame(data, info)) { ... }
+ }
+*/
+
+class OceanFieldReader
+{
+public:
+	struct FrameInfo
+	{
+		uint64_t frame; // increases by 1 with every published frame
+		uint64_t publishTime; // steady clock, in nanoseconds
+		float simulationTime;
+	};
+
+	OceanFieldReader(void);
+	~OceanFieldReader(void);
+
+	// fails if the producer didn't create the shared memory yet
+	bool Open(const std::string& i_Name);
+	void Close(void);
+
+	bool IsOpen(void) const;
+
+	// o_Data - FFTSize * FFTSize * 4 floats per layer, layer after layer
+	// returns false if nothing new could be read
+	bool ReadLatestFrame(std::vector<float>& o_Data, FrameInfo& o_Info);
+
+	// increases every time the ring was opened again
+	unsigned int GetRingGeneration(void) const;
+
+	unsigned int GetFFTSize(void) const;
+	unsigned int GetLayerCount(void) const;
+	unsigned int GetSlotCount(void) const;
+
+	static uint64_t GetTimeNow(void);
+
+private:
+	//// Variables ////
+	std::string m_Name;
+
+	const OceanFieldRing::RingHeader* m_pRing;
+	size_t m_RingSize;
+
+	int m_FileDescriptor;
+
+	unsigned int m_RingGeneration;
+};
+
+#endif /* OCEAN_FIELD_READER_H */
\ No newline at end of file
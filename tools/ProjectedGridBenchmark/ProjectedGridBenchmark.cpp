@@ -0,0 +1,89 @@
+/* Author: BAIRAC MIHAI */
+
+/*
+ Measures the CPU projected grid generation time (check source/CPUProjectedGrid) without a window or a GL context
+ The camera looks at the ocean from a typical height and the FFT displacement is a random field
+
+ Usage: ProjectedGridBenchmark [grid width] [grid height] [thread count] [iteration count]
+ thread count 0 - one thread per hardware thread
+*/
+
+#include "../../source/CPUProjectedGrid.h"
+#include "glm/gtc/matrix_transform.hpp" //perspective(), lookAt()
+#include "glm/gtc/constants.hpp" //pi()
+#include "glm/matrix.hpp" //inverse()
+#include <algorithm> // std::sort()
+#include <cstdio>
+#include <cstdlib> // std::atoi(), std::rand()
+#include <vector>
+
+int main ( int argc, char* argv[] )
+{
+	int width = (argc > 1 ? std::atoi(argv[1]) : 256);
+	int height = (argc > 2 ? std::atoi(argv[2]) : 512);
+	int threadCount = (argc > 3 ? std::atoi(argv[3]) : 0);
+	int iterationCount = (argc > 4 ? std::atoi(argv[4]) : 200);
+	if (width < 2 || height < 2 || width > 65535 || height > 65535 || threadCount < 0 || iterationCount <= 0)
+	{
+		fprintf(stderr, "Invalid arguments!\n");
+		return 1;
+	}
+
+	const unsigned short k_FFTSize = 256;
+	const float k_PatchSize = 384.0f;
+	const float k_TileScale = 1.0f;
+
+	// the projector looks at the ocean plane (y = 0), the pack matrix spreads the grid uvs [0, 1] over the clip space below the horizon
+	// (like Projector::Update does with the visible part of the plane)
+	glm::mat4 projection = glm::perspective(glm::pi<float>() / 3.0f, 16.0f / 9.0f, 1.0f, 10000.0f);
+	glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 30.0f, 0.0f), glm::vec3(0.0f, 0.0f, 200.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::mat4 pack = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(-1.0f, -1.0f, 0.0f)), glm::vec3(2.0f, 1.2f, 1.0f));
+
+	glm::mat4 projectingMatrix = glm::inverse(projection * view) * pack;
+	glm::vec4 plane(0.0f, 1.0f, 0.0f, 0.0f);
+
+	glm::mat4 gridCorners;
+	if (!CPUProjectedGrid::ComputeGridCorners(projectingMatrix, plane, gridCorners))
+	{
+		fprintf(stderr, "The projector doesn't see the ocean plane!\n");
+		return 1;
+	}
+
+	std::vector<glm::vec4> displacementData(k_FFTSize * k_FFTSize);
+	for (size_t i = 0; i < displacementData.size(); ++i)
+	{
+		displacementData[i] = glm::vec4(std::rand() / static_cast<float>(RAND_MAX) - 0.5f, std::rand() / static_cast<float>(RAND_MAX) * 4.0f - 2.0f, std::rand() / static_cast<float>(RAND_MAX) - 0.5f, 0.0f);
+	}
+
+	CPUProjectedGrid grid(static_cast<unsigned short>(width), static_cast<unsigned short>(height), static_cast<unsigned short>(threadCount));
+
+	std::vector<MeshBufferManager::VertexData> vertexData(grid.GetVertexCount());
+
+	// warm up
+	grid.Generate(gridCorners, &displacementData[0], k_FFTSize, k_TileScale / k_PatchSize, &vertexData[0]);
+
+	std::vector<float> times; // milliseconds
+	times.reserve(iterationCount);
+
+	for (int i = 0; i < iterationCount; ++i)
+	{
+		grid.Generate(gridCorners, &displacementData[0], k_FFTSize, k_TileScale / k_PatchSize, &vertexData[0]);
+		times.push_back(grid.GetLastGenerationTime());
+	}
+
+	std::sort(times.begin(), times.end());
+
+	float sum = 0.0f;
+	for (size_t i = 0; i < times.size(); ++i)
+	{
+		sum += times[i];
+	}
+	float average = sum / times.size();
+
+	printf("grid: %d x %d (%u vertices), %u thread(s), %d iterations\n", width, height, grid.GetVertexCount(), grid.GetThreadCount(), iterationCount);
+	printf("generation (ms): min %.3f, avg %.3f, p50 %.3f, p99 %.3f, max %.3f\n",
+		   times.front(), average, times[times.size() / 2], times[times.size() * 99 / 100], times.back());
+	printf("throughput: %.1f Mvertices/s\n", grid.GetVertexCount() / (average * 1000.0f));
+
+	return 0;
+}
\ No newline at end of file